@@ -0,0 +1,282 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA oscillator calibration service source file.
+ *
+ *      This file contains the function implementations of the oscillator
+ *      calibration service.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2771 $
+ * $Date: 2009-09-11 11:54:26 +0200 (fr, 11 sep 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "clksys_calibration.h"
+
+
+/*! \brief Wait for a capture and return the captured value.
+ *
+ *  \param tc       The Timer/Counter.
+ *  \param capture  Where the captured value is stored.
+ *
+ *  \return  True if a capture was made before the timeout.
+ */
+static bool CLKCAL_WaitForCapture( TC0_t * tc, uint16_t * capture )
+{
+	uint32_t timeout = CLKCAL_TIMEOUT_LOOPS;
+
+	do {} while ( ( ( tc->INTFLAGS & TC0_CCAIF_bm ) == 0 ) && ( --timeout != 0 ) );
+	if (timeout == 0) {
+		return false;
+	}
+
+	/* Reading CCA clears the capture flag. */
+	*capture = tc->CCA;
+	return true;
+}
+
+
+/*! \brief Initialize the oscillator calibration service.
+ *
+ *  This function starts the 32.768 kHz crystal oscillator on TOSC and the
+ *  RTC from it, and routes the RTC overflow event to input capture A of
+ *  the Timer/Counter, counting clkPER. The crystal is started with a long
+ *  startup time, so the function blocks until it is ready.
+ *
+ *  The same crystal can be used as the DFLL reference by
+ *  CLKSYS_AutoCalibration_Enable() with an external reference.
+ *
+ *  \param cal           Pointer to the calibration service.
+ *  \param tc            Timer/Counter to use for counting.
+ *  \param eventChannel  Event channel to use, 0 to 7.
+ *  \param nominalHz     Nominal clkPER frequency in Hz.
+ */
+void CLKCAL_Init( CLKCAL_Calibration_t * cal,
+                  TC0_t * tc,
+                  uint8_t eventChannel,
+                  uint32_t nominalHz )
+{
+	cal->tc = tc;
+	CLKCAL_ClearStatistics( cal );
+
+	/* Start the 32.768 kHz crystal and clock the RTC from it. */
+	CLKSYS_XOSC_Config( OSC_FRQRANGE_04TO2_gc, false, OSC_XOSCSEL_32KHz_gc );
+	CLKSYS_Enable( OSC_XOSCEN_bm );
+	do {} while ( CLKSYS_IsReady( OSC_XOSCRDY_bm ) == 0 );
+	CLKSYS_RTC_ClockSource_Enable( CLK_RTCSRC_TOSC_gc );
+
+	/* Capture the free-running counter on every RTC overflow. */
+	( &EVSYS.CH0MUX )[eventChannel] = EVSYS_CHMUX_RTC_OVF_gc;
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->PER = 0xFFFF;
+	tc->CTRLB = TC0_CCAEN_bm | TC_WGMODE_NORMAL_gc;
+	tc->CTRLD = TC_EVACT_CAPT_gc | ( TC_EVSEL_CH0_gc + eventChannel );
+	tc->CTRLA = TC_CLKSEL_DIV1_gc;
+
+	CLKCAL_SetNominalFrequency( cal, nominalHz );
+	RTC.CTRL = RTC_PRESCALER_DIV1_gc;
+}
+
+
+/*! \brief Set the nominal clkPER frequency.
+ *
+ *  The RTC period is set to the longest period that keeps the count within
+ *  CLKCAL_MAX_COUNT, to get the best resolution. At 32 MHz the period is
+ *  one RTC tick and the resolution of one period is 32 ppm; at 2 MHz it is
+ *  30 ticks and 16 ppm. This function must be called after the system
+ *  clock has been changed.
+ *
+ *  \param cal        Pointer to the calibration service.
+ *  \param nominalHz  Nominal clkPER frequency in Hz.
+ */
+void CLKCAL_SetNominalFrequency( CLKCAL_Calibration_t * cal, uint32_t nominalHz )
+{
+	uint32_t refTicks = ( CLKCAL_MAX_COUNT * CLKCAL_REFERENCE_HZ ) / nominalHz;
+
+	if (refTicks == 0) {
+		refTicks = 1;
+	}
+
+	cal->nominalHz = nominalHz;
+	cal->refTicks = (uint16_t) refTicks;
+	cal->measuredHz = nominalHz;
+
+	do {} while ( RTC.STATUS & RTC_SYNCBUSY_bm );
+	RTC.PER = cal->refTicks - 1;
+
+	/* Restart the count: above the new period, it would run to 0xFFFF
+	 * before the next overflow. */
+	do {} while ( RTC.STATUS & RTC_SYNCBUSY_bm );
+	RTC.CNT = 0;
+}
+
+
+/*! \brief Measure the clkPER frequency.
+ *
+ *  This function counts clkPER cycles over a number of RTC periods and
+ *  updates the measured frequency, the error and the statistics. It blocks
+ *  for the measurement time, about (periods + 1) x 1 ms at 32 MHz.
+ *
+ *  \param cal          Pointer to the calibration service.
+ *  \param periods      Number of RTC periods to average over, 1 to 255.
+ *  \param temperature  Device temperature in degrees Celsius, or
+ *                      CLKCAL_TEMPERATURE_UNKNOWN.
+ *
+ *  \return  False if the RTC did not run, true otherwise.
+ */
+bool CLKCAL_Measure( CLKCAL_Calibration_t * cal, uint8_t periods, int8_t temperature )
+{
+	TC0_t * tc = cal->tc;
+	uint16_t previous;
+	uint16_t capture;
+	uint32_t count = 0;
+	uint32_t refTotal;
+	int32_t error;
+	uint8_t i;
+
+	/* Discard old captures, including the one held in the capture
+	 * buffer, and synchronize to the next overflow. */
+	capture = tc->CCA;
+	capture = tc->CCA;
+	tc->INTFLAGS = TC0_CCAIF_bm;
+	if (!CLKCAL_WaitForCapture( tc, &previous )) {
+		return false;
+	}
+
+	for (i = 0; i < periods; ++i) {
+		if (!CLKCAL_WaitForCapture( tc, &capture )) {
+			return false;
+		}
+		count += (uint16_t) ( capture - previous );
+		previous = capture;
+	}
+
+	/* measuredHz = count x 1024 / refTotal, split to stay within 32 bits. */
+	refTotal = (uint32_t) periods * cal->refTicks;
+	cal->measuredHz = ( count / refTotal ) * CLKCAL_REFERENCE_HZ +
+	                  ( ( count % refTotal ) * CLKCAL_REFERENCE_HZ ) / refTotal;
+
+	/* Error in ppm, with the nominal frequency in kHz to stay within 32 bits. */
+	error = ( (int32_t) cal->measuredHz - (int32_t) cal->nominalHz ) * 1000 /
+	        (int32_t) ( cal->nominalHz / 1000 );
+	if (error > INT16_MAX) {
+		error = INT16_MAX;
+	} else if (error < -INT16_MAX) {
+		error = -INT16_MAX;
+	}
+	cal->ppm = (int16_t) error;
+
+	if (cal->ppm < cal->ppmMin) {
+		cal->ppmMin = cal->ppm;
+	}
+	if (cal->ppm > cal->ppmMax) {
+		cal->ppmMax = cal->ppm;
+	}
+	++cal->measurementCount;
+
+	if (temperature != CLKCAL_TEMPERATURE_UNKNOWN) {
+		int16_t bin = ( temperature - CLKCAL_TEMPERATURE_MIN ) / CLKCAL_TEMPERATURE_STEP;
+		int16_t worst;
+		int16_t magnitude = ( cal->ppm < 0 ) ? -cal->ppm : cal->ppm;
+
+		if (bin < 0) {
+			bin = 0;
+		} else if (bin >= CLKCAL_TEMPERATURE_BINS) {
+			bin = CLKCAL_TEMPERATURE_BINS - 1;
+		}
+
+		worst = cal->drift[bin];
+		if (worst < 0) {
+			worst = -worst;
+		}
+		if (magnitude > worst) {
+			cal->drift[bin] = cal->ppm;
+		}
+	}
+
+	return true;
+}
+
+
+/*! \brief Wait until the oscillator is within a given accuracy.
+ *
+ *  The DFLL needs some time to lock after it is enabled or the clock is
+ *  changed. Instead of always waiting the worst-case lock time, this
+ *  function measures until the error is within the limit, so it returns
+ *  after the first measurement when the oscillator is already accurate.
+ *
+ *  \param cal          Pointer to the calibration service.
+ *  \param maxPpm       Largest error accepted, in ppm.
+ *  \param periods      Number of RTC periods per measurement.
+ *  \param maxAttempts  Number of measurements before giving up.
+ *
+ *  \return  True if the error is within the limit.
+ */
+bool CLKCAL_WaitForAccurateLock( CLKCAL_Calibration_t * cal,
+                                 uint16_t maxPpm,
+                                 uint8_t periods,
+                                 uint8_t maxAttempts )
+{
+	while (maxAttempts-- > 0) {
+		if (!CLKCAL_Measure( cal, periods, CLKCAL_TEMPERATURE_UNKNOWN )) {
+			return false;
+		}
+		if (( cal->ppm <= (int16_t) maxPpm ) && ( cal->ppm >= -(int16_t) maxPpm )) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*! \brief Clear the error statistics and the drift table.
+ *
+ *  \param cal  Pointer to the calibration service.
+ */
+void CLKCAL_ClearStatistics( CLKCAL_Calibration_t * cal )
+{
+	uint8_t i;
+
+	cal->ppm = 0;
+	cal->ppmMin = INT16_MAX;
+	cal->ppmMax = -INT16_MAX;
+	cal->measurementCount = 0;
+	for (i = 0; i < CLKCAL_TEMPERATURE_BINS; ++i) {
+		cal->drift[i] = 0;
+	}
+}
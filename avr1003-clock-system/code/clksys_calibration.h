@@ -0,0 +1,136 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA oscillator calibration service header file.
+ *
+ *      This file contains the function prototypes, macros and type definitions
+ *      for the oscillator calibration service. The service measures the
+ *      peripheral clock against a 32.768 kHz crystal on TOSC, using the Real
+ *      Time Counter overflow event to capture a free-running Timer/Counter.
+ *      It reports the frequency error in ppm, tracks the error over
+ *      temperature, and exposes the measured frequency, so baud rates can be
+ *      computed from the actual clock rather than the nominal one.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1665 $
+ * $Date: 2008-06-05 09:21:50 +0200 (to, 05 jun 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef CLKSYS_CALIBRATION_H
+#define CLKSYS_CALIBRATION_H
+
+#include "avr_compiler.h"
+#include "clksys_driver.h"
+
+
+/* Definitions of macros. */
+
+/*! \brief RTC clock frequency, 1.024 kHz from the 32.768 kHz crystal. */
+#define CLKCAL_REFERENCE_HZ         1024
+
+/*! \brief Highest expected count per RTC period. Leaves room for an
+ *         oscillator running 9 % fast within the 16-bit capture.
+ */
+#define CLKCAL_MAX_COUNT            60000UL
+
+/*! \brief Lowest temperature of the drift table, in degrees Celsius. */
+#define CLKCAL_TEMPERATURE_MIN      -40
+
+/*! \brief Temperature range of one drift table entry, in degrees Celsius. */
+#define CLKCAL_TEMPERATURE_STEP     10
+
+/*! \brief Number of drift table entries, covering -40 to 89 degrees. */
+#define CLKCAL_TEMPERATURE_BINS     13
+
+/*! \brief Temperature value to pass when the temperature is not known. */
+#define CLKCAL_TEMPERATURE_UNKNOWN  -128
+
+/*! \brief Number of busy-wait loops before a measurement is abandoned. */
+#define CLKCAL_TIMEOUT_LOOPS        100000UL
+
+/*! \brief Get the measured peripheral clock frequency in Hz.
+ *
+ *  \param _cal  Pointer to the calibration service.
+ */
+#define CLKCAL_GetMeasuredHz( _cal )   ( (_cal)->measuredHz )
+
+/*! \brief Get the error of the last measurement in ppm.
+ *
+ *  \param _cal  Pointer to the calibration service.
+ */
+#define CLKCAL_GetErrorPpm( _cal )     ( (_cal)->ppm )
+
+
+/*! \brief Oscillator calibration service instance. */
+typedef struct CLKCAL_Calibration_struct {
+	/*! Timer/Counter counting clkPER cycles. */
+	TC0_t * tc;
+	/*! Nominal clkPER frequency in Hz. */
+	uint32_t nominalHz;
+	/*! RTC ticks per measurement period. */
+	uint16_t refTicks;
+	/*! Frequency found by the last measurement, in Hz. */
+	uint32_t measuredHz;
+	/*! Error of the last measurement in ppm. */
+	int16_t ppm;
+	/*! Lowest error seen, in ppm. */
+	int16_t ppmMin;
+	/*! Highest error seen, in ppm. */
+	int16_t ppmMax;
+	/*! Number of measurements made. */
+	uint16_t measurementCount;
+	/*! Error with the largest magnitude seen in each temperature range. */
+	int16_t drift[CLKCAL_TEMPERATURE_BINS];
+} CLKCAL_Calibration_t;
+
+
+/* Prototyping of functions. */
+
+void CLKCAL_Init( CLKCAL_Calibration_t * cal,
+                  TC0_t * tc,
+                  uint8_t eventChannel,
+                  uint32_t nominalHz );
+void CLKCAL_SetNominalFrequency( CLKCAL_Calibration_t * cal, uint32_t nominalHz );
+bool CLKCAL_Measure( CLKCAL_Calibration_t * cal, uint8_t periods, int8_t temperature );
+bool CLKCAL_WaitForAccurateLock( CLKCAL_Calibration_t * cal,
+                                 uint16_t maxPpm,
+                                 uint8_t periods,
+                                 uint8_t maxAttempts );
+void CLKCAL_ClearStatistics( CLKCAL_Calibration_t * cal );
+
+#endif
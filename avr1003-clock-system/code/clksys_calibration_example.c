@@ -0,0 +1,154 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA oscillator calibration service example source.
+ *
+ *      This file contains an example application that demonstrates the
+ *      oscillator calibration service. The device runs from the 32 MHz RC
+ *      oscillator, calibrated by the DFLL against the 32.768 kHz crystal on
+ *      TOSC. The error is measured before and after the DFLL is enabled, and
+ *      the USART baud rate is computed from the measured frequency. The error
+ *      in ppm is sent at 921600 baud and shown on PORTD.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "avr_compiler.h"
+#include "clksys_calibration.h"
+
+/* The LEDs to use for visual feedback. */
+#define LEDPORT PORTD
+#define LEDMASK 0xFF
+
+/* USART used for telemetry output, TXD on PE3. */
+#define USART USARTE0
+#define USART_BAUDRATE 921600UL
+
+/* Accuracy required before the USART is used, in ppm. */
+#define REQUIRED_PPM 2000
+
+/* Calibration service instance. */
+CLKCAL_Calibration_t calibration;
+
+
+/*! \brief Set the USART baud rate from a clock frequency.
+ *
+ *  BSCALE = -7 gives BSEL = 8 x f / baud - 128, with 1/128 resolution of
+ *  the baud period.
+ *
+ *  \param clockHz  clkPER frequency in Hz.
+ */
+static void SetBaudRate( uint32_t clockHz )
+{
+	uint16_t bsel = (uint16_t) ( ( 8 * clockHz + USART_BAUDRATE / 2 ) / USART_BAUDRATE ) - 128;
+
+	USART.BAUDCTRLA = (uint8_t) bsel;
+	/* BSCALE = -7, in two's complement. */
+	USART.BAUDCTRLB = ( 0x09 << USART_BSCALE_gp ) | (uint8_t) ( bsel >> 8 );
+}
+
+
+/*! \brief Send one character. */
+static void SendChar( char c )
+{
+	do {} while ( ( USART.STATUS & USART_DREIF_bm ) == 0 );
+	USART.DATA = c;
+}
+
+
+/*! \brief Send a signed number as text followed by a line feed. */
+static void SendNumber( int16_t value )
+{
+	char digits[6];
+	uint8_t count = 0;
+	uint16_t magnitude = ( value < 0 ) ? -value : value;
+
+	if (value < 0) {
+		SendChar( '-' );
+	}
+	do {
+		digits[count++] = '0' + ( magnitude % 10 );
+		magnitude /= 10;
+	} while (magnitude != 0);
+	while (count > 0) {
+		SendChar( digits[--count] );
+	}
+	SendChar( '\n' );
+}
+
+
+int main( void )
+{
+	int16_t factoryPpm;
+
+	LEDPORT.DIRSET = LEDMASK;
+
+	/* Run from the 32 MHz RC oscillator. */
+	CLKSYS_Enable( OSC_RC32MEN_bm );
+	do {} while ( CLKSYS_IsReady( OSC_RC32MRDY_bm ) == 0 );
+	CLKSYS_Main_ClockSource_Select( CLK_SCLKSEL_RC32M_gc );
+	CLKSYS_Disable( OSC_RC2MEN_bm );
+
+	/* Measure the error with the factory calibration. */
+	CLKCAL_Init( &calibration, &TCC0, 0, 32000000UL );
+	CLKCAL_Measure( &calibration, 16, CLKCAL_TEMPERATURE_UNKNOWN );
+	factoryPpm = CLKCAL_GetErrorPpm( &calibration );
+
+	/* Calibrate against the crystal, and only wait for the DFLL when the
+	 * error is above the limit. */
+	CLKSYS_AutoCalibration_Enable( OSC_RC32MCREF_bm, true );
+	CLKCAL_WaitForAccurateLock( &calibration, REQUIRED_PPM, 16, 100 );
+
+	/* Set up the USART from the measured frequency, 8N1. */
+	PORTE.DIRSET = PIN3_bm;
+	PORTE.OUTSET = PIN3_bm;
+	SetBaudRate( CLKCAL_GetMeasuredHz( &calibration ) );
+	USART.CTRLC = USART_CHSIZE_8BIT_gc;
+	USART.CTRLB = USART_TXEN_bm;
+
+	SendNumber( factoryPpm );
+
+	while (1) {
+		CLKCAL_Measure( &calibration, 64, CLKCAL_TEMPERATURE_UNKNOWN );
+
+		SendNumber( CLKCAL_GetErrorPpm( &calibration ) );
+		LEDPORT.OUT = ~( (uint8_t) ( CLKCAL_GetErrorPpm( &calibration ) / 16 ) );
+	}
+}
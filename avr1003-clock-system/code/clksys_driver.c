@@ -104,7 +104,7 @@ void CCPWrite( volatile uint8_t * address, uint8_t value )
 	// Restore global interrupt setting from scratch register.
         asm("out  0x3F, R1");
 
-#elif defined __GNUC__
+#elif defined __AVR__
 	AVR_ENTER_CRITICAL_REGION( );
 	volatile uint8_t * tmpAddr = address;
 #ifdef RAMPZ
@@ -121,6 +121,12 @@ void CCPWrite( volatile uint8_t * address, uint8_t value )
 		);
 
 	AVR_LEAVE_CRITICAL_REGION( );
+#else
+	/* Other targets, such as a host simulation, have no timing to meet. */
+	AVR_ENTER_CRITICAL_REGION( );
+	CCP = CCP_IOREG_gc;
+	*address = value;
+	AVR_LEAVE_CRITICAL_REGION( );
 #endif
 }
 
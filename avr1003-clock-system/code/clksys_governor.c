@@ -0,0 +1,413 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Clock System governor source file.
+ *
+ *      This file contains the function implementations of the clock governor.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2771 $
+ * $Date: 2009-09-11 11:54:26 +0200 (fr, 11 sep 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "clksys_governor.h"
+
+/*! \brief No level change pending. */
+#define CLKGOV_NO_PENDING   0xFF
+
+/*! \brief PLL multiplication factor. The 32 MHz RC oscillator is divided by
+ *         four at the PLL input, giving 64 MHz.
+ */
+#define CLKGOV_PLL_FACTOR   8
+
+
+/*! \brief Clock settings for one performance level. */
+typedef struct CLKGOV_LevelConfig_struct {
+	/*! Main system clock source. */
+	CLK_SCLKSEL_t source;
+	/*! Enable bit of the oscillator, OSC_RC2MEN_bm, OSC_RC32MEN_bm or OSC_PLLEN_bm. */
+	uint8_t oscEnable;
+	/*! Ready flag of the oscillator. */
+	uint8_t oscReady;
+	/*! Prescaler B and C setting. */
+	CLK_PSBCDIV_t prescaler;
+	/*! Division from the source to clkCPU. */
+	uint8_t cpuDivider;
+	/*! clkPER4 frequency in Hz. */
+	uint32_t per4Hz;
+	/*! clkPER and clkCPU frequency in Hz. */
+	uint32_t perHz;
+} CLKGOV_LevelConfig_t;
+
+
+/*! \brief Clock settings of the performance levels, see CLKGOV_Level_t. */
+static const CLKGOV_LevelConfig_t CLKGOV_levels[CLKGOV_LEVEL_COUNT] = {
+	{ CLK_SCLKSEL_RC2M_gc, OSC_RC2MEN_bm, OSC_RC2MRDY_bm,
+	  CLK_PSBCDIV_1_1_gc, 1, 2000000UL, 2000000UL },
+	{ CLK_SCLKSEL_RC32M_gc, OSC_RC32MEN_bm, OSC_RC32MRDY_bm,
+	  CLK_PSBCDIV_1_1_gc, 1, 32000000UL, 32000000UL },
+	{ CLK_SCLKSEL_PLL_gc, OSC_PLLEN_bm, OSC_PLLRDY_bm,
+	  CLK_PSBCDIV_1_2_gc, 2, 64000000UL, 32000000UL },
+};
+
+
+/*! \brief Governor state. */
+static struct {
+	/*! Current performance level. */
+	CLKGOV_Level_t level;
+	/*! Deferred level, or CLKGOV_NO_PENDING. */
+	uint8_t pendingLevel;
+	/*! Number of holds in effect. */
+	volatile uint8_t holdCount;
+	/*! Load threshold for raising the level. */
+	uint8_t upLoad;
+	/*! Load threshold for lowering the level. */
+	uint8_t downLoad;
+	/*! Low-load updates needed before lowering the level. */
+	uint8_t downDelay;
+	/*! Consecutive low-load updates. */
+	uint8_t lowLoadCount;
+	/*! Number of registered clients. */
+	uint8_t clientCount;
+	/*! Registered notification functions. */
+	CLKGOV_Notify_t clients[CLKGOV_MAX_CLIENTS];
+} CLKGOV_state;
+
+
+
+/*! \brief Call all registered notification functions.
+ *
+ *  \param event  The notification event.
+ */
+static void CLKGOV_Notify( CLKGOV_Event_t event )
+{
+	uint8_t i;
+	uint32_t perHz = CLKGOV_levels[CLKGOV_state.level].perHz;
+
+	for (i = 0; i < CLKGOV_state.clientCount; ++i) {
+		CLKGOV_state.clients[i]( event, perHz );
+	}
+}
+
+
+/*! \brief Start the oscillator of a level and wait until it is ready.
+ *
+ *  \param level  The level.
+ */
+static void CLKGOV_Start( CLKGOV_Level_t level )
+{
+	const CLKGOV_LevelConfig_t * newConfig = &CLKGOV_levels[level];
+
+	if (newConfig->source == CLK_SCLKSEL_PLL_gc) {
+		/* The PLL runs from the 32 MHz RC oscillator. */
+		CLKSYS_Enable( OSC_RC32MEN_bm );
+		do {} while ( CLKSYS_IsReady( OSC_RC32MRDY_bm ) == 0 );
+
+		/* The PLL can only be configured while disabled. */
+		if (( OSC.CTRL & OSC_PLLEN_bm ) == 0) {
+			CLKSYS_PLL_Config( OSC_PLLSRC_RC32M_gc, CLKGOV_PLL_FACTOR );
+		}
+	}
+	CLKSYS_Enable( newConfig->oscEnable );
+	do {} while ( CLKSYS_IsReady( newConfig->oscReady ) == 0 );
+}
+
+
+/*! \brief Stop the oscillators a level does not need, except the 2 MHz RC
+ *         oscillator.
+ *
+ *  \param level  The level.
+ */
+static void CLKGOV_StopUnused( CLKGOV_Level_t level )
+{
+	if (level != CLKGOV_LEVEL_HIGH) {
+		CLKSYS_Disable( OSC_PLLEN_bm );
+	}
+	if (level == CLKGOV_LEVEL_LOW) {
+		CLKSYS_Disable( OSC_RC32MEN_bm );
+	}
+}
+
+
+/*! \brief Switch the system clock to a new level.
+ *
+ *  The oscillator of the new level must have been started with
+ *  CLKGOV_Start(). The prescalers are changed before the clock source when
+ *  the new level divides the source clock more, and after it otherwise, so
+ *  clkCPU never exceeds the higher of the two frequencies during the switch.
+ *
+ *  A client that finds clock dependent activity starting in the pre-change
+ *  notification, such as a start bit whose interrupt is pending, takes a
+ *  hold there. The change is then deferred, and the clients are notified
+ *  of the unchanged clock.
+ *
+ *  \param level  The new level.
+ *
+ *  \return  True if the clock was switched, false if deferred.
+ */
+static bool CLKGOV_Switch( CLKGOV_Level_t level )
+{
+	const CLKGOV_LevelConfig_t * newConfig = &CLKGOV_levels[level];
+	const CLKGOV_LevelConfig_t * oldConfig = &CLKGOV_levels[CLKGOV_state.level];
+
+	CLKGOV_Notify( CLKGOV_EVENT_PRE_CHANGE );
+
+	if (CLKGOV_state.holdCount != 0) {
+		CLKGOV_state.pendingLevel = level;
+		CLKGOV_Notify( CLKGOV_EVENT_POST_CHANGE );
+		return false;
+	}
+
+	if (newConfig->cpuDivider > oldConfig->cpuDivider) {
+		CLKSYS_Prescalers_Config( CLK_PSADIV_1_gc, newConfig->prescaler );
+		CLKSYS_Main_ClockSource_Select( newConfig->source );
+	} else {
+		CLKSYS_Main_ClockSource_Select( newConfig->source );
+		CLKSYS_Prescalers_Config( CLK_PSADIV_1_gc, newConfig->prescaler );
+	}
+
+	CLKGOV_StopUnused( level );
+
+	CLKGOV_state.level = level;
+	CLKGOV_state.pendingLevel = CLKGOV_NO_PENDING;
+
+	CLKGOV_Notify( CLKGOV_EVENT_POST_CHANGE );
+	return true;
+}
+
+
+
+/*! \brief Initialize the clock governor.
+ *
+ *  This function must be called once, with the device running from the
+ *  2 MHz RC oscillator as after reset. No clients are notified of the
+ *  initial switch.
+ *
+ *  \param level  Initial performance level.
+ */
+void CLKGOV_Init( CLKGOV_Level_t level )
+{
+	CLKGOV_state.level = CLKGOV_LEVEL_LOW;
+	CLKGOV_state.pendingLevel = CLKGOV_NO_PENDING;
+	CLKGOV_state.holdCount = 0;
+	CLKGOV_state.lowLoadCount = 0;
+	CLKGOV_state.clientCount = 0;
+	CLKGOV_ConfigPolicy( CLKGOV_DEFAULT_UP_LOAD,
+	                     CLKGOV_DEFAULT_DOWN_LOAD,
+	                     CLKGOV_DEFAULT_DOWN_DELAY );
+
+	if (level != CLKGOV_LEVEL_LOW) {
+		CLKGOV_Start( level );
+		CLKGOV_Switch( level );
+	}
+}
+
+
+/*! \brief Register a notification function.
+ *
+ *  \param notify  Function called before and after every clock change.
+ *
+ *  \return  True if registered, false if all client slots are in use.
+ */
+bool CLKGOV_RegisterClient( CLKGOV_Notify_t notify )
+{
+	if (CLKGOV_state.clientCount >= CLKGOV_MAX_CLIENTS) {
+		return false;
+	}
+	CLKGOV_state.clients[CLKGOV_state.clientCount++] = notify;
+	return true;
+}
+
+
+/*! \brief Configure the load policy used by CLKGOV_Update().
+ *
+ *  A load at or above \c upLoad selects the highest level directly, to
+ *  finish the work and return to a low level as soon as possible. The
+ *  level is lowered one step after \c downDelay consecutive updates with
+ *  a load below \c downLoad, unless the load scaled to the lower clock
+ *  would reach \c upLoad and raise the level again at the next update.
+ *
+ *  \param upLoad     Load threshold for raising the level, in percent.
+ *  \param downLoad   Load threshold for lowering the level, in percent.
+ *  \param downDelay  Consecutive low-load updates before lowering the level.
+ */
+void CLKGOV_ConfigPolicy( uint8_t upLoad, uint8_t downLoad, uint8_t downDelay )
+{
+	CLKGOV_state.upLoad = upLoad;
+	CLKGOV_state.downLoad = downLoad;
+	CLKGOV_state.downDelay = downDelay;
+}
+
+
+/*! \brief Select a performance level.
+ *
+ *  If the governor is held, the change is deferred until the governor is
+ *  released and CLKGOV_Update() or CLKGOV_SetLevel() is called again.
+ *
+ *  The oscillator of the new level is started with interrupts enabled. The
+ *  hold count is then checked and the clock switched, notifications
+ *  included, with interrupts disabled, so that a hold taken by an interrupt
+ *  handler either defers the change or comes after it. A hold taken in the
+ *  pre-change notification also defers the change.
+ *
+ *  \param level  The new level.
+ *
+ *  \return  True if the level was changed, false if deferred.
+ */
+bool CLKGOV_SetLevel( CLKGOV_Level_t level )
+{
+	bool changed;
+
+	if (level == CLKGOV_state.level) {
+		CLKGOV_state.pendingLevel = CLKGOV_NO_PENDING;
+		CLKGOV_StopUnused( level );
+		return true;
+	}
+
+	if (CLKGOV_state.holdCount != 0) {
+		CLKGOV_state.pendingLevel = level;
+		return false;
+	}
+
+	CLKGOV_Start( level );
+
+	AVR_ENTER_CRITICAL_REGION( );
+	changed = ( CLKGOV_state.holdCount == 0 );
+	if (changed) {
+		changed = CLKGOV_Switch( level );
+	} else {
+		CLKGOV_state.pendingLevel = level;
+	}
+	AVR_LEAVE_CRITICAL_REGION( );
+
+	return changed;
+}
+
+
+/*! \brief Update the performance level from the CPU load.
+ *
+ *  This function is meant to be called periodically from the main loop
+ *  with the CPU load over the last period. It also applies a change that
+ *  was deferred by a hold.
+ *
+ *  \param load  CPU load in percent.
+ */
+void CLKGOV_Update( uint8_t load )
+{
+	uint8_t level = CLKGOV_state.pendingLevel;
+
+	if (load >= CLKGOV_state.upLoad) {
+		CLKGOV_state.lowLoadCount = 0;
+		level = CLKGOV_LEVEL_HIGH;
+	} else if (load < CLKGOV_state.downLoad) {
+		if (++CLKGOV_state.lowLoadCount >= CLKGOV_state.downDelay) {
+			CLKGOV_state.lowLoadCount = 0;
+			if (CLKGOV_state.level != CLKGOV_LEVEL_LOW) {
+				uint8_t lower = CLKGOV_state.level - 1;
+				uint32_t scaled = (uint32_t) load *
+				                  ( CLKGOV_levels[CLKGOV_state.level].perHz /
+				                    CLKGOV_levels[lower].perHz );
+
+				if (scaled < CLKGOV_state.upLoad) {
+					level = lower;
+				}
+			}
+		}
+	} else {
+		CLKGOV_state.lowLoadCount = 0;
+	}
+
+	if (level != CLKGOV_NO_PENDING) {
+		CLKGOV_SetLevel( (CLKGOV_Level_t) level );
+	}
+}
+
+
+/*! \brief Hold the current clock.
+ *
+ *  Clients call this function before starting clock dependent activity
+ *  that must not be interrupted by a clock change, for instance a
+ *  transfer, and CLKGOV_Release() when it has completed. Holds may be
+ *  nested and may be taken from interrupt handlers; interrupts are disabled
+ *  from the last check of the holds to the post-change notification.
+ */
+void CLKGOV_Hold( void )
+{
+	AVR_ENTER_CRITICAL_REGION( );
+	++CLKGOV_state.holdCount;
+	AVR_LEAVE_CRITICAL_REGION( );
+}
+
+
+/*! \brief Release a hold taken with CLKGOV_Hold(). */
+void CLKGOV_Release( void )
+{
+	AVR_ENTER_CRITICAL_REGION( );
+	if (CLKGOV_state.holdCount != 0) {
+		--CLKGOV_state.holdCount;
+	}
+	AVR_LEAVE_CRITICAL_REGION( );
+}
+
+
+/*! \brief Get the current performance level. */
+CLKGOV_Level_t CLKGOV_GetLevel( void )
+{
+	return CLKGOV_state.level;
+}
+
+
+/*! \brief Get the current clkPER frequency in Hz. */
+uint32_t CLKGOV_GetPerHz( void )
+{
+	return CLKGOV_levels[CLKGOV_state.level].perHz;
+}
+
+
+/*! \brief Get the current clkCPU frequency in Hz. */
+uint32_t CLKGOV_GetCpuHz( void )
+{
+	return CLKGOV_levels[CLKGOV_state.level].perHz;
+}
+
+
+/*! \brief Get the current clkPER4 frequency in Hz. */
+uint32_t CLKGOV_GetPer4Hz( void )
+{
+	return CLKGOV_levels[CLKGOV_state.level].per4Hz;
+}
@@ -0,0 +1,132 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Clock System governor header file.
+ *
+ *      This file contains the function prototypes and type definitions for the
+ *      clock governor. The governor switches the system clock at runtime
+ *      between a few performance levels, based on the CPU load reported by the
+ *      application. Drivers that derive baud rates, prescalers or periods from
+ *      the peripheral clock register a notification function, and are called
+ *      before and after every change so they can recompute their settings from
+ *      CLKGOV_GetPerHz(). While a driver holds the governor, for instance
+ *      during a transfer, changes are deferred.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1665 $
+ * $Date: 2008-06-05 09:21:50 +0200 (to, 05 jun 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef CLKSYS_GOVERNOR_H
+#define CLKSYS_GOVERNOR_H
+
+#include "avr_compiler.h"
+#include "clksys_driver.h"
+
+
+/* Definitions of macros. */
+
+/*! \brief Maximum number of registered notification functions. */
+#define CLKGOV_MAX_CLIENTS         4
+
+/*! \brief Default load (percent) above which the highest level is selected. */
+#define CLKGOV_DEFAULT_UP_LOAD     80
+
+/*! \brief Default load (percent) below which the level is lowered. */
+#define CLKGOV_DEFAULT_DOWN_LOAD   30
+
+/*! \brief Default number of consecutive low-load updates before lowering
+ *         the level.
+ */
+#define CLKGOV_DEFAULT_DOWN_DELAY  4
+
+
+/*! \brief Performance levels.
+ *
+ *  clkPER4, clkPER2, clkPER and clkCPU for each level:
+ *  - CLKGOV_LEVEL_LOW:  2 MHz RC, all clocks 2 MHz.
+ *  - CLKGOV_LEVEL_MID:  32 MHz RC, all clocks 32 MHz.
+ *  - CLKGOV_LEVEL_HIGH: PLL, 32 MHz RC / 4 x 8 = 64 MHz clkPER4 and
+ *    clkPER2, 32 MHz clkPER and clkCPU.
+ */
+typedef enum CLKGOV_Level_enum {
+	CLKGOV_LEVEL_LOW = 0,
+	CLKGOV_LEVEL_MID = 1,
+	CLKGOV_LEVEL_HIGH = 2,
+} CLKGOV_Level_t;
+
+/*! \brief Number of performance levels. */
+#define CLKGOV_LEVEL_COUNT   3
+
+/*! \brief Notification events. */
+typedef enum CLKGOV_Event_enum {
+	/*! The clock is about to change. Stop clock dependent activity, or take
+	 *  a hold to defer the change if such activity is starting. */
+	CLKGOV_EVENT_PRE_CHANGE,
+	/*! The clock has changed. Recompute settings from the new frequency. */
+	CLKGOV_EVENT_POST_CHANGE,
+} CLKGOV_Event_t;
+
+/*! \brief Notification function.
+ *
+ *  Called with interrupts disabled, so it must not wait for interrupts. A
+ *  post-change notification may follow a pre-change one without a change,
+ *  when a hold taken in the pre-change notification deferred it.
+ *
+ *  \param event  The notification event.
+ *  \param perHz  clkPER frequency in Hz. Before a change this is the current
+ *                frequency, after a change the new frequency.
+ */
+typedef void (*CLKGOV_Notify_t)( CLKGOV_Event_t event, uint32_t perHz );
+
+
+/* Prototyping of functions. */
+
+void CLKGOV_Init( CLKGOV_Level_t level );
+bool CLKGOV_RegisterClient( CLKGOV_Notify_t notify );
+void CLKGOV_ConfigPolicy( uint8_t upLoad, uint8_t downLoad, uint8_t downDelay );
+bool CLKGOV_SetLevel( CLKGOV_Level_t level );
+void CLKGOV_Update( uint8_t load );
+void CLKGOV_Hold( void );
+void CLKGOV_Release( void );
+CLKGOV_Level_t CLKGOV_GetLevel( void );
+uint32_t CLKGOV_GetPerHz( void );
+uint32_t CLKGOV_GetCpuHz( void );
+uint32_t CLKGOV_GetPer4Hz( void );
+
+#endif
@@ -0,0 +1,195 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Clock System governor example source.
+ *
+ *      This file contains an example application that demonstrates the clock
+ *      governor. The amount of work done every 100 ms is selected with the
+ *      switches on PORTC, and the governor changes the system clock from the
+ *      measured load. The current level is shown on PORTD.
+ *
+ *      Two clients recompute their settings when the clock changes: the
+ *      USART, sending a status character at 9600 baud, and the Timer/Counters
+ *      setting the 100 ms load measurement period. The USART holds the governor
+ *      while a character is being sent.
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "avr_compiler.h"
+#include "clksys_governor.h"
+
+/* The LEDs to use for visual feedback. */
+#define LEDPORT PORTD
+#define LEDMASK 0xFF
+
+/* Which switches to listen to. */
+#define SWITCHPORT PORTC
+#define SWITCHMASK 0xFF
+
+/* USART used for status output, TXD on PE3. */
+#define USART USARTE0
+#define USART_BAUDRATE 9600
+
+/* Load measurement period in ms. */
+#define PERIOD_MS 100
+
+
+/* Prototype functions. */
+void UsartClient( CLKGOV_Event_t event, uint32_t perHz );
+void TimerClient( CLKGOV_Event_t event, uint32_t perHz );
+
+/* Set by the period timer interrupt. */
+volatile bool periodElapsed;
+
+
+/*! \brief Example code running the clock governor.
+ *
+ *  TCC0 defines the measurement period and TCC1, running from the same
+ *  clock, measures the time spent working. The load is the ratio of the
+ *  two, which does not depend on the clock frequency.
+ */
+int main( void )
+{
+	uint16_t busyTicks = 0;
+
+	/* Set up user interface. */
+	LEDPORT.DIRSET = LEDMASK;
+	SWITCHPORT.DIRCLR = SWITCHMASK;
+
+	/* Set up the USART pin and frame format, 8N1. */
+	PORTE.DIRSET = PIN3_bm;
+	PORTE.OUTSET = PIN3_bm;
+	USART.CTRLC = USART_CHSIZE_8BIT_gc;
+
+	CLKGOV_Init( CLKGOV_LEVEL_LOW );
+	CLKGOV_RegisterClient( UsartClient );
+	CLKGOV_RegisterClient( TimerClient );
+
+	/* Apply the settings for the initial clock. */
+	UsartClient( CLKGOV_EVENT_POST_CHANGE, CLKGOV_GetPerHz() );
+	TimerClient( CLKGOV_EVENT_POST_CHANGE, CLKGOV_GetPerHz() );
+
+	TCC0.INTCTRLA = TC_OVFINTLVL_LO_gc;
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	while (1) {
+		uint16_t start;
+		uint16_t work;
+
+		/* Do the amount of work selected by the switches. */
+		start = TCC1.CNT;
+		for (work = (uint8_t) ~SWITCHPORT.IN; work > 0; --work) {
+			delay_us( 100 );
+		}
+		busyTicks += TCC1.CNT - start;
+
+		if (periodElapsed) {
+			uint8_t load;
+
+			periodElapsed = false;
+			load = (uint8_t) ( ( (uint32_t) busyTicks * 100 ) / ( TCC0.PER + 1 ) );
+			busyTicks = 0;
+
+			CLKGOV_Update( load > 100 ? 100 : load );
+			LEDPORT.OUT = ~( 1 << CLKGOV_GetLevel() );
+
+			/* Send the level while holding the clock. The hold is
+			 * released by the transmit complete interrupt. */
+			CLKGOV_Hold();
+			USART.STATUS = USART_TXCIF_bm;
+			USART.DATA = '0' + CLKGOV_GetLevel();
+		}
+	}
+}
+
+
+/*! \brief USART client. Recomputes the baud rate from the new clock.
+ *
+ *  A transmission is never in progress here, as the transmission holds
+ *  the governor.
+ */
+void UsartClient( CLKGOV_Event_t event, uint32_t perHz )
+{
+	if (event == CLKGOV_EVENT_PRE_CHANGE) {
+		USART.CTRLB &= ~USART_TXEN_bm;
+	} else {
+		uint16_t bsel = ( perHz + 8UL * USART_BAUDRATE ) / ( 16UL * USART_BAUDRATE ) - 1;
+
+		USART.BAUDCTRLA = (uint8_t) bsel;
+		USART.BAUDCTRLB = (uint8_t) ( bsel >> 8 );
+		USART.CTRLA = USART_TXCINTLVL_LO_gc;
+		USART.CTRLB |= USART_TXEN_bm;
+	}
+}
+
+
+/*! \brief Timer client. Recomputes the measurement period from the new
+ *         clock.
+ */
+void TimerClient( CLKGOV_Event_t event, uint32_t perHz )
+{
+	if (event == CLKGOV_EVENT_PRE_CHANGE) {
+		TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+		TCC1.CTRLA = TC_CLKSEL_OFF_gc;
+	} else {
+		/* Longest period that fits in 16 bits: clkPER/1024 at 32 MHz. */
+		TCC0.PER = (uint16_t) ( perHz / 1024 * PERIOD_MS / 1000 ) - 1;
+		TCC0.CNT = 0;
+		TCC1.PER = 0xFFFF;
+		TCC0.CTRLA = TC_CLKSEL_DIV1024_gc;
+		TCC1.CTRLA = TC_CLKSEL_DIV1024_gc;
+	}
+}
+
+
+/*! \brief Measurement period interrupt. */
+ISR(TCC0_OVF_vect)
+{
+	periodElapsed = true;
+}
+
+
+/*! \brief Transmit complete. Releases the hold on the clock. */
+ISR(USARTE0_TXC_vect)
+{
+	CLKGOV_Release();
+}
@@ -0,0 +1,492 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host drift simulation test of the oscillator calibration service.
+ *
+ *      This program runs the calibration service of clksys_calibration.c on the
+ *      host simulator, with the oscillators given a frequency error and the
+ *      DFLLs, the RTC and the 32.768 kHz crystal on TOSC modelled, and checks
+ *      what the service reports against the error it was given.
+ *
+ *      Tests:
+ *        - accuracy: CLKCAL_Measure() at 32 MHz and 2 MHz, for errors from
+ *          -2 % to +2 % and two crystal errors, over one and several RTC
+ *          periods. The error reported must be within one count of the
+ *          true error relative to the crystal, plus 2 ppm of rounding.
+ *        - lock: CLKCAL_WaitForAccurateLock() after enabling the DFLL of the
+ *          32 MHz and the 2 MHz oscillator with the crystal as reference. It
+ *          must lock, and a second call must return after one measurement.
+ *          With the 32 kHz RC oscillator as reference, the DFLL follows the
+ *          error of that oscillator and the lock must fail, with the error
+ *          reported within the bound of the one the DFLL leaves.
+ *        - sweep: a temperature sweep of the 32 MHz oscillator from -40 to
+ *          85 degrees, with a parabolic drift of the oscillator and of the
+ *          crystal. Without the DFLL, each measurement must be within the
+ *          bound and the drift table must hold the worst error of each
+ *          range. With the DFLL, the error must be within the bound of the
+ *          error the DFLL leaves: the simulated DFLL corrects in whole steps
+ *          of SIM_DFLL_STEP_PPM until the oscillator is within half a step
+ *          of the crystal, and the test follows the same steps. Half a step
+ *          would only bound the DFLL, not the measurement.
+ *
+ *      The drift curves and the DFLL step, SIM_DFLL_STEP_PPM, are assumed
+ *      figures, not measurements. The crystal takes a second to start; the
+ *      program waits for it with the CPU clock divided by 512, to save
+ *      simulation time.
+ *
+ *      Each measurement prints one line of space separated key=value pairs,
+ *      with errors in ppm and times in microseconds, and the program exits with
+ *      a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding clksys_calibration.c. The
+ *      simulator is shared with AVR1307, and needs a program linked with
+ *      -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/clkcal_drift.c \
+ *            clksys_calibration.c clksys_driver.c -o clkcal_drift
+ *        ./clkcal_drift
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2771 $
+ * $Date: 2009-09-11 11:54:26 +0200 (fr, 11 sep 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "avr_compiler.h"
+#include "clksys_calibration.h"
+#include "sim.h"
+
+/* Timer/Counter and event channel of the calibration service. */
+#define CAL_TC            TCC0
+#define CAL_CHANNEL       0
+
+/*! Error of the crystal in the accuracy test, in ppm. */
+#define XTAL_PPM          -150
+
+/*! RTC periods per measurement of the lock wait. */
+#define LOCK_PERIODS      4
+
+/*! Largest error accepted by the lock wait: half a DFLL step and the
+ *  measurement error. */
+#define LOCK_PPM          ( SIM_DFLL_STEP_PPM / 2 + 50 )
+
+/*! Measurements before the lock wait gives up. */
+#define LOCK_ATTEMPTS     6
+
+/*! RTC periods per measurement of the temperature sweep. */
+#define SWEEP_PERIODS     2
+
+/*! Temperature step of the sweep. */
+#define SWEEP_STEP        CLKCAL_TEMPERATURE_STEP
+
+/*! Number of entries of a table. */
+#define COUNT( _table )   ( sizeof(_table) / sizeof((_table)[0]) )
+
+
+/*! \brief An oscillator to calibrate. */
+typedef struct Clock_struct {
+	/*! Name in the output. */
+	const char * name;
+	/*! System clock selection. */
+	CLK_SCLKSEL_t source;
+	/*! OSC.CTRL bit of the oscillator. */
+	uint8_t oscillator;
+	/*! OSC.DFLLCTRL bit of its DFLL. */
+	uint8_t dfllRef;
+	/*! Nominal frequency. */
+	uint32_t nominalHz;
+	/*! Measurement periods of the accuracy test. */
+	uint8_t periods[2];
+} Clock_t;
+
+/*! \brief A lock test. */
+typedef struct LockTest_struct {
+	/*! Name in the output. */
+	const char * name;
+	/*! Oscillator calibrated. */
+	const Clock_t * clock;
+	/*! Error of the oscillator before the DFLL is enabled. */
+	int32_t oscPpm;
+	/*! True for the crystal as DFLL reference, false for the 32 kHz RC
+	 *  oscillator. */
+	bool crystal;
+	/*! Error of the 32 kHz RC oscillator. */
+	int32_t rc32kPpm;
+	/*! True if the lock must succeed. */
+	bool mustLock;
+} LockTest_t;
+
+
+/*! Oscillators. */
+static const Clock_t clocks[] = {
+	{ "rc32m", CLK_SCLKSEL_RC32M_gc, OSC_RC32MEN_bm, OSC_RC32MCREF_bm, 32000000UL, { 1, 4 } },
+	{ "rc2m", CLK_SCLKSEL_RC2M_gc, OSC_RC2MEN_bm, OSC_RC2MCREF_bm, 2000000UL, { 1, 2 } },
+};
+
+/*! Oscillator errors of the accuracy test, in ppm. */
+static const int32_t accuracyPpm[] = { -20000, 250, 20000 };
+
+/*! Lock tests. */
+static const LockTest_t lockTests[] = {
+	{ "rc32m_xtal", &clocks[0], 15000, true, 0, true },
+	{ "rc2m_xtal", &clocks[1], -12000, true, 0, true },
+	{ "rc32m_rc32k", &clocks[0], 15000, false, 4000, false },
+};
+
+/*! Calibration service. */
+static CLKCAL_Calibration_t calibration;
+
+/*! Where the reset handler returns to. */
+static sigjmp_buf bootPoint;
+
+
+/*! \brief Error of the 32 MHz oscillator at a temperature, in ppm. */
+static int32_t Sweep_OscPpm(int16_t temperature)
+{
+	int32_t delta = temperature - 25;
+
+	return 1500 - 3 * delta * delta;
+}
+
+
+/*! \brief Error of the crystal at a temperature, in ppm: -0.034 ppm per
+ *         square degree from 25 degrees. */
+static int32_t Sweep_XtalPpm(int16_t temperature)
+{
+	int32_t delta = temperature - 25;
+
+	return -(delta * delta * 34) / 1000;
+}
+
+
+/*! \brief Error of an oscillator relative to the crystal, which the service
+ *         measures, in ppm. */
+static double Relative_Ppm(int32_t oscPpm, int32_t xtalPpm)
+{
+	return ((1e6 + oscPpm) / (1e6 + xtalPpm) - 1.0) * 1e6;
+}
+
+
+/*! \brief Largest measurement error of the service with its current
+ *         setting: one count over the measurement, and 2 ppm of rounding. */
+static uint32_t Bound_Ppm(uint8_t periods)
+{
+	uint64_t counts = (uint64_t) calibration.nominalHz * calibration.refTicks * periods /
+	                  CLKCAL_REFERENCE_HZ;
+
+	return (uint32_t) ((1000000 + counts - 1) / counts) + 2;
+}
+
+
+/*! \brief Microseconds since the start of the simulation. */
+static uint64_t Now_Us(void)
+{
+	return SIM_GetNanoseconds() / 1000;
+}
+
+
+/*! \brief Correction a DFLL reaches.
+ *
+ *  Follows the steps of the simulated DFLL from its current correction, so
+ *  an error at exactly half a step is left where the DFLL leaves it.
+ *
+ *  \param correctionPpm  Current correction, in ppm.
+ *  \param oscPpm         Error of the oscillator, in ppm.
+ *  \param xtalPpm        Error of the reference, in ppm.
+ *
+ *  \return  The correction after settling, in ppm.
+ */
+static int32_t Dfll_Correction(int32_t correctionPpm, int32_t oscPpm, int32_t xtalPpm)
+{
+	while (oscPpm + correctionPpm - xtalPpm > SIM_DFLL_STEP_PPM / 2) {
+		correctionPpm -= SIM_DFLL_STEP_PPM;
+	}
+	while (oscPpm + correctionPpm - xtalPpm < -(SIM_DFLL_STEP_PPM / 2)) {
+		correctionPpm += SIM_DFLL_STEP_PPM;
+	}
+	return correctionPpm;
+}
+
+
+/*! \brief Let the time a DFLL needs to correct a change of error pass. */
+static void Dfll_Settle(int32_t changePpm)
+{
+	uint32_t steps = labs(changePpm) / SIM_DFLL_STEP_PPM + 2;
+
+	SIM_Run(steps * (SIM_CLK_GetCpuHz() / 1000));
+}
+
+
+/*! \brief Reset handler: return to App_Reset(). */
+static void Harness_Reset(void)
+{
+	siglongjmp(bootPoint, 1);
+}
+
+
+/*! \brief Reset the device, so that each test starts from the reset state.
+ *
+ *  The errors of the oscillators are kept and are set again by each test.
+ */
+static void App_Reset(void)
+{
+	SIM_SetResetHandler(Harness_Reset);
+	if (sigsetjmp(bootPoint, 1) == 0) {
+		SIM_Reset(RST_PORF_bm);
+	}
+	SIM_SetResetHandler(NULL);
+}
+
+
+/*! \brief Start the calibration service and run from an oscillator. */
+static void App_Init(const Clock_t * clock)
+{
+	/* Wait for the crystal with a slow clock. */
+	CLKSYS_Prescalers_Config( CLK_PSADIV_512_gc, CLK_PSBCDIV_1_1_gc );
+	CLKCAL_Init( &calibration, &CAL_TC, CAL_CHANNEL, 2000000UL / 512 );
+	CLKSYS_Prescalers_Config( CLK_PSADIV_1_gc, CLK_PSBCDIV_1_1_gc );
+
+	if (clock->source != CLK_SCLKSEL_RC2M_gc) {
+		CLKSYS_Enable( clock->oscillator );
+		do {} while ( CLKSYS_IsReady( clock->oscillator ) == 0 );
+		CLKSYS_Main_ClockSource_Select( clock->source );
+	}
+	CLKCAL_SetNominalFrequency( &calibration, clock->nominalHz );
+}
+
+
+/*! \brief Measure an oscillator with errors from -2 % to +2 %.
+ *
+ *  \return  True if every measurement is within the bound.
+ */
+static bool Test_Accuracy(const Clock_t * clock, int32_t xtalPpm)
+{
+	bool success = true;
+	uint8_t d;
+	uint8_t p;
+
+	SIM_OSC_SetDrift(OSC_XOSCEN_bm, xtalPpm);
+	App_Reset();
+	App_Init(clock);
+
+	for (d = 0; d < COUNT(accuracyPpm); d++) {
+		double expected = Relative_Ppm(accuracyPpm[d], xtalPpm);
+		bool ok = true;
+
+		SIM_OSC_SetDrift(clock->oscillator, accuracyPpm[d]);
+		printf("test=accuracy clock=%s xtal_ppm=%ld osc_ppm=%ld expected_ppm=%.1f",
+		        clock->name, (long) xtalPpm, (long) accuracyPpm[d], expected);
+		for (p = 0; p < COUNT(clock->periods); p++) {
+			uint8_t periods = clock->periods[p];
+			uint32_t bound = Bound_Ppm(periods);
+			bool measured = CLKCAL_Measure( &calibration, periods, CLKCAL_TEMPERATURE_UNKNOWN );
+			int16_t ppm = CLKCAL_GetErrorPpm( &calibration );
+
+			printf(" periods=%u ppm=%d bound=%lu measured_hz=%lu", periods, ppm,
+			        (unsigned long) bound,
+			        (unsigned long) CLKCAL_GetMeasuredHz( &calibration ) );
+			ok &= measured && (ppm >= expected - bound) && (ppm <= expected + bound);
+		}
+		printf(" result=%s\n", ok ? "pass" : "fail");
+		success &= ok;
+	}
+	SIM_OSC_SetDrift(clock->oscillator | OSC_XOSCEN_bm, 0);
+	return success;
+}
+
+
+/*! \brief Enable a DFLL and wait for the lock.
+ *
+ *  \return  True if the lock succeeds or fails as expected.
+ */
+static bool Test_Lock(const LockTest_t * test)
+{
+	const Clock_t * clock = test->clock;
+	uint32_t bound = Bound_Ppm(LOCK_PERIODS);
+	uint64_t start;
+	uint64_t lockUs;
+	uint64_t againUs;
+	uint64_t againMaxUs;
+	bool locked;
+	bool again;
+	int16_t ppm;
+	bool ok;
+
+	SIM_OSC_SetDrift(clock->oscillator, test->oscPpm);
+	SIM_OSC_SetDrift(OSC_RC32KEN_bm, test->rc32kPpm);
+	App_Reset();
+	App_Init(clock);
+	bound = Bound_Ppm(LOCK_PERIODS);
+	if (!test->crystal) {
+		CLKSYS_Enable( OSC_RC32KEN_bm );
+		do {} while ( CLKSYS_IsReady( OSC_RC32KRDY_bm ) == 0 );
+	}
+
+	start = Now_Us();
+	CLKSYS_AutoCalibration_Enable( clock->dfllRef, test->crystal );
+	locked = CLKCAL_WaitForAccurateLock( &calibration, LOCK_PPM, LOCK_PERIODS, LOCK_ATTEMPTS );
+	lockUs = Now_Us() - start;
+	ppm = CLKCAL_GetErrorPpm( &calibration );
+
+	/* Already accurate: one measurement, synchronization included. */
+	start = Now_Us();
+	again = CLKCAL_WaitForAccurateLock( &calibration, LOCK_PPM, LOCK_PERIODS, LOCK_ATTEMPTS );
+	againUs = Now_Us() - start;
+	againMaxUs = (uint64_t) (LOCK_PERIODS + 2) * calibration.refTicks * 1000000 /
+	             CLKCAL_REFERENCE_HZ;
+
+	printf("test=lock case=%s osc_ppm=%ld reference=%s locked=%u lock_us=%lu ppm=%d"
+	        " limit_ppm=%u again=%u again_us=%lu again_max_us=%lu",
+	        test->name, (long) test->oscPpm, test->crystal ? "xtal" : "rc32k", locked,
+	        (unsigned long) lockUs, ppm, LOCK_PPM, again, (unsigned long) againUs,
+	        (unsigned long) againMaxUs);
+
+	if (test->mustLock) {
+		ok = locked && again && (againUs <= againMaxUs);
+	} else {
+		/* Locked to the RC oscillator, off by its error. */
+		int32_t correctionPpm = Dfll_Correction(0, test->oscPpm, test->rc32kPpm);
+		double expected = Relative_Ppm(test->oscPpm + correctionPpm, 0);
+
+		ok = !locked && !again &&
+		     (ppm >= expected - bound) && (ppm <= expected + bound);
+	}
+	printf(" result=%s\n", ok ? "pass" : "fail");
+
+	SIM_OSC_SetDrift(clock->oscillator | OSC_RC32KEN_bm, 0);
+	return ok;
+}
+
+
+/*! \brief Sweep the temperature of the 32 MHz oscillator and the crystal.
+ *
+ *  \param dfll  True to run with the DFLL enabled.
+ *
+ *  \return  True if the measurements and the drift table are as expected.
+ */
+static bool Test_Sweep(bool dfll)
+{
+	const Clock_t * clock = &clocks[0];
+	int16_t worst[CLKCAL_TEMPERATURE_BINS] = { 0 };
+	uint32_t bound;
+	int32_t previousPpm = 0;
+	int32_t correctionPpm = 0;
+	bool success = true;
+	int16_t temperature;
+	uint8_t i;
+
+	SIM_OSC_SetDrift( clock->oscillator, Sweep_OscPpm( CLKCAL_TEMPERATURE_MIN ) );
+	SIM_OSC_SetDrift( OSC_XOSCEN_bm, Sweep_XtalPpm( CLKCAL_TEMPERATURE_MIN ) );
+	App_Reset();
+	App_Init(clock);
+	bound = Bound_Ppm(SWEEP_PERIODS);
+	if (dfll) {
+		CLKSYS_AutoCalibration_Enable( clock->dfllRef, true );
+	}
+	CLKCAL_ClearStatistics( &calibration );
+
+	for (temperature = CLKCAL_TEMPERATURE_MIN; temperature <= 85; temperature += SWEEP_STEP) {
+		int32_t oscPpm = Sweep_OscPpm(temperature);
+		int32_t xtalPpm = Sweep_XtalPpm(temperature);
+		double expected;
+		int16_t bin = ( temperature - CLKCAL_TEMPERATURE_MIN ) / CLKCAL_TEMPERATURE_STEP;
+		int16_t ppm;
+		bool ok;
+
+		SIM_OSC_SetDrift(clock->oscillator, oscPpm);
+		SIM_OSC_SetDrift(OSC_XOSCEN_bm, xtalPpm);
+		if (dfll) {
+			Dfll_Settle(oscPpm - previousPpm);
+		}
+		previousPpm = oscPpm;
+		if (dfll) {
+			correctionPpm = Dfll_Correction(correctionPpm, oscPpm, xtalPpm);
+		}
+		expected = Relative_Ppm(oscPpm + correctionPpm, xtalPpm);
+
+		ok = CLKCAL_Measure( &calibration, SWEEP_PERIODS, (int8_t) temperature );
+		ppm = CLKCAL_GetErrorPpm( &calibration );
+		ok &= (ppm >= expected - bound) && (ppm <= expected + bound);
+		if (abs(ppm) > abs(worst[bin])) {
+			worst[bin] = ppm;
+		}
+
+		printf("test=sweep dfll=%s temperature=%d osc_ppm=%ld xtal_ppm=%ld"
+		        " correction_ppm=%ld expected_ppm=%.1f ppm=%d bound=%lu result=%s\n",
+		        dfll ? "on" : "off", temperature, (long) oscPpm, (long) xtalPpm,
+		        (long) correctionPpm, expected, ppm, (unsigned long) bound,
+		        ok ? "pass" : "fail");
+		success &= ok;
+	}
+
+	/* The drift table holds the worst error of each 10 degree range. */
+	printf("test=drift_table dfll=%s ppm_min=%d ppm_max=%d count=%u table=",
+	        dfll ? "on" : "off", calibration.ppmMin, calibration.ppmMax,
+	        calibration.measurementCount);
+	for (i = 0; i < CLKCAL_TEMPERATURE_BINS; i++) {
+		printf("%s%d", (i == 0) ? "" : ",", calibration.drift[i]);
+		success &= (calibration.drift[i] == worst[i]);
+	}
+	printf(" result=%s\n", success ? "pass" : "fail");
+
+	SIM_OSC_SetDrift(clock->oscillator | OSC_XOSCEN_bm, 0);
+	return success;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	for (i = 0; i < COUNT(clocks); i++) {
+		success &= Test_Accuracy(&clocks[i], 0);
+		success &= Test_Accuracy(&clocks[i], XTAL_PPM);
+	}
+	for (i = 0; i < COUNT(lockTests); i++) {
+		success &= Test_Lock(&lockTests[i]);
+	}
+	success &= Test_Sweep(false);
+	success &= Test_Sweep(true);
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
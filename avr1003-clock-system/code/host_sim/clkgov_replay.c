@@ -0,0 +1,708 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host load trace replay test of the clock governor.
+ *
+ *      This program replays traces of work and of USART commands on the host
+ *      simulator, with the clock system modelled, and runs the clock governor of
+ *      clksys_governor.c on them with a fixed level or a load policy. It reports
+ *      the job latency, the energy, the time spent at each level and the number of
+ *      switches, and checks that no clock change overlaps a held transaction.
+ *
+ *      The application is the one of clksys_governor_example.c: TCC0 defines the
+ *      load measurement period and is recomputed by a governor client, and the
+ *      main loop calls CLKGOV_Update() with the load of each period. Jobs arrive
+ *      at the times of the trace and take a fixed number of CPU cycles; the main
+ *      loop runs them in arrival order and is idle otherwise. Commands arrive on
+ *      USARTE0 at 9600 baud. The falling edge of the start bit on RXD (PE2) holds
+ *      the governor, through a pin change interrupt or, when that interrupt is
+ *      pending, in the pre-change notification. The receive complete interrupt
+ *      keeps the hold and sends a reply, and the transmit complete interrupt
+ *      releases it. A client recomputes the baud rate, and counts a violation for
+ *      a pre-change notification during a reply, or a command received between
+ *      the pre-change and post-change notifications.
+ *
+ *      Traces:
+ *        - bursty: bursts of work every half second, idle in between.
+ *        - steady_low: a small job every 10 ms, a few percent load at 2 MHz.
+ *        - mixed: random job sizes and arrival times, about 40 % load at 2 MHz.
+ *        - churn: a load that fits the high levels but not the low one, with
+ *          commands every 4 to 6 ms. The governor must not step down to the
+ *          low level and jump back up every few periods.
+ *
+ *      Policies: the three fixed levels, the default policy and a fast policy
+ *      (60 %, 20 %, one period). Every policy must receive and reply to every
+ *      command without frame errors or violations. The governed policies must
+ *      use no more energy than the fixed high level, give no longer average
+ *      latency than the fixed low level, and an average latency at most
+ *      MAX_LATENCY_VS_HIGH times that of the fixed high level. The limit
+ *      allows for steady_low, whose load never leaves the low level: its jobs
+ *      run at 2 MHz, 16 times slower, by design.
+ *
+ *      The energy is computed from assumed typical supply currents of each level,
+ *      active and idle, at 3.0 V; they are not measurements and only serve to
+ *      compare the policies. The idle time is counted as idle sleep. Switching
+ *      time and oscillator start-up are counted as active at the old level.
+ *
+ *      Each run prints one line of space separated key=value pairs, with times in
+ *      microseconds unless the key says otherwise, and the program exits with a
+ *      non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding clksys_governor.c. The simulator
+ *      is shared with AVR1307, and needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/clkgov_replay.c \
+ *            clksys_governor.c clksys_driver.c -o clkgov_replay
+ *        ./clkgov_replay
+ *
+ * \par Application note:
+ *      AVR1003: Using the XMEGA Clock System
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2771 $
+ * $Date: 2009-09-11 11:54:26 +0200 (fr, 11 sep 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "clksys_governor.h"
+#include "sim.h"
+
+/* USART receiving the commands. */
+#define USART             USARTE0
+#define USART_BAUDRATE    9600
+
+/*! Load measurement period in ms. */
+#define PERIOD_MS         10
+
+/*! Bytes in the reply to a command. */
+#define REPLY_LENGTH      2
+
+/*! Trace length. */
+#define RUN_MS            4000
+
+/*! Time allowed after the trace for the last reply. */
+#define DRAIN_MS          50
+
+/*! CPU cycles of work run between checks for commands. */
+#define CHUNK_CYCLES      200
+
+/*! Longest idle step of the main loop. */
+#define IDLE_US           100
+
+/*! Largest number of jobs and commands of a trace. */
+#define MAX_JOBS          4096
+#define MAX_COMMANDS      1024
+
+/*! Supply voltage of the energy figures. */
+#define SUPPLY_MV         3000
+
+/*! Largest average latency of a governed policy, relative to the fixed high
+ *  level. */
+#define MAX_LATENCY_VS_HIGH  20
+
+/*! Number of policies. */
+#define POLICY_COUNT      ( sizeof(policies) / sizeof(policies[0]) )
+
+
+/*! \brief A job of the main loop. */
+typedef struct Job_struct {
+	/*! Arrival time. */
+	uint32_t arrivalUs;
+	/*! CPU cycles of work. */
+	uint32_t cycles;
+} Job_t;
+
+/*! \brief Generated trace. */
+typedef struct Trace_struct {
+	const char * name;
+	Job_t jobs[MAX_JOBS];
+	uint16_t jobCount;
+	/*! Arrival times of the commands. */
+	uint32_t commandUs[MAX_COMMANDS];
+	uint16_t commandCount;
+} Trace_t;
+
+/*! \brief Clock policy. */
+typedef struct Policy_struct {
+	const char * name;
+	/*! CLKGOV_Update() is called with the load of each period. */
+	bool governed;
+	/*! Level from start, the fixed level if not governed. */
+	CLKGOV_Level_t level;
+	uint8_t upLoad;
+	uint8_t downLoad;
+	uint8_t downDelay;
+} Policy_t;
+
+/*! \brief Result of one run. */
+typedef struct Result_struct {
+	double energyUj;
+	double latencyAvgUs;
+} Result_t;
+
+
+static const Policy_t policies[] = {
+	{ "fixed_low",  false, CLKGOV_LEVEL_LOW,  0, 0, 0 },
+	{ "fixed_mid",  false, CLKGOV_LEVEL_MID,  0, 0, 0 },
+	{ "fixed_high", false, CLKGOV_LEVEL_HIGH, 0, 0, 0 },
+	{ "governor",   true,  CLKGOV_LEVEL_LOW,
+	  CLKGOV_DEFAULT_UP_LOAD, CLKGOV_DEFAULT_DOWN_LOAD, CLKGOV_DEFAULT_DOWN_DELAY },
+	{ "fast",       true,  CLKGOV_LEVEL_LOW,  60, 20, 1 },
+};
+
+/*! Assumed typical supply current of each level running and idle, in uA. */
+static const uint16_t activeUa[CLKGOV_LEVEL_COUNT] = { 800, 9500, 11000 };
+static const uint16_t idleUa[CLKGOV_LEVEL_COUNT] = { 250, 3800, 4500 };
+
+
+/*! Trace replayed. */
+static Trace_t trace;
+
+/*! Latency of each completed job. */
+static uint32_t latencies[MAX_JOBS];
+
+/*! Boot point of each run, see Harness_Reset(). */
+static sigjmp_buf bootPoint;
+
+/*! State of the pseudo-random sequence. */
+static uint32_t randomSeed;
+
+/*! Set by the period timer interrupt. */
+static volatile bool periodElapsed;
+
+/*! A reply is being sent, from the command to transmit complete. */
+static volatile bool replyActive;
+
+/*! Between the pre-change and post-change notifications. */
+static volatile bool switching;
+
+/*! Bytes of the reply sent. */
+static volatile uint8_t replyIndex;
+
+/*! A hold was taken for the character on RXD. */
+static volatile bool rxHeld;
+
+/*! Level at the last pre-change notification. */
+static CLKGOV_Level_t preChangeLevel;
+
+/*! Counters of the run. */
+static volatile uint32_t violations;
+static volatile uint32_t overruns;
+static volatile uint32_t rxErrors;
+static volatile uint32_t commandsReceived;
+static uint32_t switches;
+
+/*! Time accounted for, and the energy and time per level. */
+static uint64_t accountedNs;
+static double energyUaNs;
+static uint64_t levelNs[CLKGOV_LEVEL_COUNT];
+
+
+/*! \brief Next value of the pseudo-random sequence, in 0 to \a range - 1. */
+static uint32_t Random_Next(uint32_t range)
+{
+	randomSeed = randomSeed * 1103515245UL + 12345UL;
+	return ((randomSeed >> 8) & 0xFFFFFF) % range;
+}
+
+
+/*! \brief Add commands \a minUs to \a maxUs apart. */
+static void Trace_AddCommands(uint32_t minUs, uint32_t maxUs)
+{
+	uint32_t us = Random_Next(minUs);
+
+	trace.commandCount = 0;
+	while ((us < RUN_MS * 1000UL) && (trace.commandCount < MAX_COMMANDS)) {
+		trace.commandUs[trace.commandCount++] = us;
+		us += minUs + Random_Next(maxUs - minUs + 1);
+	}
+}
+
+
+/*! \brief Add a job to the trace. */
+static void Trace_AddJob(uint32_t arrivalUs, uint32_t cycles)
+{
+	if ((arrivalUs < RUN_MS * 1000UL) && (trace.jobCount < MAX_JOBS)) {
+		trace.jobs[trace.jobCount].arrivalUs = arrivalUs;
+		trace.jobs[trace.jobCount].cycles = cycles;
+		trace.jobCount++;
+	}
+}
+
+
+/*! \brief Generate a trace.
+ *
+ *  \param index  Trace number.
+ *
+ *  \return  False if there is no such trace.
+ */
+static bool Trace_Generate(uint8_t index)
+{
+	uint32_t us;
+	uint8_t i;
+
+	randomSeed = 1 + index;
+	trace.jobCount = 0;
+	switch (index) {
+	case 0:
+		/* 20 jobs of 10 ms at 2 MHz every 500 ms. */
+		trace.name = "bursty";
+		for (us = 5000; us < RUN_MS * 1000UL; us += 500000UL) {
+			for (i = 0; i < 20; i++) {
+				Trace_AddJob(us, 20000);
+			}
+		}
+		Trace_AddCommands(10000, 40000);
+		break;
+	case 1:
+		trace.name = "steady_low";
+		for (us = 0; us < RUN_MS * 1000UL; us += 10000) {
+			Trace_AddJob(us, 2000);
+		}
+		Trace_AddCommands(10000, 40000);
+		break;
+	case 2:
+		/* 15500 cycles every 20 ms on average. */
+		trace.name = "mixed";
+		for (us = Random_Next(40000); us < RUN_MS * 1000UL; us += Random_Next(40000)) {
+			Trace_AddJob(us, 1000 + Random_Next(29001));
+		}
+		Trace_AddCommands(10000, 40000);
+		break;
+	case 3:
+		/* Overload at 2 MHz, 16 % load at 32 MHz: the load scaled to
+		 * the low level keeps the governor from stepping down. */
+		trace.name = "churn";
+		for (us = 0; us < RUN_MS * 1000UL; us += 1000) {
+			Trace_AddJob(us, 5000);
+		}
+		Trace_AddCommands(4000, 6000);
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+
+/*! \brief Account the time since the last call.
+ *
+ *  \param level  Level the time was spent at.
+ *  \param busy   The time was spent running jobs.
+ *
+ *  \return  The time in nanoseconds.
+ */
+static uint64_t Account(CLKGOV_Level_t level, bool busy)
+{
+	uint64_t now = SIM_GetNanoseconds();
+	uint64_t elapsed = now - accountedNs;
+
+	accountedNs = now;
+	levelNs[level] += elapsed;
+	energyUaNs += (double) (busy ? activeUa[level] : idleUa[level]) * elapsed;
+	return elapsed;
+}
+
+
+/*! \brief Convert microseconds to CPU cycles at the current clock, at least 1. */
+static uint32_t Us_ToCycles(uint32_t us)
+{
+	uint32_t cycles = (uint32_t) ((uint64_t) us * SIM_CLK_GetCpuHz() / 1000000UL);
+
+	return (cycles == 0) ? 1 : cycles;
+}
+
+
+/*! \brief Hold the governor for the character starting on RXD.
+ *
+ *  The pin change interrupt is disabled until the character is received,
+ *  so the edges of its data bits do not take more holds.
+ */
+static void Rx_Hold(void)
+{
+	PORTE.INT0MASK = 0;
+	PORTE.INTFLAGS = PORT_INT0IF_bm;
+	if (!rxHeld) {
+		rxHeld = true;
+		CLKGOV_Hold();
+	}
+}
+
+
+/*! \brief USART client. Recomputes the baud rate from the new clock.
+ *
+ *  No reply may be in progress at a change, as the reply holds the governor.
+ *  A start bit whose pin change interrupt is pending, or a low RXD, takes the
+ *  hold here, which defers the change.
+ */
+static void UsartClient( CLKGOV_Event_t event, uint32_t perHz )
+{
+	if (event == CLKGOV_EVENT_PRE_CHANGE) {
+		if (replyActive) {
+			violations++;
+		}
+		if (( PORTE.INTFLAGS & PORT_INT0IF_bm ) || !( PORTE.IN & PIN2_bm )) {
+			Rx_Hold();
+		}
+		preChangeLevel = CLKGOV_GetLevel();
+		switching = true;
+		USART.CTRLB &= ~USART_TXEN_bm;
+	} else {
+		uint16_t bsel = ( perHz + 8UL * USART_BAUDRATE ) / ( 16UL * USART_BAUDRATE ) - 1;
+
+		USART.BAUDCTRLA = (uint8_t) bsel;
+		USART.BAUDCTRLB = (uint8_t) ( bsel >> 8 );
+		USART.CTRLB |= USART_TXEN_bm;
+		switching = false;
+		if (CLKGOV_GetLevel() != preChangeLevel) {
+			switches++;
+		}
+	}
+}
+
+
+/*! \brief Timer client. Recomputes the measurement period from the new
+ *         clock.
+ */
+static void TimerClient( CLKGOV_Event_t event, uint32_t perHz )
+{
+	if (event == CLKGOV_EVENT_PRE_CHANGE) {
+		TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+	} else {
+		TCC0.PER = (uint16_t) ( perHz / 64 * PERIOD_MS / 1000 ) - 1;
+		TCC0.CNT = 0;
+		TCC0.CTRLA = TC_CLKSEL_DIV64_gc;
+	}
+}
+
+
+/*! \brief Measurement period interrupt. */
+ISR(TCC0_OVF_vect)
+{
+	periodElapsed = true;
+}
+
+
+/*! \brief Start bit on RXD. Holds the clock for the character. */
+ISR(PORTE_INT0_vect)
+{
+	Rx_Hold();
+}
+
+
+/*! \brief Command received. Keeps the hold of the start bit for the reply. */
+ISR(USARTE0_RXC_vect)
+{
+	bool frameError = USART.STATUS & USART_FERR_bm;
+
+	(void) USART.DATA;
+	if (switching || !rxHeld) {
+		violations++;
+	}
+	if (!rxHeld) {
+		CLKGOV_Hold();
+	}
+	rxHeld = false;
+	PORTE.INTFLAGS = PORT_INT0IF_bm;
+	PORTE.INT0MASK = PIN2_bm;
+	if (frameError) {
+		rxErrors++;
+		CLKGOV_Release();
+		return;
+	}
+	commandsReceived++;
+	if (replyActive) {
+		overruns++;
+		CLKGOV_Release();
+		return;
+	}
+	replyActive = true;
+	replyIndex = 0;
+	USART.STATUS = USART_TXCIF_bm;
+	USART.CTRLA = USART_RXCINTLVL_LO_gc | USART_DREINTLVL_LO_gc;
+}
+
+
+/*! \brief Send the next byte of the reply. */
+ISR(USARTE0_DRE_vect)
+{
+	USART.DATA = '0' + CLKGOV_GetLevel();
+	if (++replyIndex == REPLY_LENGTH) {
+		USART.CTRLA = USART_RXCINTLVL_LO_gc | USART_TXCINTLVL_LO_gc;
+	}
+}
+
+
+/*! \brief Reply sent. Releases the hold on the clock. */
+ISR(USARTE0_TXC_vect)
+{
+	USART.CTRLA = USART_RXCINTLVL_LO_gc;
+	replyActive = false;
+	CLKGOV_Release();
+}
+
+
+/*! \brief Reset handler: start the application of the run. */
+static void Harness_Reset(void)
+{
+	siglongjmp(bootPoint, 1);
+}
+
+
+/*! \brief Reset the device, so that each run starts from the reset state. */
+static void App_Reset(void)
+{
+	SIM_SetResetHandler(Harness_Reset);
+	if (sigsetjmp(bootPoint, 1) == 0) {
+		SIM_Reset(RST_PORF_bm);
+	}
+	SIM_SetResetHandler(NULL);
+}
+
+
+/*! \brief Start the application as after reset. */
+static void App_Init(const Policy_t * policy)
+{
+	PORTE.DIRSET = PIN3_bm;
+	PORTE.OUTSET = PIN3_bm;
+	USART.CTRLC = USART_CHSIZE_8BIT_gc;
+
+	CLKGOV_Init( policy->level );
+	if (policy->governed) {
+		CLKGOV_ConfigPolicy( policy->upLoad, policy->downLoad, policy->downDelay );
+	}
+	CLKGOV_RegisterClient( UsartClient );
+	CLKGOV_RegisterClient( TimerClient );
+	UsartClient( CLKGOV_EVENT_POST_CHANGE, CLKGOV_GetPerHz() );
+	TimerClient( CLKGOV_EVENT_POST_CHANGE, CLKGOV_GetPerHz() );
+
+	USART.CTRLA = USART_RXCINTLVL_LO_gc;
+	USART.CTRLB |= USART_RXEN_bm;
+	TCC0.INTCTRLA = TC_OVFINTLVL_LO_gc;
+
+	/* The start bit interrupt has priority over the others. */
+	PORTE.PIN2CTRL = PORT_ISC_FALLING_gc;
+	PORTE.INT0MASK = PIN2_bm;
+	PORTE.INTCTRL = PORT_INT0LVL_MED_gc;
+	PMIC.CTRL |= PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm;
+	sei();
+}
+
+
+/*! \brief Compare two latencies for qsort(). */
+static int Latency_Compare(const void * a, const void * b)
+{
+	uint32_t x = *(const uint32_t *) a;
+	uint32_t y = *(const uint32_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+
+/*! \brief Replay the trace with one policy.
+ *
+ *  \param policy  The policy.
+ *  \param result  The energy and average latency.
+ *
+ *  \return  True if the replies are complete and there is no violation.
+ */
+static bool Trace_Run(const Policy_t * policy, Result_t * result)
+{
+	uint64_t startNs;
+	uint64_t periodNs = 0;
+	uint64_t busyNs = 0;
+	uint64_t latencyTotal = 0;
+	uint16_t nextJob = 0;
+	uint16_t nextCommand = 0;
+	uint16_t replies;
+	uint8_t reply[REPLY_LENGTH];
+	uint32_t replyBytes = 0;
+	uint32_t updates = 0;
+	uint32_t loadTotal = 0;
+	bool success;
+	uint16_t i;
+
+	App_Reset();
+
+	periodElapsed = false;
+	replyActive = false;
+	switching = false;
+	rxHeld = false;
+	violations = 0;
+	overruns = 0;
+	rxErrors = 0;
+	commandsReceived = 0;
+	energyUaNs = 0;
+	memset(levelNs, 0, sizeof(levelNs));
+	startNs = SIM_GetNanoseconds();
+	accountedNs = startNs;
+
+	App_Init(policy);
+	Account(policy->level, true);
+	switches = 0;
+
+	while (SIM_GetNanoseconds() - startNs < RUN_MS * 1000000ULL) {
+		uint64_t nowUs = (SIM_GetNanoseconds() - startNs) / 1000;
+
+		if ((nextCommand < trace.commandCount) && (trace.commandUs[nextCommand] <= nowUs)) {
+			uint8_t command = 'A' + nextCommand % 26;
+
+			SIM_USART_Inject(&USART, &command, 1);
+			nextCommand++;
+		}
+
+		if ((nextJob < trace.jobCount) && (trace.jobs[nextJob].arrivalUs <= nowUs)) {
+			uint32_t remaining = trace.jobs[nextJob].cycles;
+
+			while (remaining > 0) {
+				uint32_t chunk = (remaining < CHUNK_CYCLES) ? remaining : CHUNK_CYCLES;
+				CLKGOV_Level_t level = CLKGOV_GetLevel();
+
+				SIM_Run(chunk);
+				remaining -= chunk;
+				busyNs += Account(level, true);
+			}
+			latencies[nextJob] = (uint32_t) ((SIM_GetNanoseconds() - startNs) / 1000 -
+			                                 trace.jobs[nextJob].arrivalUs);
+			latencyTotal += latencies[nextJob];
+			nextJob++;
+		} else {
+			uint64_t untilUs = IDLE_US;
+			CLKGOV_Level_t level = CLKGOV_GetLevel();
+
+			if ((nextJob < trace.jobCount) && (trace.jobs[nextJob].arrivalUs - nowUs < untilUs)) {
+				untilUs = trace.jobs[nextJob].arrivalUs - nowUs;
+			}
+			SIM_Run(Us_ToCycles((uint32_t) untilUs));
+			Account(level, false);
+		}
+
+		if (periodElapsed) {
+			uint64_t now = SIM_GetNanoseconds();
+			uint64_t elapsed = now - startNs - periodNs;
+			uint8_t load = (elapsed == 0) ? 0 : (uint8_t) ((busyNs * 100 + elapsed / 2) / elapsed);
+			CLKGOV_Level_t level = CLKGOV_GetLevel();
+
+			periodElapsed = false;
+			periodNs = now - startNs;
+			busyNs = 0;
+			if (load > 100) {
+				load = 100;
+			}
+			loadTotal += load;
+			updates++;
+			if (policy->governed) {
+				CLKGOV_Update( load );
+			}
+			Account(level, true);
+		}
+	}
+
+	/* Let the last reply complete. */
+	for (i = 0; (i < DRAIN_MS * 10) && (replyActive || !SIM_USART_IsIdle(&USART)); i++) {
+		CLKGOV_Level_t level = CLKGOV_GetLevel();
+
+		SIM_Run(Us_ToCycles(IDLE_US));
+		Account(level, false);
+	}
+	while ((replies = SIM_USART_Read(&USART, reply, sizeof(reply))) != 0) {
+		replyBytes += replies;
+	}
+
+	cli();
+	TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+	USART.CTRLA = 0;
+	USART.CTRLB = 0;
+
+	qsort(latencies, nextJob, sizeof(latencies[0]), Latency_Compare);
+	result->energyUj = energyUaNs * SUPPLY_MV / 1e12;
+	result->latencyAvgUs = (nextJob == 0) ? 0 : (double) latencyTotal / nextJob;
+
+	success = (violations == 0) && (overruns == 0) && (rxErrors == 0) &&
+	          (commandsReceived == nextCommand) &&
+	          (replyBytes == commandsReceived * REPLY_LENGTH);
+	printf("trace=%s policy=%s jobs=%u done=%u commands=%u rx_errors=%lu reply_bytes=%lu",
+	       trace.name, policy->name, trace.jobCount, nextJob, nextCommand,
+	       (unsigned long) rxErrors, (unsigned long) replyBytes);
+	if (nextJob != 0) {
+		printf(" latency_avg=%.0f latency_p95=%lu latency_max=%lu",
+		       result->latencyAvgUs, (unsigned long) latencies[nextJob * 95 / 100],
+		       (unsigned long) latencies[nextJob - 1]);
+	}
+	printf(" load_avg=%lu energy_uj=%.0f low_pct=%.1f mid_pct=%.1f high_pct=%.1f"
+	       " switches=%lu violations=%lu overruns=%lu",
+	       (unsigned long) ((updates == 0) ? 0 : loadTotal / updates), result->energyUj,
+	       100.0 * levelNs[CLKGOV_LEVEL_LOW] / (accountedNs - startNs),
+	       100.0 * levelNs[CLKGOV_LEVEL_MID] / (accountedNs - startNs),
+	       100.0 * levelNs[CLKGOV_LEVEL_HIGH] / (accountedNs - startNs),
+	       (unsigned long) switches, (unsigned long) violations, (unsigned long) overruns);
+	return success;
+}
+
+
+int main(void)
+{
+	Result_t results[POLICY_COUNT];
+	bool success = true;
+	uint8_t t;
+	uint8_t p;
+
+	for (t = 0; Trace_Generate(t); t++) {
+		for (p = 0; p < POLICY_COUNT; p++) {
+			bool ok = Trace_Run(&policies[p], &results[p]);
+
+			if (policies[p].governed) {
+				double energyRatio = results[p].energyUj / results[2].energyUj;
+				double latencyRatio = results[p].latencyAvgUs / results[0].latencyAvgUs;
+				double highRatio = results[p].latencyAvgUs / results[2].latencyAvgUs;
+
+				printf(" energy_vs_high=%.2f latency_vs_low=%.2f latency_vs_high=%.2f",
+				       energyRatio, latencyRatio, highRatio);
+				ok &= (energyRatio <= 1.0) && (latencyRatio <= 1.0) &&
+				      (highRatio <= MAX_LATENCY_VS_HIGH);
+			}
+			printf(" result=%s\n", ok ? "pass" : "fail");
+			success &= ok;
+		}
+	}
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
@@ -65,6 +65,21 @@
 //! Bitmask for all sleep mode bits.
 #define SLEEPMGR_MODE_MASK SLEEP_SMODE_gm
 
+/*! Uncomment to enable CPU load accounting in SLEEPMGR_Sleep(), see
+ *  SLEEPMGR_GetLoad() and SLEEPMGR_GetWakeCount().
+ */
+//#define SLEEPMGR_ACCOUNTING
+
+/*! \brief  Time stamp used by the load accounting.
+ *
+ * This must be a 16-bit counter that keeps running in all sleep modes used and
+ * wraps from 0xFFFF to 0, e.g. the RTC with PER = 0xFFFF. No single sleep or
+ * active period may be longer than one counter wrap.
+ */
+#define SLEEPMGR_GET_TIME() (RTC.CNT)
+//! Count rate of SLEEPMGR_GET_TIME() in Hz, here the 1.024 kHz RTC clock.
+#define SLEEPMGR_TIME_HZ 1024
+
 
 
 /*============================ TYPES =========================================*/
@@ -90,6 +105,21 @@ typedef enum SLEEPMGR_mode_enum
 	SLEEPMGR_NUM_MODES //!< Do not change! This equals the sleep mode count.
 } SLEEPMGR_mode_t;
 
+/*! \brief  Wake-up source names.
+ *
+ * Interrupt handlers that can wake the device pass one of these to
+ * SLEEPMGR_NOTE_WAKEUP(). Wake-ups from handlers that do not are counted as
+ * SLEEPMGR_NUM_WAKE_SOURCES. Do not touch the last entry, as it is used to
+ * indicate the number of wake-up sources.
+ */
+typedef enum SLEEPMGR_wake_enum
+{
+	SLEEPMGR_WAKE_RTC,
+	SLEEPMGR_WAKE_PORT,
+	SLEEPMGR_WAKE_USART,
+	SLEEPMGR_NUM_WAKE_SOURCES //!< Do not change! This equals the source count.
+} SLEEPMGR_wake_t;
+
 
 
 /*============================ MACROS ========================================*/
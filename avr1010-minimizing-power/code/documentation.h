@@ -34,6 +34,20 @@
  * necessary to perform a project clean to avoid conflict for compiled modules.
  *
  * 
+ * \section loadinfo Load Accounting
+ * The sleep manager can measure how much of the time the CPU is active, and
+ * count which interrupts wake it up. Define SLEEPMGR_ACCOUNTING and set the
+ * time stamp source in config_sleepmgr.h, then read the results with
+ * SLEEPMGR_GetLoad() and SLEEPMGR_GetWakeCount(). The time stamp must keep
+ * running in the sleep modes used, so the RTC in the examples must then be
+ * set up to count freely to 0xFFFF, with wake-ups by compare match.
+ *
+ * The accounting can also be built for a Linux x86-64 host, using the register
+ * headers and the simulator in the host_sim directory of AVR1307. See
+ * host_sim/sleepmgr_account.c for the load windows, the RTC wrap and the
+ * wake-up counts checked against sleeps of known length.
+ *
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices can be used with the supplied example codes.
  * Note that there are separate code examples for devices with 32-bit RTC, such
@@ -0,0 +1,390 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host simulation test of the sleep manager load accounting.
+ *
+ *      This program runs SLEEPMGR_Sleep() of sleepmgr.c, built with
+ *      SLEEPMGR_ACCOUNTING, on the host simulator, with the RTC as time stamp
+ *      and wake-ups by a pin change, a received USART character and a pin
+ *      change whose handler does not call SLEEPMGR_NOTE_WAKEUP(). Each period
+ *      is a sleep, the wake-up handler and some work after it, with known
+ *      lengths, and the load reported is checked against them.
+ *
+ *      Tests:
+ *        - port: 100 ms periods, 25 ms active, woken by PORTD. The RTC count
+ *          starts 6 s before it wraps from 0xFFFF to 0, so the first 10 s
+ *          window and several 1 s windows span the wrap. Both windows must
+ *          report 250 per mille, and the PORT count must equal the periods.
+ *        - usart_1s: 200 ms periods, 20 ms active, woken by USARTC0. After
+ *          3 s the 1 s window must report 100 per mille, while the 10 s
+ *          window still reports the one completed in the port test.
+ *        - usart_10s: 20 s more of the same. The 10 s window must report 100
+ *          per mille, and the USART count must equal the periods.
+ *        - unknown: 100 ms periods, woken by PORTC, with 10 ms in the handler
+ *          and 20 ms of work after it. Without SLEEPMGR_NOTE_WAKEUP() the
+ *          handler counts as sleep, so the load must be 200 per mille and the
+ *          wake-ups counted as SLEEPMGR_NUM_WAKE_SOURCES. Every time stamp
+ *          taken outside an interrupt handler must be taken with interrupts
+ *          disabled, so that a pending interrupt cannot run between the
+ *          wake-up and its time stamp.
+ *
+ *      The simulator models the RTC clock from the ULP oscillator as exactly
+ *      1 kHz, so a tick is 1 ms here against 1/1024 s on the device. Loads
+ *      may be off by LOAD_TOLERANCE per mille, for the time stamps rounding
+ *      to whole ticks. The SLEEP instruction is replaced by Test_Sleep(),
+ *      which runs the simulator through the sleep and raises the wake-up.
+ *
+ *      Each test prints one line of space separated key=value pairs, with
+ *      loads in per mille, and the program exits with a non-zero status if a
+ *      check fails.
+ *
+ *      Build and run from the directory holding sleepmgr.c, which this file
+ *      includes. The simulator is shared with AVR1307, and needs a program
+ *      linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/sleepmgr_account.c -o sleepmgr_account
+ *        ./sleepmgr_account
+ *
+ * \par Application note:
+ *      AVR1010: Minimizing the power consumption of XMEGA devices
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2770 $
+ * $Date: 2009-09-11 10:55:22 +0200 (fr, 11 sep 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SLEEPMGR_ACCOUNTING
+
+#include "avr_compiler.h"
+#include "sleepmgr.h"
+#include "sim.h"
+
+/* Build the sleep manager with the SLEEP instruction and the time stamp of
+ * this program. */
+static void Test_Sleep(void);
+static uint16_t Test_GetTime(void);
+
+#undef cpu_sleep
+#define cpu_sleep()          Test_Sleep()
+#undef SLEEPMGR_GET_TIME
+#define SLEEPMGR_GET_TIME()  Test_GetTime()
+
+#include "sleepmgr.c"
+
+/*! CPU cycles per RTC tick, 1 ms. */
+#define TICK_CYCLES       ( F_CPU / 1000 )
+
+/*! CPU cycles of a time in milliseconds. */
+#define MS( _ms )         ( (uint32_t) (_ms) * TICK_CYCLES )
+
+/*! RTC count at the start, 6 s before the count wraps. */
+#define RTC_START         ( 0xFFFF - 6000 )
+
+/*! Largest error of a load, in per mille. */
+#define LOAD_TOLERANCE    3
+
+/*! USART baud rate and the BSEL value for it. */
+#define BAUD              9600
+#define BSEL              ( F_CPU / (16UL * BAUD) - 1 )
+
+/*! CPU cycles of one USART character, 8N1. */
+#define CHAR_CYCLES       ( 10 * 16 * (BSEL + 1) )
+
+/*! CPU cycles between polls for the wake-up handler. */
+#define POLL_CYCLES       20
+
+/*! Wake-up by the PORTC handler, which does not call SLEEPMGR_NOTE_WAKEUP(). */
+#define WAKE_UNKNOWN      SLEEPMGR_NUM_WAKE_SOURCES
+
+
+/*! How the next sleep ends. */
+static uint8_t wakeSource;
+
+/*! CPU cycles of the next sleep. */
+static uint32_t sleepCycles;
+
+/*! CPU cycles in the wake-up handler. */
+static uint32_t handlerCycles;
+
+/*! Wake-up handlers run. */
+static volatile uint16_t wakeHandled;
+
+/*! Time stamps taken outside interrupt handlers with interrupts enabled. */
+static uint16_t unlockedStamps;
+
+
+/*! \brief The wake-up handler work. */
+static void Handler_Run(void)
+{
+	SIM_Run(handlerCycles);
+	wakeHandled++;
+}
+
+
+ISR(PORTD_INT0_vect)
+{
+	SLEEPMGR_NOTE_WAKEUP(SLEEPMGR_WAKE_PORT);
+	Handler_Run();
+}
+
+
+ISR(USARTC0_RXC_vect)
+{
+	SLEEPMGR_NOTE_WAKEUP(SLEEPMGR_WAKE_USART);
+	(void) USARTC0.DATA;
+	Handler_Run();
+}
+
+
+ISR(PORTC_INT0_vect)
+{
+	Handler_Run();
+}
+
+
+/*! \brief Time stamp of the sleep manager: the RTC count.
+ *
+ *  Counts the time stamps taken outside interrupt handlers with the I bit
+ *  set, which could be delayed by an interrupt.
+ */
+static uint16_t Test_GetTime(void)
+{
+	uint8_t executing = PMIC_HILVLEX_bm | PMIC_MEDLVLEX_bm | PMIC_LOLVLEX_bm;
+
+	if ((SREG & CPU_I_bm) && !(PMIC.STATUS & executing)) {
+		unlockedStamps++;
+	}
+	return RTC.CNT;
+}
+
+
+/*! \brief The SLEEP instruction: sleep for sleepCycles, then raise the
+ *         wake-up of wakeSource and return after its handler has run.
+ */
+static void Test_Sleep(void)
+{
+	uint16_t handled = wakeHandled;
+	uint8_t data = 0x55;
+
+	/* Sleep canceled. */
+	if (!(SLEEP.CTRL & SLEEP_SEN_bm)) {
+		return;
+	}
+
+	switch (wakeSource) {
+	case SLEEPMGR_WAKE_PORT:
+		SIM_Run(sleepCycles);
+		SIM_PORT_SetInput(&PORTD, 0x01);
+		SIM_PORT_SetInput(&PORTD, 0x00);
+		break;
+	case SLEEPMGR_WAKE_USART:
+		/* The character ends when the sleep does. */
+		SIM_Run(sleepCycles - CHAR_CYCLES);
+		SIM_USART_Inject(&USARTC0, &data, 1);
+		break;
+	default:
+		SIM_Run(sleepCycles);
+		SIM_PORT_SetInput(&PORTC, 0x01);
+		SIM_PORT_SetInput(&PORTC, 0x00);
+		break;
+	}
+	while (wakeHandled == handled) {
+		SIM_Run(POLL_CYCLES);
+	}
+}
+
+
+/*! \brief Run periods of sleep, wake-up handler and work.
+ *
+ *  \param source     How each sleep ends.
+ *  \param periods    Number of periods.
+ *  \param periodMs   Length of a period.
+ *  \param activeMs   Time not sleeping in a period, the handler included.
+ *  \param handlerMs  Time in the handler.
+ */
+static void Run_Periods(uint8_t source, uint16_t periods, uint16_t periodMs,
+                        uint16_t activeMs, uint16_t handlerMs)
+{
+	uint16_t i;
+
+	wakeSource = source;
+	sleepCycles = MS(periodMs - activeMs);
+	handlerCycles = MS(handlerMs);
+	for (i = 0; i < periods; i++) {
+		SLEEPMGR_Sleep();
+		SIM_Run(MS(activeMs - handlerMs));
+	}
+}
+
+
+/*! \brief Check a load against the expected one. */
+static bool Load_Ok(uint16_t load, uint16_t expected)
+{
+	return abs((int) load - (int) expected) <= LOAD_TOLERANCE;
+}
+
+
+/*! \brief Set up the RTC, the wake-up sources and the sleep manager. */
+static void Test_Init(void)
+{
+	CLK.RTCCTRL = CLK_RTCSRC_ULP_gc | CLK_RTCEN_bm;
+	RTC.PER = 0xFFFF;
+	RTC.CNT = RTC_START;
+	RTC.CTRL = RTC_PRESCALER_DIV1_gc;
+	while (RTC.STATUS & RTC_SYNCBUSY_bm) {
+	}
+
+	PORTD.PIN0CTRL = PORT_ISC_RISING_gc;
+	PORTD.INT0MASK = 0x01;
+	PORTD.INTCTRL = PORT_INT0LVL_LO_gc;
+	PORTC.PIN0CTRL = PORT_ISC_RISING_gc;
+	PORTC.INT0MASK = 0x01;
+	PORTC.INTCTRL = PORT_INT0LVL_LO_gc;
+
+	USARTC0.BAUDCTRLA = (uint8_t) BSEL;
+	USARTC0.BAUDCTRLB = (uint8_t) (BSEL >> 8);
+	USARTC0.CTRLC = USART_CMODE_ASYNCHRONOUS_gc | USART_PMODE_DISABLED_gc |
+	                USART_CHSIZE_8BIT_gc;
+	USARTC0.CTRLB = USART_RXEN_bm;
+	USARTC0.CTRLA = USART_RXCINTLVL_LO_gc;
+
+	PMIC.CTRL = PMIC_LOLVLEN_bm;
+
+	SLEEPMGR_Init();
+	/* USART wake-ups need Idle mode. */
+	SLEEPMGR_Lock(SLEEPMGR_IDLE);
+	sei();
+}
+
+
+/*! \brief The port test, across the RTC wrap. */
+static bool Test_Port(uint16_t * load10s)
+{
+	uint16_t periods = 120;
+	uint16_t load1s;
+	uint16_t wakes;
+	bool wrapped;
+	bool ok;
+
+	Run_Periods(SLEEPMGR_WAKE_PORT, periods, 100, 25, 5);
+	load1s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_1S);
+	*load10s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_10S);
+	wakes = SLEEPMGR_GetWakeCount(SLEEPMGR_WAKE_PORT);
+	wrapped = RTC.CNT < RTC_START;
+
+	ok = Load_Ok(load1s, 250) && Load_Ok(*load10s, 250) &&
+	     (wakes == periods) && wrapped;
+	printf("test=port periods=%u load_1s=%u load_10s=%u expected=250 "
+	       "wakes=%u wrapped=%u result=%s\n",
+	       periods, load1s, *load10s, wakes, wrapped, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+/*! \brief The usart tests, the windows after a change of load. */
+static bool Test_Usart(uint16_t portLoad10s)
+{
+	uint16_t periods = 15;
+	uint16_t load1s;
+	uint16_t load10s;
+	uint16_t wakes;
+	bool success = true;
+	bool ok;
+
+	SLEEPMGR_ClearWakeCounts();
+	Run_Periods(SLEEPMGR_WAKE_USART, periods, 200, 20, 4);
+	load1s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_1S);
+	load10s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_10S);
+	ok = Load_Ok(load1s, 100) && (load10s == portLoad10s);
+	success &= ok;
+	printf("test=usart_1s periods=%u load_1s=%u expected=100 load_10s=%u "
+	       "expected_10s=%u result=%s\n",
+	       periods, load1s, load10s, portLoad10s, ok ? "pass" : "fail");
+
+	Run_Periods(SLEEPMGR_WAKE_USART, 100, 200, 20, 4);
+	periods += 100;
+	load10s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_10S);
+	wakes = SLEEPMGR_GetWakeCount(SLEEPMGR_WAKE_USART);
+	ok = Load_Ok(load10s, 100) && (wakes == periods) &&
+	     (SLEEPMGR_GetWakeCount(SLEEPMGR_WAKE_PORT) == 0);
+	success &= ok;
+	printf("test=usart_10s periods=%u load_10s=%u expected=100 wakes=%u "
+	       "result=%s\n", periods, load10s, wakes, ok ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief The unknown test, wake-ups not noted by the handler. */
+static bool Test_Unknown(void)
+{
+	uint16_t periods = 25;
+	uint16_t load1s;
+	uint16_t wakes;
+	bool ok;
+
+	SLEEPMGR_ClearWakeCounts();
+	Run_Periods(WAKE_UNKNOWN, periods, 100, 30, 10);
+	load1s = SLEEPMGR_GetLoad(SLEEPMGR_WINDOW_1S);
+	wakes = SLEEPMGR_GetWakeCount(WAKE_UNKNOWN);
+
+	ok = Load_Ok(load1s, 200) && (wakes == periods) &&
+	     (SLEEPMGR_GetWakeCount(SLEEPMGR_WAKE_USART) == 0) &&
+	     (unlockedStamps == 0);
+	printf("test=unknown periods=%u load_1s=%u expected=200 wakes=%u "
+	       "unlocked_stamps=%u result=%s\n",
+	       periods, load1s, wakes, unlockedStamps, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	uint16_t portLoad10s;
+
+	Test_Init();
+	success &= Test_Port(&portLoad10s);
+	success &= Test_Usart(portLoad10s);
+	success &= Test_Unknown();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
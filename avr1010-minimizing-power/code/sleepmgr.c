@@ -63,6 +63,86 @@ SLEEPMGR_DEFINE_MODES;
 //! Sleep mode lock counters.
 SLEEPMGR_lock_t SLEEPMGR_locks[SLEEPMGR_NUM_MODES];
 
+#ifdef SLEEPMGR_ACCOUNTING
+
+//! Load accounting window.
+typedef struct SLEEPMGR_Window_struct
+{
+	//! Active time so far in this window.
+	uint32_t active;
+	//! Total time so far in this window.
+	uint32_t total;
+	//! Load of the last completed window, in per mille.
+	uint16_t load;
+} SLEEPMGR_Window_t;
+
+//! Window lengths in SLEEPMGR_GET_TIME() ticks.
+static const uint32_t SLEEPMGR_windowLength[SLEEPMGR_NUM_WINDOWS] =
+{
+	SLEEPMGR_TIME_HZ,
+	10UL * SLEEPMGR_TIME_HZ
+};
+
+//! Wake-up source, set by SLEEPMGR_NOTE_WAKEUP().
+volatile uint8_t SLEEPMGR_wakeSource = SLEEPMGR_WAKE_AWAKE;
+//! Wake-up time, set by SLEEPMGR_NOTE_WAKEUP().
+volatile uint16_t SLEEPMGR_wakeTime;
+//! End of the previous sleep.
+static uint16_t SLEEPMGR_lastWakeTime;
+//! Load accounting windows.
+static SLEEPMGR_Window_t SLEEPMGR_windows[SLEEPMGR_NUM_WINDOWS];
+//! Wake-up counters. The last one counts wake-ups from unknown sources.
+static uint16_t SLEEPMGR_wakeCounts[SLEEPMGR_NUM_WAKE_SOURCES + 1];
+
+#endif
+
+
+
+/*============================ IMPLEMENTATION (PRIVATE FUNCTIONS) ============*/
+
+#ifdef SLEEPMGR_ACCOUNTING
+/*!
+ * This function accounts for one sleep, called by SLEEPMGR_Sleep() after
+ * waking up. The active time is the time from the end of the previous sleep to
+ * the start of this one. Each window is a little longer than its nominal
+ * length, as it ends on the first wake-up after that.
+ *
+ * \param  sleepTime  Time stamp taken just before sleeping.
+ */
+static void SLEEPMGR_Account( uint16_t sleepTime )
+{
+	// Fetch what the waking interrupt handler recorded, and mark us awake.
+	cli();
+	uint8_t source = SLEEPMGR_wakeSource;
+	uint16_t wakeTime = SLEEPMGR_wakeTime;
+	// No SLEEPMGR_NOTE_WAKEUP() in the handler, use the current time. Read it
+	// before sei(), so a pending interrupt does not count as sleep.
+	if (source == SLEEPMGR_WAKE_PENDING) {
+		source = SLEEPMGR_NUM_WAKE_SOURCES;
+		wakeTime = SLEEPMGR_GET_TIME();
+	}
+	SLEEPMGR_wakeSource = SLEEPMGR_WAKE_AWAKE;
+	sei();
+	++SLEEPMGR_wakeCounts[source];
+
+	// 16-bit differences handle counter wrap.
+	uint16_t active = sleepTime - SLEEPMGR_lastWakeTime;
+	uint16_t period = wakeTime - SLEEPMGR_lastWakeTime;
+	SLEEPMGR_lastWakeTime = wakeTime;
+
+	SLEEPMGR_Window_t * window = SLEEPMGR_windows;
+	for (uint8_t index = 0; index < SLEEPMGR_NUM_WINDOWS; ++index, ++window) {
+		window->active += active;
+		window->total += period;
+		if (window->total >= SLEEPMGR_windowLength[index]) {
+			window->load = (window->active * 1000) / window->total;
+			window->active = 0;
+			window->total = 0;
+		}
+	}
+}
+#endif
+
 
 
 /*============================ IMPLEMENTATION (PUBLIC FUNCTIONS) =============*/
@@ -81,6 +161,11 @@ void SLEEPMGR_Init( void )
 	// Lock the deepest sleep mode once and for all, to ease the search
 	// implementation in SLEEPMGR_Sleep() later.
 	SLEEPMGR_locks[SLEEPMGR_NUM_MODES - 1] = 1;
+
+#ifdef SLEEPMGR_ACCOUNTING
+	// Start the first active period now.
+	SLEEPMGR_lastWakeTime = SLEEPMGR_GET_TIME();
+#endif
 }
 
 
@@ -173,6 +258,13 @@ void SLEEPMGR_Sleep( void )
 	uint8_t modeConfig = PROGMEM_READ_BYTE( modePtr );
 	SLEEPMGR_PREPARE_SLEEP( modeConfig );
 
+#ifdef SLEEPMGR_ACCOUNTING
+	// Time stamp the sleep, and let the first interrupt handler record the
+	// wake-up.
+	uint16_t sleepTime = SLEEPMGR_GET_TIME();
+	SLEEPMGR_wakeSource = SLEEPMGR_WAKE_PENDING;
+#endif
+
 	// Enable interrupts before sleeping, otherwise we won't wake up.
 	sei();
 
@@ -182,6 +274,10 @@ void SLEEPMGR_Sleep( void )
 	
 	// After waking up, we disable sleep.
 	SLEEPMGR_DISABLE_SLEEP();
+
+#ifdef SLEEPMGR_ACCOUNTING
+	SLEEPMGR_Account( sleepTime );
+#endif
 }
 
 
@@ -200,4 +296,49 @@ void SLEEPMGR_CancelSleep( void )
 }
 
 
+#ifdef SLEEPMGR_ACCOUNTING
+/*!
+ * This function returns the share of time the CPU was active, i.e. not
+ * sleeping in SLEEPMGR_Sleep(), over the last completed window. Time in the
+ * interrupt handler that woke the device counts as active if the handler uses
+ * SLEEPMGR_NOTE_WAKEUP(). The value is 0 until the first window has completed.
+ *
+ * \param  window  The window, 1 s or 10 s.
+ *
+ * \return  CPU load in per mille.
+ */
+uint16_t SLEEPMGR_GetLoad( SLEEPMGR_window_t window )
+{
+	return SLEEPMGR_windows[window].load;
+}
+
+
+/*!
+ * This function returns how many times a source has woken the device since the
+ * counts were last cleared. The counts wrap at 65536.
+ *
+ * \param  source  Wake-up source from SLEEPMGR_wake_t, or
+ *                 SLEEPMGR_NUM_WAKE_SOURCES for handlers that do not use
+ *                 SLEEPMGR_NOTE_WAKEUP().
+ *
+ * \return  Number of wake-ups.
+ */
+uint16_t SLEEPMGR_GetWakeCount( uint8_t source )
+{
+	return SLEEPMGR_wakeCounts[source];
+}
+
+
+/*!
+ * This function clears all wake-up counts.
+ */
+void SLEEPMGR_ClearWakeCounts( void )
+{
+	for (uint8_t index = 0; index <= SLEEPMGR_NUM_WAKE_SOURCES; ++index) {
+		SLEEPMGR_wakeCounts[index] = 0;
+	}
+}
+#endif
+
+
 /* EOF */
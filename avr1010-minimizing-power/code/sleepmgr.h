@@ -56,6 +56,58 @@
 
 
 
+/*============================ DEFINITIONS ===================================*/
+
+//! Value of SLEEPMGR_wakeSource while SLEEPMGR_Sleep() is sleeping.
+#define SLEEPMGR_WAKE_PENDING 0xFE
+//! Value of SLEEPMGR_wakeSource while awake.
+#define SLEEPMGR_WAKE_AWAKE 0xFF
+
+
+
+/*============================ TYPES =========================================*/
+
+//! Load accounting windows, see SLEEPMGR_GetLoad().
+typedef enum SLEEPMGR_window_enum
+{
+	SLEEPMGR_WINDOW_1S,
+	SLEEPMGR_WINDOW_10S,
+	SLEEPMGR_NUM_WINDOWS
+} SLEEPMGR_window_t;
+
+
+
+/*============================ MACROS ========================================*/
+
+#ifdef SLEEPMGR_ACCOUNTING
+
+extern volatile uint8_t SLEEPMGR_wakeSource;
+extern volatile uint16_t SLEEPMGR_wakeTime;
+
+/*! \brief  Record the wake-up source and time.
+ *
+ * Put this first in interrupt handlers that can wake the device. Only the
+ * first handler after a sleep records anything, so the time spent in it is
+ * counted as active time.
+ *
+ * \param  source  The wake-up source, from SLEEPMGR_wake_t.
+ */
+#define SLEEPMGR_NOTE_WAKEUP( source ) \
+{ \
+	if (SLEEPMGR_wakeSource == SLEEPMGR_WAKE_PENDING) { \
+		SLEEPMGR_wakeTime = SLEEPMGR_GET_TIME(); \
+		SLEEPMGR_wakeSource = (source); \
+	} \
+}
+
+#else
+
+#define SLEEPMGR_NOTE_WAKEUP( source )
+
+#endif
+
+
+
 /*============================ PROTOTYPES ====================================*/
 #ifdef __cplusplus
 extern "C" {
@@ -73,6 +125,15 @@ void SLEEPMGR_Sleep( void );
 //! Cancel pending sleep attempt, e.g. when work is added from a device driver.
 void SLEEPMGR_CancelSleep( void );
 
+#ifdef SLEEPMGR_ACCOUNTING
+//! Get the CPU load in per mille over the last completed window.
+uint16_t SLEEPMGR_GetLoad( SLEEPMGR_window_t window );
+//! Get the number of wake-ups by a source since the counts were cleared.
+uint16_t SLEEPMGR_GetWakeCount( uint8_t source );
+//! Clear the wake-up counts.
+void SLEEPMGR_ClearWakeCounts( void );
+#endif
+
 
 #ifdef __cplusplus
 } /* extern "C" */
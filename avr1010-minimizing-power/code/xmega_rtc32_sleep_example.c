@@ -161,8 +161,9 @@ int main(void)
 /* RTC32 compare ISR
  *
  * The RTC is only used to wake the device up at intervals, so the ISR
- * does not need to do anything.
+ * only records the wake-up for the sleep manager load accounting.
  */
 ISR(RTC32_COMP_vect)
 {
+    SLEEPMGR_NOTE_WAKEUP( SLEEPMGR_WAKE_RTC );
 }
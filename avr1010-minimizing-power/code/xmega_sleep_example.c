@@ -178,8 +178,9 @@ int main(void)
 /* RTC compare ISR
  *
  * The RTC is only used to wake the device up at intervals, so the ISR
- * does not need to do anything.
+ * only records the wake-up for the sleep manager load accounting.
  */
 ISR(RTC_COMP_vect)
 {
+    SLEEPMGR_NOTE_WAKEUP( SLEEPMGR_WAKE_RTC );
 }
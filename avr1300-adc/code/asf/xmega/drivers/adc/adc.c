@@ -37,6 +37,7 @@
  */
 #include <compiler.h>
 #include <adc.h>
+#include <trace_driver.h>
 
 /**
  * \ingroup adc_module_group
@@ -74,7 +75,9 @@ static adc_callback_t adca_callback;
  */
 ISR(ADCA_CH0_vect)
 {
+	TRACE_ISR_ENTER(ADCA_CH0_vect_num);
 	adca_callback(&ADCA, 0, adcch_get_result(&ADCA, 0));
+	TRACE_ISR_EXIT(ADCA_CH0_vect_num);
 }
 
 #    if XMEGA_A
@@ -88,7 +91,9 @@ ISR(ADCA_CH0_vect)
  */
 ISR(ADCA_CH1_vect)
 {
+	TRACE_ISR_ENTER(ADCA_CH1_vect_num);
 	adca_callback(&ADCA, 1, adcch_get_result(&ADCA, 1));
+	TRACE_ISR_EXIT(ADCA_CH1_vect_num);
 }
 
 /**
@@ -100,7 +105,9 @@ ISR(ADCA_CH1_vect)
  */
 ISR(ADCA_CH2_vect)
 {
+	TRACE_ISR_ENTER(ADCA_CH2_vect_num);
 	adca_callback(&ADCA, 2, adcch_get_result(&ADCA, 2));
+	TRACE_ISR_EXIT(ADCA_CH2_vect_num);
 }
 
 /**
@@ -112,7 +119,9 @@ ISR(ADCA_CH2_vect)
  */
 ISR(ADCA_CH3_vect)
 {
+	TRACE_ISR_ENTER(ADCA_CH3_vect_num);
 	adca_callback(&ADCA, 3, adcch_get_result(&ADCA, 3));
+	TRACE_ISR_EXIT(ADCA_CH3_vect_num);
 }
 
 #    endif /* XMEGA_A */
@@ -147,7 +156,9 @@ static adc_callback_t adcb_callback;
  */
 ISR(ADCB_CH0_vect)
 {
+	TRACE_ISR_ENTER(ADCB_CH0_vect_num);
 	adcb_callback(&ADCB, 0, adcch_get_result(&ADCB, 0));
+	TRACE_ISR_EXIT(ADCB_CH0_vect_num);
 }
 
 #    if XMEGA_A
@@ -161,7 +172,9 @@ ISR(ADCB_CH0_vect)
  */
 ISR(ADCB_CH1_vect)
 {
+	TRACE_ISR_ENTER(ADCB_CH1_vect_num);
 	adcb_callback(&ADCB, 1, adcch_get_result(&ADCB, 1));
+	TRACE_ISR_EXIT(ADCB_CH1_vect_num);
 }
 
 /**
@@ -173,7 +186,9 @@ ISR(ADCB_CH1_vect)
  */
 ISR(ADCB_CH2_vect)
 {
+	TRACE_ISR_ENTER(ADCB_CH2_vect_num);
 	adcb_callback(&ADCB, 2, adcch_get_result(&ADCB, 2));
+	TRACE_ISR_EXIT(ADCB_CH2_vect_num);
 }
 
 /**
@@ -185,7 +200,9 @@ ISR(ADCB_CH2_vect)
  */
 ISR(ADCB_CH3_vect)
 {
+	TRACE_ISR_ENTER(ADCB_CH3_vect_num);
 	adcb_callback(&ADCB, 3, adcch_get_result(&ADCB, 3));
+	TRACE_ISR_EXIT(ADCB_CH3_vect_num);
 }
 
 #    endif /* XMEGA_A */
@@ -78,6 +78,10 @@ extern "C" {
  * - \ref sleepmgr_group for setting allowed sleep mode.
  * - \ref interrupt_group for ISR definition and disabling interrupts during
  * critical code sections.
+ * - trace_driver.h of application note AVR1307, whose directory must be in the
+ * include path. If TRACE_ENABLED is defined, the ISRs record their entry and
+ * exit with the interrupt trace driver, and trace_driver.c must be added to
+ * the project. Otherwise the trace macros are empty.
  * @{
  */
 
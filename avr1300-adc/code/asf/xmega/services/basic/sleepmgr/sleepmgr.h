@@ -87,6 +87,58 @@
 #  define CONFIG_SLEEPMGR_ENABLE
 #endif
 
+/**
+ * \def CONFIG_SLEEPMGR_ACCOUNTING
+ * \brief Configuration symbol for enabling CPU load accounting
+ *
+ * If this symbol is defined, \ref sleepmgr_enter_sleep time stamps each sleep
+ * and counts the wake-up sources, and the load over the last 1 s and 10 s can
+ * be read with \ref sleepmgr_get_load. It costs a few tens of cycles per sleep.
+ * Interrupt handlers that can wake the device should call
+ * \ref sleepmgr_note_wakeup first thing.
+ *
+ * This symbol may be defined in \ref conf_sleepmgr.h. It requires
+ * \ref CONFIG_SLEEPMGR_ENABLE, and is only supported on XMEGA.
+ */
+#if defined(__DOXYGEN__) && !defined(CONFIG_SLEEPMGR_ACCOUNTING)
+#  define CONFIG_SLEEPMGR_ACCOUNTING
+#endif
+
+/**
+ * \def CONFIG_SLEEPMGR_ACCOUNTING_TIME
+ * \brief Configuration symbol for the load accounting time stamp
+ *
+ * Expression giving a 16-bit count that keeps running in all sleep modes used
+ * and wraps from 0xffff to 0. No single sleep or active period may be longer
+ * than one wrap. Defaults to RTC.CNT, which the RTC driver sets up this way.
+ */
+#if defined(__DOXYGEN__) && !defined(CONFIG_SLEEPMGR_ACCOUNTING_TIME)
+#  define CONFIG_SLEEPMGR_ACCOUNTING_TIME
+#endif
+
+/**
+ * \def CONFIG_SLEEPMGR_ACCOUNTING_HZ
+ * \brief Configuration symbol for the count rate of the time stamp
+ *
+ * Count rate of \ref CONFIG_SLEEPMGR_ACCOUNTING_TIME in Hz. Defaults to 1024,
+ * the rate of the RTC clocked by the 1.024 kHz ULP output without prescaling.
+ */
+#if defined(__DOXYGEN__) && !defined(CONFIG_SLEEPMGR_ACCOUNTING_HZ)
+#  define CONFIG_SLEEPMGR_ACCOUNTING_HZ
+#endif
+
+/**
+ * \def CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES
+ * \brief Configuration symbol for the number of wake-up sources counted
+ *
+ * The application numbers its wake-up sources from 0, and passes the number to
+ * \ref sleepmgr_note_wakeup. Wake-ups from handlers that do not call it are
+ * counted as source \ref CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES. Defaults to 4.
+ */
+#if defined(__DOXYGEN__) && !defined(CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES)
+#  define CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES
+#endif
+
 /**
  * \enum sleepmgr_mode
  * \brief Sleep mode locks
@@ -110,6 +162,9 @@ static inline void sleepmgr_init(void)
 		sleepmgr_locks[i] = 0;
 	}
 	sleepmgr_locks[SLEEPMGR_NR_OF_MODES - 1] = 1;
+#  ifdef CONFIG_SLEEPMGR_ACCOUNTING
+	sleepmgr_account_init();
+#  endif
 #endif /* CONFIG_SLEEPMGR_ENABLE */
 }
 
@@ -176,6 +231,41 @@ static inline void sleepmgr_unlock_mode(enum sleepmgr_mode mode)
  * mode being locked.
  */
 
+/**
+ * \fn sleepmgr_note_wakeup
+ * \brief Record the wake-up source for the load accounting
+ *
+ * Call this first thing in interrupt handlers that can wake the device. Only
+ * the first handler after a sleep records anything, so the time spent in it
+ * is counted as active time. Does nothing unless
+ * \ref CONFIG_SLEEPMGR_ACCOUNTING is defined.
+ *
+ * \param source Wake-up source, less than
+ * \ref CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES.
+ */
+
+/**
+ * \fn sleepmgr_get_load
+ * \brief Get the CPU load over the last completed window
+ *
+ * Returns the share of time the CPU was not sleeping in
+ * \ref sleepmgr_enter_sleep, in per mille. Each window ends on the first
+ * wake-up after its nominal length. Returns 0 until the first window has
+ * completed.
+ *
+ * \param window Window to read.
+ */
+
+/**
+ * \fn sleepmgr_get_wake_count
+ * \brief Get the number of wake-ups by a source
+ *
+ * Counts wrap at 65536, and are cleared by \ref sleepmgr_clear_wake_counts.
+ *
+ * \param source Wake-up source, or \ref CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES for
+ * wake-ups from handlers that do not call \ref sleepmgr_note_wakeup.
+ */
+
 //! @}
 
 #endif /* SLEEPMGR_H */
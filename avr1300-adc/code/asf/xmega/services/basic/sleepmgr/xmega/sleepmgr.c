@@ -56,3 +56,119 @@ enum SLEEP_SMODE_enum sleepmgr_configs[SLEEPMGR_NR_OF_MODES] = {
 };
 
 #endif /* CONFIG_SLEEPMGR_ENABLE */
+
+#if defined(CONFIG_SLEEPMGR_ACCOUNTING)
+
+//! Load accounting window
+struct sleepmgr_window {
+	//! Active time so far in this window
+	uint32_t active;
+	//! Total time so far in this window
+	uint32_t total;
+	//! Load of the last completed window, in per mille
+	uint16_t load;
+};
+
+//! Window lengths in time stamp ticks
+static const uint32_t sleepmgr_window_length[SLEEPMGR_NR_OF_LOAD_WINDOWS] = {
+	CONFIG_SLEEPMGR_ACCOUNTING_HZ,
+	10UL * CONFIG_SLEEPMGR_ACCOUNTING_HZ,
+};
+
+volatile uint8_t sleepmgr_wake_source = SLEEPMGR_WAKE_AWAKE;
+volatile uint16_t sleepmgr_wake_time;
+
+//! End of the previous sleep
+static uint16_t sleepmgr_last_wake_time;
+//! Load accounting windows
+static struct sleepmgr_window sleepmgr_windows[SLEEPMGR_NR_OF_LOAD_WINDOWS];
+//! Wake-up counters, the last one for unknown sources
+static uint16_t sleepmgr_wake_counts[CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES + 1];
+
+/**
+ * \internal
+ * \brief Start the first active period
+ */
+void sleepmgr_account_init(void)
+{
+	sleepmgr_last_wake_time = CONFIG_SLEEPMGR_ACCOUNTING_TIME;
+}
+
+/**
+ * \internal
+ * \brief Account for one sleep
+ *
+ * Called by \ref sleepmgr_enter_sleep after waking up. The active time is the
+ * time from the end of the previous sleep to the start of this one.
+ *
+ * \param sleep_time Time stamp taken just before sleeping.
+ */
+void sleepmgr_account(uint16_t sleep_time)
+{
+	struct sleepmgr_window *window = sleepmgr_windows;
+	uint16_t                wake_time;
+	uint16_t                active;
+	uint16_t                period;
+	uint8_t                 source;
+	uint8_t                 i;
+
+	/*
+	 * Fetch what the waking interrupt handler recorded, and mark us awake.
+	 * If no handler noted the wake-up, time stamp it here, before an
+	 * interrupt can add its run time to the sleep.
+	 */
+	cpu_irq_disable();
+	source = sleepmgr_wake_source;
+	wake_time = sleepmgr_wake_time;
+	if (source == SLEEPMGR_WAKE_PENDING) {
+		source = CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES;
+		wake_time = CONFIG_SLEEPMGR_ACCOUNTING_TIME;
+	}
+	sleepmgr_wake_source = SLEEPMGR_WAKE_AWAKE;
+	cpu_irq_enable();
+
+	sleepmgr_wake_counts[source]++;
+
+	// 16-bit differences handle counter wrap.
+	active = sleep_time - sleepmgr_last_wake_time;
+	period = wake_time - sleepmgr_last_wake_time;
+	sleepmgr_last_wake_time = wake_time;
+
+	for (i = 0; i < SLEEPMGR_NR_OF_LOAD_WINDOWS; i++, window++) {
+		window->active += active;
+		window->total += period;
+		if (window->total >= sleepmgr_window_length[i]) {
+			window->load = (window->active * 1000) / window->total;
+			window->active = 0;
+			window->total = 0;
+		}
+	}
+}
+
+uint16_t sleepmgr_get_load(enum sleepmgr_load_window window)
+{
+	Assert(window < SLEEPMGR_NR_OF_LOAD_WINDOWS);
+
+	return sleepmgr_windows[window].load;
+}
+
+uint16_t sleepmgr_get_wake_count(uint8_t source)
+{
+	Assert(source <= CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES);
+
+	return sleepmgr_wake_counts[source];
+}
+
+/**
+ * \brief Clear the wake-up counts
+ */
+void sleepmgr_clear_wake_counts(void)
+{
+	uint8_t i;
+
+	for (i = 0; i <= CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES; i++) {
+		sleepmgr_wake_counts[i] = 0;
+	}
+}
+
+#endif /* CONFIG_SLEEPMGR_ACCOUNTING */
@@ -86,6 +86,69 @@ extern enum SLEEP_SMODE_enum sleepmgr_configs[];
 #endif /* CONFIG_SLEEPMGR_ENABLE */
 //! @}
 
+#if defined(CONFIG_SLEEPMGR_ACCOUNTING)
+#  if !defined(CONFIG_SLEEPMGR_ENABLE)
+#    error CONFIG_SLEEPMGR_ACCOUNTING requires CONFIG_SLEEPMGR_ENABLE
+#  endif
+#  ifndef CONFIG_SLEEPMGR_ACCOUNTING_TIME
+#    define CONFIG_SLEEPMGR_ACCOUNTING_TIME RTC.CNT
+#  endif
+#  ifndef CONFIG_SLEEPMGR_ACCOUNTING_HZ
+#    define CONFIG_SLEEPMGR_ACCOUNTING_HZ 1024
+#  endif
+#  ifndef CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES
+#    define CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES 4
+#  endif
+#endif /* CONFIG_SLEEPMGR_ACCOUNTING */
+
+//! Load accounting windows
+enum sleepmgr_load_window {
+	//! Load over about 1 s.
+	SLEEPMGR_LOAD_1S,
+	//! Load over about 10 s.
+	SLEEPMGR_LOAD_10S,
+	SLEEPMGR_NR_OF_LOAD_WINDOWS,
+};
+
+/**
+ * \internal
+ * \name Load accounting
+ * @{
+ */
+#if defined(CONFIG_SLEEPMGR_ACCOUNTING) || defined(__DOXYGEN__)
+//! sleepmgr_wake_source while sleeping
+#  define SLEEPMGR_WAKE_PENDING 0xfe
+//! sleepmgr_wake_source while awake
+#  define SLEEPMGR_WAKE_AWAKE   0xff
+
+//! Wake-up source recorded by \ref sleepmgr_note_wakeup
+extern volatile uint8_t sleepmgr_wake_source;
+//! Wake-up time recorded by \ref sleepmgr_note_wakeup
+extern volatile uint16_t sleepmgr_wake_time;
+
+void sleepmgr_account_init(void);
+void sleepmgr_account(uint16_t sleep_time);
+#endif /* CONFIG_SLEEPMGR_ACCOUNTING */
+//! @}
+
+#ifdef CONFIG_SLEEPMGR_ACCOUNTING
+uint16_t sleepmgr_get_load(enum sleepmgr_load_window window);
+uint16_t sleepmgr_get_wake_count(uint8_t source);
+void sleepmgr_clear_wake_counts(void);
+#endif
+
+static inline void sleepmgr_note_wakeup(uint8_t source)
+{
+#ifdef CONFIG_SLEEPMGR_ACCOUNTING
+	Assert(source < CONFIG_SLEEPMGR_NR_OF_WAKE_SOURCES);
+
+	if (sleepmgr_wake_source == SLEEPMGR_WAKE_PENDING) {
+		sleepmgr_wake_time = CONFIG_SLEEPMGR_ACCOUNTING_TIME;
+		sleepmgr_wake_source = source;
+	}
+#endif
+}
+
 static inline void sleepmgr_enter_sleep(void)
 {
 #ifdef CONFIG_SLEEPMGR_ENABLE
@@ -113,10 +176,19 @@ static inline void sleepmgr_enter_sleep(void)
 	sleep_set_mode(config);
 	sleep_enable();
 
+#  ifdef CONFIG_SLEEPMGR_ACCOUNTING
+	uint16_t sleep_time = CONFIG_SLEEPMGR_ACCOUNTING_TIME;
+	sleepmgr_wake_source = SLEEPMGR_WAKE_PENDING;
+#  endif
+
 	cpu_irq_enable();
 	sleep_enter();
 
 	sleep_disable();
+
+#  ifdef CONFIG_SLEEPMGR_ACCOUNTING
+	sleepmgr_account(sleep_time);
+#  endif
 #else
 	cpu_irq_enable();
 #endif /* CONFIG_SLEEPMGR_ENABLE */
@@ -0,0 +1,161 @@
+/**
+ * \file
+ *
+ * \brief CRC service definitions
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef SERVICES_CRC_CRC_H
+#define SERVICES_CRC_CRC_H
+
+#include <compiler.h>
+#include <nvm.h>
+
+/**
+ * \defgroup crc_group CRC service
+ *
+ * This service calculates CRC-16-CCITT and CRC-32 checksums of data in
+ * SRAM, flash and EEPROM, and runs the flash CRC commands of the NVM
+ * controller.
+ *
+ * \section crc_incremental Incremental use
+ *
+ * All software CRC functions take the current CRC value and return the
+ * updated one, so a checksum can be built up as data arrives. A USART
+ * receive interrupt can call crc16_ccitt_byte() or crc32_byte() for each
+ * byte, and a DMA transfer complete handler can call crc16_ccitt_update()
+ * or crc32_update() for each block. The result does not depend on how the
+ * data was split.
+ *
+ * - CRC-16-CCITT: polynomial 0x1021, start with \ref CRC16_CCITT_INIT, no
+ *   reflection and no final XOR. The check value of "123456789" is 0x29b1.
+ * - CRC-32 (IEEE 802.3): reflected polynomial 0xedb88320, start with
+ *   \ref CRC32_INIT and pass the result through crc32_finalize(). The
+ *   check value of "123456789" is 0xcbf43926.
+ *
+ * \section crc_speed Implementation
+ *
+ * CRC-16-CCITT is calculated a byte at a time with shifts, which on the
+ * AVR is as fast as a table and needs no flash for one.
+ *
+ * CRC-32 uses a 1 KB table in flash, so each byte costs one table read and
+ * byte moves instead of eight 32-bit shifts. Slicing over several bytes
+ * does not pay off on an 8-bit CPU, where the table reads are the main
+ * cost. If \ref CONFIG_CRC32_SMALL_TABLE is defined, a 64-byte table is
+ * used instead, at about twice the cost per byte.
+ *
+ * The check values, incremental use and the agreement of both CRC-32
+ * tables are tested on the host by asf_crc_example/host_sim/crc_check.c.
+ *
+ * \section crc_hardware NVM controller CRC
+ *
+ * The NVM controller can calculate a CRC of a flash range, or of the whole
+ * application or boot section, much faster than software, but the CPU is
+ * halted while it runs. Its polynomial and width are device specific and
+ * do not match either of the software CRCs, so a hardware checksum can
+ * only be compared with another hardware checksum from the same device,
+ * e.g. one stored when the flash was programmed and verified.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_CRC32_SMALL_TABLE
+ * \brief Use a 16-entry CRC-32 table to save flash
+ */
+#ifdef __DOXYGEN__
+# define CONFIG_CRC32_SMALL_TABLE
+#endif
+
+//! Initial value for CRC-16-CCITT
+#define CRC16_CCITT_INIT    0xffff
+
+//! Initial value for CRC-32
+#define CRC32_INIT          0xffffffffUL
+
+/**
+ * \brief Update a CRC-16-CCITT with one byte
+ *
+ * \param crc Current CRC value
+ * \param data Data byte
+ *
+ * \return Updated CRC value
+ */
+static inline uint16_t crc16_ccitt_byte(uint16_t crc, uint8_t data)
+{
+	uint8_t x;
+
+	x = (uint8_t)(crc >> 8) ^ data;
+	x ^= x >> 4;
+	return (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+}
+
+uint32_t crc32_byte(uint32_t crc, uint8_t data);
+
+/**
+ * \brief Finish a CRC-32 calculation
+ *
+ * \param crc CRC value after the last update
+ *
+ * \return CRC-32 of the data
+ */
+static inline uint32_t crc32_finalize(uint32_t crc)
+{
+	return ~crc;
+}
+
+uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t *data,
+		uint16_t length);
+uint16_t crc16_ccitt_update_flash(uint16_t crc, flash_addr_t address,
+		uint32_t length);
+uint16_t crc16_ccitt_update_eeprom(uint16_t crc, uint16_t address,
+		uint16_t length);
+
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint16_t length);
+uint32_t crc32_update_flash(uint32_t crc, flash_addr_t address,
+		uint32_t length);
+uint32_t crc32_update_eeprom(uint32_t crc, uint16_t address,
+		uint16_t length);
+
+/**
+ * \name NVM controller CRC
+ * @{
+ */
+uint32_t crc_nvm_flash_range(flash_addr_t start, flash_addr_t end);
+uint32_t crc_nvm_app_section(void);
+uint32_t crc_nvm_boot_section(void);
+//! @}
+
+//! @}
+
+#endif /* SERVICES_CRC_CRC_H */
@@ -0,0 +1,423 @@
+/**
+ * \file
+ *
+ * \brief Dual-image firmware update service
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <compiler.h>
+#include <ccp.h>
+#include <nvm.h>
+#include <fwupdate.h>
+
+#ifdef CONFIG_FWUPDATE_DMA_CH23
+# define FWUPDATE_DMA_CH_A        DMA.CH2
+# define FWUPDATE_DMA_CH_B        DMA.CH3
+# define FWUPDATE_DMA_DBUFMODE    DMA_DBUFMODE_CH23_gc
+#else
+# define FWUPDATE_DMA_CH_A        DMA.CH0
+# define FWUPDATE_DMA_CH_B        DMA.CH1
+# define FWUPDATE_DMA_DBUFMODE    DMA_DBUFMODE_CH01_gc
+#endif
+
+/**
+ * \internal
+ * \brief Update states
+ */
+enum fwupdate_state {
+	//! No update in progress
+	FWUPDATE_STATE_IDLE,
+	//! Receiving and programming pages
+	FWUPDATE_STATE_RECEIVING,
+	//! Reading back the staging region
+	FWUPDATE_STATE_VERIFYING,
+	//! Image verified and trailer written
+	FWUPDATE_STATE_DONE,
+	//! CRC mismatch or DMA error
+	FWUPDATE_STATE_FAILED,
+};
+
+/**
+ * \internal
+ * \brief Service private struct
+ */
+struct fwupdate_data_struct {
+	//! USART the image is received on
+	USART_t *usart;
+	//! Image size in bytes
+	uint32_t size;
+	//! Expected image CRC
+	uint16_t crc;
+	//! CRC of the pages read back so far
+	uint16_t verify_crc;
+	//! Number of pages in the image
+	uint16_t page_count;
+	//! Next page to program or read back
+	uint16_t page;
+	//! RAM buffer, and DMA channel, holding the next page
+	uint8_t buffer_index;
+	//! Current state, \ref fwupdate_state
+	uint8_t state;
+};
+
+/**
+ * \internal
+ * \brief Service private data
+ */
+struct fwupdate_data_struct fwupdate_data;
+
+/**
+ * \internal
+ * \brief Page buffers filled by DMA channel A and B
+ */
+static uint8_t fwupdate_buffer[2][FLASH_PAGE_SIZE];
+
+/**
+ * \internal
+ * \brief Send a byte to the host
+ */
+static void fwupdate_send(uint8_t data)
+{
+	while (!(fwupdate_data.usart->STATUS & USART_DREIF_bm)) {
+		// Wait for the transmit buffer
+	}
+	fwupdate_data.usart->DATA = data;
+}
+
+/**
+ * \internal
+ * \brief Configure a DMA channel to receive one page per block
+ *
+ * The destination address and the block size are reloaded at the end of
+ * each block, so the channel is ready again when the other channel of the
+ * pair enables it.
+ */
+static void fwupdate_setup_channel(volatile DMA_CH_t *channel,
+		uint8_t *buffer, uint8_t trigger)
+{
+	uint16_t source = (uint16_t)&fwupdate_data.usart->DATA;
+	uint16_t destination = (uint16_t)buffer;
+
+	channel->CTRLA = DMA_CH_RESET_bm;
+	channel->ADDRCTRL = DMA_CH_SRCRELOAD_NONE_gc | DMA_CH_SRCDIR_FIXED_gc
+			| DMA_CH_DESTRELOAD_BLOCK_gc | DMA_CH_DESTDIR_INC_gc;
+	channel->TRIGSRC = trigger;
+	channel->TRFCNT = FLASH_PAGE_SIZE;
+	channel->SRCADDR0 = LSB(source);
+	channel->SRCADDR1 = MSB(source);
+	channel->SRCADDR2 = 0;
+	channel->DESTADDR0 = LSB(destination);
+	channel->DESTADDR1 = MSB(destination);
+	channel->DESTADDR2 = 0;
+	channel->CTRLA = DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+/**
+ * \internal
+ * \brief Stop reception and release the DMA channels
+ */
+static void fwupdate_stop_dma(void)
+{
+	FWUPDATE_DMA_CH_A.CTRLA = 0;
+	FWUPDATE_DMA_CH_B.CTRLA = 0;
+	DMA.CTRL &= ~DMA_DBUFMODE_gm;
+}
+
+/**
+ * \internal
+ * \brief Load a RAM buffer into the flash page buffer and program it
+ *
+ * The erase and write is started and this function returns. If it runs
+ * from the application section, the CPU is halted until the page is done,
+ * while the DMA keeps receiving.
+ *
+ * \param data Pointer to one page of data
+ * \param address Byte address of the flash page
+ */
+static void fwupdate_program_page(const uint8_t *data, flash_addr_t address)
+{
+	uint16_t i;
+
+	for (i = 0; i < FLASH_PAGE_SIZE; i += 2) {
+		nvm_flash_load_word_to_buffer(address + i,
+				data[i] | ((uint16_t)data[i + 1] << 8));
+	}
+
+	nvm_flash_atomic_write_app_page(address);
+}
+
+/**
+ * \internal
+ * \brief Write the trailer that marks the staging region as verified
+ */
+static void fwupdate_write_trailer(void)
+{
+	uint8_t page[sizeof(struct fwupdate_trailer)];
+	struct fwupdate_trailer *trailer = (struct fwupdate_trailer *)page;
+	uint8_t i;
+
+	trailer->magic = FWUPDATE_TRAILER_MAGIC;
+	trailer->size = fwupdate_data.size;
+	trailer->image_crc = fwupdate_data.crc;
+	trailer->trailer_crc = fwupdate_crc_update(0xffff, page,
+			offsetof(struct fwupdate_trailer, trailer_crc));
+
+	/* Flush the page buffer, so the rest of the trailer page is erased
+	 * whatever was loaded before.
+	 */
+	nvm_wait_until_ready();
+	nvm_flash_flush_buffer();
+	for (i = 0; i < sizeof(page); i += 2) {
+		nvm_flash_load_word_to_buffer(FWUPDATE_TRAILER_ADDRESS + i,
+				page[i] | ((uint16_t)page[i + 1] << 8));
+	}
+
+	nvm_flash_atomic_write_app_page(FWUPDATE_TRAILER_ADDRESS);
+	nvm_wait_until_ready();
+}
+
+/**
+ * \brief Start receiving an image
+ *
+ * The image is received by two DMA channels triggered by the receive
+ * complete of \a usart. The USART must be configured with its receiver and
+ * transmitter enabled and its receive complete interrupt disabled. The
+ * DMA controller is enabled by this function.
+ *
+ * Any image already in the staging region is invalidated.
+ *
+ * \param usart Pointer to the USART the image is received on
+ * \param dma_trigger DMA trigger source for receive complete on \a usart,
+ *                    e.g. DMA_CH_TRIGSRC_USARTC0_RXC_gc
+ * \param size Image size in bytes
+ * \param crc CRC-16-CCITT of the image
+ *
+ * \retval STATUS_OK if the update was started
+ * \retval ERR_BUSY if an update is already in progress
+ * \retval ERR_INVALID_ARG if the image does not fit in the staging region
+ */
+status_code_t fwupdate_begin(USART_t *usart, uint8_t dma_trigger,
+		uint32_t size, uint16_t crc)
+{
+	if ((fwupdate_data.state == FWUPDATE_STATE_RECEIVING)
+			|| (fwupdate_data.state == FWUPDATE_STATE_VERIFYING)) {
+		return ERR_BUSY;
+	}
+
+	if ((size == 0) || (size > FWUPDATE_IMAGE_MAX_SIZE)) {
+		return ERR_INVALID_ARG;
+	}
+
+	fwupdate_data.usart = usart;
+	fwupdate_data.size = size;
+	fwupdate_data.crc = crc;
+	fwupdate_data.page_count = (size + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+	fwupdate_data.page = 0;
+	fwupdate_data.buffer_index = 0;
+
+	nvm_wait_until_ready();
+	nvm_flash_flush_buffer();
+	nvm_flash_erase_app_page(FWUPDATE_TRAILER_ADDRESS);
+
+	// Drop anything received before the host was told to start
+	while (usart->STATUS & USART_RXCIF_bm) {
+		(void)usart->DATA;
+	}
+
+	DMA.CTRL = (DMA.CTRL & ~DMA_DBUFMODE_gm) | FWUPDATE_DMA_DBUFMODE
+			| DMA_ENABLE_bm;
+	fwupdate_setup_channel(&FWUPDATE_DMA_CH_A, fwupdate_buffer[0],
+			dma_trigger);
+	fwupdate_setup_channel(&FWUPDATE_DMA_CH_B, fwupdate_buffer[1],
+			dma_trigger);
+	FWUPDATE_DMA_CH_A.CTRLA |= DMA_CH_ENABLE_bm;
+
+	fwupdate_data.state = FWUPDATE_STATE_RECEIVING;
+	fwupdate_send(FWUPDATE_ACK);
+
+	return STATUS_OK;
+}
+
+/**
+ * \brief Run the update
+ *
+ * This must be called regularly from the main loop while an update is in
+ * progress. Each call programs at most one received page, or reads back
+ * one page of the staging region, so the application keeps running between
+ * the calls.
+ *
+ * The service has no timeout. If the host stops sending, the application
+ * should call fwupdate_abort().
+ *
+ * \note The flash page buffer is loaded with the NVM command register set
+ *       to the load command, so interrupt handlers must not read flash
+ *       while this function runs.
+ *
+ * \retval STATUS_OK if the image is verified and ready to be installed
+ * \retval ERR_BUSY if the update is still in progress
+ * \retval ERR_BAD_DATA if the image CRC did not match
+ * \retval ERR_IO_ERROR if a DMA transfer failed
+ * \retval ERR_FLUSHED if no update has been started
+ */
+status_code_t fwupdate_task(void)
+{
+	volatile DMA_CH_t *channel;
+	flash_addr_t address;
+	uint32_t length;
+
+	switch (fwupdate_data.state) {
+	case FWUPDATE_STATE_RECEIVING:
+		if (fwupdate_data.buffer_index) {
+			channel = &FWUPDATE_DMA_CH_B;
+		} else {
+			channel = &FWUPDATE_DMA_CH_A;
+		}
+
+		if (channel->CTRLB & DMA_CH_ERRIF_bm) {
+			fwupdate_stop_dma();
+			fwupdate_data.state = FWUPDATE_STATE_FAILED;
+			fwupdate_send(FWUPDATE_NAK);
+			return ERR_IO_ERROR;
+		}
+
+		if (!(channel->CTRLB & DMA_CH_TRNIF_bm)) {
+			return ERR_BUSY;
+		}
+
+		channel->CTRLB |= DMA_CH_TRNIF_bm;
+		address = CONFIG_FWUPDATE_STAGING_START
+				+ (flash_addr_t)fwupdate_data.page * FLASH_PAGE_SIZE;
+		fwupdate_program_page(fwupdate_buffer[fwupdate_data.buffer_index],
+				address);
+
+		/* The buffer is free again. Each acknowledge lets the host
+		 * send the page two pages ahead, so none is sent for the last
+		 * two pages.
+		 */
+		if (fwupdate_data.page + 2 < fwupdate_data.page_count) {
+			fwupdate_send(FWUPDATE_ACK);
+		}
+
+		fwupdate_data.buffer_index ^= 1;
+		fwupdate_data.page++;
+		if (fwupdate_data.page == fwupdate_data.page_count) {
+			fwupdate_stop_dma();
+			fwupdate_data.page = 0;
+			fwupdate_data.verify_crc = 0xffff;
+			fwupdate_data.state = FWUPDATE_STATE_VERIFYING;
+		}
+		return ERR_BUSY;
+
+	case FWUPDATE_STATE_VERIFYING:
+		nvm_wait_until_ready();
+
+		address = (flash_addr_t)fwupdate_data.page * FLASH_PAGE_SIZE;
+		length = fwupdate_data.size - address;
+		if (length > FLASH_PAGE_SIZE) {
+			length = FLASH_PAGE_SIZE;
+		}
+		fwupdate_data.verify_crc = fwupdate_crc_flash(
+				fwupdate_data.verify_crc,
+				CONFIG_FWUPDATE_STAGING_START + address, length);
+
+		fwupdate_data.page++;
+		if (fwupdate_data.page < fwupdate_data.page_count) {
+			return ERR_BUSY;
+		}
+
+		if (fwupdate_data.verify_crc != fwupdate_data.crc) {
+			fwupdate_data.state = FWUPDATE_STATE_FAILED;
+			fwupdate_send(FWUPDATE_NAK);
+			return ERR_BAD_DATA;
+		}
+
+		fwupdate_write_trailer();
+		fwupdate_data.state = FWUPDATE_STATE_DONE;
+		fwupdate_send(FWUPDATE_ACK);
+		return STATUS_OK;
+
+	case FWUPDATE_STATE_DONE:
+		return STATUS_OK;
+
+	case FWUPDATE_STATE_FAILED:
+		return ERR_BAD_DATA;
+
+	default:
+		return ERR_FLUSHED;
+	}
+}
+
+/**
+ * \brief Abort an update in progress
+ *
+ * The DMA channels are released. The staging region is left partly
+ * written, but without a trailer, so it is never installed.
+ */
+void fwupdate_abort(void)
+{
+	if (fwupdate_data.state == FWUPDATE_STATE_RECEIVING) {
+		fwupdate_stop_dma();
+	}
+	fwupdate_data.state = FWUPDATE_STATE_IDLE;
+}
+
+/**
+ * \brief Check if a verified image is waiting to be installed
+ */
+bool fwupdate_is_pending(void)
+{
+	struct fwupdate_trailer trailer;
+
+	nvm_wait_until_ready();
+	return fwupdate_read_trailer(&trailer);
+}
+
+/**
+ * \brief Install a verified image
+ *
+ * The device is reset, and the boot section stub copies the image over the
+ * active one before starting it. Nothing is done if no verified image is
+ * pending.
+ */
+void fwupdate_install(void)
+{
+	if (!fwupdate_is_pending()) {
+		return;
+	}
+
+	cpu_irq_disable();
+	ccp_write_io((uint8_t *)&RST.CTRL, RST_SWRST_bm);
+	while (true) {
+		// Wait for the reset
+	}
+}
@@ -0,0 +1,232 @@
+/**
+ * \file
+ *
+ * \brief Dual-image firmware update service definitions
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef SERVICES_FWUPDATE_FWUPDATE_H
+#define SERVICES_FWUPDATE_FWUPDATE_H
+
+#include <compiler.h>
+#include <status_codes.h>
+#include <nvm.h>
+#include <conf_fwupdate.h>
+
+/**
+ * \defgroup fwupdate_group Dual-image firmware update
+ *
+ * This service lets a running application receive a new firmware image over
+ * a USART and install it without a separate bootloader protocol.
+ *
+ * The application section is split in two regions. The active image runs
+ * from the start of flash, and the new image is written to a staging region
+ * while the application keeps running. When the whole image has been
+ * received and its CRC verified, a trailer is written to the last page of
+ * the staging region, and the device is reset. A small stub in the boot
+ * section then copies the staging region over the active image and starts
+ * it.
+ *
+ * \section fwupdate_reception Overlapped reception and programming
+ *
+ * While a page is programmed, code that runs from the application section
+ * is halted until the operation is done. Interrupt handlers are halted as
+ * well, so the image is received by a pair of DMA channels in double buffer
+ * mode. One channel fills a RAM page buffer from the USART while the page
+ * received by the other is loaded into the flash page buffer and
+ * programmed, so reception and programming overlap.
+ *
+ * \section fwupdate_protocol Transfer protocol
+ *
+ * The application decides how an update is requested and how the image size
+ * and CRC are received, and then calls fwupdate_begin(). From there:
+ * - The device sends \ref FWUPDATE_ACK when it is ready.
+ * - The host sends the first two pages of the image, or the only one, and
+ *   then one more page for each \ref FWUPDATE_ACK that follows. An
+ *   acknowledge is sent as soon as a page has left its RAM buffer, so the
+ *   host never overruns the DMA.
+ * - The last page is padded to a full page with 0xff.
+ * - When all pages are written, the staging region is read back. The device
+ *   sends \ref FWUPDATE_ACK if the CRC matches, or \ref FWUPDATE_NAK if not.
+ *
+ * The CRC is CRC-16-CCITT (polynomial 0x1021, initial value 0xffff) over the
+ * image size given to fwupdate_begin(), not including the padding.
+ *
+ * \section fwupdate_recovery Interrupted updates
+ *
+ * The active image is not touched before the staging region has been
+ * verified and the trailer written, so an update that is interrupted before
+ * that leaves the old firmware running, and the update can just be
+ * restarted.
+ *
+ * The boot section stub runs on every reset and keeps the trailer until the
+ * copied image has been verified. If power fails during the copy, the copy
+ * is done again on the next reset. Pages that already match the staging
+ * region are skipped, so a resumed copy only programs the pages that were
+ * not done.
+ *
+ * If the copied image still does not match the trailer CRC after three
+ * attempts, for instance because a flash page no longer programs, the
+ * active image is partly overwritten. The stub then holds instead of
+ * starting it, and tries again after the next reset. Enable the watchdog
+ * timer by fuse to get that reset without a power cycle.
+ *
+ * The recovery is tested on the host by
+ * asf_fwupdate_example/host_sim/fwupdate_power_loss.c, which cuts the power
+ * at every page operation of the copy and of the trailer erase.
+ *
+ * \section fwupdate_build Build requirements
+ *
+ * - The BOOTRST fuse must select the boot loader reset vector.
+ * - With GCC, the reset entry and the \c .BOOT section must be placed in
+ *   the boot section, in that order. For the ATxmega128A1:
+ *   \code
+ *   LDFLAGS += -Wl,--section-start=.fwupdate_reset=0x20000
+ *   LDFLAGS += -Wl,--section-start=.BOOT=0x20008
+ *   \endcode
+ * - With IAR, the \c FWUPDATE_RESET segment must be placed at the start of
+ *   the boot section and the \c BOOT segment after it.
+ * - The stub only calls code that is placed in the boot section, so it
+ *   must not be built without optimization, where \c static \c inline
+ *   functions are not inlined.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_FWUPDATE_STAGING_START
+ * \brief Byte address of the staging region
+ *
+ * Must be a multiple of \ref FLASH_PAGE_SIZE. The active image may use the
+ * application section up to this address.
+ */
+#ifdef __DOXYGEN__
+# define CONFIG_FWUPDATE_STAGING_START
+#endif
+
+/**
+ * \def CONFIG_FWUPDATE_STAGING_SIZE
+ * \brief Size of the staging region in bytes, including the trailer page
+ *
+ * Must be a multiple of \ref FLASH_PAGE_SIZE. The largest image that can be
+ * installed is one page smaller.
+ */
+#ifdef __DOXYGEN__
+# define CONFIG_FWUPDATE_STAGING_SIZE
+#endif
+
+/**
+ * \def CONFIG_FWUPDATE_DMA_CH23
+ * \brief Receive with DMA channels 2 and 3 instead of 0 and 1
+ */
+#ifdef __DOXYGEN__
+# define CONFIG_FWUPDATE_DMA_CH23
+#endif
+
+#if !defined(CONFIG_FWUPDATE_STAGING_START) \
+		|| !defined(CONFIG_FWUPDATE_STAGING_SIZE)
+# error The staging region must be configured in conf_fwupdate.h
+#endif
+
+#if (CONFIG_FWUPDATE_STAGING_START % FLASH_PAGE_SIZE) \
+		|| (CONFIG_FWUPDATE_STAGING_SIZE % FLASH_PAGE_SIZE)
+# error The staging region must be aligned to flash pages
+#endif
+
+#if CONFIG_FWUPDATE_STAGING_SIZE - FLASH_PAGE_SIZE \
+		> CONFIG_FWUPDATE_STAGING_START
+# error The staging region must not be larger than the active image region
+#endif
+
+//! Acknowledge sent to the host.
+#define FWUPDATE_ACK                0x06
+
+//! Negative acknowledge sent to the host.
+#define FWUPDATE_NAK                0x15
+
+//! Byte address of the trailer page, the last page of the staging region.
+#define FWUPDATE_TRAILER_ADDRESS    ((flash_addr_t)CONFIG_FWUPDATE_STAGING_START \
+		+ CONFIG_FWUPDATE_STAGING_SIZE - FLASH_PAGE_SIZE)
+
+//! Largest image size in bytes.
+#define FWUPDATE_IMAGE_MAX_SIZE     ((uint32_t)CONFIG_FWUPDATE_STAGING_SIZE \
+		- FLASH_PAGE_SIZE)
+
+//! Trailer magic value, "FWUP" in ASCII.
+#define FWUPDATE_TRAILER_MAGIC      0x46575550UL
+
+/**
+ * \brief Trailer marking a verified image in the staging region
+ *
+ * The trailer is stored at the start of the trailer page. It is only valid
+ * if \a magic matches and \a trailer_crc is the CRC of the fields before
+ * it, so a page that was only partly written is never taken for a valid
+ * trailer.
+ */
+struct fwupdate_trailer {
+	//! \ref FWUPDATE_TRAILER_MAGIC
+	uint32_t magic;
+	//! Image size in bytes
+	uint32_t size;
+	//! CRC of the image
+	uint16_t image_crc;
+	//! CRC of the fields above
+	uint16_t trailer_crc;
+};
+
+status_code_t fwupdate_begin(USART_t *usart, uint8_t dma_trigger,
+		uint32_t size, uint16_t crc);
+status_code_t fwupdate_task(void);
+void fwupdate_abort(void);
+void fwupdate_install(void);
+bool fwupdate_is_pending(void);
+
+/**
+ * \name Boot section functions
+ *
+ * These functions are placed in the boot section, so the stub can use them
+ * while the application section is being rewritten.
+ *
+ * @{
+ */
+uint16_t fwupdate_crc_update(uint16_t crc, const uint8_t *data,
+		uint16_t length);
+uint16_t fwupdate_crc_flash(uint16_t crc, flash_addr_t address,
+		uint32_t length);
+bool fwupdate_read_trailer(struct fwupdate_trailer *trailer);
+void fwupdate_boot_main(void);
+//! @}
+
+//! @}
+
+#endif /* SERVICES_FWUPDATE_FWUPDATE_H */
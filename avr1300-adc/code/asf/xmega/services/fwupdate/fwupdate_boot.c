@@ -0,0 +1,255 @@
+/**
+ * \file
+ *
+ * \brief Dual-image firmware update boot section stub
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <compiler.h>
+#include <nvm.h>
+#include <fwupdate.h>
+
+/*
+ * Everything in this file is placed in the boot section. The stub runs
+ * while the application section is being rewritten, so it must not call
+ * any code outside the boot section. The ASF flash read functions and
+ * nvm_wait_until_ready() are static inline and may be emitted to the
+ * application section, so the stub uses its own copies below.
+ *
+ * The host test in asf_fwupdate_example/host_sim builds the stub against a
+ * flash model, which also takes the place of the jump to the application.
+ */
+#if defined(FWUPDATE_HOST_SIM)
+# define FWUPDATE_BOOT_FUNC
+# define fwupdate_boot_read_byte(addr)   fwupdate_host_read_byte(addr)
+# define fwupdate_boot_read_word(addr)   fwupdate_host_read_word(addr)
+# define fwupdate_boot_start_app()       fwupdate_host_start_app()
+# define fwupdate_boot_hold()            fwupdate_host_hold()
+#elif defined(__GNUC__)
+# define FWUPDATE_BOOT_FUNC    __attribute__((section(".BOOT")))
+# define fwupdate_boot_read_byte(addr)   pgm_read_byte_far(addr)
+# define fwupdate_boot_read_word(addr)   pgm_read_word_far(addr)
+# define fwupdate_boot_start_app()       asm volatile ("jmp 0")
+# define fwupdate_boot_hold()            do { } while (true)
+#elif defined(__ICCAVR__)
+# define FWUPDATE_BOOT_FUNC    COMPILER_PRAGMA(location = "BOOT")
+# define fwupdate_boot_read_byte(addr)   \
+		(*(uint8_t IAR_FLASH_PTR *)(addr))
+# define fwupdate_boot_read_word(addr)   \
+		(*(uint16_t IAR_FLASH_PTR *)(addr))
+# define fwupdate_boot_start_app()       asm("jmp 0")
+# define fwupdate_boot_hold()            do { } while (true)
+#else
+# error Unknown compiler
+#endif
+
+//! Number of copy attempts before the stub holds until the next reset.
+#define FWUPDATE_BOOT_COPY_ATTEMPTS    3
+
+/**
+ * \internal
+ * \brief Wait for the NVM controller to finish
+ */
+FWUPDATE_BOOT_FUNC static void fwupdate_boot_wait(void)
+{
+	while (NVM.STATUS & NVM_NVMBUSY_bm) {
+		// Wait for the page operation to finish
+	}
+}
+
+/**
+ * \brief Update a CRC-16-CCITT with a block of data in SRAM
+ *
+ * \param crc Current CRC value, 0xffff for a new calculation
+ * \param data Pointer to the data
+ * \param length Number of bytes
+ *
+ * \return Updated CRC value
+ */
+FWUPDATE_BOOT_FUNC uint16_t fwupdate_crc_update(uint16_t crc,
+		const uint8_t *data, uint16_t length)
+{
+	uint8_t x;
+
+	while (length--) {
+		x = (uint8_t)(crc >> 8) ^ *data++;
+		x ^= x >> 4;
+		crc = (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+	}
+
+	return crc;
+}
+
+/**
+ * \brief Update a CRC-16-CCITT with a block of flash
+ *
+ * \param crc Current CRC value, 0xffff for a new calculation
+ * \param address Byte address of the first byte
+ * \param length Number of bytes
+ *
+ * \return Updated CRC value
+ */
+FWUPDATE_BOOT_FUNC uint16_t fwupdate_crc_flash(uint16_t crc,
+		flash_addr_t address, uint32_t length)
+{
+	uint8_t x;
+
+	while (length--) {
+		x = (uint8_t)(crc >> 8) ^ fwupdate_boot_read_byte(address);
+		x ^= x >> 4;
+		crc = (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+		address++;
+	}
+
+	return crc;
+}
+
+/**
+ * \brief Read and check the trailer of the staging region
+ *
+ * \param trailer Pointer to storage for the trailer
+ *
+ * \retval true if the staging region holds a verified image
+ * \retval false if not
+ */
+FWUPDATE_BOOT_FUNC bool fwupdate_read_trailer(struct fwupdate_trailer *trailer)
+{
+	uint8_t *data = (uint8_t *)trailer;
+	uint8_t i;
+
+	for (i = 0; i < sizeof(struct fwupdate_trailer); i++) {
+		data[i] = fwupdate_boot_read_byte(FWUPDATE_TRAILER_ADDRESS + i);
+	}
+
+	return (trailer->magic == FWUPDATE_TRAILER_MAGIC)
+			&& (trailer->size != 0)
+			&& (trailer->size <= FWUPDATE_IMAGE_MAX_SIZE)
+			&& (trailer->trailer_crc == fwupdate_crc_update(0xffff, data,
+					offsetof(struct fwupdate_trailer, trailer_crc)));
+}
+
+/**
+ * \internal
+ * \brief Check if an active image page matches its staging copy
+ *
+ * \param address Byte address of the page in the active image
+ */
+FWUPDATE_BOOT_FUNC static bool fwupdate_boot_page_matches(
+		flash_addr_t address)
+{
+	flash_addr_t staging = CONFIG_FWUPDATE_STAGING_START + address;
+	uint16_t i;
+
+	for (i = 0; i < FLASH_PAGE_SIZE; i += 2) {
+		if (fwupdate_boot_read_word(address + i)
+				!= fwupdate_boot_read_word(staging + i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \internal
+ * \brief Copy a page from the staging region to the active image
+ *
+ * Every word of the page buffer is loaded, so the buffer needs no flush.
+ *
+ * \param address Byte address of the page in the active image
+ */
+FWUPDATE_BOOT_FUNC static void fwupdate_boot_copy_page(flash_addr_t address)
+{
+	flash_addr_t staging = CONFIG_FWUPDATE_STAGING_START + address;
+	uint16_t i;
+
+	for (i = 0; i < FLASH_PAGE_SIZE; i += 2) {
+		nvm_flash_load_word_to_buffer(address + i,
+				fwupdate_boot_read_word(staging + i));
+	}
+
+	nvm_common_spm(address, NVM_CMD_ERASE_WRITE_APP_PAGE_gc);
+	fwupdate_boot_wait();
+}
+
+/**
+ * \brief Install a pending image and start the application
+ *
+ * This is entered from the reset entry in the boot section on every reset.
+ * If the staging region holds a verified image, it is copied over the
+ * active image. The trailer is erased when the copy has been verified, so
+ * an interrupted copy is resumed on the next reset.
+ *
+ * If the copy cannot be verified after \ref FWUPDATE_BOOT_COPY_ATTEMPTS
+ * attempts, the active image is partly overwritten and must not be started.
+ * The stub then holds with the trailer kept, and tries again after the next
+ * reset, for instance by the watchdog timer if it is enabled by fuse.
+ */
+FWUPDATE_BOOT_FUNC void fwupdate_boot_main(void)
+{
+	struct fwupdate_trailer trailer;
+	flash_addr_t end;
+	flash_addr_t address;
+	uint8_t attempt;
+
+	if (fwupdate_read_trailer(&trailer)) {
+		end = (trailer.size + FLASH_PAGE_SIZE - 1)
+				& ~((flash_addr_t)FLASH_PAGE_SIZE - 1);
+
+		for (attempt = 0; attempt < FWUPDATE_BOOT_COPY_ATTEMPTS;
+				attempt++) {
+			for (address = 0; address < end;
+					address += FLASH_PAGE_SIZE) {
+				if (!fwupdate_boot_page_matches(address)) {
+					fwupdate_boot_copy_page(address);
+				}
+			}
+
+			if (fwupdate_crc_flash(0xffff, 0, trailer.size)
+					== trailer.image_crc) {
+				nvm_common_spm(FWUPDATE_TRAILER_ADDRESS,
+						NVM_CMD_ERASE_APP_PAGE_gc);
+				fwupdate_boot_wait();
+				break;
+			}
+		}
+
+		if (attempt == FWUPDATE_BOOT_COPY_ATTEMPTS) {
+			// Wait for a reset
+			fwupdate_boot_hold();
+		}
+	}
+
+	// Start the application from its reset vector
+	fwupdate_boot_start_app();
+}
@@ -0,0 +1,73 @@
+/**
+ * \file
+ *
+ * \brief Dual-image firmware update boot section reset entry
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assembler.h>
+
+	/*
+	 * With the BOOTRST fuse programmed, the device starts here after
+	 * every reset. The stack pointer is set to the end of internal SRAM
+	 * by hardware, so all that is needed before C code can run is the
+	 * register setup normally done by the C startup code of the
+	 * application, which is not run yet.
+	 */
+
+	PUBLIC_FUNCTION_SEGMENT(fwupdate_boot_reset, fwupdate_reset)
+
+#if defined(__GNUC__)
+
+	clr     r1                      // GCC expects zero in r1
+	out     SREG, r1                // Start with interrupts disabled
+	jmp     fwupdate_boot_main
+
+#elif defined(__IAR_SYSTEMS_ASM__)
+
+	EXTERN  fwupdate_boot_main
+	RSEG    CSTACK:DATA:NOROOT(0)
+	RSEG    fwupdate_reset:CODE
+
+	ldi     r16, 0
+	out     SREG, r16               // Start with interrupts disabled
+	ldi     r28, LOW(SFE(CSTACK))   // IAR keeps the data stack in Y
+	ldi     r29, HIGH(SFE(CSTACK))
+	jmp     fwupdate_boot_main
+
+#else
+# error Unknown assembler
+#endif
+
+	END_FUNC(fwupdate_boot_reset)
+	END_FILE()
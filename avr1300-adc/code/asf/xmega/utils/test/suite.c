@@ -39,8 +39,17 @@
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <status_codes.h>
 #include <test/suite.h>	
 
+#if !defined(CONFIG_TEST_BENCHMARK_CYCLES)
+# if defined(XMEGA)
+#  include <sysclk.h>
+# else
+#  include <time.h>
+# endif
+#endif
+
 /**
  * \weakgroup test_suite_group
  * @{
@@ -95,6 +104,184 @@ static int test_call(void (*func)(const struct test_case *),
 	return TEST_PASS;
 }
 
+/**
+ * \internal
+ * \name Benchmark timer
+ *
+ * The timer is started right before and stopped right after each run of
+ * a benchmark case. test_benchmark_timer_stop() returns the elapsed
+ * cycles.
+ */
+//@{
+#if defined(CONFIG_TEST_BENCHMARK_CYCLES)
+
+extern uint32_t CONFIG_TEST_BENCHMARK_CYCLES(void);
+
+static uint32_t test_benchmark_start;
+
+static void test_benchmark_timer_init(void)
+{
+}
+
+static inline void test_benchmark_timer_start(void)
+{
+	test_benchmark_start = CONFIG_TEST_BENCHMARK_CYCLES();
+}
+
+static inline uint32_t test_benchmark_timer_stop(void)
+{
+	return CONFIG_TEST_BENCHMARK_CYCLES() - test_benchmark_start;
+}
+
+static uint32_t test_benchmark_timer_hz(void)
+{
+	return CONFIG_TEST_BENCHMARK_HZ;
+}
+
+#elif defined(XMEGA)
+
+/*
+ * TCC0 counts clk_PER, which runs at the CPU clock. Its overflow is
+ * routed through event channel 7 to clock TCC1, giving 32 bits. Both
+ * counters are read with TCC0 stopped, so there is no carry to catch.
+ */
+static void test_benchmark_timer_init(void)
+{
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TC0);
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TC1);
+
+	TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+	TCC0.PER = 0xffff;
+	TCC1.PER = 0xffff;
+	EVSYS.CH7MUX = EVSYS_CHMUX_TCC0_OVF_gc;
+	TCC1.CTRLA = TC_CLKSEL_EVCH7_gc;
+}
+
+static inline void test_benchmark_timer_start(void)
+{
+	TCC0.CNT = 0;
+	TCC1.CNT = 0;
+	TCC0.CTRLA = TC_CLKSEL_DIV1_gc;
+}
+
+static inline uint32_t test_benchmark_timer_stop(void)
+{
+	TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+
+	return ((uint32_t)TCC1.CNT << 16) | TCC0.CNT;
+}
+
+static uint32_t test_benchmark_timer_hz(void)
+{
+	return sysclk_get_per_hz();
+}
+
+#else
+
+static clock_t test_benchmark_start;
+
+static void test_benchmark_timer_init(void)
+{
+}
+
+static inline void test_benchmark_timer_start(void)
+{
+	test_benchmark_start = clock();
+}
+
+static inline uint32_t test_benchmark_timer_stop(void)
+{
+	return (uint32_t)(clock() - test_benchmark_start);
+}
+
+static uint32_t test_benchmark_timer_hz(void)
+{
+	return CLOCKS_PER_SEC;
+}
+
+#endif
+//@}
+
+//! \internal Empty run, timed to find the cost of the timing itself.
+static void test_benchmark_empty(const struct test_case *test)
+{
+}
+
+/**
+ * \internal
+ * Time one run of \a func.
+ */
+static uint32_t test_benchmark_time(void (*func)(const struct test_case *),
+	const struct test_case *test)
+{
+	test_benchmark_timer_start();
+	func(test);
+	return test_benchmark_timer_stop();
+}
+
+/**
+ * \internal
+ * Run a benchmark case and print its result
+ *
+ * \a test->run is called \a test->repeat times. The samples are sorted
+ * to report the minimum, the median and the maximum, after subtracting
+ * the time of an empty run.
+ *
+ * \return #TEST_PASS if all runs were executed successfully, or the
+ * result value passed to test_fail() on failure.
+ */
+static int test_benchmark_run(const struct test_case *test)
+{
+	static uint32_t samples[CONFIG_TEST_BENCHMARK_MAX_REPEAT];
+	void (*volatile empty)(const struct test_case *) = test_benchmark_empty;
+	uint32_t overhead;
+	uint32_t median;
+	uint32_t hz;
+	uint16_t i;
+	uint16_t j;
+	int ret;
+
+	if (test->repeat > CONFIG_TEST_BENCHMARK_MAX_REPEAT)
+		return ERR_INVALID_ARG;
+
+	test_benchmark_timer_init();
+	overhead = test_benchmark_time(empty, test);
+
+	ret = setjmp(test_failure_jmpbuf);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < test->repeat; i++) {
+		uint32_t sample = test_benchmark_time(test->run, test);
+
+		sample = (sample > overhead) ? sample - overhead : 0;
+
+		// Insertion sort, the number of samples is small
+		for (j = i; (j > 0) && (samples[j - 1] > sample); j--)
+			samples[j] = samples[j - 1];
+		samples[j] = sample;
+	}
+
+	median = samples[test->repeat / 2];
+	if (!(test->repeat & 1))
+		median = (samples[test->repeat / 2 - 1] + median) / 2;
+
+	hz = test_benchmark_timer_hz();
+	dbg_info("BENCH name=\"%s\" repeat=%u min=%lu median=%lu max=%lu "
+			"hz=%lu bytes=%lu bytes_per_s=%lu\n",
+			test->name, test->repeat,
+			(unsigned long)samples[0],
+			(unsigned long)median,
+			(unsigned long)samples[test->repeat - 1],
+			(unsigned long)hz,
+			(unsigned long)test->bytes,
+			(unsigned long)(median ? (uint64_t)test->bytes * hz / median
+					: 0));
+
+	return TEST_PASS;
+}
+
 static int test_case_run(const struct test_case *test)
 {
 	int	result;
@@ -111,7 +298,10 @@ static int test_case_run(const struct test_case *test)
 		}
 	}
 
-	result = test_call(test->run, test);
+	if (test->repeat)
+		result = test_benchmark_run(test);
+	else
+		result = test_call(test->run, test);
 	if (result)
 		test_report_failure(test, "test", result);
 
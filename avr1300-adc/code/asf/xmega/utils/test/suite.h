@@ -126,6 +126,15 @@ struct test_case {
 	void (*cleanup)(const struct test_case *test);
 	//! The name of this test
 	const char *name;
+	/**
+	 * \brief Number of timed runs of a benchmark case
+	 *
+	 * Zero for an ordinary test case, which is run once and only
+	 * reports whether it passed. See DEFINE_BENCHMARK_CASE().
+	 */
+	uint16_t repeat;
+	//! Number of bytes processed by one run of a benchmark case, or 0
+	uint32_t bytes;
 };
 
 /**
@@ -145,6 +154,78 @@ struct test_case {
 		.name           = _test_str_##_sym                    \
 	}
 
+/**
+ * \brief Convenience macro for creating a benchmark case struct.
+ *
+ * A benchmark case is run by the test suite like a test case, except
+ * that \a _run is called \a _repeat times and each call is timed. The
+ * fixture is set up once before the first run and cleaned up after the
+ * last one, so only \a _run is measured. It may call test_fail() like a
+ * test, which stops the benchmark and fails the case.
+ *
+ * The result is printed as one line of key=value pairs:
+ * \code
+ * BENCH name="crc32 1 KB" repeat=8 min=9230 median=9232 max=9240 hz=2000000 bytes=1024 bytes_per_s=221837
+ * \endcode
+ * min, median and max are in CPU cycles, with the cost of the timing
+ * itself subtracted. bytes_per_s is calculated from the median and is
+ * 0 if \a _bytes is 0. Interrupts taken during a run are included in
+ * its time, so a setup function may want to disable the ones not
+ * needed by the code under test.
+ *
+ * On XMEGA, the cycles are counted by a 32-bit cascade of TCC0 and
+ * TCC1 clocked from clk_PER through event channel 7. Other builds use
+ * \ref CONFIG_TEST_BENCHMARK_CYCLES.
+ *
+ * \param _sym Variable name of the resulting struct
+ * \param _setup Function which sets up the benchmark environment. Can
+ * be NULL.
+ * \param _run Function to benchmark
+ * \param _cleanup Function which cleans up what was set up. Can be NULL.
+ * \param _name String describing the benchmark case.
+ * \param _repeat Number of timed runs, at most
+ * \ref CONFIG_TEST_BENCHMARK_MAX_REPEAT
+ * \param _bytes Number of bytes processed by one run, or 0
+ */
+#define DEFINE_BENCHMARK_CASE(_sym, _setup, _run, _cleanup, _name,   \
+		_repeat, _bytes)                                       \
+	static const char _test_str_##_sym[] = _name;             \
+	static const struct test_case _sym = {                    \
+		.setup          = _setup,                             \
+		.run            = _run,                               \
+		.cleanup        = _cleanup,                           \
+		.name           = _test_str_##_sym,                   \
+		.repeat         = _repeat,                            \
+		.bytes          = _bytes                              \
+	}
+
+/**
+ * \def CONFIG_TEST_BENCHMARK_MAX_REPEAT
+ * \brief Maximum number of timed runs of a benchmark case
+ *
+ * One 32-bit sample is kept per run to find the median. Defaults to 16.
+ *
+ * \def CONFIG_TEST_BENCHMARK_CYCLES
+ * \brief Name of a function returning a free-running 32-bit cycle counter
+ *
+ * The function takes no arguments and returns uint32_t. It replaces the
+ * XMEGA Timer/Counter cascade, e.g. with the cycle counter of a simulator
+ * when the suite is built for a host. If neither this nor XMEGA is
+ * defined, clock() is used.
+ *
+ * \def CONFIG_TEST_BENCHMARK_HZ
+ * \brief Rate of the \ref CONFIG_TEST_BENCHMARK_CYCLES counter in Hz
+ */
+#ifdef __DOXYGEN__
+# define CONFIG_TEST_BENCHMARK_MAX_REPEAT
+# define CONFIG_TEST_BENCHMARK_CYCLES
+# define CONFIG_TEST_BENCHMARK_HZ
+#endif
+
+#ifndef CONFIG_TEST_BENCHMARK_MAX_REPEAT
+# define CONFIG_TEST_BENCHMARK_MAX_REPEAT  16
+#endif
+
 /**
  * \brief Convenience macro for creating an array of test cases.
  * @param _sym Variable name of the resulting array
@@ -0,0 +1,375 @@
+/**
+ * \file
+ *
+ * \brief Test suite benchmark example
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <compiler.h>
+#include <stdio.h>
+#include <board.h>
+#include <led.h>
+#include <sysclk.h>
+#include <crc.h>
+#include <test/suite.h>
+#include <usart_driver.h>
+#include <twi_master_driver.h>
+#include <twi_slave_driver.h>
+#include <AES_driver.h>
+
+/*! Size of the block processed by the CRC, USART and AES benchmarks. */
+#define BLOCK_SIZE 1024
+
+/*! Number of timed runs of each benchmark. */
+#define REPEAT     8
+
+/*! Address of the TWI slave, which shares TWIC with the master. */
+#define TWI_SLAVE_ADDRESS  0x55
+
+/*! Bytes written, and then read back, by one TWI transaction. */
+#define TWI_BYTES          TWIM_WRITE_BUFFER_SIZE
+
+/*! TWI baud rate setting for 100 kHz at the 2 MHz reset clock. */
+#define TWI_BAUDSETTING    TWI_BAUD_MAX(2000000UL, 100000UL)
+
+void board_init(void);
+
+/*! Block checksummed and encrypted from SRAM. */
+static uint8_t block[BLOCK_SIZE];
+
+/*! Ciphertext of the AES benchmarks. */
+static uint8_t cipher[BLOCK_SIZE];
+
+/*! Result of the last run, so the calls are not optimized away. */
+static volatile uint32_t result;
+
+/*! Interrupt driver of USARTD0, fed by USART_RXComplete(). */
+static USART_data_t usart_data;
+
+/*! TWI master and slave drivers on TWIC. */
+static TWI_Master_t twi_master;
+static TWI_Slave_t twi_slave;
+
+/*! Data written by the TWI master. */
+static uint8_t twi_data[TWI_BYTES] = {
+	0x55, 0xaa, 0xf0, 0x0f, 0xb0, 0x0b, 0xde, 0xad
+};
+
+/*! AES-128 key, plaintext and ciphertext from FIPS-197 appendix C.1. */
+static uint8_t aes_key[AES_BLOCK_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static uint8_t aes_plaintext[AES_BLOCK_LENGTH] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t aes_ciphertext[AES_BLOCK_LENGTH] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/*! Initialization vector of the AES CBC benchmark. */
+static uint8_t aes_init[AES_BLOCK_LENGTH];
+
+/*! Send one character to the USB bridge on USARTC0. */
+static int usart_putchar(char c, FILE *stream)
+{
+	if (c == '\n') {
+		usart_putchar('\r', stream);
+	}
+	while (!(USARTC0.STATUS & USART_DREIF_bm)) {
+	}
+	USARTC0.DATA = c;
+	return 0;
+}
+
+static FILE usart_stdout = FDEV_SETUP_STREAM(usart_putchar, NULL,
+		_FDEV_SETUP_WRITE);
+
+static void run_check_values(const struct test_case *test)
+{
+	static const uint8_t check[] = "123456789";
+
+	test_fail_unless(test,
+			crc16_ccitt_update(CRC16_CCITT_INIT, check, 9) == 0x29b1,
+			"CRC-16-CCITT check value mismatch");
+	test_fail_unless(test,
+			crc32_finalize(crc32_update(CRC32_INIT, check, 9))
+			== 0xcbf43926UL,
+			"CRC-32 check value mismatch");
+}
+
+static void setup_block(const struct test_case *test)
+{
+	uint16_t i;
+
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		block[i] = i;
+	}
+}
+
+static void run_crc16_sram(const struct test_case *test)
+{
+	result = crc16_ccitt_update(CRC16_CCITT_INIT, block, BLOCK_SIZE);
+}
+
+static void run_crc32_sram(const struct test_case *test)
+{
+	result = crc32_update(CRC32_INIT, block, BLOCK_SIZE);
+}
+
+static void run_crc16_flash(const struct test_case *test)
+{
+	result = crc16_ccitt_update_flash(CRC16_CCITT_INIT, 0, BLOCK_SIZE);
+}
+
+static void run_crc32_flash(const struct test_case *test)
+{
+	result = crc32_update_flash(CRC32_INIT, 0, BLOCK_SIZE);
+}
+
+static void run_nvm_flash_range(const struct test_case *test)
+{
+	result = crc_nvm_flash_range(0, BLOCK_SIZE - 1);
+}
+
+/*! The slave returns each byte inverted, as in the TWI application note. */
+static void twi_slave_process_data(void)
+{
+	uint8_t index = twi_slave.bytesReceived;
+
+	twi_slave.sendData[index] = ~twi_slave.receivedData[index];
+}
+
+static void setup_usart_rx(const struct test_case *test)
+{
+	sysclk_enable_module(SYSCLK_PORT_D, SYSCLK_USART0);
+	USART_InterruptDriver_Initialize(&usart_data, &USARTD0,
+			USART_DREINTLVL_OFF_gc);
+}
+
+/*
+ * Run the receive complete handler once per byte and empty the ring
+ * buffer after each call, as the application would. The receiver is
+ * off, so the data register just holds its last value.
+ */
+static void run_usart_rx(const struct test_case *test)
+{
+	uint16_t i;
+
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		test_fail_unless(test, USART_RXComplete(&usart_data),
+				"USART receive buffer overflow");
+		result = USART_RXBuffer_GetByte(&usart_data);
+	}
+}
+
+static void setup_twi(const struct test_case *test)
+{
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TWI);
+
+	/* Use the internal pull-ups on SDA and SCL, in case the board has
+	 * none.
+	 */
+	PORTCFG.MPCMASK = PIN0_bm | PIN1_bm;
+	PORTC.PIN0CTRL = (PORTC.PIN0CTRL & ~PORT_OPC_gm)
+			| PORT_OPC_WIREDANDPULL_gc;
+
+	TWI_MasterInit(&twi_master, &TWIC, TWI_MASTER_INTLVL_LO_gc,
+			TWI_BAUDSETTING);
+	TWI_SlaveInitializeDriver(&twi_slave, &TWIC, twi_slave_process_data);
+	TWI_SlaveInitializeModule(&twi_slave, TWI_SLAVE_ADDRESS,
+			TWI_SLAVE_INTLVL_LO_gc);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+}
+
+/*
+ * One write-read transaction between the master and the slave on TWIC.
+ * Both interrupt handlers run within the timed call, so the time is the
+ * bus time plus the handler load on the CPU.
+ */
+static void run_twi(const struct test_case *test)
+{
+	uint8_t expected;
+	uint8_t i;
+
+	test_fail_unless(test, TWI_MasterWriteRead(&twi_master,
+			TWI_SLAVE_ADDRESS, twi_data, TWI_BYTES, TWI_BYTES),
+			"TWI master busy");
+	while (twi_master.status != TWIM_STATUS_READY) {
+		/* Wait until transaction is complete. */
+	}
+	test_fail_unless(test, twi_master.result == TWIM_RESULT_OK,
+			"TWI transaction result %d", twi_master.result);
+	for (i = 0; i < TWI_BYTES; i++) {
+		expected = ~twi_data[i];
+		test_fail_unless(test, twi_master.readData[i] == expected,
+				"TWI read data mismatch at %d", i);
+	}
+}
+
+static void cleanup_twi(const struct test_case *test)
+{
+	cli();
+	PMIC.CTRL &= ~PMIC_LOLVLEN_bm;
+	TWIC.MASTER.CTRLA = 0;
+	TWIC.SLAVE.CTRLA = 0;
+}
+
+static void setup_aes(const struct test_case *test)
+{
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_AES);
+	setup_block(test);
+}
+
+static void run_aes_check_value(const struct test_case *test)
+{
+	uint8_t out[AES_BLOCK_LENGTH];
+	uint8_t i;
+
+	test_fail_unless(test, AES_encrypt(aes_plaintext, out, aes_key),
+			"AES error");
+	for (i = 0; i < AES_BLOCK_LENGTH; i++) {
+		test_fail_unless(test, out[i] == aes_ciphertext[i],
+				"AES ciphertext mismatch at %d", i);
+	}
+}
+
+static void run_aes_encrypt(const struct test_case *test)
+{
+	uint16_t i;
+
+	for (i = 0; i < BLOCK_SIZE; i += AES_BLOCK_LENGTH) {
+		test_fail_unless(test,
+				AES_encrypt(&block[i], &cipher[i], aes_key),
+				"AES error");
+	}
+}
+
+static void run_aes_cbc_encrypt(const struct test_case *test)
+{
+	test_fail_unless(test, AES_CBC_encrypt(block, cipher, aes_key, aes_init,
+			BLOCK_SIZE / AES_BLOCK_LENGTH), "AES error");
+}
+
+DEFINE_TEST_CASE(check_values, NULL, run_check_values, NULL,
+		"CRC check values");
+DEFINE_BENCHMARK_CASE(crc16_sram, setup_block, run_crc16_sram, NULL,
+		"crc16_ccitt_update SRAM", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(crc32_sram, setup_block, run_crc32_sram, NULL,
+		"crc32_update SRAM", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(crc16_flash, NULL, run_crc16_flash, NULL,
+		"crc16_ccitt_update_flash", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(crc32_flash, NULL, run_crc32_flash, NULL,
+		"crc32_update_flash", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(nvm_flash_range, NULL, run_nvm_flash_range, NULL,
+		"crc_nvm_flash_range", REPEAT, BLOCK_SIZE);
+
+DEFINE_TEST_ARRAY(crc_tests) = {
+	&check_values,
+	&crc16_sram,
+	&crc32_sram,
+	&crc16_flash,
+	&crc32_flash,
+	&nvm_flash_range,
+};
+
+DEFINE_TEST_SUITE(crc_suite, crc_tests, "CRC service");
+
+DEFINE_BENCHMARK_CASE(usart_rx, setup_usart_rx, run_usart_rx, NULL,
+		"USART_RXComplete", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(twi_write_read, setup_twi, run_twi, cleanup_twi,
+		"TWI_MasterWriteRead 100 kHz", REPEAT, 2 * TWI_BYTES);
+DEFINE_TEST_CASE(aes_check_value, setup_aes, run_aes_check_value, NULL,
+		"AES check value");
+DEFINE_BENCHMARK_CASE(aes_encrypt, setup_aes, run_aes_encrypt, NULL,
+		"AES_encrypt", REPEAT, BLOCK_SIZE);
+DEFINE_BENCHMARK_CASE(aes_cbc_encrypt, setup_aes, run_aes_cbc_encrypt, NULL,
+		"AES_CBC_encrypt", REPEAT, BLOCK_SIZE);
+
+DEFINE_TEST_ARRAY(driver_tests) = {
+	&usart_rx,
+	&twi_write_read,
+	&aes_check_value,
+	&aes_encrypt,
+	&aes_cbc_encrypt,
+};
+
+DEFINE_TEST_SUITE(driver_suite, driver_tests, "Application note drivers");
+
+/*! TWIC master interrupt vector. */
+ISR(TWIC_TWIM_vect)
+{
+	TWI_MasterInterruptHandler(&twi_master);
+}
+
+/*! TWIC slave interrupt vector. */
+ISR(TWIC_TWIS_vect)
+{
+	TWI_SlaveInterruptHandler(&twi_slave);
+}
+
+int main(void)
+{
+	int fail;
+
+	board_init();
+	sysclk_init();
+
+	/* USARTC0 is connected to the USB bridge on the Xplain board.
+	 * 19200 baud, 8N1 at the 2 MHz reset clock.
+	 */
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_USART0);
+	PORTC.DIRSET = PIN3_bm;
+	USARTC0.BAUDCTRLA = 12;
+	USARTC0.BAUDCTRLB = 0;
+	USARTC0.CTRLC = USART_CMODE_ASYNCHRONOUS_gc | USART_PMODE_DISABLED_gc
+			| USART_CHSIZE_8BIT_gc;
+	USARTC0.CTRLB = USART_TXEN_bm;
+	stdout = &usart_stdout;
+
+	fail = test_suite_run(&crc_suite);
+	fail |= test_suite_run(&driver_suite);
+
+	if (fail == 0) {
+		LED_On(LED0_GPIO);
+	} else {
+		LED_On(LED1_GPIO);
+	}
+
+	while (true) {
+	}
+}
@@ -0,0 +1,142 @@
+/**
+ * \file
+ *
+ * \brief CRC service example
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <compiler.h>
+#include <board.h>
+#include <led.h>
+#include <crc.h>
+
+/*! Size of the blocks used for the throughput measurement. */
+#define BLOCK_SIZE 1024
+
+void board_init(void);
+
+/*! Indexes into \ref cycles. */
+enum measurement {
+	CRC16_SRAM,
+	CRC32_SRAM,
+	CRC16_FLASH,
+	CRC32_FLASH,
+	NVM_FLASH_RANGE,
+	MEASUREMENT_COUNT,
+};
+
+/*! CPU cycles to checksum BLOCK_SIZE bytes with each method. At 2 MHz,
+ *  the throughput in bytes per second is BLOCK_SIZE * 2000000 / cycles.
+ */
+volatile uint16_t cycles[MEASUREMENT_COUNT];
+
+/*! Results of the NVM controller CRC, kept for the debugger. */
+volatile uint32_t nvm_crc;
+
+/*! Block checksummed from SRAM. */
+static uint8_t block[BLOCK_SIZE];
+
+/*! Check the software CRCs against their standard check values, both in
+ *  one call and split in several updates.
+ */
+static bool crc_self_test(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint32_t crc32;
+	uint16_t crc16;
+	uint8_t i;
+
+	if (crc16_ccitt_update(CRC16_CCITT_INIT, check, 9) != 0x29b1) {
+		return false;
+	}
+	if (crc32_finalize(crc32_update(CRC32_INIT, check, 9)) != 0xcbf43926UL) {
+		return false;
+	}
+
+	crc16 = crc16_ccitt_update(CRC16_CCITT_INIT, check, 4);
+	crc32 = crc32_update(CRC32_INIT, check, 4);
+	for (i = 4; i < 9; i++) {
+		crc16 = crc16_ccitt_byte(crc16, check[i]);
+		crc32 = crc32_byte(crc32, check[i]);
+	}
+
+	return (crc16 == 0x29b1) && (crc32_finalize(crc32) == 0xcbf43926UL);
+}
+
+int main(void)
+{
+	uint16_t i;
+
+	board_init();
+
+	if (crc_self_test()) {
+		LED_On(LED0_GPIO);
+	} else {
+		LED_On(LED1_GPIO);
+	}
+
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		block[i] = i;
+	}
+
+	/* Timer/Counter C0 counts CPU cycles. */
+	TCC0.PER = 0xffff;
+	TCC0.CTRLA = TC_CLKSEL_DIV1_gc;
+
+	TCC0.CNT = 0;
+	crc16_ccitt_update(CRC16_CCITT_INIT, block, BLOCK_SIZE);
+	cycles[CRC16_SRAM] = TCC0.CNT;
+
+	TCC0.CNT = 0;
+	crc32_update(CRC32_INIT, block, BLOCK_SIZE);
+	cycles[CRC32_SRAM] = TCC0.CNT;
+
+	TCC0.CNT = 0;
+	crc16_ccitt_update_flash(CRC16_CCITT_INIT, 0, BLOCK_SIZE);
+	cycles[CRC16_FLASH] = TCC0.CNT;
+
+	TCC0.CNT = 0;
+	crc32_update_flash(CRC32_INIT, 0, BLOCK_SIZE);
+	cycles[CRC32_FLASH] = TCC0.CNT;
+
+	TCC0.CNT = 0;
+	nvm_crc = crc_nvm_flash_range(0, BLOCK_SIZE - 1);
+	cycles[NVM_FLASH_RANGE] = TCC0.CNT;
+
+	TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+
+	LED_On(LED2_GPIO);
+
+	while (true) {
+	}
+}
@@ -0,0 +1,368 @@
+/**
+ * \file
+ *
+ * \brief Host check of the CRC service
+ *
+ * This program runs the software CRCs of the CRC service on the host and
+ * checks:
+ * - check: the check values of "123456789", 0x29b1 for CRC-16-CCITT and
+ *   0xcbf43926 for CRC-32, with both CRC-32 tables.
+ * - split: a CRC built up block by block, with blocks of 1 to 97 bytes, or
+ *   byte by byte as a receive interrupt would, equals the CRC of the whole
+ *   buffer in one call.
+ * - variants: the 256-entry and the 16-entry CRC-32 tables give the same
+ *   CRC for every byte value from a set of CRC values, and for the whole
+ *   buffer.
+ * - memories: the flash and EEPROM functions give the CRC of the same data
+ *   in SRAM, from an address that is not page aligned.
+ * - speed: the host TSC cycles per byte of each variant. These only compare
+ *   the variants with each other on the host; they are not AVR cycles.
+ *
+ * The 16-entry table variant is built from the same crc.c, with
+ * \ref CONFIG_CRC32_SMALL_TABLE defined and the function names prefixed
+ * with small_, so both variants are in one program.
+ *
+ * Each line holds space separated key=value pairs, and the program exits
+ * with a non-zero status if a check fails.
+ *
+ * Build and run from the asf_crc_example directory, on an x86-64 host:
+ * \code
+ * gcc -std=gnu99 -O2 -Ihost_sim -I. -I../asf/xmega/services/crc \
+ *     host_sim/crc_check.c ../asf/xmega/services/crc/crc.c -o crc_check
+ * ./crc_check
+ * \endcode
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <x86intrin.h>
+#include <compiler.h>
+#include <nvm.h>
+#include <crc.h>
+
+#define CONFIG_CRC32_SMALL_TABLE
+#define crc32_byte                  small_crc32_byte
+#define crc16_ccitt_update          small_crc16_ccitt_update
+#define crc16_ccitt_update_flash    small_crc16_ccitt_update_flash
+#define crc16_ccitt_update_eeprom   small_crc16_ccitt_update_eeprom
+#define crc32_update                small_crc32_update
+#define crc32_update_flash          small_crc32_update_flash
+#define crc32_update_eeprom         small_crc32_update_eeprom
+#define crc_nvm_flash_range         small_crc_nvm_flash_range
+#define crc_nvm_app_section         small_crc_nvm_app_section
+#define crc_nvm_boot_section        small_crc_nvm_boot_section
+
+uint32_t small_crc32_byte(uint32_t crc, uint8_t data);
+uint32_t small_crc32_update(uint32_t crc, const uint8_t *data,
+		uint16_t length);
+
+#include <crc.c>
+
+#undef crc32_byte
+#undef crc16_ccitt_update
+#undef crc16_ccitt_update_flash
+#undef crc16_ccitt_update_eeprom
+#undef crc32_update
+#undef crc32_update_flash
+#undef crc32_update_eeprom
+#undef crc_nvm_flash_range
+#undef crc_nvm_app_section
+#undef crc_nvm_boot_section
+
+//! Check string of the CRC catalogues
+#define TEST_CHECK_STRING       "123456789"
+
+//! CRC-16-CCITT of the check string
+#define TEST_CHECK_CRC16        0x29b1
+
+//! CRC-32 of the check string
+#define TEST_CHECK_CRC32        0xcbf43926UL
+
+//! Size of the test buffer
+#define TEST_BUFFER_SIZE        1000
+
+//! Flash and EEPROM address of the test data, not page aligned
+#define TEST_MEMORY_ADDRESS     45
+
+//! Size of the flash and EEPROM models
+#define TEST_FLASH_SIZE         2048
+#define TEST_EEPROM_SIZE        2048
+
+//! Bytes and repetitions of the speed measurement
+#define TEST_SPEED_SIZE         4096
+#define TEST_SPEED_RUNS         200
+
+struct host_nvm host_nvm;
+
+//! Flash model
+static uint8_t test_flash[TEST_FLASH_SIZE];
+
+//! EEPROM model
+static uint8_t test_eeprom[TEST_EEPROM_SIZE];
+
+//! Test data
+static uint8_t test_buffer[TEST_BUFFER_SIZE];
+
+//! Keeps the speed measurement from being optimized away
+static volatile uint32_t test_sink;
+
+uint8_t nvm_flash_read_byte(flash_addr_t addr)
+{
+	return test_flash[addr % TEST_FLASH_SIZE];
+}
+
+uint8_t nvm_eeprom_read_byte(uint8_t page_addr, uint8_t byte_addr)
+{
+	uint16_t address = page_addr * EEPROM_PAGE_SIZE
+			+ (byte_addr & (EEPROM_PAGE_SIZE - 1));
+
+	return test_eeprom[address % TEST_EEPROM_SIZE];
+}
+
+void nvm_issue_command(NVM_CMD_t nvm_command)
+{
+	(void)nvm_command;
+}
+
+void nvm_wait_until_ready(void)
+{
+}
+
+//! Fill the test buffer with a pseudo-random sequence
+static void test_fill(void)
+{
+	uint32_t seed = 1;
+	uint16_t i;
+
+	for (i = 0; i < TEST_BUFFER_SIZE; i++) {
+		seed = seed * 1103515245UL + 12345UL;
+		test_buffer[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+//! Check the check values of both CRCs and both CRC-32 tables
+static bool test_check(void)
+{
+	const uint8_t *data = (const uint8_t *)TEST_CHECK_STRING;
+	uint8_t length = strlen(TEST_CHECK_STRING);
+	uint16_t crc16;
+	uint32_t crc32;
+	uint32_t small32;
+	bool success;
+
+	crc16 = crc16_ccitt_update(CRC16_CCITT_INIT, data, length);
+	crc32 = crc32_finalize(crc32_update(CRC32_INIT, data, length));
+	small32 = crc32_finalize(small_crc32_update(CRC32_INIT, data, length));
+	success = (crc16 == TEST_CHECK_CRC16) && (crc32 == TEST_CHECK_CRC32)
+			&& (small32 == TEST_CHECK_CRC32);
+
+	printf("test=check crc16=0x%04x crc32=0x%08lx small_crc32=0x%08lx"
+			" result=%s\n", crc16, (unsigned long)crc32,
+			(unsigned long)small32, success ? "pass" : "fail");
+
+	return success;
+}
+
+//! Check that a CRC built up in blocks equals the CRC in one call
+static bool test_split(void)
+{
+	uint16_t whole16;
+	uint32_t whole32;
+	uint16_t splits = 0;
+	uint16_t mismatches = 0;
+	uint16_t block;
+	uint16_t i;
+
+	whole16 = crc16_ccitt_update(CRC16_CCITT_INIT, test_buffer,
+			TEST_BUFFER_SIZE);
+	whole32 = crc32_update(CRC32_INIT, test_buffer, TEST_BUFFER_SIZE);
+
+	for (block = 1; block <= 97; block += 8) {
+		uint16_t crc16 = CRC16_CCITT_INIT;
+		uint32_t crc32 = CRC32_INIT;
+
+		for (i = 0; i < TEST_BUFFER_SIZE; i += block) {
+			uint16_t length = (TEST_BUFFER_SIZE - i < block)
+					? TEST_BUFFER_SIZE - i : block;
+
+			crc16 = crc16_ccitt_update(crc16, &test_buffer[i], length);
+			crc32 = crc32_update(crc32, &test_buffer[i], length);
+		}
+		mismatches += (crc16 != whole16) + (crc32 != whole32);
+		splits++;
+	}
+
+	// Byte by byte, as from a receive interrupt
+	{
+		uint16_t crc16 = CRC16_CCITT_INIT;
+		uint32_t crc32 = CRC32_INIT;
+
+		for (i = 0; i < TEST_BUFFER_SIZE; i++) {
+			crc16 = crc16_ccitt_byte(crc16, test_buffer[i]);
+			crc32 = crc32_byte(crc32, test_buffer[i]);
+		}
+		mismatches += (crc16 != whole16) + (crc32 != whole32);
+		splits++;
+	}
+
+	printf("test=split bytes=%u splits=%u crc16=0x%04x crc32=0x%08lx"
+			" mismatches=%u result=%s\n", TEST_BUFFER_SIZE, splits,
+			whole16, (unsigned long)crc32_finalize(whole32), mismatches,
+			(mismatches == 0) ? "pass" : "fail");
+
+	return mismatches == 0;
+}
+
+//! Check that both CRC-32 tables give the same CRC
+static bool test_variants(void)
+{
+	static const uint32_t start[] = {
+		0x00000000UL, 0xffffffffUL, 0x12345678UL, 0xedb88320UL, 0x80000001UL
+	};
+	uint16_t mismatches = 0;
+	uint16_t checks = 0;
+	uint8_t s;
+	uint16_t data;
+
+	for (s = 0; s < sizeof(start) / sizeof(start[0]); s++) {
+		for (data = 0; data < 256; data++) {
+			mismatches += crc32_byte(start[s], data)
+					!= small_crc32_byte(start[s], data);
+			checks++;
+		}
+	}
+	mismatches += crc32_update(CRC32_INIT, test_buffer, TEST_BUFFER_SIZE)
+			!= small_crc32_update(CRC32_INIT, test_buffer,
+					TEST_BUFFER_SIZE);
+	checks++;
+
+	printf("test=variants checks=%u mismatches=%u result=%s\n", checks,
+			mismatches, (mismatches == 0) ? "pass" : "fail");
+
+	return mismatches == 0;
+}
+
+//! Check the flash and EEPROM functions against the SRAM functions
+static bool test_memories(void)
+{
+	uint16_t sram16;
+	uint32_t sram32;
+	uint16_t flash16;
+	uint32_t flash32;
+	uint16_t eeprom16;
+	uint32_t eeprom32;
+	bool success;
+
+	memcpy(&test_flash[TEST_MEMORY_ADDRESS], test_buffer, TEST_BUFFER_SIZE);
+	memcpy(&test_eeprom[TEST_MEMORY_ADDRESS], test_buffer, TEST_BUFFER_SIZE);
+
+	sram16 = crc16_ccitt_update(CRC16_CCITT_INIT, test_buffer,
+			TEST_BUFFER_SIZE);
+	sram32 = crc32_update(CRC32_INIT, test_buffer, TEST_BUFFER_SIZE);
+	flash16 = crc16_ccitt_update_flash(CRC16_CCITT_INIT,
+			TEST_MEMORY_ADDRESS, TEST_BUFFER_SIZE);
+	flash32 = crc32_update_flash(CRC32_INIT, TEST_MEMORY_ADDRESS,
+			TEST_BUFFER_SIZE);
+	eeprom16 = crc16_ccitt_update_eeprom(CRC16_CCITT_INIT,
+			TEST_MEMORY_ADDRESS, TEST_BUFFER_SIZE);
+	eeprom32 = crc32_update_eeprom(CRC32_INIT, TEST_MEMORY_ADDRESS,
+			TEST_BUFFER_SIZE);
+	success = (flash16 == sram16) && (eeprom16 == sram16)
+			&& (flash32 == sram32) && (eeprom32 == sram32);
+
+	printf("test=memories address=%u bytes=%u flash=%s eeprom=%s"
+			" result=%s\n", TEST_MEMORY_ADDRESS, TEST_BUFFER_SIZE,
+			((flash16 == sram16) && (flash32 == sram32)) ? "ok" : "fail",
+			((eeprom16 == sram16) && (eeprom32 == sram32)) ? "ok" : "fail",
+			success ? "pass" : "fail");
+
+	return success;
+}
+
+//! Report the host cycles per byte of each variant
+static void test_speed(void)
+{
+	static uint8_t data[TEST_SPEED_SIZE];
+	uint64_t cycles[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+	uint16_t run;
+	uint8_t v;
+
+	memset(data, 0x5a, sizeof(data));
+
+	// The fastest run of each variant, to leave out interruptions
+	for (run = 0; run < TEST_SPEED_RUNS; run++) {
+		for (v = 0; v < 3; v++) {
+			uint64_t start = __rdtsc();
+			uint64_t elapsed;
+
+			if (v == 0) {
+				test_sink = crc16_ccitt_update(CRC16_CCITT_INIT, data,
+						sizeof(data));
+			} else if (v == 1) {
+				test_sink = crc32_update(CRC32_INIT, data, sizeof(data));
+			} else {
+				test_sink = small_crc32_update(CRC32_INIT, data,
+						sizeof(data));
+			}
+			elapsed = __rdtsc() - start;
+			if (elapsed < cycles[v]) {
+				cycles[v] = elapsed;
+			}
+		}
+	}
+
+	printf("test=speed bytes=%u crc16_cycles_per_byte=%.2f"
+			" crc32_table_cycles_per_byte=%.2f"
+			" crc32_small_table_cycles_per_byte=%.2f\n", TEST_SPEED_SIZE,
+			(double)cycles[0] / TEST_SPEED_SIZE,
+			(double)cycles[1] / TEST_SPEED_SIZE,
+			(double)cycles[2] / TEST_SPEED_SIZE);
+}
+
+int main(void)
+{
+	bool success = true;
+
+	test_fill();
+
+	success &= test_check();
+	success &= test_split();
+	success &= test_variants();
+	success &= test_memories();
+	test_speed();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file
+ *
+ * \brief Host memory model interface of the NVM driver for the CRC test
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef HOST_NVM_H
+#define HOST_NVM_H
+
+#include <compiler.h>
+
+/*
+ * This header replaces drivers/nvm/nvm.h when the CRC service is built for
+ * the host. The flash and EEPROM read functions are implemented by the
+ * memory model of crc_check.c. The CRC commands of the NVM controller are
+ * not modelled.
+ */
+
+//! EEPROM page size in bytes
+#define EEPROM_PAGE_SIZE    32
+
+//! NVM commands used by the CRC service
+typedef enum NVM_CMD_enum {
+	NVM_CMD_APP_CRC_gc = 0x38,
+	NVM_CMD_BOOT_CRC_gc = 0x39,
+	NVM_CMD_FLASH_RANGE_CRC_gc = 0x3a,
+} NVM_CMD_t;
+
+//! NVM controller registers used by the CRC service
+struct host_nvm {
+	//! Address registers
+	volatile uint8_t ADDR0, ADDR1, ADDR2;
+	//! Data registers
+	volatile uint8_t DATA0, DATA1, DATA2;
+};
+
+extern struct host_nvm host_nvm;
+
+#define NVM    host_nvm
+
+typedef uint32_t flash_addr_t;
+
+uint8_t nvm_flash_read_byte(flash_addr_t addr);
+uint8_t nvm_eeprom_read_byte(uint8_t page_addr, uint8_t byte_addr);
+void nvm_issue_command(NVM_CMD_t nvm_command);
+void nvm_wait_until_ready(void);
+
+#endif /* HOST_NVM_H */
@@ -0,0 +1,132 @@
+/**
+ * \file
+ *
+ * \brief Dual-image firmware update example
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <compiler.h>
+#include <board.h>
+#include <led.h>
+#include <fwupdate.h>
+
+/*! Byte the host sends to request an update. */
+#define UPDATE_REQUEST    'U'
+
+void board_init(void);
+
+/*! Wait for and return one byte from the host. */
+static uint8_t usart_getchar(void)
+{
+	while (!(USARTC0.STATUS & USART_RXCIF_bm)) {
+	}
+	return USARTC0.DATA;
+}
+
+/*! Send one byte to the host. */
+static void usart_putchar(uint8_t data)
+{
+	while (!(USARTC0.STATUS & USART_DREIF_bm)) {
+	}
+	USARTC0.DATA = data;
+}
+
+/*! Receive the image header, start the update and return its status.
+ *
+ *  The header is the image size as four bytes and the image CRC as two
+ *  bytes, least significant byte first.
+ */
+static status_code_t start_update(void)
+{
+	uint32_t size = 0;
+	uint16_t crc = 0;
+	uint8_t i;
+	status_code_t status;
+
+	for (i = 0; i < 32; i += 8) {
+		size |= (uint32_t)usart_getchar() << i;
+	}
+	crc = usart_getchar();
+	crc |= (uint16_t)usart_getchar() << 8;
+
+	status = fwupdate_begin(&USARTC0, DMA_CH_TRIGSRC_USARTC0_RXC_gc,
+			size, crc);
+	if (status != STATUS_OK) {
+		usart_putchar(FWUPDATE_NAK);
+		return status;
+	}
+
+	return ERR_BUSY;
+}
+
+int main(void)
+{
+	status_code_t status = ERR_FLUSHED;
+	uint16_t blink = 0;
+
+	board_init();
+
+	/* USARTC0 is connected to the USB bridge on the Xplain board.
+	 * 19200 baud, 8N1 at the 2 MHz reset clock.
+	 */
+	USARTC0.BAUDCTRLA = 12;
+	USARTC0.BAUDCTRLB = 0;
+	USARTC0.CTRLA = 0;
+	USARTC0.CTRLC = USART_CMODE_ASYNCHRONOUS_gc | USART_PMODE_DISABLED_gc
+			| USART_CHSIZE_8BIT_gc;
+	USARTC0.CTRLB = USART_RXEN_bm | USART_TXEN_bm;
+
+	/* The application keeps running while the image is received. LED0
+	 * blinks all the time, and only stops while a page is programmed.
+	 */
+	while (true) {
+		if (++blink == 0) {
+			LED_Toggle(LED0_GPIO);
+		}
+
+		if (status == ERR_BUSY) {
+			status = fwupdate_task();
+			if (status == STATUS_OK) {
+				/* Resets the device. The boot section stub
+				 * installs the new image and starts it.
+				 */
+				fwupdate_install();
+			}
+		} else if (USARTC0.STATUS & USART_RXCIF_bm) {
+			if (USARTC0.DATA == UPDATE_REQUEST) {
+				LED_On(LED1_GPIO);
+				status = start_update();
+			}
+		}
+	}
+}
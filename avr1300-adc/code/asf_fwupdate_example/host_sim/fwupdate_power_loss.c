@@ -0,0 +1,429 @@
+/**
+ * \file
+ *
+ * \brief Power loss test of the firmware update boot section stub on the host
+ *
+ * This program runs fwupdate_boot_main() against a model of the application
+ * section flash and its page buffer, and cuts the power at every page
+ * operation of the copy and of the trailer erase. A page operation that is
+ * cut leaves each byte of the page at its old value, erased or written. The
+ * stub is then started again, as after the next reset, and must finish the
+ * copy, start the new image and leave no valid trailer. A second power loss
+ * during the resumed copy is also tested, and a page that no longer programs
+ * must make the stub hold instead of starting a partly copied image.
+ *
+ * Each line holds space separated key=value pairs, and the program exits
+ * with a non-zero status if a check fails.
+ *
+ * Build and run from the asf_fwupdate_example directory:
+ * \code
+ * gcc -std=gnu99 -O2 -Ihost_sim -I. -I../asf/xmega/utils \
+ *     -I../asf/xmega/services/fwupdate host_sim/fwupdate_power_loss.c \
+ *     ../asf/xmega/services/fwupdate/fwupdate_boot.c -o fwupdate_power_loss
+ * ./fwupdate_power_loss
+ * \endcode
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <compiler.h>
+#include <nvm.h>
+#include <fwupdate.h>
+
+//! Size of the new image, the last page partly used
+#define TEST_IMAGE_SIZE         (40UL * FLASH_PAGE_SIZE + 100)
+
+//! Size of the old image
+#define TEST_OLD_IMAGE_SIZE     (30UL * FLASH_PAGE_SIZE)
+
+//! Pages of the new image that are the same as in the old image
+#define TEST_SAME_PAGE_A        3
+#define TEST_SAME_PAGE_B        17
+
+//! Page of the active image that does not program in the hold test
+#define TEST_STUCK_PAGE         12
+
+//! Result of a run of the stub
+enum test_boot_result {
+	//! The stub returned, which it must never do
+	TEST_BOOT_RETURNED,
+	//! The stub started the application
+	TEST_BOOT_STARTED,
+	//! The stub holds until the next reset
+	TEST_BOOT_HELD,
+	//! The power was cut during a page operation
+	TEST_BOOT_POWER_LOSS,
+};
+
+//! NVM controller registers, never busy as page operations complete at once
+struct host_nvm host_nvm;
+
+//! Application section flash
+static uint8_t test_flash[APP_SECTION_SIZE];
+
+//! Flash page buffer
+static uint16_t test_page_buffer[FLASH_PAGE_SIZE / 2];
+
+//! Contents of the new image
+static uint8_t test_image[TEST_IMAGE_SIZE];
+
+//! Reset entry, left by the application start, the hold and power losses
+static jmp_buf test_reset;
+
+//! Page operations since the last reset
+static uint32_t test_spm_count;
+
+//! Page operation cut by a power loss, 0 for none
+static uint32_t test_power_loss_at;
+
+//! Byte address of a page that does not program, UINT32_MAX for none
+static flash_addr_t test_stuck_page = UINT32_MAX;
+
+//! Page operations outside the active image and the trailer page
+static uint32_t test_bad_spm;
+
+//! State of the pseudo-random sequence
+static uint32_t test_random_seed = 1;
+
+/**
+ * \brief Next value of the pseudo-random sequence, 0 to \a range - 1
+ */
+static uint32_t test_random(uint32_t range)
+{
+	test_random_seed = test_random_seed * 1103515245UL + 12345;
+	return (test_random_seed >> 16) % range;
+}
+
+uint8_t fwupdate_host_read_byte(flash_addr_t address)
+{
+	return test_flash[address];
+}
+
+uint16_t fwupdate_host_read_word(flash_addr_t address)
+{
+	return test_flash[address] | ((uint16_t)test_flash[address + 1] << 8);
+}
+
+void fwupdate_host_start_app(void)
+{
+	longjmp(test_reset, TEST_BOOT_STARTED);
+}
+
+void fwupdate_host_hold(void)
+{
+	longjmp(test_reset, TEST_BOOT_HELD);
+}
+
+void nvm_flash_flush_buffer(void)
+{
+	memset(test_page_buffer, 0xff, sizeof(test_page_buffer));
+}
+
+void nvm_flash_load_word_to_buffer(uint32_t word_addr, uint16_t data)
+{
+	test_page_buffer[(word_addr % FLASH_PAGE_SIZE) / 2] = data;
+}
+
+/**
+ * \brief Run a page operation on the flash model
+ *
+ * An erase and write programs the page buffer and then clears it. A page
+ * operation cut by a power loss leaves each byte at its old value, erased
+ * or written, and does not return.
+ */
+void nvm_common_spm(uint32_t addr, uint8_t nvm_cmd)
+{
+	flash_addr_t start = addr & ~((flash_addr_t)FLASH_PAGE_SIZE - 1);
+	uint8_t *page = &test_flash[start];
+	uint8_t result[FLASH_PAGE_SIZE];
+	uint16_t i;
+
+	if ((start >= CONFIG_FWUPDATE_STAGING_START)
+			&& (start != FWUPDATE_TRAILER_ADDRESS)) {
+		test_bad_spm++;
+	}
+
+	if (nvm_cmd == NVM_CMD_ERASE_WRITE_APP_PAGE_gc) {
+		for (i = 0; i < FLASH_PAGE_SIZE; i += 2) {
+			result[i] = LSB(test_page_buffer[i / 2]);
+			result[i + 1] = MSB(test_page_buffer[i / 2]);
+		}
+		nvm_flash_flush_buffer();
+	} else if (nvm_cmd == NVM_CMD_ERASE_APP_PAGE_gc) {
+		memset(result, 0xff, sizeof(result));
+	} else {
+		test_bad_spm++;
+		return;
+	}
+
+	if (start == test_stuck_page) {
+		// The page keeps its old contents
+		memcpy(result, page, sizeof(result));
+	}
+
+	test_spm_count++;
+	if (test_spm_count == test_power_loss_at) {
+		for (i = 0; i < FLASH_PAGE_SIZE; i++) {
+			switch (test_random(3)) {
+			case 0:
+				break;
+			case 1:
+				page[i] = 0xff;
+				break;
+			default:
+				page[i] = result[i];
+				break;
+			}
+		}
+		longjmp(test_reset, TEST_BOOT_POWER_LOSS);
+	}
+
+	memcpy(page, result, sizeof(result));
+}
+
+/**
+ * \brief Reset the device and run the stub
+ *
+ * \param power_loss_at Page operation to cut, 0 for none
+ * \param spm_count Set to the number of page operations started, the cut
+ *                  one included
+ */
+static enum test_boot_result test_boot(uint32_t power_loss_at,
+		uint32_t *spm_count)
+{
+	volatile enum test_boot_result result = TEST_BOOT_RETURNED;
+	int jump;
+
+	// The page buffer does not keep its contents over a reset
+	nvm_flash_flush_buffer();
+	test_spm_count = 0;
+	test_power_loss_at = power_loss_at;
+
+	jump = setjmp(test_reset);
+	if (jump == 0) {
+		fwupdate_boot_main();
+	} else {
+		result = (enum test_boot_result)jump;
+	}
+
+	*spm_count = test_spm_count;
+	return result;
+}
+
+/**
+ * \brief Write the old image, and the new image with its trailer
+ */
+static void test_setup(void)
+{
+	struct fwupdate_trailer trailer;
+	uint32_t i;
+
+	memset(test_flash, 0xff, sizeof(test_flash));
+	for (i = 0; i < TEST_OLD_IMAGE_SIZE; i++) {
+		test_flash[i] = test_random(256);
+	}
+	for (i = 0; i < TEST_IMAGE_SIZE; i++) {
+		test_image[i] = test_random(256);
+	}
+	memcpy(&test_image[TEST_SAME_PAGE_A * FLASH_PAGE_SIZE],
+			&test_flash[TEST_SAME_PAGE_A * FLASH_PAGE_SIZE], FLASH_PAGE_SIZE);
+	memcpy(&test_image[TEST_SAME_PAGE_B * FLASH_PAGE_SIZE],
+			&test_flash[TEST_SAME_PAGE_B * FLASH_PAGE_SIZE], FLASH_PAGE_SIZE);
+	memcpy(&test_flash[CONFIG_FWUPDATE_STAGING_START], test_image,
+			TEST_IMAGE_SIZE);
+
+	trailer.magic = FWUPDATE_TRAILER_MAGIC;
+	trailer.size = TEST_IMAGE_SIZE;
+	trailer.image_crc = fwupdate_crc_update(0xffff, test_image,
+			TEST_IMAGE_SIZE);
+	trailer.trailer_crc = fwupdate_crc_update(0xffff, (uint8_t *)&trailer,
+			offsetof(struct fwupdate_trailer, trailer_crc));
+	memcpy(&test_flash[FWUPDATE_TRAILER_ADDRESS], &trailer, sizeof(trailer));
+}
+
+/**
+ * \brief Check that the new image was installed and started
+ */
+static bool test_installed(enum test_boot_result result)
+{
+	struct fwupdate_trailer trailer;
+
+	return (result == TEST_BOOT_STARTED)
+			&& !memcmp(test_flash, test_image, TEST_IMAGE_SIZE)
+			&& !fwupdate_read_trailer(&trailer);
+}
+
+/**
+ * \brief Check the CRC against the CRC-16-CCITT check value
+ */
+static bool test_crc(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint16_t crc = fwupdate_crc_update(0xffff, check, sizeof(check) - 1);
+	bool success = (crc == 0x29b1);
+
+	printf("test=crc check=0x%04x result=%s\n", crc,
+			success ? "pass" : "fail");
+	return success;
+}
+
+/**
+ * \brief Install without a power loss
+ *
+ * \param spm_count Set to the number of page operations of the install
+ */
+static bool test_clean(uint32_t *spm_count)
+{
+	uint32_t pages = (TEST_IMAGE_SIZE + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+	enum test_boot_result result;
+	uint32_t again;
+	bool success;
+
+	test_setup();
+	result = test_boot(0, spm_count);
+	success = test_installed(result);
+
+	// The same pages are skipped, and the trailer page is erased
+	success &= (*spm_count == pages - 2 + 1);
+
+	// With no image pending, the stub only starts the application
+	result = test_boot(0, &again);
+	success &= (result == TEST_BOOT_STARTED) && (again == 0);
+
+	printf("test=clean pages=%lu spm=%lu spm_after=%lu result=%s\n",
+			(unsigned long)pages, (unsigned long)*spm_count,
+			(unsigned long)again, success ? "pass" : "fail");
+	return success;
+}
+
+/**
+ * \brief Cut the power at every page operation, once or twice
+ *
+ * \param spm_total Page operations of an install without a power loss
+ * \param losses Number of power losses, 1 or 2
+ */
+static bool test_power_loss(uint32_t spm_total, uint8_t losses)
+{
+	enum test_boot_result result;
+	uint32_t failures = 0;
+	uint32_t resumed_max = 0;
+	uint32_t at;
+	uint32_t spm;
+	uint32_t second;
+
+	for (at = 1; at <= spm_total; at++) {
+		bool success;
+
+		test_setup();
+		result = test_boot(at, &spm);
+		success = (result == TEST_BOOT_POWER_LOSS) && (spm == at);
+
+		if (losses == 2) {
+			// Cut a page operation of the resumed copy, if any
+			second = 1 + test_random(spm_total - at + 1);
+			result = test_boot(second, &spm);
+			success &= (result == TEST_BOOT_POWER_LOSS)
+					|| test_installed(result);
+		}
+
+		// The pages already copied are skipped
+		result = test_boot(0, &spm);
+		success &= test_installed(result) && (spm <= spm_total - at + 1);
+		if (spm > resumed_max) {
+			resumed_max = spm;
+		}
+
+		if (!success) {
+			failures++;
+			printf("test=power_loss losses=%u at=%lu result=fail\n", losses,
+					(unsigned long)at);
+		}
+	}
+
+	printf("test=power_loss losses=%u cuts=%lu resumed_spm_max=%lu "
+			"failures=%lu result=%s\n", losses, (unsigned long)spm_total,
+			(unsigned long)resumed_max, (unsigned long)failures,
+			(failures == 0) ? "pass" : "fail");
+	return failures == 0;
+}
+
+/**
+ * \brief A page that does not program makes the stub hold
+ *
+ * The copy is attempted three times, the trailer is kept and the image is
+ * not started. Once the page programs again, the next reset installs the
+ * image.
+ */
+static bool test_hold(void)
+{
+	struct fwupdate_trailer trailer;
+	enum test_boot_result held;
+	enum test_boot_result result;
+	uint32_t spm;
+	uint32_t spm_after;
+	bool success;
+
+	test_setup();
+	test_stuck_page = (flash_addr_t)TEST_STUCK_PAGE * FLASH_PAGE_SIZE;
+	held = test_boot(0, &spm);
+	success = (held == TEST_BOOT_HELD) && fwupdate_read_trailer(&trailer);
+
+	test_stuck_page = UINT32_MAX;
+	result = test_boot(0, &spm_after);
+	success &= test_installed(result) && (spm_after == 1 + 1);
+
+	printf("test=hold held=%s spm=%lu spm_after_repair=%lu result=%s\n",
+			(held == TEST_BOOT_HELD) ? "yes" : "no", (unsigned long)spm,
+			(unsigned long)spm_after, success ? "pass" : "fail");
+	return success;
+}
+
+int main(void)
+{
+	uint32_t spm_total;
+	bool success = true;
+
+	success &= test_crc();
+	success &= test_clean(&spm_total);
+	success &= test_power_loss(spm_total, 1);
+	success &= test_power_loss(spm_total, 2);
+	success &= test_hold();
+
+	success &= (test_bad_spm == 0);
+	printf("summary bad_spm=%lu result=%s\n", (unsigned long)test_bad_spm,
+			success ? "pass" : "fail");
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+/**
+ * \file
+ *
+ * \brief Host flash model interface of the NVM driver for the fwupdate test
+ *
+ * Copyright (C) 2010 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef HOST_NVM_H
+#define HOST_NVM_H
+
+#include <compiler.h>
+
+/*
+ * This header replaces drivers/nvm/nvm.h when the boot section stub of the
+ * firmware update service is built for the host. The functions are
+ * implemented by the flash model of fwupdate_power_loss.c, for the flash
+ * layout of the ATxmega128A1.
+ */
+
+//! Flash page size in bytes
+#define FLASH_PAGE_SIZE                    (512)
+
+//! Size of the application section in bytes
+#define APP_SECTION_SIZE                   0x20000UL
+
+//! NVM controller busy flag
+#define NVM_NVMBUSY_bm                     0x80
+
+//! Erase and write application section page
+#define NVM_CMD_ERASE_WRITE_APP_PAGE_gc    0x25
+
+//! Erase application section page
+#define NVM_CMD_ERASE_APP_PAGE_gc          0x22
+
+//! NVM controller registers used by the stub
+struct host_nvm {
+	//! Status register
+	volatile uint8_t STATUS;
+};
+
+extern struct host_nvm host_nvm;
+
+#define NVM    host_nvm
+
+typedef uint32_t flash_addr_t;
+
+void nvm_flash_flush_buffer(void);
+void nvm_flash_load_word_to_buffer(uint32_t word_addr, uint16_t data);
+void nvm_common_spm(uint32_t addr, uint8_t nvm_cmd);
+
+uint8_t fwupdate_host_read_byte(flash_addr_t address);
+uint16_t fwupdate_host_read_word(flash_addr_t address);
+void fwupdate_host_start_app(void);
+void fwupdate_host_hold(void);
+
+#endif /* HOST_NVM_H */
@@ -0,0 +1,342 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Analog Comparator event service source file.
+ *
+ *      This file contains the function implementations of the Analog Comparator
+ *      event service.
+ *
+ * \par Application note:
+ *      AVR1302: Using the XMEGA Analog Comparator
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "ac_event.h"
+
+
+/*! \brief Initialize the Analog Comparator event service.
+ *
+ *  This function routes the comparator output to an event channel and uses
+ *  the event for input capture on channel A of the Timer/Counter. A DMA
+ *  channel triggered by the capture copies every timestamp into the
+ *  capture ring buffer, so no interrupt is needed per event.
+ *
+ *  The comparator interrupt mode is set to both edges with the interrupt
+ *  disabled, so every output change generates an event. The comparator
+ *  must be configured (MUX, scaler) and enabled by the application.
+ *
+ *  \param service        Pointer to the event service.
+ *  \param ac             Pointer to Analog Comparator module.
+ *  \param comp           Which submodule, 0 or 1.
+ *  \param acEventSource  Event source of the comparator output, e.g.
+ *                        EVSYS_CHMUX_ACA_CH0_gc.
+ *  \param eventChannel   Event channel to use, 0 to 7.
+ *  \param tc             Timer/Counter used for timestamps.
+ *  \param clockSelect    Timer/Counter clock, setting the timestamp resolution.
+ *  \param dmaChannel     DMA channel to use.
+ *  \param dmaTrigger     Capture A trigger of the Timer/Counter, e.g.
+ *                        DMA_CH_TRIGSRC_TCC0_CCA_gc.
+ *  \param minInterval    Events closer than this number of ticks to the
+ *                        previous valid event are treated as chatter.
+ */
+void ACEV_Init( ACEV_Service_t * service,
+                AC_t * ac,
+                AC_COMP_t comp,
+                EVSYS_CHMUX_t acEventSource,
+                uint8_t eventChannel,
+                TC0_t * tc,
+                TC_CLKSEL_t clockSelect,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dmaTrigger,
+                uint16_t minInterval )
+{
+	uint32_t srcAddr = (uint32_t) (uintptr_t) &tc->CCA;
+	uint32_t destAddr = (uint32_t) (uintptr_t) service->captures;
+
+	service->ac = ac;
+	service->comp = comp;
+	service->tc = tc;
+	service->dmaChannel = dmaChannel;
+	service->readIndex = 0;
+	service->lastEventValid = false;
+	service->minInterval = minInterval;
+	service->autoHysteresis = false;
+	service->hysteresis = AC_HYSMODE_NO_gc;
+	ACEV_ClearStatistics( service );
+
+	/* Events on both output edges, no interrupt. */
+	AC_ConfigInterrupt( ac, comp, AC_INTMODE_BOTHEDGES_gc, AC_INTLVL_OFF_gc );
+	AC_ConfigHysteresis( ac, comp, service->hysteresis );
+
+	/* Route the comparator output to the event channel. */
+	( &EVSYS.CH0MUX )[eventChannel] = acEventSource;
+
+	/* Copy every capture into the ring buffer, wrapping at the end. */
+	DMA.CTRL |= DMA_ENABLE_bm;
+	dmaChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	dmaChannel->CTRLA |= DMA_CH_RESET_bm;
+
+	dmaChannel->SRCADDR0 = ( srcAddr >> 0*8 ) & 0xFF;
+	dmaChannel->SRCADDR1 = ( srcAddr >> 1*8 ) & 0xFF;
+	dmaChannel->SRCADDR2 = ( srcAddr >> 2*8 ) & 0xFF;
+
+	dmaChannel->DESTADDR0 = ( destAddr >> 0*8 ) & 0xFF;
+	dmaChannel->DESTADDR1 = ( destAddr >> 1*8 ) & 0xFF;
+	dmaChannel->DESTADDR2 = ( destAddr >> 2*8 ) & 0xFF;
+
+	dmaChannel->ADDRCTRL = DMA_CH_SRCRELOAD_BURST_gc | DMA_CH_SRCDIR_INC_gc |
+	                       DMA_CH_DESTRELOAD_BLOCK_gc | DMA_CH_DESTDIR_INC_gc;
+	dmaChannel->TRFCNT = sizeof( service->captures );
+	dmaChannel->REPCNT = 0;
+	dmaChannel->TRIGSRC = dmaTrigger;
+	dmaChannel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm | DMA_CH_SINGLE_bm |
+	                    DMA_CH_BURSTLEN_2BYTE_gc;
+
+	/* Free-running timer capturing on channel A. */
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->PER = 0xFFFF;
+	tc->CTRLB = TC0_CCAEN_bm | TC_WGMODE_NORMAL_gc;
+	tc->CTRLD = TC_EVACT_CAPT_gc | ( TC_EVSEL_CH0_gc + eventChannel );
+	tc->CTRLA = clockSelect;
+}
+
+
+/*! \brief Connect a comparator output to the AWeX fault detection.
+ *
+ *  The comparator output is routed to an event channel that is added to
+ *  the fault detection event mask of the AWeX. When the comparator output
+ *  changes as selected by its interrupt mode, the AWeX performs the fault
+ *  action in hardware, without any CPU involvement. Use a different
+ *  comparator (or event channel) than the one used for timestamps if both
+ *  are needed.
+ *
+ *  \param acEventSource  Event source of the comparator output, e.g.
+ *                        EVSYS_CHMUX_ACA_CH1_gc.
+ *  \param eventChannel   Event channel to use, 0 to 3.
+ *  \param awex           The AWeX module to shut down.
+ *  \param faultAction    Action to perform on a fault condition.
+ */
+void ACEV_ConnectFault( EVSYS_CHMUX_t acEventSource,
+                        uint8_t eventChannel,
+                        AWEX_t * awex,
+                        AWEX_FDACT_t faultAction )
+{
+	( &EVSYS.CH0MUX )[eventChannel] = acEventSource;
+
+	AWEX_ConfigureFaultDetection( awex, faultAction,
+	                              awex->FDEVMASK | ( 1 << eventChannel ) );
+}
+
+
+/*! \brief Enable or disable automatic hysteresis tuning.
+ *
+ *  With tuning enabled, every chattering event increases the hysteresis
+ *  one step, and the hysteresis is reduced one step again after
+ *  ACEV_HYSTERESIS_RELAX_EVENTS clean events. This keeps the hysteresis,
+ *  and thereby the timing error it causes, as small as the noise allows.
+ *
+ *  \param service  Pointer to the event service.
+ *  \param enable   True to enable tuning.
+ */
+void ACEV_EnableAutoHysteresis( ACEV_Service_t * service, bool enable )
+{
+	service->autoHysteresis = enable;
+	service->cleanEvents = 0;
+}
+
+
+/*! \brief Update the hysteresis setting from the chatter statistics.
+ *
+ *  \param service  Pointer to the event service.
+ *  \param chatter  True if the last event was chatter.
+ */
+static void ACEV_TuneHysteresis( ACEV_Service_t * service, bool chatter )
+{
+	AC_HYSMODE_t hysteresis = service->hysteresis;
+
+	if(chatter){
+		service->cleanEvents = 0;
+		if(hysteresis == AC_HYSMODE_NO_gc){
+			hysteresis = AC_HYSMODE_SMALL_gc;
+		}else{
+			hysteresis = AC_HYSMODE_LARGE_gc;
+		}
+	}else if(++service->cleanEvents >= ACEV_HYSTERESIS_RELAX_EVENTS){
+		service->cleanEvents = 0;
+		if(hysteresis == AC_HYSMODE_LARGE_gc){
+			hysteresis = AC_HYSMODE_SMALL_gc;
+		}else{
+			hysteresis = AC_HYSMODE_NO_gc;
+		}
+	}
+
+	if(hysteresis != service->hysteresis){
+		service->hysteresis = hysteresis;
+		AC_ConfigHysteresis( service->ac, service->comp, hysteresis );
+	}
+}
+
+
+/*! \brief Get the next comparator event.
+ *
+ *  This function processes the captures copied by DMA since the last call.
+ *  Captures closer than minInterval to the previous valid event are
+ *  counted as chatter and dropped. The interval statistics are updated for
+ *  every valid event.
+ *
+ *  The function must be called at least once per ACEV_CAPTURE_BUFFER_SIZE
+ *  events, and more often than the timer period, for the intervals to be
+ *  correct.
+ *
+ *  \param service    Pointer to the event service.
+ *  \param timestamp  Timestamp of the event, valid if true is returned.
+ *
+ *  \return  True if a valid event was found.
+ */
+bool ACEV_GetEvent( ACEV_Service_t * service, uint16_t * timestamp )
+{
+	uint16_t bytesLeft;
+	uint8_t writeIndex;
+
+	AVR_ENTER_CRITICAL_REGION( );
+	bytesLeft = service->dmaChannel->TRFCNT;
+	AVR_LEAVE_CRITICAL_REGION( );
+	writeIndex = (uint8_t) ( ( sizeof( service->captures ) - bytesLeft ) / 2 ) &
+	             ( ACEV_CAPTURE_BUFFER_SIZE - 1 );
+
+	while(service->readIndex != writeIndex){
+		uint16_t capture = service->captures[service->readIndex];
+		uint16_t interval = capture - service->lastEvent;
+
+		service->readIndex = ( service->readIndex + 1 ) & ( ACEV_CAPTURE_BUFFER_SIZE - 1 );
+
+		if(service->lastEventValid && ( interval < service->minInterval )){
+			service->chatterCount++;
+			if(service->autoHysteresis){
+				ACEV_TuneHysteresis( service, true );
+			}
+			continue;
+		}
+
+		if(service->lastEventValid){
+			if(interval < service->intervalMin){
+				service->intervalMin = interval;
+			}
+			if(interval > service->intervalMax){
+				service->intervalMax = interval;
+			}
+		}
+		if(service->autoHysteresis){
+			ACEV_TuneHysteresis( service, false );
+		}
+
+		service->eventCount++;
+		service->lastEvent = capture;
+		service->lastEventValid = true;
+		*timestamp = capture;
+		return true;
+	}
+
+	return false;
+}
+
+
+/*! \brief Clear the event statistics.
+ *
+ *  \param service  Pointer to the event service.
+ */
+void ACEV_ClearStatistics( ACEV_Service_t * service )
+{
+	service->cleanEvents = 0;
+	service->eventCount = 0;
+	service->chatterCount = 0;
+	service->intervalMin = 0xFFFF;
+	service->intervalMax = 0;
+}
+
+
+/*! \brief Calibrate the voltage scaler threshold above the noise floor.
+ *
+ *  The comparator must have the signal on the positive input and the
+ *  voltage scaler on the negative input, and the signal must be at its
+ *  quiescent level (e.g. no load current). The scaler is stepped up from
+ *  zero, and at each step the comparator output is sampled
+ *  ACEV_CALIBRATION_SAMPLES times. The first step where the output never
+ *  goes high is just above the noise peak. The threshold is set margin
+ *  steps above this level.
+ *
+ *  \param ac      Pointer to Analog Comparator module.
+ *  \param comp    Which submodule, 0 or 1.
+ *  \param margin  Number of 1/64 VCC steps to add above the noise peak.
+ *
+ *  \return  The scale factor set, in number of 1/64ths of VCC.
+ */
+uint8_t ACEV_CalibrateScaler( AC_t * ac, AC_COMP_t comp, uint8_t margin )
+{
+	uint8_t scaleFactor;
+
+	for(scaleFactor = 0; scaleFactor < 63; scaleFactor++){
+		uint16_t sample;
+		bool exceeded = false;
+
+		AC_ConfigVoltageScaler( ac, scaleFactor );
+
+		/* Let the scaler output settle. */
+		delay_us( 10 );
+
+		for(sample = 0; sample < ACEV_CALIBRATION_SAMPLES; sample++){
+			if(AC_GetComparatorState( ac, comp )){
+				exceeded = true;
+				break;
+			}
+		}
+
+		if(!exceeded){
+			break;
+		}
+	}
+
+	if(scaleFactor + margin > 63){
+		scaleFactor = 63;
+	}else{
+		scaleFactor += margin;
+	}
+	AC_ConfigVoltageScaler( ac, scaleFactor );
+
+	return scaleFactor;
+}
@@ -0,0 +1,134 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Analog Comparator event service header file.
+ *
+ *      This file contains the function prototypes, macros and type definitions
+ *      for the Analog Comparator event service.
+ *
+ *      The service routes comparator outputs through the event system, so that
+ *      the reaction to a zero crossing or an over-current condition happens in
+ *      hardware: a Timer/Counter input capture timestamps the event, and the
+ *      AWeX fault detection can shut down the outputs within a few peripheral
+ *      clock cycles. The captures are copied into a ring buffer by DMA, and
+ *      software consumes them with ACEV_GetEvent(), which also filters comparator
+ *      chatter and tunes the hysteresis from the measured noise.
+ *
+ * \par Application note:
+ *      AVR1302: Using the XMEGA Analog Comparator
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef AC_EVENT_H
+#define AC_EVENT_H
+
+#include "avr_compiler.h"
+#include "ac_driver.h"
+#include "awex_driver.h"
+
+/*! Number of captures in the DMA ring buffer. Must be a power of two. */
+#define ACEV_CAPTURE_BUFFER_SIZE     32
+
+/*! Number of consecutive clean events before the hysteresis is reduced. */
+#define ACEV_HYSTERESIS_RELAX_EVENTS 256
+
+/*! Number of comparator samples per voltage scaler step in
+ *  ACEV_CalibrateScaler().
+ */
+#define ACEV_CALIBRATION_SAMPLES     1000
+
+
+/*! \brief Analog Comparator event service instance. */
+typedef struct ACEV_Service_struct {
+	/*! The Analog Comparator module. */
+	AC_t * ac;
+	/*! The comparator generating the captured events. */
+	AC_COMP_t comp;
+	/*! Timer/Counter timestamping the events on capture channel A. */
+	TC0_t * tc;
+	/*! DMA channel copying the captures into the ring buffer. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! Capture ring buffer, written by DMA. */
+	uint16_t captures[ACEV_CAPTURE_BUFFER_SIZE];
+	/*! Next capture to process. */
+	uint8_t readIndex;
+	/*! Timestamp of the last valid event. */
+	uint16_t lastEvent;
+	/*! True if lastEvent holds a valid timestamp. */
+	bool lastEventValid;
+	/*! Events closer than this number of ticks to the previous one are chatter. */
+	uint16_t minInterval;
+	/*! True if the hysteresis is tuned automatically. */
+	bool autoHysteresis;
+	/*! Current hysteresis setting. */
+	AC_HYSMODE_t hysteresis;
+	/*! Valid events since the last hysteresis change. */
+	uint16_t cleanEvents;
+	/*! Number of valid events. */
+	uint16_t eventCount;
+	/*! Number of events rejected as chatter. */
+	uint16_t chatterCount;
+	/*! Shortest interval between valid events, in ticks. */
+	uint16_t intervalMin;
+	/*! Longest interval between valid events, in ticks. */
+	uint16_t intervalMax;
+} ACEV_Service_t;
+
+
+/* Prototyping of functions. */
+
+void ACEV_Init( ACEV_Service_t * service,
+                AC_t * ac,
+                AC_COMP_t comp,
+                EVSYS_CHMUX_t acEventSource,
+                uint8_t eventChannel,
+                TC0_t * tc,
+                TC_CLKSEL_t clockSelect,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dmaTrigger,
+                uint16_t minInterval );
+void ACEV_ConnectFault( EVSYS_CHMUX_t acEventSource,
+                        uint8_t eventChannel,
+                        AWEX_t * awex,
+                        AWEX_FDACT_t faultAction );
+void ACEV_EnableAutoHysteresis( ACEV_Service_t * service, bool enable );
+bool ACEV_GetEvent( ACEV_Service_t * service, uint16_t * timestamp );
+void ACEV_ClearStatistics( ACEV_Service_t * service );
+uint8_t ACEV_CalibrateScaler( AC_t * ac, AC_COMP_t comp, uint8_t margin );
+
+#endif
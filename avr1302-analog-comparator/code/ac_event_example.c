@@ -0,0 +1,138 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Analog Comparator event service example source.
+ *
+ *      This file contains an example application that demonstrates the Analog
+ *      Comparator event service. Comparator 0 detects the zero crossings of a
+ *      signal on PA0, referenced to PA1, and the crossings are timestamped by
+ *      TCD0 input capture and copied to a ring buffer by DMA. Comparator 1
+ *      compares a current sense voltage on PA2 against the voltage scaler and
+ *      shuts down the PWM outputs of TCC0 through the AWeX fault detection, with
+ *      no CPU involvement.
+ *
+ *      The signal period is shown on PORTE, and PORTD shows the number of events
+ *      rejected as chatter.
+ *
+ * \par Application note:
+ *      AVR1302: Using the XMEGA Analog Comparator
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "avr_compiler.h"
+#include "ac_event.h"
+
+/* The Analog comparator used in the example. */
+#define AC ACA
+
+/* Event channels used for the zero crossings and the over-current fault. */
+#define ZERO_CROSS_EVENT_CHANNEL  0
+#define FAULT_EVENT_CHANNEL       1
+
+/* Voltage scaler steps above the quiescent current sense level. */
+#define OVERCURRENT_MARGIN        8
+
+/* Zero crossings closer than this many timer ticks are chatter. At 2 MHz
+ * with prescaler 8 this is 2 ms, below half the period of a 50 Hz signal.
+ */
+#define MIN_CROSSING_INTERVAL     500
+
+/* Event service instance. */
+ACEV_Service_t zeroCross;
+
+
+int main(void)
+{
+	uint16_t timestamp;
+	uint16_t lastTimestamp = 0;
+
+	/* Over-current comparator: current sense on PA2 against the scaler. */
+	AC_ConfigMUX(&AC, ANALOG_COMPARATOR1, AC_MUXPOS_PIN2_gc, AC_MUXNEG_SCALER_gc);
+	AC_Enable(&AC, ANALOG_COMPARATOR1, true);
+
+	/* Find the threshold with no load current, before the PWM starts. */
+	ACEV_CalibrateScaler(&AC, ANALOG_COMPARATOR1, OVERCURRENT_MARGIN);
+
+	/* Rising edge of the over-current comparator trips the AWeX. */
+	AC_ConfigInterrupt(&AC, ANALOG_COMPARATOR1, AC_INTMODE_RISING_gc, AC_INTLVL_OFF_gc);
+	ACEV_ConnectFault(EVSYS_CHMUX_ACA_CH1_gc, FAULT_EVENT_CHANNEL,
+	                  &AWEXC, AWEX_FDACT_CLEAROE_gc);
+
+	/* Complementary PWM on PC0/PC1 with dead time. */
+	PORTC.DIRSET = 0x03;
+	TCC0.PER = 1000;
+	TCC0.CCA = 500;
+	TCC0.CTRLB = TC0_CCAEN_bm | TC_WGMODE_SS_gc;
+	AWEX_SetDeadTimesSymmetricalUnbuffered(AWEXC, 8);
+	AWEX_EnableDeadTimeInsertion(&AWEXC, AWEX_DTICCAEN_bm);
+	AWEXC.OUTOVEN = 0x03;
+	TCC0.CTRLA = TC_CLKSEL_DIV1_gc;
+
+	/* Zero crossing comparator: signal on PA0 against PA1. */
+	AC_ConfigMUX(&AC, ANALOG_COMPARATOR0, AC_MUXPOS_PIN0_gc, AC_MUXNEG_PIN1_gc);
+	AC_Enable(&AC, ANALOG_COMPARATOR0, false);
+
+	ACEV_Init(&zeroCross, &AC, ANALOG_COMPARATOR0,
+	          EVSYS_CHMUX_ACA_CH0_gc, ZERO_CROSS_EVENT_CHANNEL,
+	          &TCD0, TC_CLKSEL_DIV8_gc,
+	          &DMA.CH0, DMA_CH_TRIGSRC_TCD0_CCA_gc,
+	          MIN_CROSSING_INTERVAL);
+	ACEV_EnableAutoHysteresis(&zeroCross, true);
+
+	/* Enable output on PORTD and PORTE. */
+	PORTD.DIRSET = 0xFF;
+	PORTE.DIRSET = 0xFF;
+
+	do {
+		while(ACEV_GetEvent(&zeroCross, &timestamp)){
+			/* Half period of the signal, upper bits. */
+			PORTE.OUT = (uint8_t) ((uint16_t) (timestamp - lastTimestamp) >> 4);
+			lastTimestamp = timestamp;
+		}
+		PORTD.OUT = (uint8_t) zeroCross.chatterCount;
+
+		/* The fault cleared the output override enable bits. Restart the
+		 * PWM outputs when the over-current has gone away.
+		 */
+		if(AWEX_IsFaultDetected((&AWEXC)) &&
+		   !AC_GetComparatorState(&AC, ANALOG_COMPARATOR1)){
+			AWEX_ClearFaultFlag((&AWEXC));
+			AWEXC.OUTOVEN = 0x03;
+		}
+	} while(true);
+}
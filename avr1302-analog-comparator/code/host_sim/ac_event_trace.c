@@ -0,0 +1,530 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host analog trace replay test of the Analog Comparator event service.
+ *
+ *      This program replays sampled analog traces on the comparator inputs of
+ *      the host simulator and runs the event service in ac_event.c on them, with
+ *      the comparator events routed through the event system to input capture
+ *      and to the AWeX fault detection as on the device. It reports the
+ *      distribution of the detection latency of each path.
+ *
+ *      Scenarios:
+ *        - zero_cross_<n>mv: a 50 Hz sine of 1.5 V amplitude on PA0 against
+ *          PA1 at mid level, with band-limited noise of n mV, timestamped by
+ *          TCD0 at 2 us per tick with automatic hysteresis tuning. The capture
+ *          error is the reconstructed capture time minus the true crossing of
+ *          the noise-free sine; the software latency is the time ACEV_GetEvent(),
+ *          polled every POLL_US from the main loop, returns the event. Every
+ *          crossing must give exactly one event, within the error bound set by
+ *          the noise, the largest hysteresis, the timer tick and the sample time,
+ *          and reach the main loop within one poll interval more.
+ *        - calibrate: ACEV_CalibrateScaler() on a quiescent current sense signal
+ *          with noise. The threshold found must be the first voltage scaler step
+ *          above the noise peak, plus the margin.
+ *        - overcurrent: current sense ramps of slopes from RAMP_SLOPE_MIN to
+ *          RAMP_SLOPE_MAX mV/us on PA2, compared with the calibrated threshold,
+ *          tripping the AWeX of TCC0. A second event channel captures the fault
+ *          event on TCE0 at the CPU clock, as a logic analyzer on the outputs
+ *          would. Every ramp must trip the fault and clear OUTOVEN, the baseline
+ *          noise must not, and the trip must follow the threshold crossing by
+ *          less than two samples: one for the sample time, one for the 1 mV
+ *          steps of the slowest ramps. The main loop re-arms the outputs as in
+ *          ac_event_example.c.
+ *
+ *      The traces are sampled every microsecond, and the simulator does not
+ *      model the comparator propagation delay (tens of nanoseconds in the data
+ *      sheet), so the latencies below one sample are those of the model. The
+ *      noise is drawn from a fixed pseudo-random sequence, so that runs repeat.
+ *
+ *      Each scenario prints one line of space separated key=value pairs, with
+ *      times in microseconds unless the key says otherwise, and the program
+ *      exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding ac_event.c. The simulator is
+ *      shared with AVR1307, the DMA model needs a program linked with -no-pie,
+ *      and the flash attribute of avr_compiler.h means nothing on the host:
+ *        gcc -std=gnu99 -O2 -no-pie -Wno-attributes -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/ac_event_trace.c ac_event.c ac_driver.c awex_driver.c \
+ *            -lm -o ac_event_trace
+ *        ./ac_event_trace
+ *
+ * \par Application note:
+ *      AVR1302: Using the XMEGA Analog Comparator
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "ac_event.h"
+#include "sim.h"
+
+/*! CPU cycles per microsecond. */
+#define CYCLES_PER_US        ( F_CPU / 1000000UL )
+
+/*! Time between trace samples. */
+#define SAMPLE_US            1
+
+/*! Signal frequency of the zero crossing scenarios, in Hz. */
+#define SINE_HZ              50
+
+/*! Periods of the sine replayed. */
+#define SINE_PERIODS         10
+
+/*! Sine amplitude and mid level, in mV. */
+#define SINE_AMPLITUDE_MV    1500
+#define SINE_OFFSET_MV       1650
+
+/*! The noise takes a new random value every NOISE_STEP_US, with linear
+ *  interpolation in between. */
+#define NOISE_STEP_US        20
+
+/*! Timer/Counter clock of the timestamps and its division. */
+#define TIMESTAMP_CLKSEL     TC_CLKSEL_DIV64_gc
+#define TIMESTAMP_DIV        64
+
+/*! Events closer than this to the last valid one are chatter, 2 ms. */
+#define MIN_INTERVAL_TICKS   ( 2000UL * CYCLES_PER_US / TIMESTAMP_DIV )
+
+/*! Interval of the main loop calling ACEV_GetEvent(). */
+#define POLL_US              1000
+
+/*! An event further than this from every crossing is an extra event. */
+#define MATCH_WINDOW_US      1000
+
+/*! Quiescent level and noise of the current sense signal, in mV. */
+#define SENSE_LEVEL_MV       300
+#define SENSE_NOISE_MV       20
+
+/*! Samples of the repeated quiescent noise trace. */
+#define QUIET_SAMPLES        997
+
+/*! Voltage scaler steps above the noise peak, as ac_event_example.c. */
+#define OVERCURRENT_MARGIN   8
+
+/*! Over-current ramps, their slopes and levels. */
+#define RAMPS                16
+#define RAMP_SLOPE_MIN       0.5
+#define RAMP_SLOPE_MAX       50.0
+#define RAMP_TOP_MV          2500
+#define RAMP_HOLD_US         200
+#define RAMP_GAP_US          2000
+
+/*! Interval of the main loop checking the fault flag. */
+#define FAULT_POLL_US        50
+
+/*! Largest number of events or trips recorded per scenario. */
+#define RECORD_SIZE          64
+
+/*! Samples of the longest trace. */
+#define TRACE_SIZE           ( SINE_PERIODS * 1000000UL / SINE_HZ / SAMPLE_US )
+
+
+/*! \brief Distribution of a latency, in CPU cycles. */
+typedef struct Stats_struct {
+	int64_t values[RECORD_SIZE];  /*!< In increasing order. */
+	uint8_t count;
+} Stats_t;
+
+
+/*! Trace replayed on a comparator input. */
+static int16_t trace[TRACE_SIZE];
+
+/*! Quiescent noise trace of the current sense signal. */
+static int16_t quiet[QUIET_SAMPLES];
+
+/*! Event service under test. */
+static ACEV_Service_t service;
+
+/*! State of the noise sequence. */
+static uint32_t noiseSeed = 1;
+
+
+/*! \brief Next value of the noise sequence, uniform in -1 to 1. */
+static double Noise_Next(void)
+{
+	noiseSeed = noiseSeed * 1103515245UL + 12345UL;
+	return ((noiseSeed >> 8) & 0xFFFF) / 32767.5 - 1.0;
+}
+
+
+/*! \brief Convert CPU cycles to microseconds. */
+static double Cycles_ToUs(int64_t cycles)
+{
+	return (double) cycles / CYCLES_PER_US;
+}
+
+
+/*! \brief Print the minimum, median, average and maximum of a latency.
+ *
+ *  \param name   Key prefix.
+ *  \param stats  The values.
+ *  \param ns     True to print nanoseconds instead of microseconds.
+ */
+static void Stats_Print(const char * name, Stats_t * stats, bool ns)
+{
+	double scale = ns ? 1000.0 : 1.0;
+	int64_t sum = 0;
+	uint8_t i;
+
+	if (stats->count == 0) {
+		printf(" %s=none", name);
+		return;
+	}
+	for (i = 0; i < stats->count; i++) {
+		sum += stats->values[i];
+	}
+	printf(" %s_min=%.1f %s_p50=%.1f %s_avg=%.1f %s_max=%.1f",
+	       name, scale * Cycles_ToUs(stats->values[0]),
+	       name, scale * Cycles_ToUs(stats->values[stats->count / 2]),
+	       name, scale * Cycles_ToUs(sum) / stats->count,
+	       name, scale * Cycles_ToUs(stats->values[stats->count - 1]));
+}
+
+
+/*! \brief Add a value to a latency distribution, keeping it sorted. */
+static void Stats_Add(Stats_t * stats, int64_t value)
+{
+	uint8_t i;
+
+	if (stats->count == RECORD_SIZE) {
+		return;
+	}
+	for (i = stats->count++; (i > 0) && (stats->values[i - 1] > value); i--) {
+		stats->values[i] = stats->values[i - 1];
+	}
+	stats->values[i] = value;
+}
+
+
+/*! \brief Run until a given time. */
+static void Run_Until(uint64_t cycle)
+{
+	if (cycle > SIM_GetCycles()) {
+		SIM_Run((uint32_t) (cycle - SIM_GetCycles()));
+	}
+}
+
+
+/*! \brief Zero crossing detection of a noisy sine.
+ *
+ *  \param noise  Peak noise in mV.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool ZeroCross_Run(uint16_t noise)
+{
+	/* Slope of the sine at the crossings, in mV per microsecond. */
+	double slope = 2 * M_PI * SINE_HZ * SINE_AMPLITUDE_MV / 1e6;
+	double boundUs = (noise + SIM_AC_HYS_LARGE_LP_MV / 2.0) / slope +
+	                 (double) TIMESTAMP_DIV / CYCLES_PER_US + SAMPLE_US;
+	uint16_t crossings = 2 * SINE_PERIODS;
+	uint8_t matched[2 * SINE_PERIODS];
+	Stats_t captureError = { .count = 0 };
+	Stats_t softwareLatency = { .count = 0 };
+	double noiseFrom = 0;
+	double noiseTo = Noise_Next();
+	uint16_t missed = 0;
+	uint16_t extra = 0;
+	uint64_t start;
+	uint64_t timerStart;
+	uint16_t timerCount;
+	uint64_t poll;
+	uint32_t i;
+	bool success;
+
+	/* The sine starts at its peak, crossing the mid level every half period
+	 * from a quarter period on. */
+	for (i = 0; i < TRACE_SIZE; i++) {
+		double t = (double) i * SAMPLE_US / 1e6;
+		double phase = (double) (i % NOISE_STEP_US) / NOISE_STEP_US;
+
+		if (i % NOISE_STEP_US == 0) {
+			noiseFrom = noiseTo;
+			noiseTo = Noise_Next();
+		}
+		trace[i] = (int16_t) lround(SINE_OFFSET_MV +
+		                            SINE_AMPLITUDE_MV * cos(2 * M_PI * SINE_HZ * t) +
+		                            noise * (noiseFrom + (noiseTo - noiseFrom) * phase));
+	}
+	memset(matched, 0, sizeof(matched));
+
+	/* Zero crossing comparator as in ac_event_example.c. */
+	AC_Disable(&ACA, ANALOG_COMPARATOR0);
+	AC_ConfigMUX(&ACA, ANALOG_COMPARATOR0, AC_MUXPOS_PIN0_gc, AC_MUXNEG_PIN1_gc);
+	SIM_AC_SetInput(&ACA, 1, SINE_OFFSET_MV);
+	SIM_AC_SetInput(&ACA, 0, trace[0]);
+	AC_Enable(&ACA, ANALOG_COMPARATOR0, false);
+	ACEV_Init(&service, &ACA, ANALOG_COMPARATOR0,
+	          EVSYS_CHMUX_ACA_CH0_gc, 0,
+	          &TCD0, TIMESTAMP_CLKSEL,
+	          &DMA.CH0, DMA_CH_TRIGSRC_TCD0_CCA_gc,
+	          MIN_INTERVAL_TICKS);
+	/* The timer was started by the last register access of ACEV_Init(). */
+	timerStart = SIM_GetCycles() - SIM_CYCLES_PER_ACCESS;
+	timerCount = TCD0.CNT;
+	ACEV_EnableAutoHysteresis(&service, true);
+
+	start = SIM_GetCycles();
+	SIM_AC_SetTrace(&ACA, 0, trace, TRACE_SIZE, SAMPLE_US * CYCLES_PER_US, false);
+
+	for (poll = start; poll < start + (uint64_t) TRACE_SIZE * SAMPLE_US * CYCLES_PER_US;) {
+		uint16_t timestamp;
+
+		poll += (uint64_t) POLL_US * CYCLES_PER_US;
+		Run_Until(poll);
+		while (ACEV_GetEvent(&service, &timestamp)) {
+			uint64_t now = SIM_GetCycles();
+			uint32_t ticks = (uint32_t) ((now - timerStart) / TIMESTAMP_DIV);
+			uint16_t age = (uint16_t) (timerCount + ticks - timestamp);
+			uint64_t capture = timerStart + (uint64_t) (ticks - age) * TIMESTAMP_DIV;
+			/* Nearest crossing of the noise-free sine. */
+			int64_t halfPeriod = (int64_t) CYCLES_PER_US * 1000000 / SINE_HZ / 2;
+			int64_t fromFirst = (int64_t) (capture - start) - halfPeriod / 2;
+			int64_t k = (fromFirst + halfPeriod / 2) / halfPeriod;
+			int64_t error = fromFirst - k * halfPeriod;
+
+			if ((fromFirst < -halfPeriod / 2) || (k >= crossings) ||
+			    (llabs(error) > (int64_t) MATCH_WINDOW_US * CYCLES_PER_US) || matched[k]) {
+				extra++;
+				continue;
+			}
+			matched[k] = 1;
+			Stats_Add(&captureError, error);
+			Stats_Add(&softwareLatency, error + (int64_t) (now - capture));
+		}
+	}
+	for (i = 0; i < crossings; i++) {
+		missed += !matched[i];
+	}
+
+	success = (missed == 0) && (extra == 0) && (captureError.count != 0) &&
+	          (fabs(Cycles_ToUs(captureError.values[0])) <= boundUs) &&
+	          (fabs(Cycles_ToUs(captureError.values[captureError.count - 1])) <= boundUs) &&
+	          (Cycles_ToUs(softwareLatency.values[softwareLatency.count - 1]) <= POLL_US + boundUs);
+	printf("scenario=zero_cross_%umv crossings=%u events=%u missed=%u extra=%u chatter=%u "
+	       "hysteresis=%s",
+	       noise, crossings, service.eventCount, missed, extra, service.chatterCount,
+	       (service.hysteresis == AC_HYSMODE_NO_gc) ? "no" :
+	       (service.hysteresis == AC_HYSMODE_SMALL_gc) ? "small" : "large");
+	Stats_Print("capture_err", &captureError, false);
+	Stats_Print("sw_latency", &softwareLatency, false);
+	printf(" err_bound=%.1f result=%s\n", boundUs, success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Scaler calibration on a noisy quiescent signal.
+ *
+ *  \param scale  Scale factor found.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool Calibrate_Run(uint8_t * scale)
+{
+	int16_t peak = INT16_MIN;
+	uint8_t clearStep;
+	uint16_t i;
+	bool success;
+
+	for (i = 0; i < QUIET_SAMPLES; i++) {
+		quiet[i] = (int16_t) lround(SENSE_LEVEL_MV + SENSE_NOISE_MV * Noise_Next());
+		if (quiet[i] > peak) {
+			peak = quiet[i];
+		}
+	}
+	SIM_AC_SetTrace(&ACA, 2, quiet, QUIET_SAMPLES, SAMPLE_US * CYCLES_PER_US, true);
+
+	/* Over-current comparator as in ac_event_example.c. */
+	AC_ConfigMUX(&ACA, ANALOG_COMPARATOR1, AC_MUXPOS_PIN2_gc, AC_MUXNEG_SCALER_gc);
+	AC_Enable(&ACA, ANALOG_COMPARATOR1, true);
+	*scale = ACEV_CalibrateScaler(&ACA, ANALOG_COMPARATOR1, OVERCURRENT_MARGIN);
+	clearStep = *scale - OVERCURRENT_MARGIN;
+
+	/* The output goes high above the scaler output, (step + 1) / 64 VCC. */
+	success = ((clearStep + 1) * (int32_t) SIM_AC_VCC_MV / 64 >= peak) &&
+	          ((clearStep == 0) || (clearStep * (int32_t) SIM_AC_VCC_MV / 64 < peak));
+	printf("scenario=calibrate level_mv=%u noise_peak_mv=%d first_clear_step=%u "
+	       "margin=%u scale=%u threshold_mv=%ld result=%s\n",
+	       SENSE_LEVEL_MV, peak, clearStep, OVERCURRENT_MARGIN, *scale,
+	       (long) ((*scale + 1) * (int32_t) SIM_AC_VCC_MV / 64),
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Over-current ramps tripping the AWeX fault detection.
+ *
+ *  \param scale  Voltage scaler setting of the threshold.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool Overcurrent_Run(uint8_t scale)
+{
+	int32_t threshold = (scale + 1) * (int32_t) SIM_AC_VCC_MV / 64;
+	uint64_t crossing[RAMPS];
+	Stats_t latency = { .count = 0 };
+	uint16_t trips = 0;
+	uint16_t falseTrips = 0;
+	uint16_t outputsLeft = 0;
+	uint32_t count = 0;
+	uint32_t i;
+	uint64_t start;
+	uint64_t end;
+	uint64_t timerStart;
+	uint16_t timerCount;
+	uint64_t poll;
+	uint8_t ramp;
+	bool success;
+
+	/* Baseline, then each ramp with its hold time and a gap of baseline.
+	 * The ramps are noise free, so the crossing is known exactly. */
+	for (ramp = 0; ramp < RAMPS; ramp++) {
+		double slope = RAMP_SLOPE_MIN *
+		               pow(RAMP_SLOPE_MAX / RAMP_SLOPE_MIN, (double) ramp / (RAMPS - 1));
+
+		for (i = 0; i < RAMP_GAP_US / SAMPLE_US; i++) {
+			trace[count++] = quiet[i % QUIET_SAMPLES];
+		}
+		crossing[ramp] = (uint64_t) (((threshold - SENSE_LEVEL_MV) / slope + count * SAMPLE_US) *
+		                             CYCLES_PER_US);
+		for (i = 0; SENSE_LEVEL_MV + slope * i * SAMPLE_US < RAMP_TOP_MV; i++) {
+			trace[count++] = (int16_t) lround(SENSE_LEVEL_MV + slope * i * SAMPLE_US);
+		}
+		for (i = 0; i < RAMP_HOLD_US / SAMPLE_US; i++) {
+			trace[count++] = RAMP_TOP_MV;
+		}
+	}
+	for (i = 0; i < RAMP_GAP_US / SAMPLE_US; i++) {
+		trace[count++] = quiet[i % QUIET_SAMPLES];
+	}
+
+	/* Rising edge of the over-current comparator trips the AWeX. */
+	AC_ConfigInterrupt(&ACA, ANALOG_COMPARATOR1, AC_INTMODE_RISING_gc, AC_INTLVL_OFF_gc);
+	ACEV_ConnectFault(EVSYS_CHMUX_ACA_CH1_gc, 1, &AWEXC, AWEX_FDACT_CLEAROE_gc);
+	AWEXC.STATUS = AWEX_FDF_bm;
+	AWEXC.OUTOVEN = 0x03;
+
+	/* Timestamp the same event at the CPU clock. */
+	EVSYS.CH2MUX = EVSYS_CHMUX_ACA_CH1_gc;
+	TCE0.CTRLA = TC_CLKSEL_OFF_gc;
+	TCE0.PER = 0xFFFF;
+	TCE0.CTRLB = TC0_CCAEN_bm | TC_WGMODE_NORMAL_gc;
+	TCE0.CTRLD = TC_EVACT_CAPT_gc | TC_EVSEL_CH2_gc;
+	TCE0.CTRLA = TC_CLKSEL_DIV1_gc;
+	timerStart = SIM_GetCycles() - SIM_CYCLES_PER_ACCESS;
+	timerCount = TCE0.CNT;
+
+	start = SIM_GetCycles();
+	end = start + (uint64_t) count * SAMPLE_US * CYCLES_PER_US;
+	SIM_AC_SetTrace(&ACA, 2, trace, count, SAMPLE_US * CYCLES_PER_US, false);
+
+	/* Main loop: note each trip, re-arm when the over-current has gone. */
+	for (poll = start; poll < end;) {
+		poll += (uint64_t) FAULT_POLL_US * CYCLES_PER_US;
+		Run_Until(poll);
+		if (AWEX_IsFaultDetected((&AWEXC))) {
+			uint16_t capture = TCE0.CCA;
+			uint64_t now = SIM_GetCycles();
+			uint32_t ticks = (uint32_t) (now - timerStart);
+			uint16_t age = (uint16_t) (timerCount + ticks - capture);
+			uint64_t trip = timerStart + ticks - age;
+			int64_t fromRamp = -1;
+
+			if (AWEXC.OUTOVEN != 0) {
+				outputsLeft++;
+			}
+			for (ramp = 0; ramp < RAMPS; ramp++) {
+				int64_t distance = (int64_t) (trip - start) - (int64_t) crossing[ramp];
+
+				if ((distance >= 0) &&
+				    (distance < (int64_t) (RAMP_HOLD_US * CYCLES_PER_US * 10))) {
+					fromRamp = distance;
+				}
+			}
+			if (fromRamp < 0) {
+				falseTrips++;
+			} else {
+				trips++;
+				Stats_Add(&latency, fromRamp);
+			}
+			/* Wait for the over-current to go away, then re-arm. */
+			while (AC_GetComparatorState(&ACA, ANALOG_COMPARATOR1)) {
+				SIM_Run(FAULT_POLL_US * CYCLES_PER_US);
+			}
+			AWEX_ClearFaultFlag((&AWEXC));
+			AWEXC.OUTOVEN = 0x03;
+			poll = SIM_GetCycles();
+		}
+	}
+
+	success = (trips == RAMPS) && (falseTrips == 0) && (outputsLeft == 0) &&
+	          (latency.count != 0) &&
+	          (latency.values[latency.count - 1] < (int64_t) (2 * SAMPLE_US * CYCLES_PER_US));
+	printf("scenario=overcurrent ramps=%u slope_mv_per_us=%.1f-%.1f threshold_mv=%ld "
+	       "trips=%u false_trips=%u outputs_left=%u",
+	       RAMPS, RAMP_SLOPE_MIN, RAMP_SLOPE_MAX, (long) threshold,
+	       trips, falseTrips, outputsLeft);
+	Stats_Print("latency_ns", &latency, true);
+	printf(" result=%s\n", success ? "pass" : "fail");
+	return success;
+}
+
+
+int main(void)
+{
+	static const uint16_t noises[] = { 0, 5, 20 };
+	bool success = true;
+	uint8_t scale = 0;
+	uint8_t i;
+
+	for (i = 0; i < sizeof(noises) / sizeof(noises[0]); i++) {
+		success &= ZeroCross_Run(noises[i]);
+	}
+	success &= Calibrate_Run(&scale);
+	success &= Overcurrent_Run(scale);
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
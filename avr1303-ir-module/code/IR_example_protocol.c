@@ -0,0 +1,117 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA IR remote control and IrDA SIR example source.
+ *
+ *      This file contains an example application that decodes remote control
+ *      frames with the IR remote control decoder and forwards them as IrDA SIR
+ *      frames on the IRCOM-enabled USART.
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 481 $
+ * $Date: 2007-03-06 10:12:53 +0100 (ty, 06 mar 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "avr_compiler.h"
+#include "IR_remote.h"
+#include "IR_sir.h"
+
+
+/*! Payload length of a forwarded remote control frame. */
+#define FORWARD_LENGTH  5
+
+
+/*! Remote control decoder instance. */
+IRRC_Decoder_t remoteDecoder;
+/*! IrDA SIR link instance. */
+IRSIR_Link_t sirLink;
+
+
+/*! \brief Example application.
+ *
+ *  The output of an IR receiver module (active low, e.g. TSOP family) is
+ *  connected to PD2. Its edges are captured by TCD0 through event channel 0
+ *  and copied into the decoder's ring buffer by DMA channel 0, without any
+ *  interrupts.
+ *
+ *  USARTC0 runs in IrDA mode at 9600 baud with the default 3/16 pulse
+ *  length, using DMA channel 1 for transmission and DMA channel 2 for
+ *  reception. Connect an IrDA transceiver to PC2 (RXD) and PC3 (TXD).
+ *
+ *  Every decoded remote control frame is forwarded as a SIR frame holding
+ *  protocol, address, command and flags. The first payload byte of every
+ *  SIR frame received is shown on the LEDs on PORTE.
+ */
+int main( void )
+{
+	IRRC_Frame_t frame;
+	uint8_t payload[FORWARD_LENGTH];
+
+	/* LEDs on PORTE. */
+	PORTE.DIRSET = 0xFF;
+	PORTE.OUTSET = 0xFF;
+
+	/* PC3 (TXD0) as output. */
+	PORTC.DIRSET = PIN3_bm;
+
+	IRRC_Init( &remoteDecoder, &TCD0, &PORTD, PIN2_bm,
+	           EVSYS_CHMUX_PORTD_PIN2_gc, 0,
+	           &DMA.CH0, DMA_CH_TRIGSRC_TCD0_CCA_gc );
+
+	/* 9600 baud at the default 2 MHz: BSEL = 12, BSCALE = 0. */
+	IRSIR_LinkInit( &sirLink, &USARTC0, 12, 0,
+	                &DMA.CH1, DMA_CH_TRIGSRC_USARTC0_DRE_gc,
+	                &DMA.CH2, DMA_CH_TRIGSRC_USARTC0_RXC_gc );
+
+	do {
+		while ( IRRC_Process( &remoteDecoder, &frame ) ) {
+			payload[0] = frame.protocol;
+			payload[1] = (uint8_t) ( frame.address >> 8 );
+			payload[2] = (uint8_t) frame.address;
+			payload[3] = frame.command;
+			payload[4] = frame.flags;
+
+			/* Drop the frame if the previous one is still being sent. */
+			IRSIR_Send( &sirLink, payload, FORWARD_LENGTH );
+		}
+
+		while ( IRSIR_Poll( &sirLink ) != 0 ) {
+			PORTE.OUT = ~IRSIR_GetPayload( &sirLink )[0];
+		}
+	} while (1);
+}
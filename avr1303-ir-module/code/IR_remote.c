@@ -0,0 +1,493 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA IR remote control decoder source file.
+ *
+ *      This file contains the function implementations of the IR remote
+ *      control decoder for the NEC, RC5 and Sony SIRC protocols.
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "IR_remote.h"
+
+
+/*! \brief Check if a duration matches a nominal time within 25%.
+ *
+ *  \param duration  Measured duration in ticks.
+ *  \param nominal   Nominal duration in ticks.
+ *
+ *  \return  True if the duration is within tolerance.
+ */
+static bool IRRC_Match( uint16_t duration, uint16_t nominal )
+{
+	uint16_t tolerance = nominal >> 2;
+
+	return ( duration >= nominal - tolerance ) &&
+	       ( duration <= nominal + tolerance );
+}
+
+
+/*! \brief Decode a NEC frame or repeat code.
+ *
+ *  A NEC frame is a 9 ms leader mark, a 4.5 ms space, 32 bits sent LSB
+ *  first and a stop mark. Every bit is a 560 us mark followed by a 560 us
+ *  (zero) or 1690 us (one) space. The bytes are address, inverted address
+ *  (or high address byte for extended NEC), command and inverted command.
+ *
+ *  \param pulses      Pulse buffer.
+ *  \param pulseCount  Number of pulses.
+ *  \param frame       Decoded frame.
+ *
+ *  \return  True if a valid frame was decoded.
+ */
+static bool IRRC_DecodeNEC( const uint16_t * pulses,
+                            uint8_t pulseCount,
+                            IRRC_Frame_t * frame )
+{
+	uint32_t data = 0;
+	uint8_t bit;
+	uint8_t command;
+	uint8_t commandInverted;
+
+	/* Repeat code: leader mark, 2.25 ms space and a stop mark. */
+	if ( ( pulseCount == 3 ) &&
+	     IRRC_Match( pulses[1], IRRC_US_TO_TICKS( IRRC_NEC_REPEAT_SPACE_US ) ) ) {
+		frame->protocol = IRRC_PROTOCOL_NEC;
+		frame->flags = IRRC_FLAG_REPEAT_bm;
+		frame->bitCount = 0;
+		return true;
+	}
+
+	if ( ( pulseCount != 67 ) ||
+	     !IRRC_Match( pulses[1], IRRC_US_TO_TICKS( IRRC_NEC_LEADER_SPACE_US ) ) ) {
+		return false;
+	}
+
+	for ( bit = 0; bit < 32; bit++ ) {
+		uint16_t mark = pulses[2 + 2 * bit] & IRRC_TIMESTAMP_MASK;
+		uint16_t space = pulses[3 + 2 * bit];
+
+		if ( !IRRC_Match( mark, IRRC_US_TO_TICKS( IRRC_NEC_BIT_MARK_US ) ) ) {
+			return false;
+		}
+
+		data >>= 1;
+		if ( IRRC_Match( space, IRRC_US_TO_TICKS( IRRC_NEC_ONE_SPACE_US ) ) ) {
+			data |= 0x80000000UL;
+		} else if ( !IRRC_Match( space, IRRC_US_TO_TICKS( IRRC_NEC_ZERO_SPACE_US ) ) ) {
+			return false;
+		}
+	}
+
+	command = (uint8_t) ( data >> 16 );
+	commandInverted = (uint8_t) ( data >> 24 );
+	if ( (uint8_t) ( command ^ commandInverted ) != 0xFF ) {
+		return false;
+	}
+
+	frame->protocol = IRRC_PROTOCOL_NEC;
+	frame->command = command;
+	frame->flags = 0;
+	frame->bitCount = 32;
+
+	/* Standard NEC sends the inverted address, extended NEC a 16-bit one. */
+	if ( (uint8_t) ~( data >> 8 ) == (uint8_t) data ) {
+		frame->address = (uint8_t) data;
+	} else {
+		frame->address = (uint16_t) data;
+	}
+
+	return true;
+}
+
+
+/*! \brief Decode a Sony SIRC frame.
+ *
+ *  A SIRC frame is a 2.4 ms start mark followed by 12, 15 or 20 bits sent
+ *  LSB first. Every bit is a 600 us space followed by a 600 us (zero) or
+ *  1200 us (one) mark. The first 7 bits are the command, the rest the
+ *  address.
+ *
+ *  \param pulses      Pulse buffer.
+ *  \param pulseCount  Number of pulses.
+ *  \param frame       Decoded frame.
+ *
+ *  \return  True if a valid frame was decoded.
+ */
+static bool IRRC_DecodeSIRC( const uint16_t * pulses,
+                             uint8_t pulseCount,
+                             IRRC_Frame_t * frame )
+{
+	uint8_t bitCount = ( pulseCount - 1 ) / 2;
+	uint32_t data = 0;
+	uint8_t bit;
+
+	if ( ( bitCount != 12 ) && ( bitCount != 15 ) && ( bitCount != 20 ) ) {
+		return false;
+	}
+
+	for ( bit = 0; bit < bitCount; bit++ ) {
+		uint16_t space = pulses[1 + 2 * bit];
+		uint16_t mark = pulses[2 + 2 * bit] & IRRC_TIMESTAMP_MASK;
+
+		if ( !IRRC_Match( space, IRRC_US_TO_TICKS( IRRC_SIRC_SPACE_US ) ) ) {
+			return false;
+		}
+
+		if ( IRRC_Match( mark, IRRC_US_TO_TICKS( IRRC_SIRC_ONE_MARK_US ) ) ) {
+			data |= 1UL << bit;
+		} else if ( !IRRC_Match( mark, IRRC_US_TO_TICKS( IRRC_SIRC_ZERO_MARK_US ) ) ) {
+			return false;
+		}
+	}
+
+	frame->protocol = IRRC_PROTOCOL_SIRC;
+	frame->command = (uint8_t) ( data & 0x7F );
+	frame->address = (uint16_t) ( data >> 7 );
+	frame->flags = 0;
+	frame->bitCount = bitCount;
+
+	return true;
+}
+
+
+/*! \brief Decode a Philips RC5 frame.
+ *
+ *  RC5 is Manchester coded with a bit time of 1778 us. A one is a space
+ *  followed by a mark, a zero a mark followed by a space. The 14 bits are
+ *  two start bits, the toggle bit, 5 address bits and 6 command bits, sent
+ *  MSB first. The second start bit is the inverted command bit 6 in
+ *  extended RC5.
+ *
+ *  The pulses are expanded into half bits. The first half of the first
+ *  start bit is a space and therefore not visible, and a trailing space is
+ *  merged with the inter-frame gap, so both are added here.
+ *
+ *  \param pulses      Pulse buffer.
+ *  \param pulseCount  Number of pulses.
+ *  \param frame       Decoded frame.
+ *
+ *  \return  True if a valid frame was decoded.
+ */
+static bool IRRC_DecodeRC5( const uint16_t * pulses,
+                            uint8_t pulseCount,
+                            IRRC_Frame_t * frame )
+{
+	uint32_t halfBits = 0;  /* One bit per half bit, 1 = mark. */
+	uint8_t halfBitCount = 1;
+	uint16_t data = 0;
+	uint8_t i;
+
+	for ( i = 0; i < pulseCount; i++ ) {
+		uint16_t duration = pulses[i] & IRRC_TIMESTAMP_MASK;
+		uint8_t isMark = ( pulses[i] & IRRC_MARK_bm ) ? 1 : 0;
+		uint8_t length;
+
+		if ( IRRC_Match( duration, IRRC_US_TO_TICKS( IRRC_RC5_HALF_BIT_US ) ) ) {
+			length = 1;
+		} else if ( IRRC_Match( duration, IRRC_US_TO_TICKS( 2 * IRRC_RC5_HALF_BIT_US ) ) ) {
+			length = 2;
+		} else {
+			return false;
+		}
+
+		while ( length-- ) {
+			if ( halfBitCount >= 28 ) {
+				return false;
+			}
+			halfBits = ( halfBits << 1 ) | isMark;
+			halfBitCount++;
+		}
+	}
+
+	/* Pad the trailing space of a final zero. */
+	if ( halfBitCount == 27 ) {
+		halfBits <<= 1;
+		halfBitCount++;
+	}
+	if ( halfBitCount != 28 ) {
+		return false;
+	}
+
+	/* Each bit must have a transition in the middle. */
+	for ( i = 0; i < 14; i++ ) {
+		uint8_t pair = (uint8_t) ( halfBits >> ( 26 - 2 * i ) ) & 0x03;
+
+		data <<= 1;
+		if ( pair == 0x01 ) {
+			data |= 1;
+		} else if ( pair != 0x02 ) {
+			return false;
+		}
+	}
+
+	frame->protocol = IRRC_PROTOCOL_RC5;
+	frame->command = ( data & 0x3F ) | ( ( data & 0x1000 ) ? 0 : 0x40 );
+	frame->address = ( data >> 6 ) & 0x1F;
+	frame->flags = ( data & 0x0800 ) ? IRRC_FLAG_TOGGLE_bm : 0;
+	frame->bitCount = 14;
+
+	return true;
+}
+
+
+/*! \brief Initialize the IR remote control decoder.
+ *
+ *  This function configures the receiver pin to sense both edges and routes
+ *  it through an event channel to input capture channel A of the
+ *  Timer/Counter. The period is set to 0x7FFF, which makes the
+ *  Timer/Counter store the pin level in bit 15 of every capture. A DMA
+ *  channel triggered by the capture copies the captures into the edge ring
+ *  buffer and wraps around at its end.
+ *
+ *  \param decoder         Pointer to the decoder.
+ *  \param tc              The Timer/Counter to use for timestamps.
+ *  \param port            The port of the IR receiver pin.
+ *  \param pinMask         Bit mask of the IR receiver pin.
+ *  \param pinEventSource  Event source for the pin, e.g.
+ *                         EVSYS_CHMUX_PORTD_PIN2_gc.
+ *  \param eventChannel    Event channel to use, 0 to 7.
+ *  \param dmaChannel      DMA channel to use.
+ *  \param dmaTrigger      Capture A trigger of the Timer/Counter, e.g.
+ *                         DMA_CH_TRIGSRC_TCD0_CCA_gc.
+ */
+void IRRC_Init( IRRC_Decoder_t * decoder,
+                TC0_t * tc,
+                PORT_t * port,
+                uint8_t pinMask,
+                EVSYS_CHMUX_t pinEventSource,
+                uint8_t eventChannel,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dmaTrigger )
+{
+	uint32_t srcAddr = (uint32_t) (uintptr_t) &tc->CCA;
+	uint32_t destAddr = (uint32_t) (uintptr_t) decoder->edges;
+
+	decoder->tc = tc;
+	decoder->dmaChannel = dmaChannel;
+	decoder->readIndex = 0;
+	decoder->lastEdgeValid = false;
+	decoder->pulseCount = 0;
+	decoder->edgeCount = 0;
+	decoder->frameCount = 0;
+	decoder->errorCount = 0;
+
+	/* Receiver pin as input, sensing both edges. */
+	port->DIRCLR = pinMask;
+	PORTCFG.MPCMASK = pinMask;
+	port->PIN0CTRL = PORT_ISC_BOTHEDGES_gc;
+
+	/* Route the pin to the event channel. */
+	( &EVSYS.CH0MUX )[eventChannel] = pinEventSource;
+
+	/* Copy every capture into the ring buffer, wrapping at the end. */
+	DMA.CTRL |= DMA_ENABLE_bm;
+	dmaChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	dmaChannel->CTRLA |= DMA_CH_RESET_bm;
+
+	dmaChannel->SRCADDR0 = ( srcAddr >> 0*8 ) & 0xFF;
+	dmaChannel->SRCADDR1 = ( srcAddr >> 1*8 ) & 0xFF;
+	dmaChannel->SRCADDR2 = ( srcAddr >> 2*8 ) & 0xFF;
+
+	dmaChannel->DESTADDR0 = ( destAddr >> 0*8 ) & 0xFF;
+	dmaChannel->DESTADDR1 = ( destAddr >> 1*8 ) & 0xFF;
+	dmaChannel->DESTADDR2 = ( destAddr >> 2*8 ) & 0xFF;
+
+	dmaChannel->ADDRCTRL = DMA_CH_SRCRELOAD_BURST_gc | DMA_CH_SRCDIR_INC_gc |
+	                       DMA_CH_DESTRELOAD_BLOCK_gc | DMA_CH_DESTDIR_INC_gc;
+	dmaChannel->TRFCNT = sizeof( decoder->edges );
+	dmaChannel->REPCNT = 0;
+	dmaChannel->TRIGSRC = dmaTrigger;
+	dmaChannel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm | DMA_CH_SINGLE_bm |
+	                    DMA_CH_BURSTLEN_2BYTE_gc;
+
+	/* Free-running timer capturing on channel A. */
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->PER = IRRC_TIMESTAMP_MASK;
+	tc->CTRLB = TC0_CCAEN_bm | TC_WGMODE_NORMAL_gc;
+	tc->CTRLD = TC_EVACT_CAPT_gc | ( TC_EVSEL_CH0_gc + eventChannel );
+	tc->CTRLA = IRRC_TIMER_CLKSEL;
+}
+
+
+/*! \brief Decode the pulses of one frame.
+ *
+ *  The protocol is selected from the length of the first mark, trying RC5
+ *  if a frame with a SIRC start mark does not decode as SIRC. This
+ *  function can also be used to decode recorded pulse trains offline.
+ *
+ *  \param pulses      Pulse durations in ticks, marks flagged with
+ *                     IRRC_MARK_bm. The first pulse must be a mark.
+ *  \param pulseCount  Number of pulses.
+ *  \param frame       Decoded frame.
+ *
+ *  \return  True if a valid frame was decoded.
+ */
+bool IRRC_DecodePulses( const uint16_t * pulses,
+                        uint8_t pulseCount,
+                        IRRC_Frame_t * frame )
+{
+	uint16_t leader;
+
+	frame->protocol = IRRC_PROTOCOL_NONE;
+	if ( ( pulseCount < 3 ) || !( pulses[0] & IRRC_MARK_bm ) ) {
+		return false;
+	}
+
+	leader = pulses[0] & IRRC_TIMESTAMP_MASK;
+	if ( IRRC_Match( leader, IRRC_US_TO_TICKS( IRRC_NEC_LEADER_MARK_US ) ) ) {
+		return IRRC_DecodeNEC( pulses, pulseCount, frame );
+	}
+	/* An RC5 frame starting with a zero after the start bit has a double
+	 * half bit mark of 1778 us, which a receiver module can stretch into
+	 * the SIRC start mark range. */
+	if ( IRRC_Match( leader, IRRC_US_TO_TICKS( IRRC_SIRC_START_MARK_US ) ) &&
+	     IRRC_DecodeSIRC( pulses, pulseCount, frame ) ) {
+		return true;
+	}
+	return IRRC_DecodeRC5( pulses, pulseCount, frame );
+}
+
+
+/*! \brief Decode the pending frame and start a new one.
+ *
+ *  \param decoder  Pointer to the decoder.
+ *  \param frame    Decoded frame.
+ *
+ *  \return  True if a valid frame was decoded.
+ */
+static bool IRRC_EndFrame( IRRC_Decoder_t * decoder, IRRC_Frame_t * frame )
+{
+	bool valid = false;
+
+	if ( decoder->pulseCount <= IRRC_MAX_PULSES ) {
+		valid = IRRC_DecodePulses( decoder->pulses, decoder->pulseCount, frame );
+	}
+
+	if ( valid ) {
+		decoder->frameCount++;
+	} else {
+		decoder->errorCount++;
+	}
+	decoder->pulseCount = 0;
+
+	return valid;
+}
+
+
+/*! \brief Process captured edges and decode complete frames.
+ *
+ *  This function converts all edges captured since the last call into
+ *  mark and space durations. A frame ends with a space longer than
+ *  IRRC_GAP_US, or when the line has been idle for that long.
+ *
+ *  The function returns as soon as a frame is decoded, so it should be
+ *  called again until it returns false. It must be called at least every
+ *  30 ms, so that the edge buffer does not overflow and the timestamps do
+ *  not wrap more than once.
+ *
+ *  \param decoder  Pointer to the decoder.
+ *  \param frame    Decoded frame, valid if true is returned.
+ *
+ *  \return  True if a frame was decoded.
+ */
+bool IRRC_Process( IRRC_Decoder_t * decoder, IRRC_Frame_t * frame )
+{
+	uint16_t bytesLeft;
+	uint8_t writeIndex;
+	uint16_t now;
+
+	/* The DMA channel counts down the bytes left of the buffer. */
+	AVR_ENTER_CRITICAL_REGION( );
+	bytesLeft = decoder->dmaChannel->TRFCNT;
+	now = decoder->tc->CNT;
+	AVR_LEAVE_CRITICAL_REGION( );
+	writeIndex = (uint8_t) ( ( sizeof( decoder->edges ) - bytesLeft ) / 2 ) &
+	             ( IRRC_EDGE_BUFFER_SIZE - 1 );
+
+	while ( decoder->readIndex != writeIndex ) {
+		uint16_t edge = decoder->edges[decoder->readIndex];
+
+		decoder->readIndex = ( decoder->readIndex + 1 ) & ( IRRC_EDGE_BUFFER_SIZE - 1 );
+		decoder->edgeCount++;
+
+		if ( decoder->lastEdgeValid ) {
+			uint16_t duration = ( edge - decoder->lastEdge ) & IRRC_TIMESTAMP_MASK;
+			bool isMark = !( decoder->lastEdge & IRRC_LEVEL_bm );
+
+			if ( isMark ) {
+				if ( decoder->pulseCount < IRRC_MAX_PULSES ) {
+					decoder->pulses[decoder->pulseCount++] = duration | IRRC_MARK_bm;
+				} else {
+					/* Too long for any protocol, drop it. */
+					decoder->pulseCount = IRRC_MAX_PULSES + 1;
+				}
+			} else if ( duration >= IRRC_US_TO_TICKS( IRRC_GAP_US ) ) {
+				if ( decoder->pulseCount != 0 ) {
+					decoder->lastEdge = edge;
+					if ( IRRC_EndFrame( decoder, frame ) ) {
+						return true;
+					}
+					continue;
+				}
+			} else if ( decoder->pulseCount != 0 ) {
+				if ( decoder->pulseCount < IRRC_MAX_PULSES ) {
+					decoder->pulses[decoder->pulseCount++] = duration;
+				} else {
+					decoder->pulseCount = IRRC_MAX_PULSES + 1;
+				}
+			}
+		}
+
+		decoder->lastEdge = edge;
+		decoder->lastEdgeValid = true;
+	}
+
+	/* Line idle (high) after the last mark: the frame is complete. */
+	if ( ( decoder->pulseCount != 0 ) &&
+	     ( decoder->lastEdge & IRRC_LEVEL_bm ) &&
+	     ( ( ( now - decoder->lastEdge ) & IRRC_TIMESTAMP_MASK ) >=
+	       IRRC_US_TO_TICKS( IRRC_GAP_US ) ) ) {
+		return IRRC_EndFrame( decoder, frame );
+	}
+
+	return false;
+}
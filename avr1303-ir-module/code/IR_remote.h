@@ -0,0 +1,192 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA IR remote control decoder header file.
+ *
+ *      This file contains the function prototypes, macros and type definitions
+ *      for the IR remote control decoder. The decoder handles the NEC, RC5 and
+ *      Sony SIRC protocols.
+ *
+ *      The output of an IR receiver module is routed through the event system
+ *      to a Timer/Counter input capture, and a DMA channel copies every capture
+ *      into a ring buffer. No code runs per edge; the edge timestamps are
+ *      decoded in batches by IRRC_Process(), called from the main loop.
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef IR_REMOTE_H
+#define IR_REMOTE_H
+
+#include "avr_compiler.h"
+
+/*! Number of edge timestamps in the DMA ring buffer. Must be a power of two,
+ *  and large enough to hold the edges arriving between two calls to
+ *  IRRC_Process(). A NEC frame has 68 edges.
+ */
+#define IRRC_EDGE_BUFFER_SIZE   128
+
+/*! Maximum number of mark/space pulses in one frame (NEC: 67). */
+#define IRRC_MAX_PULSES         68
+
+/* Timer clock for the timestamps, giving a range of 65 ms or more. */
+#ifndef IRRC_TIMER_CLKSEL
+#if F_CPU > 8000000UL
+/*! Timer clock selection for the edge timestamps. */
+#define IRRC_TIMER_CLKSEL       TC_CLKSEL_DIV64_gc
+/*! Timer prescaler division factor, must match IRRC_TIMER_CLKSEL. */
+#define IRRC_TIMER_DIV          64
+#else
+#define IRRC_TIMER_CLKSEL       TC_CLKSEL_DIV8_gc
+#define IRRC_TIMER_DIV          8
+#endif
+#endif
+
+/*! \brief Convert microseconds to timestamp ticks.
+ *
+ *  \param _us  Time in microseconds.
+ */
+#define IRRC_US_TO_TICKS( _us ) \
+        ( (uint16_t) ( ( (uint32_t) (_us) * ( F_CPU / 1000UL ) ) / \
+                       ( IRRC_TIMER_DIV * 1000UL ) ) )
+
+/*! Timestamps are 15 bits. The captured pin level is stored in bit 15. */
+#define IRRC_TIMESTAMP_MASK     0x7FFF
+
+/*! Pin level bit in a captured timestamp. */
+#define IRRC_LEVEL_bm           0x8000
+
+/*! Mark flag in a stored pulse, the remaining bits hold the duration. */
+#define IRRC_MARK_bm            0x8000
+
+/*! Shortest space that ends a frame. Longer than any space within a frame. */
+#define IRRC_GAP_US             7000
+
+/* Nominal protocol timing in microseconds. */
+#define IRRC_NEC_LEADER_MARK_US    9000  /*!< NEC leader mark. */
+#define IRRC_NEC_LEADER_SPACE_US   4500  /*!< NEC leader space. */
+#define IRRC_NEC_REPEAT_SPACE_US   2250  /*!< NEC repeat code space. */
+#define IRRC_NEC_BIT_MARK_US        560  /*!< NEC bit mark. */
+#define IRRC_NEC_ZERO_SPACE_US      560  /*!< NEC space for a zero. */
+#define IRRC_NEC_ONE_SPACE_US      1690  /*!< NEC space for a one. */
+#define IRRC_SIRC_START_MARK_US    2400  /*!< SIRC start mark. */
+#define IRRC_SIRC_SPACE_US          600  /*!< SIRC space between bits. */
+#define IRRC_SIRC_ZERO_MARK_US      600  /*!< SIRC mark for a zero. */
+#define IRRC_SIRC_ONE_MARK_US      1200  /*!< SIRC mark for a one. */
+#define IRRC_RC5_HALF_BIT_US        889  /*!< RC5 half bit time. */
+
+
+/*! \brief Remote control protocols. */
+typedef enum IRRC_Protocol_enum {
+	IRRC_PROTOCOL_NONE = 0,  /*!< No frame decoded. */
+	IRRC_PROTOCOL_NEC = 1,   /*!< NEC, 8 or 16 bit address and 8 bit command. */
+	IRRC_PROTOCOL_RC5 = 2,   /*!< Philips RC5, 5 bit address and 7 bit command. */
+	IRRC_PROTOCOL_SIRC = 3,  /*!< Sony SIRC, 12, 15 or 20 bits. */
+} IRRC_Protocol_t;
+
+/*! Frame flag: NEC repeat code, the previous command is still held. */
+#define IRRC_FLAG_REPEAT_bm     0x01
+/*! Frame flag: RC5 toggle bit, changes on every new key press. */
+#define IRRC_FLAG_TOGGLE_bm     0x02
+
+
+/*! \brief A decoded remote control frame. */
+typedef struct IRRC_Frame_struct {
+	/*! Protocol of the frame. */
+	IRRC_Protocol_t protocol;
+	/*! Device address. NEC: 16 bits if the inverted address byte does not match. */
+	uint16_t address;
+	/*! Command code. */
+	uint8_t command;
+	/*! IRRC_FLAG_REPEAT_bm and IRRC_FLAG_TOGGLE_bm. */
+	uint8_t flags;
+	/*! Number of data bits in the frame. */
+	uint8_t bitCount;
+} IRRC_Frame_t;
+
+
+/*! \brief IR remote control decoder instance.
+ *
+ *  The edge buffer is written by the DMA controller. Every entry is a
+ *  Timer/Counter capture with the timestamp in bits 0-14 and the pin level
+ *  after the edge in bit 15.
+ */
+typedef struct IRRC_Decoder_struct {
+	/*! Timer/Counter capturing the edges on channel A. */
+	TC0_t * tc;
+	/*! DMA channel copying the captures to the edge buffer. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! Edge capture ring buffer, written by DMA. */
+	uint16_t edges[IRRC_EDGE_BUFFER_SIZE];
+	/*! Next edge to process. */
+	uint8_t readIndex;
+	/*! Previous edge capture. */
+	uint16_t lastEdge;
+	/*! True if lastEdge holds a valid capture. */
+	bool lastEdgeValid;
+	/*! Pulses of the frame being received. */
+	uint16_t pulses[IRRC_MAX_PULSES];
+	/*! Number of pulses in pulses[]. */
+	uint8_t pulseCount;
+	/*! Number of edges processed, for decode rate statistics. */
+	uint32_t edgeCount;
+	/*! Number of frames successfully decoded. */
+	uint16_t frameCount;
+	/*! Number of frames not matching any protocol. */
+	uint16_t errorCount;
+} IRRC_Decoder_t;
+
+
+/* Prototyping of functions. */
+
+void IRRC_Init( IRRC_Decoder_t * decoder,
+                TC0_t * tc,
+                PORT_t * port,
+                uint8_t pinMask,
+                EVSYS_CHMUX_t pinEventSource,
+                uint8_t eventChannel,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dmaTrigger );
+bool IRRC_Process( IRRC_Decoder_t * decoder, IRRC_Frame_t * frame );
+bool IRRC_DecodePulses( const uint16_t * pulses,
+                        uint8_t pulseCount,
+                        IRRC_Frame_t * frame );
+
+#endif
@@ -0,0 +1,397 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA IrDA SIR framing source file.
+ *
+ *      This file contains the function implementations of the IrDA SIR framing
+ *      and the DMA-driven IrDA SIR link.
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "IR_sir.h"
+
+
+/*! \brief Update the frame check sequence with one byte.
+ *
+ *  The FCS is the reflected CRC-16-CCITT (polynomial 0x8408) used by IrLAP.
+ *  This table-free formulation needs only shifts and XORs, which is cheaper
+ *  on the AVR than a bit loop and does not use any flash for a table.
+ *
+ *  \param fcs   Current frame check sequence.
+ *  \param data  Data byte.
+ *
+ *  \return  Updated frame check sequence.
+ */
+uint16_t IRSIR_UpdateFCS( uint16_t fcs, uint8_t data )
+{
+	data ^= (uint8_t) fcs;
+	data ^= (uint8_t) ( data << 4 );
+
+	return ( ( (uint16_t) data << 8 ) | ( fcs >> 8 ) ) ^
+	       (uint8_t) ( data >> 4 ) ^
+	       ( (uint16_t) data << 3 );
+}
+
+
+/*! \brief Store a character, escaping it if it is a control character.
+ *
+ *  \param frame  Position in the frame buffer.
+ *  \param data   Character to store.
+ *
+ *  \return  Next position in the frame buffer.
+ */
+static uint8_t * IRSIR_PutEscaped( uint8_t * frame, uint8_t data )
+{
+	if ( ( data == IRSIR_BOF ) || ( data == IRSIR_EOF ) || ( data == IRSIR_CE ) ) {
+		*frame++ = IRSIR_CE;
+		data ^= IRSIR_ESCAPE_XOR;
+	}
+	*frame++ = data;
+
+	return frame;
+}
+
+
+/*! \brief Encode a frame for transmission.
+ *
+ *  The frame consists of the extra BOFs, a BOF, the escaped payload, the
+ *  escaped FCS (least significant byte first) and an EOF.
+ *
+ *  \param payload    Payload to send, at most IRSIR_MAX_PAYLOAD bytes.
+ *  \param length     Payload length.
+ *  \param extraBofs  Number of extra BOFs, at most IRSIR_MAX_EXTRA_BOFS.
+ *  \param frame      Frame buffer, at least IRSIR_TX_BUFFER_SIZE bytes.
+ *
+ *  \return  Length of the encoded frame.
+ */
+uint8_t IRSIR_EncodeFrame( const uint8_t * payload,
+                           uint8_t length,
+                           uint8_t extraBofs,
+                           uint8_t * frame )
+{
+	uint8_t * position = frame;
+	uint16_t fcs = IRSIR_FCS_INIT;
+
+	do {
+		*position++ = IRSIR_BOF;
+	} while ( extraBofs-- != 0 );
+
+	while ( length-- != 0 ) {
+		uint8_t data = *payload++;
+
+		fcs = IRSIR_UpdateFCS( fcs, data );
+		position = IRSIR_PutEscaped( position, data );
+	}
+
+	fcs = ~fcs;
+	position = IRSIR_PutEscaped( position, (uint8_t) fcs );
+	position = IRSIR_PutEscaped( position, (uint8_t) ( fcs >> 8 ) );
+	*position++ = IRSIR_EOF;
+
+	return (uint8_t) ( position - frame );
+}
+
+
+/*! \brief Initialize a frame receiver.
+ *
+ *  \param receiver  Pointer to the receiver.
+ */
+void IRSIR_ReceiverInit( IRSIR_Receiver_t * receiver )
+{
+	receiver->length = 0;
+	receiver->fcs = IRSIR_FCS_INIT;
+	receiver->state = IRSIR_RX_STATE_HUNT;
+	receiver->frameCount = 0;
+	receiver->errorCount = 0;
+	receiver->overrunCount = 0;
+}
+
+
+/*! \brief Feed one received character to the frame receiver.
+ *
+ *  A BOF always starts a new frame, so a frame aborted by the sender is
+ *  discarded when the next frame begins. A frame ended by the abort
+ *  sequence, CE and EOF, or cut off by a BOF counts as an error, as does
+ *  one with a bad FCS. Characters outside frames are ignored.
+ *
+ *  \param receiver  Pointer to the receiver.
+ *  \param data      Received character.
+ *
+ *  \return  The payload length if this character completed a frame with a
+ *           valid FCS, zero otherwise. The payload is in receiver->buffer.
+ */
+uint8_t IRSIR_ReceiveChar( IRSIR_Receiver_t * receiver, uint8_t data )
+{
+	switch ( data ) {
+	case IRSIR_BOF:
+		/* A frame cut off by a new BOF is aborted. */
+		if ( ( receiver->state != IRSIR_RX_STATE_HUNT ) && ( receiver->length != 0 ) ) {
+			receiver->errorCount++;
+		}
+		receiver->length = 0;
+		receiver->fcs = IRSIR_FCS_INIT;
+		receiver->state = IRSIR_RX_STATE_DATA;
+		return 0;
+
+	case IRSIR_EOF:
+		if ( receiver->state == IRSIR_RX_STATE_HUNT ) {
+			return 0;
+		}
+		/* CE followed by EOF is the abort sequence. */
+		if ( ( receiver->state == IRSIR_RX_STATE_DATA ) &&
+		     ( receiver->length > 2 ) && ( receiver->fcs == IRSIR_FCS_GOOD ) ) {
+			receiver->state = IRSIR_RX_STATE_HUNT;
+			receiver->frameCount++;
+			return receiver->length - 2;
+		}
+		receiver->state = IRSIR_RX_STATE_HUNT;
+		receiver->errorCount++;
+		return 0;
+
+	case IRSIR_CE:
+		if ( receiver->state == IRSIR_RX_STATE_DATA ) {
+			receiver->state = IRSIR_RX_STATE_ESCAPE;
+		}
+		return 0;
+
+	default:
+		break;
+	}
+
+	if ( receiver->state == IRSIR_RX_STATE_HUNT ) {
+		return 0;
+	}
+
+	if ( receiver->state == IRSIR_RX_STATE_ESCAPE ) {
+		data ^= IRSIR_ESCAPE_XOR;
+		receiver->state = IRSIR_RX_STATE_DATA;
+	}
+
+	if ( receiver->length >= sizeof( receiver->buffer ) ) {
+		receiver->overrunCount++;
+		receiver->state = IRSIR_RX_STATE_HUNT;
+		return 0;
+	}
+
+	receiver->buffer[receiver->length++] = data;
+	receiver->fcs = IRSIR_UpdateFCS( receiver->fcs, data );
+
+	return 0;
+}
+
+
+/*! \brief Set the source and destination address of a DMA channel.
+ *
+ *  \param channel   The DMA channel.
+ *  \param srcAddr   Source address.
+ *  \param destAddr  Destination address.
+ */
+static void IRSIR_SetDMAAddresses( volatile DMA_CH_t * channel,
+                                   uint32_t srcAddr,
+                                   uint32_t destAddr )
+{
+	channel->SRCADDR0 = ( srcAddr >> 0*8 ) & 0xFF;
+	channel->SRCADDR1 = ( srcAddr >> 1*8 ) & 0xFF;
+	channel->SRCADDR2 = ( srcAddr >> 2*8 ) & 0xFF;
+
+	channel->DESTADDR0 = ( destAddr >> 0*8 ) & 0xFF;
+	channel->DESTADDR1 = ( destAddr >> 1*8 ) & 0xFF;
+	channel->DESTADDR2 = ( destAddr >> 2*8 ) & 0xFF;
+}
+
+
+/*! \brief Initialize an IrDA SIR link.
+ *
+ *  This function sets the USART in IrDA mode with 8 data bits, no parity
+ *  and 1 stop bit, and uses the default 3/16 bit pulse length of the IRCOM
+ *  module. The receive DMA channel is started immediately and runs
+ *  continuously, writing every received character into a ring buffer.
+ *
+ *  The application must set the USART TXD pin as output.
+ *
+ *  \param link          Pointer to the link.
+ *  \param usart         The USART to use.
+ *  \param bselValue     Baud rate select value.
+ *  \param bscaleFactor  Baud rate scale factor, -7 to 7.
+ *  \param txChannel     DMA channel for transmission.
+ *  \param txTrigger     Data register empty trigger of the USART, e.g.
+ *                       DMA_CH_TRIGSRC_USARTC0_DRE_gc.
+ *  \param rxChannel     DMA channel for reception.
+ *  \param rxTrigger     Receive complete trigger of the USART, e.g.
+ *                       DMA_CH_TRIGSRC_USARTC0_RXC_gc.
+ */
+void IRSIR_LinkInit( IRSIR_Link_t * link,
+                     USART_t * usart,
+                     uint16_t bselValue,
+                     int8_t bscaleFactor,
+                     volatile DMA_CH_t * txChannel,
+                     DMA_CH_TRIGSRC_t txTrigger,
+                     volatile DMA_CH_t * rxChannel,
+                     DMA_CH_TRIGSRC_t rxTrigger )
+{
+	link->usart = usart;
+	link->txChannel = txChannel;
+	link->rxChannel = rxChannel;
+	link->rxReadIndex = 0;
+	IRSIR_ReceiverInit( &link->receiver );
+
+	/* USART in IrDA mode, 8N1. */
+	usart->CTRLC = USART_CMODE_IRDA_gc | USART_PMODE_DISABLED_gc |
+	               USART_CHSIZE_8BIT_gc;
+	usart->BAUDCTRLA = (uint8_t) bselValue;
+	usart->BAUDCTRLB = ( (uint8_t) bscaleFactor << USART_BSCALE_gp ) |
+	                   (uint8_t) ( bselValue >> 8 );
+	IRCOM_TXSetPulseLength( 0 );
+	IRCOM_RXSetPulseLength( 0 );
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	/* Transmit channel, started by IRSIR_Send(). */
+	txChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	txChannel->CTRLA |= DMA_CH_RESET_bm;
+	txChannel->TRIGSRC = txTrigger;
+
+	/* Receive channel, writing to the ring buffer forever. */
+	rxChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	rxChannel->CTRLA |= DMA_CH_RESET_bm;
+	IRSIR_SetDMAAddresses( rxChannel,
+	                       (uint32_t) (uintptr_t) &usart->DATA,
+	                       (uint32_t) (uintptr_t) link->rxRing );
+	rxChannel->ADDRCTRL = DMA_CH_SRCRELOAD_NONE_gc | DMA_CH_SRCDIR_FIXED_gc |
+	                      DMA_CH_DESTRELOAD_BLOCK_gc | DMA_CH_DESTDIR_INC_gc;
+	rxChannel->TRFCNT = IRSIR_RX_RING_SIZE;
+	rxChannel->REPCNT = 0;
+	rxChannel->TRIGSRC = rxTrigger;
+	rxChannel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm | DMA_CH_SINGLE_bm |
+	                   DMA_CH_BURSTLEN_1BYTE_gc;
+
+	usart->CTRLB |= USART_RXEN_bm | USART_TXEN_bm;
+}
+
+
+/*! \brief Send a frame.
+ *
+ *  The payload is encoded into the transmit buffer, and the transmit DMA
+ *  channel feeds it to the USART, triggered by the data register empty
+ *  flag. The payload buffer can be reused as soon as this function
+ *  returns.
+ *
+ *  \param link     Pointer to the link.
+ *  \param payload  Payload to send.
+ *  \param length   Payload length, 1 to IRSIR_MAX_PAYLOAD.
+ *
+ *  \return  True if the frame was queued, false if the previous frame is
+ *           still being sent or the payload is empty or too long.
+ */
+bool IRSIR_Send( IRSIR_Link_t * link, const uint8_t * payload, uint8_t length )
+{
+	volatile DMA_CH_t * channel = link->txChannel;
+	uint8_t frameLength;
+
+	if ( IRSIR_IsSending( link ) || ( length == 0 ) || ( length > IRSIR_MAX_PAYLOAD ) ) {
+		return false;
+	}
+
+	frameLength = IRSIR_EncodeFrame( payload, length, 0, link->txBuffer );
+
+	IRSIR_SetDMAAddresses( channel,
+	                       (uint32_t) (uintptr_t) link->txBuffer,
+	                       (uint32_t) (uintptr_t) &link->usart->DATA );
+	channel->ADDRCTRL = DMA_CH_SRCRELOAD_NONE_gc | DMA_CH_SRCDIR_INC_gc |
+	                    DMA_CH_DESTRELOAD_NONE_gc | DMA_CH_DESTDIR_FIXED_gc;
+	channel->TRFCNT = frameLength;
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+
+	return true;
+}
+
+
+/*! \brief Check if a frame is being sent.
+ *
+ *  The DMA channel disables itself when the last character has been
+ *  written to the USART. The character may still be shifting out.
+ *
+ *  \param link  Pointer to the link.
+ *
+ *  \return  True if the transmit DMA channel is still active.
+ */
+bool IRSIR_IsSending( IRSIR_Link_t * link )
+{
+	return ( link->txChannel->CTRLA & DMA_CH_ENABLE_bm ) != 0;
+}
+
+
+/*! \brief Process received characters.
+ *
+ *  This function runs all characters received by DMA since the last call
+ *  through the frame receiver. It returns as soon as a valid frame is
+ *  complete, so it should be called again until it returns zero. It must
+ *  be called often enough that the ring buffer does not overflow, i.e.
+ *  at least once per IRSIR_RX_RING_SIZE character times.
+ *
+ *  \param link  Pointer to the link.
+ *
+ *  \return  The payload length of a received frame, or zero. The payload is
+ *           available through IRSIR_GetPayload().
+ */
+uint8_t IRSIR_Poll( IRSIR_Link_t * link )
+{
+	uint16_t bytesLeft;
+	uint8_t writeIndex;
+
+	AVR_ENTER_CRITICAL_REGION( );
+	bytesLeft = link->rxChannel->TRFCNT;
+	AVR_LEAVE_CRITICAL_REGION( );
+	writeIndex = (uint8_t) ( IRSIR_RX_RING_SIZE - bytesLeft ) & ( IRSIR_RX_RING_SIZE - 1 );
+
+	while ( link->rxReadIndex != writeIndex ) {
+		uint8_t data = link->rxRing[link->rxReadIndex];
+		uint8_t length;
+
+		link->rxReadIndex = ( link->rxReadIndex + 1 ) & ( IRSIR_RX_RING_SIZE - 1 );
+		length = IRSIR_ReceiveChar( &link->receiver, data );
+		if ( length != 0 ) {
+			return length;
+		}
+	}
+
+	return 0;
+}
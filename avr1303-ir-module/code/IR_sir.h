@@ -0,0 +1,170 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA IrDA SIR framing header file.
+ *
+ *      This file contains the function prototypes, macros and type definitions
+ *      for IrDA SIR asynchronous framing on top of a USART in IRCOM mode.
+ *
+ *      Frames are wrapped with BOF/EOF flags, control characters in the payload
+ *      are escaped, and a 16-bit frame check sequence (CRC-16-CCITT, as used by
+ *      IrLAP) is appended. Transmission and reception run by DMA, so the CPU
+ *      only touches complete frames.
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef IR_SIR_H
+#define IR_SIR_H
+
+#include "avr_compiler.h"
+#include "IR_driver.h"
+
+/*! Beginning of frame flag. */
+#define IRSIR_BOF               0xC0
+/*! End of frame flag. */
+#define IRSIR_EOF               0xC1
+/*! Control escape character. */
+#define IRSIR_CE                0x7D
+/*! Value XORed with an escaped character. */
+#define IRSIR_ESCAPE_XOR        0x20
+
+/*! Initial value of the frame check sequence. */
+#define IRSIR_FCS_INIT          0xFFFF
+/*! Frame check sequence residue of a frame received without errors. */
+#define IRSIR_FCS_GOOD          0xF0B8
+
+/*! Largest payload that can be sent or received. */
+#define IRSIR_MAX_PAYLOAD       64
+
+/*! Largest number of extra BOFs sent in front of a frame. */
+#define IRSIR_MAX_EXTRA_BOFS    4
+
+/*! Worst-case size of an encoded frame: every payload and FCS byte
+ *  escaped, plus the BOF, EOF and the extra BOFs.
+ */
+#define IRSIR_TX_BUFFER_SIZE    ( 2 * ( IRSIR_MAX_PAYLOAD + 2 ) + 2 + IRSIR_MAX_EXTRA_BOFS )
+
+/*! Size of the receive DMA ring buffer. Must be a power of two. */
+#define IRSIR_RX_RING_SIZE      128
+
+
+/*! \brief Receive state machine states. */
+typedef enum IRSIR_RxState_enum {
+	IRSIR_RX_STATE_HUNT = 0,    /*!< Waiting for BOF. */
+	IRSIR_RX_STATE_DATA = 1,    /*!< Receiving frame data. */
+	IRSIR_RX_STATE_ESCAPE = 2,  /*!< Previous character was CE. */
+} IRSIR_RxState_t;
+
+
+/*! \brief IrDA SIR frame receiver, independent of the USART.
+ *
+ *  The received payload and FCS are unescaped into the buffer while the
+ *  FCS is updated, so a frame is checked as soon as the EOF arrives.
+ */
+typedef struct IRSIR_Receiver_struct {
+	/*! Payload and FCS of the frame being received. */
+	uint8_t buffer[IRSIR_MAX_PAYLOAD + 2];
+	/*! Number of bytes in buffer. */
+	uint8_t length;
+	/*! Running frame check sequence. */
+	uint16_t fcs;
+	/*! Receive state. */
+	IRSIR_RxState_t state;
+	/*! Number of frames received without errors. */
+	uint16_t frameCount;
+	/*! Number of frames with FCS errors or aborted frames. */
+	uint16_t errorCount;
+	/*! Number of frames longer than IRSIR_MAX_PAYLOAD. */
+	uint16_t overrunCount;
+} IRSIR_Receiver_t;
+
+
+/*! \brief IrDA SIR link on a USART with DMA transmission and reception. */
+typedef struct IRSIR_Link_struct {
+	/*! USART in IrDA mode. */
+	USART_t * usart;
+	/*! DMA channel feeding the USART data register. */
+	volatile DMA_CH_t * txChannel;
+	/*! DMA channel emptying the USART data register into rxRing. */
+	volatile DMA_CH_t * rxChannel;
+	/*! Encoded frame being transmitted. */
+	uint8_t txBuffer[IRSIR_TX_BUFFER_SIZE];
+	/*! Received characters, written by DMA. */
+	uint8_t rxRing[IRSIR_RX_RING_SIZE];
+	/*! Next character to process in rxRing. */
+	uint8_t rxReadIndex;
+	/*! Frame receiver. */
+	IRSIR_Receiver_t receiver;
+} IRSIR_Link_t;
+
+
+/* Prototyping of functions. */
+
+uint16_t IRSIR_UpdateFCS( uint16_t fcs, uint8_t data );
+uint8_t IRSIR_EncodeFrame( const uint8_t * payload,
+                           uint8_t length,
+                           uint8_t extraBofs,
+                           uint8_t * frame );
+void IRSIR_ReceiverInit( IRSIR_Receiver_t * receiver );
+uint8_t IRSIR_ReceiveChar( IRSIR_Receiver_t * receiver, uint8_t data );
+
+void IRSIR_LinkInit( IRSIR_Link_t * link,
+                     USART_t * usart,
+                     uint16_t bselValue,
+                     int8_t bscaleFactor,
+                     volatile DMA_CH_t * txChannel,
+                     DMA_CH_TRIGSRC_t txTrigger,
+                     volatile DMA_CH_t * rxChannel,
+                     DMA_CH_TRIGSRC_t rxTrigger );
+bool IRSIR_Send( IRSIR_Link_t * link, const uint8_t * payload, uint8_t length );
+bool IRSIR_IsSending( IRSIR_Link_t * link );
+uint8_t IRSIR_Poll( IRSIR_Link_t * link );
+
+/*! \brief This macro returns the payload of the last frame received.
+ *
+ *  The payload is valid after IRSIR_Poll() returned a non-zero length,
+ *  until the next call to IRSIR_Poll().
+ *
+ *  \param _link  Pointer to the IrDA SIR link.
+ */
+#define IRSIR_GetPayload( _link )   ( (_link)->receiver.buffer )
+
+#endif
@@ -16,6 +16,13 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section hostsim Host Simulation
+ * The IR remote control decoder and the IrDA SIR framing can also be built
+ * for a Linux x86-64 host, using the register headers and the simulator in
+ * the host_sim directory of AVR1307. See host_sim/ir_replay.c for the decode
+ * rate over a sweep of remote control timing, host_sim/irsir_frame.c for the
+ * framing and the link, and sim.h for what is modelled. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
@@ -0,0 +1,593 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host trace replay test of the IR remote control decoder.
+ *
+ *      This program replays synthetic IR receiver traces on a port pin of the
+ *      host simulator and runs the IR remote control decoder in IR_remote.c on
+ *      them, through the same event channel, input capture and DMA ring buffer
+ *      as on the device. IRRC_Process() is called every PROCESS_INTERVAL_US, as
+ *      from a main loop.
+ *
+ *      Each trace is built from the nominal protocol timing, scaled to model a
+ *      remote control with a slow or fast oscillator, and then distorted as the
+ *      output of an IR receiver module: every mark is stretched by
+ *      MARK_STRETCH_US, and every edge moves by up to JITTER_US, drawn from a
+ *      fixed pseudo-random sequence so that runs repeat. The traces hold NEC
+ *      frames with the inverted and with a 16-bit (extended) address, NEC
+ *      repeat codes, RC5 frames with the toggle bit set and cleared, and SIRC
+ *      frames of 12, 15 and 20 bits.
+ *
+ *      For every timing scale from 70% to 130% of nominal, FRAMES_PER_CASE
+ *      frames of each kind are sent, each followed by FRAME_GAP_US of idle line.
+ *      The program prints one line per scale with the decoded and sent frames
+ *      of each kind, and checks that:
+ *        - all frames are decoded within SCALE_BAND percent of nominal,
+ *        - no frame is ever decoded with a wrong protocol, address, command,
+ *          flags or bit count,
+ *        - a trace of short noise spikes gives no frame,
+ *        - every edge injected is captured and processed, none lost in the
+ *          DMA ring buffer.
+ *
+ *      Each line holds space separated key=value pairs, and the program exits
+ *      with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding IR_remote.c. The simulator is
+ *      shared with AVR1307, the DMA model needs a program linked with -no-pie,
+ *      and the flash attribute of avr_compiler.h means nothing on the host:
+ *        gcc -std=gnu99 -O2 -no-pie -Wno-attributes -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/ir_replay.c IR_remote.c -o ir_replay
+ *        ./ir_replay
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "IR_remote.h"
+#include "sim.h"
+
+/*! Frames sent of each kind per timing scale. */
+#define FRAMES_PER_CASE       4
+
+/*! Lowest timing scale, in percent of nominal. */
+#define SCALE_MIN             70
+
+/*! Highest timing scale, in percent of nominal. */
+#define SCALE_MAX             130
+
+/*! Step between timing scales, in percent. */
+#define SCALE_STEP            5
+
+/*! Scales within this many percent of nominal must decode every frame. */
+#define SCALE_BAND            15
+
+/*! Mark stretch of the IR receiver module. */
+#define MARK_STRETCH_US       20
+
+/*! Largest edge jitter, either way. */
+#define JITTER_US             12
+
+/*! Idle line after each frame. */
+#define FRAME_GAP_US          25000
+
+/*! Interval between calls to IRRC_Process(). */
+#define PROCESS_INTERVAL_US   10000
+
+/*! Noise spikes in the noise trace. */
+#define NOISE_SPIKES          400
+
+/*! Largest edges in one frame: NEC, 67 pulses. */
+#define TRACE_SIZE            ( IRRC_MAX_PULSES + 1 )
+
+/*! Frames kept per IRRC_Process() round. */
+#define RESULT_SIZE           8
+
+/*! CPU cycles per microsecond. */
+#define CYCLES_PER_US         ( F_CPU / 1000000UL )
+
+
+/*! \brief A kind of frame sent. */
+typedef enum Case_enum {
+	CASE_NEC,
+	CASE_NEC_EXT,
+	CASE_NEC_REPEAT,
+	CASE_RC5,
+	CASE_SIRC12,
+	CASE_SIRC15,
+	CASE_SIRC20,
+	CASE_COUNT,
+} Case_t;
+
+/*! Names printed for each kind of frame. */
+static const char * const caseNames[CASE_COUNT] = {
+	"nec", "nec_ext", "nec_repeat", "rc5", "sirc12", "sirc15", "sirc20"
+};
+
+/*! \brief A pulse train: alternating mark and space durations, mark first. */
+typedef struct Trace_struct {
+	/*! Durations in microseconds. */
+	uint16_t pulses[TRACE_SIZE];
+	/*! Number of pulses. */
+	uint8_t count;
+} Trace_t;
+
+
+/*! The decoder under test. */
+static IRRC_Decoder_t decoder;
+
+/*! Frames decoded since the last call to Results_Clear(). */
+static IRRC_Frame_t results[RESULT_SIZE];
+
+/*! Number of frames in results[], may exceed RESULT_SIZE. */
+static uint8_t resultCount;
+
+/*! Cycle count of the next call to IRRC_Process(). */
+static uint64_t nextProcess;
+
+/*! Edges driven on the pin. */
+static uint32_t edgesInjected;
+
+/*! State of the jitter sequence. */
+static uint32_t jitterSeed = 1;
+
+
+/*! \brief Call IRRC_Process() until it has no more frames. */
+static void Decoder_Poll(void)
+{
+	IRRC_Frame_t frame;
+
+	while (IRRC_Process(&decoder, &frame)) {
+		if (resultCount < RESULT_SIZE) {
+			results[resultCount] = frame;
+		}
+		resultCount++;
+	}
+}
+
+
+/*! \brief Let time pass, calling IRRC_Process() every PROCESS_INTERVAL_US.
+ *
+ *  \param cycles  CPU cycles to run.
+ */
+static void Line_Run(uint64_t cycles)
+{
+	uint64_t end = SIM_GetCycles() + cycles;
+
+	while (SIM_GetCycles() < end) {
+		uint64_t now = SIM_GetCycles();
+		uint64_t until = (nextProcess < end) ? nextProcess : end;
+
+		if (until > now) {
+			SIM_Run((uint32_t) (until - now));
+		}
+		if (SIM_GetCycles() >= nextProcess) {
+			Decoder_Poll();
+			nextProcess += (uint64_t) PROCESS_INTERVAL_US * CYCLES_PER_US;
+		}
+	}
+}
+
+
+/*! \brief Next jitter value of the pseudo-random sequence.
+ *
+ *  \return  Jitter in CPU cycles, -JITTER_US to JITTER_US microseconds.
+ */
+static int32_t Jitter_Next(void)
+{
+	jitterSeed = jitterSeed * 1103515245UL + 12345UL;
+	return (int32_t) ((jitterSeed >> 16) % (2 * JITTER_US * CYCLES_PER_US + 1)) -
+	       (int32_t) (JITTER_US * CYCLES_PER_US);
+}
+
+
+/*! \brief Drive a pulse train on the receiver pin, as a receiver module would.
+ *
+ *  The edges are placed at the scaled nominal times, the end of each mark
+ *  is delayed by the mark stretch, and each edge is moved by the jitter.
+ *  A mark is a low level.
+ *
+ *  \param trace    Pulse train, durations in microseconds.
+ *  \param scale    Timing scale in percent.
+ *  \param stretch  Mark stretch in microseconds.
+ *  \param jitter   True to add the edge jitter.
+ */
+static void Trace_Play(const Trace_t * trace, uint8_t scale, uint16_t stretch, bool jitter)
+{
+	uint64_t start = SIM_GetCycles();
+	uint64_t nominal = 0;
+	uint8_t i;
+
+	for (i = 0; i < trace->count; i++) {
+		bool mark = ((i & 1) == 0);
+		int64_t edge = (int64_t) (nominal * scale / 100);
+
+		if (i != 0) {
+			if (!mark) {
+				edge += (int64_t) stretch * CYCLES_PER_US;
+			}
+			if (jitter) {
+				edge += Jitter_Next();
+			}
+		}
+		if ((int64_t) (start + edge) > (int64_t) SIM_GetCycles()) {
+			Line_Run(start + edge - SIM_GetCycles());
+		}
+		SIM_PORT_SetInput(&PORTD, mark ? 0 : PIN2_bm);
+		edgesInjected++;
+		nominal += (uint64_t) trace->pulses[i] * CYCLES_PER_US;
+	}
+
+	/* The last pulse is a mark: its end returns the line to idle. */
+	{
+		int64_t edge = (int64_t) (nominal * scale / 100) + (int64_t) stretch * CYCLES_PER_US;
+
+		if (jitter) {
+			edge += Jitter_Next();
+		}
+		if ((int64_t) (start + edge) > (int64_t) SIM_GetCycles()) {
+			Line_Run(start + edge - SIM_GetCycles());
+		}
+		SIM_PORT_SetInput(&PORTD, PIN2_bm);
+		edgesInjected++;
+	}
+}
+
+
+/*! \brief Add a pulse to a pulse train.
+ *
+ *  Consecutive pulses of the same kind are merged.
+ *
+ *  \param trace     Pulse train.
+ *  \param duration  Duration in microseconds.
+ *  \param mark      True for a mark.
+ */
+static void Trace_Add(Trace_t * trace, uint16_t duration, bool mark)
+{
+	bool lastMark = ((trace->count & 1) == 1);
+
+	if ((trace->count == 0) && !mark) {
+		return;
+	}
+	if ((trace->count != 0) && (lastMark == mark)) {
+		trace->pulses[trace->count - 1] += duration;
+	} else {
+		trace->pulses[trace->count++] = duration;
+	}
+}
+
+
+/*! \brief Build a NEC frame, 32 bits LSB first.
+ *
+ *  \param trace  Pulse train built.
+ *  \param data   Address, address high byte or inverted address, command
+ *                and inverted command, from the least significant byte.
+ */
+static void Trace_NEC(Trace_t * trace, uint32_t data)
+{
+	uint8_t bit;
+
+	trace->count = 0;
+	Trace_Add(trace, IRRC_NEC_LEADER_MARK_US, true);
+	Trace_Add(trace, IRRC_NEC_LEADER_SPACE_US, false);
+	for (bit = 0; bit < 32; bit++) {
+		Trace_Add(trace, IRRC_NEC_BIT_MARK_US, true);
+		Trace_Add(trace, (data & (1UL << bit)) ? IRRC_NEC_ONE_SPACE_US :
+		                                         IRRC_NEC_ZERO_SPACE_US, false);
+	}
+	Trace_Add(trace, IRRC_NEC_BIT_MARK_US, true);
+}
+
+
+/*! \brief Build a NEC repeat code.
+ *
+ *  \param trace  Pulse train built.
+ */
+static void Trace_NECRepeat(Trace_t * trace)
+{
+	trace->count = 0;
+	Trace_Add(trace, IRRC_NEC_LEADER_MARK_US, true);
+	Trace_Add(trace, IRRC_NEC_REPEAT_SPACE_US, false);
+	Trace_Add(trace, IRRC_NEC_BIT_MARK_US, true);
+}
+
+
+/*! \brief Build an RC5 frame, 14 Manchester coded bits MSB first.
+ *
+ *  A one is a space followed by a mark. The leading space of the first
+ *  start bit and a trailing space are part of the idle line.
+ *
+ *  \param trace  Pulse train built.
+ *  \param data   The 14 bits, start bits first.
+ */
+static void Trace_RC5(Trace_t * trace, uint16_t data)
+{
+	int8_t bit;
+
+	trace->count = 0;
+	for (bit = 13; bit >= 0; bit--) {
+		bool one = (data >> bit) & 1;
+
+		Trace_Add(trace, IRRC_RC5_HALF_BIT_US, !one);
+		Trace_Add(trace, IRRC_RC5_HALF_BIT_US, one);
+	}
+	if ((trace->count & 1) == 0) {
+		trace->count--;
+	}
+}
+
+
+/*! \brief Build a SIRC frame, LSB first.
+ *
+ *  \param trace     Pulse train built.
+ *  \param data      Command in bits 0-6, address above.
+ *  \param bitCount  Number of bits, 12, 15 or 20.
+ */
+static void Trace_SIRC(Trace_t * trace, uint32_t data, uint8_t bitCount)
+{
+	uint8_t bit;
+
+	trace->count = 0;
+	Trace_Add(trace, IRRC_SIRC_START_MARK_US, true);
+	for (bit = 0; bit < bitCount; bit++) {
+		Trace_Add(trace, IRRC_SIRC_SPACE_US, false);
+		Trace_Add(trace, (data & (1UL << bit)) ? IRRC_SIRC_ONE_MARK_US :
+		                                         IRRC_SIRC_ZERO_MARK_US, true);
+	}
+}
+
+
+/*! \brief Build frame number \a n of a kind, and the frame it decodes to.
+ *
+ *  The address and command change with \a n, so that every bit position
+ *  is exercised with both values.
+ *
+ *  \param kind      Kind of frame.
+ *  \param n         Frame number.
+ *  \param trace     Pulse train built.
+ *  \param expected  Frame the decoder should return.
+ */
+static void Case_Build(Case_t kind, uint8_t n, Trace_t * trace, IRRC_Frame_t * expected)
+{
+	static const uint8_t patterns[4] = { 0x5A, 0xA5, 0x0F, 0xF0 };
+	uint8_t pattern = patterns[n & 3];
+	uint8_t command = (uint8_t) (pattern ^ (n >> 2));
+
+	memset(expected, 0, sizeof(*expected));
+	switch (kind) {
+	case CASE_NEC:
+		Trace_NEC(trace, (uint32_t) pattern | ((uint32_t) (uint8_t) ~pattern << 8) |
+		                 ((uint32_t) command << 16) | ((uint32_t) (uint8_t) ~command << 24));
+		expected->protocol = IRRC_PROTOCOL_NEC;
+		expected->address = pattern;
+		expected->command = command;
+		expected->bitCount = 32;
+		break;
+	case CASE_NEC_EXT:
+		Trace_NEC(trace, (uint32_t) pattern | ((uint32_t) (pattern ^ 0x3C) << 8) |
+		                 ((uint32_t) command << 16) | ((uint32_t) (uint8_t) ~command << 24));
+		expected->protocol = IRRC_PROTOCOL_NEC;
+		expected->address = (uint16_t) (pattern | ((pattern ^ 0x3C) << 8));
+		expected->command = command;
+		expected->bitCount = 32;
+		break;
+	case CASE_NEC_REPEAT:
+		Trace_NECRepeat(trace);
+		expected->protocol = IRRC_PROTOCOL_NEC;
+		expected->flags = IRRC_FLAG_REPEAT_bm;
+		break;
+	case CASE_RC5:
+	{
+		/* Start bit, inverted command bit 6, toggle, address and command. */
+		uint8_t address = pattern & 0x1F;
+		uint8_t rc5Command = command & 0x7F;
+		bool toggle = (n & 1);
+
+		Trace_RC5(trace, (uint16_t) (0x2000 | ((rc5Command & 0x40) ? 0 : 0x1000) |
+		                             (toggle ? 0x0800 : 0) | (address << 6) |
+		                             (rc5Command & 0x3F)));
+		expected->protocol = IRRC_PROTOCOL_RC5;
+		expected->address = address;
+		expected->command = rc5Command;
+		expected->flags = toggle ? IRRC_FLAG_TOGGLE_bm : 0;
+		expected->bitCount = 14;
+		break;
+	}
+	default:
+	{
+		uint8_t bitCount = (kind == CASE_SIRC12) ? 12 : (kind == CASE_SIRC15) ? 15 : 20;
+		uint32_t address = ((uint32_t) pattern << 5 | (n & 0x1F)) &
+		                   ((1UL << (bitCount - 7)) - 1);
+
+		Trace_SIRC(trace, (command & 0x7F) | (address << 7), bitCount);
+		expected->protocol = IRRC_PROTOCOL_SIRC;
+		expected->address = (uint16_t) address;
+		expected->command = command & 0x7F;
+		expected->bitCount = bitCount;
+		break;
+	}
+	}
+}
+
+
+/*! \brief Compare a decoded frame with the frame sent.
+ *
+ *  \param frame     Decoded frame.
+ *  \param expected  Frame sent.
+ *
+ *  \return  true if they match. Only the flags of a repeat code are compared.
+ */
+static bool Frame_Match(const IRRC_Frame_t * frame, const IRRC_Frame_t * expected)
+{
+	if ((frame->protocol != expected->protocol) || (frame->flags != expected->flags)) {
+		return false;
+	}
+	if (expected->flags & IRRC_FLAG_REPEAT_bm) {
+		return true;
+	}
+	return (frame->address == expected->address) &&
+	       (frame->command == expected->command) &&
+	       (frame->bitCount == expected->bitCount);
+}
+
+
+/*! \brief Send the frames of every kind at one timing scale.
+ *
+ *  \param scale  Timing scale in percent.
+ *  \param wrong  Incremented for each frame decoded with wrong contents.
+ *
+ *  \return  true if all frames were decoded.
+ */
+static bool Scale_Run(uint8_t scale, uint16_t * wrong)
+{
+	uint8_t decoded[CASE_COUNT];
+	uint16_t sent = 0;
+	uint16_t good = 0;
+	uint16_t wrongBefore = *wrong;
+	uint8_t kind;
+	uint8_t n;
+
+	for (kind = 0; kind < CASE_COUNT; kind++) {
+		decoded[kind] = 0;
+		for (n = 0; n < FRAMES_PER_CASE; n++) {
+			Trace_t trace;
+			IRRC_Frame_t expected;
+			uint8_t i;
+
+			Case_Build((Case_t) kind, n, &trace, &expected);
+			resultCount = 0;
+			Trace_Play(&trace, scale, MARK_STRETCH_US, true);
+			Line_Run((uint64_t) FRAME_GAP_US * CYCLES_PER_US);
+			sent++;
+			for (i = 0; (i < resultCount) && (i < RESULT_SIZE); i++) {
+				if (!Frame_Match(&results[i], &expected)) {
+					(*wrong)++;
+				}
+			}
+			if ((resultCount == 1) && Frame_Match(&results[0], &expected)) {
+				decoded[kind]++;
+				good++;
+			}
+		}
+	}
+
+	printf("scale=%u", scale);
+	for (kind = 0; kind < CASE_COUNT; kind++) {
+		printf(" %s=%u/%u", caseNames[kind], decoded[kind], FRAMES_PER_CASE);
+	}
+	printf(" decode_rate=%.1f%% wrong=%u\n", 100.0 * good / sent, *wrong - wrongBefore);
+	return good == sent;
+}
+
+
+/*! \brief Send noise spikes and check that no frame is decoded.
+ *
+ *  The spikes are marks of 10 to 300 us, spaced 0.5 to 20 ms apart, as
+ *  from a lamp or a switching power supply near the receiver.
+ *
+ *  \return  true if no frame was decoded.
+ */
+static bool Noise_Run(void)
+{
+	uint16_t errorsBefore = decoder.errorCount;
+	uint16_t i;
+
+	resultCount = 0;
+	for (i = 0; i < NOISE_SPIKES; i++) {
+		Trace_t trace;
+
+		trace.count = 1;
+		trace.pulses[0] = 10 + (uint16_t) ((uint32_t) (Jitter_Next() + JITTER_US * CYCLES_PER_US) * 290 /
+		                                   (2 * JITTER_US * CYCLES_PER_US));
+		Trace_Play(&trace, 100, 0, false);
+		Line_Run((uint64_t) (500 + (uint32_t) (Jitter_Next() + JITTER_US * CYCLES_PER_US) * 19500 /
+		                     (2 * JITTER_US * CYCLES_PER_US)) * CYCLES_PER_US);
+	}
+	Line_Run((uint64_t) FRAME_GAP_US * CYCLES_PER_US);
+
+	printf("scenario=noise spikes=%u frames=%u rejected=%u result=%s\n",
+	       NOISE_SPIKES, resultCount, decoder.errorCount - errorsBefore,
+	       (resultCount == 0) ? "pass" : "fail");
+	return resultCount == 0;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	bool inBand = true;
+	uint16_t wrong = 0;
+	uint8_t scale;
+
+	/* Idle line, then start the decoder as IR_example_protocol.c does. */
+	SIM_PORT_SetInput(&PORTD, PIN2_bm);
+	IRRC_Init(&decoder, &TCD0, &PORTD, PIN2_bm,
+	          EVSYS_CHMUX_PORTD_PIN2_gc, 0,
+	          &DMA.CH0, DMA_CH_TRIGSRC_TCD0_CCA_gc);
+	nextProcess = SIM_GetCycles() + (uint64_t) PROCESS_INTERVAL_US * CYCLES_PER_US;
+
+	for (scale = SCALE_MIN; scale <= SCALE_MAX; scale += SCALE_STEP) {
+		bool all = Scale_Run(scale, &wrong);
+
+		if ((scale >= 100 - SCALE_BAND) && (scale <= 100 + SCALE_BAND)) {
+			inBand &= all;
+		}
+	}
+	printf("scenario=scale_sweep band=+-%u%% stretch_us=%u jitter_us=%u in_band=%s wrong=%u result=%s\n",
+	       SCALE_BAND, MARK_STRETCH_US, JITTER_US, inBand ? "all" : "missed", wrong,
+	       (inBand && (wrong == 0)) ? "pass" : "fail");
+	success &= inBand && (wrong == 0);
+
+	success &= Noise_Run();
+
+	Line_Run((uint64_t) PROCESS_INTERVAL_US * CYCLES_PER_US);
+	printf("scenario=edges injected=%lu captured=%lu frames=%u errors=%u result=%s\n",
+	       (unsigned long) edgesInjected, (unsigned long) decoder.edgeCount,
+	       decoder.frameCount, decoder.errorCount,
+	       (decoder.edgeCount == edgesInjected) ? "pass" : "fail");
+	success &= (decoder.edgeCount == edgesInjected);
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
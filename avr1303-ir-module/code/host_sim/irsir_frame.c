@@ -0,0 +1,449 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host test of the IrDA SIR framing.
+ *
+ *      This program checks the IrDA SIR framing of IR_sir.c on the host:
+ *      IRSIR_EncodeFrame() against IRSIR_ReceiveChar(), and one frame over a
+ *      USART of the host simulator with the DMA link of IRSIR_Send() and
+ *      IRSIR_Poll(). IrDA mode runs as asynchronous mode on the simulator,
+ *      with the transmitter looped back to the receiver.
+ *
+ *      Tests:
+ *        - fcs: the FCS of "123456789" is 0x906E, and the FCS over a payload
+ *          and its transmitted FCS leaves the residue 0xF0B8.
+ *        - roundtrip: frames holding BOF (0xC0), EOF (0xC1) and CE (0x7D),
+ *          all 256 byte values in frames of IRSIR_MAX_PAYLOAD, payloads whose
+ *          FCS bytes must be escaped, and 0 to IRSIR_MAX_EXTRA_BOFS extra
+ *          BOFs. The frame must have the expected length, no BOF or EOF
+ *          between its ends, only control characters escaped, and must be
+ *          received with the same payload.
+ *        - abort: a frame ended by CE and EOF, a frame cut off by a BOF and
+ *          a frame with a bad FCS must each count one error and give no
+ *          payload, and the frame after each must be received.
+ *        - overrun: a payload of IRSIR_MAX_PAYLOAD is received, a longer one
+ *          counts one overrun and no error, and the frame after it is
+ *          received.
+ *        - link: IRSIR_Send() rejects an empty and a too long payload, and a
+ *          second frame while one is being sent, and a frame sent is
+ *          received by IRSIR_Poll() before LINK_TIMEOUT_CYCLES.
+ *
+ *      Each test prints one line of space separated key=value pairs, and the
+ *      program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding IR_sir.c. The simulator is
+ *      shared with AVR1307, and the DMA model needs a program linked with
+ *      -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -Wno-attributes -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/irsir_frame.c IR_sir.c IR_driver.c -o irsir_frame
+ *        ./irsir_frame
+ *
+ * \par Application note:
+ *      AVR1303: Use and configuration of IR communication module
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 619 $
+ * $Date: 2007-08-31 10:49:16 +0200 (fr, 31 aug 2007) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "IR_sir.h"
+#include "sim.h"
+
+/*! Baud rate select value of the link, 117.6 kbit/s at 32 MHz. */
+#define LINK_BSEL            16
+
+/*! CPU cycles the link frame may take, twice a frame of escaped bytes. */
+#define LINK_TIMEOUT_CYCLES  ( 2UL * IRSIR_TX_BUFFER_SIZE * 10 * 16 * ( LINK_BSEL + 1 ) )
+
+/*! CPU cycles between calls to IRSIR_Poll(). */
+#define POLL_CYCLES          1000
+
+/*! Size of the frame buffer of the overrun test. */
+#define LONG_FRAME_SIZE      256
+
+/*! Number of entries of a table. */
+#define COUNT( _table )      ( sizeof(_table) / sizeof((_table)[0]) )
+
+
+/*! \brief Test if a character must be escaped. */
+static bool Is_Control(uint8_t data)
+{
+	return ( data == IRSIR_BOF ) || ( data == IRSIR_EOF ) || ( data == IRSIR_CE );
+}
+
+
+/*! \brief The FCS sent after a payload. */
+static uint16_t Payload_FCS(const uint8_t * payload, uint8_t length)
+{
+	uint16_t fcs = IRSIR_FCS_INIT;
+
+	while ( length-- != 0 ) {
+		fcs = IRSIR_UpdateFCS( fcs, *payload++ );
+	}
+	return ~fcs;
+}
+
+
+/*! \brief Feed characters to a receiver.
+ *
+ *  \return  The length of the last frame completed, zero if none.
+ */
+static uint8_t Receive(IRSIR_Receiver_t * receiver, const uint8_t * frame,
+                       uint16_t length)
+{
+	uint8_t received = 0;
+	uint16_t i;
+
+	for ( i = 0; i < length; i++ ) {
+		uint8_t payloadLength = IRSIR_ReceiveChar( receiver, frame[i] );
+
+		if ( payloadLength != 0 ) {
+			received = payloadLength;
+		}
+	}
+	return received;
+}
+
+
+/*! \brief Check the escaping and length of an encoded frame.
+ *
+ *  \return  True if the frame starts with 1 + extraBofs BOFs, ends with one
+ *           EOF, has neither between, escapes only control characters and
+ *           has the expected length.
+ */
+static bool Frame_Ok(const uint8_t * payload, uint8_t length, uint8_t extraBofs,
+                     const uint8_t * frame, uint8_t frameLength)
+{
+	uint16_t fcs = Payload_FCS( payload, length );
+	uint16_t expected = 1 + extraBofs + length + 2 + 1;
+	uint16_t i;
+
+	for ( i = 0; i < length; i++ ) {
+		expected += Is_Control( payload[i] );
+	}
+	expected += Is_Control( (uint8_t) fcs ) + Is_Control( (uint8_t) ( fcs >> 8 ) );
+	if ( ( frameLength != expected ) || ( frame[frameLength - 1] != IRSIR_EOF ) ) {
+		return false;
+	}
+	for ( i = 0; i <= extraBofs; i++ ) {
+		if ( frame[i] != IRSIR_BOF ) {
+			return false;
+		}
+	}
+	for ( ; i < frameLength - 1U; i++ ) {
+		if ( ( frame[i] == IRSIR_BOF ) || ( frame[i] == IRSIR_EOF ) ) {
+			return false;
+		}
+		if ( frame[i] == IRSIR_CE ) {
+			i++;
+			if ( !Is_Control( frame[i] ^ IRSIR_ESCAPE_XOR ) ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+/*! \brief Encode a payload, check the frame and receive it.
+ *
+ *  \return  True if the frame is right and received with the same payload.
+ */
+static bool Roundtrip(const uint8_t * payload, uint8_t length, uint8_t extraBofs)
+{
+	IRSIR_Receiver_t receiver;
+	uint8_t frame[IRSIR_TX_BUFFER_SIZE];
+	uint8_t frameLength;
+	uint8_t received;
+
+	frameLength = IRSIR_EncodeFrame( payload, length, extraBofs, frame );
+	if ( !Frame_Ok( payload, length, extraBofs, frame, frameLength ) ) {
+		return false;
+	}
+	IRSIR_ReceiverInit( &receiver );
+	received = Receive( &receiver, frame, frameLength );
+	return ( received == length ) &&
+	       ( memcmp( receiver.buffer, payload, length ) == 0 ) &&
+	       ( receiver.frameCount == 1 ) && ( receiver.errorCount == 0 );
+}
+
+
+/*! \brief The fcs test. */
+static bool Test_FCS(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint8_t payload[IRSIR_MAX_PAYLOAD + 2];
+	uint16_t checkFcs = Payload_FCS( check, sizeof(check) - 1 );
+	uint16_t residueErrors = 0;
+	uint8_t length;
+	bool ok;
+
+	for ( length = 1; length <= IRSIR_MAX_PAYLOAD; length++ ) {
+		uint16_t fcs;
+		uint8_t i;
+
+		for ( i = 0; i < length; i++ ) {
+			payload[i] = (uint8_t) ( length * 13 + i * 71 );
+		}
+		fcs = Payload_FCS( payload, length );
+		payload[length] = (uint8_t) fcs;
+		payload[length + 1] = (uint8_t) ( fcs >> 8 );
+		fcs = IRSIR_FCS_INIT;
+		for ( i = 0; i < length + 2; i++ ) {
+			fcs = IRSIR_UpdateFCS( fcs, payload[i] );
+		}
+		residueErrors += ( fcs != IRSIR_FCS_GOOD );
+	}
+
+	ok = ( checkFcs == 0x906E ) && ( residueErrors == 0 );
+	printf("test=fcs check=0x%04X expected=0x906E residue_errors=%u result=%s\n",
+	       checkFcs, residueErrors, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+/*! \brief The roundtrip test. */
+static bool Test_Roundtrip(void)
+{
+	static const uint8_t controls[] = { IRSIR_BOF, IRSIR_EOF, IRSIR_CE };
+	uint8_t payload[IRSIR_MAX_PAYLOAD];
+	uint16_t frames = 0;
+	uint16_t failures = 0;
+	uint8_t fcsEscapes = 0;
+	uint32_t value;
+	uint8_t extraBofs;
+	uint8_t i;
+	bool ok;
+
+	for ( extraBofs = 0; extraBofs <= IRSIR_MAX_EXTRA_BOFS; extraBofs++ ) {
+		/* Each control character alone, and all of them together. */
+		for ( i = 0; i < COUNT(controls); i++ ) {
+			failures += !Roundtrip( &controls[i], 1, extraBofs );
+			frames++;
+		}
+		failures += !Roundtrip( controls, COUNT(controls), extraBofs );
+		frames++;
+
+		/* All byte values. */
+		for ( value = 0; value < 256; value += IRSIR_MAX_PAYLOAD ) {
+			for ( i = 0; i < IRSIR_MAX_PAYLOAD; i++ ) {
+				payload[i] = (uint8_t) ( value + i );
+			}
+			failures += !Roundtrip( payload, IRSIR_MAX_PAYLOAD, extraBofs );
+			frames++;
+		}
+
+		/* Every byte escaped. */
+		memset( payload, IRSIR_CE, sizeof(payload) );
+		failures += !Roundtrip( payload, IRSIR_MAX_PAYLOAD, extraBofs );
+		frames++;
+	}
+
+	/* Payloads whose low or high FCS byte is a control character. */
+	for ( value = 0; ( value < 0x10000 ) && ( fcsEscapes != 0x03 ); value++ ) {
+		uint16_t fcs;
+
+		payload[0] = (uint8_t) value;
+		payload[1] = (uint8_t) ( value >> 8 );
+		fcs = Payload_FCS( payload, 2 );
+		if ( !( fcsEscapes & 0x01 ) && Is_Control( (uint8_t) fcs ) ) {
+			fcsEscapes |= 0x01;
+		} else if ( !( fcsEscapes & 0x02 ) && Is_Control( (uint8_t) ( fcs >> 8 ) ) ) {
+			fcsEscapes |= 0x02;
+		} else {
+			continue;
+		}
+		failures += !Roundtrip( payload, 2, 0 );
+		frames++;
+	}
+
+	ok = ( failures == 0 ) && ( fcsEscapes == 0x03 );
+	printf("test=roundtrip frames=%u failures=%u fcs_escapes=%u result=%s\n",
+	       frames, failures, fcsEscapes, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+/*! \brief The abort test. */
+static bool Test_Abort(void)
+{
+	static const uint8_t payload[] = { 0x12, IRSIR_CE, 0x34, IRSIR_BOF, 0x56 };
+	static const uint8_t abortSequence[] = { IRSIR_CE, IRSIR_EOF };
+	IRSIR_Receiver_t receiver;
+	uint8_t frame[IRSIR_TX_BUFFER_SIZE];
+	uint8_t frameLength;
+	uint8_t aborted = 0;
+	uint8_t cut = 0;
+	uint8_t badFcs = 0;
+	uint8_t next[3];
+	uint16_t errors[3];
+	bool ok = true;
+
+	frameLength = IRSIR_EncodeFrame( payload, sizeof(payload), 0, frame );
+	IRSIR_ReceiverInit( &receiver );
+
+	/* Everything but the FCS and EOF, then the abort sequence. */
+	aborted = Receive( &receiver, frame, frameLength - 3 );
+	aborted |= Receive( &receiver, abortSequence, sizeof(abortSequence) );
+	next[0] = Receive( &receiver, frame, frameLength );
+	errors[0] = receiver.errorCount;
+
+	/* Half a frame, cut off by the next one. */
+	cut = Receive( &receiver, frame, frameLength / 2 );
+	next[1] = Receive( &receiver, frame, frameLength );
+	errors[1] = receiver.errorCount;
+
+	/* A flipped bit. */
+	frame[2] ^= 0x01;
+	badFcs = Receive( &receiver, frame, frameLength );
+	frame[2] ^= 0x01;
+	next[2] = Receive( &receiver, frame, frameLength );
+	errors[2] = receiver.errorCount;
+
+	ok = ( aborted == 0 ) && ( cut == 0 ) && ( badFcs == 0 ) &&
+	     ( next[0] == sizeof(payload) ) && ( next[1] == sizeof(payload) ) &&
+	     ( next[2] == sizeof(payload) ) &&
+	     ( memcmp( receiver.buffer, payload, sizeof(payload) ) == 0 ) &&
+	     ( errors[0] == 1 ) && ( errors[1] == 2 ) && ( errors[2] == 3 ) &&
+	     ( receiver.frameCount == 3 );
+	printf("test=abort errors=%u,%u,%u frames=%u result=%s\n",
+	       errors[0], errors[1], errors[2], receiver.frameCount,
+	       ok ? "pass" : "fail");
+	return ok;
+}
+
+
+/*! \brief The overrun test. */
+static bool Test_Overrun(void)
+{
+	IRSIR_Receiver_t receiver;
+	uint8_t payload[IRSIR_MAX_PAYLOAD + 3];
+	uint8_t frame[LONG_FRAME_SIZE];
+	uint8_t frameLength;
+	uint8_t full;
+	uint8_t longer;
+	uint8_t next;
+	uint8_t i;
+	bool ok;
+
+	for ( i = 0; i < sizeof(payload); i++ ) {
+		payload[i] = (uint8_t) ( i * 7 + 1 );
+	}
+	IRSIR_ReceiverInit( &receiver );
+
+	frameLength = IRSIR_EncodeFrame( payload, IRSIR_MAX_PAYLOAD, 0, frame );
+	full = Receive( &receiver, frame, frameLength );
+
+	/* The FCS bytes fit in the buffer, one more byte does not. */
+	frameLength = IRSIR_EncodeFrame( payload, IRSIR_MAX_PAYLOAD + 1, 0, frame );
+	longer = Receive( &receiver, frame, frameLength );
+
+	frameLength = IRSIR_EncodeFrame( payload, 3, 0, frame );
+	next = Receive( &receiver, frame, frameLength );
+
+	ok = ( full == IRSIR_MAX_PAYLOAD ) && ( longer == 0 ) && ( next == 3 ) &&
+	     ( receiver.overrunCount == 1 ) && ( receiver.errorCount == 0 ) &&
+	     ( receiver.frameCount == 2 );
+	printf("test=overrun full=%u longer=%u next=%u overruns=%u errors=%u "
+	       "result=%s\n", full, longer, next, receiver.overrunCount,
+	       receiver.errorCount, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+/*! \brief The link test. */
+static bool Test_Link(void)
+{
+	static IRSIR_Link_t link;
+	uint8_t payload[IRSIR_MAX_PAYLOAD + 1];
+	uint64_t start;
+	uint32_t elapsed = 0;
+	bool empty;
+	bool tooLong;
+	bool sent;
+	bool busy;
+	uint8_t received = 0;
+	uint8_t i;
+	bool ok;
+
+	for ( i = 0; i < sizeof(payload); i++ ) {
+		payload[i] = (uint8_t) ( 0xBE + i );
+	}
+	IRSIR_LinkInit( &link, &USARTC0, LINK_BSEL, 0,
+	                &DMA.CH0, DMA_CH_TRIGSRC_USARTC0_DRE_gc,
+	                &DMA.CH1, DMA_CH_TRIGSRC_USARTC0_RXC_gc );
+	SIM_USART_SetLoopback( &USARTC0, true );
+
+	empty = IRSIR_Send( &link, payload, 0 );
+	tooLong = IRSIR_Send( &link, payload, IRSIR_MAX_PAYLOAD + 1 );
+	start = SIM_GetCycles();
+	sent = IRSIR_Send( &link, payload, IRSIR_MAX_PAYLOAD );
+	busy = IRSIR_Send( &link, payload, 1 );
+
+	while ( ( received == 0 ) && ( elapsed < LINK_TIMEOUT_CYCLES ) ) {
+		SIM_Run( POLL_CYCLES );
+		received = IRSIR_Poll( &link );
+		elapsed = (uint32_t) ( SIM_GetCycles() - start );
+	}
+
+	ok = !empty && !tooLong && sent && !busy &&
+	     ( received == IRSIR_MAX_PAYLOAD ) &&
+	     ( memcmp( IRSIR_GetPayload( &link ), payload, IRSIR_MAX_PAYLOAD ) == 0 );
+	printf("test=link empty=%u too_long=%u sent=%u busy=%u received=%u "
+	       "cycles=%lu result=%s\n", empty, tooLong, sent, busy, received,
+	       (unsigned long) elapsed, ok ? "pass" : "fail");
+	return ok;
+}
+
+
+int main(void)
+{
+	bool success = true;
+
+	success &= Test_FCS();
+	success &= Test_Roundtrip();
+	success &= Test_Abort();
+	success &= Test_Overrun();
+	success &= Test_Link();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
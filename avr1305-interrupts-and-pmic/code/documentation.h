@@ -16,6 +16,14 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section stackinfo Stack Monitoring
+ * With nested interrupt levels, the stack must hold main() and one handler of
+ * each level on top of each other. stack_monitor.c measures the stack use at
+ * run time: STACK_GetMaxDepth() gives the high-water mark, and with
+ * STACK_MONITOR_ENABLED defined, STACK_GetISRDepth() gives the depth at entry of
+ * each instrumented handler. tools/stack_report.c calculates the worst case at
+ * build time from the avr-gcc -fstack-usage output and the call graph. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
@@ -50,6 +50,12 @@
  *****************************************************************************/
 #include "avr_compiler.h"
 #include "pmic_driver.h"
+#include "stack_monitor.h"
+
+/*! \brief Stack monitor numbers of the interrupt handlers. */
+#define STACK_ISR_CCA  0
+#define STACK_ISR_CCB  1
+#define STACK_ISR_CCC  2
 
 /*! \brief Counter incremented in Compare Match C handler. */
 volatile uint8_t compareMatchCCount = 0;
@@ -68,6 +74,7 @@ volatile uint8_t compareMatchACount = 0;
  */
 ISR(TCC0_CCA_vect)
 {
+	STACK_ISR_ENTRY(STACK_ISR_CCA);
 	++compareMatchACount;
 }
 
@@ -79,6 +86,7 @@ ISR(TCC0_CCA_vect)
  */
 ISR(TCC0_CCB_vect)
 {
+	STACK_ISR_ENTRY(STACK_ISR_CCB);
 	++compareMatchBCount;
 }
 
@@ -90,6 +98,7 @@ ISR(TCC0_CCB_vect)
  */
 ISR(TCC0_CCC_vect)
 {
+	STACK_ISR_ENTRY(STACK_ISR_CCC);
 	++compareMatchCCount;
 }
 
@@ -108,10 +117,15 @@ ISR(TCC0_CCC_vect)
  *  Compare macth C (0x70) triggers a high level interrupt.
  *
  *  When setup is complete, the main program enters an infinite loop, and the
- *  interrupt handling and counter values can be observed.
+ *  interrupt handling and counter values can be observed. The stack high-water
+ *  mark can be read with STACK_GetMaxDepth(), and with STACK_MONITOR_ENABLED
+ *  defined, the stack depth at entry of each handler with STACK_GetISRDepth().
  */
 int main( void )
 {
+	/* Paint the stack before any interrupt can use it. */
+	STACK_Paint();
+
 	/* Enable all interrupt levels. */
 	PMIC_SetVectorLocationToApplication();
 	PMIC_EnableLowLevel();
@@ -0,0 +1,133 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA stack monitor source file.
+ *
+ *      This file contains the function implementations of the stack monitor.
+ *      See stack_monitor.h.
+ *
+ * \par Application note:
+ *      AVR1305: XMEGA Interrupts and the Programmable Multi-level Interrupt Controller
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+#include "stack_monitor.h"
+
+/*! \brief Deepest stack seen at entry of each interrupt handler. */
+uint16_t STACK_isrDepth[STACK_NUM_ISRS];
+
+
+
+/*! \brief Fill the free stack area with the paint pattern.
+ *
+ *  Call this first in main(), before interrupts are enabled. Everything
+ *  from STACK_LIMIT up to the current stack pointer is painted, which is
+ *  all the stack not in use yet. The bytes used by the startup code and
+ *  main() itself stay unpainted, and are counted as used.
+ */
+void STACK_Paint( void )
+{
+	uint8_t * p = STACK_LIMIT;
+	uint8_t * sp = STACK_GetSP();
+	uint8_t i;
+
+	while ( p < sp ) {
+		*p++ = STACK_PAINT_PATTERN;
+	}
+
+	for ( i = 0; i < STACK_NUM_ISRS; i++ ) {
+		STACK_isrDepth[i] = 0;
+	}
+}
+
+
+
+/*! \brief Get the number of stack bytes never used since STACK_Paint().
+ *
+ *  The painted area is searched from STACK_LIMIT for the first byte that
+ *  has been overwritten. A pushed byte that happens to equal the pattern
+ *  makes the result up to that many bytes too large, which in practice is
+ *  a few bytes at most; leave some margin.
+ *
+ *  \return  Number of bytes between STACK_LIMIT and the deepest point the
+ *           stack has reached.
+ */
+uint16_t STACK_GetUnused( void )
+{
+	const uint8_t * p = STACK_LIMIT;
+
+	while ( ( p <= STACK_TOP ) && ( *p == STACK_PAINT_PATTERN ) ) {
+		p++;
+	}
+	return p - STACK_LIMIT;
+}
+
+
+
+/*! \brief Get the deepest stack use since STACK_Paint().
+ *
+ *  \return  High-water mark of the stack in bytes.
+ */
+uint16_t STACK_GetMaxDepth( void )
+{
+	return ( STACK_TOP - STACK_LIMIT + 1 ) - STACK_GetUnused();
+}
+
+
+
+/*! \brief Get the deepest stack seen at entry of an interrupt handler.
+ *
+ *  Only handlers using STACK_ISR_ENTRY() in a build with
+ *  STACK_MONITOR_ENABLED defined are sampled.
+ *
+ *  \param isr  Handler number, less than STACK_NUM_ISRS.
+ *
+ *  \return  Stack depth in bytes, 0 if the handler has not run.
+ */
+uint16_t STACK_GetISRDepth( uint8_t isr )
+{
+	uint16_t depth;
+
+	/* The handler may update the value while we read it. */
+	AVR_ENTER_CRITICAL_REGION();
+	depth = STACK_isrDepth[isr];
+	AVR_LEAVE_CRITICAL_REGION();
+
+	return depth;
+}
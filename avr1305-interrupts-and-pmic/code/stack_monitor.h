@@ -0,0 +1,155 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA stack monitor header file.
+ *
+ *      This file contains the function prototypes and macros of the stack
+ *      monitor. The stack monitor measures how much of the stack an
+ *      application uses, so that the stack reservation can be sized from
+ *      measurements instead of guesses.
+ *
+ *      The free stack area is filled with a known pattern at startup
+ *      (STACK_Paint()). The deepest point the stack has reached since then is
+ *      found by looking for the first overwritten byte (STACK_GetMaxDepth()).
+ *      In instrumented builds, each interrupt handler can also sample the stack
+ *      pointer at entry (STACK_ISR_ENTRY()), which shows how deep the stack was
+ *      when the handler started, for each handler separately.
+ *
+ *      The measured depths complement the worst-case analysis of
+ *      tools/stack_report.c, which only sees what the call graph shows.
+ *
+ * \par Application note:
+ *      AVR1305: XMEGA Interrupts and the Programmable Multi-level Interrupt Controller
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#include "avr_compiler.h"
+
+/* Definitions of macros. */
+
+/*! \brief Pattern the free stack area is filled with. */
+#define STACK_PAINT_PATTERN  0xC5
+
+#ifndef STACK_NUM_ISRS
+/*! \brief Number of interrupt handlers that can be sampled. */
+#define STACK_NUM_ISRS  8
+#endif
+
+#if defined( __ICCAVR__ )
+
+/* IAR keeps return addresses on RSTACK, which is what SP points into, and
+ * locals on the separate CSTACK. Only RSTACK is monitored.
+ */
+#pragma segment="RSTACK"
+
+/*! \brief Lowest address the stack may grow to. */
+#define STACK_LIMIT  ( (uint8_t *) __segment_begin( "RSTACK" ) )
+
+/*! \brief Address of the first byte pushed on the stack. */
+#define STACK_TOP    ( (uint8_t *) __segment_end( "RSTACK" ) - 1 )
+
+#elif defined( __GNUC__ )
+
+/* Symbols from the linker script: end of .bss and .noinit, and initial
+ * stack pointer. The stack may grow down to _end when no heap is used.
+ */
+extern uint8_t _end;
+extern uint8_t __stack;
+
+/*! \brief Lowest address the stack may grow to. */
+#define STACK_LIMIT  ( &_end )
+
+/*! \brief Address of the first byte pushed on the stack. */
+#define STACK_TOP    ( &__stack )
+
+#endif
+
+/*! \brief Read the stack pointer. */
+#define STACK_GetSP()  ( (uint8_t *) ( SPL | ( (uint16_t) SPH << 8 ) ) )
+
+#ifdef STACK_MONITOR_ENABLED
+
+/*! \brief Sample the stack depth at interrupt handler entry.
+ *
+ *  Put first in the handler. The depth includes the registers the handler
+ *  saved in its prologue, but not what the handler itself uses later.
+ *
+ *  \param _isr  Handler number, less than STACK_NUM_ISRS.
+ */
+#define STACK_ISR_ENTRY( _isr )  STACK_Sample( (_isr) )
+
+#else
+
+#define STACK_ISR_ENTRY( _isr )
+
+#endif
+
+extern uint16_t STACK_isrDepth[STACK_NUM_ISRS];
+
+/* Prototype of functions. */
+
+void STACK_Paint( void );
+uint16_t STACK_GetMaxDepth( void );
+uint16_t STACK_GetUnused( void );
+uint16_t STACK_GetISRDepth( uint8_t isr );
+
+
+/*! \brief Record the current stack depth for an interrupt handler.
+ *
+ *  Use STACK_ISR_ENTRY() rather than calling this directly, so that the
+ *  calls go away when STACK_MONITOR_ENABLED is not defined.
+ *
+ *  \param isr  Handler number, less than STACK_NUM_ISRS.
+ */
+INLINE void STACK_Sample( uint8_t isr )
+{
+	uint16_t depth = STACK_TOP - STACK_GetSP();
+
+	/* Handlers of the same level never nest, so no other writer can
+	 * interfere.
+	 */
+	if ( depth > STACK_isrDepth[isr] ) {
+		STACK_isrDepth[isr] = depth;
+	}
+}
+
+#endif
@@ -0,0 +1,561 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Worst-case stack depth report for XMEGA applications.
+ *
+ *      This host program calculates the worst-case stack depth of an
+ *      application built with avr-gcc. It combines the frame sizes from the
+ *      -fstack-usage output (.su files) with the call graph, which it takes from
+ *      the disassembly of the linked application. It reports the deepest call
+ *      path from main() and from each interrupt handler, the worst case for
+ *      each interrupt level, and the sum over all levels, which is the
+ *      reservation needed when low, medium and high level handlers nest on top
+ *      of main().
+ *
+ *      Interrupt levels are set at run time, so they are given on the command
+ *      line, one -i option per handler, as level:vector. The level is lo, med,
+ *      hi or nmi, and the vector is the vector number or the handler name, e.g.
+ *      -i hi:27 or -i hi:__vector_27. Handlers found without a level are
+ *      listed, but left out of the sum.
+ *
+ *      The result is only an upper bound when the program has no recursion,
+ *      no indirect calls and no dynamic stack allocation. Each of these is
+ *      counted on the summary line, and should be zero. Functions without
+ *      stack usage data, typically assembler routines from libgcc, are
+ *      counted as their return address only and listed as missing.
+ *
+ *      Build with the drivers (USART, TWI, SPI, DMA, AES) compiled with
+ *      -fstack-usage, then run on the host. -p 3 sets the return address size
+ *      for devices with more than 128 KB of flash, such as the ATxmega128A1
+ *      the PMIC example runs on, where its handlers are vectors 16 to 18:
+ *        gcc -std=gnu99 -O2 tools/stack_report.c -o stack_report
+ *        avr-objdump -d app.elf > app.lst
+ *        ./stack_report -p 3 -i lo:16 -i med:17 -i hi:18 app.lst *.su
+ *
+ *      Each function prints one line of space separated key=value pairs,
+ *      followed by one line per interrupt level and one summary line.
+ *
+ *      tools/fixture holds a hand-written listing and .su files of the PMIC
+ *      example extended with a USART report, covering a tail jump, a libgcc
+ *      routine without stack usage data, a dynamic frame, an indirect call
+ *      and a handler without a level, and the expected report. Check the
+ *      program against it from tools/fixture with:
+ *        ../../stack_report -p 3 -i lo:16 -i med:17 -i hi:18 pmic_app.lst \
+ *            *.su | diff expected.txt -
+ *
+ * \par Application note:
+ *      AVR1305: XMEGA Interrupts and the Programmable Multi-level Interrupt Controller
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+/*! Largest number of functions handled. */
+#define REPORT_MAX_FUNCTIONS  4096
+
+/*! Largest number of call graph edges handled. */
+#define REPORT_MAX_EDGES      16384
+
+/*! Longest input line. */
+#define REPORT_LINE_SIZE      512
+
+/*! Interrupt levels, in nesting order. */
+typedef enum Report_Level_enum {
+	REPORT_LEVEL_MAIN,
+	REPORT_LEVEL_LO,
+	REPORT_LEVEL_MED,
+	REPORT_LEVEL_HI,
+	REPORT_LEVEL_NMI,
+	REPORT_NUM_LEVELS,
+	REPORT_LEVEL_NONE = REPORT_NUM_LEVELS,
+} Report_Level_t;
+
+/*! Names of the interrupt levels. */
+static const char * const levelNames[REPORT_NUM_LEVELS + 1] = {
+	"main", "lo", "med", "hi", "nmi", "unknown"
+};
+
+/*! Function in the call graph. */
+typedef struct Report_Function_struct {
+	char * name;
+	/*! Stack usage from the .su file, including the return address. */
+	uint16_t frame;
+	bool hasFrame;
+	bool dynamic;
+	bool indirect;
+	bool isr;
+	Report_Level_t level;
+	/*! First outgoing edge, or -1. */
+	int32_t firstEdge;
+	/*! 0 not visited, 1 being visited, 2 done. */
+	uint8_t state;
+	/*! Worst-case depth, valid when state is 2. */
+	uint32_t depth;
+	/*! Callee on the worst path, or -1. */
+	int32_t worstCallee;
+} Report_Function_t;
+
+/*! Call graph edge. */
+typedef struct Report_Edge_struct {
+	int32_t callee;
+	/*! Jump rather than call: the caller frame is already gone. */
+	bool tail;
+	int32_t next;
+} Report_Edge_t;
+
+static Report_Function_t functions[REPORT_MAX_FUNCTIONS];
+static uint32_t numFunctions;
+static Report_Edge_t edges[REPORT_MAX_EDGES];
+static uint32_t numEdges;
+
+/*! Bytes of return address for functions without stack usage data. */
+static uint8_t pcBytes = 2;
+
+static uint32_t recursions;
+static uint32_t indirectCalls;
+
+
+
+/*! \brief Find a function by name, adding it if not found.
+ *
+ *  \param name    Function name.
+ *  \param length  Length of the name.
+ *
+ *  \return  Index of the function.
+ */
+static int32_t Report_Function(const char * name, size_t length)
+{
+	uint32_t i;
+
+	for (i = 0; i < numFunctions; i++) {
+		if (strlen(functions[i].name) == length &&
+		    memcmp(functions[i].name, name, length) == 0) {
+			return i;
+		}
+	}
+	if (numFunctions == REPORT_MAX_FUNCTIONS) {
+		fprintf(stderr, "too many functions\n");
+		exit(1);
+	}
+	functions[i].name = malloc(length + 1);
+	memcpy(functions[i].name, name, length);
+	functions[i].name[length] = '\0';
+	functions[i].level = REPORT_LEVEL_NONE;
+	functions[i].firstEdge = -1;
+	functions[i].worstCallee = -1;
+	functions[i].isr = (strncmp(functions[i].name, "__vector_", 9) == 0) &&
+	                   isdigit((unsigned char) functions[i].name[9]);
+	numFunctions++;
+	return i;
+}
+
+
+/*! \brief Test if a function is a shared prologue or epilogue routine.
+ *
+ *  With -mcall-prologues, functions jump to these and get back by an
+ *  indirect jump. Their pushes are part of the caller's stack usage.
+ */
+static bool Report_IsPrologue(const char * name)
+{
+	return strncmp(name, "__prologue_saves__", 18) == 0 ||
+	       strncmp(name, "__epilogue_restores__", 21) == 0;
+}
+
+
+/*! \brief Add a call graph edge, unless it is already there.
+ *
+ *  \param caller  Calling function.
+ *  \param callee  Called function.
+ *  \param tail    Jump instead of call.
+ */
+static void Report_AddEdge(int32_t caller, int32_t callee, bool tail)
+{
+	int32_t e;
+
+	for (e = functions[caller].firstEdge; e >= 0; e = edges[e].next) {
+		if (edges[e].callee == callee && edges[e].tail == tail) {
+			return;
+		}
+	}
+	if (numEdges == REPORT_MAX_EDGES) {
+		fprintf(stderr, "too many call graph edges\n");
+		exit(1);
+	}
+	edges[numEdges].callee = callee;
+	edges[numEdges].tail = tail;
+	edges[numEdges].next = functions[caller].firstEdge;
+	functions[caller].firstEdge = numEdges;
+	numEdges++;
+}
+
+
+/*! \brief Read the call graph from an avr-objdump -d listing.
+ *
+ *  Function labels look like "0000012c <main>:". Calls and jumps are
+ *  found from the symbol objdump adds as a comment, e.g.
+ *  "call 0x164 ; 0x164 <foo>". Targets with an offset, "<foo+0x12>", are
+ *  branches within a function and are ignored.
+ *
+ *  \param file  Listing.
+ */
+static void Report_ReadListing(FILE * file)
+{
+	char line[REPORT_LINE_SIZE];
+	int32_t current = -1;
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char * p;
+		char * mnemonic;
+		char * target;
+		size_t length;
+		bool call;
+		bool jump;
+
+		/* Function label. */
+		if (isxdigit((unsigned char) line[0])) {
+			p = strstr(line, " <");
+			if (p != NULL && strstr(p, ">:") != NULL) {
+				p += 2;
+				current = Report_Function(p, strcspn(p, ">"));
+			}
+			continue;
+		}
+		if (current < 0 || Report_IsPrologue(functions[current].name)) {
+			continue;
+		}
+
+		/* Instruction: address, opcode bytes, mnemonic, operands. */
+		p = strchr(line, '\t');
+		if (p == NULL || (p = strchr(p + 1, '\t')) == NULL) {
+			continue;
+		}
+		mnemonic = p + 1;
+		length = strcspn(mnemonic, " \t\r\n");
+		if ((length == 5 && strncmp(mnemonic, "icall", 5) == 0) ||
+		    (length == 6 && strncmp(mnemonic, "eicall", 6) == 0) ||
+		    (length == 4 && strncmp(mnemonic, "ijmp", 4) == 0) ||
+		    (length == 5 && strncmp(mnemonic, "eijmp", 5) == 0)) {
+			functions[current].indirect = true;
+			continue;
+		}
+		call = (length == 4 && strncmp(mnemonic, "call", 4) == 0) ||
+		       (length == 5 && strncmp(mnemonic, "rcall", 5) == 0);
+		jump = (length == 3 && strncmp(mnemonic, "jmp", 3) == 0) ||
+		       (length == 4 && strncmp(mnemonic, "rjmp", 4) == 0);
+		if (!call && !jump) {
+			continue;
+		}
+
+		p = strchr(mnemonic, ';');
+		if (p == NULL || (target = strchr(p, '<')) == NULL) {
+			continue;
+		}
+		target++;
+		length = strcspn(target, "+>");
+		if (target[length] != '>') {
+			continue;
+		}
+		if (Report_IsPrologue(target)) {
+			continue;
+		}
+		{
+			int32_t callee = Report_Function(target, length);
+
+			if (callee != current) {
+				Report_AddEdge(current, callee, jump);
+			} else if (call) {
+				/* A call to the start of the function itself. */
+				recursions++;
+			}
+		}
+	}
+}
+
+
+/*! \brief Read the stack usage from a .su file.
+ *
+ *  Lines look like "usart_driver.c:123:6:USART_RXComplete<TAB>8<TAB>static".
+ *  avr-gcc includes the return address and saved registers in the value.
+ *
+ *  \param file  Stack usage file.
+ */
+static void Report_ReadStackUsage(FILE * file)
+{
+	char line[REPORT_LINE_SIZE];
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char * tab = strchr(line, '\t');
+		char * name;
+		int32_t f;
+
+		if (tab == NULL) {
+			continue;
+		}
+		*tab = '\0';
+		name = strrchr(line, ':');
+		name = (name != NULL) ? name + 1 : line;
+		f = Report_Function(name, strlen(name));
+		functions[f].frame = (uint16_t) strtoul(tab + 1, &tab, 10);
+		functions[f].hasFrame = true;
+		if (strstr(tab, "dynamic") != NULL) {
+			functions[f].dynamic = true;
+		}
+	}
+}
+
+
+/*! \brief Calculate the worst-case depth of a function and its callees.
+ *
+ *  \param f  Function.
+ *
+ *  \return  Worst-case depth in bytes.
+ */
+static uint32_t Report_Depth(int32_t f)
+{
+	Report_Function_t * function = &functions[f];
+	uint32_t frame;
+	int32_t e;
+
+	if (function->state == 2) {
+		return function->depth;
+	}
+	if (function->state == 1) {
+		/* Recursion, the depth has no bound. */
+		recursions++;
+		return 0;
+	}
+	function->state = 1;
+
+	frame = function->hasFrame ? function->frame : pcBytes;
+	function->depth = frame;
+	for (e = function->firstEdge; e >= 0; e = edges[e].next) {
+		uint32_t depth = Report_Depth(edges[e].callee);
+
+		/* After a tail jump, the callee takes over the return address,
+		 * and the frame of the caller is gone.
+		 */
+		if (!edges[e].tail) {
+			depth += frame;
+		}
+		if (depth > function->depth) {
+			function->depth = depth;
+			function->worstCallee = edges[e].callee;
+		}
+	}
+
+	function->state = 2;
+	return function->depth;
+}
+
+
+/*! \brief Print a function and its worst call path.
+ *
+ *  \param f  Function.
+ */
+static void Report_PrintFunction(int32_t f)
+{
+	int32_t p;
+
+	printf("function=%s level=%s depth=%lu path=",
+	       functions[f].name,
+	       levelNames[functions[f].level],
+	       (unsigned long) functions[f].depth);
+	for (p = f; p >= 0; p = functions[p].worstCallee) {
+		printf("%s%s", (p == f) ? "" : ">", functions[p].name);
+	}
+	printf("\n");
+}
+
+
+/*! \brief Set the level of an interrupt handler from a -i option.
+ *
+ *  \param option  level:vector.
+ *
+ *  \return  true if the option is valid.
+ */
+static bool Report_SetLevel(const char * option)
+{
+	const char * colon = strchr(option, ':');
+	char name[64];
+	uint8_t level;
+
+	if (colon == NULL) {
+		return false;
+	}
+	for (level = REPORT_LEVEL_LO; level < REPORT_NUM_LEVELS; level++) {
+		if (strlen(levelNames[level]) == (size_t) (colon - option) &&
+		    strncmp(option, levelNames[level], colon - option) == 0) {
+			break;
+		}
+	}
+	if (level == REPORT_NUM_LEVELS || colon[1] == '\0') {
+		return false;
+	}
+	if (isdigit((unsigned char) colon[1])) {
+		snprintf(name, sizeof(name), "__vector_%s", colon + 1);
+	} else {
+		snprintf(name, sizeof(name), "%s", colon + 1);
+	}
+	functions[Report_Function(name, strlen(name))].level = level;
+	return true;
+}
+
+
+/*! \brief Calculate and print the stack report.
+ *
+ *  \param argc  Number of arguments.
+ *  \param argv  Options, listing and .su files.
+ *
+ *  \return  0 on success, 1 on usage or input errors.
+ */
+int main(int argc, char * argv[])
+{
+	uint32_t worst[REPORT_NUM_LEVELS] = {0};
+	int32_t worstFunction[REPORT_NUM_LEVELS];
+	uint32_t total = 0;
+	uint32_t missing = 0;
+	uint32_t dynamic = 0;
+	uint32_t unassigned = 0;
+	int32_t mainFunction;
+	uint32_t i;
+	int arg;
+	bool listing = true;
+
+	/* Levels and the main function first, so they are found later. */
+	mainFunction = Report_Function("main", 4);
+	functions[mainFunction].level = REPORT_LEVEL_MAIN;
+
+	for (arg = 1; arg < argc; arg++) {
+		FILE * file;
+
+		if (strcmp(argv[arg], "-i") == 0 && arg + 1 < argc) {
+			if (!Report_SetLevel(argv[++arg])) {
+				fprintf(stderr, "bad level option: %s\n", argv[arg]);
+				return 1;
+			}
+			continue;
+		}
+		if (strcmp(argv[arg], "-p") == 0 && arg + 1 < argc) {
+			pcBytes = (uint8_t) atoi(argv[++arg]);
+			continue;
+		}
+
+		file = fopen(argv[arg], "r");
+		if (file == NULL) {
+			perror(argv[arg]);
+			return 1;
+		}
+		if (listing) {
+			Report_ReadListing(file);
+			listing = false;
+		} else {
+			Report_ReadStackUsage(file);
+		}
+		fclose(file);
+	}
+	if (listing) {
+		fprintf(stderr, "usage: %s [-p pcbytes] [-i level:vector]... "
+		        "listing file.su...\n", argv[0]);
+		return 1;
+	}
+
+	for (i = 0; i < REPORT_NUM_LEVELS; i++) {
+		worstFunction[i] = -1;
+	}
+	for (i = 0; i < numFunctions; i++) {
+		Report_Function_t * function = &functions[i];
+
+		if (function->level != REPORT_LEVEL_NONE) {
+			function->isr = (function->level != REPORT_LEVEL_MAIN);
+		}
+		if (function->level == REPORT_LEVEL_NONE && !function->isr) {
+			continue;
+		}
+		Report_Depth(i);
+		Report_PrintFunction(i);
+		if (function->level == REPORT_LEVEL_NONE) {
+			unassigned++;
+		} else if (function->depth > worst[function->level]) {
+			worst[function->level] = function->depth;
+			worstFunction[function->level] = i;
+		}
+	}
+
+	for (i = 0; i < REPORT_NUM_LEVELS; i++) {
+		printf("level=%s worst=%lu function=%s\n",
+		       levelNames[i],
+		       (unsigned long) worst[i],
+		       (worstFunction[i] >= 0) ? functions[worstFunction[i]].name : "-");
+		total += worst[i];
+	}
+
+	/* Everything that can be reached counts for the warnings. */
+	for (i = 0; i < numFunctions; i++) {
+		if (functions[i].state != 2) {
+			continue;
+		}
+		if (!functions[i].hasFrame) {
+			missing++;
+			fprintf(stderr, "missing stack usage: %s\n", functions[i].name);
+		}
+		if (functions[i].dynamic) {
+			dynamic++;
+		}
+		if (functions[i].indirect) {
+			indirectCalls++;
+		}
+	}
+
+	printf("total=%lu recursive=%lu indirect=%lu dynamic=%lu missing=%lu "
+	       "unassigned=%lu\n",
+	       (unsigned long) total,
+	       (unsigned long) recursions,
+	       (unsigned long) indirectCalls,
+	       (unsigned long) dynamic,
+	       (unsigned long) missing,
+	       (unsigned long) unassigned);
+
+	return 0;
+}
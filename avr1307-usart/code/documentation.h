@@ -16,6 +16,62 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section hostsim Host Simulation
+ * The drivers can also be built for a Linux x86-64 host, using the register
+ * headers and the simulator in the host_sim directory. See sim.h for what is
+ * modelled, usart_benchmark.c for a throughput and latency benchmark of
+ * the interrupt driven driver, multidrop_bus.c for a simulation of a
+ * multi-drop bus counting the interrupts of each node, idleframe_modbus.c
+ * for Modbus RTU style frames received by the idle line framing receiver,
+ * modbus_master.c for a Modbus master checking the Modbus RTU slave and
+ * its CPU load, rs485_halfduplex.c for the driver enable timing of the
+ * RS-485 transmitter, autobaud_trace.c for the auto-baud detector on
+ * jittered edge traces, and baud_table.c for the compile-time baud rate
+ * solver of usart_baud.h checked against USART_Baudrate_Solve(). \n
+ *
+ * \section multidrop Multi-drop Bus
+ * usart_multidrop.c implements a multi-drop bus with 9-bit characters and
+ * the multi-processor communication mode. A node is interrupted once for
+ * each frame sent to another node, and receives the payload of its own
+ * frames by DMA. See usart_multidrop.h for the frame format. \n
+ *
+ * \section idleframe Idle Line Framing
+ * usart_idleframe.c receives frames delimited by idle time on the line, like
+ * Modbus RTU, by DMA. The falling edges of RXD restart a Timer/Counter
+ * through the event system, and its compare match interrupt ends the frame
+ * once the line has been idle for the given time. The CPU is interrupted
+ * once per frame. Add event_system_driver.c to the project. \n
+ *
+ * \section modbus Modbus RTU Slave
+ * usart_modbus.c is a Modbus RTU slave for an RS-485 transceiver, built on
+ * the idle line framing receiver. Requests are executed on register and
+ * coil tables in application memory, and the response is sent by DMA. The
+ * driver enable pin is released by the TXC interrupt. Add usart_idleframe.c
+ * and event_system_driver.c to the project. \n
+ *
+ * \section rs485 RS-485 Half-duplex Transmitter
+ * usart_rs485.c sends queued frames by DMA on an RS-485 transceiver. The
+ * driver enable pin is set before the first start bit and released by the
+ * TXC interrupt after the last stop bit, and an optional turnaround gap
+ * between frames is timed by a Timer/Counter. The local echo can be
+ * suppressed by disabling the receiver while sending. \n
+ *
+ * \section autobaud Auto-baud Detection
+ * usart_autobaud.c finds the baud rate of a peer from a sync character
+ * (0x55). Its falling edges on RXD are captured by a Timer/Counter through
+ * the event system and copied by DMA, and the baud rate setting is found
+ * from the time of eight bits. The character after the sync character
+ * must be the given verify character, or the detector starts over. Add
+ * event_system_driver.c to the project. \n
+ *
+ * \section trace Interrupt Tracing
+ * trace_driver.c records the entry and exit of each ISR with a timestamp in
+ * a RAM ring, and exports it over a USART by DMA. To use it in the interrupt
+ * driven example, add trace_driver.c to the project and define
+ * TRACE_ENABLED. Without TRACE_ENABLED the trace macros are empty. The
+ * export is decoded on the host by tools/trace_decode.c. The ADC driver of
+ * AVR1300 and the TWI example of AVR1308 use the same macros. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
@@ -0,0 +1,441 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART auto-baud detection test for the host-side simulator.
+ *
+ *      This program runs the auto-baud detector on the host simulator with
+ *      jittered edge traces of the sync and verify characters, at standard and
+ *      odd baud rates.
+ *
+ *      USARTC0 receives 8 data bits, no parity and one stop bit. RXD (PC2) is
+ *      routed by event channel 0 to a capture on TCC0 channel A, and DMA channel
+ *      0 copies the capture values. For each rate, TRIALS traces are fed to RXD.
+ *      Each trace is the sync character 0x55 followed at once by the verify
+ *      character CR, as a peer would send it. The peer clock is off by up to
+ *      PEER_OFFSET_PERMILLE, and every edge is moved by up to JITTER_PERMILLE of
+ *      a bit time. Some traces start with a garbage character and a pause, which
+ *      the detector must skip. A pause longer than the timer range can look like
+ *      part of a sync character; the verify character then fails, and the peer
+ *      sends the pair again, up to ATTEMPTS times. In other traces, the first
+ *      sync character is followed by a wrong verify character, which must be
+ *      rejected before a second pair locks the detector.
+ *
+ *      The computation in the DMA interrupt is charged as CAPTURE_CYCLES and
+ *      SOLVE_CYCLES after the call, so the time from the last edge of the
+ *      sync character until the receiver is ready is an upper bound. It must
+ *      be less than the two bit times until the start bit of the verify
+ *      character, which at 32 MHz limits the detector to about 190 kbaud.
+ *      The test fails if a trace does not lock the detector, if a wrong
+ *      verify character is accepted, if the baud rate is off by more than
+ *      ERROR_LIMIT, or if the receiver was not ready in time.
+ *
+ *      Build and run from the directory holding usart_driver.c. The DMA model
+ *      needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=32000000UL -Ihost_sim -I. \
+ *            host_sim/sim.c host_sim/autobaud_trace.c usart_autobaud.c \
+ *            usart_driver.c event_system_driver.c -o autobaud_trace
+ *        ./autobaud_trace
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "usart_autobaud.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+#if F_CPU != 32000000UL
+#error The timing budget is for 32 MHz: build with -DF_CPU=32000000UL.
+#endif
+
+/*! Traces per baud rate. */
+#define TRIALS                 20
+
+/*! Lowest baud rate the detector is set up for. */
+#define MIN_BAUDRATE           1200
+
+/*! Character sent after the sync character. */
+#define VERIFY_CHAR            0x0D
+
+/*! Most the peer clock is off, in permille. */
+#define PEER_OFFSET_PERMILLE   10
+
+/*! Most an edge is moved from its place, in permille of a bit time. */
+#define JITTER_PERMILLE        30
+
+/*! Times the peer sends the sync and verify characters without answer. */
+#define ATTEMPTS               3
+
+/*! Largest baud rate error allowed, in units of 0.01 %. */
+#define ERROR_LIMIT            150
+
+/*! Estimated CPU cycles of AUTOBAUD_CaptureComplete() without the register
+ *  accesses: saving the registers and the interval sums and checks. */
+#define CAPTURE_CYCLES         150
+
+/*! Estimated CPU cycles of AUTOBAUD_Solve() with its 32-bit shifts, run
+ *  when the intervals are even. */
+#define SOLVE_CYCLES           150
+
+/*! CPU cycles charged for one pass of the main loop that finds nothing to do. */
+#define IDLE_CYCLES            16
+
+/*! Largest number of edges of a trace. */
+#define MAX_EDGES              64
+
+
+/*! The detector, in static data for the DMA. */
+AUTOBAUD_t detector;
+
+/*! Edge trace fed to RXD. */
+static SIM_Edge_t trace[MAX_EDGES];
+
+/*! Number of edges in the trace. */
+static uint16_t traceCount;
+
+/*! Time of the trace, and of its last edge, in CPU cycles from its start. */
+static uint64_t traceTime;
+static uint64_t traceLastEdge;
+
+/*! Level of RXD at the end of the trace. */
+static bool traceLevel;
+
+/*! Time of the last sync edge and of the verify start bit, from the trace start. */
+static uint64_t syncEdge;
+static uint64_t verifyEdge;
+
+/*! Cycle count when the trace was injected. */
+static uint64_t traceStart;
+
+/*! Time the receiver was last enabled, from the trace start. */
+static uint64_t readyTime;
+
+/*! Baud rates tested; the last five are not standard rates. */
+static const uint32_t testBaudrate[] = {
+	1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200,
+	7200, 31250, 74880, 100000, 187500,
+};
+
+/*! State of the pseudo-random generator. */
+static uint32_t testRandom = 1;
+
+
+/*! \brief Get a pseudo-random number from 0 to \a range - 1. */
+static uint16_t Test_Random(uint16_t range)
+{
+	testRandom = testRandom * 1103515245UL + 12345;
+	return (uint16_t) ((testRandom >> 16) % range);
+}
+
+
+/*! \brief Get a pseudo-random number from -\a limit to \a limit. */
+static int32_t Test_Spread(int32_t limit)
+{
+	return (int32_t) Test_Random(2 * limit + 1) - limit;
+}
+
+
+/*! \brief Append a level to the trace, from \a time on.
+ *
+ *  \param time    Time of the edge, in CPU cycles from the trace start.
+ *  \param jitter  Most the edge is moved, in CPU cycles.
+ *
+ *  \return  Time of the edge after jitter, or of the last edge if the level
+ *           does not change.
+ */
+static uint64_t Test_AddLevel(uint64_t time, bool level, uint32_t jitter)
+{
+	if (level == traceLevel) {
+		return traceLastEdge;
+	}
+	time += Test_Spread(jitter);
+	trace[traceCount].delay = (uint32_t) (time - traceLastEdge);
+	trace[traceCount].level = level;
+	traceCount++;
+	traceLastEdge = time;
+	traceLevel = level;
+	return time;
+}
+
+
+/*! \brief Append a character to the trace, starting at the trace time.
+ *
+ *  \param data       The character.
+ *  \param bitCycles  Bit time of the peer, in CPU cycles.
+ *  \param jitter     Most an edge is moved, in CPU cycles.
+ *
+ *  \return  Time of the start bit.
+ */
+static uint64_t Test_AddChar(uint8_t data, uint32_t bitCycles, uint32_t jitter)
+{
+	uint16_t levels = ((uint16_t) data << 1) | 0x200;
+	uint64_t start = traceTime;
+	uint8_t bit;
+
+	for (bit = 0; bit < 10; bit++) {
+		uint64_t edge = Test_AddLevel(traceTime, (levels >> bit) & 1, jitter);
+
+		if ((bit == 8) && (data == AUTOBAUD_SYNC_CHAR)) {
+			/* The last falling edge of the sync character. */
+			syncEdge = edge;
+		}
+		if (bit == 0) {
+			start = edge;
+		}
+		traceTime += bitCycles;
+	}
+	return start;
+}
+
+
+/*! \brief Feed the trace to RXD and wait until it has been received. */
+static void Test_RunTrace(void)
+{
+	traceStart = SIM_GetCycles();
+	SIM_USART_InjectEdges(&USARTC0, trace, traceCount);
+	while (!SIM_USART_IsIdle(&USARTC0)) {
+		SIM_Run(IDLE_CYCLES);
+	}
+	/* Let the receive interrupt run. */
+	SIM_Run(IDLE_CYCLES);
+}
+
+
+/*! \brief Get the bit time of a baud rate setting, in 1/128 CPU cycles. */
+static uint32_t Test_BitCycles128(const USART_Baud_t * setting)
+{
+	uint32_t d = setting->clk2x ? 8 : 16;
+
+	if (setting->bscale < 0) {
+		return ((d * setting->bsel) << (7 + setting->bscale)) + (d << 7);
+	}
+	return ((d * (setting->bsel + 1UL)) << setting->bscale) << 7;
+}
+
+
+/*! \brief Run the traces of one baud rate and report.
+ *
+ *  \return  True if every trace gave the expected result in time.
+ */
+static bool Test_Baudrate(uint32_t baudrate)
+{
+	uint16_t trials = 0;
+	uint16_t locks = 0;
+	uint16_t wrongLocks = 0;
+	uint16_t maxError = 0;
+	uint16_t maxPeerError = 0;
+	uint16_t garbage = 0;
+	uint16_t rejected = 0;
+	uint16_t retries = 0;
+	uint32_t readyCycles = 0;
+	bool readyLate = false;
+	uint8_t attempt;
+	uint32_t budget = (uint32_t) (2 * (uint64_t) F_CPU / baudrate);
+	uint32_t failures = detector.failures;
+	bool success;
+
+	for (trials = 0; trials < TRIALS; trials++) {
+		/* Peer bit time in 1/1024 cycles, and its jitter in cycles. */
+		uint64_t bit1024 = ((uint64_t) F_CPU << 10) / baudrate;
+		uint32_t bitCycles;
+		uint32_t jitter;
+		bool withGarbage = (trials % 4) == 1;
+		bool withWrong = (trials % 5) == 3;
+		uint32_t peerError;
+
+		bit1024 = bit1024 * (1000 + Test_Spread(PEER_OFFSET_PERMILLE)) / 1000;
+		bitCycles = (uint32_t) ((bit1024 + 512) >> 10);
+		jitter = bitCycles * JITTER_PERMILLE / 1000;
+
+		traceCount = 0;
+		traceTime = 2 * bitCycles;
+		traceLastEdge = 0;
+		traceLevel = true;
+
+		AUTOBAUD_Start(&detector);
+
+		if (withGarbage) {
+			uint8_t data;
+
+			/* Any character but the sync character, and a pause. */
+			do {
+				data = Test_Random(256);
+			} while (data == AUTOBAUD_SYNC_CHAR);
+			Test_AddChar(data, bitCycles, jitter);
+			traceTime += (10 + Test_Random(20)) * bitCycles;
+			garbage++;
+		}
+		if (withWrong) {
+			Test_AddChar(AUTOBAUD_SYNC_CHAR, bitCycles, jitter);
+			verifyEdge = Test_AddChar(VERIFY_CHAR ^ 0x20, bitCycles, jitter);
+			Test_RunTrace();
+			rejected += (detector.state == AUTOBAUD_STATE_SYNC);
+
+			traceCount = 0;
+			traceTime = 2 * bitCycles;
+			traceLastEdge = 0;
+		}
+		for (attempt = 0; attempt < ATTEMPTS; attempt++) {
+			if (attempt != 0) {
+				/* No answer: the peer tries again after a pause. */
+				traceCount = 0;
+				traceTime = 12 * bitCycles;
+				traceLastEdge = 0;
+				retries++;
+			}
+			Test_AddChar(AUTOBAUD_SYNC_CHAR, bitCycles, jitter);
+			verifyEdge = Test_AddChar(VERIFY_CHAR, bitCycles, jitter);
+			Test_RunTrace();
+			if (AUTOBAUD_IsLocked(&detector)) {
+				break;
+			}
+		}
+
+		if (!AUTOBAUD_IsLocked(&detector)) {
+			continue;
+		}
+		locks++;
+		if (readyTime - syncEdge > readyCycles) {
+			readyCycles = (uint32_t) (readyTime - syncEdge);
+		}
+		if (readyTime >= verifyEdge) {
+			readyLate = true;
+		}
+		if (detector.setting.error > maxError) {
+			maxError = detector.setting.error;
+		}
+		/* Error against the peer bit time, not the measured one. */
+		{
+			uint64_t programmed = Test_BitCycles128(&detector.setting) << 3;
+			uint64_t peer = bit1024;
+
+			peerError = (uint32_t) (((programmed > peer) ? programmed - peer : peer - programmed) *
+			                        10000 / peer);
+		}
+		if (peerError > maxPeerError) {
+			maxPeerError = peerError;
+		}
+		if (peerError > ERROR_LIMIT) {
+			wrongLocks++;
+		}
+	}
+
+	failures = detector.failures - failures;
+	success = (locks == TRIALS) && (wrongLocks == 0) && !readyLate &&
+	          (rejected == (TRIALS + 1) / 5) && (failures >= rejected) &&
+	          (failures <= rejected + retries);
+
+	printf("baudrate=%lu trials=%u locks=%u garbage=%u wrong_verify=%u "
+	       "verify_failures=%lu retries=%u "
+	       "error_max=%u peer_error_max=%u bsel=%u bscale=%d clk2x=%u "
+	       "ready_max_cycles=%lu budget_cycles=%lu result=%s\n",
+	       (unsigned long) baudrate,
+	       trials,
+	       locks,
+	       garbage,
+	       rejected,
+	       (unsigned long) failures,
+	       retries,
+	       maxError,
+	       maxPeerError,
+	       detector.setting.bsel,
+	       detector.setting.bscale,
+	       detector.setting.clk2x,
+	       (unsigned long) readyCycles,
+	       (unsigned long) budget,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Run the traces at each baud rate and report.
+ *
+ *  \return  0 if every baud rate passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	USART_Format_Set(&USARTC0, USART_CHSIZE_8BIT_gc, USART_PMODE_DISABLED_gc, false);
+	AUTOBAUD_Init(&detector, &USARTC0, &TCC0, 0, EVSYS_CHMUX_PORTC_PIN2_gc,
+	              &DMA.CH0, DMA_CH_TRIGSRC_TCC0_CCA_gc, MIN_BAUDRATE, VERIFY_CHAR,
+	              DMA_CH_TRNINTLVL_MED_gc, USART_RXCINTLVL_LO_gc);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm;
+	sei();
+
+	for (i = 0; i < sizeof(testBaudrate) / sizeof(testBaudrate[0]); i++) {
+		success &= Test_Baudrate(testBaudrate[i]);
+	}
+
+	printf("summary rates=%u trials=%u measurements=%u failures=%u "
+	       "dma_isr=%lu result=%s\n",
+	       (unsigned) (sizeof(testBaudrate) / sizeof(testBaudrate[0])),
+	       (unsigned) (TRIALS * sizeof(testBaudrate) / sizeof(testBaudrate[0])),
+	       detector.measurements,
+	       detector.failures,
+	       (unsigned long) SIM_GetIrqStats(DMA_CH0_vect_num)->count,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Capture values in: measure the sync character. */
+ISR(DMA_CH0_vect)
+{
+	AUTOBAUD_CaptureComplete(&detector);
+	SIM_Run(CAPTURE_CYCLES);
+
+	if (detector.state == AUTOBAUD_STATE_VERIFY) {
+		SIM_Run(SOLVE_CYCLES);
+		readyTime = SIM_GetCycles() - traceStart;
+	}
+}
+
+
+/*! \brief Character received before the detector is locked. */
+ISR(USARTC0_RXC_vect)
+{
+	AUTOBAUD_RXComplete(&detector);
+}
@@ -0,0 +1,2432 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA register definitions for the host-side simulator.
+ *
+ *      This file replaces the avr-libc <avr/io.h> when the drivers are built
+ *      for the host simulator. It provides the register structs, bit masks,
+ *      group configurations and module instances of ATxmega128A1 for the
+ *      modules modelled by the simulator (CPU, CLK, OSC, DFLL, RST, WDT, PMIC,
+ *      DMA, EVSYS, NVM, AES, PORT, VPORT, PORTCFG, AC, ADC, RTC, TWI, SPI,
+ *      TC0, AWEX, HIRES and USART), and for the 32-bit RTC and the battery backup module (RTC32
+ *      and VBAT) of ATxmega256A3B.
+ *
+ *      The module instances are placed at their data sheet offsets in a
+ *      simulated I/O memory area, so USARTC0, PORTC etc. are used exactly as on
+ *      the device. Each access to the area is trapped by the simulator, which
+ *      applies the side effects of the register, see sim.h.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SIM_AVR_IO_H
+#define SIM_AVR_IO_H
+
+#include <stdint.h>
+
+/*! Size of the simulated I/O memory area. */
+#define SIM_IO_SIZE  0x1000
+
+/*! Simulated I/O memory, set up by the simulator before main() is run. */
+extern uint8_t * SIM_ioSpace;
+
+/*! \brief Access a register or module at an I/O memory offset. */
+#define SIM_IO(_type, _offset)  (*(_type *) (SIM_ioSpace + (_offset)))
+
+typedef volatile uint8_t register8_t;
+typedef volatile uint16_t register16_t;
+typedef volatile uint32_t register32_t;
+
+
+/* CPU registers *************************************************************/
+
+#define CCP    SIM_IO(register8_t, 0x0034)  /*!< Configuration Change Protection. */
+#define RAMPD  SIM_IO(register8_t, 0x0038)  /*!< Ramp D. */
+#define RAMPX  SIM_IO(register8_t, 0x0039)  /*!< Ramp X. */
+#define RAMPY  SIM_IO(register8_t, 0x003A)  /*!< Ramp Y. */
+#define RAMPZ  SIM_IO(register8_t, 0x003B)  /*!< Ramp Z. */
+#define EIND   SIM_IO(register8_t, 0x003C)  /*!< Extended Indirect Jump. */
+#define SPL    SIM_IO(register8_t, 0x003D)  /*!< Stack Pointer Low. */
+#define SPH    SIM_IO(register8_t, 0x003E)  /*!< Stack Pointer High. */
+#define SREG   SIM_IO(register8_t, 0x003F)  /*!< Status Register. */
+
+#define CPU_I_bm  0x80  /*!< Global Interrupt Enable Flag bit mask. */
+#define CPU_I_bp  7     /*!< Global Interrupt Enable Flag bit position. */
+
+/*! CCP signatures. */
+typedef enum CCP_enum {
+	CCP_SPM_gc = (0x9D<<0),    /*!< SPM Instruction Protection. */
+	CCP_IOREG_gc = (0xD8<<0),  /*!< IO Register Protection. */
+} CCP_t;
+
+
+/* CLK - Clock System ********************************************************/
+
+/*! Clock System. */
+typedef struct CLK_struct {
+	register8_t CTRL;     /*!< Control Register. */
+	register8_t PSCTRL;   /*!< Prescaler Control Register. */
+	register8_t LOCK;     /*!< Lock register. */
+	register8_t RTCCTRL;  /*!< RTC Control Register. */
+} CLK_t;
+
+#define CLK  SIM_IO(CLK_t, 0x0040)
+
+/* CLK.CTRL bit masks and bit positions. */
+#define CLK_SCLKSEL_gm   0x07  /*!< System Clock Selection group mask. */
+#define CLK_SCLKSEL_gp   0     /*!< System Clock Selection group position. */
+
+/* CLK.PSCTRL bit masks and bit positions. */
+#define CLK_PSADIV_gm    0x7C  /*!< Prescaler A Division Factor group mask. */
+#define CLK_PSADIV_gp    2     /*!< Prescaler A Division Factor group position. */
+#define CLK_PSBCDIV_gm   0x03  /*!< Prescaler B and C Division factor group mask. */
+#define CLK_PSBCDIV_gp   0     /*!< Prescaler B and C Division factor group position. */
+
+/* CLK.LOCK bit masks and bit positions. */
+#define CLK_LOCK_bm      0x01  /*!< Clock System Lock bit mask. */
+
+/* CLK.RTCCTRL bit masks and bit positions. */
+#define CLK_RTCSRC_gm    0x0E  /*!< Clock Source group mask. */
+#define CLK_RTCSRC_gp    1     /*!< Clock Source group position. */
+#define CLK_RTCEN_bm     0x01  /*!< RTC Clock Source Enable bit mask. */
+
+/*! System Clock Selection. */
+typedef enum CLK_SCLKSEL_enum {
+	CLK_SCLKSEL_RC2M_gc = (0x00<<0),   /*!< Internal 2MHz RC Oscillator. */
+	CLK_SCLKSEL_RC32M_gc = (0x01<<0),  /*!< Internal 32MHz RC Oscillator. */
+	CLK_SCLKSEL_RC32K_gc = (0x02<<0),  /*!< Internal 32kHz RC Oscillator. */
+	CLK_SCLKSEL_XOSC_gc = (0x03<<0),   /*!< External Crystal Oscillator or Clock. */
+	CLK_SCLKSEL_PLL_gc = (0x04<<0),    /*!< Phase Locked Loop. */
+} CLK_SCLKSEL_t;
+
+/*! Prescaler A Division Factor. */
+typedef enum CLK_PSADIV_enum {
+	CLK_PSADIV_1_gc = (0x00<<2),    /*!< Divide by 1. */
+	CLK_PSADIV_2_gc = (0x01<<2),    /*!< Divide by 2. */
+	CLK_PSADIV_4_gc = (0x03<<2),    /*!< Divide by 4. */
+	CLK_PSADIV_8_gc = (0x05<<2),    /*!< Divide by 8. */
+	CLK_PSADIV_16_gc = (0x07<<2),   /*!< Divide by 16. */
+	CLK_PSADIV_32_gc = (0x09<<2),   /*!< Divide by 32. */
+	CLK_PSADIV_64_gc = (0x0B<<2),   /*!< Divide by 64. */
+	CLK_PSADIV_128_gc = (0x0D<<2),  /*!< Divide by 128. */
+	CLK_PSADIV_256_gc = (0x0F<<2),  /*!< Divide by 256. */
+	CLK_PSADIV_512_gc = (0x11<<2),  /*!< Divide by 512. */
+} CLK_PSADIV_t;
+
+/*! Prescaler B and C Division Factor. */
+typedef enum CLK_PSBCDIV_enum {
+	CLK_PSBCDIV_1_1_gc = (0x00<<0),  /*!< Divide B by 1 and C by 1. */
+	CLK_PSBCDIV_1_2_gc = (0x01<<0),  /*!< Divide B by 1 and C by 2. */
+	CLK_PSBCDIV_4_1_gc = (0x02<<0),  /*!< Divide B by 4 and C by 1. */
+	CLK_PSBCDIV_2_2_gc = (0x03<<0),  /*!< Divide B by 2 and C by 2. */
+} CLK_PSBCDIV_t;
+
+/*! RTC Clock Source. */
+typedef enum CLK_RTCSRC_enum {
+	CLK_RTCSRC_ULP_gc = (0x00<<1),     /*!< 1kHz from internal 32kHz ULP. */
+	CLK_RTCSRC_TOSC_gc = (0x01<<1),    /*!< 1kHz from 32kHz crystal oscillator on TOSC. */
+	CLK_RTCSRC_RCOSC_gc = (0x02<<1),   /*!< 1kHz from internal 32kHz RC oscillator. */
+	CLK_RTCSRC_TOSC32_gc = (0x05<<1),  /*!< 32kHz from 32kHz crystal oscillator on TOSC. */
+} CLK_RTCSRC_t;
+
+
+/* OSC - Oscillator **********************************************************/
+
+/*! Oscillator. */
+typedef struct OSC_struct {
+	register8_t CTRL;      /*!< Control Register. */
+	register8_t STATUS;    /*!< Status Register. */
+	register8_t XOSCCTRL;  /*!< External Oscillator Control Register. */
+	register8_t XOSCFAIL;  /*!< External Oscillator Failure Detection Register. */
+	register8_t RC32KCAL;  /*!< 32kHz Internal Oscillator Calibration Register. */
+	register8_t PLLCTRL;   /*!< PLL Control Register. */
+	register8_t DFLLCTRL;  /*!< DFLL Control Register. */
+} OSC_t;
+
+#define OSC  SIM_IO(OSC_t, 0x0050)
+
+/* OSC.CTRL bit masks and bit positions. */
+#define OSC_PLLEN_bm     0x10  /*!< PLL Enable bit mask. */
+#define OSC_XOSCEN_bm    0x08  /*!< External Oscillator Enable bit mask. */
+#define OSC_RC32KEN_bm   0x04  /*!< Internal 32kHz RC Oscillator Enable bit mask. */
+#define OSC_RC32MEN_bm   0x02  /*!< Internal 32MHz RC Oscillator Enable bit mask. */
+#define OSC_RC2MEN_bm    0x01  /*!< Internal 2MHz RC Oscillator Enable bit mask. */
+
+/* OSC.STATUS bit masks and bit positions. */
+#define OSC_PLLRDY_bm    0x10  /*!< PLL Ready bit mask. */
+#define OSC_XOSCRDY_bm   0x08  /*!< External Oscillator Ready bit mask. */
+#define OSC_RC32KRDY_bm  0x04  /*!< Internal 32kHz RC Oscillator Ready bit mask. */
+#define OSC_RC32MRDY_bm  0x02  /*!< Internal 32MHz RC Oscillator Ready bit mask. */
+#define OSC_RC2MRDY_bm   0x01  /*!< Internal 2MHz RC Oscillator Ready bit mask. */
+
+/* OSC.XOSCCTRL bit masks and bit positions. */
+#define OSC_FRQRANGE_gm  0xC0  /*!< Frequency Range group mask. */
+#define OSC_FRQRANGE_gp  6     /*!< Frequency Range group position. */
+#define OSC_X32KLPM_bm   0x20  /*!< 32kHz XTAL OSC Low-power Mode bit mask. */
+#define OSC_XOSCSEL_gm   0x0F  /*!< External Oscillator Selection and Startup Time group mask. */
+#define OSC_XOSCSEL_gp   0     /*!< External Oscillator Selection and Startup Time group position. */
+
+/* OSC.XOSCFAIL bit masks and bit positions. */
+#define OSC_XOSCFDIF_bm  0x02  /*!< Failure Detection Interrupt Flag bit mask. */
+#define OSC_XOSCFDEN_bm  0x01  /*!< Failure Detection Enable bit mask. */
+
+/* OSC.PLLCTRL bit masks and bit positions. */
+#define OSC_PLLSRC_gm    0xC0  /*!< Clock Source group mask. */
+#define OSC_PLLSRC_gp    6     /*!< Clock Source group position. */
+#define OSC_PLLFAC_gm    0x1F  /*!< Multiplication Factor group mask. */
+#define OSC_PLLFAC_gp    0     /*!< Multiplication Factor group position. */
+
+/* OSC.DFLLCTRL bit masks and bit positions. */
+#define OSC_RC32MCREF_bm  0x02  /*!< 32MHz Calibration Reference bit mask. */
+#define OSC_RC2MCREF_bm   0x01  /*!< 2MHz Calibration Reference bit mask. */
+
+/*! Oscillator Frequency Range. */
+typedef enum OSC_FRQRANGE_enum {
+	OSC_FRQRANGE_04TO2_gc = (0x00<<6),   /*!< 0.4 - 2 MHz. */
+	OSC_FRQRANGE_2TO9_gc = (0x01<<6),    /*!< 2 - 9 MHz. */
+	OSC_FRQRANGE_9TO12_gc = (0x02<<6),   /*!< 9 - 12 MHz. */
+	OSC_FRQRANGE_12TO16_gc = (0x03<<6),  /*!< 12 - 16 MHz. */
+} OSC_FRQRANGE_t;
+
+/*! External Oscillator Selection and Startup Time. */
+typedef enum OSC_XOSCSEL_enum {
+	OSC_XOSCSEL_EXTCLK_gc = (0x00<<0),       /*!< External Clock - 6 CLK. */
+	OSC_XOSCSEL_32KHz_gc = (0x02<<0),        /*!< 32kHz TOSC - 32K CLK. */
+	OSC_XOSCSEL_XTAL_256CLK_gc = (0x03<<0),  /*!< 0.4-16MHz XTAL - 256 CLK. */
+	OSC_XOSCSEL_XTAL_1KCLK_gc = (0x07<<0),   /*!< 0.4-16MHz XTAL - 1K CLK. */
+	OSC_XOSCSEL_XTAL_16KCLK_gc = (0x0B<<0),  /*!< 0.4-16MHz XTAL - 16K CLK. */
+} OSC_XOSCSEL_t;
+
+/*! PLL Clock Source. */
+typedef enum OSC_PLLSRC_enum {
+	OSC_PLLSRC_RC2M_gc = (0x00<<6),   /*!< Internal 2MHz RC Oscillator. */
+	OSC_PLLSRC_RC32M_gc = (0x02<<6),  /*!< Internal 32MHz RC Oscillator. */
+	OSC_PLLSRC_XOSC_gc = (0x03<<6),   /*!< External Oscillator. */
+} OSC_PLLSRC_t;
+
+
+/* DFLL - DFLL ***************************************************************/
+
+/*! DFLL. */
+typedef struct DFLL_struct {
+	register8_t CTRL;         /*!< Control Register. */
+	register8_t reserved_0x01;
+	register8_t CALA;         /*!< Calibration Register A. */
+	register8_t CALB;         /*!< Calibration Register B. */
+	register8_t COMP0;        /*!< Oscillator Compare Register 0. */
+	register8_t COMP1;        /*!< Oscillator Compare Register 1. */
+	register8_t COMP2;        /*!< Oscillator Compare Register 2. */
+	register8_t reserved_0x07;
+} DFLL_t;
+
+#define DFLLRC32M  SIM_IO(DFLL_t, 0x0060)
+#define DFLLRC2M   SIM_IO(DFLL_t, 0x0068)
+
+/* DFLL.CTRL bit masks and bit positions. */
+#define DFLL_ENABLE_bm   0x01  /*!< DFLL Enable bit mask. */
+
+/* DFLL.CALA bit masks and bit positions. */
+#define DFLL_CALL_gm     0x7F  /*!< DFLL Calibration bits [6:0] group mask. */
+#define DFLL_CALL_gp     0     /*!< DFLL Calibration bits [6:0] group position. */
+
+/* DFLL.CALB bit masks and bit positions. */
+#define DFLL_CALH_gm     0x3F  /*!< DFLL Calibration bits [12:7] group mask. */
+#define DFLL_CALH_gp     0     /*!< DFLL Calibration bits [12:7] group position. */
+
+
+/* RST - Reset ***************************************************************/
+
+/*! Reset. */
+typedef struct RST_struct {
+	register8_t STATUS;  /*!< Status Register. */
+	register8_t CTRL;    /*!< Control Register. */
+} RST_t;
+
+#define RST  SIM_IO(RST_t, 0x0078)
+
+/* RST.STATUS bit masks and bit positions. */
+#define RST_SDRF_bm   0x40  /*!< Spike Detection Reset Flag bit mask. */
+#define RST_SRF_bm    0x20  /*!< Software Reset Flag bit mask. */
+#define RST_PDIRF_bm  0x10  /*!< Programming and Debug Interface Reset Flag bit mask. */
+#define RST_WDRF_bm   0x08  /*!< Watchdog Reset Flag bit mask. */
+#define RST_BORF_bm   0x04  /*!< Brown-out Reset Flag bit mask. */
+#define RST_EXTRF_bm  0x02  /*!< External Reset Flag bit mask. */
+#define RST_PORF_bm   0x01  /*!< Power-on Reset Flag bit mask. */
+
+/* RST.CTRL bit masks and bit positions. */
+#define RST_SWRST_bm  0x01  /*!< Software Reset bit mask. */
+
+
+/* WDT - Watchdog Timer ******************************************************/
+
+/*! Watchdog Timer. */
+typedef struct WDT_struct {
+	register8_t CTRL;     /*!< Control. */
+	register8_t WINCTRL;  /*!< Windowed Mode Control. */
+	register8_t STATUS;   /*!< Status. */
+} WDT_t;
+
+#define WDT  SIM_IO(WDT_t, 0x0080)
+
+/* WDT.CTRL bit masks and bit positions. */
+#define WDT_PER_gm      0x3C  /*!< Period group mask. */
+#define WDT_PER_gp      2     /*!< Period group position. */
+#define WDT_ENABLE_bm   0x02  /*!< Enable bit mask. */
+#define WDT_CEN_bm      0x01  /*!< Change Enable bit mask. */
+
+/* WDT.WINCTRL bit masks and bit positions. */
+#define WDT_WPER_gm     0x3C  /*!< Windowed Mode Period group mask. */
+#define WDT_WPER_gp     2     /*!< Windowed Mode Period group position. */
+#define WDT_WEN_bm      0x02  /*!< Windowed Mode Enable bit mask. */
+#define WDT_WCEN_bm     0x01  /*!< Windowed Mode Change Enable bit mask. */
+
+/* WDT.STATUS bit masks and bit positions. */
+#define WDT_SYNCBUSY_bm 0x01  /*!< Synchronization busy bit mask. */
+
+/*! Period setting. */
+typedef enum WDT_PER_enum {
+	WDT_PER_8CLK_gc = (0x00<<2),    /*!< 8 cycles (8ms @ 3.3V). */
+	WDT_PER_16CLK_gc = (0x01<<2),   /*!< 16 cycles (16ms @ 3.3V). */
+	WDT_PER_32CLK_gc = (0x02<<2),   /*!< 32 cycles (32ms @ 3.3V). */
+	WDT_PER_64CLK_gc = (0x03<<2),   /*!< 64 cycles (64ms @ 3.3V). */
+	WDT_PER_128CLK_gc = (0x04<<2),  /*!< 128 cycles (0.125s @ 3.3V). */
+	WDT_PER_256CLK_gc = (0x05<<2),  /*!< 256 cycles (0.25s @ 3.3V). */
+	WDT_PER_512CLK_gc = (0x06<<2),  /*!< 512 cycles (0.5s @ 3.3V). */
+	WDT_PER_1KCLK_gc = (0x07<<2),   /*!< 1K cycles (1s @ 3.3V). */
+	WDT_PER_2KCLK_gc = (0x08<<2),   /*!< 2K cycles (2s @ 3.3V). */
+	WDT_PER_4KCLK_gc = (0x09<<2),   /*!< 4K cycles (4s @ 3.3V). */
+	WDT_PER_8KCLK_gc = (0x0A<<2),   /*!< 8K cycles (8s @ 3.3V). */
+} WDT_PER_t;
+
+/*! Closed window period. */
+typedef enum WDT_WPER_enum {
+	WDT_WPER_8CLK_gc = (0x00<<2),    /*!< 8 cycles (8ms @ 3.3V). */
+	WDT_WPER_16CLK_gc = (0x01<<2),   /*!< 16 cycles (16ms @ 3.3V). */
+	WDT_WPER_32CLK_gc = (0x02<<2),   /*!< 32 cycles (32ms @ 3.3V). */
+	WDT_WPER_64CLK_gc = (0x03<<2),   /*!< 64 cycles (64ms @ 3.3V). */
+	WDT_WPER_128CLK_gc = (0x04<<2),  /*!< 128 cycles (0.125s @ 3.3V). */
+	WDT_WPER_256CLK_gc = (0x05<<2),  /*!< 256 cycles (0.25s @ 3.3V). */
+	WDT_WPER_512CLK_gc = (0x06<<2),  /*!< 512 cycles (0.5s @ 3.3V). */
+	WDT_WPER_1KCLK_gc = (0x07<<2),   /*!< 1K cycles (1s @ 3.3V). */
+	WDT_WPER_2KCLK_gc = (0x08<<2),   /*!< 2K cycles (2s @ 3.3V). */
+	WDT_WPER_4KCLK_gc = (0x09<<2),   /*!< 4K cycles (4s @ 3.3V). */
+	WDT_WPER_8KCLK_gc = (0x0A<<2),   /*!< 8K cycles (8s @ 3.3V). */
+} WDT_WPER_t;
+
+
+/* SLEEP - Sleep Controller **************************************************/
+
+/*! Sleep Controller. */
+typedef struct SLEEP_struct {
+	register8_t CTRL;  /*!< Control Register. */
+} SLEEP_t;
+
+#define SLEEP  SIM_IO(SLEEP_t, 0x0048)
+
+/* SLEEP.CTRL bit masks and bit positions. */
+#define SLEEP_SMODE_gm  0x0E  /*!< Sleep Mode group mask. */
+#define SLEEP_SMODE_gp  1     /*!< Sleep Mode group position. */
+#define SLEEP_SEN_bm    0x01  /*!< Sleep Enable bit mask. */
+
+/*! Sleep Mode. */
+typedef enum SLEEP_SMODE_enum {
+	SLEEP_SMODE_IDLE_gc = (0x00<<1),    /*!< Idle mode. */
+	SLEEP_SMODE_PDOWN_gc = (0x02<<1),   /*!< Power-down Mode. */
+	SLEEP_SMODE_PSAVE_gc = (0x03<<1),   /*!< Power-save Mode. */
+	SLEEP_SMODE_STDBY_gc = (0x06<<1),   /*!< Standby Mode. */
+	SLEEP_SMODE_ESTDBY_gc = (0x07<<1),  /*!< Extended Standby Mode. */
+} SLEEP_SMODE_t;
+
+
+/* PMIC - Programmable Multi-level Interrupt Controller **********************/
+
+/*! Programmable Multi-level Interrupt Controller. */
+typedef struct PMIC_struct {
+	register8_t STATUS;  /*!< Status Register. */
+	register8_t INTPRI;  /*!< Interrupt Priority. */
+	register8_t CTRL;    /*!< Control Register. */
+} PMIC_t;
+
+#define PMIC  SIM_IO(PMIC_t, 0x00A0)
+
+#define PMIC_NMIEX_bm     0x80  /*!< Non-maskable Interrupt Executing bit mask. */
+#define PMIC_HILVLEX_bm   0x04  /*!< High Level Interrupt Executing bit mask. */
+#define PMIC_MEDLVLEX_bm  0x02  /*!< Medium Level Interrupt Executing bit mask. */
+#define PMIC_LOLVLEX_bm   0x01  /*!< Low Level Interrupt Executing bit mask. */
+
+#define PMIC_RREN_bm      0x80  /*!< Round-Robin Priority Enable bit mask. */
+#define PMIC_IVSEL_bm     0x40  /*!< Interrupt Vector Select bit mask. */
+#define PMIC_HILVLEN_bm   0x04  /*!< High Level Enable bit mask. */
+#define PMIC_MEDLVLEN_bm  0x02  /*!< Medium Level Enable bit mask. */
+#define PMIC_LOLVLEN_bm   0x01  /*!< Low Level Enable bit mask. */
+
+
+/* NVM - Non Volatile Memory Controller **************************************/
+
+/*! Non-volatile Memory Controller. */
+typedef struct NVM_struct {
+	register8_t ADDR0;     /*!< Address Register 0. */
+	register8_t ADDR1;     /*!< Address Register 1. */
+	register8_t ADDR2;     /*!< Address Register 2. */
+	register8_t reserved_0x03;
+	register8_t DATA0;     /*!< Data Register 0. */
+	register8_t DATA1;     /*!< Data Register 1. */
+	register8_t DATA2;     /*!< Data Register 2. */
+	register8_t reserved_0x07;
+	register8_t reserved_0x08;
+	register8_t reserved_0x09;
+	register8_t CMD;       /*!< Command. */
+	register8_t CTRLA;     /*!< Control Register A. */
+	register8_t CTRLB;     /*!< Control Register B. */
+	register8_t INTCTRL;   /*!< Interrupt Control. */
+	register8_t reserved_0x0E;
+	register8_t STATUS;    /*!< Status. */
+	register8_t LOCKBITS;  /*!< Lock Bits. */
+} NVM_t;
+
+#define NVM  SIM_IO(NVM_t, 0x01C0)
+
+#define NVM_CMD  NVM.CMD  /*!< Command, as named by the production signature code. */
+
+/*! Offset of the production signature row in the signature row space. */
+#define PROD_SIGNATURES_START  0x0000
+
+/* NVM.CTRLA bit masks and bit positions. */
+#define NVM_CMDEX_bm     0x01  /*!< Command Execute bit mask. */
+#define NVM_CMDEX_bp     0
+
+/* NVM.CTRLB bit masks and bit positions. */
+#define NVM_EEMAPEN_bm   0x08  /*!< EEPROM Mapping Enable bit mask. */
+#define NVM_EEMAPEN_bp   3
+#define NVM_FPRM_bm      0x04  /*!< Flash Power Reduction Enable bit mask. */
+#define NVM_FPRM_bp      2
+#define NVM_EPRM_bm      0x02  /*!< EEPROM Power Reduction Enable bit mask. */
+#define NVM_EPRM_bp      1
+#define NVM_SPMLOCK_bm   0x01  /*!< SPM Lock bit mask. */
+#define NVM_SPMLOCK_bp   0
+
+/* NVM.INTCTRL bit masks and bit positions. */
+#define NVM_SPMLVL_gm    0x0C  /*!< SPM Interrupt Level group mask. */
+#define NVM_SPMLVL_gp    2
+#define NVM_EELVL_gm     0x03  /*!< EEPROM Interrupt Level group mask. */
+#define NVM_EELVL_gp     0
+
+/* NVM.STATUS bit masks and bit positions. */
+#define NVM_NVMBUSY_bm   0x80  /*!< Non-volatile Memory Busy bit mask. */
+#define NVM_NVMBUSY_bp   7
+#define NVM_FBUSY_bm     0x40  /*!< Flash Memory Busy bit mask. */
+#define NVM_FBUSY_bp     6
+#define NVM_EELOAD_bm    0x02  /*!< EEPROM Page Buffer Active Loading bit mask. */
+#define NVM_EELOAD_bp    1
+#define NVM_FLOAD_bm     0x01  /*!< Flash Page Buffer Active Loading bit mask. */
+#define NVM_FLOAD_bp     0
+
+/*! NVM Command. */
+typedef enum NVM_CMD_enum {
+	NVM_CMD_NO_OPERATION_gc = (0x00<<0),            /*!< No operation. */
+	NVM_CMD_READ_CALIB_ROW_gc = (0x02<<0),          /*!< Read calibration row. */
+	NVM_CMD_READ_USER_SIG_ROW_gc = (0x03<<0),       /*!< Read user signature row. */
+	NVM_CMD_READ_EEPROM_gc = (0x06<<0),             /*!< Read EEPROM. */
+	NVM_CMD_READ_FUSES_gc = (0x07<<0),              /*!< Read fuse byte. */
+	NVM_CMD_WRITE_LOCK_BITS_gc = (0x08<<0),         /*!< Write lock bits. */
+	NVM_CMD_ERASE_USER_SIG_ROW_gc = (0x18<<0),      /*!< Erase user signature row. */
+	NVM_CMD_WRITE_USER_SIG_ROW_gc = (0x1A<<0),      /*!< Write user signature row. */
+	NVM_CMD_ERASE_APP_gc = (0x20<<0),               /*!< Erase Application Section. */
+	NVM_CMD_ERASE_APP_PAGE_gc = (0x22<<0),          /*!< Erase Application Section page. */
+	NVM_CMD_LOAD_FLASH_BUFFER_gc = (0x23<<0),       /*!< Load Flash page buffer. */
+	NVM_CMD_WRITE_APP_PAGE_gc = (0x24<<0),          /*!< Write Application Section page. */
+	NVM_CMD_ERASE_WRITE_APP_PAGE_gc = (0x25<<0),    /*!< Erase-and-write Application Section page. */
+	NVM_CMD_ERASE_FLASH_BUFFER_gc = (0x26<<0),      /*!< Erase Flash page buffer. */
+	NVM_CMD_ERASE_BOOT_PAGE_gc = (0x2A<<0),         /*!< Erase Boot Section page. */
+	NVM_CMD_WRITE_BOOT_PAGE_gc = (0x2C<<0),         /*!< Write Boot Section page. */
+	NVM_CMD_ERASE_WRITE_BOOT_PAGE_gc = (0x2D<<0),   /*!< Erase-and-write Boot Section page. */
+	NVM_CMD_ERASE_EEPROM_gc = (0x30<<0),            /*!< Erase EEPROM. */
+	NVM_CMD_ERASE_EEPROM_PAGE_gc = (0x32<<0),       /*!< Erase EEPROM page. */
+	NVM_CMD_LOAD_EEPROM_BUFFER_gc = (0x33<<0),      /*!< Load EEPROM page buffer. */
+	NVM_CMD_WRITE_EEPROM_PAGE_gc = (0x34<<0),       /*!< Write EEPROM page. */
+	NVM_CMD_ERASE_WRITE_EEPROM_PAGE_gc = (0x35<<0), /*!< Erase-and-write EEPROM page. */
+	NVM_CMD_ERASE_EEPROM_BUFFER_gc = (0x36<<0),     /*!< Erase EEPROM page buffer. */
+	NVM_CMD_APP_CRC_gc = (0x38<<0),                 /*!< Generate Application section CRC. */
+	NVM_CMD_BOOT_CRC_gc = (0x39<<0),                /*!< Generate Boot Section CRC. */
+	NVM_CMD_FLASH_RANGE_CRC_gc = (0x3A<<0),         /*!< Generate Flash Range CRC. */
+} NVM_CMD_t;
+
+/*! SPM ready interrupt level. */
+typedef enum NVM_SPMLVL_enum {
+	NVM_SPMLVL_OFF_gc = (0x00<<2),  /*!< Interrupt disabled. */
+	NVM_SPMLVL_LO_gc = (0x01<<2),   /*!< Low level. */
+	NVM_SPMLVL_MED_gc = (0x02<<2),  /*!< Medium level. */
+	NVM_SPMLVL_HI_gc = (0x03<<2),   /*!< High level. */
+} NVM_SPMLVL_t;
+
+/*! EEPROM ready interrupt level. */
+typedef enum NVM_EELVL_enum {
+	NVM_EELVL_OFF_gc = (0x00<<0),  /*!< Interrupt disabled. */
+	NVM_EELVL_LO_gc = (0x01<<0),   /*!< Low level. */
+	NVM_EELVL_MED_gc = (0x02<<0),  /*!< Medium level. */
+	NVM_EELVL_HI_gc = (0x03<<0),   /*!< High level. */
+} NVM_EELVL_t;
+
+
+/* AES - AES Module **********************************************************/
+
+/*! AES Module. */
+typedef struct AES_struct {
+	register8_t CTRL;     /*!< AES Control Register. */
+	register8_t STATUS;   /*!< AES Status Register. */
+	register8_t STATE;    /*!< AES State Register. */
+	register8_t KEY;      /*!< AES Key Register. */
+	register8_t INTCTRL;  /*!< AES Interrupt Control Register. */
+} AES_t;
+
+#define AES  SIM_IO(AES_t, 0x00C0)
+
+/* AES.CTRL bit masks and bit positions. */
+#define AES_START_bm    0x80  /*!< Start/Run bit mask. */
+#define AES_START_bp    7
+#define AES_AUTO_bm     0x40  /*!< Auto Start Trigger bit mask. */
+#define AES_AUTO_bp     6
+#define AES_RESET_bm    0x20  /*!< AES Software Reset bit mask. */
+#define AES_RESET_bp    5
+#define AES_DECRYPT_bm  0x10  /*!< Decryption / Direction bit mask. */
+#define AES_DECRYPT_bp  4
+#define AES_XOR_bm      0x04  /*!< State XOR Load Enable bit mask. */
+#define AES_XOR_bp      2
+
+/* AES.STATUS bit masks and bit positions. */
+#define AES_ERROR_bm    0x80  /*!< AES Error bit mask. */
+#define AES_ERROR_bp    7
+#define AES_SRIF_bm     0x01  /*!< State Ready Interrupt Flag bit mask. */
+#define AES_SRIF_bp     0
+
+/* AES.INTCTRL bit masks and bit positions. */
+#define AES_INTLVL_gm   0x03  /*!< Interrupt level group mask. */
+#define AES_INTLVL_gp   0
+
+/*! Interrupt level. */
+typedef enum AES_INTLVL_enum {
+	AES_INTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt Disabled. */
+	AES_INTLVL_LO_gc = (0x01<<0),   /*!< Low Level. */
+	AES_INTLVL_MED_gc = (0x02<<0),  /*!< Medium Level. */
+	AES_INTLVL_HI_gc = (0x03<<0),   /*!< High Level. */
+} AES_INTLVL_t;
+
+
+/* PORT - I/O Port Configuration *********************************************/
+
+/*! I/O Ports. */
+typedef struct PORT_struct {
+	register8_t DIR;       /*!< I/O Port Data Direction. */
+	register8_t DIRSET;    /*!< I/O Port Data Direction Set. */
+	register8_t DIRCLR;    /*!< I/O Port Data Direction Clear. */
+	register8_t DIRTGL;    /*!< I/O Port Data Direction Toggle. */
+	register8_t OUT;       /*!< I/O Port Output. */
+	register8_t OUTSET;    /*!< I/O Port Output Set. */
+	register8_t OUTCLR;    /*!< I/O Port Output Clear. */
+	register8_t OUTTGL;    /*!< I/O Port Output Toggle. */
+	register8_t IN;        /*!< I/O port Input. */
+	register8_t INTCTRL;   /*!< Interrupt Control Register. */
+	register8_t INT0MASK;  /*!< Port Interrupt 0 Mask. */
+	register8_t INT1MASK;  /*!< Port Interrupt 1 Mask. */
+	register8_t INTFLAGS;  /*!< Interrupt Flag Register. */
+	register8_t reserved_0x0D;
+	register8_t reserved_0x0E;
+	register8_t reserved_0x0F;
+	register8_t PIN0CTRL;  /*!< Pin 0 Control Register. */
+	register8_t PIN1CTRL;  /*!< Pin 1 Control Register. */
+	register8_t PIN2CTRL;  /*!< Pin 2 Control Register. */
+	register8_t PIN3CTRL;  /*!< Pin 3 Control Register. */
+	register8_t PIN4CTRL;  /*!< Pin 4 Control Register. */
+	register8_t PIN5CTRL;  /*!< Pin 5 Control Register. */
+	register8_t PIN6CTRL;  /*!< Pin 6 Control Register. */
+	register8_t PIN7CTRL;  /*!< Pin 7 Control Register. */
+} PORT_t;
+
+#define PORTA  SIM_IO(PORT_t, 0x0600)
+#define PORTB  SIM_IO(PORT_t, 0x0620)
+#define PORTC  SIM_IO(PORT_t, 0x0640)
+#define PORTD  SIM_IO(PORT_t, 0x0660)
+#define PORTE  SIM_IO(PORT_t, 0x0680)
+#define PORTF  SIM_IO(PORT_t, 0x06A0)
+#define PORTH  SIM_IO(PORT_t, 0x06E0)
+#define PORTJ  SIM_IO(PORT_t, 0x0700)
+#define PORTK  SIM_IO(PORT_t, 0x0720)
+#define PORTQ  SIM_IO(PORT_t, 0x07C0)
+#define PORTR  SIM_IO(PORT_t, 0x07E0)
+
+#define PIN0_bm  0x01
+#define PIN1_bm  0x02
+#define PIN2_bm  0x04
+#define PIN3_bm  0x08
+#define PIN4_bm  0x10
+#define PIN5_bm  0x20
+#define PIN6_bm  0x40
+#define PIN7_bm  0x80
+
+/* PORT.INTCTRL bit masks and bit positions. */
+#define PORT_INT1LVL_gm  0x0C  /*!< Port Interrupt 1 Level group mask. */
+#define PORT_INT1LVL_gp  2
+#define PORT_INT0LVL_gm  0x03  /*!< Port Interrupt 0 Level group mask. */
+#define PORT_INT0LVL_gp  0
+
+/* PORT.INTFLAGS bit masks and bit positions. */
+#define PORT_INT1IF_bm  0x02  /*!< Port Interrupt 1 Flag bit mask. */
+#define PORT_INT1IF_bp  1
+#define PORT_INT0IF_bm  0x01  /*!< Port Interrupt 0 Flag bit mask. */
+#define PORT_INT0IF_bp  0
+
+/* PORT.PINnCTRL bit masks and bit positions. */
+#define PORT_SRLEN_bm  0x80  /*!< Slew Rate Enable bit mask. */
+#define PORT_SRLEN_bp  7
+#define PORT_INVEN_bm  0x40  /*!< Inverted I/O Enable bit mask. */
+#define PORT_INVEN_bp  6
+#define PORT_OPC_gm    0x38  /*!< Output/Pull Configuration group mask. */
+#define PORT_OPC_gp    3
+#define PORT_ISC_gm    0x07  /*!< Input/Sense Configuration group mask. */
+#define PORT_ISC_gp    0
+
+/*! Output/Pull Configuration. */
+typedef enum PORT_OPC_enum {
+	PORT_OPC_TOTEM_gc = (0x00<<3),           /*!< Totempole. */
+	PORT_OPC_BUSKEEPER_gc = (0x01<<3),       /*!< Totempole w/ Bus keeper on Input and Output. */
+	PORT_OPC_PULLDOWN_gc = (0x02<<3),        /*!< Totempole w/ Pull-down on Input. */
+	PORT_OPC_PULLUP_gc = (0x03<<3),          /*!< Totempole w/ Pull-up on Input. */
+	PORT_OPC_WIREDOR_gc = (0x04<<3),         /*!< Wired OR. */
+	PORT_OPC_WIREDAND_gc = (0x05<<3),        /*!< Wired AND. */
+	PORT_OPC_WIREDORPULL_gc = (0x06<<3),     /*!< Wired OR and Pull-down. */
+	PORT_OPC_WIREDANDPULL_gc = (0x07<<3),    /*!< Wired AND and Pull-up. */
+} PORT_OPC_t;
+
+/*! Port Interrupt 0 Level. */
+typedef enum PORT_INT0LVL_enum {
+	PORT_INT0LVL_OFF_gc = (0x00<<0),  /*!< Interrupt Disabled. */
+	PORT_INT0LVL_LO_gc = (0x01<<0),   /*!< Low Level. */
+	PORT_INT0LVL_MED_gc = (0x02<<0),  /*!< Medium Level. */
+	PORT_INT0LVL_HI_gc = (0x03<<0),   /*!< High Level. */
+} PORT_INT0LVL_t;
+
+/*! Port Interrupt 1 Level. */
+typedef enum PORT_INT1LVL_enum {
+	PORT_INT1LVL_OFF_gc = (0x00<<2),  /*!< Interrupt Disabled. */
+	PORT_INT1LVL_LO_gc = (0x01<<2),   /*!< Low Level. */
+	PORT_INT1LVL_MED_gc = (0x02<<2),  /*!< Medium Level. */
+	PORT_INT1LVL_HI_gc = (0x03<<2),   /*!< High Level. */
+} PORT_INT1LVL_t;
+
+/*! Input/Sense Configuration. */
+typedef enum PORT_ISC_enum {
+	PORT_ISC_BOTHEDGES_gc = (0x00<<0),      /*!< Sense Both Edges. */
+	PORT_ISC_RISING_gc = (0x01<<0),         /*!< Sense Rising Edge. */
+	PORT_ISC_FALLING_gc = (0x02<<0),        /*!< Sense Falling Edge. */
+	PORT_ISC_LEVEL_gc = (0x03<<0),          /*!< Sense Level (Transparent For Events). */
+	PORT_ISC_INPUT_DISABLE_gc = (0x07<<0),  /*!< Disable Digital Input Buffer. */
+} PORT_ISC_t;
+
+
+/* VPORT - Virtual Ports ****************************************************/
+
+/*! Virtual Port. */
+typedef struct VPORT_struct {
+	register8_t DIR;       /*!< I/O Port Data Direction. */
+	register8_t OUT;       /*!< I/O Port Output. */
+	register8_t IN;        /*!< I/O Port Input. */
+	register8_t INTFLAGS;  /*!< Interrupt Flag Register. */
+} VPORT_t;
+
+#define VPORT0  SIM_IO(VPORT_t, 0x0010)
+#define VPORT1  SIM_IO(VPORT_t, 0x0014)
+#define VPORT2  SIM_IO(VPORT_t, 0x0018)
+#define VPORT3  SIM_IO(VPORT_t, 0x001C)
+
+
+/* PORTCFG - Port Configuration **********************************************/
+
+/*! I/O port Configuration. */
+typedef struct PORTCFG_struct {
+	register8_t MPCMASK;   /*!< Multi-pin Configuration Mask. */
+	register8_t reserved_0x01;
+	register8_t VPCTRLA;   /*!< Virtual Port Control Register A. */
+	register8_t VPCTRLB;   /*!< Virtual Port Control Register B. */
+	register8_t CLKEVOUT;  /*!< Clock and Event Out Register. */
+} PORTCFG_t;
+
+#define PORTCFG  SIM_IO(PORTCFG_t, 0x00B0)
+
+/* PORTCFG.VPCTRLA bit masks and bit positions. */
+#define PORTCFG_VP1MAP_gm  0xF0  /*!< Virtual Port 1 Mapping group mask. */
+#define PORTCFG_VP1MAP_gp  4
+#define PORTCFG_VP0MAP_gm  0x0F  /*!< Virtual Port 0 Mapping group mask. */
+#define PORTCFG_VP0MAP_gp  0
+
+/* PORTCFG.VPCTRLB bit masks and bit positions. */
+#define PORTCFG_VP3MAP_gm  0xF0  /*!< Virtual Port 3 Mapping group mask. */
+#define PORTCFG_VP3MAP_gp  4
+#define PORTCFG_VP2MAP_gm  0x0F  /*!< Virtual Port 2 Mapping group mask. */
+#define PORTCFG_VP2MAP_gp  0
+
+/*! Virtual Port 0 Mapping. */
+typedef enum PORTCFG_VP0MAP_enum {
+	PORTCFG_VP0MAP_PORTA_gc = (0x00<<0),  /*!< Mapped To PORTA. */
+	PORTCFG_VP0MAP_PORTB_gc = (0x01<<0),  /*!< Mapped To PORTB. */
+	PORTCFG_VP0MAP_PORTC_gc = (0x02<<0),  /*!< Mapped To PORTC. */
+	PORTCFG_VP0MAP_PORTD_gc = (0x03<<0),  /*!< Mapped To PORTD. */
+	PORTCFG_VP0MAP_PORTE_gc = (0x04<<0),  /*!< Mapped To PORTE. */
+	PORTCFG_VP0MAP_PORTF_gc = (0x05<<0),  /*!< Mapped To PORTF. */
+	PORTCFG_VP0MAP_PORTH_gc = (0x07<<0),  /*!< Mapped To PORTH. */
+	PORTCFG_VP0MAP_PORTJ_gc = (0x08<<0),  /*!< Mapped To PORTJ. */
+	PORTCFG_VP0MAP_PORTK_gc = (0x09<<0),  /*!< Mapped To PORTK. */
+	PORTCFG_VP0MAP_PORTQ_gc = (0x0E<<0),  /*!< Mapped To PORTQ. */
+	PORTCFG_VP0MAP_PORTR_gc = (0x0F<<0),  /*!< Mapped To PORTR. */
+} PORTCFG_VP0MAP_t;
+
+/*! Virtual Port 1 Mapping. */
+typedef enum PORTCFG_VP1MAP_enum {
+	PORTCFG_VP1MAP_PORTA_gc = (0x00<<4),  /*!< Mapped To PORTA. */
+	PORTCFG_VP1MAP_PORTB_gc = (0x01<<4),  /*!< Mapped To PORTB. */
+	PORTCFG_VP1MAP_PORTC_gc = (0x02<<4),  /*!< Mapped To PORTC. */
+	PORTCFG_VP1MAP_PORTD_gc = (0x03<<4),  /*!< Mapped To PORTD. */
+	PORTCFG_VP1MAP_PORTE_gc = (0x04<<4),  /*!< Mapped To PORTE. */
+	PORTCFG_VP1MAP_PORTF_gc = (0x05<<4),  /*!< Mapped To PORTF. */
+	PORTCFG_VP1MAP_PORTH_gc = (0x07<<4),  /*!< Mapped To PORTH. */
+	PORTCFG_VP1MAP_PORTJ_gc = (0x08<<4),  /*!< Mapped To PORTJ. */
+	PORTCFG_VP1MAP_PORTK_gc = (0x09<<4),  /*!< Mapped To PORTK. */
+	PORTCFG_VP1MAP_PORTQ_gc = (0x0E<<4),  /*!< Mapped To PORTQ. */
+	PORTCFG_VP1MAP_PORTR_gc = (0x0F<<4),  /*!< Mapped To PORTR. */
+} PORTCFG_VP1MAP_t;
+
+/*! Virtual Port 2 Mapping. */
+typedef enum PORTCFG_VP2MAP_enum {
+	PORTCFG_VP2MAP_PORTA_gc = (0x00<<0),  /*!< Mapped To PORTA. */
+	PORTCFG_VP2MAP_PORTB_gc = (0x01<<0),  /*!< Mapped To PORTB. */
+	PORTCFG_VP2MAP_PORTC_gc = (0x02<<0),  /*!< Mapped To PORTC. */
+	PORTCFG_VP2MAP_PORTD_gc = (0x03<<0),  /*!< Mapped To PORTD. */
+	PORTCFG_VP2MAP_PORTE_gc = (0x04<<0),  /*!< Mapped To PORTE. */
+	PORTCFG_VP2MAP_PORTF_gc = (0x05<<0),  /*!< Mapped To PORTF. */
+	PORTCFG_VP2MAP_PORTH_gc = (0x07<<0),  /*!< Mapped To PORTH. */
+	PORTCFG_VP2MAP_PORTJ_gc = (0x08<<0),  /*!< Mapped To PORTJ. */
+	PORTCFG_VP2MAP_PORTK_gc = (0x09<<0),  /*!< Mapped To PORTK. */
+	PORTCFG_VP2MAP_PORTQ_gc = (0x0E<<0),  /*!< Mapped To PORTQ. */
+	PORTCFG_VP2MAP_PORTR_gc = (0x0F<<0),  /*!< Mapped To PORTR. */
+} PORTCFG_VP2MAP_t;
+
+/*! Virtual Port 3 Mapping. */
+typedef enum PORTCFG_VP3MAP_enum {
+	PORTCFG_VP3MAP_PORTA_gc = (0x00<<4),  /*!< Mapped To PORTA. */
+	PORTCFG_VP3MAP_PORTB_gc = (0x01<<4),  /*!< Mapped To PORTB. */
+	PORTCFG_VP3MAP_PORTC_gc = (0x02<<4),  /*!< Mapped To PORTC. */
+	PORTCFG_VP3MAP_PORTD_gc = (0x03<<4),  /*!< Mapped To PORTD. */
+	PORTCFG_VP3MAP_PORTE_gc = (0x04<<4),  /*!< Mapped To PORTE. */
+	PORTCFG_VP3MAP_PORTF_gc = (0x05<<4),  /*!< Mapped To PORTF. */
+	PORTCFG_VP3MAP_PORTH_gc = (0x07<<4),  /*!< Mapped To PORTH. */
+	PORTCFG_VP3MAP_PORTJ_gc = (0x08<<4),  /*!< Mapped To PORTJ. */
+	PORTCFG_VP3MAP_PORTK_gc = (0x09<<4),  /*!< Mapped To PORTK. */
+	PORTCFG_VP3MAP_PORTQ_gc = (0x0E<<4),  /*!< Mapped To PORTQ. */
+	PORTCFG_VP3MAP_PORTR_gc = (0x0F<<4),  /*!< Mapped To PORTR. */
+} PORTCFG_VP3MAP_t;
+
+
+/* EVSYS - Event System ******************************************************/
+
+/*! Event System. */
+typedef struct EVSYS_struct {
+	register8_t CH0MUX;   /*!< Event Channel 0 Multiplexer. */
+	register8_t CH1MUX;   /*!< Event Channel 1 Multiplexer. */
+	register8_t CH2MUX;   /*!< Event Channel 2 Multiplexer. */
+	register8_t CH3MUX;   /*!< Event Channel 3 Multiplexer. */
+	register8_t CH4MUX;   /*!< Event Channel 4 Multiplexer. */
+	register8_t CH5MUX;   /*!< Event Channel 5 Multiplexer. */
+	register8_t CH6MUX;   /*!< Event Channel 6 Multiplexer. */
+	register8_t CH7MUX;   /*!< Event Channel 7 Multiplexer. */
+	register8_t CH0CTRL;  /*!< Channel 0 Control Register. */
+	register8_t CH1CTRL;  /*!< Channel 1 Control Register. */
+	register8_t CH2CTRL;  /*!< Channel 2 Control Register. */
+	register8_t CH3CTRL;  /*!< Channel 3 Control Register. */
+	register8_t CH4CTRL;  /*!< Channel 4 Control Register. */
+	register8_t CH5CTRL;  /*!< Channel 5 Control Register. */
+	register8_t CH6CTRL;  /*!< Channel 6 Control Register. */
+	register8_t CH7CTRL;  /*!< Channel 7 Control Register. */
+	register8_t STROBE;   /*!< Event Strobe. */
+	register8_t DATA;     /*!< Event Data. */
+} EVSYS_t;
+
+#define EVSYS  SIM_IO(EVSYS_t, 0x0180)
+
+/* EVSYS.CH0CTRL bit masks and bit positions. */
+#define EVSYS_QDIRM_gm    0x60  /*!< Quadrature Decoder Index Recognition Mode group mask. */
+#define EVSYS_QDIRM_gp    5
+#define EVSYS_QDIEN_bm    0x10  /*!< Quadrature Decoder Index Enable bit mask. */
+#define EVSYS_QDIEN_bp    4
+#define EVSYS_QDEN_bm     0x08  /*!< Quadrature Decoder Enable bit mask. */
+#define EVSYS_QDEN_bp     3
+#define EVSYS_DIGFILT_gm  0x07  /*!< Digital Filter group mask. */
+#define EVSYS_DIGFILT_gp  0
+
+/*! Quadrature Decoder Index Recognition Mode. */
+typedef enum EVSYS_QDIRM_enum {
+	EVSYS_QDIRM_00_gc = (0x00<<5),  /*!< QDPH0 = 0, QDPH90 = 0. */
+	EVSYS_QDIRM_01_gc = (0x01<<5),  /*!< QDPH0 = 0, QDPH90 = 1. */
+	EVSYS_QDIRM_10_gc = (0x02<<5),  /*!< QDPH0 = 1, QDPH90 = 0. */
+	EVSYS_QDIRM_11_gc = (0x03<<5),  /*!< QDPH0 = 1, QDPH90 = 1. */
+} EVSYS_QDIRM_t;
+
+/*! Digital filter coefficient. */
+typedef enum EVSYS_DIGFILT_enum {
+	EVSYS_DIGFILT_1SAMPLE_gc = (0x00<<0),   /*!< 1 SAMPLE. */
+	EVSYS_DIGFILT_2SAMPLES_gc = (0x01<<0),  /*!< 2 SAMPLES. */
+	EVSYS_DIGFILT_3SAMPLES_gc = (0x02<<0),  /*!< 3 SAMPLES. */
+	EVSYS_DIGFILT_4SAMPLES_gc = (0x03<<0),  /*!< 4 SAMPLES. */
+	EVSYS_DIGFILT_5SAMPLES_gc = (0x04<<0),  /*!< 5 SAMPLES. */
+	EVSYS_DIGFILT_6SAMPLES_gc = (0x05<<0),  /*!< 6 SAMPLES. */
+	EVSYS_DIGFILT_7SAMPLES_gc = (0x06<<0),  /*!< 7 SAMPLES. */
+	EVSYS_DIGFILT_8SAMPLES_gc = (0x07<<0),  /*!< 8 SAMPLES. */
+} EVSYS_DIGFILT_t;
+
+/*! Event Channel multiplexer input selection. Only the RTC, Analog
+ *  Comparator, port pin and Timer/Counter sources are listed. */
+typedef enum EVSYS_CHMUX_enum {
+	EVSYS_CHMUX_OFF_gc = (0x00<<0),         /*!< Off. */
+	EVSYS_CHMUX_RTC_OVF_gc = (0x08<<0),     /*!< RTC Overflow. */
+	EVSYS_CHMUX_RTC_CMP_gc = (0x09<<0),     /*!< RTC Compare Match. */
+	EVSYS_CHMUX_ACA_CH0_gc = (0x20<<0),     /*!< Analog Comparator A Channel 0. */
+	EVSYS_CHMUX_ACA_CH1_gc = (0x21<<0),     /*!< Analog Comparator A Channel 1. */
+	EVSYS_CHMUX_ACA_WIN_gc = (0x22<<0),     /*!< Analog Comparator A Window. */
+	EVSYS_CHMUX_ACB_CH0_gc = (0x24<<0),     /*!< Analog Comparator B Channel 0. */
+	EVSYS_CHMUX_ACB_CH1_gc = (0x25<<0),     /*!< Analog Comparator B Channel 1. */
+	EVSYS_CHMUX_ACB_WIN_gc = (0x26<<0),     /*!< Analog Comparator B Window. */
+	EVSYS_CHMUX_PORTA_PIN0_gc = (0x50<<0),  /*!< Port A, Pin0. */
+	EVSYS_CHMUX_PORTA_PIN1_gc = (0x51<<0),  /*!< Port A, Pin1. */
+	EVSYS_CHMUX_PORTA_PIN2_gc = (0x52<<0),  /*!< Port A, Pin2. */
+	EVSYS_CHMUX_PORTA_PIN3_gc = (0x53<<0),  /*!< Port A, Pin3. */
+	EVSYS_CHMUX_PORTA_PIN4_gc = (0x54<<0),  /*!< Port A, Pin4. */
+	EVSYS_CHMUX_PORTA_PIN5_gc = (0x55<<0),  /*!< Port A, Pin5. */
+	EVSYS_CHMUX_PORTA_PIN6_gc = (0x56<<0),  /*!< Port A, Pin6. */
+	EVSYS_CHMUX_PORTA_PIN7_gc = (0x57<<0),  /*!< Port A, Pin7. */
+	EVSYS_CHMUX_PORTB_PIN0_gc = (0x58<<0),  /*!< Port B, Pin0. */
+	EVSYS_CHMUX_PORTB_PIN1_gc = (0x59<<0),  /*!< Port B, Pin1. */
+	EVSYS_CHMUX_PORTB_PIN2_gc = (0x5A<<0),  /*!< Port B, Pin2. */
+	EVSYS_CHMUX_PORTB_PIN3_gc = (0x5B<<0),  /*!< Port B, Pin3. */
+	EVSYS_CHMUX_PORTB_PIN4_gc = (0x5C<<0),  /*!< Port B, Pin4. */
+	EVSYS_CHMUX_PORTB_PIN5_gc = (0x5D<<0),  /*!< Port B, Pin5. */
+	EVSYS_CHMUX_PORTB_PIN6_gc = (0x5E<<0),  /*!< Port B, Pin6. */
+	EVSYS_CHMUX_PORTB_PIN7_gc = (0x5F<<0),  /*!< Port B, Pin7. */
+	EVSYS_CHMUX_PORTC_PIN0_gc = (0x60<<0),  /*!< Port C, Pin0. */
+	EVSYS_CHMUX_PORTC_PIN1_gc = (0x61<<0),  /*!< Port C, Pin1. */
+	EVSYS_CHMUX_PORTC_PIN2_gc = (0x62<<0),  /*!< Port C, Pin2. */
+	EVSYS_CHMUX_PORTC_PIN3_gc = (0x63<<0),  /*!< Port C, Pin3. */
+	EVSYS_CHMUX_PORTC_PIN4_gc = (0x64<<0),  /*!< Port C, Pin4. */
+	EVSYS_CHMUX_PORTC_PIN5_gc = (0x65<<0),  /*!< Port C, Pin5. */
+	EVSYS_CHMUX_PORTC_PIN6_gc = (0x66<<0),  /*!< Port C, Pin6. */
+	EVSYS_CHMUX_PORTC_PIN7_gc = (0x67<<0),  /*!< Port C, Pin7. */
+	EVSYS_CHMUX_PORTD_PIN0_gc = (0x68<<0),  /*!< Port D, Pin0. */
+	EVSYS_CHMUX_PORTD_PIN1_gc = (0x69<<0),  /*!< Port D, Pin1. */
+	EVSYS_CHMUX_PORTD_PIN2_gc = (0x6A<<0),  /*!< Port D, Pin2. */
+	EVSYS_CHMUX_PORTD_PIN3_gc = (0x6B<<0),  /*!< Port D, Pin3. */
+	EVSYS_CHMUX_PORTD_PIN4_gc = (0x6C<<0),  /*!< Port D, Pin4. */
+	EVSYS_CHMUX_PORTD_PIN5_gc = (0x6D<<0),  /*!< Port D, Pin5. */
+	EVSYS_CHMUX_PORTD_PIN6_gc = (0x6E<<0),  /*!< Port D, Pin6. */
+	EVSYS_CHMUX_PORTD_PIN7_gc = (0x6F<<0),  /*!< Port D, Pin7. */
+	EVSYS_CHMUX_PORTE_PIN0_gc = (0x70<<0),  /*!< Port E, Pin0. */
+	EVSYS_CHMUX_PORTE_PIN1_gc = (0x71<<0),  /*!< Port E, Pin1. */
+	EVSYS_CHMUX_PORTE_PIN2_gc = (0x72<<0),  /*!< Port E, Pin2. */
+	EVSYS_CHMUX_PORTE_PIN3_gc = (0x73<<0),  /*!< Port E, Pin3. */
+	EVSYS_CHMUX_PORTE_PIN4_gc = (0x74<<0),  /*!< Port E, Pin4. */
+	EVSYS_CHMUX_PORTE_PIN5_gc = (0x75<<0),  /*!< Port E, Pin5. */
+	EVSYS_CHMUX_PORTE_PIN6_gc = (0x76<<0),  /*!< Port E, Pin6. */
+	EVSYS_CHMUX_PORTE_PIN7_gc = (0x77<<0),  /*!< Port E, Pin7. */
+	EVSYS_CHMUX_PORTF_PIN0_gc = (0x78<<0),  /*!< Port F, Pin0. */
+	EVSYS_CHMUX_PORTF_PIN1_gc = (0x79<<0),  /*!< Port F, Pin1. */
+	EVSYS_CHMUX_PORTF_PIN2_gc = (0x7A<<0),  /*!< Port F, Pin2. */
+	EVSYS_CHMUX_PORTF_PIN3_gc = (0x7B<<0),  /*!< Port F, Pin3. */
+	EVSYS_CHMUX_PORTF_PIN4_gc = (0x7C<<0),  /*!< Port F, Pin4. */
+	EVSYS_CHMUX_PORTF_PIN5_gc = (0x7D<<0),  /*!< Port F, Pin5. */
+	EVSYS_CHMUX_PORTF_PIN6_gc = (0x7E<<0),  /*!< Port F, Pin6. */
+	EVSYS_CHMUX_PORTF_PIN7_gc = (0x7F<<0),  /*!< Port F, Pin7. */
+	EVSYS_CHMUX_TCC0_OVF_gc = (0xC0<<0),    /*!< Timer/Counter C0 Overflow. */
+	EVSYS_CHMUX_TCC0_ERR_gc = (0xC1<<0),    /*!< Timer/Counter C0 Error. */
+	EVSYS_CHMUX_TCC0_CCA_gc = (0xC4<<0),    /*!< Timer/Counter C0 Compare or Capture A. */
+	EVSYS_CHMUX_TCC0_CCB_gc = (0xC5<<0),    /*!< Timer/Counter C0 Compare or Capture B. */
+	EVSYS_CHMUX_TCC0_CCC_gc = (0xC6<<0),    /*!< Timer/Counter C0 Compare or Capture C. */
+	EVSYS_CHMUX_TCC0_CCD_gc = (0xC7<<0),    /*!< Timer/Counter C0 Compare or Capture D. */
+	EVSYS_CHMUX_TCD0_OVF_gc = (0xD0<<0),    /*!< Timer/Counter D0 Overflow. */
+	EVSYS_CHMUX_TCD0_ERR_gc = (0xD1<<0),    /*!< Timer/Counter D0 Error. */
+	EVSYS_CHMUX_TCD0_CCA_gc = (0xD4<<0),    /*!< Timer/Counter D0 Compare or Capture A. */
+	EVSYS_CHMUX_TCD0_CCB_gc = (0xD5<<0),    /*!< Timer/Counter D0 Compare or Capture B. */
+	EVSYS_CHMUX_TCD0_CCC_gc = (0xD6<<0),    /*!< Timer/Counter D0 Compare or Capture C. */
+	EVSYS_CHMUX_TCD0_CCD_gc = (0xD7<<0),    /*!< Timer/Counter D0 Compare or Capture D. */
+	EVSYS_CHMUX_TCE0_OVF_gc = (0xE0<<0),    /*!< Timer/Counter E0 Overflow. */
+	EVSYS_CHMUX_TCE0_ERR_gc = (0xE1<<0),    /*!< Timer/Counter E0 Error. */
+	EVSYS_CHMUX_TCE0_CCA_gc = (0xE4<<0),    /*!< Timer/Counter E0 Compare or Capture A. */
+	EVSYS_CHMUX_TCE0_CCB_gc = (0xE5<<0),    /*!< Timer/Counter E0 Compare or Capture B. */
+	EVSYS_CHMUX_TCE0_CCC_gc = (0xE6<<0),    /*!< Timer/Counter E0 Compare or Capture C. */
+	EVSYS_CHMUX_TCE0_CCD_gc = (0xE7<<0),    /*!< Timer/Counter E0 Compare or Capture D. */
+	EVSYS_CHMUX_TCF0_OVF_gc = (0xF0<<0),    /*!< Timer/Counter F0 Overflow. */
+	EVSYS_CHMUX_TCF0_ERR_gc = (0xF1<<0),    /*!< Timer/Counter F0 Error. */
+	EVSYS_CHMUX_TCF0_CCA_gc = (0xF4<<0),    /*!< Timer/Counter F0 Compare or Capture A. */
+	EVSYS_CHMUX_TCF0_CCB_gc = (0xF5<<0),    /*!< Timer/Counter F0 Compare or Capture B. */
+	EVSYS_CHMUX_TCF0_CCC_gc = (0xF6<<0),    /*!< Timer/Counter F0 Compare or Capture C. */
+	EVSYS_CHMUX_TCF0_CCD_gc = (0xF7<<0),    /*!< Timer/Counter F0 Compare or Capture D. */
+} EVSYS_CHMUX_t;
+
+
+/* AC - Analog Comparator ****************************************************/
+
+/*! Analog Comparator. */
+typedef struct AC_struct {
+	register8_t AC0CTRL;     /*!< Comparator 0 Control. */
+	register8_t AC1CTRL;     /*!< Comparator 1 Control. */
+	register8_t AC0MUXCTRL;  /*!< Comparator 0 MUX Control. */
+	register8_t AC1MUXCTRL;  /*!< Comparator 1 MUX Control. */
+	register8_t CTRLA;       /*!< Control Register A. */
+	register8_t CTRLB;       /*!< Control Register B. */
+	register8_t WINCTRL;     /*!< Window Mode Control. */
+	register8_t STATUS;      /*!< Status. */
+} AC_t;
+
+#define ACA  SIM_IO(AC_t, 0x0380)
+#define ACB  SIM_IO(AC_t, 0x0390)
+
+/* AC.AC0CTRL and AC.AC1CTRL bit masks and bit positions. */
+#define AC_INTMODE_gm     0xC0  /*!< Interrupt Mode group mask. */
+#define AC_INTMODE_gp     6
+#define AC_INTLVL_gm      0x30  /*!< Interrupt Level group mask. */
+#define AC_INTLVL_gp      4
+#define AC_HSMODE_bm      0x08  /*!< High-speed Mode bit mask. */
+#define AC_HSMODE_bp      3
+#define AC_HYSMODE_gm     0x06  /*!< Hysteresis Mode group mask. */
+#define AC_HYSMODE_gp     1
+#define AC_ENABLE_bm      0x01  /*!< Enable bit mask. */
+#define AC_ENABLE_bp      0
+
+/* AC.AC0MUXCTRL and AC.AC1MUXCTRL bit masks and bit positions. */
+#define AC_MUXPOS_gm      0x38  /*!< MUX Positive Input group mask. */
+#define AC_MUXPOS_gp      3
+#define AC_MUXNEG_gm      0x07  /*!< MUX Negative Input group mask. */
+#define AC_MUXNEG_gp      0
+
+/* AC.CTRLA bit masks and bit positions. */
+#define AC_AC0OUT_bm      0x01  /*!< Comparator 0 Output Enable bit mask. */
+#define AC_AC0OUT_bp      0
+
+/* AC.CTRLB bit masks and bit positions. */
+#define AC_SCALEFAC_gm    0x3F  /*!< VCC Voltage Scaler Factor group mask. */
+#define AC_SCALEFAC_gp    0
+#define AC_SCALEFAC_bp    0
+
+/* AC.WINCTRL bit masks and bit positions. */
+#define AC_WEN_bm         0x10  /*!< Window Mode Enable bit mask. */
+#define AC_WEN_bp         4
+#define AC_WINTMODE_gm    0x0C  /*!< Window Interrupt Mode group mask. */
+#define AC_WINTMODE_gp    2
+#define AC_WINTLVL_gm     0x03  /*!< Window Interrupt Level group mask. */
+#define AC_WINTLVL_gp     0
+
+/* AC.STATUS bit masks and bit positions. */
+#define AC_WSTATE_gm      0xC0  /*!< Window Mode State group mask. */
+#define AC_WSTATE_gp      6
+#define AC_AC1STATE_bm    0x20  /*!< Comparator 1 State bit mask. */
+#define AC_AC1STATE_bp    5
+#define AC_AC0STATE_bm    0x10  /*!< Comparator 0 State bit mask. */
+#define AC_AC0STATE_bp    4
+#define AC_WIF_bm         0x04  /*!< Window Mode Interrupt Flag bit mask. */
+#define AC_WIF_bp         2
+#define AC_AC1IF_bm       0x02  /*!< Comparator 1 Interrupt Flag bit mask. */
+#define AC_AC1IF_bp       1
+#define AC_AC0IF_bm       0x01  /*!< Comparator 0 Interrupt Flag bit mask. */
+#define AC_AC0IF_bp       0
+
+/*! Interrupt mode. */
+typedef enum AC_INTMODE_enum {
+	AC_INTMODE_BOTHEDGES_gc = (0x00<<6),  /*!< Interrupt on both edges. */
+	AC_INTMODE_FALLING_gc = (0x02<<6),    /*!< Interrupt on falling edge. */
+	AC_INTMODE_RISING_gc = (0x03<<6),     /*!< Interrupt on rising edge. */
+} AC_INTMODE_t;
+
+/*! Interrupt level. */
+typedef enum AC_INTLVL_enum {
+	AC_INTLVL_OFF_gc = (0x00<<4),  /*!< Interrupt disabled. */
+	AC_INTLVL_LO_gc = (0x01<<4),   /*!< Low level. */
+	AC_INTLVL_MED_gc = (0x02<<4),  /*!< Medium level. */
+	AC_INTLVL_HI_gc = (0x03<<4),   /*!< High level. */
+} AC_INTLVL_t;
+
+/*! Hysteresis mode selection. */
+typedef enum AC_HYSMODE_enum {
+	AC_HYSMODE_NO_gc = (0x00<<1),     /*!< No hysteresis. */
+	AC_HYSMODE_SMALL_gc = (0x01<<1),  /*!< Small hysteresis. */
+	AC_HYSMODE_LARGE_gc = (0x02<<1),  /*!< Large hysteresis. */
+} AC_HYSMODE_t;
+
+/*! Positive input multiplexer selection. */
+typedef enum AC_MUXPOS_enum {
+	AC_MUXPOS_PIN0_gc = (0x00<<3),  /*!< Pin 0. */
+	AC_MUXPOS_PIN1_gc = (0x01<<3),  /*!< Pin 1. */
+	AC_MUXPOS_PIN2_gc = (0x02<<3),  /*!< Pin 2. */
+	AC_MUXPOS_PIN3_gc = (0x03<<3),  /*!< Pin 3. */
+	AC_MUXPOS_PIN4_gc = (0x04<<3),  /*!< Pin 4. */
+	AC_MUXPOS_PIN5_gc = (0x05<<3),  /*!< Pin 5. */
+	AC_MUXPOS_PIN6_gc = (0x06<<3),  /*!< Pin 6. */
+	AC_MUXPOS_DAC_gc = (0x07<<3),   /*!< DAC output. */
+} AC_MUXPOS_t;
+
+/*! Negative input multiplexer selection. */
+typedef enum AC_MUXNEG_enum {
+	AC_MUXNEG_PIN0_gc = (0x00<<0),     /*!< Pin 0. */
+	AC_MUXNEG_PIN1_gc = (0x01<<0),     /*!< Pin 1. */
+	AC_MUXNEG_PIN3_gc = (0x02<<0),     /*!< Pin 3. */
+	AC_MUXNEG_PIN5_gc = (0x03<<0),     /*!< Pin 5. */
+	AC_MUXNEG_PIN7_gc = (0x04<<0),     /*!< Pin 7. */
+	AC_MUXNEG_DAC_gc = (0x05<<0),      /*!< DAC output. */
+	AC_MUXNEG_BANDGAP_gc = (0x06<<0),  /*!< Bandgap Reference. */
+	AC_MUXNEG_SCALER_gc = (0x07<<0),   /*!< Internal voltage scaler. */
+} AC_MUXNEG_t;
+
+/*! Window interrupt mode. */
+typedef enum AC_WINTMODE_enum {
+	AC_WINTMODE_ABOVE_gc = (0x00<<2),    /*!< Interrupt on signal above window. */
+	AC_WINTMODE_INSIDE_gc = (0x01<<2),   /*!< Interrupt on signal inside window. */
+	AC_WINTMODE_BELOW_gc = (0x02<<2),    /*!< Interrupt on signal below window. */
+	AC_WINTMODE_OUTSIDE_gc = (0x03<<2),  /*!< Interrupt on signal outside window. */
+} AC_WINTMODE_t;
+
+/*! Window interrupt level. */
+typedef enum AC_WINTLVL_enum {
+	AC_WINTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt disabled. */
+	AC_WINTLVL_LO_gc = (0x01<<0),   /*!< Low priority. */
+	AC_WINTLVL_MED_gc = (0x02<<0),  /*!< Medium priority. */
+	AC_WINTLVL_HI_gc = (0x03<<0),   /*!< High priority. */
+} AC_WINTLVL_t;
+
+/*! Window mode state. */
+typedef enum AC_WSTATE_enum {
+	AC_WSTATE_ABOVE_gc = (0x00<<6),   /*!< Signal above window. */
+	AC_WSTATE_INSIDE_gc = (0x01<<6),  /*!< Signal inside window. */
+	AC_WSTATE_BELOW_gc = (0x02<<6),   /*!< Signal below window. */
+} AC_WSTATE_t;
+
+
+/* ADC - Analog/Digital Converter ********************************************/
+
+/*! ADC Channel. */
+typedef struct ADC_CH_struct {
+	register8_t CTRL;      /*!< Control Register. */
+	register8_t MUXCTRL;   /*!< MUX Control. */
+	register8_t INTCTRL;   /*!< Channel Interrupt Control. */
+	register8_t INTFLAGS;  /*!< Interrupt Flags. */
+	union {
+		register16_t RES;  /*!< Channel Result. */
+		struct {
+			register8_t RESL;  /*!< Channel Result low byte. */
+			register8_t RESH;  /*!< Channel Result high byte. */
+		};
+	};
+	register8_t reserved_0x06;
+	register8_t reserved_0x07;
+} ADC_CH_t;
+
+/*! Analog-to-Digital Converter. */
+typedef struct ADC_struct {
+	register8_t CTRLA;      /*!< Control Register A. */
+	register8_t CTRLB;      /*!< Control Register B. */
+	register8_t REFCTRL;    /*!< Reference Control. */
+	register8_t EVCTRL;     /*!< Event Control. */
+	register8_t PRESCALER;  /*!< Clock Prescaler. */
+	register8_t reserved_0x05;
+	register8_t INTFLAGS;   /*!< Interrupt Flags. */
+	register8_t reserved_0x07;
+	register8_t reserved_0x08;
+	register8_t reserved_0x09;
+	register8_t reserved_0x0A;
+	register8_t reserved_0x0B;
+	union {
+		register16_t CAL;  /*!< Calibration Value. */
+		struct {
+			register8_t CALL;  /*!< Calibration Value low byte. */
+			register8_t CALH;  /*!< Calibration Value high byte. */
+		};
+	};
+	register8_t reserved_0x0E;
+	register8_t reserved_0x0F;
+	register16_t CH0RES;    /*!< Channel 0 Result. */
+	register16_t CH1RES;    /*!< Channel 1 Result. */
+	register16_t CH2RES;    /*!< Channel 2 Result. */
+	register16_t CH3RES;    /*!< Channel 3 Result. */
+	register16_t CMP;       /*!< Compare Value. */
+	register8_t reserved_0x1A[6];
+	ADC_CH_t CH0;           /*!< ADC Channel 0. */
+	ADC_CH_t CH1;           /*!< ADC Channel 1. */
+	ADC_CH_t CH2;           /*!< ADC Channel 2. */
+	ADC_CH_t CH3;           /*!< ADC Channel 3. */
+} ADC_t;
+
+#define ADCA  SIM_IO(ADC_t, 0x0200)
+#define ADCB  SIM_IO(ADC_t, 0x0240)
+
+/* ADC_CH.CTRL bit masks and bit positions. */
+#define ADC_CH_START_bm      0x80  /*!< Channel Start Conversion bit mask. */
+#define ADC_CH_START_bp      7
+#define ADC_CH_GAINFAC_gm    0x1C  /*!< Gain Factor group mask. */
+#define ADC_CH_GAINFAC_gp    2
+#define ADC_CH_INPUTMODE_gm  0x03  /*!< Negative Input Select group mask. */
+#define ADC_CH_INPUTMODE_gp  0
+
+/* ADC_CH.MUXCTRL bit masks and bit positions. */
+#define ADC_CH_MUXPOS_gm     0x78  /*!< Positive Input Select group mask. */
+#define ADC_CH_MUXPOS_gp     3
+#define ADC_CH_MUXINT_gm     0x78  /*!< Internal Input Select group mask. */
+#define ADC_CH_MUXINT_gp     3
+#define ADC_CH_MUXNEG_gm     0x03  /*!< Negative Input Select group mask. */
+#define ADC_CH_MUXNEG_gp     0
+
+/* ADC_CH.INTCTRL bit masks and bit positions. */
+#define ADC_CH_INTMODE_gm    0x0C  /*!< Interrupt Mode group mask. */
+#define ADC_CH_INTMODE_gp    2
+#define ADC_CH_INTLVL_gm     0x03  /*!< Interrupt Level group mask. */
+#define ADC_CH_INTLVL_gp     0
+
+/* ADC_CH.INTFLAGS bit masks and bit positions. */
+#define ADC_CH_CHIF_bm       0x01  /*!< Channel Interrupt Flag bit mask. */
+#define ADC_CH_CHIF_bp       0
+
+/* ADC.CTRLA bit masks and bit positions. */
+#define ADC_DMASEL_gm        0xC0  /*!< DMA Selection group mask. */
+#define ADC_DMASEL_gp        6
+#define ADC_CH3START_bm      0x20  /*!< Channel 3 Start Conversion bit mask. */
+#define ADC_CH3START_bp      5
+#define ADC_CH2START_bm      0x10  /*!< Channel 2 Start Conversion bit mask. */
+#define ADC_CH2START_bp      4
+#define ADC_CH1START_bm      0x08  /*!< Channel 1 Start Conversion bit mask. */
+#define ADC_CH1START_bp      3
+#define ADC_CH0START_bm      0x04  /*!< Channel 0 Start Conversion bit mask. */
+#define ADC_CH0START_bp      2
+#define ADC_FLUSH_bm         0x02  /*!< Flush Pipeline bit mask. */
+#define ADC_FLUSH_bp         1
+#define ADC_ENABLE_bm        0x01  /*!< Enable ADC bit mask. */
+#define ADC_ENABLE_bp        0
+
+/* ADC.CTRLB bit masks and bit positions. */
+#define ADC_CONMODE_bm       0x10  /*!< Conversion Mode bit mask. */
+#define ADC_CONMODE_bp       4
+#define ADC_FREERUN_bm       0x08  /*!< Free Running Mode Enable bit mask. */
+#define ADC_FREERUN_bp       3
+#define ADC_RESOLUTION_gm    0x06  /*!< Result Resolution group mask. */
+#define ADC_RESOLUTION_gp    1
+
+/* ADC.REFCTRL bit masks and bit positions. */
+#define ADC_REFSEL_gm        0x30  /*!< Reference Selection group mask. */
+#define ADC_REFSEL_gp        4
+#define ADC_BANDGAP_bm       0x02  /*!< Bandgap enable bit mask. */
+#define ADC_BANDGAP_bp       1
+#define ADC_TEMPREF_bm       0x01  /*!< Temperature Reference Enable bit mask. */
+#define ADC_TEMPREF_bp       0
+
+/* ADC.EVCTRL bit masks and bit positions. */
+#define ADC_SWEEP_gm         0xC0  /*!< Channel Sweep Selection group mask. */
+#define ADC_SWEEP_gp         6
+#define ADC_EVSEL_gm         0x38  /*!< Event Input Select group mask. */
+#define ADC_EVSEL_gp         3
+#define ADC_EVACT_gm         0x07  /*!< Event Action Select group mask. */
+#define ADC_EVACT_gp         0
+
+/* ADC.PRESCALER bit masks and bit positions. */
+#define ADC_PRESCALER_gm     0x07  /*!< Clock Prescaler Selection group mask. */
+#define ADC_PRESCALER_gp     0
+
+/* ADC.INTFLAGS bit masks and bit positions. */
+#define ADC_CH3IF_bm         0x08  /*!< Channel 3 Interrupt Flag bit mask. */
+#define ADC_CH3IF_bp         3
+#define ADC_CH2IF_bm         0x04  /*!< Channel 2 Interrupt Flag bit mask. */
+#define ADC_CH2IF_bp         2
+#define ADC_CH1IF_bm         0x02  /*!< Channel 1 Interrupt Flag bit mask. */
+#define ADC_CH1IF_bp         1
+#define ADC_CH0IF_bm         0x01  /*!< Channel 0 Interrupt Flag bit mask. */
+#define ADC_CH0IF_bp         0
+
+/*! Gain factor. */
+typedef enum ADC_CH_GAIN_enum {
+	ADC_CH_GAIN_1X_gc = (0x00<<2),   /*!< 1x gain. */
+	ADC_CH_GAIN_2X_gc = (0x01<<2),   /*!< 2x gain. */
+	ADC_CH_GAIN_4X_gc = (0x02<<2),   /*!< 4x gain. */
+	ADC_CH_GAIN_8X_gc = (0x03<<2),   /*!< 8x gain. */
+	ADC_CH_GAIN_16X_gc = (0x04<<2),  /*!< 16x gain. */
+	ADC_CH_GAIN_32X_gc = (0x05<<2),  /*!< 32x gain. */
+	ADC_CH_GAIN_64X_gc = (0x06<<2),  /*!< 64x gain. */
+} ADC_CH_GAIN_t;
+
+/*! Input mode. */
+typedef enum ADC_CH_INPUTMODE_enum {
+	ADC_CH_INPUTMODE_INTERNAL_gc = (0x00<<0),   /*!< Internal inputs, no gain. */
+	ADC_CH_INPUTMODE_SINGLEENDED_gc = (0x01<<0),  /*!< Single-ended input, no gain. */
+	ADC_CH_INPUTMODE_DIFF_gc = (0x02<<0),       /*!< Differential input, no gain. */
+	ADC_CH_INPUTMODE_DIFFWGAIN_gc = (0x03<<0),  /*!< Differential input, with gain. */
+} ADC_CH_INPUTMODE_t;
+
+/*! Positive input multiplexer selection. */
+typedef enum ADC_CH_MUXPOS_enum {
+	ADC_CH_MUXPOS_PIN0_gc = (0x00<<3),  /*!< Input pin 0. */
+	ADC_CH_MUXPOS_PIN1_gc = (0x01<<3),  /*!< Input pin 1. */
+	ADC_CH_MUXPOS_PIN2_gc = (0x02<<3),  /*!< Input pin 2. */
+	ADC_CH_MUXPOS_PIN3_gc = (0x03<<3),  /*!< Input pin 3. */
+	ADC_CH_MUXPOS_PIN4_gc = (0x04<<3),  /*!< Input pin 4. */
+	ADC_CH_MUXPOS_PIN5_gc = (0x05<<3),  /*!< Input pin 5. */
+	ADC_CH_MUXPOS_PIN6_gc = (0x06<<3),  /*!< Input pin 6. */
+	ADC_CH_MUXPOS_PIN7_gc = (0x07<<3),  /*!< Input pin 7. */
+} ADC_CH_MUXPOS_t;
+
+/*! Internal input multiplexer selections. */
+typedef enum ADC_CH_MUXINT_enum {
+	ADC_CH_MUXINT_TEMP_gc = (0x00<<3),       /*!< Temperature Reference. */
+	ADC_CH_MUXINT_BANDGAP_gc = (0x01<<3),    /*!< Bandgap Reference. */
+	ADC_CH_MUXINT_SCALEDVCC_gc = (0x02<<3),  /*!< 1/10 scaled VCC. */
+	ADC_CH_MUXINT_DAC_gc = (0x03<<3),        /*!< DAC output. */
+} ADC_CH_MUXINT_t;
+
+/*! Negative input multiplexer selection. */
+typedef enum ADC_CH_MUXNEG_enum {
+	ADC_CH_MUXNEG_PIN0_gc = (0x00<<0),  /*!< Input pin 0, or pin 4 with gain. */
+	ADC_CH_MUXNEG_PIN1_gc = (0x01<<0),  /*!< Input pin 1, or pin 5 with gain. */
+	ADC_CH_MUXNEG_PIN2_gc = (0x02<<0),  /*!< Input pin 2, or pin 6 with gain. */
+	ADC_CH_MUXNEG_PIN3_gc = (0x03<<0),  /*!< Input pin 3, or pin 7 with gain. */
+	ADC_CH_MUXNEG_PIN4_gc = (0x00<<0),  /*!< Input pin 4, with gain. */
+	ADC_CH_MUXNEG_PIN5_gc = (0x01<<0),  /*!< Input pin 5, with gain. */
+	ADC_CH_MUXNEG_PIN6_gc = (0x02<<0),  /*!< Input pin 6, with gain. */
+	ADC_CH_MUXNEG_PIN7_gc = (0x03<<0),  /*!< Input pin 7, with gain. */
+} ADC_CH_MUXNEG_t;
+
+/*! Interrupt mode. */
+typedef enum ADC_CH_INTMODE_enum {
+	ADC_CH_INTMODE_COMPLETE_gc = (0x00<<2),  /*!< Interrupt on conversion complete. */
+	ADC_CH_INTMODE_BELOW_gc = (0x01<<2),     /*!< Interrupt on result below compare value. */
+	ADC_CH_INTMODE_ABOVE_gc = (0x03<<2),     /*!< Interrupt on result above compare value. */
+} ADC_CH_INTMODE_t;
+
+/*! Interrupt level. */
+typedef enum ADC_CH_INTLVL_enum {
+	ADC_CH_INTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt disabled. */
+	ADC_CH_INTLVL_LO_gc = (0x01<<0),   /*!< Low level. */
+	ADC_CH_INTLVL_MED_gc = (0x02<<0),  /*!< Medium level. */
+	ADC_CH_INTLVL_HI_gc = (0x03<<0),   /*!< High level. */
+} ADC_CH_INTLVL_t;
+
+/*! Conversion result resolution. */
+typedef enum ADC_RESOLUTION_enum {
+	ADC_RESOLUTION_12BIT_gc = (0x00<<1),      /*!< 12-bit right-adjusted result. */
+	ADC_RESOLUTION_8BIT_gc = (0x02<<1),       /*!< 8-bit right-adjusted result. */
+	ADC_RESOLUTION_LEFT12BIT_gc = (0x03<<1),  /*!< 12-bit left-adjusted result. */
+} ADC_RESOLUTION_t;
+
+/*! Voltage reference selection. */
+typedef enum ADC_REFSEL_enum {
+	ADC_REFSEL_INT1V_gc = (0x00<<4),  /*!< Internal 1V. */
+	ADC_REFSEL_VCC_gc = (0x01<<4),    /*!< Internal VCC / 1.6V. */
+	ADC_REFSEL_AREFA_gc = (0x02<<4),  /*!< External reference on PORT A. */
+	ADC_REFSEL_AREFB_gc = (0x03<<4),  /*!< External reference on PORT B. */
+} ADC_REFSEL_t;
+
+/*! Channel sweep selection. */
+typedef enum ADC_SWEEP_enum {
+	ADC_SWEEP_0_gc = (0x00<<6),    /*!< ADC Channel 0. */
+	ADC_SWEEP_01_gc = (0x01<<6),   /*!< ADC Channel 0,1. */
+	ADC_SWEEP_012_gc = (0x02<<6),  /*!< ADC Channel 0,1,2. */
+	ADC_SWEEP_0123_gc = (0x03<<6), /*!< ADC Channel 0,1,2,3. */
+} ADC_SWEEP_t;
+
+/*! Clock prescaler. */
+typedef enum ADC_PRESCALER_enum {
+	ADC_PRESCALER_DIV4_gc = (0x00<<0),    /*!< Divide clock by 4. */
+	ADC_PRESCALER_DIV8_gc = (0x01<<0),    /*!< Divide clock by 8. */
+	ADC_PRESCALER_DIV16_gc = (0x02<<0),   /*!< Divide clock by 16. */
+	ADC_PRESCALER_DIV32_gc = (0x03<<0),   /*!< Divide clock by 32. */
+	ADC_PRESCALER_DIV64_gc = (0x04<<0),   /*!< Divide clock by 64. */
+	ADC_PRESCALER_DIV128_gc = (0x05<<0),  /*!< Divide clock by 128. */
+	ADC_PRESCALER_DIV256_gc = (0x06<<0),  /*!< Divide clock by 256. */
+	ADC_PRESCALER_DIV512_gc = (0x07<<0),  /*!< Divide clock by 512. */
+} ADC_PRESCALER_t;
+
+
+/* RTC - Real-Time Counter ***************************************************/
+
+/*! Real-Time Counter. */
+typedef struct RTC_struct {
+	register8_t CTRL;      /*!< Control Register. */
+	register8_t STATUS;    /*!< Status Register. */
+	register8_t INTCTRL;   /*!< Interrupt Control Register. */
+	register8_t INTFLAGS;  /*!< Interrupt Flags. */
+	register8_t TEMP;      /*!< Temporary register. */
+	register8_t reserved_0x05;
+	register8_t reserved_0x06;
+	register8_t reserved_0x07;
+	register16_t CNT;      /*!< Count Register. */
+	register16_t PER;      /*!< Period Register. */
+	register16_t COMP;     /*!< Compare Register. */
+} RTC_t;
+
+#define RTC  SIM_IO(RTC_t, 0x0400)
+
+/* RTC.CTRL bit masks and bit positions. */
+#define RTC_PRESCALER_gm  0x07  /*!< Prescaling Factor group mask. */
+#define RTC_PRESCALER_gp  0     /*!< Prescaling Factor group position. */
+
+/* RTC.STATUS bit masks and bit positions. */
+#define RTC_SYNCBUSY_bm   0x01  /*!< Synchronization Busy Flag bit mask. */
+
+/* RTC.INTCTRL bit masks and bit positions. */
+#define RTC_COMPINTLVL_gm  0x0C  /*!< Compare Match Interrupt Level group mask. */
+#define RTC_COMPINTLVL_gp  2     /*!< Compare Match Interrupt Level group position. */
+#define RTC_OVFINTLVL_gm   0x03  /*!< Overflow Interrupt Level group mask. */
+#define RTC_OVFINTLVL_gp   0     /*!< Overflow Interrupt Level group position. */
+
+/* RTC.INTFLAGS bit masks and bit positions. */
+#define RTC_COMPIF_bm     0x02  /*!< Compare Match Interrupt Flag bit mask. */
+#define RTC_OVFIF_bm      0x01  /*!< Overflow Interrupt Flag bit mask. */
+
+/*! Prescaler Factor. */
+typedef enum RTC_PRESCALER_enum {
+	RTC_PRESCALER_OFF_gc = (0x00<<0),      /*!< RTC Off. */
+	RTC_PRESCALER_DIV1_gc = (0x01<<0),     /*!< RTC Clock. */
+	RTC_PRESCALER_DIV2_gc = (0x02<<0),     /*!< RTC Clock / 2. */
+	RTC_PRESCALER_DIV8_gc = (0x03<<0),     /*!< RTC Clock / 8. */
+	RTC_PRESCALER_DIV16_gc = (0x04<<0),    /*!< RTC Clock / 16. */
+	RTC_PRESCALER_DIV64_gc = (0x05<<0),    /*!< RTC Clock / 64. */
+	RTC_PRESCALER_DIV256_gc = (0x06<<0),   /*!< RTC Clock / 256. */
+	RTC_PRESCALER_DIV1024_gc = (0x07<<0),  /*!< RTC Clock / 1024. */
+} RTC_PRESCALER_t;
+
+
+/* VBAT - Battery Backup Module *********************************************/
+
+/*! Battery Backup Module. */
+typedef struct VBAT_struct {
+	register8_t CTRL;     /*!< Control Register. */
+	register8_t STATUS;   /*!< Status Register. */
+	register8_t BACKUP0;  /*!< Backup Register 0. */
+	register8_t BACKUP1;  /*!< Backup Register 1. */
+} VBAT_t;
+
+#define VBAT  SIM_IO(VBAT_t, 0x00F0)
+
+/* VBAT.CTRL bit masks and bit positions. */
+#define VBAT_XOSCSEL_bm   0x10  /*!< 32-kHz Crystal Oscillator Output Selection bit mask. */
+#define VBAT_XOSCEN_bm    0x08  /*!< Crystal Oscillator Enable bit mask. */
+#define VBAT_XOSCFDEN_bm  0x04  /*!< Crystal Oscillator Failure Detection Monitor Enable bit mask. */
+#define VBAT_ACCEN_bm     0x02  /*!< Access Enable bit mask. */
+#define VBAT_RESET_bm     0x01  /*!< Reset bit mask. */
+
+/* VBAT.STATUS bit masks and bit positions. */
+#define VBAT_BBPWR_bm     0x80  /*!< Battery backup Power bit mask. */
+#define VBAT_XOSCRDY_bm   0x08  /*!< Crystal Oscillator Ready bit mask. */
+#define VBAT_XOSCFAIL_bm  0x04  /*!< Crystal Oscillator Failure bit mask. */
+#define VBAT_BBBORF_bm    0x02  /*!< Battery Backup Brown-Out Reset Flag bit mask. */
+#define VBAT_BBPORF_bm    0x01  /*!< Battery Backup Power-On Reset Flag bit mask. */
+
+
+/* RTC32 - 32-bit Real-Time Counter *****************************************/
+
+/*! 32-bit Real-Time Counter. */
+typedef struct RTC32_struct {
+	register8_t CTRL;      /*!< Control Register. */
+	register8_t SYNCCTRL;  /*!< Synchronization Control/Status Register. */
+	register8_t INTCTRL;   /*!< Interrupt Control Register. */
+	register8_t INTFLAGS;  /*!< Interrupt Flags. */
+	register8_t reserved_0x04;
+	register8_t reserved_0x05;
+	register8_t reserved_0x06;
+	register8_t reserved_0x07;
+	register32_t CNT;      /*!< Count Register. */
+	register32_t PER;      /*!< Period Register. */
+	register32_t COMP;     /*!< Compare Register. */
+} RTC32_t;
+
+#define RTC32  SIM_IO(RTC32_t, 0x0420)
+
+/* RTC32.CTRL bit masks and bit positions. */
+#define RTC32_ENABLE_bm    0x01  /*!< RTC enable bit mask. */
+
+/* RTC32.SYNCCTRL bit masks and bit positions. */
+#define RTC32_SYNCCNT_bm   0x10  /*!< Synchronize Count Register bit mask. */
+#define RTC32_SYNCBUSY_bm  0x01  /*!< Synchronization Busy Flag bit mask. */
+
+/* RTC32.INTCTRL bit masks and bit positions. */
+#define RTC32_COMPINTLVL_gm  0x0C  /*!< Compare Match Interrupt Level group mask. */
+#define RTC32_COMPINTLVL_gp  2     /*!< Compare Match Interrupt Level group position. */
+#define RTC32_OVFINTLVL_gm   0x03  /*!< Overflow Interrupt Level group mask. */
+#define RTC32_OVFINTLVL_gp   0     /*!< Overflow Interrupt Level group position. */
+
+/* RTC32.INTFLAGS bit masks and bit positions. */
+#define RTC32_COMPIF_bm    0x02  /*!< Compare Match Interrupt Flag bit mask. */
+#define RTC32_OVFIF_bm     0x01  /*!< Overflow Interrupt Flag bit mask. */
+
+/*! Compare Interrupt level. */
+typedef enum RTC32_COMPINTLVL_enum {
+	RTC32_COMPINTLVL_OFF_gc = (0x00<<2),  /*!< Interrupt Disabled. */
+	RTC32_COMPINTLVL_LO_gc = (0x01<<2),   /*!< Low Level. */
+	RTC32_COMPINTLVL_MED_gc = (0x02<<2),  /*!< Medium Level. */
+	RTC32_COMPINTLVL_HI_gc = (0x03<<2),   /*!< High Level. */
+} RTC32_COMPINTLVL_t;
+
+/*! Overflow Interrupt level. */
+typedef enum RTC32_OVFINTLVL_enum {
+	RTC32_OVFINTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt Disabled. */
+	RTC32_OVFINTLVL_LO_gc = (0x01<<0),   /*!< Low Level. */
+	RTC32_OVFINTLVL_MED_gc = (0x02<<0),  /*!< Medium Level. */
+	RTC32_OVFINTLVL_HI_gc = (0x03<<0),   /*!< High Level. */
+} RTC32_OVFINTLVL_t;
+
+
+/* TC - 16-bit Timer/Counter With PWM ****************************************/
+
+/*! 16-bit Timer/Counter 0. */
+typedef struct TC0_struct {
+	register8_t CTRLA;     /*!< Control  Register A. */
+	register8_t CTRLB;     /*!< Control Register B. */
+	register8_t CTRLC;     /*!< Control register C. */
+	register8_t CTRLD;     /*!< Control Register D. */
+	register8_t CTRLE;     /*!< Control Register E. */
+	register8_t reserved_0x05;
+	register8_t INTCTRLA;  /*!< Interrupt Control Register A. */
+	register8_t INTCTRLB;  /*!< Interrupt Control Register B. */
+	register8_t CTRLFCLR;  /*!< Control Register F Clear. */
+	register8_t CTRLFSET;  /*!< Control Register F Set. */
+	register8_t CTRLGCLR;  /*!< Control Register G Clear. */
+	register8_t CTRLGSET;  /*!< Control Register G Set. */
+	register8_t INTFLAGS;  /*!< Interrupt Flag Register. */
+	register8_t reserved_0x0D;
+	register8_t reserved_0x0E;
+	register8_t TEMP;      /*!< Temporary Register For 16-bit Access. */
+	register8_t reserved_0x10[16];
+	register16_t CNT;      /*!< Count. */
+	register8_t reserved_0x22[4];
+	register16_t PER;      /*!< Period. */
+	register16_t CCA;      /*!< Compare or Capture A. */
+	register16_t CCB;      /*!< Compare or Capture B. */
+	register16_t CCC;      /*!< Compare or Capture C. */
+	register16_t CCD;      /*!< Compare or Capture D. */
+	register8_t reserved_0x30[6];
+	register16_t PERBUF;   /*!< Period Buffer. */
+	register16_t CCABUF;   /*!< Compare Or Capture A Buffer. */
+	register16_t CCBBUF;   /*!< Compare Or Capture B Buffer. */
+	register16_t CCCBUF;   /*!< Compare Or Capture C Buffer. */
+	register16_t CCDBUF;   /*!< Compare Or Capture D Buffer. */
+} TC0_t;
+
+#define TCC0  SIM_IO(TC0_t, 0x0800)
+#define TCD0  SIM_IO(TC0_t, 0x0900)
+#define TCE0  SIM_IO(TC0_t, 0x0A00)
+#define TCF0  SIM_IO(TC0_t, 0x0B00)
+
+/* TC0.CTRLA bit masks and bit positions. */
+#define TC0_CLKSEL_gm     0x0F  /*!< Clock Selection group mask. */
+#define TC0_CLKSEL_gp     0
+
+/* TC0.CTRLB bit masks and bit positions. */
+#define TC0_CCDEN_bm      0x80  /*!< Compare or Capture D Enable bit mask. */
+#define TC0_CCCEN_bm      0x40  /*!< Compare or Capture C Enable bit mask. */
+#define TC0_CCBEN_bm      0x20  /*!< Compare or Capture B Enable bit mask. */
+#define TC0_CCAEN_bm      0x10  /*!< Compare or Capture A Enable bit mask. */
+#define TC0_WGMODE_gm     0x07  /*!< Waveform generation mode group mask. */
+#define TC0_WGMODE_gp     0
+
+/* TC0.CTRLD bit masks and bit positions. */
+#define TC0_EVACT_gm      0xE0  /*!< Event Action group mask. */
+#define TC0_EVACT_gp      5
+#define TC0_EVDLY_bm      0x10  /*!< Event Delay bit mask. */
+#define TC0_EVDLY_bp      4
+#define TC0_EVSEL_gm      0x0F  /*!< Event Source Select group mask. */
+#define TC0_EVSEL_gp      0
+
+/* TC0.INTCTRLA bit masks and bit positions. */
+#define TC0_ERRINTLVL_gm  0x0C  /*!< Error Interrupt Level group mask. */
+#define TC0_ERRINTLVL_gp  2
+#define TC0_OVFINTLVL_gm  0x03  /*!< Overflow interrupt level group mask. */
+#define TC0_OVFINTLVL_gp  0
+
+/* TC0.INTCTRLB bit masks and bit positions. */
+#define TC0_CCDINTLVL_gm  0xC0  /*!< Compare or Capture D Interrupt Level group mask. */
+#define TC0_CCDINTLVL_gp  6
+#define TC0_CCCINTLVL_gm  0x30  /*!< Compare or Capture C Interrupt Level group mask. */
+#define TC0_CCCINTLVL_gp  4
+#define TC0_CCBINTLVL_gm  0x0C  /*!< Compare or Capture B Interrupt Level group mask. */
+#define TC0_CCBINTLVL_gp  2
+#define TC0_CCAINTLVL_gm  0x03  /*!< Compare or Capture A Interrupt Level group mask. */
+#define TC0_CCAINTLVL_gp  0
+
+/* TC0.CTRLFCLR and TC0.CTRLFSET bit masks and bit positions. */
+#define TC0_CMD_gm        0x0C  /*!< Command group mask. */
+#define TC0_CMD_gp        2
+#define TC0_LUPD_bm       0x02  /*!< Lock Update bit mask. */
+#define TC0_LUPD_bp       1
+#define TC0_DIR_bm        0x01  /*!< Direction bit mask. */
+#define TC0_DIR_bp        0
+
+/* TC0.CTRLGCLR and TC0.CTRLGSET bit masks and bit positions. */
+#define TC0_CCDBV_bm      0x10  /*!< Compare or Capture D Buffer Valid bit mask. */
+#define TC0_CCDBV_bp      4
+#define TC0_CCCBV_bm      0x08  /*!< Compare or Capture C Buffer Valid bit mask. */
+#define TC0_CCCBV_bp      3
+#define TC0_CCBBV_bm      0x04  /*!< Compare or Capture B Buffer Valid bit mask. */
+#define TC0_CCBBV_bp      2
+#define TC0_CCABV_bm      0x02  /*!< Compare or Capture A Buffer Valid bit mask. */
+#define TC0_CCABV_bp      1
+#define TC0_PERBV_bm      0x01  /*!< Period Buffer Valid bit mask. */
+#define TC0_PERBV_bp      0
+
+/* TC0.INTFLAGS bit masks and bit positions. */
+#define TC0_CCDIF_bm      0x80  /*!< Compare or Capture D Interrupt Flag bit mask. */
+#define TC0_CCDIF_bp      7
+#define TC0_CCCIF_bm      0x40  /*!< Compare or Capture C Interrupt Flag bit mask. */
+#define TC0_CCCIF_bp      6
+#define TC0_CCBIF_bm      0x20  /*!< Compare or Capture B Interrupt Flag bit mask. */
+#define TC0_CCBIF_bp      5
+#define TC0_CCAIF_bm      0x10  /*!< Compare or Capture A Interrupt Flag bit mask. */
+#define TC0_CCAIF_bp      4
+#define TC0_ERRIF_bm      0x02  /*!< Error Interrupt Flag bit mask. */
+#define TC0_ERRIF_bp      1
+#define TC0_OVFIF_bm      0x01  /*!< Overflow Interrupt Flag bit mask. */
+#define TC0_OVFIF_bp      0
+
+/*! Clock Selection. */
+typedef enum TC_CLKSEL_enum {
+	TC_CLKSEL_OFF_gc = (0x00<<0),      /*!< Timer Off. */
+	TC_CLKSEL_DIV1_gc = (0x01<<0),     /*!< System Clock. */
+	TC_CLKSEL_DIV2_gc = (0x02<<0),     /*!< System Clock / 2. */
+	TC_CLKSEL_DIV4_gc = (0x03<<0),     /*!< System Clock / 4. */
+	TC_CLKSEL_DIV8_gc = (0x04<<0),     /*!< System Clock / 8. */
+	TC_CLKSEL_DIV64_gc = (0x05<<0),    /*!< System Clock / 64. */
+	TC_CLKSEL_DIV256_gc = (0x06<<0),   /*!< System Clock / 256. */
+	TC_CLKSEL_DIV1024_gc = (0x07<<0),  /*!< System Clock / 1024. */
+	TC_CLKSEL_EVCH0_gc = (0x08<<0),    /*!< Event Channel 0. */
+	TC_CLKSEL_EVCH1_gc = (0x09<<0),    /*!< Event Channel 1. */
+	TC_CLKSEL_EVCH2_gc = (0x0A<<0),    /*!< Event Channel 2. */
+	TC_CLKSEL_EVCH3_gc = (0x0B<<0),    /*!< Event Channel 3. */
+	TC_CLKSEL_EVCH4_gc = (0x0C<<0),    /*!< Event Channel 4. */
+	TC_CLKSEL_EVCH5_gc = (0x0D<<0),    /*!< Event Channel 5. */
+	TC_CLKSEL_EVCH6_gc = (0x0E<<0),    /*!< Event Channel 6. */
+	TC_CLKSEL_EVCH7_gc = (0x0F<<0),    /*!< Event Channel 7. */
+} TC_CLKSEL_t;
+
+/*! Waveform Generation Mode. */
+typedef enum TC_WGMODE_enum {
+	TC_WGMODE_NORMAL_gc = (0x00<<0),  /*!< Normal Mode. */
+	TC_WGMODE_FRQ_gc = (0x01<<0),     /*!< Frequency Generation Mode. */
+	TC_WGMODE_SS_gc = (0x03<<0),      /*!< Single Slope. */
+	TC_WGMODE_DS_T_gc = (0x05<<0),    /*!< Dual Slope, Update on TOP. */
+	TC_WGMODE_DS_TB_gc = (0x06<<0),   /*!< Dual Slope, Update on TOP and BOTTOM. */
+	TC_WGMODE_DS_B_gc = (0x07<<0),    /*!< Dual Slope, Update on BOTTOM. */
+} TC_WGMODE_t;
+
+/*! Event Action. */
+typedef enum TC_EVACT_enum {
+	TC_EVACT_OFF_gc = (0x00<<5),      /*!< No Event Action. */
+	TC_EVACT_CAPT_gc = (0x01<<5),     /*!< Input Capture. */
+	TC_EVACT_UPDOWN_gc = (0x02<<5),   /*!< Externally Controlled Up/Down Count. */
+	TC_EVACT_QDEC_gc = (0x03<<5),     /*!< Quadrature Decode. */
+	TC_EVACT_RESTART_gc = (0x04<<5),  /*!< Restart. */
+	TC_EVACT_FRQ_gc = (0x05<<5),      /*!< Frequency Capture. */
+	TC_EVACT_PW_gc = (0x06<<5),       /*!< Pulse-width Capture. */
+} TC_EVACT_t;
+
+/*! Event Selection. */
+typedef enum TC_EVSEL_enum {
+	TC_EVSEL_OFF_gc = (0x00<<0),  /*!< No Event Source. */
+	TC_EVSEL_CH0_gc = (0x08<<0),  /*!< Event Channel 0. */
+	TC_EVSEL_CH1_gc = (0x09<<0),  /*!< Event Channel 1. */
+	TC_EVSEL_CH2_gc = (0x0A<<0),  /*!< Event Channel 2. */
+	TC_EVSEL_CH3_gc = (0x0B<<0),  /*!< Event Channel 3. */
+	TC_EVSEL_CH4_gc = (0x0C<<0),  /*!< Event Channel 4. */
+	TC_EVSEL_CH5_gc = (0x0D<<0),  /*!< Event Channel 5. */
+	TC_EVSEL_CH6_gc = (0x0E<<0),  /*!< Event Channel 6. */
+	TC_EVSEL_CH7_gc = (0x0F<<0),  /*!< Event Channel 7. */
+} TC_EVSEL_t;
+
+/*! Timer/Counter Command. */
+typedef enum TC_CMD_enum {
+	TC_CMD_NONE_gc = (0x00<<2),     /*!< No Command. */
+	TC_CMD_UPDATE_gc = (0x01<<2),   /*!< Force Update. */
+	TC_CMD_RESTART_gc = (0x02<<2),  /*!< Force Restart. */
+	TC_CMD_RESET_gc = (0x03<<2),    /*!< Force Hard Reset. */
+} TC_CMD_t;
+
+/*! Overflow Interrupt Level. */
+typedef enum TC_OVFINTLVL_enum {
+	TC_OVFINTLVL_OFF_gc = (0x00<<0),/*!< Interrupt Disabled. */
+	TC_OVFINTLVL_LO_gc = (0x01<<0),/*!< Low Level. */
+	TC_OVFINTLVL_MED_gc = (0x02<<0),/*!< Medium Level. */
+	TC_OVFINTLVL_HI_gc = (0x03<<0),/*!< High Level. */
+} TC_OVFINTLVL_t;
+
+/*! Error Interrupt Level. */
+typedef enum TC_ERRINTLVL_enum {
+	TC_ERRINTLVL_OFF_gc = (0x00<<2),/*!< Interrupt Disabled. */
+	TC_ERRINTLVL_LO_gc = (0x01<<2),/*!< Low Level. */
+	TC_ERRINTLVL_MED_gc = (0x02<<2),/*!< Medium Level. */
+	TC_ERRINTLVL_HI_gc = (0x03<<2),/*!< High Level. */
+} TC_ERRINTLVL_t;
+
+/*! Compare or Capture A Interrupt Level. */
+typedef enum TC_CCAINTLVL_enum {
+	TC_CCAINTLVL_OFF_gc = (0x00<<0),/*!< Interrupt Disabled. */
+	TC_CCAINTLVL_LO_gc = (0x01<<0),/*!< Low Level. */
+	TC_CCAINTLVL_MED_gc = (0x02<<0),/*!< Medium Level. */
+	TC_CCAINTLVL_HI_gc = (0x03<<0),/*!< High Level. */
+} TC_CCAINTLVL_t;
+
+/*! Compare or Capture B Interrupt Level. */
+typedef enum TC_CCBINTLVL_enum {
+	TC_CCBINTLVL_OFF_gc = (0x00<<2),/*!< Interrupt Disabled. */
+	TC_CCBINTLVL_LO_gc = (0x01<<2),/*!< Low Level. */
+	TC_CCBINTLVL_MED_gc = (0x02<<2),/*!< Medium Level. */
+	TC_CCBINTLVL_HI_gc = (0x03<<2),/*!< High Level. */
+} TC_CCBINTLVL_t;
+
+/*! Compare or Capture C Interrupt Level. */
+typedef enum TC_CCCINTLVL_enum {
+	TC_CCCINTLVL_OFF_gc = (0x00<<4),/*!< Interrupt Disabled. */
+	TC_CCCINTLVL_LO_gc = (0x01<<4),/*!< Low Level. */
+	TC_CCCINTLVL_MED_gc = (0x02<<4),/*!< Medium Level. */
+	TC_CCCINTLVL_HI_gc = (0x03<<4),/*!< High Level. */
+} TC_CCCINTLVL_t;
+
+/*! Compare or Capture D Interrupt Level. */
+typedef enum TC_CCDINTLVL_enum {
+	TC_CCDINTLVL_OFF_gc = (0x00<<6),/*!< Interrupt Disabled. */
+	TC_CCDINTLVL_LO_gc = (0x01<<6),/*!< Low Level. */
+	TC_CCDINTLVL_MED_gc = (0x02<<6),/*!< Medium Level. */
+	TC_CCDINTLVL_HI_gc = (0x03<<6),/*!< High Level. */
+} TC_CCDINTLVL_t;
+
+
+/* AWEX - Advanced Waveform Extension ****************************************/
+
+/*! Advanced Waveform Extension. */
+typedef struct AWEX_struct {
+	register8_t CTRL;       /*!< Control Register. */
+	register8_t reserved_0x01;
+	register8_t FDEVMASK;   /*!< Fault Detection Event Mask. */
+	register8_t FDCTRL;     /*!< Fault Detection Control Register. */
+	register8_t STATUS;     /*!< Status Register. */
+	register8_t reserved_0x05;
+	register8_t DTBOTH;     /*!< Dead Time Both Sides. */
+	register8_t DTBOTHBUF;  /*!< Dead Time Both Sides Buffer. */
+	register8_t DTLS;       /*!< Dead Time Low Side. */
+	register8_t DTHS;       /*!< Dead Time High Side. */
+	register8_t DTLSBUF;    /*!< Dead Time Low Side Buffer. */
+	register8_t DTHSBUF;    /*!< Dead Time High Side Buffer. */
+	register8_t OUTOVEN;    /*!< Output Override Enable. */
+} AWEX_t;
+
+#define AWEXC  SIM_IO(AWEX_t, 0x0880)
+#define AWEXE  SIM_IO(AWEX_t, 0x0A80)
+
+/* AWEX.CTRL bit masks and bit positions. */
+#define AWEX_PGM_bm       0x20  /*!< Pattern Generation Mode bit mask. */
+#define AWEX_PGM_bp       5
+#define AWEX_CWCM_bm      0x10  /*!< Common Waveform Channel Mode bit mask. */
+#define AWEX_CWCM_bp      4
+#define AWEX_DTICCDEN_bm  0x08  /*!< Dead Time Insertion Compare Channel D Enable bit mask. */
+#define AWEX_DTICCDEN_bp  3
+#define AWEX_DTICCCEN_bm  0x04  /*!< Dead Time Insertion Compare Channel C Enable bit mask. */
+#define AWEX_DTICCCEN_bp  2
+#define AWEX_DTICCBEN_bm  0x02  /*!< Dead Time Insertion Compare Channel B Enable bit mask. */
+#define AWEX_DTICCBEN_bp  1
+#define AWEX_DTICCAEN_bm  0x01  /*!< Dead Time Insertion Compare Channel A Enable bit mask. */
+#define AWEX_DTICCAEN_bp  0
+
+/* AWEX.FDCTRL bit masks and bit positions. */
+#define AWEX_FDDBD_bm     0x10  /*!< Fault Detect on Disable Break Disable bit mask. */
+#define AWEX_FDDBD_bp     4
+#define AWEX_FDMODE_bm    0x04  /*!< Fault Detection Mode bit mask. */
+#define AWEX_FDMODE_bp    2
+#define AWEX_FDACT_gm     0x03  /*!< Fault Detection Action group mask. */
+#define AWEX_FDACT_gp     0
+
+/* AWEX.STATUS bit masks and bit positions. */
+#define AWEX_FDF_bm       0x04  /*!< Fault Detection Flag bit mask. */
+#define AWEX_FDF_bp       2
+#define AWEX_DTHSBUFV_bm  0x02  /*!< Dead Time High Side Buffer Valid bit mask. */
+#define AWEX_DTHSBUFV_bp  1
+#define AWEX_DTLSBUFV_bm  0x01  /*!< Dead Time Low Side Buffer Valid bit mask. */
+#define AWEX_DTLSBUFV_bp  0
+
+/*! Fault Detect Action. */
+typedef enum AWEX_FDACT_enum {
+	AWEX_FDACT_NONE_gc = (0x00<<0),      /*!< No Fault Protection. */
+	AWEX_FDACT_CLEAROE_gc = (0x01<<0),   /*!< Clear Output Enable Bits. */
+	AWEX_FDACT_CLEARDIR_gc = (0x03<<0),  /*!< Clear I/O Port Direction Bits. */
+} AWEX_FDACT_t;
+
+
+/* HIRES - High-Resolution Extension *****************************************/
+
+/*! High-Resolution Extension. */
+typedef struct HIRES_struct {
+	register8_t CTRL;  /*!< Control Register. */
+} HIRES_t;
+
+#define HIRESC  SIM_IO(HIRES_t, 0x0890)
+#define HIRESD  SIM_IO(HIRES_t, 0x0990)
+#define HIRESE  SIM_IO(HIRES_t, 0x0A90)
+#define HIRESF  SIM_IO(HIRES_t, 0x0B90)
+
+/* HIRES.CTRL bit masks and bit positions. */
+#define HIRES_HREN_gm     0x03  /*!< High Resolution Enable group mask. */
+#define HIRES_HREN_gp     0
+
+/*! High Resolution Enable. */
+typedef enum HIRES_HREN_enum {
+	HIRES_HREN_NONE_gc = (0x00<<0),  /*!< High Resolution Disabled. */
+	HIRES_HREN_TC0_gc = (0x01<<0),   /*!< Enable High Resolution on Timer/Counter 0. */
+	HIRES_HREN_TC1_gc = (0x02<<0),   /*!< Enable High Resolution on Timer/Counter 1. */
+	HIRES_HREN_BOTH_gc = (0x03<<0),  /*!< Enable High Resolution both Timer/Counters. */
+} HIRES_HREN_t;
+
+
+/* SPI - Serial Peripheral Interface ****************************************/
+
+/*! Serial Peripheral Interface. */
+typedef struct SPI_struct {
+	register8_t CTRL;     /*!< Control Register. */
+	register8_t INTCTRL;  /*!< Interrupt Control Register. */
+	register8_t STATUS;   /*!< Status Register. */
+	register8_t DATA;     /*!< Data Register. */
+} SPI_t;
+
+#define SPIC  SIM_IO(SPI_t, 0x08C0)
+#define SPID  SIM_IO(SPI_t, 0x09C0)
+#define SPIE  SIM_IO(SPI_t, 0x0AC0)
+#define SPIF  SIM_IO(SPI_t, 0x0BC0)
+
+/* SPI.CTRL bit masks and bit positions. */
+#define SPI_CLK2X_bm      0x80  /*!< Enable Double Speed bit mask. */
+#define SPI_CLK2X_bp      7
+#define SPI_ENABLE_bm     0x40  /*!< Enable Module bit mask. */
+#define SPI_ENABLE_bp     6
+#define SPI_DORD_bm       0x20  /*!< Data Order Setting bit mask. */
+#define SPI_DORD_bp       5
+#define SPI_MASTER_bm     0x10  /*!< Master Operation Enable bit mask. */
+#define SPI_MASTER_bp     4
+#define SPI_MODE_gm       0x0C  /*!< SPI Mode group mask. */
+#define SPI_MODE_gp       2
+#define SPI_PRESCALER_gm  0x03  /*!< Prescaler group mask. */
+#define SPI_PRESCALER_gp  0
+
+/* SPI.INTCTRL bit masks and bit positions. */
+#define SPI_INTLVL_gm  0x03  /*!< Interrupt level group mask. */
+#define SPI_INTLVL_gp  0
+
+/* SPI.STATUS bit masks and bit positions. */
+#define SPI_IF_bm     0x80  /*!< Interrupt Flag bit mask. */
+#define SPI_IF_bp     7
+#define SPI_WRCOL_bm  0x40  /*!< Write Collision bit mask. */
+#define SPI_WRCOL_bp  6
+
+/*! SPI Mode. */
+typedef enum SPI_MODE_enum {
+	SPI_MODE_0_gc = (0x00<<2),  /*!< SPI Mode 0. */
+	SPI_MODE_1_gc = (0x01<<2),  /*!< SPI Mode 1. */
+	SPI_MODE_2_gc = (0x02<<2),  /*!< SPI Mode 2. */
+	SPI_MODE_3_gc = (0x03<<2),  /*!< SPI Mode 3. */
+} SPI_MODE_t;
+
+/*! Prescaler setting. */
+typedef enum SPI_PRESCALER_enum {
+	SPI_PRESCALER_DIV4_gc = (0x00<<0),    /*!< System Clock / 4. */
+	SPI_PRESCALER_DIV16_gc = (0x01<<0),   /*!< System Clock / 16. */
+	SPI_PRESCALER_DIV64_gc = (0x02<<0),   /*!< System Clock / 64. */
+	SPI_PRESCALER_DIV128_gc = (0x03<<0),  /*!< System Clock / 128. */
+} SPI_PRESCALER_t;
+
+/*! Interrupt level. */
+typedef enum SPI_INTLVL_enum {
+	SPI_INTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt Disabled. */
+	SPI_INTLVL_LO_gc = (0x01<<0),   /*!< Low Level. */
+	SPI_INTLVL_MED_gc = (0x02<<0),  /*!< Medium Level. */
+	SPI_INTLVL_HI_gc = (0x03<<0),   /*!< High Level. */
+} SPI_INTLVL_t;
+
+
+/* TWI - Two-Wire Interface **************************************************/
+
+/*! TWI master. */
+typedef struct TWI_MASTER_struct {
+	register8_t CTRLA;   /*!< Control Register A. */
+	register8_t CTRLB;   /*!< Control Register B. */
+	register8_t CTRLC;   /*!< Control Register C. */
+	register8_t STATUS;  /*!< Status Register. */
+	register8_t BAUD;    /*!< Baud Rate Control Register. */
+	register8_t ADDR;    /*!< Address Register. */
+	register8_t DATA;    /*!< Data Register. */
+} TWI_MASTER_t;
+
+/*! TWI slave. */
+typedef struct TWI_SLAVE_struct {
+	register8_t CTRLA;     /*!< Control Register A. */
+	register8_t CTRLB;     /*!< Control Register B. */
+	register8_t STATUS;    /*!< Status Register. */
+	register8_t ADDR;      /*!< Address Register. */
+	register8_t DATA;      /*!< Data Register. */
+	register8_t ADDRMASK;  /*!< Address Mask Register. */
+} TWI_SLAVE_t;
+
+/*! Two-Wire Interface. */
+typedef struct TWI_struct {
+	register8_t CTRL;     /*!< TWI Common Control Register. */
+	TWI_MASTER_t MASTER;  /*!< TWI master module. */
+	TWI_SLAVE_t SLAVE;    /*!< TWI slave module. */
+} TWI_t;
+
+#define TWIC  SIM_IO(TWI_t, 0x0480)
+#define TWID  SIM_IO(TWI_t, 0x0490)
+#define TWIE  SIM_IO(TWI_t, 0x04A0)
+#define TWIF  SIM_IO(TWI_t, 0x04B0)
+
+/* TWI.CTRL bit masks and bit positions. */
+#define TWI_SDAHOLD_bm  0x02  /*!< SDA Hold Time Enable bit mask. */
+#define TWI_SDAHOLD_bp  1
+#define TWI_EDIEN_bm    0x01  /*!< External Driver Interface Enable bit mask. */
+#define TWI_EDIEN_bp    0
+
+/* TWI_MASTER.CTRLA bit masks and bit positions. */
+#define TWI_MASTER_INTLVL_gm    0xC0  /*!< Interrupt Level group mask. */
+#define TWI_MASTER_INTLVL_gp    6
+#define TWI_MASTER_RIEN_bm      0x20  /*!< Read Interrupt Enable bit mask. */
+#define TWI_MASTER_RIEN_bp      5
+#define TWI_MASTER_WIEN_bm      0x10  /*!< Write Interrupt Enable bit mask. */
+#define TWI_MASTER_WIEN_bp      4
+#define TWI_MASTER_ENABLE_bm    0x08  /*!< Enable TWI Master bit mask. */
+#define TWI_MASTER_ENABLE_bp    3
+
+/* TWI_MASTER.CTRLB bit masks and bit positions. */
+#define TWI_MASTER_TIMEOUT_gm   0x0C  /*!< Inactive Bus Timeout group mask. */
+#define TWI_MASTER_TIMEOUT_gp   2
+#define TWI_MASTER_QCEN_bm      0x02  /*!< Quick Command Enable bit mask. */
+#define TWI_MASTER_QCEN_bp      1
+#define TWI_MASTER_SMEN_bm      0x01  /*!< Smart Mode Enable bit mask. */
+#define TWI_MASTER_SMEN_bp      0
+
+/* TWI_MASTER.CTRLC bit masks and bit positions. */
+#define TWI_MASTER_ACKACT_bm    0x04  /*!< Acknowledge Action bit mask. */
+#define TWI_MASTER_ACKACT_bp    2
+#define TWI_MASTER_CMD_gm       0x03  /*!< Command group mask. */
+#define TWI_MASTER_CMD_gp       0
+
+/* TWI_MASTER.STATUS bit masks and bit positions. */
+#define TWI_MASTER_RIF_bm       0x80  /*!< Read Interrupt Flag bit mask. */
+#define TWI_MASTER_RIF_bp       7
+#define TWI_MASTER_WIF_bm       0x40  /*!< Write Interrupt Flag bit mask. */
+#define TWI_MASTER_WIF_bp       6
+#define TWI_MASTER_CLKHOLD_bm   0x20  /*!< Clock Hold bit mask. */
+#define TWI_MASTER_CLKHOLD_bp   5
+#define TWI_MASTER_RXACK_bm     0x10  /*!< Received Acknowledge bit mask. */
+#define TWI_MASTER_RXACK_bp     4
+#define TWI_MASTER_ARBLOST_bm   0x08  /*!< Arbitration Lost bit mask. */
+#define TWI_MASTER_ARBLOST_bp   3
+#define TWI_MASTER_BUSERR_bm    0x04  /*!< Bus Error bit mask. */
+#define TWI_MASTER_BUSERR_bp    2
+#define TWI_MASTER_BUSSTATE_gm  0x03  /*!< Bus State group mask. */
+#define TWI_MASTER_BUSSTATE_gp  0
+
+/* TWI_SLAVE.CTRLA bit masks and bit positions. */
+#define TWI_SLAVE_INTLVL_gm     0xC0  /*!< Interrupt Level group mask. */
+#define TWI_SLAVE_INTLVL_gp     6
+#define TWI_SLAVE_DIEN_bm       0x20  /*!< Data Interrupt Enable bit mask. */
+#define TWI_SLAVE_DIEN_bp       5
+#define TWI_SLAVE_APIEN_bm      0x10  /*!< Address/Stop Interrupt Enable bit mask. */
+#define TWI_SLAVE_APIEN_bp      4
+#define TWI_SLAVE_ENABLE_bm     0x08  /*!< Enable TWI Slave bit mask. */
+#define TWI_SLAVE_ENABLE_bp     3
+#define TWI_SLAVE_PIEN_bm       0x04  /*!< Stop Interrupt Enable bit mask. */
+#define TWI_SLAVE_PIEN_bp       2
+#define TWI_SLAVE_PMEN_bm       0x02  /*!< Promiscuous Mode Enable bit mask. */
+#define TWI_SLAVE_PMEN_bp       1
+#define TWI_SLAVE_SMEN_bm       0x01  /*!< Smart Mode Enable bit mask. */
+#define TWI_SLAVE_SMEN_bp       0
+
+/* TWI_SLAVE.CTRLB bit masks and bit positions. */
+#define TWI_SLAVE_ACKACT_bm     0x04  /*!< Acknowledge Action bit mask. */
+#define TWI_SLAVE_ACKACT_bp     2
+#define TWI_SLAVE_CMD_gm        0x03  /*!< Command group mask. */
+#define TWI_SLAVE_CMD_gp        0
+
+/* TWI_SLAVE.STATUS bit masks and bit positions. */
+#define TWI_SLAVE_DIF_bm        0x80  /*!< Data Interrupt Flag bit mask. */
+#define TWI_SLAVE_DIF_bp        7
+#define TWI_SLAVE_APIF_bm       0x40  /*!< Address/Stop Interrupt Flag bit mask. */
+#define TWI_SLAVE_APIF_bp       6
+#define TWI_SLAVE_CLKHOLD_bm    0x20  /*!< Clock Hold bit mask. */
+#define TWI_SLAVE_CLKHOLD_bp    5
+#define TWI_SLAVE_RXACK_bm      0x10  /*!< Received Acknowledge bit mask. */
+#define TWI_SLAVE_RXACK_bp      4
+#define TWI_SLAVE_COLL_bm       0x08  /*!< Collision bit mask. */
+#define TWI_SLAVE_COLL_bp       3
+#define TWI_SLAVE_BUSERR_bm     0x04  /*!< Bus Error bit mask. */
+#define TWI_SLAVE_BUSERR_bp     2
+#define TWI_SLAVE_DIR_bm        0x02  /*!< Read/Write Direction bit mask. */
+#define TWI_SLAVE_DIR_bp        1
+#define TWI_SLAVE_AP_bm         0x01  /*!< Slave Address or Stop bit mask. */
+#define TWI_SLAVE_AP_bp         0
+
+/*! Master Interrupt Level. */
+typedef enum TWI_MASTER_INTLVL_enum {
+	TWI_MASTER_INTLVL_OFF_gc = (0x00<<6),  /*!< Interrupt Disabled. */
+	TWI_MASTER_INTLVL_LO_gc = (0x01<<6),   /*!< Low Level. */
+	TWI_MASTER_INTLVL_MED_gc = (0x02<<6),  /*!< Medium Level. */
+	TWI_MASTER_INTLVL_HI_gc = (0x03<<6),   /*!< High Level. */
+} TWI_MASTER_INTLVL_t;
+
+/*! Inactive Timeout. */
+typedef enum TWI_MASTER_TIMEOUT_enum {
+	TWI_MASTER_TIMEOUT_DISABLED_gc = (0x00<<2),  /*!< Bus Timeout Disabled. */
+	TWI_MASTER_TIMEOUT_50US_gc = (0x01<<2),      /*!< 50 Microseconds. */
+	TWI_MASTER_TIMEOUT_100US_gc = (0x02<<2),     /*!< 100 Microseconds. */
+	TWI_MASTER_TIMEOUT_200US_gc = (0x03<<2),     /*!< 200 Microseconds. */
+} TWI_MASTER_TIMEOUT_t;
+
+/*! Master Command. */
+typedef enum TWI_MASTER_CMD_enum {
+	TWI_MASTER_CMD_NOACT_gc = (0x00<<0),      /*!< No Action. */
+	TWI_MASTER_CMD_REPSTART_gc = (0x01<<0),   /*!< Issue Repeated Start Condition. */
+	TWI_MASTER_CMD_RECVTRANS_gc = (0x02<<0),  /*!< Receive or Transmit Data. */
+	TWI_MASTER_CMD_STOP_gc = (0x03<<0),       /*!< Issue Stop Condition. */
+} TWI_MASTER_CMD_t;
+
+/*! Master Bus State. */
+typedef enum TWI_MASTER_BUSSTATE_enum {
+	TWI_MASTER_BUSSTATE_UNKNOWN_gc = (0x00<<0),  /*!< Unknown Bus State. */
+	TWI_MASTER_BUSSTATE_IDLE_gc = (0x01<<0),     /*!< Bus is Idle. */
+	TWI_MASTER_BUSSTATE_OWNER_gc = (0x02<<0),    /*!< This Module Controls The Bus. */
+	TWI_MASTER_BUSSTATE_BUSY_gc = (0x03<<0),     /*!< The Bus is Busy. */
+} TWI_MASTER_BUSSTATE_t;
+
+/*! Slave Interrupt Level. */
+typedef enum TWI_SLAVE_INTLVL_enum {
+	TWI_SLAVE_INTLVL_OFF_gc = (0x00<<6),  /*!< Interrupt Disabled. */
+	TWI_SLAVE_INTLVL_LO_gc = (0x01<<6),   /*!< Low Level. */
+	TWI_SLAVE_INTLVL_MED_gc = (0x02<<6),  /*!< Medium Level. */
+	TWI_SLAVE_INTLVL_HI_gc = (0x03<<6),   /*!< High Level. */
+} TWI_SLAVE_INTLVL_t;
+
+/*! Slave Command. */
+typedef enum TWI_SLAVE_CMD_enum {
+	TWI_SLAVE_CMD_NOACT_gc = (0x00<<0),      /*!< No Action. */
+	TWI_SLAVE_CMD_COMPTRANS_gc = (0x02<<0),  /*!< Used To Complete a Transaction. */
+	TWI_SLAVE_CMD_RESPONSE_gc = (0x03<<0),   /*!< Used in Response to Address/Data Interrupt. */
+} TWI_SLAVE_CMD_t;
+
+
+/* USART - Universal Asynchronous Receiver-Transmitter ***********************/
+
+/*! Universal Synchronous/Asynchronous Receiver/Transmitter. */
+typedef struct USART_struct {
+	register8_t DATA;       /*!< Data Register. */
+	register8_t STATUS;     /*!< Status Register. */
+	register8_t reserved_0x02;
+	register8_t CTRLA;      /*!< Control Register A. */
+	register8_t CTRLB;      /*!< Control Register B. */
+	register8_t CTRLC;      /*!< Control Register C. */
+	register8_t BAUDCTRLA;  /*!< Baud Rate Control Register A. */
+	register8_t BAUDCTRLB;  /*!< Baud Rate Control Register B. */
+} USART_t;
+
+#define USARTC0  SIM_IO(USART_t, 0x08A0)
+#define USARTC1  SIM_IO(USART_t, 0x08B0)
+#define USARTD0  SIM_IO(USART_t, 0x09A0)
+#define USARTD1  SIM_IO(USART_t, 0x09B0)
+#define USARTE0  SIM_IO(USART_t, 0x0AA0)
+#define USARTE1  SIM_IO(USART_t, 0x0AB0)
+#define USARTF0  SIM_IO(USART_t, 0x0BA0)
+#define USARTF1  SIM_IO(USART_t, 0x0BB0)
+
+/* USART.STATUS bit masks and bit positions. */
+#define USART_RXCIF_bm   0x80  /*!< Receive Interrupt Flag bit mask. */
+#define USART_RXCIF_bp   7
+#define USART_TXCIF_bm   0x40  /*!< Transmit Interrupt Flag bit mask. */
+#define USART_TXCIF_bp   6
+#define USART_DREIF_bm   0x20  /*!< Data Register Empty Flag bit mask. */
+#define USART_DREIF_bp   5
+#define USART_FERR_bm    0x10  /*!< Frame Error bit mask. */
+#define USART_FERR_bp    4
+#define USART_BUFOVF_bm  0x08  /*!< Buffer Overflow bit mask. */
+#define USART_BUFOVF_bp  3
+#define USART_PERR_bm    0x04  /*!< Parity Error bit mask. */
+#define USART_PERR_bp    2
+#define USART_RXB8_bm    0x01  /*!< Receive Bit 8 bit mask. */
+#define USART_RXB8_bp    0
+
+/* USART.CTRLA bit masks and bit positions. */
+#define USART_RXCINTLVL_gm  0x30  /*!< Receive Interrupt Level group mask. */
+#define USART_RXCINTLVL_gp  4
+#define USART_TXCINTLVL_gm  0x0C  /*!< Transmit Interrupt Level group mask. */
+#define USART_TXCINTLVL_gp  2
+#define USART_DREINTLVL_gm  0x03  /*!< Data Register Empty Interrupt Level group mask. */
+#define USART_DREINTLVL_gp  0
+
+/* USART.CTRLB bit masks and bit positions. */
+#define USART_RXEN_bm   0x10  /*!< Receiver Enable bit mask. */
+#define USART_RXEN_bp   4
+#define USART_TXEN_bm   0x08  /*!< Transmitter Enable bit mask. */
+#define USART_TXEN_bp   3
+#define USART_CLK2X_bm  0x04  /*!< Double transmission speed bit mask. */
+#define USART_CLK2X_bp  2
+#define USART_MPCM_bm   0x02  /*!< Multi-processor Communication Mode bit mask. */
+#define USART_MPCM_bp   1
+#define USART_TXB8_bm   0x01  /*!< Transmit bit 8 bit mask. */
+#define USART_TXB8_bp   0
+
+/* USART.CTRLC bit masks and bit positions. */
+#define USART_CMODE_gm   0xC0  /*!< Communication Mode group mask. */
+#define USART_CMODE_gp   6
+#define USART_PMODE_gm   0x30  /*!< Parity Mode group mask. */
+#define USART_PMODE_gp   4
+#define USART_SBMODE_bm  0x08  /*!< Stop Bit Mode bit mask. */
+#define USART_SBMODE_bp  3
+#define USART_CHSIZE_gm  0x07  /*!< Character Size group mask. */
+#define USART_CHSIZE_gp  0
+
+/* USART.BAUDCTRLB bit masks and bit positions. */
+#define USART_BSCALE_gm   0xF0  /*!< Baud Rate Scale group mask. */
+#define USART_BSCALE_gp   4
+#define USART_BSCALE0_bp  4
+#define USART_BSEL_gm     0x0F  /*!< Baud Rate Selection Bits [11:8] group mask. */
+#define USART_BSEL_gp     0
+
+/*! Receive Complete Interrupt level. */
+typedef enum USART_RXCINTLVL_enum {
+	USART_RXCINTLVL_OFF_gc = (0x00<<4),  /*!< Interrupt Disabled. */
+	USART_RXCINTLVL_LO_gc = (0x01<<4),   /*!< Low Level. */
+	USART_RXCINTLVL_MED_gc = (0x02<<4),  /*!< Medium Level. */
+	USART_RXCINTLVL_HI_gc = (0x03<<4),   /*!< High Level. */
+} USART_RXCINTLVL_t;
+
+/*! Transmit Complete Interrupt level. */
+typedef enum USART_TXCINTLVL_enum {
+	USART_TXCINTLVL_OFF_gc = (0x00<<2),  /*!< Interrupt Disabled. */
+	USART_TXCINTLVL_LO_gc = (0x01<<2),   /*!< Low Level. */
+	USART_TXCINTLVL_MED_gc = (0x02<<2),  /*!< Medium Level. */
+	USART_TXCINTLVL_HI_gc = (0x03<<2),   /*!< High Level. */
+} USART_TXCINTLVL_t;
+
+/*! Data Register Empty Interrupt level. */
+typedef enum USART_DREINTLVL_enum {
+	USART_DREINTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt Disabled. */
+	USART_DREINTLVL_LO_gc = (0x01<<0),   /*!< Low Level. */
+	USART_DREINTLVL_MED_gc = (0x02<<0),  /*!< Medium Level. */
+	USART_DREINTLVL_HI_gc = (0x03<<0),   /*!< High Level. */
+} USART_DREINTLVL_t;
+
+/*! Character Size. */
+typedef enum USART_CHSIZE_enum {
+	USART_CHSIZE_5BIT_gc = (0x00<<0),  /*!< Character size: 5 bit. */
+	USART_CHSIZE_6BIT_gc = (0x01<<0),  /*!< Character size: 6 bit. */
+	USART_CHSIZE_7BIT_gc = (0x02<<0),  /*!< Character size: 7 bit. */
+	USART_CHSIZE_8BIT_gc = (0x03<<0),  /*!< Character size: 8 bit. */
+	USART_CHSIZE_9BIT_gc = (0x07<<0),  /*!< Character size: 9 bit. */
+} USART_CHSIZE_t;
+
+/*! Communication Mode. */
+typedef enum USART_CMODE_enum {
+	USART_CMODE_ASYNCHRONOUS_gc = (0x00<<6),  /*!< Asynchronous Mode. */
+	USART_CMODE_SYNCHRONOUS_gc = (0x01<<6),   /*!< Synchronous Mode. */
+	USART_CMODE_IRDA_gc = (0x02<<6),          /*!< IrDA Mode. */
+	USART_CMODE_MSPI_gc = (0x03<<6),          /*!< Master SPI Mode. */
+} USART_CMODE_t;
+
+/*! Parity Mode. */
+typedef enum USART_PMODE_enum {
+	USART_PMODE_DISABLED_gc = (0x00<<4),  /*!< No Parity. */
+	USART_PMODE_EVEN_gc = (0x02<<4),      /*!< Even Parity. */
+	USART_PMODE_ODD_gc = (0x03<<4),       /*!< Odd Parity. */
+} USART_PMODE_t;
+
+
+/* IRCOM - IR Communication Module ******************************************/
+
+/*! IR Communication Module. */
+typedef struct IRCOM_struct {
+	register8_t TXPLCTRL;  /*!< IrDA Transmitter Pulse Length Control Register. */
+	register8_t RXPLCTRL;  /*!< IrDA Receiver Pulse Length Control Register. */
+	register8_t CTRL;      /*!< Control Register. */
+} IRCOM_t;
+
+#define IRCOM  SIM_IO(IRCOM_t, 0x08F8)
+
+#define IRCOM_TXPLCTRL  IRCOM.TXPLCTRL  /*!< IrDA Transmitter Pulse Length Control Register. */
+#define IRCOM_RXPLCTRL  IRCOM.RXPLCTRL  /*!< IrDA Receiver Pulse Length Control Register. */
+#define IRCOM_CTRL      IRCOM.CTRL      /*!< Control Register. */
+
+/* IRCOM.CTRL bit masks and bit positions. */
+#define IRCOM_EVSEL_gm  0x0F  /*!< Event Channel Select group mask. */
+#define IRCOM_EVSEL_gp  0     /*!< Event Channel Select group position. */
+
+/*! Event Channel Select. */
+typedef enum IRDA_EVSEL_enum {
+	IRDA_EVSEL_OFF_gc = (0x00<<0),  /*!< No Event Source. */
+	IRDA_EVSEL_0_gc = (0x08<<0),    /*!< Event Channel 0. */
+	IRDA_EVSEL_1_gc = (0x09<<0),    /*!< Event Channel 1. */
+	IRDA_EVSEL_2_gc = (0x0A<<0),    /*!< Event Channel 2. */
+	IRDA_EVSEL_3_gc = (0x0B<<0),    /*!< Event Channel 3. */
+	IRDA_EVSEL_4_gc = (0x0C<<0),    /*!< Event Channel 4. */
+	IRDA_EVSEL_5_gc = (0x0D<<0),    /*!< Event Channel 5. */
+	IRDA_EVSEL_6_gc = (0x0E<<0),    /*!< Event Channel 6. */
+	IRDA_EVSEL_7_gc = (0x0F<<0),    /*!< Event Channel 7. */
+} IRDA_EVSEL_t;
+
+
+/* DMA - DMA Controller ******************************************************/
+
+/*! DMA Channel. */
+typedef struct DMA_CH_struct {
+	register8_t CTRLA;      /*!< Channel Control. */
+	register8_t CTRLB;      /*!< Channel Control. */
+	register8_t ADDRCTRL;   /*!< Address Control. */
+	register8_t TRIGSRC;    /*!< Channel Trigger Source. */
+	register16_t TRFCNT;    /*!< Channel Block Transfer Count. */
+	register8_t REPCNT;     /*!< Channel Repeat Count. */
+	register8_t reserved_0x07;
+	register8_t SRCADDR0;   /*!< Channel Source Address 0. */
+	register8_t SRCADDR1;   /*!< Channel Source Address 1. */
+	register8_t SRCADDR2;   /*!< Channel Source Address 2. */
+	register8_t reserved_0x0B;
+	register8_t DESTADDR0;  /*!< Channel Destination Address 0. */
+	register8_t DESTADDR1;  /*!< Channel Destination Address 1. */
+	register8_t DESTADDR2;  /*!< Channel Destination Address 2. */
+	register8_t reserved_0x0F;
+} DMA_CH_t;
+
+/*! DMA Controller. */
+typedef struct DMA_struct {
+	register8_t CTRL;      /*!< Control. */
+	register8_t reserved_0x01;
+	register8_t reserved_0x02;
+	register8_t INTFLAGS;  /*!< Transfer Interrupt Status. */
+	register8_t STATUS;    /*!< Status. */
+	register8_t reserved_0x05;
+	register16_t TEMP;     /*!< Temporary Register For 16/24-bit Access. */
+	register8_t reserved_0x08;
+	register8_t reserved_0x09;
+	register8_t reserved_0x0A;
+	register8_t reserved_0x0B;
+	register8_t reserved_0x0C;
+	register8_t reserved_0x0D;
+	register8_t reserved_0x0E;
+	register8_t reserved_0x0F;
+	DMA_CH_t CH0;          /*!< DMA Channel 0. */
+	DMA_CH_t CH1;          /*!< DMA Channel 1. */
+	DMA_CH_t CH2;          /*!< DMA Channel 2. */
+	DMA_CH_t CH3;          /*!< DMA Channel 3. */
+} DMA_t;
+
+#define DMA  SIM_IO(DMA_t, 0x0100)
+
+/* DMA.CTRL bit masks and bit positions. */
+#define DMA_ENABLE_bm     0x80  /*!< Enable bit mask. */
+#define DMA_ENABLE_bp     7
+#define DMA_RESET_bm      0x40  /*!< Software Reset bit mask. */
+#define DMA_RESET_bp      6
+#define DMA_DBUFMODE_gm   0x0C  /*!< Double Buffering Mode group mask. */
+#define DMA_DBUFMODE_gp   2
+#define DMA_PRIMODE_gm    0x03  /*!< Channel Priority Mode group mask. */
+#define DMA_PRIMODE_gp    0
+
+/* DMA.INTFLAGS bit masks and bit positions. */
+#define DMA_CH3ERRIF_bm   0x80  /*!< Channel 3 Block Transfer Error Interrupt Flag bit mask. */
+#define DMA_CH2ERRIF_bm   0x40  /*!< Channel 2 Block Transfer Error Interrupt Flag bit mask. */
+#define DMA_CH1ERRIF_bm   0x20  /*!< Channel 1 Block Transfer Error Interrupt Flag bit mask. */
+#define DMA_CH0ERRIF_bm   0x10  /*!< Channel 0 Block Transfer Error Interrupt Flag bit mask. */
+#define DMA_CH3TRNIF_bm   0x08  /*!< Channel 3 Transaction Complete Interrupt Flag bit mask. */
+#define DMA_CH2TRNIF_bm   0x04  /*!< Channel 2 Transaction Complete Interrupt Flag bit mask. */
+#define DMA_CH1TRNIF_bm   0x02  /*!< Channel 1 Transaction Complete Interrupt Flag bit mask. */
+#define DMA_CH0TRNIF_bm   0x01  /*!< Channel 0 Transaction Complete Interrupt Flag bit mask. */
+
+/* DMA.STATUS bit masks and bit positions. */
+#define DMA_CH3BUSY_bm    0x80  /*!< Channel 3 Busy Flag bit mask. */
+#define DMA_CH2BUSY_bm    0x40  /*!< Channel 2 Busy Flag bit mask. */
+#define DMA_CH1BUSY_bm    0x20  /*!< Channel 1 Busy Flag bit mask. */
+#define DMA_CH0BUSY_bm    0x10  /*!< Channel 0 Busy Flag bit mask. */
+#define DMA_CH3PEND_bm    0x08  /*!< Channel 3 Pending Flag bit mask. */
+#define DMA_CH2PEND_bm    0x04  /*!< Channel 2 Pending Flag bit mask. */
+#define DMA_CH1PEND_bm    0x02  /*!< Channel 1 Pending Flag bit mask. */
+#define DMA_CH0PEND_bm    0x01  /*!< Channel 0 Pending Flag bit mask. */
+
+/* DMA_CH.CTRLA bit masks and bit positions. */
+#define DMA_CH_ENABLE_bm    0x80  /*!< Channel Enable bit mask. */
+#define DMA_CH_ENABLE_bp    7
+#define DMA_CH_RESET_bm     0x40  /*!< Channel Software Reset bit mask. */
+#define DMA_CH_RESET_bp     6
+#define DMA_CH_REPEAT_bm    0x20  /*!< Channel Repeat Mode bit mask. */
+#define DMA_CH_REPEAT_bp    5
+#define DMA_CH_TRFREQ_bm    0x10  /*!< Channel Transfer Request bit mask. */
+#define DMA_CH_TRFREQ_bp    4
+#define DMA_CH_SINGLE_bm    0x04  /*!< Channel Single Shot Data Transfer bit mask. */
+#define DMA_CH_SINGLE_bp    2
+#define DMA_CH_BURSTLEN_gm  0x03  /*!< Channel Transfer Mode group mask. */
+#define DMA_CH_BURSTLEN_gp  0
+
+/* DMA_CH.CTRLB bit masks and bit positions. */
+#define DMA_CH_CHBUSY_bm     0x80  /*!< Block Transfer Busy bit mask. */
+#define DMA_CH_CHBUSY_bp     7
+#define DMA_CH_CHPEND_bm     0x40  /*!< Block Transfer Pending bit mask. */
+#define DMA_CH_CHPEND_bp     6
+#define DMA_CH_ERRIF_bm      0x20  /*!< Block Transfer Error Interrupt Flag bit mask. */
+#define DMA_CH_ERRIF_bp      5
+#define DMA_CH_TRNIF_bm      0x10  /*!< Transaction Complete Interrupt Flag bit mask. */
+#define DMA_CH_TRNIF_bp      4
+#define DMA_CH_ERRINTLVL_gm  0x0C  /*!< Transfer Error Interrupt Level group mask. */
+#define DMA_CH_ERRINTLVL_gp  2
+#define DMA_CH_TRNINTLVL_gm  0x03  /*!< Transaction Complete Interrupt Level group mask. */
+#define DMA_CH_TRNINTLVL_gp  0
+
+/* DMA_CH.ADDRCTRL bit masks and bit positions. */
+#define DMA_CH_SRCRELOAD_gm   0xC0  /*!< Channel Source Address Reload group mask. */
+#define DMA_CH_SRCRELOAD_gp   6
+#define DMA_CH_SRCDIR_gm      0x30  /*!< Channel Source Address Mode group mask. */
+#define DMA_CH_SRCDIR_gp      4
+#define DMA_CH_DESTRELOAD_gm  0x0C  /*!< Channel Destination Address Reload group mask. */
+#define DMA_CH_DESTRELOAD_gp  2
+#define DMA_CH_DESTDIR_gm     0x03  /*!< Channel Destination Address Mode group mask. */
+#define DMA_CH_DESTDIR_gp     0
+
+/*! Burst mode. */
+typedef enum DMA_CH_BURSTLEN_enum {
+	DMA_CH_BURSTLEN_1BYTE_gc = (0x00<<0),  /*!< 1-byte burst mode. */
+	DMA_CH_BURSTLEN_2BYTE_gc = (0x01<<0),  /*!< 2-byte burst mode. */
+	DMA_CH_BURSTLEN_4BYTE_gc = (0x02<<0),  /*!< 4-byte burst mode. */
+	DMA_CH_BURSTLEN_8BYTE_gc = (0x03<<0),  /*!< 8-byte burst mode. */
+} DMA_CH_BURSTLEN_t;
+
+/*! Source address reload mode. */
+typedef enum DMA_CH_SRCRELOAD_enum {
+	DMA_CH_SRCRELOAD_NONE_gc = (0x00<<6),         /*!< No reload. */
+	DMA_CH_SRCRELOAD_BLOCK_gc = (0x01<<6),        /*!< Reload at end of block. */
+	DMA_CH_SRCRELOAD_BURST_gc = (0x02<<6),        /*!< Reload at end of burst. */
+	DMA_CH_SRCRELOAD_TRANSACTION_gc = (0x03<<6),  /*!< Reload at end of transaction. */
+} DMA_CH_SRCRELOAD_t;
+
+/*! Source addressing mode. */
+typedef enum DMA_CH_SRCDIR_enum {
+	DMA_CH_SRCDIR_FIXED_gc = (0x00<<4),  /*!< Fixed. */
+	DMA_CH_SRCDIR_INC_gc = (0x01<<4),    /*!< Increment. */
+	DMA_CH_SRCDIR_DEC_gc = (0x02<<4),    /*!< Decrement. */
+} DMA_CH_SRCDIR_t;
+
+/*! Destination address reload mode. */
+typedef enum DMA_CH_DESTRELOAD_enum {
+	DMA_CH_DESTRELOAD_NONE_gc = (0x00<<2),         /*!< No reload. */
+	DMA_CH_DESTRELOAD_BLOCK_gc = (0x01<<2),        /*!< Reload at end of block. */
+	DMA_CH_DESTRELOAD_BURST_gc = (0x02<<2),        /*!< Reload at end of burst. */
+	DMA_CH_DESTRELOAD_TRANSACTION_gc = (0x03<<2),  /*!< Reload at end of transaction. */
+} DMA_CH_DESTRELOAD_t;
+
+/*! Destination addressing mode. */
+typedef enum DMA_CH_DESTDIR_enum {
+	DMA_CH_DESTDIR_FIXED_gc = (0x00<<0),  /*!< Fixed. */
+	DMA_CH_DESTDIR_INC_gc = (0x01<<0),    /*!< Increment. */
+	DMA_CH_DESTDIR_DEC_gc = (0x02<<0),    /*!< Decrement. */
+} DMA_CH_DESTDIR_t;
+
+/*! Transfer trigger source. Only the event, Timer/Counter 0 and USART
+ *  sources are listed. */
+typedef enum DMA_CH_TRIGSRC_enum {
+	DMA_CH_TRIGSRC_OFF_gc = (0x00<<0),          /*!< Off software triggers only. */
+	DMA_CH_TRIGSRC_EVSYS_CH0_gc = (0x01<<0),    /*!< Event System Channel 0. */
+	DMA_CH_TRIGSRC_EVSYS_CH1_gc = (0x02<<0),    /*!< Event System Channel 1. */
+	DMA_CH_TRIGSRC_EVSYS_CH2_gc = (0x03<<0),    /*!< Event System Channel 2. */
+	DMA_CH_TRIGSRC_TCC0_OVF_gc = (0x40<<0),     /*!< Timer/Counter C0 overflow. */
+	DMA_CH_TRIGSRC_TCC0_ERR_gc = (0x41<<0),     /*!< Timer/Counter C0 error. */
+	DMA_CH_TRIGSRC_TCC0_CCA_gc = (0x42<<0),     /*!< Timer/Counter C0 compare or capture A. */
+	DMA_CH_TRIGSRC_TCC0_CCB_gc = (0x43<<0),     /*!< Timer/Counter C0 compare or capture B. */
+	DMA_CH_TRIGSRC_TCC0_CCC_gc = (0x44<<0),     /*!< Timer/Counter C0 compare or capture C. */
+	DMA_CH_TRIGSRC_TCC0_CCD_gc = (0x45<<0),     /*!< Timer/Counter C0 compare or capture D. */
+	DMA_CH_TRIGSRC_SPIC_gc = (0x4A<<0),        /*!< SPI C transfer complete. */
+	DMA_CH_TRIGSRC_USARTC0_RXC_gc = (0x4B<<0),  /*!< USART C0 RX complete. */
+	DMA_CH_TRIGSRC_USARTC0_DRE_gc = (0x4C<<0),  /*!< USART C0 data register empty. */
+	DMA_CH_TRIGSRC_USARTC1_RXC_gc = (0x4E<<0),  /*!< USART C1 RX complete. */
+	DMA_CH_TRIGSRC_USARTC1_DRE_gc = (0x4F<<0),  /*!< USART C1 data register empty. */
+	DMA_CH_TRIGSRC_TCD0_OVF_gc = (0x60<<0),     /*!< Timer/Counter D0 overflow. */
+	DMA_CH_TRIGSRC_TCD0_ERR_gc = (0x61<<0),     /*!< Timer/Counter D0 error. */
+	DMA_CH_TRIGSRC_TCD0_CCA_gc = (0x62<<0),     /*!< Timer/Counter D0 compare or capture A. */
+	DMA_CH_TRIGSRC_TCD0_CCB_gc = (0x63<<0),     /*!< Timer/Counter D0 compare or capture B. */
+	DMA_CH_TRIGSRC_TCD0_CCC_gc = (0x64<<0),     /*!< Timer/Counter D0 compare or capture C. */
+	DMA_CH_TRIGSRC_TCD0_CCD_gc = (0x65<<0),     /*!< Timer/Counter D0 compare or capture D. */
+	DMA_CH_TRIGSRC_SPID_gc = (0x6A<<0),        /*!< SPI D transfer complete. */
+	DMA_CH_TRIGSRC_USARTD0_RXC_gc = (0x6B<<0),  /*!< USART D0 RX complete. */
+	DMA_CH_TRIGSRC_USARTD0_DRE_gc = (0x6C<<0),  /*!< USART D0 data register empty. */
+	DMA_CH_TRIGSRC_USARTD1_RXC_gc = (0x6E<<0),  /*!< USART D1 RX complete. */
+	DMA_CH_TRIGSRC_USARTD1_DRE_gc = (0x6F<<0),  /*!< USART D1 data register empty. */
+	DMA_CH_TRIGSRC_TCE0_OVF_gc = (0x80<<0),     /*!< Timer/Counter E0 overflow. */
+	DMA_CH_TRIGSRC_TCE0_ERR_gc = (0x81<<0),     /*!< Timer/Counter E0 error. */
+	DMA_CH_TRIGSRC_TCE0_CCA_gc = (0x82<<0),     /*!< Timer/Counter E0 compare or capture A. */
+	DMA_CH_TRIGSRC_TCE0_CCB_gc = (0x83<<0),     /*!< Timer/Counter E0 compare or capture B. */
+	DMA_CH_TRIGSRC_TCE0_CCC_gc = (0x84<<0),     /*!< Timer/Counter E0 compare or capture C. */
+	DMA_CH_TRIGSRC_TCE0_CCD_gc = (0x85<<0),     /*!< Timer/Counter E0 compare or capture D. */
+	DMA_CH_TRIGSRC_SPIE_gc = (0x8A<<0),        /*!< SPI E transfer complete. */
+	DMA_CH_TRIGSRC_USARTE0_RXC_gc = (0x8B<<0),  /*!< USART E0 RX complete. */
+	DMA_CH_TRIGSRC_USARTE0_DRE_gc = (0x8C<<0),  /*!< USART E0 data register empty. */
+	DMA_CH_TRIGSRC_USARTE1_RXC_gc = (0x8E<<0),  /*!< USART E1 RX complete. */
+	DMA_CH_TRIGSRC_USARTE1_DRE_gc = (0x8F<<0),  /*!< USART E1 data register empty. */
+	DMA_CH_TRIGSRC_TCF0_OVF_gc = (0xA0<<0),     /*!< Timer/Counter F0 overflow. */
+	DMA_CH_TRIGSRC_TCF0_ERR_gc = (0xA1<<0),     /*!< Timer/Counter F0 error. */
+	DMA_CH_TRIGSRC_TCF0_CCA_gc = (0xA2<<0),     /*!< Timer/Counter F0 compare or capture A. */
+	DMA_CH_TRIGSRC_TCF0_CCB_gc = (0xA3<<0),     /*!< Timer/Counter F0 compare or capture B. */
+	DMA_CH_TRIGSRC_TCF0_CCC_gc = (0xA4<<0),     /*!< Timer/Counter F0 compare or capture C. */
+	DMA_CH_TRIGSRC_TCF0_CCD_gc = (0xA5<<0),     /*!< Timer/Counter F0 compare or capture D. */
+	DMA_CH_TRIGSRC_SPIF_gc = (0xAA<<0),        /*!< SPI F transfer complete. */
+	DMA_CH_TRIGSRC_USARTF0_RXC_gc = (0xAB<<0),  /*!< USART F0 RX complete. */
+	DMA_CH_TRIGSRC_USARTF0_DRE_gc = (0xAC<<0),  /*!< USART F0 data register empty. */
+	DMA_CH_TRIGSRC_USARTF1_RXC_gc = (0xAE<<0),  /*!< USART F1 RX complete. */
+	DMA_CH_TRIGSRC_USARTF1_DRE_gc = (0xAF<<0),  /*!< USART F1 data register empty. */
+} DMA_CH_TRIGSRC_t;
+
+/*! Interrupt level. */
+typedef enum DMA_CH_TRNINTLVL_enum {
+	DMA_CH_TRNINTLVL_OFF_gc = (0x00<<0),  /*!< Interrupt disabled. */
+	DMA_CH_TRNINTLVL_LO_gc = (0x01<<0),   /*!< Low level. */
+	DMA_CH_TRNINTLVL_MED_gc = (0x02<<0),  /*!< Medium level. */
+	DMA_CH_TRNINTLVL_HI_gc = (0x03<<0),   /*!< High level. */
+} DMA_CH_TRNINTLVL_t;
+
+/*! Interrupt level. */
+typedef enum DMA_CH_ERRINTLVL_enum {
+	DMA_CH_ERRINTLVL_OFF_gc = (0x00<<2),  /*!< Interrupt disabled. */
+	DMA_CH_ERRINTLVL_LO_gc = (0x01<<2),   /*!< Low level. */
+	DMA_CH_ERRINTLVL_MED_gc = (0x02<<2),  /*!< Medium level. */
+	DMA_CH_ERRINTLVL_HI_gc = (0x03<<2),   /*!< High level. */
+} DMA_CH_ERRINTLVL_t;
+
+
+/* Interrupt vector numbers **************************************************/
+
+#define PORTC_INT0_vect_num   2
+#define PORTC_INT1_vect_num   3
+#define DMA_CH0_vect_num      6
+#define DMA_CH1_vect_num      7
+#define DMA_CH2_vect_num      8
+#define DMA_CH3_vect_num      9
+#define TWIC_TWIS_vect_num    12
+#define TWIC_TWIM_vect_num    13
+#define TCC0_OVF_vect_num     14
+#define TCC0_ERR_vect_num     15
+#define TCC0_CCA_vect_num     16
+#define TCC0_CCB_vect_num     17
+#define TCC0_CCC_vect_num     18
+#define TCC0_CCD_vect_num     19
+#define SPIC_INT_vect_num     24
+#define USARTC0_RXC_vect_num  25
+#define USARTC0_DRE_vect_num  26
+#define USARTC0_TXC_vect_num  27
+#define USARTC1_RXC_vect_num  28
+#define USARTC1_DRE_vect_num  29
+#define USARTC1_TXC_vect_num  30
+#define AES_INT_vect_num      31
+#define NVM_EE_vect_num       32
+#define NVM_SPM_vect_num      33
+#define PORTB_INT0_vect_num   34
+#define PORTB_INT1_vect_num   35
+#define ACB_AC0_vect_num      36
+#define ACB_AC1_vect_num      37
+#define ACB_ACW_vect_num      38
+#define ADCB_CH0_vect_num     39
+#define ADCB_CH1_vect_num     40
+#define ADCB_CH2_vect_num     41
+#define ADCB_CH3_vect_num     42
+#define PORTE_INT0_vect_num   43
+#define PORTE_INT1_vect_num   44
+#define TWIE_TWIS_vect_num    45
+#define TWIE_TWIM_vect_num    46
+#define TCE0_OVF_vect_num     47
+#define TCE0_ERR_vect_num     48
+#define TCE0_CCA_vect_num     49
+#define TCE0_CCB_vect_num     50
+#define TCE0_CCC_vect_num     51
+#define TCE0_CCD_vect_num     52
+#define SPIE_INT_vect_num     57
+#define USARTE0_RXC_vect_num  58
+#define USARTE0_DRE_vect_num  59
+#define USARTE0_TXC_vect_num  60
+#define USARTE1_RXC_vect_num  61
+#define USARTE1_DRE_vect_num  62
+#define USARTE1_TXC_vect_num  63
+#define PORTD_INT0_vect_num   64
+#define PORTD_INT1_vect_num   65
+#define PORTA_INT0_vect_num   66
+#define PORTA_INT1_vect_num   67
+#define ACA_AC0_vect_num      68
+#define ACA_AC1_vect_num      69
+#define ACA_ACW_vect_num      70
+#define ADCA_CH0_vect_num     71
+#define ADCA_CH1_vect_num     72
+#define ADCA_CH2_vect_num     73
+#define ADCA_CH3_vect_num     74
+#define TWID_TWIS_vect_num    75
+#define TWID_TWIM_vect_num    76
+#define TCD0_OVF_vect_num     77
+#define TCD0_ERR_vect_num     78
+#define TCD0_CCA_vect_num     79
+#define TCD0_CCB_vect_num     80
+#define TCD0_CCC_vect_num     81
+#define TCD0_CCD_vect_num     82
+#define SPID_INT_vect_num     87
+#define USARTD0_RXC_vect_num  88
+#define USARTD0_DRE_vect_num  89
+#define USARTD0_TXC_vect_num  90
+#define USARTD1_RXC_vect_num  91
+#define USARTD1_DRE_vect_num  92
+#define USARTD1_TXC_vect_num  93
+#define PORTF_INT0_vect_num   104
+#define PORTF_INT1_vect_num   105
+#define TWIF_TWIS_vect_num    106
+#define TWIF_TWIM_vect_num    107
+#define TCF0_OVF_vect_num     108
+#define TCF0_ERR_vect_num     109
+#define TCF0_CCA_vect_num     110
+#define TCF0_CCB_vect_num     111
+#define TCF0_CCC_vect_num     112
+#define TCF0_CCD_vect_num     113
+#define SPIF_INT_vect_num     118
+#define USARTF0_RXC_vect_num  119
+#define USARTF0_DRE_vect_num  120
+#define USARTF0_TXC_vect_num  121
+#define USARTF1_RXC_vect_num  122
+#define USARTF1_DRE_vect_num  123
+#define USARTF1_TXC_vect_num  124
+
+/*! Number of interrupt vectors of ATxmega128A1. */
+#define _VECTORS_COUNT  125
+
+#endif
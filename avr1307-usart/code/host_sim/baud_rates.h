@@ -0,0 +1,202 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Compile-time baud rate table rows for the host solver test.
+ *
+ *      Each inclusion runs usart_baud.h once for every standard baud rate at
+ *      the clock given by USART_BAUD_CLOCK, and expands to one BAUD_ROW() per
+ *      rate, for use inside an array initializer. Rates above a quarter of
+ *      the clock are left out: no setting exists for them, and usart_baud.h
+ *      would stop the build.
+ *
+ *      USART_BAUD_MAX_ERROR must be set high enough that usart_baud.h does not
+ *      reject a rate for its error; baud_table.c checks each error against
+ *      the default limit.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#define USART_BAUD_RATE 300UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 600UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 1200UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 2400UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 4800UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 9600UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 14400UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 19200UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 28800UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 38400UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 57600UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 76800UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 115200UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 230400UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 250000UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 460800UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 500000UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 921600UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 1000000UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 2000000UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
+
+#define USART_BAUD_RATE 4000000UL
+#if USART_BAUD_RATE * 4 <= USART_BAUD_CLOCK
+#include "usart_baud.h"
+BAUD_ROW()
+#endif
+#undef USART_BAUD_RATE
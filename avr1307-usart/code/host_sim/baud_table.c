@@ -0,0 +1,281 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART baud rate solver table test for the host.
+ *
+ *      This program checks the compile-time solver of usart_baud.h against
+ *      the runtime solver, USART_Baudrate_Solve(), for the standard baud
+ *      rates at every clock of testClock[].
+ *
+ *      The compile-time rows come from baud_rates.h, which includes
+ *      usart_baud.h once per clock and baud rate. For each row, the runtime
+ *      solver must find the same BSEL, BSCALE and CLK2X setting and the same
+ *      error, and the bit time error of the setting must equal the smallest
+ *      one found by trying every BSEL at every BSCALE, with and without
+ *      CLK2X. A rate is feasible if its error is within ERROR_LIMIT, the
+ *      default limit of usart_baud.h. For the rates left out of the table,
+ *      above a quarter of the clock, the runtime solver must find nothing.
+ *
+ *      Each clock and rate prints one line of space separated key=value
+ *      pairs, with errors in units of 0.01 %, and the program exits with a
+ *      non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding usart_driver.c:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=32000000UL -Ihost_sim -I. \
+ *            host_sim/sim.c host_sim/baud_table.c usart_driver.c -o baud_table
+ *        ./baud_table
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "usart_driver.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Largest error of a feasible rate, in units of 0.01 %. */
+#define ERROR_LIMIT            100
+
+/*! Let usart_baud.h accept any error, so that every rate gets a row. */
+#define USART_BAUD_MAX_ERROR   0xFFFF
+
+
+/*! \brief A compile-time result of usart_baud.h. */
+typedef struct BaudRow {
+	uint32_t clockHz;
+	uint32_t baudrate;
+	uint16_t bsel;
+	int8_t bscale;
+	bool clk2x;
+	uint16_t error;
+} BaudRow_t;
+
+/*! \brief Row for the current USART_BAUD_CLOCK and USART_BAUD_RATE. */
+#define BAUD_ROW() \
+	{ USART_BAUD_CLOCK, USART_BAUD_RATE, USART_BSEL_VALUE, USART_BSCALE_VALUE, \
+	  USART_CLK2X_VALUE, USART_BAUD_ERROR },
+
+/*! Clocks of the table: the RC oscillators, their prescaled values and
+ *  the common baud rate crystals. */
+static const uint32_t testClock[] = {
+	1000000, 1843200, 2000000, 3686400, 4000000, 7372800, 8000000,
+	16000000, 32000000
+};
+
+/*! Standard baud rates. The same rates as in baud_rates.h. */
+static const uint32_t testBaudrate[] = {
+	300, 600, 1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600,
+	76800, 115200, 230400, 250000, 460800, 500000, 921600, 1000000,
+	2000000, 4000000
+};
+
+/*! Compile-time results, one block of rates per clock. */
+static const BaudRow_t baudRow[] = {
+#define USART_BAUD_CLOCK 1000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 1843200UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 2000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 3686400UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 4000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 7372800UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 8000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 16000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK 32000000UL
+#include "baud_rates.h"
+#undef USART_BAUD_CLOCK
+};
+
+
+/*! \brief Find the compile-time row of a clock and rate.
+ *
+ *  \return  The row, or NULL if the rate has none.
+ */
+static const BaudRow_t * Test_FindRow(uint32_t clockHz, uint32_t baudrate)
+{
+	uint16_t i;
+
+	for (i = 0; i < sizeof(baudRow) / sizeof(baudRow[0]); i++) {
+		if ((baudRow[i].clockHz == clockHz) && (baudRow[i].baudrate == baudrate)) {
+			return &baudRow[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Bit time error of a setting, scaled by 128 x clock.
+ *
+ *  \return  false if the setting cannot be used, with negative BSCALE and an
+ *           integer part of the ratio below two.
+ */
+static bool Test_Diff(uint32_t clockHz, uint32_t baudrate, bool clk2x,
+                      int8_t bscale, uint16_t bsel, uint64_t * diff)
+{
+	uint64_t actual128;
+	uint64_t ideal128 = (uint64_t) clockHz * 128;
+
+	if (bscale >= 0) {
+		actual128 = ((uint64_t) bsel + 1) * (128 << bscale);
+	} else {
+		if (bsel < (1 << -bscale)) {
+			return false;
+		}
+		actual128 = 128 + (((uint64_t) bsel * 128) >> -bscale);
+	}
+	actual128 *= (clk2x ? 8 : 16) * (uint64_t) baudrate;
+	*diff = (actual128 > ideal128) ? actual128 - ideal128 : ideal128 - actual128;
+	return true;
+}
+
+
+/*! \brief Smallest bit time error of any setting, scaled by 128 x clock. */
+static uint64_t Test_BestDiff(uint32_t clockHz, uint32_t baudrate)
+{
+	uint64_t best = UINT64_MAX;
+	uint64_t diff;
+	int8_t bscale;
+	uint16_t bsel;
+	uint8_t clk2x;
+
+	for (clk2x = 0; clk2x < 2; clk2x++) {
+		for (bscale = -7; bscale <= 7; bscale++) {
+			for (bsel = 0; bsel <= 4095; bsel++) {
+				if (Test_Diff(clockHz, baudrate, clk2x, bscale, bsel, &diff) &&
+				    (diff < best)) {
+					best = diff;
+				}
+			}
+		}
+	}
+	return best;
+}
+
+
+/*! \brief Check one clock and rate and report.
+ *
+ *  \param feasible  Incremented if the rate is feasible.
+ *
+ *  \return  true if the check passed.
+ */
+static bool Test_Rate(uint32_t clockHz, uint32_t baudrate, uint16_t * feasible)
+{
+	const BaudRow_t * row = Test_FindRow(clockHz, baudrate);
+	USART_Baud_t setting;
+	bool found = USART_Baudrate_Solve(clockHz, baudrate, &setting);
+	bool same;
+	bool optimal;
+	uint64_t diff;
+
+	if (row == NULL) {
+		printf("clock=%lu baudrate=%lu compile=none runtime=%s result=%s\n",
+		       (unsigned long) clockHz,
+		       (unsigned long) baudrate,
+		       found ? "found" : "none",
+		       found ? "fail" : "pass");
+		return !found;
+	}
+
+	same = found && (setting.bsel == row->bsel) && (setting.bscale == row->bscale) &&
+	       (setting.clk2x == row->clk2x) && (setting.error == row->error);
+	optimal = Test_Diff(clockHz, baudrate, row->clk2x, row->bscale, row->bsel, &diff) &&
+	          (diff == Test_BestDiff(clockHz, baudrate));
+	if (row->error <= ERROR_LIMIT) {
+		(*feasible)++;
+	}
+
+	printf("clock=%lu baudrate=%lu bsel=%u bscale=%d clk2x=%u error=%u "
+	       "feasible=%s runtime=%s optimal=%s result=%s\n",
+	       (unsigned long) clockHz,
+	       (unsigned long) baudrate,
+	       row->bsel,
+	       row->bscale,
+	       row->clk2x,
+	       row->error,
+	       (row->error <= ERROR_LIMIT) ? "yes" : "no",
+	       same ? "same" : (found ? "different" : "none"),
+	       optimal ? "yes" : "no",
+	       (same && optimal) ? "pass" : "fail");
+
+	return same && optimal;
+}
+
+
+/*! \brief Check every clock and rate and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+	uint16_t feasible = 0;
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < sizeof(testClock) / sizeof(testClock[0]); i++) {
+		for (j = 0; j < sizeof(testBaudrate) / sizeof(testBaudrate[0]); j++) {
+			success &= Test_Rate(testClock[i], testBaudrate[j], &feasible);
+		}
+	}
+
+	printf("summary clocks=%u rates=%u rows=%u feasible=%u result=%s\n",
+	       (unsigned) (sizeof(testClock) / sizeof(testClock[0])),
+	       (unsigned) (sizeof(testBaudrate) / sizeof(testBaudrate[0])),
+	       (unsigned) (sizeof(baudRow) / sizeof(baudRow[0])),
+	       feasible,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART idle line framing test for the host-side simulator.
+ *
+ *      This program runs the idle line framing driver on the host simulator with
+ *      Modbus RTU timing, and reports the interrupts taken per frame.
+ *
+ *      FRAMES frames of pseudo-random length and content are sent to USARTC0 at
+ *      19200 baud, 8 data bits, even parity and one stop bit. Within a frame,
+ *      the characters are separated by up to 1.5 character times, with some gaps
+ *      of exactly 1.5 characters; the frames are separated by 3.5 to 6 character
+ *      times, with some gaps of exactly 3.5 characters. One frame is longer than
+ *      IDLEFRAME_MAX_FRAME and must be dropped. The receiver uses DMA channel 0,
+ *      TCC0 and event channel 0, with the idle time from
+ *      IDLEFRAME_MODBUS_IDLE_BITS().
+ *
+ *      The program prints one line of space separated key=value pairs and exits
+ *      with a non-zero status if a frame was split, merged, corrupted or lost.
+ *
+ *      Build and run from the directory holding usart_driver.c. The DMA model
+ *      needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -Ihost_sim -I. host_sim/sim.c \
+ *            host_sim/idleframe_modbus.c usart_idleframe.c usart_driver.c \
+ *            event_system_driver.c -o idleframe_modbus
+ *        ./idleframe_modbus
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usart_idleframe.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Number of frames sent. */
+#define FRAMES             100
+
+/*! Frame sent too long, counted from 0. */
+#define FRAME_TOO_LONG     50
+
+/*! Baud rate of the line. */
+#define BAUDRATE           19200
+
+/*! Bits of a character frame: start, 8 data, even parity, stop. */
+#define FRAME_BITS         11
+
+/*! Longest frame sent. */
+#define FRAME_MAX_LENGTH   (IDLEFRAME_MAX_FRAME + 16)
+
+/*! CPU cycles charged for one pass of the main loop that finds nothing to do. */
+#define IDLE_CYCLES        4
+
+
+/*! \brief A frame, as sent on the line. */
+typedef struct Frame_struct {
+	uint16_t length;
+	uint8_t data[FRAME_MAX_LENGTH];
+} Frame_t;
+
+
+/*! Idle line frame receiver, in static data for the DMA. */
+IDLEFRAME_Receiver_t receiver;
+
+/*! Frames sent. */
+static Frame_t frame[FRAMES];
+
+/*! Character time in CPU cycles. */
+static uint32_t charCycles;
+
+/*! State of the pseudo-random generator. */
+static uint32_t testRandom = 1;
+
+
+/*! \brief Get a pseudo-random number from 0 to \a range - 1. */
+static uint16_t Test_Random(uint16_t range)
+{
+	testRandom = testRandom * 1103515245UL + 12345;
+	return (uint16_t) ((testRandom >> 16) % range);
+}
+
+
+/*! \brief Get an idle time in CPU cycles.
+ *
+ *  \param minTenths  Shortest gap, in tenths of a character time.
+ *  \param maxTenths  Longest gap, in tenths of a character time. One gap
+ *                    in four is exactly this long, or exactly \a minTenths
+ *                    if that is not zero.
+ */
+static uint32_t Test_Gap(uint16_t minTenths, uint16_t maxTenths)
+{
+	uint16_t pick = Test_Random(4);
+	uint32_t tenths;
+
+	if (pick == 0) {
+		tenths = (minTenths != 0) ? minTenths : maxTenths;
+	} else {
+		tenths = minTenths + Test_Random(maxTenths - minTenths + 1);
+	}
+	return (charCycles * tenths) / 10;
+}
+
+
+/*! \brief Send characters and gaps to the line while the line queue takes them.
+ *
+ *  \return  True when all frames have been queued.
+ */
+static bool Test_Feed(void)
+{
+	static uint16_t f;
+	static uint16_t i;
+	static bool gapAdded;
+
+	while (f < FRAMES) {
+		uint16_t character = frame[f].data[i];
+
+		if (!gapAdded) {
+			if (i != 0) {
+				SIM_USART_InjectIdle(&USARTC0, Test_Gap(0, 15));
+			} else if (f != 0) {
+				SIM_USART_InjectIdle(&USARTC0, Test_Gap(35, 60));
+			}
+			gapAdded = true;
+		}
+		if (SIM_USART_Inject9(&USARTC0, &character, 1) == 0) {
+			return false;
+		}
+		gapAdded = false;
+		if (++i == frame[f].length) {
+			i = 0;
+			f++;
+		}
+	}
+	return true;
+}
+
+
+/*! \brief Run the frames through the receiver and report.
+ *
+ *  \return  0 if every frame was received unchanged, 1 otherwise.
+ */
+int main(void)
+{
+	const SIM_IrqStats_t * cca;
+	USART_Baud_t setting;
+	uint32_t chars = 0;
+	uint32_t received = 0;
+	uint32_t errors = 0;
+	uint32_t wraps;
+	uint64_t start;
+	uint64_t cycles;
+	uint16_t next = 0;
+	bool pinSense;
+	bool success;
+	uint16_t f;
+	uint16_t i;
+
+	for (f = 0; f < FRAMES; f++) {
+		frame[f].length = (f == FRAME_TOO_LONG) ? FRAME_MAX_LENGTH :
+		                  4 + Test_Random(IDLEFRAME_MAX_FRAME - 3);
+		for (i = 0; i < frame[f].length; i++) {
+			/* Some 0xFF, which only have the start bit as falling edge. */
+			frame[f].data[i] = (Test_Random(8) == 0) ? 0xFF : Test_Random(256);
+		}
+		chars += frame[f].length;
+	}
+	charCycles = (uint32_t) (((uint64_t) F_CPU * FRAME_BITS) / BAUDRATE);
+
+	USART_Baudrate_Solve(F_CPU, BAUDRATE, &setting);
+	USART_Baudrate_Apply(&USARTC0, &setting);
+	USART_Format_Set(&USARTC0, USART_CHSIZE_8BIT_gc, USART_PMODE_EVEN_gc, false);
+	IDLEFRAME_Init(&receiver, &USARTC0, &DMA.CH0, DMA_CH_TRIGSRC_USARTC0_RXC_gc,
+	               &TCC0, 0, EVSYS_CHMUX_PORTC_PIN2_gc, BAUDRATE,
+	               IDLEFRAME_MODBUS_IDLE_BITS(FRAME_BITS), TC_CCAINTLVL_LO_gc);
+
+	/* The falling edges of RXD restart the idle timer. */
+	pinSense = (PORTC.PIN2CTRL & PORT_ISC_gm) == PORT_ISC_FALLING_gc;
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+	SIM_ClearStats();
+	start = SIM_GetCycles();
+
+	while (!Test_Feed() || !SIM_USART_IsIdle(&USARTC0) || (next < FRAMES)) {
+		if (next == FRAME_TOO_LONG) {
+			/* Nothing to receive for this one. */
+			next++;
+		}
+		if (IDLEFRAME_FrameAvailable(&receiver)) {
+			if ((next < FRAMES) &&
+			    (IDLEFRAME_FrameLength(&receiver) == frame[next].length) &&
+			    (memcmp((const uint8_t *) IDLEFRAME_Frame(&receiver),
+			            frame[next].data, frame[next].length) == 0)) {
+				received++;
+			} else {
+				errors++;
+			}
+			next++;
+			IDLEFRAME_ReleaseFrame(&receiver);
+		}
+		if (SIM_GetCycles() - start > (uint64_t) chars * charCycles * 8) {
+			/* Frames were lost. */
+			break;
+		}
+		SIM_Run(IDLE_CYCLES);
+	}
+	cycles = SIM_GetCycles() - start;
+
+	cca = SIM_GetIrqStats(TCC0_CCA_vect_num);
+	wraps = cca->count - received - errors - receiver.framesTooLong;
+	success = pinSense && (received == FRAMES - 1) && (errors == 0) &&
+	          (receiver.framesTooLong == 1) && (receiver.framesDropped == 0) &&
+	          (SIM_GetIrqStats(USARTC0_RXC_vect_num)->count == 0);
+
+	printf("frames=%u received=%lu errors=%lu too_long=%u dropped=%u chars=%lu "
+	       "cca_isr=%lu idle_wraps=%lu isr_per_frame_x100=%lu isr_cycles=%llu "
+	       "isr_load_permille=%llu pin_sense=%s result=%s\n",
+	       FRAMES,
+	       (unsigned long) received,
+	       (unsigned long) errors,
+	       receiver.framesTooLong,
+	       receiver.framesDropped,
+	       (unsigned long) chars,
+	       (unsigned long) cca->count,
+	       (unsigned long) wraps,
+	       (unsigned long) (cca->count * 100UL / FRAMES),
+	       (unsigned long long) cca->cycles,
+	       (unsigned long long) (cca->cycles * 1000 / cycles),
+	       pinSense ? "ok" : "wrong",
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Idle time elapsed: hand the frame to the application. */
+ISR(TCC0_CCA_vect)
+{
+	IDLEFRAME_Timeout(&receiver);
+}
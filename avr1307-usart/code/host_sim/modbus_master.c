@@ -0,0 +1,618 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART Modbus RTU slave test for the host-side simulator.
+ *
+ *      This program runs the Modbus RTU slave on the host simulator against a
+ *      simulated master, and reports the CPU load of the slave.
+ *
+ *      The master sends TRANSACTIONS pseudo-random requests to the slave on
+ *      USARTC0 at 115200 baud, 8 data bits, even parity and one stop bit. Each
+ *      request is sent 1.75 ms, the Modbus silent interval, after the end of the
+ *      response to the previous one. All supported function codes are used, and
+ *      some requests are broadcast, for another slave, have a corrupted CRC, or
+ *      must give an exception response. The master keeps its own copy of the
+ *      slave tables and checks every response, the tables at the end, and that
+ *      DE is set while the response is sent and cleared before the next request.
+ *
+ *      The slave uses DMA channel 0 to receive and channel 1 to transmit, TCC0
+ *      and event channel 0 for the framing, and PC4 as DE. The simulator does not
+ *      count the C code between register accesses, so SLAVE_CYCLES_PER_REQUEST
+ *      and SLAVE_CYCLES_PER_BYTE are charged as an estimate for checking the
+ *      CRC, executing the request and building the response. The CPU load is the
+ *      time of these, of the register accesses in MODBUS_Slave_Poll() and of the
+ *      interrupts, against the total time.
+ *
+ *      The program prints one line of space separated key=value pairs and exits
+ *      with a non-zero status if a response was wrong or missing, the tables
+ *      differ, DE was wrong, or the CPU load was 5 % or more.
+ *
+ *      Build and run from the directory holding usart_driver.c. The DMA model
+ *      needs a program linked with -no-pie, and the CPU load target is for the
+ *      32 MHz clock:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=32000000UL -Ihost_sim -I. \
+ *            host_sim/sim.c host_sim/modbus_master.c usart_modbus.c \
+ *            usart_idleframe.c usart_driver.c event_system_driver.c \
+ *            -o modbus_master
+ *        ./modbus_master
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usart_modbus.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+#if F_CPU != 32000000UL
+#error The CPU load target is for 32 MHz: build with -DF_CPU=32000000UL.
+#endif
+
+/*! Number of requests sent. */
+#define TRANSACTIONS               200
+
+/*! Baud rate of the line. */
+#define BAUDRATE                   115200
+
+/*! Address of the slave. */
+#define SLAVE_ADDRESS              17
+
+/*! Address of another slave on the line. */
+#define OTHER_ADDRESS              18
+
+/*! Coils of the slave, from address 0. */
+#define COIL_START                 0
+#define COIL_COUNT                 96
+
+/*! Discrete inputs of the slave. */
+#define INPUT_START                500
+#define INPUT_COUNT                40
+
+/*! Holding registers of the slave. */
+#define HOLDING_START              1000
+#define HOLDING_COUNT              150
+
+/*! Input registers of the slave. */
+#define INPUT_REG_START            3000
+#define INPUT_REG_COUNT            40
+
+/*! Estimated CPU cycles of MODBUS_Slave_Poll() per request, without the
+ *  register accesses. */
+#define SLAVE_CYCLES_PER_REQUEST   300
+
+/*! Estimated CPU cycles per request and response byte: a CRC table lookup
+ *  and copying or converting the data. */
+#define SLAVE_CYCLES_PER_BYTE      24
+
+/*! CPU cycles charged for one pass of the main loop that finds nothing to do. */
+#define IDLE_CYCLES                16
+
+/*! CPU load that must not be reached, in permille. */
+#define LOAD_LIMIT_PERMILLE        50
+
+
+/*! \brief A request and what the slave must answer. */
+typedef struct Request_struct {
+	uint8_t data[MODBUS_MAX_ADU];
+	uint16_t length;
+	/*! Expected response; length 0 if there must be none. */
+	uint8_t response[MODBUS_MAX_ADU];
+	uint16_t responseLength;
+	/*! The request was corrupted on the line. */
+	bool corrupted;
+} Request_t;
+
+
+/*! Idle line frame receiver of the slave, in static data for the DMA. */
+IDLEFRAME_Receiver_t receiver;
+
+/*! The slave, in static data for the DMA. */
+MODBUS_Slave_t slave;
+
+/*! Slave tables, in application memory. */
+static uint8_t slaveCoils[COIL_COUNT / 8];
+static uint8_t slaveInputs[INPUT_COUNT / 8];
+static uint16_t slaveHolding[HOLDING_COUNT];
+static uint16_t slaveInputRegs[INPUT_REG_COUNT];
+
+/*! Copy of the slave tables kept by the master. */
+static uint8_t modelCoils[COIL_COUNT / 8];
+static uint16_t modelHolding[HOLDING_COUNT];
+
+/*! State of the pseudo-random generator. */
+static uint32_t testRandom = 1;
+
+
+/*! \brief Get a pseudo-random number from 0 to \a range - 1. */
+static uint16_t Test_Random(uint16_t range)
+{
+	testRandom = testRandom * 1103515245UL + 12345;
+	return (uint16_t) ((testRandom >> 16) % range);
+}
+
+
+/*! \brief Calculate the Modbus CRC-16 bit by bit, as a reference. */
+static uint16_t Test_Crc(const uint8_t * data, uint16_t length)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while (length-- != 0) {
+		crc ^= *data++;
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+		}
+	}
+	return crc;
+}
+
+
+/*! \brief Append the CRC to a frame and return the new length. */
+static uint16_t Test_AddCrc(uint8_t * data, uint16_t length)
+{
+	uint16_t crc = Test_Crc(data, length);
+
+	data[length] = crc & 0xFF;
+	data[length + 1] = crc >> 8;
+	return length + 2;
+}
+
+
+/*! \brief Put a 16-bit big endian value into a frame. */
+static void Test_Put16(uint8_t * data, uint16_t value)
+{
+	data[0] = value >> 8;
+	data[1] = value & 0xFF;
+}
+
+
+/*! \brief Get bit \a n of a bit table. */
+static bool Test_GetBit(const uint8_t * table, uint16_t n)
+{
+	return (table[n / 8] >> (n % 8)) & 1;
+}
+
+
+/*! \brief Set bit \a n of a bit table to \a value. */
+static void Test_SetBit(uint8_t * table, uint16_t n, bool value)
+{
+	if (value) {
+		table[n / 8] |= 1 << (n % 8);
+	} else {
+		table[n / 8] &= ~(1 << (n % 8));
+	}
+}
+
+
+/*! \brief Pick the first entry and quantity of a table access.
+ *
+ *  \param count    Entries in the table.
+ *  \param limit    Largest quantity of the function code.
+ *  \param first    Index of the first entry.
+ *  \param quantity Number of entries.
+ */
+static void Test_PickRange(uint16_t count, uint16_t limit,
+                           uint16_t * first, uint16_t * quantity)
+{
+	*quantity = 1 + Test_Random((count < limit) ? count : limit);
+	*first = Test_Random(count - *quantity + 1);
+}
+
+
+/*! \brief Make the next request and the expected response.
+ *
+ *  Write requests are applied to the master's copy of the tables unless
+ *  the slave must ignore them or answer with an exception.
+ */
+static void Test_MakeRequest(Request_t * r)
+{
+	static const uint8_t functions[] = {1, 2, 3, 3, 3, 4, 5, 6, 15, 16, 16};
+	uint8_t function = functions[Test_Random(sizeof(functions))];
+	uint8_t fault = Test_Random(100);
+	uint8_t address = SLAVE_ADDRESS;
+	uint8_t exception = 0;
+	bool corrupt = (fault >= 20) && (fault < 23);
+	bool apply;
+	uint16_t tableStart = 0;
+	uint16_t count = 1;
+	uint16_t first = 0;
+	uint16_t quantity = 1;
+	uint8_t * data = r->data;
+	uint8_t * response = r->response;
+	uint16_t i;
+
+	if (fault < 6) {
+		/* Broadcast, for write requests only. */
+		address = MODBUS_BROADCAST;
+		if (function <= 4) {
+			function = 16;
+		}
+	} else if (fault < 10) {
+		address = OTHER_ADDRESS;
+	}
+
+	switch (function) {
+	case 1:
+	case 2:
+		tableStart = (function == 1) ? COIL_START : INPUT_START;
+		count = (function == 1) ? COIL_COUNT : INPUT_COUNT;
+		Test_PickRange(count, 2000, &first, &quantity);
+		break;
+	case 3:
+		tableStart = HOLDING_START;
+		count = HOLDING_COUNT;
+		Test_PickRange(count, 125, &first, &quantity);
+		break;
+	case 4:
+		tableStart = INPUT_REG_START;
+		count = INPUT_REG_COUNT;
+		Test_PickRange(count, 125, &first, &quantity);
+		break;
+	case 5:
+		tableStart = COIL_START;
+		count = COIL_COUNT;
+		first = Test_Random(count);
+		break;
+	case 6:
+		tableStart = HOLDING_START;
+		count = HOLDING_COUNT;
+		first = Test_Random(count);
+		break;
+	case 15:
+		tableStart = COIL_START;
+		count = COIL_COUNT;
+		Test_PickRange(count, 1968, &first, &quantity);
+		break;
+	default:
+		tableStart = HOLDING_START;
+		count = HOLDING_COUNT;
+		Test_PickRange(count, 123, &first, &quantity);
+		break;
+	}
+
+	if ((fault >= 10) && (fault < 14)) {
+		/* Past the end of the table. */
+		first = count - quantity + 1 + Test_Random(8);
+		exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	} else if ((fault >= 14) && (fault < 16) && (tableStart != 0)) {
+		/* Before the start of the table. */
+		first = -1;
+		exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	}
+
+	data[0] = address;
+	data[1] = function;
+	Test_Put16(&data[2], tableStart + first);
+	Test_Put16(&data[4], quantity);
+	r->length = 6;
+
+	/* Values and data of the write functions. */
+	switch (function) {
+	case 5:
+		Test_Put16(&data[4], Test_Random(2) ? 0xFF00 : 0x0000);
+		break;
+	case 6:
+		Test_Put16(&data[4], Test_Random(0xFFFF));
+		break;
+	case 15:
+		data[6] = (quantity + 7) / 8;
+		for (i = 0; i < data[6]; i++) {
+			data[7 + i] = Test_Random(256);
+		}
+		r->length = 7 + data[6];
+		break;
+	case 16:
+		data[6] = quantity * 2;
+		for (i = 0; i < quantity; i++) {
+			Test_Put16(&data[7 + 2 * i], Test_Random(0xFFFF));
+		}
+		r->length = 7 + data[6];
+		break;
+	}
+
+	if ((fault >= 16) && (fault < 18)) {
+		/* Read exception status, not supported. */
+		data[1] = 7;
+		r->length = 2;
+		exception = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+	} else if ((fault >= 18) && (fault < 20)) {
+		/* A coil value that is neither on nor off, or quantity 0. */
+		if (function == 5) {
+			Test_Put16(&data[4], 0x1234);
+		} else {
+			data[1] = (function == 6) ? 3 : function;
+			Test_Put16(&data[4], 0);
+			if (function >= 15) {
+				data[6] = 0;
+				r->length = 7;
+			}
+		}
+		exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+	}
+
+	response[0] = SLAVE_ADDRESS;
+	for (i = 1; i < 6; i++) {
+		response[i] = data[i];
+	}
+	r->responseLength = 6;
+	apply = (address != OTHER_ADDRESS) && !corrupt && (exception == 0);
+
+	if (exception != 0) {
+		response[1] = data[1] | 0x80;
+		response[2] = exception;
+		r->responseLength = 3;
+	} else if (function <= 2) {
+		response[2] = (quantity + 7) / 8;
+		memset(&response[3], 0, response[2]);
+		for (i = 0; i < quantity; i++) {
+			Test_SetBit(&response[3], i,
+			            Test_GetBit((function == 1) ? modelCoils : slaveInputs, first + i));
+		}
+		r->responseLength = 3 + response[2];
+	} else if (function <= 4) {
+		response[2] = quantity * 2;
+		for (i = 0; i < quantity; i++) {
+			Test_Put16(&response[3 + 2 * i],
+			           (function == 3) ? modelHolding[first + i] : slaveInputRegs[first + i]);
+		}
+		r->responseLength = 3 + response[2];
+	} else if (!apply) {
+		/* The write must not change the tables. */
+	} else if (function == 5) {
+		Test_SetBit(modelCoils, first, data[4] != 0);
+	} else if (function == 6) {
+		modelHolding[first] = (data[4] << 8) | data[5];
+	} else if (function == 15) {
+		for (i = 0; i < quantity; i++) {
+			Test_SetBit(modelCoils, first + i, Test_GetBit(&data[7], i));
+		}
+	} else {
+		for (i = 0; i < quantity; i++) {
+			modelHolding[first + i] = (data[7 + 2 * i] << 8) | data[8 + 2 * i];
+		}
+	}
+
+	r->length = Test_AddCrc(data, r->length);
+	r->responseLength = Test_AddCrc(response, r->responseLength);
+
+	r->corrupted = corrupt;
+	if (corrupt) {
+		/* Corrupted on the line. */
+		data[Test_Random(r->length)] ^= 1 << Test_Random(8);
+	}
+	if ((address != SLAVE_ADDRESS) || corrupt) {
+		r->responseLength = 0;
+	}
+}
+
+
+/*! \brief Test if the slave sets DE. */
+static bool Test_IsDriverEnabled(void)
+{
+	return (PORTC.OUT & PIN4_bm) != 0;
+}
+
+
+/*! \brief Run the requests through the slave and report.
+ *
+ *  \return  0 if every response was right and the CPU load below the
+ *           limit, 1 otherwise.
+ */
+int main(void)
+{
+	static Request_t request;
+	uint8_t response[MODBUS_MAX_ADU];
+	USART_Baud_t setting;
+	uint32_t gapCycles;
+	uint32_t noResponseCycles;
+	uint32_t transactions = 0;
+	uint32_t responses = 0;
+	uint32_t mismatches = 0;
+	uint32_t timeouts = 0;
+	uint32_t deErrors = 0;
+	uint32_t corrupted = 0;
+	uint64_t busyCycles = 0;
+	uint64_t isrCycles;
+	uint64_t lastActivity = 0;
+	uint64_t start;
+	uint64_t cycles;
+	uint16_t received = 0;
+	uint32_t load;
+	bool waiting = false;
+	bool tablesOk;
+	bool success;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(slaveCoils); i++) {
+		slaveCoils[i] = modelCoils[i] = Test_Random(256);
+	}
+	for (i = 0; i < sizeof(slaveInputs); i++) {
+		slaveInputs[i] = Test_Random(256);
+	}
+	for (i = 0; i < HOLDING_COUNT; i++) {
+		slaveHolding[i] = modelHolding[i] = Test_Random(0xFFFF);
+	}
+	for (i = 0; i < INPUT_REG_COUNT; i++) {
+		slaveInputRegs[i] = Test_Random(0xFFFF);
+	}
+
+	gapCycles = (uint32_t) (((uint64_t) F_CPU * MODBUS_GAP_BITS(BAUDRATE, 11)) / BAUDRATE);
+	noResponseCycles = 3 * gapCycles;
+
+	USART_Baudrate_Solve(F_CPU, BAUDRATE, &setting);
+	USART_Baudrate_Apply(&USARTC0, &setting);
+	USART_Format_Set(&USARTC0, USART_CHSIZE_8BIT_gc, USART_PMODE_EVEN_gc, false);
+	IDLEFRAME_Init(&receiver, &USARTC0, &DMA.CH0, DMA_CH_TRIGSRC_USARTC0_RXC_gc,
+	               &TCC0, 0, EVSYS_CHMUX_PORTC_PIN2_gc, BAUDRATE,
+	               MODBUS_IDLE_BITS(BAUDRATE, 11), TC_CCAINTLVL_LO_gc);
+	MODBUS_Slave_Init(&slave, &receiver, SLAVE_ADDRESS,
+	                  &DMA.CH1, DMA_CH_TRIGSRC_USARTC0_DRE_gc,
+	                  &PORTC, PIN4_bm, USART_TXCINTLVL_LO_gc);
+	MODBUS_Slave_SetTable(&slave, MODBUS_TABLE_COILS, slaveCoils,
+	                      COIL_START, COIL_COUNT);
+	MODBUS_Slave_SetTable(&slave, MODBUS_TABLE_DISCRETE_INPUTS, slaveInputs,
+	                      INPUT_START, INPUT_COUNT);
+	MODBUS_Slave_SetTable(&slave, MODBUS_TABLE_HOLDING_REGISTERS, slaveHolding,
+	                      HOLDING_START, HOLDING_COUNT);
+	MODBUS_Slave_SetTable(&slave, MODBUS_TABLE_INPUT_REGISTERS, slaveInputRegs,
+	                      INPUT_REG_START, INPUT_REG_COUNT);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+	SIM_ClearStats();
+	start = SIM_GetCycles();
+
+	while (waiting || (transactions < TRANSACTIONS)) {
+		bool frame;
+		uint64_t before;
+
+		/* Master. */
+		if (!waiting) {
+			if (Test_IsDriverEnabled()) {
+				deErrors++;
+			}
+			Test_MakeRequest(&request);
+			SIM_USART_InjectIdle(&USARTC0, gapCycles);
+			SIM_USART_Inject(&USARTC0, request.data, request.length);
+			corrupted += request.corrupted;
+			transactions++;
+			received = 0;
+			lastActivity = 0;
+			waiting = true;
+		} else {
+			uint16_t count = SIM_USART_Read(&USARTC0, &response[received],
+			                                sizeof(response) - received);
+
+			if (count != 0) {
+				/* DE must stay set until the last stop bit is sent. */
+				received += count;
+				lastActivity = SIM_GetCycles();
+				if ((received < request.responseLength) && !Test_IsDriverEnabled()) {
+					deErrors++;
+				}
+			} else if ((lastActivity == 0) && SIM_USART_IsIdle(&USARTC0)) {
+				/* The request has been received. */
+				lastActivity = SIM_GetCycles();
+			}
+			if ((request.responseLength != 0) &&
+			    (received >= request.responseLength)) {
+				if ((received != request.responseLength) ||
+				    (memcmp(response, request.response, received) != 0)) {
+					mismatches++;
+				}
+				responses++;
+				waiting = false;
+			} else if ((lastActivity != 0) &&
+			           (SIM_GetCycles() - lastActivity > noResponseCycles)) {
+				if (request.responseLength != 0) {
+					timeouts++;
+				} else if (received != 0) {
+					mismatches++;
+				}
+				waiting = false;
+			}
+			if (!waiting) {
+				/* Let the slave release DE before the next request. */
+				SIM_Run(IDLE_CYCLES);
+			}
+		}
+
+		/* Slave main loop. */
+		frame = IDLEFRAME_FrameAvailable(&receiver) &&
+		        !MODBUS_Slave_IsTransmitting(&slave) && (slave.responseLength == 0);
+		before = SIM_GetCycles();
+		if (MODBUS_Slave_Poll(&slave)) {
+			if (frame) {
+				SIM_Run(SLAVE_CYCLES_PER_REQUEST + SLAVE_CYCLES_PER_BYTE *
+				        (IDLEFRAME_FrameLength(&receiver) + slave.responseLength));
+			}
+			busyCycles += SIM_GetCycles() - before;
+		} else {
+			SIM_Run(IDLE_CYCLES);
+		}
+	}
+	cycles = SIM_GetCycles() - start;
+
+	tablesOk = (memcmp(slaveCoils, modelCoils, sizeof(slaveCoils)) == 0) &&
+	           (memcmp(slaveHolding, modelHolding, sizeof(slaveHolding)) == 0);
+	isrCycles = SIM_GetIrqStats(TCC0_CCA_vect_num)->cycles +
+	            SIM_GetIrqStats(USARTC0_TXC_vect_num)->cycles;
+	load = (uint32_t) ((isrCycles + busyCycles) * 1000 / cycles);
+	success = (mismatches == 0) && (timeouts == 0) && (deErrors == 0) && tablesOk &&
+	          (slave.crcErrors == corrupted) && (load < LOAD_LIMIT_PERMILLE);
+
+	printf("transactions=%lu responses=%lu exceptions=%u crc_errors=%u "
+	       "mismatches=%lu timeouts=%lu de_errors=%lu tables=%s "
+	       "transactions_per_s=%lu cca_isr=%lu txc_isr=%lu isr_cycles=%llu "
+	       "poll_cycles=%llu cpu_load_permille=%lu result=%s\n",
+	       (unsigned long) transactions,
+	       (unsigned long) responses,
+	       slave.exceptions,
+	       slave.crcErrors,
+	       (unsigned long) mismatches,
+	       (unsigned long) timeouts,
+	       (unsigned long) deErrors,
+	       tablesOk ? "ok" : "differ",
+	       (unsigned long) (transactions * (uint64_t) F_CPU / cycles),
+	       (unsigned long) SIM_GetIrqStats(TCC0_CCA_vect_num)->count,
+	       (unsigned long) SIM_GetIrqStats(USARTC0_TXC_vect_num)->count,
+	       (unsigned long long) isrCycles,
+	       (unsigned long long) busyCycles,
+	       (unsigned long) load,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Idle time elapsed: a request is complete. */
+ISR(TCC0_CCA_vect)
+{
+	MODBUS_Slave_FrameTimeout(&slave);
+}
+
+
+/*! \brief Last stop bit of the response sent: release DE. */
+ISR(USARTC0_TXC_vect)
+{
+	MODBUS_Slave_TXComplete(&slave);
+}
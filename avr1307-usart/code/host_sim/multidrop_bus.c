@@ -0,0 +1,374 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART multi-drop bus simulation for the host-side simulator.
+ *
+ *      This program runs the multi-drop bus driver on the host simulator and
+ *      reports the interrupts each node takes for the traffic on the bus.
+ *
+ *      The master on USARTC0 sends BUS_FRAMES frames with pseudo-random
+ *      addresses and payload lengths over one bus, connected to the receivers
+ *      of four nodes:
+ *        - USARTC1, USARTD0 and USARTD1 are multi-drop nodes with addresses 1,
+ *          2 and 3, using DMA channels 0, 1 and 2. The master uses channel 3.
+ *        - USARTE0 is a reference node without MPCM, taking an RXC interrupt
+ *          for every character on the bus, like a node using the polled 9-bit
+ *          functions from its RXC interrupt.
+ *      Address 4 is not used by any node, and some frames are broadcast.
+ *
+ *      All nodes share the simulated CPU, but each node has its own vectors,
+ *      so the interrupt counts and ISR cycles are per node. Each node prints
+ *      one line of space separated key=value pairs, followed by a summary
+ *      line. The program exits with a non-zero status if a node missed a frame
+ *      for it or received a corrupted one.
+ *
+ *      Build and run from the directory holding usart_driver.c. The DMA model
+ *      needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -Ihost_sim -I. host_sim/sim.c \
+ *            host_sim/multidrop_bus.c usart_multidrop.c usart_driver.c \
+ *            -o multidrop_bus
+ *        ./multidrop_bus
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usart_multidrop.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Number of frames sent by the master. */
+#define BUS_FRAMES         500
+
+/*! Number of multi-drop nodes. */
+#define BUS_NODES          3
+
+/*! Baud rate of the bus. */
+#define BUS_BAUDRATE       115200
+
+/*! Address no node answers to. */
+#define BUS_UNUSED_ADDRESS 4
+
+/*! CPU cycles charged for one pass of a main loop that finds nothing to do. */
+#define BUS_IDLE_CYCLES    4
+
+
+/*! \brief Expected frame of a node, kept by the bus simulation. */
+typedef struct BUS_Frame_struct {
+	uint8_t length;
+	uint8_t data[MULTIDROP_MAX_PAYLOAD];
+} BUS_Frame_t;
+
+/*! \brief Bookkeeping of one multi-drop node. */
+typedef struct BUS_Node_struct {
+	/*! Name of the USART, for the report. */
+	const char * name;
+	/*! RXC and DMA vector numbers. */
+	uint8_t rxcVector;
+	uint8_t dmaVector;
+	/*! Frames sent to the node, not yet received. */
+	BUS_Frame_t expected[4];
+	uint8_t expectedCount;
+	/*! Frames and payload bytes received correctly. */
+	uint32_t frames;
+	uint32_t bytes;
+	/*! Frames received corrupted or out of order. */
+	uint32_t errors;
+} BUS_Node_t;
+
+
+/*! Multi-drop master, in static data for the DMA. */
+MULTIDROP_Master_t master;
+
+/*! Multi-drop nodes, in static data for the DMA. */
+MULTIDROP_Node_t node[BUS_NODES];
+
+/*! Bookkeeping of the nodes. */
+static BUS_Node_t busNode[BUS_NODES] = {
+	{ .name = "USARTC1", .rxcVector = USARTC1_RXC_vect_num, .dmaVector = DMA_CH0_vect_num },
+	{ .name = "USARTD0", .rxcVector = USARTD0_RXC_vect_num, .dmaVector = DMA_CH1_vect_num },
+	{ .name = "USARTD1", .rxcVector = USARTD1_RXC_vect_num, .dmaVector = DMA_CH2_vect_num },
+};
+
+/*! Characters received by the reference node. */
+static volatile uint32_t referenceChars;
+
+/*! State of the pseudo-random generator. */
+static uint32_t busRandom = 1;
+
+
+/*! \brief Get a pseudo-random number from 0 to \a range - 1. */
+static uint8_t Bus_Random(uint8_t range)
+{
+	busRandom = busRandom * 1103515245UL + 12345;
+	return (uint8_t) ((busRandom >> 16) % range);
+}
+
+
+/*! \brief Set up the master, the nodes and the bus wiring. */
+static void Bus_Setup(void)
+{
+	USART_Baud_t setting;
+	uint8_t i;
+
+	USART_Baudrate_Solve(F_CPU, BUS_BAUDRATE, &setting);
+
+	USART_Baudrate_Apply(&USARTC0, &setting);
+	MULTIDROP_Master_Init(&master, &USARTC0, &DMA.CH3, DMA_CH_TRIGSRC_USARTC0_DRE_gc);
+
+	USART_Baudrate_Apply(&USARTC1, &setting);
+	MULTIDROP_Node_Init(&node[0], &USARTC1, &DMA.CH0, DMA_CH_TRIGSRC_USARTC1_RXC_gc,
+	                    1, USART_RXCINTLVL_LO_gc, DMA_CH_TRNINTLVL_LO_gc);
+	USART_Baudrate_Apply(&USARTD0, &setting);
+	MULTIDROP_Node_Init(&node[1], &USARTD0, &DMA.CH1, DMA_CH_TRIGSRC_USARTD0_RXC_gc,
+	                    2, USART_RXCINTLVL_LO_gc, DMA_CH_TRNINTLVL_LO_gc);
+	USART_Baudrate_Apply(&USARTD1, &setting);
+	MULTIDROP_Node_Init(&node[2], &USARTD1, &DMA.CH2, DMA_CH_TRIGSRC_USARTD1_RXC_gc,
+	                    3, USART_RXCINTLVL_LO_gc, DMA_CH_TRNINTLVL_LO_gc);
+
+	/* Reference node: 9-bit characters, no MPCM. */
+	USART_Baudrate_Apply(&USARTE0, &setting);
+	USART_Format_Set(&USARTE0, USART_CHSIZE_9BIT_gc, USART_PMODE_DISABLED_gc, false);
+	USART_RxdInterruptLevel_Set(&USARTE0, USART_RXCINTLVL_LO_gc);
+	USART_Rx_Enable(&USARTE0);
+
+	SIM_USART_Connect(&USARTC0, &USARTC1, true);
+	SIM_USART_Connect(&USARTC0, &USARTD0, true);
+	SIM_USART_Connect(&USARTC0, &USARTD1, true);
+	SIM_USART_Connect(&USARTC0, &USARTE0, true);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	for (i = 0; i < BUS_NODES; i++) {
+		busNode[i].expectedCount = 0;
+	}
+	SIM_ClearStats();
+}
+
+
+/*! \brief Queue a frame as expected by a node. */
+static void Bus_Expect(BUS_Node_t * n, const uint8_t * data, uint8_t length)
+{
+	if (n->expectedCount == sizeof(n->expected) / sizeof(n->expected[0])) {
+		/* The node fell behind; the oldest frame counts as missed. */
+		n->errors++;
+		memmove(&n->expected[0], &n->expected[1],
+		        sizeof(n->expected) - sizeof(n->expected[0]));
+		n->expectedCount--;
+	}
+	n->expected[n->expectedCount].length = length;
+	memcpy(n->expected[n->expectedCount].data, data, length);
+	n->expectedCount++;
+}
+
+
+/*! \brief Take the received frames from the nodes and check them. */
+static void Bus_Poll(void)
+{
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < BUS_NODES; i++) {
+		BUS_Node_t * n = &busNode[i];
+		bool match;
+
+		if (!MULTIDROP_FrameAvailable(&node[i])) {
+			continue;
+		}
+
+		match = (n->expectedCount != 0) &&
+		        (MULTIDROP_FrameLength(&node[i]) == n->expected[0].length);
+		for (j = 0; match && (j < n->expected[0].length); j++) {
+			match = (node[i].buffer[j] == n->expected[0].data[j]);
+		}
+
+		if (match) {
+			n->frames++;
+			n->bytes += n->expected[0].length;
+			n->expectedCount--;
+			memmove(&n->expected[0], &n->expected[1],
+			        n->expectedCount * sizeof(n->expected[0]));
+		} else {
+			n->errors++;
+		}
+		MULTIDROP_ReleaseFrame(&node[i]);
+	}
+}
+
+
+/*! \brief Print the interrupt statistics of one node. */
+static void Bus_Print(const char * name, uint8_t address, uint32_t frames,
+                      uint32_t bytes, uint32_t dropped, uint8_t rxcVector,
+                      int16_t dmaVector, uint64_t cycles)
+{
+	const SIM_IrqStats_t * rxc = SIM_GetIrqStats(rxcVector);
+	uint32_t dmaCount = 0;
+	uint64_t isrCycles = rxc->cycles;
+
+	if (dmaVector >= 0) {
+		dmaCount = SIM_GetIrqStats(dmaVector)->count;
+		isrCycles += SIM_GetIrqStats(dmaVector)->cycles;
+	}
+
+	printf("node=%s address=%u frames=%lu bytes=%lu dropped=%lu rxc_isr=%lu "
+	       "dma_isr=%lu isr_cycles=%llu isr_load_permille=%llu\n",
+	       name, address,
+	       (unsigned long) frames,
+	       (unsigned long) bytes,
+	       (unsigned long) dropped,
+	       (unsigned long) rxc->count,
+	       (unsigned long) dmaCount,
+	       (unsigned long long) isrCycles,
+	       (unsigned long long) (isrCycles * 1000 / cycles));
+}
+
+
+/*! \brief Send the frames and report.
+ *
+ *  \return  0 if every node received its frames unchanged, 1 otherwise.
+ */
+int main(void)
+{
+	uint8_t payload[MULTIDROP_MAX_PAYLOAD];
+	uint32_t busChars = 0;
+	uint64_t start;
+	uint64_t cycles;
+	bool success = true;
+	uint16_t sent;
+	uint8_t i;
+
+	Bus_Setup();
+	start = SIM_GetCycles();
+
+	sent = 0;
+	while (sent < BUS_FRAMES) {
+		uint8_t pick = Bus_Random(BUS_NODES + 2);
+		uint8_t address = (pick < BUS_NODES) ? pick + 1 :
+		                  (pick == BUS_NODES) ? BUS_UNUSED_ADDRESS : MULTIDROP_BROADCAST;
+		uint8_t length = Bus_Random(MULTIDROP_MAX_PAYLOAD + 1);
+
+		for (i = 0; i < length; i++) {
+			payload[i] = Bus_Random(255);
+		}
+
+		while (!MULTIDROP_Master_Send(&master, address, payload, length)) {
+			Bus_Poll();
+			SIM_Run(BUS_IDLE_CYCLES);
+		}
+
+		for (i = 0; i < BUS_NODES; i++) {
+			if ((address == i + 1) || (address == MULTIDROP_BROADCAST)) {
+				Bus_Expect(&busNode[i], payload, length);
+			}
+		}
+		busChars += length + 2;
+		sent++;
+	}
+
+	/* Wait until the last frame has been received. */
+	while (MULTIDROP_Master_IsBusy(&master) || !SIM_USART_IsIdle(&USARTC0)) {
+		Bus_Poll();
+		SIM_Run(BUS_IDLE_CYCLES);
+	}
+	SIM_Run(BUS_IDLE_CYCLES * 100);
+	Bus_Poll();
+	cycles = SIM_GetCycles() - start;
+
+	for (i = 0; i < BUS_NODES; i++) {
+		BUS_Node_t * n = &busNode[i];
+
+		Bus_Print(n->name, node[i].address, n->frames, n->bytes,
+		          node[i].framesDropped, n->rxcVector, n->dmaVector, cycles);
+		success &= (n->errors == 0) && (n->expectedCount == 0) &&
+		           (node[i].framesDropped == 0);
+	}
+	Bus_Print("USARTE0", 0, 0, referenceChars, 0, USARTE0_RXC_vect_num, -1, cycles);
+	success &= (referenceChars == busChars);
+
+	printf("frames=%u bus_chars=%lu cycles=%llu result=%s\n",
+	       sent, (unsigned long) busChars, (unsigned long long) cycles,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
+
+
+/* Multi-drop node ISRs: RXC for address and length, DMA for the payload. */
+
+ISR(USARTC1_RXC_vect)
+{
+	MULTIDROP_RXComplete(&node[0]);
+}
+
+ISR(DMA_CH0_vect)
+{
+	MULTIDROP_DMAComplete(&node[0]);
+}
+
+ISR(USARTD0_RXC_vect)
+{
+	MULTIDROP_RXComplete(&node[1]);
+}
+
+ISR(DMA_CH1_vect)
+{
+	MULTIDROP_DMAComplete(&node[1]);
+}
+
+ISR(USARTD1_RXC_vect)
+{
+	MULTIDROP_RXComplete(&node[2]);
+}
+
+ISR(DMA_CH2_vect)
+{
+	MULTIDROP_DMAComplete(&node[2]);
+}
+
+
+/*! \brief Reference node: one RXC interrupt per character on the bus. */
+ISR(USARTE0_RXC_vect)
+{
+	USART_NineBits_GetChar(&USARTE0);
+	referenceChars++;
+}
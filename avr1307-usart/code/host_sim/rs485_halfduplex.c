@@ -0,0 +1,312 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART RS-485 half-duplex test for the host-side simulator.
+ *
+ *      This program runs the RS-485 half-duplex transmitter on the host simulator
+ *      and checks the timing of the driver enable (DE) pin against the characters
+ *      on the bus.
+ *
+ *      USARTC0 sends FRAMES frames of pseudo-random length at 19200 baud, 8 data
+ *      bits, no parity and one stop bit, through a simulated transceiver with DE
+ *      on PC5. The main loop keeps the transmit queue full. The transceiver
+ *      echoes the bus to the receiver of USARTC0. Two configurations are run:
+ *        - "echo": no turnaround gap, echo not suppressed. The main loop reads
+ *          the echo and checks it against the frames.
+ *        - "gap": a turnaround gap of GAP_BITS bit times, with the echo
+ *          suppressed. No character may be received.
+ *      The transmitter uses DMA channel 0, and TCC0 as gap timer.
+ *
+ *      For each configuration, the simulator measures the time from the last stop
+ *      bit of each frame to the release of DE, the time from DE being set to the
+ *      first start bit, and the bus idle time between frames. The program prints
+ *      one line of space separated key=value pairs per configuration, followed by
+ *      a summary line, and exits with a non-zero status if the bus data differs
+ *      from the frames, a character was sent with DE low, DE was released before
+ *      the end of the last stop bit or more than one bit time after it, the gap
+ *      was shorter than configured, or the echo was wrong.
+ *
+ *      Build and run from the directory holding usart_driver.c. The DMA model
+ *      needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -Ihost_sim -I. host_sim/sim.c \
+ *            host_sim/rs485_halfduplex.c usart_rs485.c usart_driver.c \
+ *            -o rs485_halfduplex
+ *        ./rs485_halfduplex
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "usart_rs485.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Number of frames sent per configuration. */
+#define FRAMES          200
+
+/*! Longest frame, in bytes. */
+#define MAX_LENGTH      48
+
+/*! Baud rate of the bus. */
+#define BAUDRATE        19200
+
+/*! Bits of a character frame. */
+#define FRAME_BITS      10
+
+/*! Turnaround gap of the "gap" configuration, in bit times. */
+#define GAP_BITS        35
+
+/*! DE pin number on PORTC. */
+#define DE_PIN          5
+
+/*! CPU cycles charged for one pass of the main loop that finds nothing to do. */
+#define IDLE_CYCLES     16
+
+
+/*! \brief A test configuration. */
+typedef struct Test_Config_struct {
+	const char * name;
+	uint16_t gapBits;
+	bool suppressEcho;
+} Test_Config_t;
+
+
+/*! The transmitter, in static data for the DMA. */
+RS485_Transmitter_t transmitter;
+
+/*! Frame data, in static data for the DMA. */
+uint8_t frameData[FRAMES][MAX_LENGTH];
+
+/*! Length of each frame. */
+static uint16_t frameLength[FRAMES];
+
+/*! Test configurations. */
+static const Test_Config_t testConfig[] = {
+	{ .name = "echo", .gapBits = 0, .suppressEcho = false },
+	{ .name = "gap", .gapBits = GAP_BITS, .suppressEcho = true },
+};
+
+/*! State of the pseudo-random generator. */
+static uint32_t testRandom = 1;
+
+
+/*! \brief Get a pseudo-random number from 0 to \a range - 1. */
+static uint16_t Test_Random(uint16_t range)
+{
+	testRandom = testRandom * 1103515245UL + 12345;
+	return (uint16_t) ((testRandom >> 16) % range);
+}
+
+
+/*! \brief Get the next expected byte of the frames, walking a position. */
+static uint8_t Test_NextByte(uint16_t * frame, uint16_t * index)
+{
+	uint8_t data = frameData[*frame][*index];
+
+	if (++*index == frameLength[*frame]) {
+		*index = 0;
+		++*frame;
+	}
+	return data;
+}
+
+
+/*! \brief Send the frames with one configuration and report.
+ *
+ *  \return  True if the configuration passed.
+ */
+static bool Test_Run(const Test_Config_t * config)
+{
+	const SIM_TransceiverStats_t * stats;
+	uint32_t bitCycles = F_CPU / BAUDRATE;
+	uint32_t gapCycles = (uint32_t) (((uint64_t) F_CPU * config->gapBits) / BAUDRATE);
+	uint32_t rxLost = SIM_USART_GetRxLost(&USARTC0);
+	uint32_t bytes = 0;
+	uint32_t busErrors = 0;
+	uint32_t echoErrors = 0;
+	uint32_t echoed = 0;
+	uint16_t echoFrame = 0;
+	uint16_t echoIndex = 0;
+	uint16_t busFrame = 0;
+	uint16_t busIndex = 0;
+	uint16_t queued = 0;
+	uint8_t bus[64];
+	uint16_t count;
+	uint16_t i;
+	bool done;
+	bool success;
+
+	for (i = 0; i < FRAMES; i++) {
+		uint16_t j;
+
+		frameLength[i] = 1 + Test_Random(MAX_LENGTH);
+		for (j = 0; j < frameLength[i]; j++) {
+			frameData[i][j] = Test_Random(256);
+		}
+		bytes += frameLength[i];
+	}
+
+	RS485_Init(&transmitter, &USARTC0, &DMA.CH0, DMA_CH_TRIGSRC_USARTC0_DRE_gc,
+	           &PORTC, 1 << DE_PIN, &TCC0, BAUDRATE, config->gapBits,
+	           config->suppressEcho, USART_TXCINTLVL_HI_gc, TC_OVFINTLVL_LO_gc);
+	SIM_USART_SetTransceiver(&USARTC0, &PORTC, DE_PIN);
+	SIM_ClearStats();
+
+	do {
+		done = (queued == FRAMES) && RS485_IsIdle(&transmitter) &&
+		       SIM_USART_IsIdle(&USARTC0);
+		if ((queued < FRAMES) &&
+		    RS485_Send(&transmitter, frameData[queued], frameLength[queued])) {
+			queued++;
+		}
+
+		/* The echo is read as it arrives, like an application would. */
+		if (!config->suppressEcho && USART_IsRXComplete(&USARTC0)) {
+			if ((echoFrame >= FRAMES) ||
+			    (USART_GetChar(&USARTC0) != Test_NextByte(&echoFrame, &echoIndex))) {
+				echoErrors++;
+			}
+			echoed++;
+			done = false;
+		}
+
+		while ((count = SIM_USART_Read(&USARTC0, bus, sizeof(bus))) != 0) {
+			for (i = 0; i < count; i++) {
+				if ((busFrame >= FRAMES) ||
+				    (bus[i] != Test_NextByte(&busFrame, &busIndex))) {
+					busErrors++;
+				}
+			}
+		}
+		SIM_Run(IDLE_CYCLES);
+	} while (!done);
+	if (busFrame != FRAMES) {
+		busErrors++;
+	}
+
+	if (config->suppressEcho) {
+		/* Every echoed character must have hit the disabled receiver. */
+		if (USART_IsRXComplete(&USARTC0) ||
+		    (SIM_USART_GetRxLost(&USARTC0) - rxLost != bytes)) {
+			echoErrors++;
+		}
+	} else if ((echoed != bytes) || (SIM_USART_GetRxLost(&USARTC0) != rxLost)) {
+		echoErrors++;
+	}
+
+	stats = SIM_USART_GetTransceiverStats(&USARTC0);
+	success = (busErrors == 0) && (echoErrors == 0) &&
+	          (stats->charsDropped == 0) && (stats->releasesEarly == 0) &&
+	          (stats->releases == FRAMES) && (stats->releaseMax < bitCycles) &&
+	          (stats->gapMin >= gapCycles) &&
+	          (RS485_FramesSent(&transmitter) == FRAMES);
+
+	printf("config=%s frames=%u bytes=%lu bus_errors=%lu echo_errors=%lu "
+	       "chars_dropped=%lu releases=%lu releases_early=%lu bit_cycles=%lu "
+	       "release_max_cycles=%lu release_avg_cycles=%lu setup_min_cycles=%lu "
+	       "gap_cycles=%lu gap_min_cycles=%lu txc_isr=%lu ovf_isr=%lu result=%s\n",
+	       config->name,
+	       RS485_FramesSent(&transmitter),
+	       (unsigned long) bytes,
+	       (unsigned long) busErrors,
+	       (unsigned long) echoErrors,
+	       (unsigned long) stats->charsDropped,
+	       (unsigned long) stats->releases,
+	       (unsigned long) stats->releasesEarly,
+	       (unsigned long) bitCycles,
+	       (unsigned long) stats->releaseMax,
+	       (unsigned long) ((stats->releases != 0) ?
+	                        stats->releaseTotal / stats->releases : 0),
+	       (unsigned long) stats->setupMin,
+	       (unsigned long) gapCycles,
+	       (unsigned long) stats->gapMin,
+	       (unsigned long) SIM_GetIrqStats(USARTC0_TXC_vect_num)->count,
+	       (unsigned long) SIM_GetIrqStats(TCC0_OVF_vect_num)->count,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Run the configurations and report.
+ *
+ *  \return  0 if every configuration passed, 1 otherwise.
+ */
+int main(void)
+{
+	USART_Baud_t setting;
+	bool success = true;
+	uint8_t i;
+
+	USART_Baudrate_Solve(F_CPU, BAUDRATE, &setting);
+	USART_Baudrate_Apply(&USARTC0, &setting);
+	USART_Format_Set(&USARTC0, USART_CHSIZE_8BIT_gc, USART_PMODE_DISABLED_gc, false);
+	USART_Rx_Enable(&USARTC0);
+	SIM_USART_SetLoopback(&USARTC0, true);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm | PMIC_HILVLEN_bm;
+	sei();
+
+	for (i = 0; i < sizeof(testConfig) / sizeof(testConfig[0]); i++) {
+		success = Test_Run(&testConfig[i]) && success;
+	}
+
+	printf("summary configs=%u result=%s\n",
+	       (unsigned) (sizeof(testConfig) / sizeof(testConfig[0])),
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Last stop bit of a frame sent: release DE. */
+ISR(USARTC0_TXC_vect)
+{
+	RS485_TXComplete(&transmitter);
+}
+
+
+/*! \brief Turnaround gap elapsed: start the next frame. */
+ISR(TCC0_OVF_vect)
+{
+	RS485_GapElapsed(&transmitter);
+}
@@ -0,0 +1,6416 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host-side XMEGA peripheral simulator source file.
+ *
+ *      This file contains the register access trapping, the cycle counter, the
+ *      virtual interrupt controller and the models of the simulated modules.
+ *      See sim.h for an overview.
+ *
+ *      The I/O memory is one shared memory object mapped twice: the view used by
+ *      the drivers (SIM_ioSpace) has no access rights, the view used by the models
+ *      (SIM_io) is readable and writable. A driver access faults; the SIGSEGV
+ *      handler notes the register and whether it is written, opens the driver
+ *      view and sets the trap flag. The CPU executes the access and raises
+ *      SIGTRAP, where the view is closed again, the register side effects are
+ *      applied, time advances and pending interrupts are dispatched. ISRs are
+ *      called from the SIGTRAP handler, like an interrupt taken between two
+ *      instructions on the device; their own register accesses nest the same
+ *      way.
+ *
+ *      The driver view is mapped at the fixed address SIM_IO_ADDRESS, below
+ *      16 MB, so that the 24-bit addresses a driver writes to a DMA channel can
+ *      point at a register. The other DMA addresses are host addresses, which
+ *      fit in 24 bits only for static data and the heap of a program linked
+ *      without position independence (-no-pie).
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "sim.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error The simulator traps register accesses on Linux x86-64 only.
+#endif
+
+/*! Trap flag in EFLAGS, stops the CPU after the next instruction. */
+#define SIM_EFLAGS_TF     0x0100
+
+/*! Page fault error code bit set for write accesses. */
+#define SIM_FAULT_WRITE   0x0002
+
+/*! Marks a vector that is not pending. */
+#define SIM_NOT_PENDING   UINT64_MAX
+
+/*! Number of simulated USARTs. */
+#define SIM_USART_COUNT   8
+
+/*! Number of simulated Timer/Counters. */
+#define SIM_TC_COUNT      4
+
+/*! Number of simulated SPI modules. */
+#define SIM_SPI_COUNT     4
+
+/*! Number of simulated Analog Comparators. */
+#define SIM_AC_COUNT      2
+
+/*! Number of analog input pins of an Analog Comparator. */
+#define SIM_AC_INPUTS     8
+
+/*! Number of simulated TWI modules. */
+#define SIM_TWI_COUNT     4
+
+/*! Number of simulated ADCs, their channels and their analog input pins. */
+#define SIM_ADC_COUNT     2
+#define SIM_ADC_CH_COUNT  4
+#define SIM_ADC_INPUTS    8
+
+/*! EEPROM size and page size in bytes. */
+#define SIM_EEPROM_SIZE   2048
+#define SIM_EEPROM_PAGE   32
+
+/*! Number of ports with pin change events and interrupts, PORTA to PORTF. */
+#define SIM_PORT_COUNT    6
+
+/*! Number of interrupt sources of a Timer/Counter. */
+#define SIM_TC_SOURCES    6
+
+/*! Number of event channels. */
+#define SIM_EVSYS_CH_COUNT  8
+
+/*! Number of DMA channels. */
+#define SIM_DMA_CH_COUNT  4
+
+/*! CPU cycles a CCP signature keeps the protected registers open. */
+#define SIM_CCP_CYCLES    4
+
+/*! Number of oscillators in OSC.CTRL, the PLL being the last. */
+#define SIM_OSC_COUNT     5
+
+/*! Frequencies of the internal oscillators. */
+#define SIM_RC2M_HZ       2000000UL
+#define SIM_RC32M_HZ      32000000UL
+#define SIM_RC32K_HZ      32768UL
+
+/*! Frequency of the 32.768 kHz crystal on TOSC, the only external oscillator. */
+#define SIM_TOSC_HZ       32768UL
+
+/*! Start-up time of the crystal oscillator with OSC_XOSCSEL_32KHz_gc: 32K
+ *  clock cycles. */
+#define SIM_TOSC_STARTUP_NS  1000000000UL
+
+/*! Number of oscillators with a frequency error: the three RC oscillators and
+ *  the crystal, in OSC.CTRL order. */
+#define SIM_DRIFT_COUNT   4
+
+/*! Number of DFLLs, DFLLRC32M first. */
+#define SIM_DFLL_COUNT    2
+
+/*! Nanoseconds between DFLL calibration steps: one period of the 1.024 kHz
+ *  reference clock. */
+#define SIM_DFLL_PERIOD_NS  (1000000000UL / 1024)
+
+/*! Clock change in ppm above which a character being received is not
+ *  sampled correctly. */
+#define SIM_USART_SKEW_PPM  20000
+
+/*! RTC clock cycles a written RTC register takes to synchronize. */
+#define SIM_RTC_SYNC_CLOCKS  2
+
+/*! Cycles of the 1.024 kHz crystal output a written RTC32 register takes to
+ *  synchronize, also in 1 Hz mode. */
+#define SIM_RTC32_SYNC_CLOCKS  2
+
+/*! Crystal clock cycles per RTC32 count tick in 1 Hz and 1.024 kHz mode. */
+#define SIM_RTC32_DIV_1HZ     32768
+#define SIM_RTC32_DIV_1KHZ    32
+
+/*! Watchdog Timer clock cycles to synchronize a new setting. */
+#define SIM_WDT_SYNC_CLOCKS  3
+
+/*! CPU cycles per Watchdog Timer clock cycle after reset: the 2 MHz internal
+ *  oscillator and the 1 kHz ULP oscillator. */
+#define SIM_WDT_CYCLES_DEFAULT  2000
+
+/*! Address of the driver view of the I/O memory, reachable by the DMA. */
+#define SIM_IO_ADDRESS    0x00200000UL
+
+/*! Highest address a DMA channel can reach. */
+#define SIM_DMA_ADDR_MAX  0x00FFFFFFUL
+
+/*! Number of bursts after which a DMA trigger that does not clear is reported. */
+#define SIM_DMA_RUNAWAY   0x100000UL
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE  0x100000
+#endif
+
+/* I/O memory offsets. */
+#define SIM_CCP_OFFSET    0x0034
+#define SIM_CLK_OFFSET    0x0040
+#define SIM_OSC_OFFSET    0x0050
+#define SIM_DFLL_OFFSET   0x0060
+#define SIM_DFLL_LAST     0x006F
+#define SIM_SREG_OFFSET   0x003F
+#define SIM_RST_OFFSET    0x0078
+#define SIM_WDT_OFFSET    0x0080
+#define SIM_AES_OFFSET    0x00C0
+#define SIM_AES_LAST      0x00C4
+#define SIM_DMA_OFFSET    0x0100
+#define SIM_DMA_CH_FIRST  0x0110
+#define SIM_DMA_LAST      0x014F
+#define SIM_PMIC_OFFSET   0x00A0
+#define SIM_VBAT_OFFSET   0x00F0
+#define SIM_VBAT_LAST     0x00F3
+#define SIM_NVM_OFFSET    0x01C0
+#define SIM_NVM_LAST      0x01CF
+#define SIM_MPCMASK       0x00B0
+#define SIM_VPCTRLA       0x00B2
+#define SIM_VPORT_FIRST   0x0010
+#define SIM_VPORT_LAST    0x001F
+#define SIM_EVSYS_OFFSET  0x0180
+#define SIM_EVSYS_LAST    0x0191
+#define SIM_RTC_OFFSET    0x0400
+#define SIM_RTC_LAST      0x040D
+#define SIM_RTC32_OFFSET  0x0420
+#define SIM_RTC32_LAST    0x0433
+#define SIM_PORT_FIRST    0x0600
+#define SIM_PORT_LAST     0x07FF
+/* The ports are 0x20 apart, more than sizeof(PORT_t). */
+#define SIM_PORT_SIZE     0x20
+
+/* Register offsets within a module. */
+#define SIM_CLK_CTRL      0x00
+#define SIM_CLK_PSCTRL    0x01
+#define SIM_CLK_LOCK      0x02
+#define SIM_CLK_RTCCTRL   0x03
+#define SIM_OSC_CTRL      0x00
+#define SIM_OSC_STATUS    0x01
+#define SIM_OSC_XOSCCTRL  0x02
+#define SIM_OSC_PLLCTRL   0x05
+#define SIM_OSC_DFLLCTRL  0x06
+#define SIM_DFLL_CTRL     0x00
+#define SIM_DFLL_SIZE     0x08
+#define SIM_RTC_CTRL      0x00
+#define SIM_RTC_STATUS    0x01
+#define SIM_RTC_INTFLAGS  0x03
+#define SIM_RTC_CNT       0x08
+#define SIM_RTC_PER       0x0A
+#define SIM_RTC_COMP      0x0C
+#define SIM_VBAT_CTRL     0x00
+#define SIM_VBAT_STATUS   0x01
+#define SIM_RTC32_CTRL    0x00
+#define SIM_RTC32_SYNCCTRL  0x01
+#define SIM_RTC32_INTFLAGS  0x03
+#define SIM_RTC32_CNT     0x08
+#define SIM_RTC32_PER     0x0C
+#define SIM_RTC32_COMP    0x10
+#define SIM_WDT_CTRL      0x00
+#define SIM_WDT_WINCTRL   0x01
+#define SIM_WDT_STATUS    0x02
+#define SIM_PORT_DIR      0x00
+#define SIM_PORT_DIRSET   0x01
+#define SIM_PORT_DIRCLR   0x02
+#define SIM_PORT_DIRTGL   0x03
+#define SIM_PORT_OUT      0x04
+#define SIM_PORT_OUTSET   0x05
+#define SIM_PORT_OUTCLR   0x06
+#define SIM_PORT_OUTTGL   0x07
+#define SIM_PORT_IN       0x08
+#define SIM_PORT_INTCTRL  0x09
+#define SIM_PORT_INT0MASK 0x0A
+#define SIM_PORT_INT1MASK 0x0B
+#define SIM_PORT_INTFLAGS 0x0C
+#define SIM_PORT_PIN0CTRL 0x10
+#define SIM_USART_DATA    0x00
+#define SIM_USART_STATUS  0x01
+#define SIM_USART_CTRLA   0x03
+#define SIM_USART_CTRLB   0x04
+#define SIM_USART_CTRLC   0x05
+#define SIM_USART_BAUDA   0x06
+#define SIM_USART_BAUDB   0x07
+#define SIM_AC_AC0CTRL    0x00
+#define SIM_AC_AC0MUXCTRL 0x02
+#define SIM_AC_CTRLB      0x05
+#define SIM_AC_WINCTRL    0x06
+#define SIM_AC_STATUS     0x07
+#define SIM_SPI_CTRL      0x00
+#define SIM_SPI_INTCTRL   0x01
+#define SIM_SPI_STATUS    0x02
+#define SIM_SPI_DATA      0x03
+#define SIM_TWI_CTRL      0x00
+#define SIM_TWIM_CTRLA    0x01
+#define SIM_TWIM_CTRLB    0x02
+#define SIM_TWIM_CTRLC    0x03
+#define SIM_TWIM_STATUS   0x04
+#define SIM_TWIM_BAUD     0x05
+#define SIM_TWIM_ADDR     0x06
+#define SIM_TWIM_DATA     0x07
+#define SIM_TWIS_CTRLA    0x08
+#define SIM_TWIS_CTRLB    0x09
+#define SIM_TWIS_STATUS   0x0A
+#define SIM_TWIS_ADDR     0x0B
+#define SIM_TWIS_DATA     0x0C
+#define SIM_AES_CTRL      0x00
+#define SIM_AES_STATUS    0x01
+#define SIM_AES_STATE     0x02
+#define SIM_AES_KEY       0x03
+#define SIM_AES_INTCTRL   0x04
+#define SIM_ADC_CTRLA     0x00
+#define SIM_ADC_CTRLB     0x01
+#define SIM_ADC_REFCTRL   0x02
+#define SIM_ADC_PRESCALER 0x04
+#define SIM_ADC_INTFLAGS  0x06
+#define SIM_ADC_CH0RES    0x10
+#define SIM_ADC_CMP       0x18
+#define SIM_ADC_CH0       0x20
+#define SIM_ADC_CH_CTRL   0x00
+#define SIM_ADC_CH_MUXCTRL  0x01
+#define SIM_ADC_CH_INTCTRL  0x02
+#define SIM_ADC_CH_INTFLAGS 0x03
+#define SIM_ADC_CH_RES    0x04
+#define SIM_ADC_CH_SIZE   0x08
+#define SIM_NVM_ADDR0     0x00
+#define SIM_NVM_DATA0     0x04
+#define SIM_NVM_CMD       0x0A
+#define SIM_NVM_CTRLA     0x0B
+#define SIM_NVM_INTCTRL   0x0D
+#define SIM_NVM_STATUS    0x0F
+#define SIM_DMA_CTRL      0x00
+#define SIM_DMA_INTFLAGS  0x03
+#define SIM_DMA_STATUS    0x04
+#define SIM_DMA_CTRLA     0x00
+#define SIM_DMA_CTRLB     0x01
+#define SIM_DMA_ADDRCTRL  0x02
+#define SIM_DMA_TRIGSRC   0x03
+#define SIM_DMA_TRFCNT    0x04
+#define SIM_DMA_REPCNT    0x06
+#define SIM_DMA_SRCADDR   0x08
+#define SIM_DMA_DESTADDR  0x0C
+#define SIM_EVSYS_STROBE  0x10
+#define SIM_TC_CTRLA      0x00
+#define SIM_TC_CTRLB      0x01
+#define SIM_TC_CTRLD      0x03
+#define SIM_TC_INTCTRLA   0x06
+#define SIM_TC_INTCTRLB   0x07
+#define SIM_TC_CTRLFCLR   0x08
+#define SIM_TC_CTRLFSET   0x09
+#define SIM_TC_CTRLGCLR   0x0A
+#define SIM_TC_CTRLGSET   0x0B
+#define SIM_TC_INTFLAGS   0x0C
+#define SIM_TC_CNT        0x20
+#define SIM_TC_PER        0x26
+#define SIM_TC_CCA        0x28
+#define SIM_TC_PERBUF     0x36
+#define SIM_AWEX_FDEVMASK 0x02
+#define SIM_AWEX_FDCTRL   0x03
+#define SIM_AWEX_STATUS   0x04
+#define SIM_AWEX_DTBOTH   0x06
+#define SIM_AWEX_DTBOTHBUF  0x07
+#define SIM_AWEX_DTLS     0x08
+#define SIM_AWEX_DTHS     0x09
+#define SIM_AWEX_DTLSBUF  0x0A
+#define SIM_AWEX_DTHSBUF  0x0B
+#define SIM_AWEX_OUTOVEN  0x0C
+
+/*! Offset of the AWeX of ports C and E from their Timer/Counter 0. */
+#define SIM_AWEX_OFFSET   0x80
+/*! Offset of the HiRes module of each port from its Timer/Counter 0. */
+#define SIM_HIRES_OFFSET  0x90
+/*! Number of buffered registers of a Timer/Counter 0, PER and CCA to CCD. */
+#define SIM_TC_BUFFERS    5
+
+/*! First event multiplexer input of the port pins, eight per port. */
+#define SIM_EVSYS_PORT_PIN0  0x50
+/*! First event multiplexer input of TCC0, TCD0 to TCF0 follow every 0x10. */
+#define SIM_EVSYS_TC_OVF     0xC0
+/*! DMA trigger source of the TCC0 overflow, TCD0 to TCF0 follow every 0x20. */
+#define SIM_DMA_TRIGSRC_TC_OVF  0x40
+
+/*! Ninth bit of a character on the line, the address bit in MPCM. */
+#define SIM_USART_BIT8    0x0100
+
+/*! Frame and parity error flags of a character in the receive FIFO. */
+#define SIM_USART_FERR    0x0200
+#define SIM_USART_PERR    0x0400
+
+/*! SS pin of an SPI module in its port. */
+#define SIM_SPI_SS        0x10
+
+/*! Data order and clock phase bits of USART.CTRLC in master SPI mode. */
+#define SIM_USART_UDORD   0x04
+#define SIM_USART_UCPHA   0x02
+
+/*! Interrupt sources of a USART, in vector order. */
+typedef enum SIM_USART_Source_enum {
+	SIM_USART_RXC = 0,
+	SIM_USART_DRE = 1,
+	SIM_USART_TXC = 2,
+} SIM_USART_Source_t;
+
+/*! \brief State of a simulated USART not visible in its registers. */
+typedef struct SIM_USART_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Vector number of the RXC interrupt, DRE and TXC follow. */
+	uint8_t rxcVector;
+	/*! Receive FIFO with the ninth bit and the error flags, the first entry
+	 *  is read from DATA. */
+	uint16_t rxFifo[2];
+	/*! Number of characters in the receive FIFO. */
+	uint8_t rxCount;
+	/*! Last character read, returned by DATA when the FIFO is empty. */
+	uint16_t rxLast;
+	/*! Transmit shift register busy. */
+	bool txBusy;
+	/*! Transmit data register holds a character. */
+	bool txFull;
+	/*! Character being shifted out. */
+	uint16_t txShift;
+	/*! Character in the transmit data register. */
+	uint16_t txData;
+	/*! Time the character in the shift register is sent. */
+	uint64_t txDone;
+	/*! Characters on their way to the receiver. */
+	uint16_t rxLine[SIM_USART_LINE_SIZE];
+	uint16_t rxLineHead;
+	uint16_t rxLineCount;
+	/*! Idle time before each character of rxLine, in CPU cycles. */
+	uint32_t rxLineIdle[SIM_USART_LINE_SIZE];
+	/*! Time the first character of rxLine is received. */
+	uint64_t rxLineDone;
+	/*! Idle time before the next character injected. */
+	uint32_t rxLineGap;
+	/*! Levels of the character on the RXD pin, one bit per bit time,
+	 *  starting with the start bit. */
+	uint16_t rxdLevels;
+	/*! Bit times of the character on the RXD pin, zero when idle. */
+	uint8_t rxdBits;
+	/*! Next bit time to apply to the RXD pin. */
+	uint8_t rxdNext;
+	/*! Start time and length of the character on the RXD pin. */
+	uint64_t rxdStart;
+	uint64_t rxdCycles;
+	/*! Characters sent by the transmitter, not yet read by SIM_USART_Read(). */
+	uint16_t txLine[SIM_USART_LINE_SIZE];
+	uint16_t txLineHead;
+	uint16_t txLineCount;
+	/*! Total number of characters sent. */
+	uint32_t txCount;
+	/*! Characters lost because the receiver was disabled or overflowed. */
+	uint32_t rxLost;
+	/*! Receivers the transmitter is connected to, one bit per SIM_usart entry. */
+	uint8_t connections;
+	/*! Edges left to apply to the RXD pin, see SIM_USART_InjectEdges(). */
+	const SIM_Edge_t * edges;
+	uint16_t edgeCount;
+	/*! Time of the first edge left, and the level of the line. */
+	uint64_t edgeTime;
+	bool edgeLevel;
+	/*! The receiver is sampling a frame of the edge trace. */
+	bool sampling;
+	/*! Time of the start edge, bits sampled and their levels. */
+	uint64_t sampleStart;
+	uint8_t sampleCount;
+	uint16_t sampleLevels;
+	/*! Port offset and pin mask of the transceiver DE input, dePort is
+	 *  zero without transceiver. */
+	uint16_t dePort;
+	uint8_t deMask;
+	/*! DE level and the time it was last set. */
+	bool deHigh;
+	uint64_t deSet;
+	/*! The next character is the first since DE was set. */
+	bool deFirst;
+	/*! A character has been sent on the bus since DE was set. */
+	bool deSent;
+	/*! End of the last character sent on the bus, SIM_NOT_PENDING if none. */
+	uint64_t deLastStop;
+	/*! The character in the shift register reaches the bus. */
+	bool txOnBus;
+	/*! Driver enable timing, see SIM_USART_GetTransceiverStats(). */
+	SIM_TransceiverStats_t deStats;
+	/*! Total time the shift register has been sending. */
+	uint64_t shiftCycles;
+} SIM_USART_t;
+
+
+/*! \brief State of a DMA channel not visible in its registers. */
+typedef struct SIM_DMA_CH_struct {
+	/*! Channel offset in the I/O memory. */
+	uint16_t offset;
+	/*! Source address at the start of the transaction, block and burst. */
+	uint32_t srcTransaction;
+	uint32_t srcBlock;
+	uint32_t srcBurst;
+	/*! Destination address at the start of the transaction, block and burst. */
+	uint32_t destTransaction;
+	uint32_t destBlock;
+	uint32_t destBurst;
+	/*! Block size written to TRFCNT when the channel was enabled. */
+	uint16_t blockSize;
+	/*! An event on the trigger channel, or a transfer complete of the
+	 *  trigger source, has not been served yet. */
+	bool eventRequest;
+	/*! Time the request in eventRequest was noted. */
+	uint64_t requestTime;
+} SIM_DMA_CH_t;
+
+
+/*! \brief State of a simulated Timer/Counter not visible in its registers.
+ *
+ *  CNT is not updated on every clock tick. It is brought up to date before
+ *  each access to the module and when one of its events is due.
+ */
+typedef struct SIM_TC_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Vector number of the OVF interrupt, ERR and CCA to CCD follow. */
+	uint8_t ovfVector;
+	/*! Time of the last clock tick counted in CNT. */
+	uint64_t lastTick;
+} SIM_TC_t;
+
+
+/*! \brief State of a simulated Analog Comparator not visible in its registers. */
+typedef struct SIM_AC_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Offset of the port with the analog input pins. */
+	uint16_t port;
+	/*! Vector number of the AC0 interrupt, AC1 and ACW follow. */
+	uint8_t vector;
+	/*! Event multiplexer input of comparator 0, comparator 1 and the window
+	 *  follow. */
+	uint8_t evsys;
+	/*! Voltage on each input pin, in millivolts. */
+	int16_t input[SIM_AC_INPUTS];
+	/*! Sample trace replayed on each input pin, NULL if none, see
+	 *  SIM_AC_SetTrace(). */
+	const int16_t * trace[SIM_AC_INPUTS];
+	uint32_t traceCount[SIM_AC_INPUTS];
+	uint32_t traceIndex[SIM_AC_INPUTS];
+	uint32_t traceCycles[SIM_AC_INPUTS];
+	bool traceRepeat[SIM_AC_INPUTS];
+	/*! Time the next sample of each trace is applied. */
+	uint64_t traceNext[SIM_AC_INPUTS];
+} SIM_AC_t;
+
+
+/*! \brief State of a simulated SPI module not visible in its registers. */
+typedef struct SIM_SPI_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Offset of the port with the SS, MOSI, MISO and SCK pins. */
+	uint16_t port;
+	/*! Vector number of the interrupt. */
+	uint8_t vector;
+	/*! DMA trigger source of the transfer complete. */
+	uint8_t trigsrc;
+	/*! A byte is being shifted. */
+	bool busy;
+	/*! Byte being shifted out, as written to DATA. In slave mode, the byte
+	 *  waiting for the next transfer. */
+	uint8_t txShift;
+	/*! Time the byte being shifted is complete. */
+	uint64_t txDone;
+	/*! Last byte received, returned by DATA. */
+	uint8_t rxData;
+	/*! STATUS has been read with IF set, the next DATA access clears IF. */
+	bool ifRead;
+	/*! Bytes the module receives, in wire order: from the slave on MISO in
+	 *  master mode, from the external master on MOSI in slave mode. */
+	uint8_t rxLine[SIM_SPI_LINE_SIZE];
+	uint16_t rxLineHead;
+	uint16_t rxLineCount;
+	/*! Bytes the module has sent, in wire order, not yet read by SIM_SPI_Read(). */
+	uint8_t txLine[SIM_SPI_LINE_SIZE];
+	uint16_t txLineHead;
+	uint16_t txLineCount;
+	/*! Total time the shift register has been shifting. */
+	uint64_t shiftCycles;
+	/*! SCK period and gap between bytes of the external master, see
+	 *  SIM_SPI_SetMasterClock(). */
+	uint32_t masterBitCycles;
+	uint32_t masterGapCycles;
+	/*! SS is low. */
+	bool selected;
+	/*! Time the external master starts the next byte, in slave mode. */
+	uint64_t nextStart;
+} SIM_SPI_t;
+
+
+/*! \brief Bus phases of a simulated TWI module. */
+typedef enum SIM_TWI_Phase_enum {
+	SIM_TWI_IDLE = 0,     /*!< No transaction on the bus. */
+	SIM_TWI_ADDRESS,      /*!< START and the address byte are being sent. */
+	SIM_TWI_WRITE,        /*!< The master sends a data byte. */
+	SIM_TWI_READ,         /*!< The slave sends a data byte. */
+	SIM_TWI_ACK,          /*!< The acknowledge bit is being sent. */
+	SIM_TWI_STOP,         /*!< The STOP condition is being sent. */
+	SIM_TWI_MASTER_WAIT,  /*!< SCL is held until the master is given a command. */
+	SIM_TWI_SLAVE_WAIT,   /*!< SCL is held until the slave is given a command. */
+} SIM_TWI_Phase_t;
+
+
+/*! \brief State of a simulated TWI module not visible in its registers. */
+typedef struct SIM_TWI_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Vector number of the slave interrupt, the master interrupt follows. */
+	uint8_t vector;
+	/*! Bus phase, and the time it is complete if the bus is being clocked. */
+	SIM_TWI_Phase_t phase;
+	uint64_t done;
+	/*! The transaction reads from the slave. */
+	bool read;
+	/*! The slave of the module has acknowledged its address. */
+	bool addressed;
+	/*! The slave is to send the next byte. */
+	bool slaveTransmit;
+	/*! The acknowledge bit being sent, and whether the slave sends it. */
+	bool nack;
+	bool ackBySlave;
+	/*! The master has read a byte and not sent its acknowledge bit yet. */
+	bool ackPending;
+	/*! The STOP condition follows the acknowledge bit. */
+	bool stopAfterAck;
+	/*! Byte on the bus. */
+	uint8_t shift;
+} SIM_TWI_t;
+
+
+/*! \brief State of the simulated AES module not visible in its registers. */
+typedef struct SIM_AES_struct {
+	/*! State and key memories. */
+	uint8_t state[16];
+	uint8_t key[16];
+	/*! Read and write pointers of the STATE and KEY registers. */
+	uint8_t stateRead;
+	uint8_t stateWrite;
+	uint8_t keyRead;
+	uint8_t keyWrite;
+	/*! An encryption or decryption is in progress, complete at done. */
+	bool busy;
+	uint64_t done;
+} SIM_AES_t;
+
+
+/*! \brief State of a simulated ADC not visible in its registers. */
+typedef struct SIM_ADC_struct {
+	/*! Module offset in the I/O memory. */
+	uint16_t offset;
+	/*! Vector number of the channel 0 interrupt, channels 1 to 3 follow. */
+	uint8_t vector;
+	/*! Voltage on each input pin, in millivolts. */
+	int16_t input[SIM_ADC_INPUTS];
+	/*! Time the conversion of each channel is complete, UINT64_MAX if none. */
+	uint64_t done[SIM_ADC_CH_COUNT];
+	/*! Result of the conversion of each channel. */
+	uint16_t result[SIM_ADC_CH_COUNT];
+	/*! Time the pipeline takes the next conversion. */
+	uint64_t nextSlot;
+} SIM_ADC_t;
+
+
+/*! \brief An interrupt source of a modelled module. */
+typedef struct SIM_Source_struct {
+	/*! Interrupt vector number. */
+	uint8_t vectorNum;
+	/*! Index passed to the functions below, identifies the source in its module. */
+	uint8_t index;
+	/*! Get the requested interrupt level, 0 if none. */
+	uint8_t (* level)(uint8_t index);
+	/*! Called when the interrupt is taken, NULL if nothing is to be done. */
+	void (* taken)(uint8_t index);
+} SIM_Source_t;
+
+
+/* Weak references to the ISRs, NULL unless defined by the application. */
+#define SIM_WEAK_ISR(_vector)  extern void _vector(void) __attribute__ ((weak))
+#define SIM_USART_VECTORS(_usart)                                              \
+	SIM_WEAK_ISR(_usart##_RXC_vect);                                       \
+	SIM_WEAK_ISR(_usart##_DRE_vect);                                       \
+	SIM_WEAK_ISR(_usart##_TXC_vect)
+
+SIM_WEAK_ISR(DMA_CH0_vect);
+SIM_WEAK_ISR(DMA_CH1_vect);
+SIM_WEAK_ISR(DMA_CH2_vect);
+SIM_WEAK_ISR(DMA_CH3_vect);
+SIM_USART_VECTORS(USARTC0);
+SIM_USART_VECTORS(USARTC1);
+SIM_USART_VECTORS(USARTE0);
+SIM_USART_VECTORS(USARTE1);
+SIM_USART_VECTORS(USARTD0);
+SIM_USART_VECTORS(USARTD1);
+SIM_USART_VECTORS(USARTF0);
+SIM_USART_VECTORS(USARTF1);
+
+#define SIM_TC_VECTORS(_tc)                                                    \
+	SIM_WEAK_ISR(_tc##_OVF_vect);                                          \
+	SIM_WEAK_ISR(_tc##_ERR_vect);                                          \
+	SIM_WEAK_ISR(_tc##_CCA_vect);                                          \
+	SIM_WEAK_ISR(_tc##_CCB_vect);                                          \
+	SIM_WEAK_ISR(_tc##_CCC_vect);                                          \
+	SIM_WEAK_ISR(_tc##_CCD_vect)
+
+SIM_TC_VECTORS(TCC0);
+SIM_TC_VECTORS(TCD0);
+SIM_TC_VECTORS(TCE0);
+SIM_TC_VECTORS(TCF0);
+
+SIM_WEAK_ISR(SPIC_INT_vect);
+SIM_WEAK_ISR(SPID_INT_vect);
+SIM_WEAK_ISR(SPIE_INT_vect);
+SIM_WEAK_ISR(SPIF_INT_vect);
+
+#define SIM_PORT_VECTORS(_port)                                                \
+	SIM_WEAK_ISR(_port##_INT0_vect);                                       \
+	SIM_WEAK_ISR(_port##_INT1_vect)
+
+SIM_PORT_VECTORS(PORTA);
+SIM_PORT_VECTORS(PORTB);
+SIM_PORT_VECTORS(PORTC);
+SIM_PORT_VECTORS(PORTD);
+SIM_PORT_VECTORS(PORTE);
+SIM_PORT_VECTORS(PORTF);
+
+#define SIM_AC_VECTORS(_ac)                                                    \
+	SIM_WEAK_ISR(_ac##_AC0_vect);                                          \
+	SIM_WEAK_ISR(_ac##_AC1_vect);                                          \
+	SIM_WEAK_ISR(_ac##_ACW_vect)
+
+SIM_AC_VECTORS(ACA);
+SIM_AC_VECTORS(ACB);
+
+#define SIM_TWI_VECTORS(_twi)                                                  \
+	SIM_WEAK_ISR(_twi##_TWIS_vect);                                        \
+	SIM_WEAK_ISR(_twi##_TWIM_vect)
+
+SIM_TWI_VECTORS(TWIC);
+SIM_TWI_VECTORS(TWID);
+SIM_TWI_VECTORS(TWIE);
+SIM_TWI_VECTORS(TWIF);
+
+#define SIM_ADC_VECTORS(_adc)                                                  \
+	SIM_WEAK_ISR(_adc##_CH0_vect);                                         \
+	SIM_WEAK_ISR(_adc##_CH1_vect);                                         \
+	SIM_WEAK_ISR(_adc##_CH2_vect);                                         \
+	SIM_WEAK_ISR(_adc##_CH3_vect)
+
+SIM_ADC_VECTORS(ADCA);
+SIM_ADC_VECTORS(ADCB);
+
+SIM_WEAK_ISR(AES_INT_vect);
+SIM_WEAK_ISR(NVM_EE_vect);
+SIM_WEAK_ISR(NVM_SPM_vect);
+
+#define SIM_ISR(_vector)  [_vector##_num] = _vector
+#define SIM_USART_ISRS(_usart)                                                 \
+	SIM_ISR(_usart##_RXC_vect),                                            \
+	SIM_ISR(_usart##_DRE_vect),                                            \
+	SIM_ISR(_usart##_TXC_vect)
+#define SIM_TC_ISRS(_tc)                                                       \
+	SIM_ISR(_tc##_OVF_vect),                                               \
+	SIM_ISR(_tc##_ERR_vect),                                               \
+	SIM_ISR(_tc##_CCA_vect),                                               \
+	SIM_ISR(_tc##_CCB_vect),                                               \
+	SIM_ISR(_tc##_CCC_vect),                                               \
+	SIM_ISR(_tc##_CCD_vect)
+#define SIM_PORT_ISRS(_port)                                                   \
+	SIM_ISR(_port##_INT0_vect),                                            \
+	SIM_ISR(_port##_INT1_vect)
+#define SIM_AC_ISRS(_ac)                                                       \
+	SIM_ISR(_ac##_AC0_vect),                                               \
+	SIM_ISR(_ac##_AC1_vect),                                               \
+	SIM_ISR(_ac##_ACW_vect)
+#define SIM_TWI_ISRS(_twi)                                                     \
+	SIM_ISR(_twi##_TWIS_vect),                                             \
+	SIM_ISR(_twi##_TWIM_vect)
+#define SIM_ADC_ISRS(_adc)                                                     \
+	SIM_ISR(_adc##_CH0_vect),                                              \
+	SIM_ISR(_adc##_CH1_vect),                                              \
+	SIM_ISR(_adc##_CH2_vect),                                              \
+	SIM_ISR(_adc##_CH3_vect)
+
+/*! ISRs of the modelled vectors, by vector number. */
+static void (* const SIM_isr[_VECTORS_COUNT])(void) = {
+	SIM_ISR(DMA_CH0_vect),
+	SIM_ISR(DMA_CH1_vect),
+	SIM_ISR(DMA_CH2_vect),
+	SIM_ISR(DMA_CH3_vect),
+	SIM_TC_ISRS(TCC0),
+	SIM_TC_ISRS(TCD0),
+	SIM_TC_ISRS(TCE0),
+	SIM_TC_ISRS(TCF0),
+	SIM_ISR(SPIC_INT_vect),
+	SIM_ISR(SPID_INT_vect),
+	SIM_ISR(SPIE_INT_vect),
+	SIM_ISR(SPIF_INT_vect),
+	SIM_USART_ISRS(USARTC0),
+	SIM_USART_ISRS(USARTC1),
+	SIM_USART_ISRS(USARTE0),
+	SIM_USART_ISRS(USARTE1),
+	SIM_USART_ISRS(USARTD0),
+	SIM_USART_ISRS(USARTD1),
+	SIM_USART_ISRS(USARTF0),
+	SIM_USART_ISRS(USARTF1),
+	SIM_PORT_ISRS(PORTA),
+	SIM_PORT_ISRS(PORTB),
+	SIM_PORT_ISRS(PORTC),
+	SIM_PORT_ISRS(PORTD),
+	SIM_PORT_ISRS(PORTE),
+	SIM_PORT_ISRS(PORTF),
+	SIM_AC_ISRS(ACA),
+	SIM_AC_ISRS(ACB),
+	SIM_TWI_ISRS(TWIC),
+	SIM_TWI_ISRS(TWID),
+	SIM_TWI_ISRS(TWIE),
+	SIM_TWI_ISRS(TWIF),
+	SIM_ADC_ISRS(ADCA),
+	SIM_ADC_ISRS(ADCB),
+	SIM_ISR(AES_INT_vect),
+	SIM_ISR(NVM_EE_vect),
+	SIM_ISR(NVM_SPM_vect),
+};
+
+#define SIM_USART_INIT(_usart, _offset)                                        \
+	{ .offset = _offset, .rxcVector = _usart##_RXC_vect_num, .txOnBus = true }
+
+/*! Simulated USARTs, in vector order, which is the priority order. */
+static SIM_USART_t SIM_usart[SIM_USART_COUNT] = {
+	SIM_USART_INIT(USARTC0, 0x08A0),
+	SIM_USART_INIT(USARTC1, 0x08B0),
+	SIM_USART_INIT(USARTE0, 0x0AA0),
+	SIM_USART_INIT(USARTE1, 0x0AB0),
+	SIM_USART_INIT(USARTD0, 0x09A0),
+	SIM_USART_INIT(USARTD1, 0x09B0),
+	SIM_USART_INIT(USARTF0, 0x0BA0),
+	SIM_USART_INIT(USARTF1, 0x0BB0),
+};
+
+#define SIM_TC_INIT(_tc, _offset)                                              \
+	{ .offset = _offset, .ovfVector = _tc##_OVF_vect_num }
+
+/*! Simulated Timer/Counters. */
+static SIM_TC_t SIM_tc[SIM_TC_COUNT] = {
+	SIM_TC_INIT(TCC0, 0x0800),
+	SIM_TC_INIT(TCD0, 0x0900),
+	SIM_TC_INIT(TCE0, 0x0A00),
+	SIM_TC_INIT(TCF0, 0x0B00),
+};
+
+#define SIM_SPI_INIT(_spi, _offset, _port)                                     \
+	{ .offset = _offset, .port = _port, .vector = _spi##_INT_vect_num,     \
+	  .trigsrc = DMA_CH_TRIGSRC_##_spi##_gc }
+
+/*! Simulated SPI modules. */
+static SIM_SPI_t SIM_spi[SIM_SPI_COUNT] = {
+	SIM_SPI_INIT(SPIC, 0x08C0, 0x0640),
+	SIM_SPI_INIT(SPID, 0x09C0, 0x0660),
+	SIM_SPI_INIT(SPIE, 0x0AC0, 0x0680),
+	SIM_SPI_INIT(SPIF, 0x0BC0, 0x06A0),
+};
+
+#define SIM_AC_INIT(_ac, _offset, _port)                                       \
+	{ .offset = _offset, .port = _port, .vector = _ac##_AC0_vect_num,      \
+	  .evsys = EVSYS_CHMUX_##_ac##_CH0_gc }
+
+/*! Simulated Analog Comparators, with their inputs on PORTA and PORTB. */
+static SIM_AC_t SIM_ac[SIM_AC_COUNT] = {
+	SIM_AC_INIT(ACA, 0x0380, 0x0600),
+	SIM_AC_INIT(ACB, 0x0390, 0x0620),
+};
+
+#define SIM_TWI_INIT(_twi, _offset)                                            \
+	{ .offset = _offset, .vector = _twi##_TWIS_vect_num }
+
+/*! Simulated TWI modules. */
+static SIM_TWI_t SIM_twi[SIM_TWI_COUNT] = {
+	SIM_TWI_INIT(TWIC, 0x0480),
+	SIM_TWI_INIT(TWID, 0x0490),
+	SIM_TWI_INIT(TWIE, 0x04A0),
+	SIM_TWI_INIT(TWIF, 0x04B0),
+};
+
+#define SIM_ADC_INIT(_adc, _offset)                                            \
+	{ .offset = _offset, .vector = _adc##_CH0_vect_num }
+
+/*! Simulated ADCs, with their inputs on PORTA and PORTB. */
+static SIM_ADC_t SIM_adc[SIM_ADC_COUNT] = {
+	SIM_ADC_INIT(ADCA, 0x0200),
+	SIM_ADC_INIT(ADCB, 0x0240),
+};
+
+/*! Simulated AES module. */
+static SIM_AES_t SIM_aes;
+
+/*! EEPROM contents, kept over resets, and the EEPROM page buffer with a bit
+ *  per loaded byte. */
+static uint8_t SIM_eeprom[SIM_EEPROM_SIZE];
+static uint8_t SIM_eeBuffer[SIM_EEPROM_PAGE];
+static uint32_t SIM_eeLoaded;
+
+/*! Time in nanoseconds the NVM controller is no longer busy, UINT64_MAX if
+ *  not busy. */
+static uint64_t SIM_nvmDone;
+
+/*! Input pin of each negative input selection, -1 for the internal ones. */
+static const int8_t SIM_acMuxNegPin[8] = { 0, 1, 3, 5, 7, -1, -1, -1 };
+
+/*! SCK division of the SPI prescaler settings, without CLK2X. */
+static const uint8_t SIM_spiDivision[4] = { 4, 16, 64, 128 };
+
+/*! Voltages of the internal ADC inputs in MUXINT order, in millivolts:
+ *  the temperature sensor, the bandgap, VCC/10 and the DAC. */
+static const int16_t SIM_adcInternalMv[4] = { 0, SIM_AC_BANDGAP_MV, SIM_AC_VCC_MV / 10, 0 };
+
+/*! AES S-box. */
+static const uint8_t SIM_aesSbox[256] = {
+	0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B,
+	0xFE, 0xD7, 0xAB, 0x76, 0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
+	0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0, 0xB7, 0xFD, 0x93, 0x26,
+	0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+	0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2,
+	0xEB, 0x27, 0xB2, 0x75, 0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
+	0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84, 0x53, 0xD1, 0x00, 0xED,
+	0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+	0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F,
+	0x50, 0x3C, 0x9F, 0xA8, 0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
+	0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2, 0xCD, 0x0C, 0x13, 0xEC,
+	0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+	0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14,
+	0xDE, 0x5E, 0x0B, 0xDB, 0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
+	0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79, 0xE7, 0xC8, 0x37, 0x6D,
+	0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+	0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F,
+	0x4B, 0xBD, 0x8B, 0x8A, 0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
+	0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E, 0xE1, 0xF8, 0x98, 0x11,
+	0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+	0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F,
+	0xB0, 0x54, 0xBB, 0x16
+};
+
+/*! Inverse AES S-box. */
+static const uint8_t SIM_aesInvSbox[256] = {
+	0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38, 0xBF, 0x40, 0xA3, 0x9E,
+	0x81, 0xF3, 0xD7, 0xFB, 0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87,
+	0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB, 0x54, 0x7B, 0x94, 0x32,
+	0xA6, 0xC2, 0x23, 0x3D, 0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
+	0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2, 0x76, 0x5B, 0xA2, 0x49,
+	0x6D, 0x8B, 0xD1, 0x25, 0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16,
+	0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92, 0x6C, 0x70, 0x48, 0x50,
+	0xFD, 0xED, 0xB9, 0xDA, 0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
+	0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A, 0xF7, 0xE4, 0x58, 0x05,
+	0xB8, 0xB3, 0x45, 0x06, 0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02,
+	0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B, 0x3A, 0x91, 0x11, 0x41,
+	0x4F, 0x67, 0xDC, 0xEA, 0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
+	0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85, 0xE2, 0xF9, 0x37, 0xE8,
+	0x1C, 0x75, 0xDF, 0x6E, 0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89,
+	0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B, 0xFC, 0x56, 0x3E, 0x4B,
+	0xC6, 0xD2, 0x79, 0x20, 0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
+	0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31, 0xB1, 0x12, 0x10, 0x59,
+	0x27, 0x80, 0xEC, 0x5F, 0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D,
+	0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF, 0xA0, 0xE0, 0x3B, 0x4D,
+	0xAE, 0x2A, 0xF5, 0xB0, 0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
+	0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26, 0xE1, 0x69, 0x14, 0x63,
+	0x55, 0x21, 0x0C, 0x7D
+};
+
+/*! Clock division of the prescaler settings, zero for the event clocks. */
+static const uint16_t SIM_tcDivision[16] = { 0, 1, 2, 4, 8, 64, 256, 1024 };
+
+/*! Interrupt flag of each Timer/Counter interrupt source, in vector order. */
+static const uint8_t SIM_tcFlag[SIM_TC_SOURCES] = {
+	TC0_OVFIF_bm, TC0_ERRIF_bm, TC0_CCAIF_bm, TC0_CCBIF_bm, TC0_CCCIF_bm, TC0_CCDIF_bm
+};
+
+/*! INT0 vector number of each port, INT1 follows. */
+static const uint8_t SIM_portVector[SIM_PORT_COUNT] = {
+	PORTA_INT0_vect_num, PORTB_INT0_vect_num, PORTC_INT0_vect_num,
+	PORTD_INT0_vect_num, PORTE_INT0_vect_num, PORTF_INT0_vect_num
+};
+
+/*! Oscillator of each system clock selection, in OSC.CTRL and OSC.STATUS. */
+static const uint8_t SIM_clkSourceOsc[8] = {
+	OSC_RC2MEN_bm, OSC_RC32MEN_bm, OSC_RC32KEN_bm, OSC_XOSCEN_bm, OSC_PLLEN_bm
+};
+
+/*! Clock division of the prescaler B and C settings. */
+static const uint8_t SIM_clkBcDivision[4] = { 1, 2, 4, 4 };
+
+/*! Assumed start-up time of each oscillator in nanoseconds. The crystal
+ *  oscillator is given by SIM_OSC_StartupNs(). */
+static const uint32_t SIM_oscStartupNs[SIM_OSC_COUNT] = { 6000, 6000, 1000000, 0, 25000 };
+
+/*! Oscillator calibrated by each DFLL, as its bit number in OSC.CTRL. */
+static const uint8_t SIM_dfllOsc[SIM_DFLL_COUNT] = { 1, 0 };
+
+/*! OSC.DFLLCTRL bit selecting the crystal as the reference of each DFLL. */
+static const uint8_t SIM_dfllCref[SIM_DFLL_COUNT] = { OSC_RC32MCREF_bm, OSC_RC2MCREF_bm };
+
+/*! RTC clock division of each RTC_PRESCALER setting, zero when stopped. */
+static const uint16_t SIM_rtcDivision[8] = { 0, 1, 2, 8, 16, 64, 256, 1024 };
+
+/*! Simulated DMA channels. */
+static SIM_DMA_CH_t SIM_dma[SIM_DMA_CH_COUNT] = {
+	{ .offset = 0x0110 },
+	{ .offset = 0x0120 },
+	{ .offset = 0x0130 },
+	{ .offset = 0x0140 },
+};
+
+/*! Time of a burst requested once per transfer, see SIM_DMA_SetLatency(). */
+static uint32_t SIM_dmaLatency;
+/*! Time the last delayed burst completed. */
+static uint64_t SIM_dmaFree;
+
+/*! Interrupt sources of the modelled modules, in vector order. */
+static SIM_Source_t SIM_source[_VECTORS_COUNT];
+static uint8_t SIM_sourceCount;
+
+/*! I/O memory as seen by the drivers, every access traps. */
+uint8_t * SIM_ioSpace;
+
+/*! I/O memory as seen by the models. */
+static uint8_t * SIM_io;
+
+/*! Simulated time in CPU cycles. */
+static uint64_t SIM_cycles;
+
+/*! Offset of the register access being single-stepped. */
+static uint16_t SIM_accessOffset;
+/*! The access being single-stepped is a write. */
+static bool SIM_accessWrite;
+/*! Register value before the access being single-stepped. */
+static uint8_t SIM_accessOld;
+/*! A register access is being single-stepped. */
+static volatile sig_atomic_t SIM_stepping;
+
+/*! PMIC.STATUS, kept here as the register is read-only. */
+static uint8_t SIM_pmicStatus;
+/*! Time of the last CCP signature for the I/O registers, SIM_NOT_PENDING
+ *  if none. */
+static uint64_t SIM_ccpTime = SIM_NOT_PENDING;
+/*! CPU cycles per Watchdog Timer clock cycle, see SIM_WDT_SetClock(). */
+static uint32_t SIM_wdtCycles = SIM_WDT_CYCLES_DEFAULT;
+/*! Time the Watchdog Timer was last restarted. */
+static uint64_t SIM_wdtStart;
+/*! Time the last Watchdog Timer setting is synchronized. */
+static uint64_t SIM_wdtSynced;
+/*! CPU clock frequency. */
+static uint32_t SIM_cpuHz = SIM_RC2M_HZ;
+/*! Nanoseconds elapsed at SIM_nsCycles, the last clock frequency change. */
+static uint64_t SIM_nsBase;
+static uint64_t SIM_nsCycles;
+/*! Time each oscillator becomes ready, in nanoseconds. */
+static uint64_t SIM_oscReady[SIM_OSC_COUNT];
+/*! Frequency error of each oscillator, see SIM_OSC_SetDrift(), in ppm. */
+static int32_t SIM_oscDrift[SIM_DRIFT_COUNT];
+/*! Correction of each oscillator by its DFLL, in ppm. */
+static int32_t SIM_oscCorrection[SIM_DRIFT_COUNT];
+/*! Time of the next step of each DFLL in nanoseconds, UINT64_MAX if disabled. */
+static uint64_t SIM_dfllNext[SIM_DFLL_COUNT];
+/*! Time the RTC count was last written or its clock changed, in nanoseconds. */
+static uint64_t SIM_rtcBase;
+/*! RTC clock ticks counted since SIM_rtcBase. */
+static uint64_t SIM_rtcTicks;
+/*! Time the last RTC register written is synchronized, in nanoseconds. */
+static uint64_t SIM_rtcSynced;
+/*! Time the crystal of the battery backup module was started or changed, in
+ *  nanoseconds. */
+static uint64_t SIM_rtc32Base;
+/*! RTC32 clock ticks since SIM_rtc32Base. */
+static uint64_t SIM_rtc32Ticks;
+/*! Time the last RTC32 register written is synchronized, in nanoseconds. */
+static uint64_t SIM_rtc32Synced;
+/*! Time the count requested with SYNCCNT is synchronized, in nanoseconds. */
+static uint64_t SIM_rtc32CntSynced;
+/*! Called at each device reset, see SIM_SetResetHandler(). */
+static void (* SIM_resetHandler)(void);
+/*! Levels applied to the input pins of each port. */
+static uint8_t SIM_portInput[(SIM_PORT_LAST - SIM_PORT_FIRST + 1) / SIM_PORT_SIZE];
+
+/*! Time each vector became pending, SIM_NOT_PENDING if it is not. */
+static uint64_t SIM_pendingSince[_VECTORS_COUNT];
+static SIM_IrqStats_t SIM_irqStats[_VECTORS_COUNT];
+
+static void SIM_Advance(uint32_t cycles);
+static void SIM_Dispatch(void);
+static void SIM_Access(uint16_t offset, bool write);
+static void SIM_EVSYS_Generate(uint8_t source);
+static void SIM_PORT_Update(uint16_t offset);
+static void SIM_DMA_Request(uint8_t trigsrc);
+static void SIM_DMA_NoteRequest(SIM_DMA_CH_t * c);
+static void SIM_RTC_Restart(void);
+
+
+/*! \brief Read a 16-bit register from the I/O memory. */
+static uint16_t SIM_Get16(uint16_t offset)
+{
+	return SIM_io[offset] | (SIM_io[offset + 1] << 8);
+}
+
+
+/*! \brief Write a 16-bit register in the I/O memory. */
+static void SIM_Set16(uint16_t offset, uint16_t value)
+{
+	SIM_io[offset] = (uint8_t) value;
+	SIM_io[offset + 1] = (uint8_t) (value >> 8);
+}
+
+
+/*! \brief Read a 32-bit register from the I/O memory. */
+static uint32_t SIM_Get32(uint16_t offset)
+{
+	return SIM_Get16(offset) | ((uint32_t) SIM_Get16(offset + 2) << 16);
+}
+
+
+/*! \brief Write a 32-bit register in the I/O memory. */
+static void SIM_Set32(uint16_t offset, uint32_t value)
+{
+	SIM_Set16(offset, (uint16_t) value);
+	SIM_Set16(offset + 2, (uint16_t) (value >> 16));
+}
+
+
+/*! \brief Reverse the bit order of a byte, to convert between LSB first
+ *  data and wire order. */
+static uint8_t SIM_BitReverse(uint8_t value)
+{
+	value = (value >> 4) | (value << 4);
+	value = ((value & 0xCC) >> 2) | ((value & 0x33) << 2);
+	return ((value & 0xAA) >> 1) | ((value & 0x55) << 1);
+}
+
+
+/*! \brief Find the simulated USART of a module offset, NULL if none. */
+static SIM_USART_t * SIM_USART_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		if ((offset >= SIM_usart[i].offset) &&
+		    (offset < SIM_usart[i].offset + sizeof(USART_t))) {
+			return &SIM_usart[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Find the simulated USART of a module instance, abort if none. */
+static SIM_USART_t * SIM_USART_Get(USART_t * usart)
+{
+	SIM_USART_t * u = SIM_USART_Find((uint8_t *) usart - SIM_ioSpace);
+
+	if (u == NULL) {
+		fprintf(stderr, "sim: %p is not a simulated USART\n", (void *) usart);
+		abort();
+	}
+	return u;
+}
+
+
+/*! \brief Test if a USART is in master SPI mode. */
+static bool SIM_USART_IsMasterSpi(const SIM_USART_t * u)
+{
+	return (SIM_io[u->offset + SIM_USART_CTRLC] & USART_CMODE_gm) == USART_CMODE_MSPI_gc;
+}
+
+
+/*! \brief Get the number of data bits of a character. */
+static uint8_t SIM_USART_CharSize(const SIM_USART_t * u)
+{
+	uint8_t chsize = SIM_io[u->offset + SIM_USART_CTRLC] & USART_CHSIZE_gm;
+
+	return (chsize == USART_CHSIZE_9BIT_gc) ? 9 : chsize + 5;
+}
+
+
+/*! \brief Get the number of bits of a frame, start and stop bits included. */
+static uint8_t SIM_USART_FrameBits(const SIM_USART_t * u)
+{
+	uint8_t ctrlc = SIM_io[u->offset + SIM_USART_CTRLC];
+	uint8_t bits = 1 + SIM_USART_CharSize(u);
+
+	bits += (ctrlc & USART_PMODE_gm) ? 1 : 0;
+	bits += (ctrlc & USART_SBMODE_bm) ? 2 : 1;
+	return bits;
+}
+
+
+/*! \brief Get the levels of the bits of a frame as sent on the line.
+ *
+ *  Bit 0 of the result is the start bit, followed by the data bits, LSB
+ *  first, the parity bit and the stop bits.
+ */
+static uint16_t SIM_USART_FrameLevels(const SIM_USART_t * u, uint16_t data)
+{
+	uint8_t pmode = SIM_io[u->offset + SIM_USART_CTRLC] & USART_PMODE_gm;
+	uint8_t size = SIM_USART_CharSize(u);
+	uint16_t levels;
+	uint8_t parity;
+
+	data &= (1 << size) - 1;
+	levels = data << 1;
+	parity = __builtin_parity(data);
+	if (pmode == USART_PMODE_EVEN_gc) {
+		levels |= parity << ++size;
+	} else if (pmode == USART_PMODE_ODD_gc) {
+		levels |= (parity ^ 1) << ++size;
+	}
+
+	/* The stop bits and the idle line are high. */
+	return levels | (0xFFFF << (size + 1));
+}
+
+
+/*! \brief Calculate the bit time from the current USART settings.
+ *
+ *  The bit time is taken from the baud rate equations of the data sheet
+ *  with seven fraction bits, for a negative BSCALE as well.
+ *
+ *  \return  Bit time in 1/128 CPU cycles.
+ */
+static uint64_t SIM_USART_BitCycles128(const SIM_USART_t * u)
+{
+	uint8_t ctrlb = SIM_io[u->offset + SIM_USART_CTRLB];
+	uint8_t baudb = SIM_io[u->offset + SIM_USART_BAUDB];
+	uint16_t bsel = ((baudb & USART_BSEL_gm) << 8) | SIM_io[u->offset + SIM_USART_BAUDA];
+	int8_t bscale = (int8_t) (baudb & USART_BSCALE_gm) >> USART_BSCALE_gp;
+	uint64_t divisor = (ctrlb & USART_CLK2X_bm) ? 8 : 16;
+	uint64_t bit128;
+
+	if (bscale >= 0) {
+		bit128 = divisor * ((uint64_t) (bsel + 1) << bscale) * 128;
+	} else {
+		bit128 = divisor * (((uint64_t) bsel << (7 + bscale)) + 128);
+	}
+
+	return bit128;
+}
+
+
+/*! \brief Calculate the frame time from the current USART settings.
+ *
+ *  In master SPI mode a frame is eight bits without start and stop bits,
+ *  at the SCK rate fPER / (2 * (BSEL + 1)); BSCALE and CLK2X are not used.
+ */
+static uint64_t SIM_USART_FrameCycles(const SIM_USART_t * u)
+{
+	if (SIM_USART_IsMasterSpi(u)) {
+		uint16_t bsel = ((SIM_io[u->offset + SIM_USART_BAUDB] & USART_BSEL_gm) << 8) |
+		                SIM_io[u->offset + SIM_USART_BAUDA];
+
+		return 8 * 2 * ((uint64_t) bsel + 1);
+	}
+	return (SIM_USART_FrameBits(u) * SIM_USART_BitCycles128(u) + 64) / 128;
+}
+
+
+/*! \brief Set the level of the RXD pin of a USART.
+ *
+ *  RXD is pin 2 of the port for USARTx0 and pin 6 for USARTx1.
+ */
+static void SIM_USART_SetRxd(const SIM_USART_t * u, bool level)
+{
+	uint16_t port = 0x0640 + ((u->offset - 0x08A0) >> 8) * SIM_PORT_SIZE;
+	uint8_t pin = (u->offset & 0x10) ? PIN6_bm : PIN2_bm;
+	uint8_t * input = &SIM_portInput[(port - SIM_PORT_FIRST) / SIM_PORT_SIZE];
+
+	*input = level ? (*input | pin) : (*input & ~pin);
+	SIM_PORT_Update(port);
+}
+
+
+/*! \brief Start putting a frame on the RXD pin of a USART.
+ *
+ *  The RXD pin only follows the line for the pin change events; the
+ *  character itself is passed to the receiver at the end of the frame.
+ *
+ *  \param levels  Levels of the bits, see SIM_USART_FrameLevels().
+ *  \param bits    Number of bits of the frame.
+ *  \param start   Time of the start bit.
+ *  \param cycles  Frame time.
+ */
+static void SIM_USART_StartRxd(SIM_USART_t * u, uint16_t levels, uint8_t bits,
+                               uint64_t start, uint64_t cycles)
+{
+	u->rxdLevels = levels;
+	u->rxdBits = bits;
+	u->rxdNext = 0;
+	u->rxdStart = start;
+	u->rxdCycles = cycles;
+}
+
+
+/*! \brief Get the time of the next bit to apply to the RXD pin. */
+static uint64_t SIM_USART_RxdNext(const SIM_USART_t * u)
+{
+	return u->rxdStart + u->rxdCycles * u->rxdNext / u->rxdBits;
+}
+
+
+/*! \brief Apply the bits of the frame on the RXD pin that are due.
+ *
+ *  Bits at the level of the bit before them are skipped, so there is one
+ *  simulator event per edge.
+ */
+static void SIM_USART_UpdateRxd(SIM_USART_t * u)
+{
+	while ((u->rxdBits != 0) && (SIM_USART_RxdNext(u) <= SIM_cycles)) {
+		bool level = (u->rxdLevels >> u->rxdNext) & 1;
+
+		SIM_USART_SetRxd(u, level);
+		do {
+			u->rxdNext++;
+		} while ((u->rxdNext < u->rxdBits) &&
+		         (((u->rxdLevels >> u->rxdNext) & 1) == level));
+		if (u->rxdNext == u->rxdBits) {
+			u->rxdBits = 0;
+		}
+	}
+}
+
+
+/*! \brief Pass a character starting on TXD through the transceiver.
+ *
+ *  Without transceiver TXD is the bus. With transceiver the character only
+ *  reaches the bus with DE set, and the first character after DE was set
+ *  gives the setup time and the idle time since the previous frame.
+ *
+ *  \param start  Time of the start bit.
+ *
+ *  \return  True if the character reaches the bus.
+ */
+static bool SIM_USART_DriveBus(SIM_USART_t * u, uint64_t start)
+{
+	SIM_TransceiverStats_t * stats = &u->deStats;
+
+	if (u->dePort == 0) {
+		return true;
+	}
+	if (!u->deHigh) {
+		stats->charsDropped++;
+		return false;
+	}
+	if (u->deFirst) {
+		u->deFirst = false;
+		if (start - u->deSet < stats->setupMin) {
+			stats->setupMin = start - u->deSet;
+		}
+		if ((u->deLastStop != SIM_NOT_PENDING) &&
+		    (start - u->deLastStop < stats->gapMin)) {
+			stats->gapMin = start - u->deLastStop;
+		}
+	}
+	return true;
+}
+
+
+/*! \brief The DE input of a transceiver has changed.
+ *
+ *  Releasing DE while a character is on the bus cuts it off. Otherwise the
+ *  time since the end of the last stop bit is the release latency.
+ */
+static void SIM_USART_DriverEnable(SIM_USART_t * u, bool high)
+{
+	SIM_TransceiverStats_t * stats = &u->deStats;
+
+	if (high) {
+		u->deSet = SIM_cycles;
+		u->deFirst = true;
+		u->deSent = false;
+	} else if (u->txBusy && u->txOnBus) {
+		stats->releasesEarly++;
+	} else if (u->deSent) {
+		uint64_t latency = SIM_cycles - u->deLastStop;
+
+		stats->releases++;
+		stats->releaseTotal += latency;
+		if (latency > stats->releaseMax) {
+			stats->releaseMax = latency;
+		}
+	}
+	u->deHigh = high;
+}
+
+
+/*! \brief The transmitter starts sending its shift register: put the
+ *  frame on the RXD pins of the connected receivers.
+ *
+ *  \param start  Time of the start bit; txDone is the end of the frame.
+ */
+static void SIM_USART_StartShift(SIM_USART_t * u, uint64_t start)
+{
+	uint16_t levels = SIM_USART_FrameLevels(u, u->txShift);
+	uint8_t bits = SIM_USART_FrameBits(u);
+	uint8_t i;
+
+	if (SIM_USART_IsMasterSpi(u)) {
+		/* MOSI is not connected to the RXD pins of other USARTs. */
+		return;
+	}
+	u->txOnBus = SIM_USART_DriveBus(u, start);
+	if (!u->txOnBus) {
+		return;
+	}
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		if (u->connections & (1 << i)) {
+			SIM_USART_StartRxd(&SIM_usart[i], levels, bits, start,
+			                   u->txDone - start);
+		}
+	}
+}
+
+
+/*! \brief Start the first character of the receive line.
+ *
+ *  \param idleFrom  Time the line became idle, the idle time of the
+ *                   character is counted from there.
+ */
+static void SIM_USART_StartLine(SIM_USART_t * u, uint64_t idleFrom)
+{
+	uint16_t data = u->rxLine[u->rxLineHead];
+	uint64_t start = idleFrom + u->rxLineIdle[u->rxLineHead];
+	uint64_t cycles = SIM_USART_FrameCycles(u);
+
+	if (SIM_USART_IsMasterSpi(u)) {
+		/* The bytes on MISO are clocked in by the transmitter. */
+		return;
+	}
+	u->rxLineDone = start + cycles;
+	SIM_USART_StartRxd(u, SIM_USART_FrameLevels(u, data),
+	                   SIM_USART_FrameBits(u), start, cycles);
+}
+
+
+/*! \brief Present the head of the receive FIFO in DATA and RXCIF. */
+static void SIM_USART_UpdateReceiver(SIM_USART_t * u)
+{
+	uint8_t * status = &SIM_io[u->offset + SIM_USART_STATUS];
+	uint16_t data = (u->rxCount != 0) ? u->rxFifo[0] : u->rxLast;
+
+	SIM_io[u->offset + SIM_USART_DATA] = (uint8_t) data;
+	*status &= ~(USART_RXCIF_bm | USART_RXB8_bm | USART_FERR_bm | USART_PERR_bm);
+	if (u->rxCount != 0) {
+		*status |= USART_RXCIF_bm;
+		*status |= (data & SIM_USART_FERR) ? USART_FERR_bm : 0;
+		*status |= (data & SIM_USART_PERR) ? USART_PERR_bm : 0;
+	}
+	if (data & SIM_USART_BIT8) {
+		*status |= USART_RXB8_bm;
+	}
+}
+
+
+/*! \brief Test if a USART uses 9-bit characters. */
+static bool SIM_USART_IsNineBits(const SIM_USART_t * u)
+{
+	return (SIM_io[u->offset + SIM_USART_CTRLC] & USART_CHSIZE_gm) == USART_CHSIZE_9BIT_gc;
+}
+
+
+/*! \brief A character has been received from the line.
+ *
+ *  In multi-processor communication mode, characters with the ninth bit
+ *  cleared are ignored by the receiver. MPCM is modelled for 9-bit
+ *  characters only.
+ */
+static void SIM_USART_Receive(SIM_USART_t * u, uint16_t data)
+{
+	uint8_t ctrlb = SIM_io[u->offset + SIM_USART_CTRLB];
+
+	if (!SIM_USART_IsNineBits(u)) {
+		data &= ~SIM_USART_BIT8;
+	}
+
+	if (!(ctrlb & USART_RXEN_bm)) {
+		u->rxLost++;
+	} else if ((ctrlb & USART_MPCM_bm) && !(data & SIM_USART_BIT8)) {
+		/* Data frame for another node. */
+	} else if (u->rxCount == sizeof(u->rxFifo) / sizeof(u->rxFifo[0])) {
+		SIM_io[u->offset + SIM_USART_STATUS] |= USART_BUFOVF_bm;
+		u->rxLost++;
+	} else {
+		u->rxFifo[u->rxCount++] = data;
+		SIM_USART_UpdateReceiver(u);
+	}
+}
+
+
+/*! \brief DATA has been read: remove the head of the receive FIFO. */
+static void SIM_USART_ReadData(SIM_USART_t * u)
+{
+	if (u->rxCount != 0) {
+		u->rxLast = u->rxFifo[0];
+		u->rxFifo[0] = u->rxFifo[1];
+		u->rxCount--;
+		SIM_io[u->offset + SIM_USART_STATUS] &= ~USART_BUFOVF_bm;
+	}
+	SIM_USART_UpdateReceiver(u);
+}
+
+
+/*! \brief DATA has been written: load the transmitter.
+ *
+ *  The ninth bit is taken from TXB8 when DATA is written.
+ */
+static void SIM_USART_WriteData(SIM_USART_t * u, uint16_t data)
+{
+	if (SIM_USART_IsNineBits(u) &&
+	    (SIM_io[u->offset + SIM_USART_CTRLB] & USART_TXB8_bm)) {
+		data |= SIM_USART_BIT8;
+	}
+
+	if (SIM_io[u->offset + SIM_USART_CTRLB] & USART_TXEN_bm) {
+		if (!u->txBusy) {
+			u->txShift = data;
+			u->txBusy = true;
+			u->txDone = SIM_cycles + SIM_USART_FrameCycles(u);
+			SIM_USART_StartShift(u, SIM_cycles);
+		} else if (!u->txFull) {
+			/* Writes with DREIF cleared are ignored, like on the device. */
+			u->txData = data;
+			u->txFull = true;
+			SIM_io[u->offset + SIM_USART_STATUS] &= ~USART_DREIF_bm;
+		}
+	}
+
+	/* DATA reads back the receive buffer, not the written value. */
+	SIM_USART_UpdateReceiver(u);
+}
+
+
+/*! \brief Exchange the byte of the shift register in master SPI mode.
+ *
+ *  The byte sent on MOSI goes to the transmit line. The byte clocked in on
+ *  MISO at the same time is taken from the receive line, see
+ *  SIM_USART_Inject(), or is the byte sent with loopback; MISO reads high
+ *  when the line is empty. Both lines hold the bytes in wire order, with the
+ *  first bit on the wire in bit 7, as seen by a slave set up for MSB first.
+ *  The clock phase and polarity do not change the timing and are not
+ *  modelled.
+ *
+ *  \return  The byte received, in the data order of the USART.
+ */
+static uint8_t SIM_USART_SpiExchange(SIM_USART_t * u)
+{
+	bool lsbFirst = (SIM_io[u->offset + SIM_USART_CTRLC] & SIM_USART_UDORD) != 0;
+	uint8_t mosi = lsbFirst ? SIM_BitReverse((uint8_t) u->txShift) : (uint8_t) u->txShift;
+	uint8_t miso = 0xFF;
+
+	if (u->txLineCount < SIM_USART_LINE_SIZE) {
+		u->txLine[(u->txLineHead + u->txLineCount) % SIM_USART_LINE_SIZE] = mosi;
+		u->txLineCount++;
+	}
+	if (u->connections & (1 << (u - SIM_usart))) {
+		miso = mosi;
+	} else if (u->rxLineCount != 0) {
+		miso = (uint8_t) u->rxLine[u->rxLineHead];
+		u->rxLineHead = (u->rxLineHead + 1) % SIM_USART_LINE_SIZE;
+		u->rxLineCount--;
+	}
+	return lsbFirst ? SIM_BitReverse(miso) : miso;
+}
+
+
+/*! \brief The shift register has sent its character. */
+static void SIM_USART_TransmitDone(SIM_USART_t * u)
+{
+	uint16_t data = u->txShift;
+	uint64_t start = u->txDone;
+	bool onBus = u->txOnBus;
+	bool spi = SIM_USART_IsMasterSpi(u);
+	uint8_t received = 0;
+	uint8_t i;
+
+	u->shiftCycles += SIM_USART_FrameCycles(u);
+	if (spi) {
+		received = SIM_USART_SpiExchange(u);
+		onBus = false;
+	}
+
+	if (onBus && (u->txLineCount < SIM_USART_LINE_SIZE)) {
+		u->txLine[(u->txLineHead + u->txLineCount) % SIM_USART_LINE_SIZE] = data;
+		u->txLineCount++;
+	}
+	if (onBus) {
+		u->deLastStop = start;
+		u->deSent = true;
+	}
+	u->txCount++;
+
+	if (u->txFull) {
+		u->txShift = u->txData;
+		u->txFull = false;
+		u->txDone += SIM_USART_FrameCycles(u);
+		SIM_USART_StartShift(u, start);
+		SIM_io[u->offset + SIM_USART_STATUS] |= USART_DREIF_bm;
+	} else {
+		u->txBusy = false;
+		SIM_io[u->offset + SIM_USART_STATUS] |= USART_TXCIF_bm;
+	}
+
+	for (i = 0; onBus && (i < SIM_USART_COUNT); i++) {
+		if (u->connections & (1 << i)) {
+			SIM_USART_Receive(&SIM_usart[i], data);
+		}
+	}
+	if (spi) {
+		SIM_USART_Receive(u, received);
+	}
+}
+
+
+/*! \brief Time of the next sample of the frame on the edge trace.
+ *
+ *  Each bit is sampled in its middle, counted from the start edge with the
+ *  bit time of the receiver.
+ */
+static uint64_t SIM_USART_SampleNext(const SIM_USART_t * u)
+{
+	return u->sampleStart +
+	       ((2 * u->sampleCount + 1) * SIM_USART_BitCycles128(u) + 128) / 256;
+}
+
+
+/*! \brief Sample the next bit of the frame on the edge trace.
+ *
+ *  A start bit sampled high is taken as noise. After the first stop bit,
+ *  the character is passed to the receiver with its frame and parity
+ *  errors. Disabling the receiver drops the frame.
+ */
+static void SIM_USART_Sample(SIM_USART_t * u)
+{
+	uint8_t pmode = SIM_io[u->offset + SIM_USART_CTRLC] & USART_PMODE_gm;
+	uint8_t size = SIM_USART_CharSize(u);
+	uint8_t bits = 2 + size + ((pmode != 0) ? 1 : 0);
+	uint16_t data;
+
+	if (!(SIM_io[u->offset + SIM_USART_CTRLB] & USART_RXEN_bm) ||
+	    ((u->sampleCount == 0) && u->edgeLevel)) {
+		u->sampling = false;
+		return;
+	}
+	u->sampleLevels |= (uint16_t) u->edgeLevel << u->sampleCount;
+	if (++u->sampleCount < bits) {
+		return;
+	}
+
+	u->sampling = false;
+	/* The ninth data bit lands on SIM_USART_BIT8. */
+	data = (u->sampleLevels >> 1) & ((1 << size) - 1);
+	if (!((u->sampleLevels >> (bits - 1)) & 1)) {
+		data |= SIM_USART_FERR;
+	}
+	if ((pmode != 0) &&
+	    (__builtin_parity((u->sampleLevels >> 1) & ((2 << size) - 1)) !=
+	     (pmode == USART_PMODE_ODD_gc))) {
+		data |= SIM_USART_PERR;
+	}
+	SIM_USART_Receive(u, data);
+}
+
+
+/*! \brief Apply the edges and take the samples of the edge trace that are due.
+ *
+ *  A sample due at the time of an edge sees the level before the edge.
+ */
+static void SIM_USART_UpdateEdges(SIM_USART_t * u)
+{
+	for (;;) {
+		uint64_t sample = u->sampling ? SIM_USART_SampleNext(u) : UINT64_MAX;
+		uint64_t edge = (u->edgeCount != 0) ? u->edgeTime : UINT64_MAX;
+
+		if ((sample <= edge) && (sample <= SIM_cycles)) {
+			SIM_USART_Sample(u);
+		} else if (edge <= SIM_cycles) {
+			bool level = u->edges->level;
+
+			if (!level && u->edgeLevel && !u->sampling &&
+			    (SIM_io[u->offset + SIM_USART_CTRLB] & USART_RXEN_bm)) {
+				u->sampling = true;
+				u->sampleStart = edge;
+				u->sampleCount = 0;
+				u->sampleLevels = 0;
+			}
+			u->edgeLevel = level;
+			SIM_USART_SetRxd(u, level);
+			u->edges++;
+			if (--u->edgeCount != 0) {
+				u->edgeTime += u->edges->delay;
+			}
+		} else {
+			return;
+		}
+	}
+}
+
+
+/*! \brief The first character of the receive line has arrived. */
+static void SIM_USART_LineDone(SIM_USART_t * u)
+{
+	uint16_t data = u->rxLine[u->rxLineHead];
+
+	u->rxLineHead = (u->rxLineHead + 1) % SIM_USART_LINE_SIZE;
+	u->rxLineCount--;
+	if (u->rxLineCount != 0) {
+		SIM_USART_StartLine(u, u->rxLineDone);
+	}
+	SIM_USART_Receive(u, data);
+}
+
+
+/*! \brief Keep the injected character in real time over a clock change.
+ *
+ *  The sender of the receive line has its own clock, so the remaining time
+ *  of the character in flight is scaled to the new CPU clock. A character
+ *  that has started is sampled with both clocks, and gets a frame error if
+ *  the clock changed by more than SIM_USART_SKEW_PPM.
+ *
+ *  \param oldHz  CPU clock before the change.
+ *  \param newHz  CPU clock after the change.
+ */
+static void SIM_USART_ClockChange(SIM_USART_t * u, uint32_t oldHz, uint32_t newHz)
+{
+	uint64_t change = (newHz > oldHz) ? newHz - oldHz : oldHz - newHz;
+	uint64_t start;
+
+	if ((u->rxLineCount == 0) || SIM_USART_IsMasterSpi(u)) {
+		return;
+	}
+	start = u->rxLineDone - u->rxdCycles;
+	if ((start < SIM_cycles) && (change * 1000000 > (uint64_t) oldHz * SIM_USART_SKEW_PPM)) {
+		u->rxLine[u->rxLineHead] |= SIM_USART_FERR;
+	}
+	u->rxLineDone = SIM_cycles + (u->rxLineDone - SIM_cycles) * newHz / oldHz;
+	u->rxdCycles = u->rxdCycles * newHz / oldHz;
+	u->rxdStart = u->rxLineDone - u->rxdCycles;
+}
+
+
+/*! \brief Apply the side effects of a USART register access. */
+static void SIM_USART_Access(SIM_USART_t * u, uint8_t reg, bool write)
+{
+	uint8_t * status = &SIM_io[u->offset + SIM_USART_STATUS];
+
+	switch (reg) {
+	case SIM_USART_DATA:
+		if (write) {
+			SIM_USART_WriteData(u, SIM_io[u->offset + SIM_USART_DATA]);
+		} else {
+			SIM_USART_ReadData(u);
+		}
+		break;
+	case SIM_USART_STATUS:
+		if (write) {
+			/* Only TXCIF is cleared by writing one; the rest is read-only. */
+			*status = SIM_accessOld & ~(*status & USART_TXCIF_bm);
+		}
+		break;
+	case SIM_USART_CTRLB:
+		if (write && !(SIM_io[u->offset + SIM_USART_CTRLB] & USART_RXEN_bm)) {
+			/* Disabling the receiver flushes the receive buffer. */
+			u->rxCount = 0;
+			*status &= ~USART_BUFOVF_bm;
+			SIM_USART_UpdateReceiver(u);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Find the simulated SPI module of a module offset, NULL if none. */
+static SIM_SPI_t * SIM_SPI_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		if ((offset >= SIM_spi[i].offset) &&
+		    (offset < SIM_spi[i].offset + sizeof(SPI_t))) {
+			return &SIM_spi[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Find the simulated SPI module of a module instance, abort if none. */
+static SIM_SPI_t * SIM_SPI_Get(SPI_t * spi)
+{
+	SIM_SPI_t * s = SIM_SPI_Find((uint8_t *) spi - SIM_ioSpace);
+
+	if (s == NULL) {
+		fprintf(stderr, "sim: %p is not a simulated SPI module\n", (void *) spi);
+		abort();
+	}
+	return s;
+}
+
+
+/*! \brief Calculate the SCK period from the current SPI settings.
+ *
+ *  In slave mode, the SCK period is the one of the external master.
+ */
+static uint32_t SIM_SPI_BitCycles(const SIM_SPI_t * s)
+{
+	uint8_t ctrl = SIM_io[s->offset + SIM_SPI_CTRL];
+	uint32_t division = SIM_spiDivision[ctrl & SPI_PRESCALER_gm];
+
+	if (!(ctrl & SPI_MASTER_bm)) {
+		return s->masterBitCycles;
+	}
+	return (ctrl & SPI_CLK2X_bm) ? division / 2 : division;
+}
+
+
+/*! \brief Test if an SPI module is a selected slave with a byte to be
+ *         clocked in, and no transfer in progress.
+ */
+static bool SIM_SPI_SlavePending(const SIM_SPI_t * s)
+{
+	uint8_t ctrl = SIM_io[s->offset + SIM_SPI_CTRL];
+
+	return (ctrl & SPI_ENABLE_bm) && !(ctrl & SPI_MASTER_bm) && s->selected &&
+	       !s->busy && (s->rxLineCount != 0);
+}
+
+
+/*! \brief Time of the first SCK edge of the next byte in slave mode. */
+static uint64_t SIM_SPI_SlaveLoadTime(const SIM_SPI_t * s)
+{
+	return s->nextStart + s->masterBitCycles / 2;
+}
+
+
+/*! \brief The external master gives the first SCK edge of a byte.
+ *
+ *  The byte in the shift register is sent from here on, so a byte written
+ *  to DATA at this time or later, until the transfer is complete, sets
+ *  WRCOL and is lost.
+ */
+static void SIM_SPI_SlaveLoad(SIM_SPI_t * s)
+{
+	s->busy = true;
+	s->txDone = s->nextStart + 8 * s->masterBitCycles;
+}
+
+
+/*! \brief The SS pin of an SPI module has changed.
+ *
+ *  In slave mode, the external master starts the first byte one SCK period
+ *  after SS goes low, and SS going high aborts the byte being shifted.
+ */
+static void SIM_SPI_SlaveSelect(SIM_SPI_t * s, bool high)
+{
+	uint8_t ctrl = SIM_io[s->offset + SIM_SPI_CTRL];
+
+	s->selected = !high;
+	if ((ctrl & SPI_ENABLE_bm) && !(ctrl & SPI_MASTER_bm)) {
+		if (high) {
+			s->busy = false;
+		} else {
+			s->nextStart = SIM_cycles + s->masterBitCycles;
+		}
+	}
+}
+
+
+/*! \brief DATA has been written: start a transfer in master mode.
+ *
+ *  Writing DATA while a byte is being shifted sets WRCOL and the byte is
+ *  lost, as the transmit direction of the SPI module is not buffered. In
+ *  slave mode, the byte waits in the shift register for the master.
+ */
+static void SIM_SPI_WriteData(SIM_SPI_t * s)
+{
+	uint8_t ctrl = SIM_io[s->offset + SIM_SPI_CTRL];
+
+	if (s->busy) {
+		SIM_io[s->offset + SIM_SPI_STATUS] |= SPI_WRCOL_bm;
+	} else if ((ctrl & SPI_ENABLE_bm) && (ctrl & SPI_MASTER_bm)) {
+		s->busy = true;
+		s->txShift = SIM_io[s->offset + SIM_SPI_DATA];
+		s->txDone = SIM_cycles + 8 * SIM_SPI_BitCycles(s);
+	} else if (ctrl & SPI_ENABLE_bm) {
+		s->txShift = SIM_io[s->offset + SIM_SPI_DATA];
+	}
+
+	/* DATA reads back the last byte received, not the written value. */
+	SIM_io[s->offset + SIM_SPI_DATA] = s->rxData;
+}
+
+
+/*! \brief The byte in the shift register has been exchanged.
+ *
+ *  The byte sent goes to the transmit line, and the byte received is taken
+ *  from the receive line, see SIM_SPI_Inject(); MISO reads high when the
+ *  line is empty. Both lines hold the bytes in wire order, as for a USART
+ *  in master SPI mode. IF is set, and the DMA channels triggered by the
+ *  module get one request each. In slave mode the byte received stays in
+ *  the shift register, and is sent back unless DATA is written before the
+ *  next byte.
+ */
+static void SIM_SPI_TransferDone(SIM_SPI_t * s)
+{
+	uint8_t ctrl = SIM_io[s->offset + SIM_SPI_CTRL];
+	bool lsbFirst = (ctrl & SPI_DORD_bm) != 0;
+	uint8_t out = lsbFirst ? SIM_BitReverse(s->txShift) : s->txShift;
+	uint8_t in = 0xFF;
+
+	s->busy = false;
+	s->shiftCycles += 8 * SIM_SPI_BitCycles(s);
+	if (s->txLineCount < SIM_SPI_LINE_SIZE) {
+		s->txLine[(s->txLineHead + s->txLineCount) % SIM_SPI_LINE_SIZE] = out;
+		s->txLineCount++;
+	}
+	if (s->rxLineCount != 0) {
+		in = s->rxLine[s->rxLineHead];
+		s->rxLineHead = (s->rxLineHead + 1) % SIM_SPI_LINE_SIZE;
+		s->rxLineCount--;
+	}
+
+	s->rxData = lsbFirst ? SIM_BitReverse(in) : in;
+	if (!(ctrl & SPI_MASTER_bm)) {
+		s->txShift = s->rxData;
+		s->nextStart = SIM_cycles + s->masterGapCycles;
+	}
+	SIM_io[s->offset + SIM_SPI_DATA] = s->rxData;
+	SIM_io[s->offset + SIM_SPI_STATUS] |= SPI_IF_bm;
+	SIM_DMA_Request(s->trigsrc);
+}
+
+
+/*! \brief Apply the side effects of an SPI register access.
+ *
+ *  IF and WRCOL are cleared by reading STATUS with IF set and then
+ *  accessing DATA, or, for IF, by taking the interrupt. Disabling the
+ *  module aborts the transfer.
+ */
+static void SIM_SPI_Access(SIM_SPI_t * s, uint8_t reg, bool write)
+{
+	uint8_t * status = &SIM_io[s->offset + SIM_SPI_STATUS];
+
+	switch (reg) {
+	case SIM_SPI_CTRL:
+		if (write && !(SIM_io[s->offset + SIM_SPI_CTRL] & SPI_ENABLE_bm)) {
+			s->busy = false;
+		}
+		break;
+	case SIM_SPI_STATUS:
+		if (write) {
+			/* STATUS is read-only. */
+			*status = SIM_accessOld;
+		} else if (*status & SPI_IF_bm) {
+			s->ifRead = true;
+		}
+		break;
+	case SIM_SPI_DATA:
+		if (s->ifRead) {
+			s->ifRead = false;
+			*status &= ~(SPI_IF_bm | SPI_WRCOL_bm);
+		}
+		if (write) {
+			SIM_SPI_WriteData(s);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Update IN of a port and sense the pin changes.
+ *
+ *  A pin change is passed to the event system as configured by the ISC bits
+ *  of PINnCTRL; level sensing is taken as sensing both edges. PORTA to
+ *  PORTF are event sources, and a sensed change sets the flag of each of
+ *  their two port interrupts that has the pin in its mask. An input pin
+ *  with inverted I/O reads and senses the inverted level of its input; the
+ *  pull configuration is not modelled. A change of a transceiver DE
+ *  pin is passed to its USART, and a change of the SS pin of an SPI module
+ *  to the module.
+ */
+static void SIM_PORT_Update(uint16_t offset)
+{
+	uint8_t * port = &SIM_io[offset & ~(SIM_PORT_SIZE - 1)];
+	uint8_t index = (offset - SIM_PORT_FIRST) / SIM_PORT_SIZE;
+	uint8_t inverted = 0;
+	uint8_t in;
+	uint8_t changed;
+	uint8_t pin;
+	uint8_t i;
+
+	for (pin = 0; pin < 8; pin++) {
+		if (port[SIM_PORT_PIN0CTRL + pin] & PORT_INVEN_bm) {
+			inverted |= 1 << pin;
+		}
+	}
+	in = (port[SIM_PORT_OUT] & port[SIM_PORT_DIR]) |
+	     ((SIM_portInput[index] ^ inverted) & ~port[SIM_PORT_DIR]);
+	changed = port[SIM_PORT_IN] ^ in;
+	port[SIM_PORT_IN] = in;
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		SIM_USART_t * u = &SIM_usart[i];
+
+		if ((u->dePort == (uint16_t) (port - SIM_io)) && (changed & u->deMask)) {
+			SIM_USART_DriverEnable(u, (in & u->deMask) != 0);
+		}
+	}
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		if ((SIM_spi[i].port == (uint16_t) (port - SIM_io)) && (changed & SIM_SPI_SS)) {
+			SIM_SPI_SlaveSelect(&SIM_spi[i], (in & SIM_SPI_SS) != 0);
+		}
+	}
+	for (pin = 0; (index < SIM_PORT_COUNT) && (changed != 0); pin++, changed >>= 1) {
+		uint8_t isc = port[SIM_PORT_PIN0CTRL + pin] & PORT_ISC_gm;
+		bool high = (in >> pin) & 1;
+
+		if ((changed & 1) &&
+		    ((isc == PORT_ISC_BOTHEDGES_gc) || (isc == PORT_ISC_LEVEL_gc) ||
+		     ((isc == PORT_ISC_RISING_gc) && high) ||
+		     ((isc == PORT_ISC_FALLING_gc) && !high))) {
+			SIM_EVSYS_Generate(SIM_EVSYS_PORT_PIN0 + index * 8 + pin);
+			if (port[SIM_PORT_INT0MASK] & (1 << pin)) {
+				port[SIM_PORT_INTFLAGS] |= PORT_INT0IF_bm;
+			}
+			if (port[SIM_PORT_INT1MASK] & (1 << pin)) {
+				port[SIM_PORT_INTFLAGS] |= PORT_INT1IF_bm;
+			}
+		}
+	}
+}
+
+
+/*! \brief Apply the side effects of a PORT register access. */
+static void SIM_PORT_Access(uint16_t offset, bool write)
+{
+	uint8_t * port = &SIM_io[offset & ~(SIM_PORT_SIZE - 1)];
+	uint8_t reg = offset & (SIM_PORT_SIZE - 1);
+	uint8_t value = port[reg];
+
+	if (write) {
+		switch (reg) {
+		case SIM_PORT_DIRSET: port[SIM_PORT_DIR] |= value; break;
+		case SIM_PORT_DIRCLR: port[SIM_PORT_DIR] &= ~value; break;
+		case SIM_PORT_DIRTGL: port[SIM_PORT_DIR] ^= value; break;
+		case SIM_PORT_OUTSET: port[SIM_PORT_OUT] |= value; break;
+		case SIM_PORT_OUTCLR: port[SIM_PORT_OUT] &= ~value; break;
+		case SIM_PORT_OUTTGL: port[SIM_PORT_OUT] ^= value; break;
+		case SIM_PORT_INTFLAGS: port[reg] = SIM_accessOld & ~value; break;
+		default: break;
+		}
+
+		/* With a multi-pin configuration mask, a PINnCTRL write goes to the
+		 * pins in the mask instead, and clears the mask.
+		 */
+		if ((reg >= SIM_PORT_PIN0CTRL) && (reg < SIM_PORT_PIN0CTRL + 8) &&
+		    (SIM_io[SIM_MPCMASK] != 0)) {
+			uint8_t pin;
+
+			port[reg] = SIM_accessOld;
+			for (pin = 0; pin < 8; pin++) {
+				if (SIM_io[SIM_MPCMASK] & (1 << pin)) {
+					port[SIM_PORT_PIN0CTRL + pin] = value;
+				}
+			}
+			SIM_io[SIM_MPCMASK] = 0;
+		}
+	}
+
+	/* The set, clear and toggle registers read back DIR and OUT. */
+	port[SIM_PORT_DIRSET] = port[SIM_PORT_DIR];
+	port[SIM_PORT_DIRCLR] = port[SIM_PORT_DIR];
+	port[SIM_PORT_DIRTGL] = port[SIM_PORT_DIR];
+	port[SIM_PORT_OUTSET] = port[SIM_PORT_OUT];
+	port[SIM_PORT_OUTCLR] = port[SIM_PORT_OUT];
+	port[SIM_PORT_OUTTGL] = port[SIM_PORT_OUT];
+	SIM_PORT_Update(offset);
+}
+
+
+/*! \brief Offset of the PORT register behind a virtual port register.
+ *
+ *  The virtual port registers DIR, OUT, IN and INTFLAGS are at four times
+ *  their offset in the mapped port.
+ */
+static uint16_t SIM_VPORT_Register(uint16_t offset)
+{
+	uint8_t index = (offset - SIM_VPORT_FIRST) / 4;
+	uint8_t map = (SIM_io[SIM_VPCTRLA + index / 2] >> ((index & 1) * 4)) & 0x0F;
+
+	return SIM_PORT_FIRST + map * SIM_PORT_SIZE + (offset & 0x03) * 4;
+}
+
+
+/*! \brief Apply a virtual port register access to the mapped port. */
+static void SIM_VPORT_Access(uint16_t offset, bool write)
+{
+	uint16_t reg = SIM_VPORT_Register(offset);
+
+	if (write && (reg % SIM_PORT_SIZE != SIM_PORT_IN)) {
+		SIM_io[reg] = SIM_io[offset];
+		SIM_PORT_Access(reg, true);
+	}
+	SIM_io[offset] = SIM_io[reg];
+}
+
+
+/*! \brief Find the simulated Analog Comparator of a module offset, NULL if none. */
+static SIM_AC_t * SIM_AC_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_AC_COUNT; i++) {
+		if ((offset >= SIM_ac[i].offset) && (offset < SIM_ac[i].offset + sizeof(AC_t))) {
+			return &SIM_ac[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Find the simulated Analog Comparator of a module instance, abort if none. */
+static SIM_AC_t * SIM_AC_Get(AC_t * ac)
+{
+	SIM_AC_t * a = SIM_AC_Find((uint8_t *) ac - SIM_ioSpace);
+
+	if ((a == NULL) || (a->offset != (uint8_t *) ac - SIM_ioSpace)) {
+		fprintf(stderr, "sim: %p is not a simulated Analog Comparator\n", (void *) ac);
+		abort();
+	}
+	return a;
+}
+
+
+/*! \brief Get the voltage on an input of a comparator, in millivolts.
+ *
+ *  The DAC is not modelled and reads as 0 V.
+ *
+ *  \param a         The Analog Comparator.
+ *  \param comp      Comparator 0 or 1.
+ *  \param positive  True for the positive input.
+ */
+static int16_t SIM_AC_Input(const SIM_AC_t * a, uint8_t comp, bool positive)
+{
+	uint8_t muxctrl = SIM_io[a->offset + SIM_AC_AC0MUXCTRL + comp];
+	uint8_t scalefac = SIM_io[a->offset + SIM_AC_CTRLB] & AC_SCALEFAC_gm;
+
+	if (positive) {
+		uint8_t pos = (muxctrl & AC_MUXPOS_gm) >> AC_MUXPOS_gp;
+
+		return (pos < 7) ? a->input[pos] : 0;
+	}
+	switch (muxctrl & AC_MUXNEG_gm) {
+	case AC_MUXNEG_DAC_gc:
+		return 0;
+	case AC_MUXNEG_BANDGAP_gc:
+		return SIM_AC_BANDGAP_MV;
+	case AC_MUXNEG_SCALER_gc:
+		return (int16_t) ((int32_t) SIM_AC_VCC_MV * (scalefac + 1) / 64);
+	default:
+		return a->input[SIM_acMuxNegPin[muxctrl & AC_MUXNEG_gm]];
+	}
+}
+
+
+/*! \brief Get the hysteresis of a comparator, in millivolts. */
+static int16_t SIM_AC_Hysteresis(uint8_t ctrl)
+{
+	bool highSpeed = (ctrl & AC_HSMODE_bm) != 0;
+
+	switch (ctrl & AC_HYSMODE_gm) {
+	case AC_HYSMODE_SMALL_gc:
+		return highSpeed ? SIM_AC_HYS_SMALL_HS_MV : SIM_AC_HYS_SMALL_LP_MV;
+	case AC_HYSMODE_LARGE_gc:
+		return highSpeed ? SIM_AC_HYS_LARGE_HS_MV : SIM_AC_HYS_LARGE_LP_MV;
+	default:
+		return 0;
+	}
+}
+
+
+/*! \brief Update the comparator outputs from the input voltages.
+ *
+ *  An enabled comparator output goes high when the positive input exceeds
+ *  the negative one by half the hysteresis, and low when it is half the
+ *  hysteresis below it. A disabled comparator output is low. An output
+ *  change selected by the interrupt mode sets the interrupt flag and
+ *  generates an event. In window mode, the signal on the positive inputs is
+ *  above the window when comparator 0 is high, inside when only comparator
+ *  1 is high, and below otherwise; a change of the window state selected by
+ *  the window interrupt mode sets the window flag and generates the window
+ *  event. The propagation delay is not modelled.
+ */
+static void SIM_AC_Update(SIM_AC_t * a)
+{
+	uint8_t * status = &SIM_io[a->offset + SIM_AC_STATUS];
+	uint8_t winctrl = SIM_io[a->offset + SIM_AC_WINCTRL];
+	uint8_t wstate;
+	uint8_t comp;
+
+	for (comp = 0; comp < 2; comp++) {
+		uint8_t ctrl = SIM_io[a->offset + SIM_AC_AC0CTRL + comp];
+		uint8_t stateMask = AC_AC0STATE_bm << comp;
+		bool high = (*status & stateMask) != 0;
+		bool out = false;
+
+		if (ctrl & AC_ENABLE_bm) {
+			int32_t difference = 2 * ((int32_t) SIM_AC_Input(a, comp, true) -
+			                          SIM_AC_Input(a, comp, false));
+			int16_t hysteresis = SIM_AC_Hysteresis(ctrl);
+
+			out = high ? (difference >= -hysteresis) : (difference > hysteresis);
+		}
+		if (out != high) {
+			uint8_t intmode = ctrl & AC_INTMODE_gm;
+
+			*status ^= stateMask;
+			if ((intmode == AC_INTMODE_BOTHEDGES_gc) ||
+			    ((intmode == AC_INTMODE_RISING_gc) && out) ||
+			    ((intmode == AC_INTMODE_FALLING_gc) && !out)) {
+				*status |= AC_AC0IF_bm << comp;
+				SIM_EVSYS_Generate(a->evsys + comp);
+			}
+		}
+	}
+
+	if (!(winctrl & AC_WEN_bm)) {
+		return;
+	}
+	wstate = (*status & AC_AC0STATE_bm) ? AC_WSTATE_ABOVE_gc :
+	         (*status & AC_AC1STATE_bm) ? AC_WSTATE_INSIDE_gc : AC_WSTATE_BELOW_gc;
+	if (wstate != (*status & AC_WSTATE_gm)) {
+		uint8_t wintmode = winctrl & AC_WINTMODE_gm;
+
+		*status = (*status & ~AC_WSTATE_gm) | wstate;
+		if (((wintmode == AC_WINTMODE_ABOVE_gc) && (wstate == AC_WSTATE_ABOVE_gc)) ||
+		    ((wintmode == AC_WINTMODE_INSIDE_gc) && (wstate == AC_WSTATE_INSIDE_gc)) ||
+		    ((wintmode == AC_WINTMODE_BELOW_gc) && (wstate == AC_WSTATE_BELOW_gc)) ||
+		    ((wintmode == AC_WINTMODE_OUTSIDE_gc) && (wstate != AC_WSTATE_INSIDE_gc))) {
+			*status |= AC_WIF_bm;
+			SIM_EVSYS_Generate(a->evsys + 2);
+		}
+	}
+}
+
+
+/*! \brief Apply the side effects of an Analog Comparator register access.
+ *
+ *  The interrupt flags are cleared by writing one, the state bits are read
+ *  only. Any other write can change the comparator outputs.
+ */
+static void SIM_AC_Access(SIM_AC_t * a, uint8_t reg, bool write)
+{
+	uint8_t * status = &SIM_io[a->offset + SIM_AC_STATUS];
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_AC_STATUS) {
+		*status = SIM_accessOld & ~(*status & (AC_WIF_bm | AC_AC1IF_bm | AC_AC0IF_bm));
+	} else {
+		SIM_AC_Update(a);
+	}
+}
+
+
+/*! \brief Time of the next sample of the input traces, UINT64_MAX if none. */
+static uint64_t SIM_AC_NextSample(const SIM_AC_t * a)
+{
+	uint64_t next = UINT64_MAX;
+	uint8_t pin;
+
+	for (pin = 0; pin < SIM_AC_INPUTS; pin++) {
+		if ((a->trace[pin] != NULL) && (a->traceNext[pin] < next)) {
+			next = a->traceNext[pin];
+		}
+	}
+	return next;
+}
+
+
+/*! \brief Apply the trace samples that are due, updating the outputs after each. */
+static void SIM_AC_UpdateTraces(SIM_AC_t * a)
+{
+	uint8_t pin;
+
+	for (pin = 0; pin < SIM_AC_INPUTS; pin++) {
+		while ((a->trace[pin] != NULL) && (a->traceNext[pin] <= SIM_cycles)) {
+			a->input[pin] = a->trace[pin][a->traceIndex[pin]++];
+			a->traceNext[pin] += a->traceCycles[pin];
+			if (a->traceIndex[pin] == a->traceCount[pin]) {
+				a->traceIndex[pin] = 0;
+				if (!a->traceRepeat[pin]) {
+					/* The last sample holds. */
+					a->trace[pin] = NULL;
+				}
+			}
+			SIM_AC_Update(a);
+		}
+	}
+}
+
+
+/*! \brief Find the simulated Timer/Counter of a module offset, NULL if none. */
+static SIM_TC_t * SIM_TC_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		if ((offset >= SIM_tc[i].offset) &&
+		    (offset < SIM_tc[i].offset + sizeof(TC0_t))) {
+			return &SIM_tc[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Find the Timer/Counter of an AWeX register offset, NULL if none. */
+static SIM_TC_t * SIM_AWEX_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_TC_COUNT; i += 2) {
+		if ((offset >= SIM_tc[i].offset + SIM_AWEX_OFFSET) &&
+		    (offset < SIM_tc[i].offset + SIM_AWEX_OFFSET + sizeof(AWEX_t))) {
+			return &SIM_tc[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Get the clock division of a Timer/Counter, zero if not counting.
+ *
+ *  The event clocks are not modelled; the counter stands still with them.
+ */
+static uint16_t SIM_TC_Division(const SIM_TC_t * t)
+{
+	return SIM_tcDivision[SIM_io[t->offset + SIM_TC_CTRLA] & TC0_CLKSEL_gm];
+}
+
+
+/*! \brief Get the counter steps per clock tick of a Timer/Counter.
+ *
+ *  With the HiRes extension enabled for Timer/Counter 0 of the port, the
+ *  counter ignores its two least significant bits and steps by four.
+ */
+static uint8_t SIM_TC_Resolution(const SIM_TC_t * t)
+{
+	return (SIM_io[t->offset + SIM_HIRES_OFFSET] & HIRES_HREN_TC0_gc) ? 4 : 1;
+}
+
+
+/*! \brief Test if a Timer/Counter counts in one of the dual-slope modes. */
+static bool SIM_TC_IsDualSlope(const SIM_TC_t * t)
+{
+	return (SIM_io[t->offset + SIM_TC_CTRLB] & TC0_WGMODE_gm) >= TC_WGMODE_DS_T_gc;
+}
+
+
+/*! \brief Test if a Timer/Counter has an AWeX, which only ports C and E have. */
+static bool SIM_TC_HasAwex(const SIM_TC_t * t)
+{
+	return (t == &SIM_tc[0]) || (t == &SIM_tc[2]);
+}
+
+
+/*! \brief Test if a compare or capture channel captures.
+ *
+ *  \param channel  0 to 3 for channel A to D.
+ */
+static bool SIM_TC_IsCapture(const SIM_TC_t * t, uint8_t channel)
+{
+	const uint8_t * tc = &SIM_io[t->offset];
+
+	return ((tc[SIM_TC_CTRLD] & TC0_EVACT_gm) == TC_EVACT_CAPT_gc) &&
+	       (tc[SIM_TC_CTRLB] & (TC0_CCAEN_bm << channel));
+}
+
+
+/*! \brief Get the number of ticks until the counter reaches a value.
+ *
+ *  \return  1 to PER + 1, or 0 if the value is above PER.
+ */
+static uint32_t SIM_TC_Distance(uint16_t count, uint16_t value, uint16_t per)
+{
+	uint32_t period = (uint32_t) per + 1;
+	uint32_t distance = (value + period - count) % period;
+
+	if (value > per) {
+		return 0;
+	}
+	return (distance != 0) ? distance : period;
+}
+
+
+/*! \brief Get the number of ticks until a dual-slope counter turns.
+ *
+ *  \return  1 to PER, counting to TOP or BOTTOM, or 0 if PER is zero.
+ */
+static uint32_t SIM_TC_DualDistance(const SIM_TC_t * t)
+{
+	uint16_t per = SIM_Get16(t->offset + SIM_TC_PER);
+	uint16_t count = SIM_Get16(t->offset + SIM_TC_CNT);
+	uint32_t distance;
+
+	if (count > per) {
+		count = per;
+	}
+	distance = (SIM_io[t->offset + SIM_TC_CTRLFSET] & TC0_DIR_bm) ? count : per - count;
+
+	/* A counter already at the end it runs to turns at once, see SIM_TC_CountDual(). */
+	return (distance != 0) ? distance : per;
+}
+
+
+/*! \brief Copy the valid buffer registers, the update condition.
+ *
+ *  PER and CCA to CCD are loaded from their buffers where the buffer valid
+ *  bit is set, and the bits are cleared. The dead-time buffers of the AWeX
+ *  belonging to the Timer/Counter are copied at the same time. Nothing is
+ *  copied at the update condition while the lock update bit is set, unlike
+ *  the update command.
+ *
+ *  \param command  true for the update command, false for the condition.
+ */
+static void SIM_TC_Update(SIM_TC_t * t, bool command)
+{
+	uint8_t * tc = &SIM_io[t->offset];
+	uint8_t i;
+
+	if (!command && (tc[SIM_TC_CTRLFSET] & TC0_LUPD_bm)) {
+		return;
+	}
+
+	for (i = 0; i < SIM_TC_BUFFERS; i++) {
+		if (tc[SIM_TC_CTRLGSET] & (TC0_PERBV_bm << i)) {
+			SIM_Set16(t->offset + SIM_TC_PER + 2 * i,
+			          SIM_Get16(t->offset + SIM_TC_PERBUF + 2 * i));
+		}
+	}
+	tc[SIM_TC_CTRLGCLR] = 0;
+	tc[SIM_TC_CTRLGSET] = 0;
+
+	if (SIM_TC_HasAwex(t)) {
+		uint8_t * awex = &SIM_io[t->offset + SIM_AWEX_OFFSET];
+
+		if (awex[SIM_AWEX_STATUS] & AWEX_DTLSBUFV_bm) {
+			awex[SIM_AWEX_DTLS] = awex[SIM_AWEX_DTLSBUF];
+		}
+		if (awex[SIM_AWEX_STATUS] & AWEX_DTHSBUFV_bm) {
+			awex[SIM_AWEX_DTHS] = awex[SIM_AWEX_DTHSBUF];
+		}
+		awex[SIM_AWEX_STATUS] &= ~(AWEX_DTLSBUFV_bm | AWEX_DTHSBUFV_bm);
+	}
+}
+
+
+/*! \brief Set the flags of a Timer/Counter and generate their events.
+ *
+ *  The overflow also requests a transfer on the DMA channels it triggers.
+ */
+static void SIM_TC_Signal(SIM_TC_t * t, uint8_t flags)
+{
+	uint8_t source = SIM_EVSYS_TC_OVF + (t - SIM_tc) * 0x10;
+	uint8_t i;
+
+	SIM_io[t->offset + SIM_TC_INTFLAGS] |= flags;
+
+	if (flags & TC0_OVFIF_bm) {
+		SIM_EVSYS_Generate(source);
+		SIM_DMA_Request(SIM_DMA_TRIGSRC_TC_OVF + (t - SIM_tc) * 0x20);
+	}
+	for (i = 0; i < 4; i++) {
+		if (flags & (TC0_CCAIF_bm << i)) {
+			SIM_EVSYS_Generate(source + 4 + i);
+		}
+	}
+}
+
+
+/*! \brief Count clock ticks, setting the flags and generating the events
+ *  of the compare matches and the overflows on the way.
+ *
+ *  Only counting up in normal mode is modelled here, the single-slope mode
+ *  counts the same way. Each flag and event is set once even if the ticks
+ *  span several periods, and the buffers are copied at the overflow.
+ */
+static void SIM_TC_Count(SIM_TC_t * t, uint64_t ticks)
+{
+	uint16_t per = SIM_Get16(t->offset + SIM_TC_PER);
+	uint32_t period = (uint32_t) per + 1;
+	uint16_t count = SIM_Get16(t->offset + SIM_TC_CNT) % period;
+	uint8_t flags = 0;
+	uint8_t i;
+
+	for (i = 0; i < 4; i++) {
+		uint32_t distance = SIM_TC_Distance(count,
+			SIM_Get16(t->offset + SIM_TC_CCA + 2 * i), per);
+
+		if (!SIM_TC_IsCapture(t, i) && (distance != 0) && (distance <= ticks)) {
+			flags |= TC0_CCAIF_bm << i;
+		}
+	}
+	if (period - count <= ticks) {
+		flags |= TC0_OVFIF_bm;
+	}
+
+	SIM_Set16(t->offset + SIM_TC_CNT, (count + ticks) % period);
+	if (flags & TC0_OVFIF_bm) {
+		SIM_TC_Update(t, false);
+	}
+	SIM_TC_Signal(t, flags);
+}
+
+
+/*! \brief Count clock ticks in one of the dual-slope modes.
+ *
+ *  The counter runs from BOTTOM up to TOP (PER) and down again, keeping the
+ *  direction in the DIR bit of CTRLF. The overflow flag is set at TOP in
+ *  DS_T mode, at BOTTOM in DS_B mode and at both in DS_TB mode; the buffers
+ *  are copied at BOTTOM in DS_B mode and at TOP otherwise. The compare
+ *  match flags are not modelled in these modes, and the counter stands
+ *  still while PER is zero.
+ */
+static void SIM_TC_CountDual(SIM_TC_t * t, uint64_t ticks)
+{
+	uint8_t * tc = &SIM_io[t->offset];
+	uint8_t mode = tc[SIM_TC_CTRLB] & TC0_WGMODE_gm;
+	uint8_t flags = 0;
+
+	while (ticks != 0) {
+		uint16_t per = SIM_Get16(t->offset + SIM_TC_PER);
+		uint16_t count = SIM_Get16(t->offset + SIM_TC_CNT);
+		bool down = (tc[SIM_TC_CTRLFSET] & TC0_DIR_bm) != 0;
+		uint32_t distance;
+
+		if (per == 0) {
+			break;
+		}
+		if (count > per) {
+			count = per;
+		}
+		distance = down ? count : per - count;
+
+		if (distance > ticks) {
+			SIM_Set16(t->offset + SIM_TC_CNT, down ? count - ticks : count + ticks);
+			break;
+		}
+		ticks -= distance;
+		SIM_Set16(t->offset + SIM_TC_CNT, down ? 0 : per);
+		tc[SIM_TC_CTRLFCLR] ^= TC0_DIR_bm;
+		tc[SIM_TC_CTRLFSET] ^= TC0_DIR_bm;
+
+		/* A counter set to the end it runs to just turns. */
+		if (distance == 0) {
+			continue;
+		}
+		if (down) {
+			if (mode != TC_WGMODE_DS_T_gc) {
+				flags |= TC0_OVFIF_bm;
+			}
+			if (mode == TC_WGMODE_DS_B_gc) {
+				SIM_TC_Update(t, false);
+			}
+		} else if (mode != TC_WGMODE_DS_B_gc) {
+			flags |= TC0_OVFIF_bm;
+			SIM_TC_Update(t, false);
+		}
+	}
+
+	SIM_TC_Signal(t, flags);
+}
+
+
+/*! \brief Bring CNT of a Timer/Counter up to date. */
+static void SIM_TC_Sync(SIM_TC_t * t)
+{
+	uint16_t division = SIM_TC_Division(t);
+	uint64_t ticks;
+
+	if (division == 0) {
+		t->lastTick = SIM_cycles;
+		return;
+	}
+	ticks = (SIM_cycles - t->lastTick) / division;
+	if (ticks != 0) {
+		t->lastTick += ticks * division;
+		if (SIM_TC_IsDualSlope(t)) {
+			SIM_TC_CountDual(t, ticks * SIM_TC_Resolution(t));
+		} else {
+			SIM_TC_Count(t, ticks * SIM_TC_Resolution(t));
+		}
+	}
+}
+
+
+/*! \brief Time of the next compare match, overflow or turn of the
+ *  counter, UINT64_MAX if none.
+ */
+static uint64_t SIM_TC_NextEvent(const SIM_TC_t * t)
+{
+	uint16_t division = SIM_TC_Division(t);
+	uint8_t resolution = SIM_TC_Resolution(t);
+	uint16_t per = SIM_Get16(t->offset + SIM_TC_PER);
+	uint32_t period = (uint32_t) per + 1;
+	uint16_t count = SIM_Get16(t->offset + SIM_TC_CNT) % period;
+	uint32_t next = period - count;
+	uint8_t i;
+
+	if (division == 0) {
+		return UINT64_MAX;
+	}
+	if (SIM_TC_IsDualSlope(t)) {
+		next = SIM_TC_DualDistance(t);
+		if (next == 0) {
+			return UINT64_MAX;
+		}
+	} else {
+		for (i = 0; i < 4; i++) {
+			uint32_t distance = SIM_TC_Distance(count,
+				SIM_Get16(t->offset + SIM_TC_CCA + 2 * i), per);
+
+			if (!SIM_TC_IsCapture(t, i) && (distance != 0) && (distance < next)) {
+				next = distance;
+			}
+		}
+	}
+	return t->lastTick + (uint64_t) ((next + resolution - 1) / resolution) * division;
+}
+
+
+/*! \brief Get the level of the port pin selected by an event channel.
+ *
+ *  \return  0 or 1, or -1 if the channel does not select a port pin.
+ */
+static int8_t SIM_EVSYS_PinLevel(uint8_t channel)
+{
+	uint8_t source = SIM_io[SIM_EVSYS_OFFSET + channel] - SIM_EVSYS_PORT_PIN0;
+
+	if (source >= SIM_PORT_COUNT * 8) {
+		return -1;
+	}
+	return (SIM_io[SIM_PORT_FIRST + (source / 8) * SIM_PORT_SIZE + SIM_PORT_IN] >>
+	        (source % 8)) & 1;
+}
+
+
+/*! \brief An event has arrived on an event channel.
+ *
+ *  The restart and input capture event actions are modelled. A capture
+ *  into a channel with its flag still set is not flagged as an error. With
+ *  PER below 0x8000, a capture of a port pin event stores the pin level in
+ *  bit 15.
+ */
+static void SIM_TC_Event(SIM_TC_t * t, uint8_t channel)
+{
+	uint8_t * tc = &SIM_io[t->offset];
+	uint8_t evsel = tc[SIM_TC_CTRLD] & TC0_EVSEL_gm;
+	uint8_t first = evsel - TC_EVSEL_CH0_gc;
+
+	if ((evsel < TC_EVSEL_CH0_gc) || (channel < first)) {
+		return;
+	}
+
+	switch (tc[SIM_TC_CTRLD] & TC0_EVACT_gm) {
+	case TC_EVACT_RESTART_gc:
+		if (channel == first) {
+			SIM_TC_Sync(t);
+			SIM_Set16(t->offset + SIM_TC_CNT, 0);
+		}
+		break;
+	case TC_EVACT_CAPT_gc:
+		/* The channel selected captures into CCA, the next ones into CCB to CCD. */
+		if ((channel - first < 4) && SIM_TC_IsCapture(t, channel - first)) {
+			uint16_t capture;
+			int8_t level = SIM_EVSYS_PinLevel(channel);
+
+			SIM_TC_Sync(t);
+			capture = SIM_Get16(t->offset + SIM_TC_CNT);
+			if ((level >= 0) && (SIM_Get16(t->offset + SIM_TC_PER) < 0x8000)) {
+				capture = (capture & 0x7FFF) | ((uint16_t) level << 15);
+			}
+			SIM_Set16(t->offset + SIM_TC_CCA + 2 * (channel - first), capture);
+			tc[SIM_TC_INTFLAGS] |= TC0_CCAIF_bm << (channel - first);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Apply the side effects of a Timer/Counter register access.
+ *
+ *  The commands of CTRLF are executed at once. Writing a buffer register
+ *  sets its buffer valid bit in CTRLG.
+ */
+static void SIM_TC_Access(SIM_TC_t * t, uint8_t reg, bool write)
+{
+	uint8_t * tc = &SIM_io[t->offset];
+	uint8_t value;
+
+	if (!write) {
+		/* Reading a capture register clears its flag. */
+		if ((reg >= SIM_TC_CCA) && (reg < SIM_TC_CCA + 8) &&
+		    SIM_TC_IsCapture(t, (reg - SIM_TC_CCA) / 2)) {
+			tc[SIM_TC_INTFLAGS] &= ~(TC0_CCAIF_bm << ((reg - SIM_TC_CCA) / 2));
+		}
+		return;
+	}
+
+	if ((reg >= SIM_TC_PERBUF) && (reg < SIM_TC_PERBUF + 2 * SIM_TC_BUFFERS)) {
+		tc[SIM_TC_CTRLGCLR] |= TC0_PERBV_bm << ((reg - SIM_TC_PERBUF) / 2);
+		tc[SIM_TC_CTRLGSET] = tc[SIM_TC_CTRLGCLR];
+		return;
+	}
+
+	switch (reg) {
+	case SIM_TC_CTRLA:
+		/* The prescaler starts from the clock change. */
+		t->lastTick = SIM_cycles;
+		break;
+	case SIM_TC_CTRLFCLR:
+	case SIM_TC_CTRLFSET:
+		/* The clear and set registers share one value. */
+		value = (reg == SIM_TC_CTRLFSET) ? (SIM_accessOld | tc[reg]) :
+		                                   (SIM_accessOld & ~tc[reg]);
+		if ((value & TC0_CMD_gm) == TC_CMD_UPDATE_gc) {
+			SIM_TC_Update(t, true);
+		} else if ((value & TC0_CMD_gm) == TC_CMD_RESTART_gc) {
+			SIM_Set16(t->offset + SIM_TC_CNT, 0);
+			value &= ~TC0_DIR_bm;
+		} else if (((value & TC0_CMD_gm) == TC_CMD_RESET_gc) &&
+		           ((tc[SIM_TC_CTRLA] & TC0_CLKSEL_gm) == TC_CLKSEL_OFF_gc)) {
+			memset(tc, 0, sizeof(TC0_t));
+			SIM_Set16(t->offset + SIM_TC_PER, 0xFFFF);
+			value = 0;
+		}
+		tc[SIM_TC_CTRLFCLR] = value & ~TC0_CMD_gm;
+		tc[SIM_TC_CTRLFSET] = value & ~TC0_CMD_gm;
+		break;
+	case SIM_TC_CTRLGCLR:
+	case SIM_TC_CTRLGSET:
+		value = (reg == SIM_TC_CTRLGSET) ? (SIM_accessOld | tc[reg]) :
+		                                   (SIM_accessOld & ~tc[reg]);
+		tc[SIM_TC_CTRLGCLR] = value;
+		tc[SIM_TC_CTRLGSET] = value;
+		break;
+	case SIM_TC_INTFLAGS:
+		/* The flags are cleared by writing one. */
+		tc[reg] = SIM_accessOld & ~tc[reg];
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Apply the side effects of an AWeX register access.
+ *
+ *  Only the dead-time registers are modelled: DTBOTH and DTBOTHBUF write
+ *  both sides, writing a buffer sets its valid flag, and the buffers are
+ *  copied on the update condition of the Timer/Counter, see SIM_TC_Update().
+ *  The fault flag is cleared by writing one, and set by the fault detection,
+ *  see SIM_AWEX_Event(). The waveform outputs are not generated.
+ *
+ *  \param t    The Timer/Counter the AWeX belongs to.
+ *  \param reg  Register offset in the AWeX.
+ */
+static void SIM_AWEX_Access(SIM_TC_t * t, uint8_t reg, bool write)
+{
+	uint8_t * awex = &SIM_io[t->offset + SIM_AWEX_OFFSET];
+
+	if (!write) {
+		return;
+	}
+
+	switch (reg) {
+	case SIM_AWEX_DTBOTH:
+		awex[SIM_AWEX_DTLS] = awex[reg];
+		awex[SIM_AWEX_DTHS] = awex[reg];
+		break;
+	case SIM_AWEX_DTBOTHBUF:
+		awex[SIM_AWEX_DTLSBUF] = awex[reg];
+		awex[SIM_AWEX_DTHSBUF] = awex[reg];
+		awex[SIM_AWEX_STATUS] |= AWEX_DTLSBUFV_bm | AWEX_DTHSBUFV_bm;
+		break;
+	case SIM_AWEX_DTLSBUF:
+		awex[SIM_AWEX_STATUS] |= AWEX_DTLSBUFV_bm;
+		break;
+	case SIM_AWEX_DTHSBUF:
+		awex[SIM_AWEX_STATUS] |= AWEX_DTHSBUFV_bm;
+		break;
+	case SIM_AWEX_STATUS:
+		awex[reg] = SIM_accessOld & ~(awex[reg] & AWEX_FDF_bm);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief An event has arrived on an event channel: detect a fault.
+ *
+ *  An event on a channel in FDEVMASK sets the fault flag and performs the
+ *  fault action at once: clearing OUTOVEN, or clearing the DIR bits of the
+ *  pins in OUTOVEN. The fault detection mode is taken as latched.
+ *
+ *  \param t  The Timer/Counter the AWeX belongs to.
+ */
+static void SIM_AWEX_Event(SIM_TC_t * t, uint8_t channel)
+{
+	uint8_t * awex = &SIM_io[t->offset + SIM_AWEX_OFFSET];
+	/* The AWeX of TCC0 drives PORTC, the one of TCE0 drives PORTE. */
+	uint16_t port = 0x0640 + ((t->offset - 0x0800) >> 8) * SIM_PORT_SIZE;
+
+	if (!(awex[SIM_AWEX_FDEVMASK] & (1 << channel))) {
+		return;
+	}
+	awex[SIM_AWEX_STATUS] |= AWEX_FDF_bm;
+	switch (awex[SIM_AWEX_FDCTRL] & AWEX_FDACT_gm) {
+	case AWEX_FDACT_CLEAROE_gc:
+		awex[SIM_AWEX_OUTOVEN] = 0;
+		break;
+	case AWEX_FDACT_CLEARDIR_gc:
+		SIM_io[port + SIM_PORT_DIR] &= ~awex[SIM_AWEX_OUTOVEN];
+		SIM_PORT_Update(port);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Pass an event on an event channel to the modules using it.
+ *
+ *  The Timer/Counter event actions, the AWeX fault detection and the DMA
+ *  triggers are modelled.
+ */
+static void SIM_EVSYS_Channel(uint8_t channel)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		SIM_TC_Event(&SIM_tc[i], channel);
+	}
+	for (i = 0; i < SIM_TC_COUNT; i += 2) {
+		SIM_AWEX_Event(&SIM_tc[i], channel);
+	}
+	for (i = 0; (i < SIM_DMA_CH_COUNT) && (channel < 3); i++) {
+		const uint8_t * ch = &SIM_io[SIM_dma[i].offset];
+
+		if ((ch[SIM_DMA_CTRLA] & DMA_CH_ENABLE_bm) &&
+		    (ch[SIM_DMA_TRIGSRC] == DMA_CH_TRIGSRC_EVSYS_CH0_gc + channel)) {
+			SIM_DMA_NoteRequest(&SIM_dma[i]);
+		}
+	}
+}
+
+
+/*! \brief An event source has fired: pass it to the channels selecting it.
+ *
+ *  \param source  Multiplexer input of the source, see EVSYS_CHMUX_t.
+ */
+static void SIM_EVSYS_Generate(uint8_t source)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_EVSYS_CH_COUNT; i++) {
+		if (SIM_io[SIM_EVSYS_OFFSET + i] == source) {
+			SIM_EVSYS_Channel(i);
+		}
+	}
+}
+
+
+/*! \brief Apply the side effects of an EVSYS register access.
+ *
+ *  Writing STROBE generates a manual event on the channels given. The
+ *  digital filters and the quadrature decoder are not modelled.
+ */
+static void SIM_EVSYS_Access(uint16_t offset, bool write)
+{
+	uint8_t * strobe = &SIM_io[SIM_EVSYS_OFFSET + SIM_EVSYS_STROBE];
+	uint8_t i;
+
+	if (write && (offset == SIM_EVSYS_OFFSET + SIM_EVSYS_STROBE)) {
+		for (i = 0; i < SIM_EVSYS_CH_COUNT; i++) {
+			if (*strobe & (1 << i)) {
+				SIM_EVSYS_Channel(i);
+			}
+		}
+		*strobe = 0;
+	}
+}
+
+
+/*! \brief A CCP signature for the I/O registers was written within the last
+ *         SIM_CCP_CYCLES. */
+static bool SIM_CCP_IsOpen(void)
+{
+	return (SIM_ccpTime != SIM_NOT_PENDING) && (SIM_cycles - SIM_ccpTime <= SIM_CCP_CYCLES);
+}
+
+
+/*! \brief Convert CPU cycles to nanoseconds at the current clock frequency. */
+static uint64_t SIM_CLK_CyclesToNs(uint64_t cycles)
+{
+	return (cycles / SIM_cpuHz) * 1000000000ULL +
+	       (cycles % SIM_cpuHz) * 1000000000ULL / SIM_cpuHz;
+}
+
+
+/*! \brief Convert a time in nanoseconds to the first CPU cycle at or after it.
+ *
+ *  \param ns  Time, UINT64_MAX for never.
+ */
+static uint64_t SIM_CLK_NsToCycles(uint64_t ns)
+{
+	uint64_t delta;
+
+	if (ns == UINT64_MAX) {
+		return UINT64_MAX;
+	}
+	if (ns <= SIM_GetNanoseconds()) {
+		return SIM_cycles;
+	}
+	delta = ns - SIM_nsBase;
+	return SIM_nsCycles + (delta / 1000000000ULL) * SIM_cpuHz +
+	       ((delta % 1000000000ULL) * SIM_cpuHz + 999999999ULL) / 1000000000ULL;
+}
+
+
+/*! \brief Frequency of an oscillator with its drift and DFLL correction.
+ *
+ *  \param osc        Bit number of the oscillator in OSC.CTRL.
+ *  \param nominalHz  Nominal frequency in Hz, or mHz.
+ */
+static uint32_t SIM_OSC_Hz(uint8_t osc, uint32_t nominalHz)
+{
+	int64_t error = (int64_t) SIM_oscDrift[osc] + SIM_oscCorrection[osc];
+
+	return (uint32_t) ((int64_t) nominalHz + (int64_t) nominalHz * error / 1000000);
+}
+
+
+/*! \brief Start-up time of an oscillator in nanoseconds, zero if it never
+ *         becomes ready.
+ *
+ *  The crystal oscillator only starts with the 32.768 kHz crystal setting.
+ */
+static uint32_t SIM_OSC_StartupNs(uint8_t osc)
+{
+	uint8_t xoscsel = SIM_io[SIM_OSC_OFFSET + SIM_OSC_XOSCCTRL] & OSC_XOSCSEL_gm;
+
+	if (osc == 3) {
+		return (xoscsel == OSC_XOSCSEL_32KHz_gc) ? SIM_TOSC_STARTUP_NS : 0;
+	}
+	return SIM_oscStartupNs[osc];
+}
+
+
+/*! \brief Test if an oscillator is enabled and has started up.
+ *
+ *  \param osc  Bit number of the oscillator in OSC.CTRL.
+ */
+static bool SIM_OSC_IsRunning(uint8_t osc)
+{
+	return (SIM_io[SIM_OSC_OFFSET + SIM_OSC_CTRL] & (1 << osc)) &&
+	       (SIM_oscReady[osc] <= SIM_GetNanoseconds());
+}
+
+
+/*! \brief Frequency of a system clock source, 0 if it is not available.
+ *
+ *  \param sclksel  CLK.CTRL system clock selection.
+ */
+static uint32_t SIM_CLK_SourceHz(uint8_t sclksel)
+{
+	uint8_t pllctrl = SIM_io[SIM_OSC_OFFSET + SIM_OSC_PLLCTRL];
+	uint32_t referenceHz;
+
+	switch (sclksel & CLK_SCLKSEL_gm) {
+	case CLK_SCLKSEL_RC2M_gc:
+		return SIM_OSC_Hz(0, SIM_RC2M_HZ);
+	case CLK_SCLKSEL_RC32M_gc:
+		return SIM_OSC_Hz(1, SIM_RC32M_HZ);
+	case CLK_SCLKSEL_RC32K_gc:
+		return SIM_OSC_Hz(2, SIM_RC32K_HZ);
+	case CLK_SCLKSEL_XOSC_gc:
+		/* Only the 32.768 kHz crystal is fitted. */
+		if ((SIM_io[SIM_OSC_OFFSET + SIM_OSC_XOSCCTRL] & OSC_XOSCSEL_gm) !=
+		    OSC_XOSCSEL_32KHz_gc) {
+			return 0;
+		}
+		return SIM_OSC_Hz(3, SIM_TOSC_HZ);
+	case CLK_SCLKSEL_PLL_gc:
+		if ((pllctrl & OSC_PLLSRC_gm) == OSC_PLLSRC_RC2M_gc) {
+			referenceHz = SIM_OSC_Hz(0, SIM_RC2M_HZ);
+		} else if ((pllctrl & OSC_PLLSRC_gm) == OSC_PLLSRC_RC32M_gc) {
+			/* The 32 MHz oscillator is divided by four for the PLL. */
+			referenceHz = SIM_OSC_Hz(1, SIM_RC32M_HZ) / 4;
+		} else {
+			/* The crystal is too slow for the PLL. */
+			referenceHz = 0;
+		}
+		return referenceHz * ((pllctrl & OSC_PLLFAC_gm) >> OSC_PLLFAC_gp);
+	default:
+		return 0;
+	}
+}
+
+
+/*! \brief Set the CPU frequency from the clock registers.
+ *
+ *  The nanosecond clock is brought up to date at the old frequency first.
+ */
+static void SIM_CLK_Update(void)
+{
+	uint8_t psctrl = SIM_io[SIM_CLK_OFFSET + SIM_CLK_PSCTRL];
+	uint8_t psadiv = (psctrl & CLK_PSADIV_gm) >> CLK_PSADIV_gp;
+	uint32_t division = (psadiv == 0) ? 1 : (1UL << ((psadiv + 1) / 2));
+	uint32_t oldHz = SIM_cpuHz;
+	uint8_t i;
+
+	SIM_nsBase += SIM_CLK_CyclesToNs(SIM_cycles - SIM_nsCycles);
+	SIM_nsCycles = SIM_cycles;
+	division *= SIM_clkBcDivision[psctrl & CLK_PSBCDIV_gm];
+	SIM_cpuHz = SIM_CLK_SourceHz(SIM_io[SIM_CLK_OFFSET + SIM_CLK_CTRL]) / division;
+	if (SIM_cpuHz != oldHz) {
+		for (i = 0; i < SIM_USART_COUNT; i++) {
+			SIM_USART_ClockChange(&SIM_usart[i], oldHz, SIM_cpuHz);
+		}
+	}
+}
+
+
+/*! \brief Apply a write to the Clock System.
+ *
+ *  CTRL, PSCTRL and LOCK only change when written within SIM_CCP_CYCLES of
+ *  the CCP signature and while the configuration is not locked, as on the
+ *  device. A clock source that is not ready is not selected. The RTC
+ *  restarts counting when RTCCTRL is written.
+ */
+static void SIM_CLK_Access(uint8_t reg, bool write)
+{
+	uint8_t * clk = &SIM_io[SIM_CLK_OFFSET];
+	uint8_t sclksel = clk[SIM_CLK_CTRL] & CLK_SCLKSEL_gm;
+	uint8_t lock = (reg == SIM_CLK_LOCK) ? SIM_accessOld : clk[SIM_CLK_LOCK];
+
+	if (write && (reg == SIM_CLK_RTCCTRL)) {
+		SIM_RTC_Restart();
+	}
+	if (!write || (reg > SIM_CLK_LOCK)) {
+		return;
+	}
+	if (!SIM_CCP_IsOpen() || (lock & CLK_LOCK_bm)) {
+		clk[reg] = SIM_accessOld;
+	} else if ((reg == SIM_CLK_CTRL) &&
+	           !(SIM_io[SIM_OSC_OFFSET + SIM_OSC_STATUS] & SIM_clkSourceOsc[sclksel])) {
+		clk[reg] = SIM_accessOld;
+	}
+	SIM_CLK_Update();
+}
+
+
+/*! \brief Oscillator of OSC.CTRL the system clock depends on. */
+static uint8_t SIM_OSC_InUse(void)
+{
+	uint8_t sclksel = SIM_io[SIM_CLK_OFFSET + SIM_CLK_CTRL] & CLK_SCLKSEL_gm;
+	uint8_t pllctrl = SIM_io[SIM_OSC_OFFSET + SIM_OSC_PLLCTRL];
+	uint8_t inUse = SIM_clkSourceOsc[sclksel];
+
+	if (sclksel == CLK_SCLKSEL_PLL_gc) {
+		if ((pllctrl & OSC_PLLSRC_gm) == OSC_PLLSRC_RC2M_gc) {
+			inUse |= OSC_RC2MEN_bm;
+		} else if ((pllctrl & OSC_PLLSRC_gm) == OSC_PLLSRC_RC32M_gc) {
+			inUse |= OSC_RC32MEN_bm;
+		}
+	}
+	return inUse;
+}
+
+
+/*! \brief Set the ready flags of the oscillators that have started up.
+ *
+ *  The PLL does not lock without a reference or a multiplication factor.
+ */
+static void SIM_OSC_UpdateStatus(void)
+{
+	uint8_t * osc = &SIM_io[SIM_OSC_OFFSET];
+	uint64_t now = SIM_GetNanoseconds();
+	uint8_t i;
+
+	for (i = 0; i < SIM_OSC_COUNT; i++) {
+		if ((osc[SIM_OSC_CTRL] & (1 << i)) && (SIM_oscReady[i] <= now) &&
+		    ((i != SIM_OSC_COUNT - 1) || (SIM_CLK_SourceHz(CLK_SCLKSEL_PLL_gc) != 0))) {
+			osc[SIM_OSC_STATUS] |= 1 << i;
+		}
+	}
+}
+
+
+/*! \brief Apply a write to the Oscillator module.
+ *
+ *  An oscillator becomes ready SIM_OSC_StartupNs() after being enabled, and
+ *  is not stopped while the system clock depends on it. The PLL settings
+ *  cannot be changed while the PLL is enabled. The RTC restarts counting
+ *  when a 32 kHz oscillator is started.
+ */
+static void SIM_OSC_Access(uint8_t reg, bool write)
+{
+	uint8_t * osc = &SIM_io[SIM_OSC_OFFSET];
+	uint64_t now = SIM_GetNanoseconds();
+	uint8_t started;
+	uint8_t i;
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_OSC_CTRL) {
+		osc[reg] |= SIM_accessOld & SIM_OSC_InUse();
+		started = osc[reg] & ~SIM_accessOld;
+		osc[SIM_OSC_STATUS] &= osc[reg];
+		for (i = 0; i < SIM_OSC_COUNT; i++) {
+			if (started & (1 << i)) {
+				SIM_oscReady[i] = (SIM_OSC_StartupNs(i) == 0) ? UINT64_MAX :
+				                  now + SIM_OSC_StartupNs(i);
+			}
+		}
+		if (started & (OSC_RC32KEN_bm | OSC_XOSCEN_bm)) {
+			SIM_RTC_Restart();
+		}
+	} else if (reg == SIM_OSC_STATUS) {
+		osc[reg] = SIM_accessOld;
+	} else if ((reg == SIM_OSC_PLLCTRL) && (osc[SIM_OSC_CTRL] & OSC_PLLEN_bm)) {
+		osc[reg] = SIM_accessOld;
+	}
+}
+
+
+/*! \brief Make one calibration step of a DFLL.
+ *
+ *  The DFLL steps its oscillator towards the frequency of its reference, the
+ *  32 kHz RC oscillator or the crystal, and keeps it within half a step.
+ *  It does nothing while the oscillator or the reference is not running.
+ *
+ *  \param dfll  DFLL number, 0 for DFLLRC32M.
+ */
+static void SIM_DFLL_Step(uint8_t dfll)
+{
+	uint8_t osc = SIM_dfllOsc[dfll];
+	uint8_t reference = (SIM_io[SIM_OSC_OFFSET + SIM_OSC_DFLLCTRL] & SIM_dfllCref[dfll]) ? 3 : 2;
+	int32_t offset;
+
+	if (!(SIM_io[SIM_OSC_OFFSET + SIM_OSC_CTRL] & (1 << osc)) || !SIM_OSC_IsRunning(reference)) {
+		return;
+	}
+	offset = SIM_oscDrift[osc] + SIM_oscCorrection[osc] - SIM_oscDrift[reference];
+	if (offset > SIM_DFLL_STEP_PPM / 2) {
+		SIM_oscCorrection[osc] -= SIM_DFLL_STEP_PPM;
+	} else if (offset < -(SIM_DFLL_STEP_PPM / 2)) {
+		SIM_oscCorrection[osc] += SIM_DFLL_STEP_PPM;
+	} else {
+		return;
+	}
+	SIM_CLK_Update();
+}
+
+
+/*! \brief Make the DFLL calibration steps that are due. */
+static void SIM_DFLL_Update(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_DFLL_COUNT; i++) {
+		while (SIM_dfllNext[i] <= SIM_GetNanoseconds()) {
+			SIM_DFLL_Step(i);
+			SIM_dfllNext[i] += SIM_DFLL_PERIOD_NS;
+		}
+	}
+}
+
+
+/*! \brief Apply a write to a DFLL.
+ *
+ *  Enabling the DFLL starts the calibration steps. The correction reached
+ *  is kept when the DFLL is disabled. The calibration registers are not
+ *  modelled.
+ */
+static void SIM_DFLL_Access(uint16_t offset, bool write)
+{
+	uint8_t dfll = (offset - SIM_DFLL_OFFSET) / SIM_DFLL_SIZE;
+
+	if (!write || ((offset - SIM_DFLL_OFFSET) % SIM_DFLL_SIZE != SIM_DFLL_CTRL)) {
+		return;
+	}
+	if (!(SIM_io[offset] & DFLL_ENABLE_bm)) {
+		SIM_dfllNext[dfll] = UINT64_MAX;
+	} else if (!(SIM_accessOld & DFLL_ENABLE_bm)) {
+		SIM_dfllNext[dfll] = SIM_GetNanoseconds() + SIM_DFLL_PERIOD_NS;
+	}
+}
+
+
+/*! \brief Frequency of the RTC clock in mHz, 0 if it is stopped.
+ *
+ *  \param readyNs  Set to the time the oscillator of the clock is ready.
+ */
+static uint32_t SIM_RTC_ClockMilliHz(uint64_t * readyNs)
+{
+	uint8_t rtcctrl = SIM_io[SIM_CLK_OFFSET + SIM_CLK_RTCCTRL];
+	uint8_t osc;
+	uint32_t nominalHz;
+
+	*readyNs = 0;
+	if (!(rtcctrl & CLK_RTCEN_bm)) {
+		return 0;
+	}
+	switch (rtcctrl & CLK_RTCSRC_gm) {
+	case CLK_RTCSRC_ULP_gc:
+		/* The drift of the ULP oscillator is not modelled. */
+		return 1000000;
+	case CLK_RTCSRC_TOSC_gc:
+		osc = 3;
+		nominalHz = SIM_TOSC_HZ / 32;
+		break;
+	case CLK_RTCSRC_RCOSC_gc:
+		osc = 2;
+		nominalHz = SIM_RC32K_HZ / 32;
+		break;
+	case CLK_RTCSRC_TOSC32_gc:
+		osc = 3;
+		nominalHz = SIM_TOSC_HZ;
+		break;
+	default:
+		return 0;
+	}
+	if (!(SIM_io[SIM_OSC_OFFSET + SIM_OSC_CTRL] & (1 << osc))) {
+		return 0;
+	}
+	*readyNs = SIM_oscReady[osc];
+	return SIM_OSC_Hz(osc, nominalHz * 1000);
+}
+
+
+/*! \brief Time of an RTC count tick in nanoseconds, UINT64_MAX if the RTC
+ *         is stopped.
+ *
+ *  \param tick  Number of the tick since SIM_rtcBase, the first being 1.
+ */
+static uint64_t SIM_RTC_TickNs(uint64_t tick)
+{
+	uint16_t division = SIM_rtcDivision[SIM_io[SIM_RTC_OFFSET + SIM_RTC_CTRL] & RTC_PRESCALER_gm];
+	uint64_t start = SIM_rtcBase;
+	uint64_t readyNs;
+	uint32_t milliHz = SIM_RTC_ClockMilliHz(&readyNs);
+	uint64_t clocks = tick * division * 1000;
+
+	if ((milliHz == 0) || (division == 0) || (readyNs == UINT64_MAX)) {
+		return UINT64_MAX;
+	}
+	if (readyNs > start) {
+		start = readyNs;
+	}
+	return start + (clocks / milliHz) * 1000000000ULL +
+	       (clocks % milliHz) * 1000000000ULL / milliHz;
+}
+
+
+/*! \brief The RTC count ticks: update CNT and the flags, and generate the
+ *         events. */
+static void SIM_RTC_Tick(void)
+{
+	uint8_t * rtc = &SIM_io[SIM_RTC_OFFSET];
+	uint16_t count = SIM_Get16(SIM_RTC_OFFSET + SIM_RTC_CNT);
+
+	if (count == SIM_Get16(SIM_RTC_OFFSET + SIM_RTC_PER)) {
+		count = 0;
+		rtc[SIM_RTC_INTFLAGS] |= RTC_OVFIF_bm;
+		SIM_EVSYS_Generate(EVSYS_CHMUX_RTC_OVF_gc);
+	} else {
+		count++;
+	}
+	SIM_Set16(SIM_RTC_OFFSET + SIM_RTC_CNT, count);
+	if (count == SIM_Get16(SIM_RTC_OFFSET + SIM_RTC_COMP)) {
+		rtc[SIM_RTC_INTFLAGS] |= RTC_COMPIF_bm;
+		SIM_EVSYS_Generate(EVSYS_CHMUX_RTC_CMP_gc);
+	}
+}
+
+
+/*! \brief Bring the RTC count up to date. */
+static void SIM_RTC_Sync(void)
+{
+	while (SIM_RTC_TickNs(SIM_rtcTicks + 1) <= SIM_GetNanoseconds()) {
+		SIM_rtcTicks++;
+		SIM_RTC_Tick();
+	}
+}
+
+
+/*! \brief Start counting RTC ticks from now, after the count or the clock
+ *         has been written. */
+static void SIM_RTC_Restart(void)
+{
+	SIM_rtcBase = SIM_GetNanoseconds();
+	SIM_rtcTicks = 0;
+}
+
+
+/*! \brief Apply a write to the Real Time Counter.
+ *
+ *  Writing CTRL or CNT restarts the count. STATUS shows SYNCBUSY for
+ *  SIM_RTC_SYNC_CLOCKS RTC clock cycles after CTRL, CNT, PER or COMP has
+ *  been written. The interrupts are not modelled.
+ */
+static void SIM_RTC_Access(uint8_t reg, bool write)
+{
+	uint8_t * rtc = &SIM_io[SIM_RTC_OFFSET];
+	uint64_t readyNs;
+	uint32_t milliHz = SIM_RTC_ClockMilliHz(&readyNs);
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_RTC_STATUS) {
+		rtc[reg] = SIM_accessOld;
+	} else if (reg == SIM_RTC_INTFLAGS) {
+		/* The flags are cleared by writing one. */
+		rtc[reg] = SIM_accessOld & ~rtc[reg];
+	} else if ((reg == SIM_RTC_CTRL) || (reg == SIM_RTC_CNT) ||
+	           (reg == SIM_RTC_PER) || (reg == SIM_RTC_COMP)) {
+		if ((reg == SIM_RTC_CTRL) || (reg == SIM_RTC_CNT)) {
+			SIM_RTC_Restart();
+		}
+		if (milliHz == 0) {
+			/* Without a clock, the synchronization never ends. */
+			SIM_rtcSynced = UINT64_MAX;
+		} else {
+			SIM_rtcSynced = SIM_GetNanoseconds() +
+			                SIM_RTC_SYNC_CLOCKS * 1000000000000ULL / milliHz;
+		}
+		rtc[SIM_RTC_STATUS] |= RTC_SYNCBUSY_bm;
+	}
+}
+
+
+/*! \brief Frequency of the 32.768 kHz crystal of the battery backup module
+ *         in mHz, 0 if it is stopped.
+ *
+ *  The crystal is taken as ready as soon as it is enabled. It is the
+ *  oscillator of SIM_OSC_SetDrift() that OSC_XOSCEN_bm selects, as the
+ *  device has a single TOSC crystal.
+ */
+static uint32_t SIM_VBAT_XoscMilliHz(void)
+{
+	if (!(SIM_io[SIM_VBAT_OFFSET + SIM_VBAT_CTRL] & VBAT_XOSCEN_bm)) {
+		return 0;
+	}
+	return SIM_OSC_Hz(3, SIM_TOSC_HZ * 1000);
+}
+
+
+/*! \brief Time of an RTC32 clock tick in nanoseconds, UINT64_MAX if the
+ *         crystal is stopped.
+ *
+ *  The crystal output to the RTC32 runs while the RTC32 is disabled, so
+ *  enabling it or writing its count keeps the phase of the ticks.
+ *
+ *  \param tick  Number of the tick since SIM_rtc32Base, the first being 1.
+ */
+static uint64_t SIM_RTC32_TickNs(uint64_t tick)
+{
+	uint32_t milliHz = SIM_VBAT_XoscMilliHz();
+	uint32_t division = (SIM_io[SIM_VBAT_OFFSET + SIM_VBAT_CTRL] & VBAT_XOSCSEL_bm) ?
+	                    SIM_RTC32_DIV_1KHZ : SIM_RTC32_DIV_1HZ;
+	uint64_t clocks = tick * division * 1000;
+
+	if (milliHz == 0) {
+		return UINT64_MAX;
+	}
+	return SIM_rtc32Base + (clocks / milliHz) * 1000000000ULL +
+	       (clocks % milliHz) * 1000000000ULL / milliHz;
+}
+
+
+/*! \brief The RTC32 count ticks: update CNT and the flags. */
+static void SIM_RTC32_Tick(void)
+{
+	uint8_t * rtc32 = &SIM_io[SIM_RTC32_OFFSET];
+	uint32_t count = SIM_Get32(SIM_RTC32_OFFSET + SIM_RTC32_CNT);
+
+	if (count == SIM_Get32(SIM_RTC32_OFFSET + SIM_RTC32_PER)) {
+		count = 0;
+		rtc32[SIM_RTC32_INTFLAGS] |= RTC32_OVFIF_bm;
+	} else {
+		count++;
+	}
+	SIM_Set32(SIM_RTC32_OFFSET + SIM_RTC32_CNT, count);
+	if (count == SIM_Get32(SIM_RTC32_OFFSET + SIM_RTC32_COMP)) {
+		rtc32[SIM_RTC32_INTFLAGS] |= RTC32_COMPIF_bm;
+	}
+}
+
+
+/*! \brief Bring the RTC32 count up to date. */
+static void SIM_RTC32_Sync(void)
+{
+	while (SIM_RTC32_TickNs(SIM_rtc32Ticks + 1) <= SIM_GetNanoseconds()) {
+		SIM_rtc32Ticks++;
+		if (SIM_io[SIM_RTC32_OFFSET + SIM_RTC32_CTRL] & RTC32_ENABLE_bm) {
+			SIM_RTC32_Tick();
+		}
+	}
+}
+
+
+/*! \brief Start the RTC32 clock ticks from now, after the crystal has been
+ *         enabled or its output changed. */
+static void SIM_RTC32_Restart(void)
+{
+	SIM_rtc32Base = SIM_GetNanoseconds();
+	SIM_rtc32Ticks = 0;
+}
+
+
+/*! \brief Time a synchronization started now ends, in nanoseconds.
+ *
+ *  Without the crystal, the synchronization never ends.
+ */
+static uint64_t SIM_RTC32_SyncEnd(void)
+{
+	uint32_t milliHz = SIM_VBAT_XoscMilliHz();
+
+	if (milliHz == 0) {
+		return UINT64_MAX;
+	}
+	return SIM_GetNanoseconds() + (uint64_t) SIM_RTC32_SYNC_CLOCKS *
+	       SIM_RTC32_DIV_1KHZ * 1000000000000ULL / milliHz;
+}
+
+
+/*! \brief Apply a write to the 32-bit Real Time Counter.
+ *
+ *  The RTC32 counts from the crystal of the battery backup module while
+ *  both are enabled. SYNCBUSY is
+ *  set for SIM_RTC32_SYNC_CLOCKS cycles of the 1.024 kHz crystal output
+ *  after CTRL, CNT, PER or COMP has been written, and SYNCCNT for the same
+ *  time after it has been written one. The interrupts are not modelled.
+ */
+static void SIM_RTC32_Access(uint8_t reg, bool write)
+{
+	uint8_t * rtc32 = &SIM_io[SIM_RTC32_OFFSET];
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_RTC32_SYNCCTRL) {
+		rtc32[reg] = SIM_accessOld | (rtc32[reg] & RTC32_SYNCCNT_bm);
+		if ((rtc32[reg] & RTC32_SYNCCNT_bm) && !(SIM_accessOld & RTC32_SYNCCNT_bm)) {
+			SIM_rtc32CntSynced = SIM_RTC32_SyncEnd();
+		}
+	} else if (reg == SIM_RTC32_INTFLAGS) {
+		/* The flags are cleared by writing one. */
+		rtc32[reg] = SIM_accessOld & ~rtc32[reg];
+	} else if ((reg == SIM_RTC32_CTRL) || (reg == SIM_RTC32_CNT) ||
+	           (reg == SIM_RTC32_PER) || (reg == SIM_RTC32_COMP)) {
+		SIM_rtc32Synced = SIM_RTC32_SyncEnd();
+		rtc32[SIM_RTC32_SYNCCTRL] |= RTC32_SYNCBUSY_bm;
+	}
+}
+
+
+/*! \brief Apply a write to the battery backup module.
+ *
+ *  The registers can only be written once ACCEN has been set; ACCEN is in
+ *  the main domain and is cleared by a device reset. Enabling the crystal
+ *  sets XOSCRDY at once; a change of the crystal or of its output restarts
+ *  the RTC32 clock. RESET, which needs the CCP signature, clears the backup
+ *  domain: the VBAT registers and the RTC32. STATUS is read-only. The
+ *  failure detection is not modelled.
+ */
+static void SIM_VBAT_Access(uint8_t reg, bool write)
+{
+	uint8_t * vbat = &SIM_io[SIM_VBAT_OFFSET];
+
+	if (!write) {
+		return;
+	}
+	if (reg != SIM_VBAT_CTRL) {
+		if ((reg == SIM_VBAT_STATUS) || !(vbat[SIM_VBAT_CTRL] & VBAT_ACCEN_bm)) {
+			vbat[reg] = SIM_accessOld;
+		}
+	} else if (!(SIM_accessOld & VBAT_ACCEN_bm)) {
+		vbat[reg] = SIM_accessOld | (vbat[reg] & VBAT_ACCEN_bm);
+	} else {
+		if ((vbat[reg] & VBAT_RESET_bm) && SIM_CCP_IsOpen()) {
+			memset(vbat, 0, SIM_VBAT_LAST - SIM_VBAT_OFFSET + 1);
+			memset(&SIM_io[SIM_RTC32_OFFSET], 0, SIM_RTC32_LAST - SIM_RTC32_OFFSET + 1);
+			vbat[reg] = VBAT_ACCEN_bm;
+			SIM_rtc32Synced = 0;
+			SIM_rtc32CntSynced = 0;
+			return;
+		}
+		vbat[reg] &= ~VBAT_RESET_bm;
+		if (vbat[reg] & VBAT_XOSCEN_bm) {
+			vbat[SIM_VBAT_STATUS] |= VBAT_XOSCRDY_bm;
+		} else {
+			vbat[SIM_VBAT_STATUS] &= ~VBAT_XOSCRDY_bm;
+		}
+		if ((vbat[reg] ^ SIM_accessOld) & (VBAT_XOSCEN_bm | VBAT_XOSCSEL_bm)) {
+			SIM_RTC32_Restart();
+		}
+	}
+}
+
+
+/*! \brief Watchdog Timer period setting in CPU cycles.
+ *
+ *  \param setting  PER or WPER group configuration.
+ */
+static uint64_t SIM_WDT_Period(uint8_t setting)
+{
+	return (uint64_t) SIM_wdtCycles << (((setting & WDT_PER_gm) >> WDT_PER_gp) + 3);
+}
+
+
+/*! \brief Closed window period of the Watchdog Timer, 0 in normal mode. */
+static uint64_t SIM_WDT_ClosedCycles(void)
+{
+	uint8_t winctrl = SIM_io[SIM_WDT_OFFSET + SIM_WDT_WINCTRL];
+
+	return (winctrl & WDT_WEN_bm) ? SIM_WDT_Period(winctrl) : 0;
+}
+
+
+/*! \brief Time the Watchdog Timer times out, UINT64_MAX if it is disabled. */
+static uint64_t SIM_WDT_Timeout(void)
+{
+	uint8_t ctrl = SIM_io[SIM_WDT_OFFSET + SIM_WDT_CTRL];
+
+	if (!(ctrl & WDT_ENABLE_bm)) {
+		return UINT64_MAX;
+	}
+	return SIM_wdtStart + SIM_WDT_ClosedCycles() + SIM_WDT_Period(ctrl);
+}
+
+
+/*! \brief Apply a write to the Watchdog Timer.
+ *
+ *  CTRL and WINCTRL only change when written with the change enable bit set
+ *  within SIM_CCP_CYCLES of the CCP signature, as on the device. A new
+ *  setting restarts the timer and keeps SYNCBUSY set for a few Watchdog
+ *  clock cycles.
+ */
+static void SIM_WDT_Access(uint8_t reg, bool write)
+{
+	uint8_t * wdt = &SIM_io[SIM_WDT_OFFSET];
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_WDT_STATUS) {
+		wdt[reg] = SIM_accessOld;
+	} else if (!SIM_CCP_IsOpen() || !(wdt[reg] & WDT_CEN_bm)) {
+		/* WDT_CEN_bm and WDT_WCEN_bm are the same bit. */
+		wdt[reg] = SIM_accessOld;
+	} else {
+		SIM_wdtStart = SIM_cycles;
+		SIM_wdtSynced = SIM_cycles + (uint64_t) SIM_WDT_SYNC_CLOCKS * SIM_wdtCycles;
+		wdt[SIM_WDT_STATUS] = WDT_SYNCBUSY_bm;
+	}
+}
+
+
+/*! \brief Find the simulated TWI module of a module offset, NULL if none. */
+static SIM_TWI_t * SIM_TWI_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_TWI_COUNT; i++) {
+		if ((offset >= SIM_twi[i].offset) && (offset < SIM_twi[i].offset + sizeof(TWI_t))) {
+			return &SIM_twi[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief SCL period of a TWI master, from MASTER.BAUD. */
+static uint32_t SIM_TWI_BitCycles(const SIM_TWI_t * w)
+{
+	return 2 * (5 + (uint32_t) SIM_io[w->offset + SIM_TWIM_BAUD]);
+}
+
+
+/*! \brief Start a bus phase that ends after \a bits SCL periods. */
+static void SIM_TWI_Clock(SIM_TWI_t * w, SIM_TWI_Phase_t phase, uint8_t bits)
+{
+	w->phase = phase;
+	w->done = SIM_cycles + bits * SIM_TWI_BitCycles(w);
+}
+
+
+/*! \brief Hold SCL low for the master: set WIF or RIF. */
+static void SIM_TWI_MasterWait(SIM_TWI_t * w, uint8_t flags)
+{
+	uint8_t * status = &SIM_io[w->offset + SIM_TWIM_STATUS];
+
+	*status = (*status & ~TWI_MASTER_RXACK_bm) | TWI_MASTER_CLKHOLD_bm | flags;
+	w->phase = SIM_TWI_MASTER_WAIT;
+}
+
+
+/*! \brief Hold SCL low for the slave: set DIF or APIF. */
+static void SIM_TWI_SlaveWait(SIM_TWI_t * w, uint8_t flags)
+{
+	uint8_t * status = &SIM_io[w->offset + SIM_TWIS_STATUS];
+
+	*status = (*status & ~(TWI_SLAVE_RXACK_bm | TWI_SLAVE_DIR_bm | TWI_SLAVE_AP_bm)) |
+	          TWI_SLAVE_CLKHOLD_bm | flags;
+	w->phase = SIM_TWI_SLAVE_WAIT;
+}
+
+
+/*! \brief The STOP condition is complete: the bus is idle.
+ *
+ *  An addressed slave with PIEN set gets APIF with AP cleared.
+ */
+static void SIM_TWI_StopDone(SIM_TWI_t * w)
+{
+	uint8_t * slaveStatus = &SIM_io[w->offset + SIM_TWIS_STATUS];
+
+	SIM_io[w->offset + SIM_TWIM_STATUS] =
+		(SIM_io[w->offset + SIM_TWIM_STATUS] & ~TWI_MASTER_BUSSTATE_gm) |
+		TWI_MASTER_BUSSTATE_IDLE_gc;
+	if (w->addressed && (SIM_io[w->offset + SIM_TWIS_CTRLA] & TWI_SLAVE_PIEN_bm)) {
+		*slaveStatus = (*slaveStatus & ~TWI_SLAVE_AP_bm) | TWI_SLAVE_APIF_bm;
+	}
+	w->addressed = false;
+	w->phase = SIM_TWI_IDLE;
+}
+
+
+/*! \brief The master writes ADDR: send a START, or a repeated START, and
+ *         the address byte.
+ *
+ *  A START written while the STOP of the previous transaction is still on
+ *  the bus follows the STOP.
+ */
+static void SIM_TWI_Start(SIM_TWI_t * w)
+{
+	uint8_t * status = &SIM_io[w->offset + SIM_TWIM_STATUS];
+	uint64_t from = SIM_cycles;
+
+	if (w->phase == SIM_TWI_STOP) {
+		from = w->done;
+		SIM_TWI_StopDone(w);
+	}
+	/* All flags are cleared, RXACK included. */
+	*status = TWI_MASTER_BUSSTATE_OWNER_gc;
+	w->shift = SIM_io[w->offset + SIM_TWIM_ADDR];
+	w->read = (w->shift & 0x01) != 0;
+	w->addressed = false;
+	w->ackPending = false;
+	w->phase = SIM_TWI_ADDRESS;
+	/* The START condition takes about one SCL period, the address and its
+	 * acknowledge bit nine. */
+	w->done = from + 10 * SIM_TWI_BitCycles(w);
+}
+
+
+/*! \brief The acknowledge bit has been clocked.
+ *
+ *  A NACK from the slave, or no slave at all, gives the master WIF with
+ *  RXACK set. An ACK in the write direction gives the master WIF; in the
+ *  read direction the slave gets DIF with DIR set to send the next byte.
+ *  The master's own ACK or NACK after a byte read reaches the slave in
+ *  RXACK.
+ */
+static void SIM_TWI_AckDone(SIM_TWI_t * w)
+{
+	if (w->ackBySlave && w->nack) {
+		SIM_TWI_MasterWait(w, TWI_MASTER_WIF_bm | TWI_MASTER_RXACK_bm);
+	} else if (!w->read) {
+		SIM_TWI_MasterWait(w, TWI_MASTER_WIF_bm);
+	} else if (w->stopAfterAck) {
+		/* The slave gets the acknowledge bit, but the STOP follows
+		 * without SCL being held. */
+		if (w->addressed) {
+			uint8_t * slaveStatus = &SIM_io[w->offset + SIM_TWIS_STATUS];
+
+			*slaveStatus = (*slaveStatus & ~TWI_SLAVE_RXACK_bm) | TWI_SLAVE_DIF_bm |
+			               TWI_SLAVE_DIR_bm | (w->nack ? TWI_SLAVE_RXACK_bm : 0);
+		}
+		SIM_TWI_Clock(w, SIM_TWI_STOP, 1);
+	} else if (!w->addressed) {
+		/* Nobody drives SDA: the master reads 0xFF. */
+		w->shift = 0xFF;
+		SIM_TWI_Clock(w, SIM_TWI_READ, 8);
+	} else {
+		SIM_TWI_SlaveWait(w, TWI_SLAVE_DIF_bm | TWI_SLAVE_DIR_bm |
+		                     (w->nack ? TWI_SLAVE_RXACK_bm : 0));
+		w->slaveTransmit = true;
+	}
+	w->stopAfterAck = false;
+}
+
+
+/*! \brief The bus phase in progress is complete. */
+static void SIM_TWI_PhaseDone(SIM_TWI_t * w)
+{
+	uint8_t slaveCtrla = SIM_io[w->offset + SIM_TWIS_CTRLA];
+	uint8_t slaveAddress = SIM_io[w->offset + SIM_TWIS_ADDR];
+
+	switch (w->phase) {
+	case SIM_TWI_ADDRESS:
+		if ((slaveCtrla & TWI_SLAVE_ENABLE_bm) &&
+		    (((w->shift >> 1) == (slaveAddress >> 1)) || (slaveCtrla & TWI_SLAVE_PMEN_bm))) {
+			w->addressed = true;
+			w->slaveTransmit = false;
+			SIM_io[w->offset + SIM_TWIS_STATUS] &= ~TWI_SLAVE_DIF_bm;
+			SIM_TWI_SlaveWait(w, TWI_SLAVE_APIF_bm | TWI_SLAVE_AP_bm |
+			                     (w->read ? TWI_SLAVE_DIR_bm : 0));
+		} else {
+			SIM_TWI_MasterWait(w, TWI_MASTER_WIF_bm | TWI_MASTER_RXACK_bm);
+		}
+		break;
+	case SIM_TWI_WRITE:
+		if (w->addressed) {
+			SIM_io[w->offset + SIM_TWIS_DATA] = w->shift;
+			w->slaveTransmit = false;
+			SIM_TWI_SlaveWait(w, TWI_SLAVE_DIF_bm);
+		} else {
+			w->ackBySlave = true;
+			w->nack = true;
+			SIM_TWI_Clock(w, SIM_TWI_ACK, 1);
+		}
+		break;
+	case SIM_TWI_READ:
+		SIM_io[w->offset + SIM_TWIM_DATA] = w->shift;
+		w->ackPending = true;
+		SIM_TWI_MasterWait(w, TWI_MASTER_RIF_bm);
+		break;
+	case SIM_TWI_ACK:
+		SIM_TWI_AckDone(w);
+		break;
+	case SIM_TWI_STOP:
+		SIM_TWI_StopDone(w);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Test if a TWI module has a bus phase in progress. */
+static bool SIM_TWI_IsClocking(const SIM_TWI_t * w)
+{
+	return (w->phase != SIM_TWI_IDLE) && (w->phase != SIM_TWI_MASTER_WAIT) &&
+	       (w->phase != SIM_TWI_SLAVE_WAIT);
+}
+
+
+/*! \brief A command has been written to MASTER.CTRLC. */
+static void SIM_TWI_MasterCommand(SIM_TWI_t * w, uint8_t ctrlc)
+{
+	uint8_t command = ctrlc & TWI_MASTER_CMD_gm;
+
+	if ((command == TWI_MASTER_CMD_NOACT_gc) || (w->phase != SIM_TWI_MASTER_WAIT)) {
+		return;
+	}
+	SIM_io[w->offset + SIM_TWIM_STATUS] &= ~(TWI_MASTER_RIF_bm | TWI_MASTER_WIF_bm |
+	                                         TWI_MASTER_CLKHOLD_bm);
+	w->nack = (ctrlc & TWI_MASTER_ACKACT_bm) != 0;
+	w->ackBySlave = false;
+	if (command == TWI_MASTER_CMD_REPSTART_gc) {
+		SIM_TWI_Start(w);
+	} else if (command == TWI_MASTER_CMD_STOP_gc) {
+		if (w->ackPending) {
+			w->ackPending = false;
+			w->stopAfterAck = true;
+			SIM_TWI_Clock(w, SIM_TWI_ACK, 1);
+		} else {
+			SIM_TWI_Clock(w, SIM_TWI_STOP, 1);
+		}
+	} else if (w->ackPending) {
+		/* Acknowledge action and the next byte read. */
+		w->ackPending = false;
+		SIM_TWI_Clock(w, SIM_TWI_ACK, 1);
+	}
+}
+
+
+/*! \brief A command has been written to SLAVE.CTRLB.
+ *
+ *  Any command clears DIF, APIF and CLKHOLD. RESPONSE answers the address
+ *  or data interrupt: it sends ACKACT as the acknowledge bit, or, when the
+ *  slave is to send, the byte in SLAVE.DATA. COMPTRANS ends the transaction
+ *  for the slave, which then NACKs.
+ */
+static void SIM_TWI_SlaveCommand(SIM_TWI_t * w, uint8_t ctrlb)
+{
+	uint8_t command = ctrlb & TWI_SLAVE_CMD_gm;
+
+	if ((command != TWI_SLAVE_CMD_COMPTRANS_gc) && (command != TWI_SLAVE_CMD_RESPONSE_gc)) {
+		return;
+	}
+	SIM_io[w->offset + SIM_TWIS_STATUS] &= ~(TWI_SLAVE_DIF_bm | TWI_SLAVE_APIF_bm |
+	                                         TWI_SLAVE_CLKHOLD_bm);
+	if (w->phase != SIM_TWI_SLAVE_WAIT) {
+		if (command == TWI_SLAVE_CMD_COMPTRANS_gc) {
+			w->addressed = false;
+		}
+		return;
+	}
+	if (w->slaveTransmit) {
+		w->shift = (command == TWI_SLAVE_CMD_RESPONSE_gc) ? SIM_io[w->offset + SIM_TWIS_DATA] : 0xFF;
+		w->addressed = (command == TWI_SLAVE_CMD_RESPONSE_gc);
+		SIM_TWI_Clock(w, SIM_TWI_READ, 8);
+	} else {
+		w->ackBySlave = true;
+		w->nack = (command == TWI_SLAVE_CMD_COMPTRANS_gc) || (ctrlb & TWI_SLAVE_ACKACT_bm);
+		w->addressed = !w->nack;
+		SIM_TWI_Clock(w, SIM_TWI_ACK, 1);
+	}
+}
+
+
+/*! \brief Apply the side effects of a TWI register access.
+ *
+ *  The master and the slave of a module share one bus, without other
+ *  devices on it. Master RIF and WIF are cleared by writing one, by
+ *  accessing DATA and by writing ADDR or a command; writing the IDLE bus
+ *  state forces the bus idle. Slave DIF and APIF are cleared by writing one
+ *  or a command. The command bits read back zero. Disabling the master
+ *  ends the transaction.
+ */
+static void SIM_TWI_Access(SIM_TWI_t * w, uint8_t reg, bool write)
+{
+	uint8_t * twi = &SIM_io[w->offset];
+	uint8_t value = twi[reg];
+
+	switch (reg) {
+	case SIM_TWIM_CTRLA:
+		if (write && !(value & TWI_MASTER_ENABLE_bm)) {
+			twi[SIM_TWIM_STATUS] = 0;
+			w->phase = SIM_TWI_IDLE;
+			w->addressed = false;
+		}
+		break;
+	case SIM_TWIM_CTRLC:
+		if (write) {
+			twi[reg] = value & ~TWI_MASTER_CMD_gm;
+			SIM_TWI_MasterCommand(w, value);
+		}
+		break;
+	case SIM_TWIM_STATUS:
+		if (write) {
+			uint8_t cleared = value & (TWI_MASTER_RIF_bm | TWI_MASTER_WIF_bm |
+			                           TWI_MASTER_ARBLOST_bm | TWI_MASTER_BUSERR_bm);
+			uint8_t status = SIM_accessOld & ~cleared;
+
+			if (cleared & (TWI_MASTER_RIF_bm | TWI_MASTER_WIF_bm)) {
+				status &= ~TWI_MASTER_CLKHOLD_bm;
+			}
+			if ((value & TWI_MASTER_BUSSTATE_gm) == TWI_MASTER_BUSSTATE_IDLE_gc) {
+				status = (status & ~TWI_MASTER_BUSSTATE_gm) | TWI_MASTER_BUSSTATE_IDLE_gc;
+			}
+			twi[reg] = status;
+		}
+		break;
+	case SIM_TWIM_ADDR:
+		if (write && (twi[SIM_TWIM_CTRLA] & TWI_MASTER_ENABLE_bm)) {
+			SIM_TWI_Start(w);
+		}
+		break;
+	case SIM_TWIM_DATA:
+		if (w->phase == SIM_TWI_MASTER_WAIT) {
+			twi[SIM_TWIM_STATUS] &= ~(TWI_MASTER_RIF_bm | TWI_MASTER_WIF_bm |
+			                          TWI_MASTER_CLKHOLD_bm);
+			if (write && !w->read) {
+				w->shift = value;
+				SIM_TWI_Clock(w, SIM_TWI_WRITE, 8);
+			}
+		}
+		break;
+	case SIM_TWIS_CTRLA:
+		if (write && !(value & TWI_SLAVE_ENABLE_bm)) {
+			twi[SIM_TWIS_STATUS] = 0;
+			w->addressed = false;
+		}
+		break;
+	case SIM_TWIS_CTRLB:
+		if (write) {
+			twi[reg] = value & ~TWI_SLAVE_CMD_gm;
+			SIM_TWI_SlaveCommand(w, value);
+		}
+		break;
+	case SIM_TWIS_STATUS:
+		if (write) {
+			uint8_t cleared = value & (TWI_SLAVE_DIF_bm | TWI_SLAVE_APIF_bm |
+			                           TWI_SLAVE_COLL_bm | TWI_SLAVE_BUSERR_bm);
+			uint8_t status = SIM_accessOld & ~cleared;
+
+			if (cleared & (TWI_SLAVE_DIF_bm | TWI_SLAVE_APIF_bm)) {
+				status &= ~TWI_SLAVE_CLKHOLD_bm;
+			}
+			twi[reg] = status;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Expand an AES-128 round key to the next one. */
+static void SIM_AES_NextKey(uint8_t * key, uint8_t rcon)
+{
+	uint8_t i;
+
+	key[0] ^= SIM_aesSbox[key[13]] ^ rcon;
+	key[1] ^= SIM_aesSbox[key[14]];
+	key[2] ^= SIM_aesSbox[key[15]];
+	key[3] ^= SIM_aesSbox[key[12]];
+	for (i = 4; i < 16; i++) {
+		key[i] ^= key[i - 4];
+	}
+}
+
+
+/*! \brief Go back from an AES-128 round key to the one before. */
+static void SIM_AES_PreviousKey(uint8_t * key, uint8_t rcon)
+{
+	uint8_t i;
+
+	for (i = 15; i >= 4; i--) {
+		key[i] ^= key[i - 4];
+	}
+	key[0] ^= SIM_aesSbox[key[13]] ^ rcon;
+	key[1] ^= SIM_aesSbox[key[14]];
+	key[2] ^= SIM_aesSbox[key[15]];
+	key[3] ^= SIM_aesSbox[key[12]];
+}
+
+
+/*! \brief Multiply by x in GF(2^8). */
+static uint8_t SIM_AES_Xtime(uint8_t value)
+{
+	return (uint8_t) ((value << 1) ^ ((value & 0x80) ? 0x1B : 0x00));
+}
+
+
+/*! \brief Multiply two elements of GF(2^8). */
+static uint8_t SIM_AES_Multiply(uint8_t a, uint8_t b)
+{
+	uint8_t product = 0;
+
+	while (b != 0) {
+		if (b & 0x01) {
+			product ^= a;
+		}
+		a = SIM_AES_Xtime(a);
+		b >>= 1;
+	}
+	return product;
+}
+
+
+/*! \brief Substitute the state bytes and shift the rows, or the inverse.
+ *
+ *  The state is in the byte order of the STATE register, column by column.
+ */
+static void SIM_AES_SubShift(uint8_t * state, bool inverse)
+{
+	uint8_t old[16];
+	uint8_t i;
+
+	memcpy(old, state, sizeof(old));
+	for (i = 0; i < 16; i++) {
+		uint8_t row = i % 4;
+		uint8_t column = i / 4;
+
+		if (inverse) {
+			state[row + 4 * ((column + row) % 4)] = SIM_aesInvSbox[old[i]];
+		} else {
+			state[i] = SIM_aesSbox[old[row + 4 * ((column + row) % 4)]];
+		}
+	}
+}
+
+
+/*! \brief Mix the columns of the state, or the inverse. */
+static void SIM_AES_MixColumns(uint8_t * state, bool inverse)
+{
+	static const uint8_t forward[4] = { 0x02, 0x03, 0x01, 0x01 };
+	static const uint8_t backward[4] = { 0x0E, 0x0B, 0x0D, 0x09 };
+	const uint8_t * m = inverse ? backward : forward;
+	uint8_t column;
+
+	for (column = 0; column < 4; column++) {
+		uint8_t * c = &state[4 * column];
+		uint8_t old[4];
+		uint8_t row;
+
+		memcpy(old, c, sizeof(old));
+		for (row = 0; row < 4; row++) {
+			c[row] = SIM_AES_Multiply(old[row], m[0]) ^
+			         SIM_AES_Multiply(old[(row + 1) % 4], m[1]) ^
+			         SIM_AES_Multiply(old[(row + 2) % 4], m[2]) ^
+			         SIM_AES_Multiply(old[(row + 3) % 4], m[3]);
+		}
+	}
+}
+
+
+/*! \brief Add a round key to the state. */
+static void SIM_AES_AddKey(uint8_t * state, const uint8_t * key)
+{
+	uint8_t i;
+
+	for (i = 0; i < 16; i++) {
+		state[i] ^= key[i];
+	}
+}
+
+
+/*! \brief Encrypt or decrypt the state in the key memory of the module.
+ *
+ *  As on the device, encryption leaves the last round key in the key
+ *  memory, and decryption starts from the last round key and leaves the
+ *  original key.
+ */
+static void SIM_AES_Run(bool decrypt)
+{
+	static const uint8_t rcon[11] = {
+		0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+	};
+	uint8_t * state = SIM_aes.state;
+	uint8_t * key = SIM_aes.key;
+	uint8_t round;
+
+	SIM_AES_AddKey(state, key);
+	if (!decrypt) {
+		for (round = 1; round <= 10; round++) {
+			SIM_AES_SubShift(state, false);
+			if (round < 10) {
+				SIM_AES_MixColumns(state, false);
+			}
+			SIM_AES_NextKey(key, rcon[round]);
+			SIM_AES_AddKey(state, key);
+		}
+	} else {
+		for (round = 10; round >= 1; round--) {
+			SIM_AES_SubShift(state, true);
+			SIM_AES_PreviousKey(key, rcon[round]);
+			SIM_AES_AddKey(state, key);
+			if (round > 1) {
+				SIM_AES_MixColumns(state, true);
+			}
+		}
+	}
+}
+
+
+/*! \brief Start an encryption or decryption, which takes SIM_AES_CYCLES. */
+static void SIM_AES_Start(void)
+{
+	SIM_aes.busy = true;
+	SIM_aes.done = SIM_cycles + SIM_AES_CYCLES;
+	SIM_aes.stateRead = 0;
+	SIM_aes.stateWrite = 0;
+	SIM_aes.keyRead = 0;
+	SIM_aes.keyWrite = 0;
+	SIM_io[SIM_AES_OFFSET + SIM_AES_CTRL] |= AES_START_bm;
+}
+
+
+/*! \brief The encryption or decryption is complete: set SRIF. */
+static void SIM_AES_Done(void)
+{
+	uint8_t * aes = &SIM_io[SIM_AES_OFFSET];
+
+	SIM_AES_Run((aes[SIM_AES_CTRL] & AES_DECRYPT_bm) != 0);
+	SIM_aes.busy = false;
+	aes[SIM_AES_CTRL] &= ~AES_START_bm;
+	aes[SIM_AES_STATUS] |= AES_SRIF_bm;
+}
+
+
+/*! \brief Apply the side effects of an AES register access.
+ *
+ *  STATE and KEY are windows to the 16-byte state and key memories, with
+ *  separate read and write pointers that are reset when the module starts.
+ *  With XOR set, a byte written to STATE is XORed into the state. With
+ *  AUTO set, writing the 16th state byte starts the module. Accessing STATE
+ *  or KEY, or setting START, while the module is busy sets ERROR and is
+ *  ignored. SRIF is cleared by accessing STATE, by writing one and by
+ *  taking the interrupt. RESET clears the module.
+ */
+static void SIM_AES_Access(uint8_t reg, bool write)
+{
+	uint8_t * aes = &SIM_io[SIM_AES_OFFSET];
+	uint8_t value = aes[reg];
+
+	if (SIM_aes.busy && ((reg == SIM_AES_STATE) || (reg == SIM_AES_KEY) ||
+	                     ((reg == SIM_AES_CTRL) && write && (value & AES_START_bm)))) {
+		aes[reg] = SIM_accessOld;
+		aes[SIM_AES_STATUS] |= AES_ERROR_bm;
+		return;
+	}
+	switch (reg) {
+	case SIM_AES_CTRL:
+		if (write && (value & AES_RESET_bm)) {
+			memset(&SIM_aes, 0, sizeof(SIM_aes));
+			memset(aes, 0, SIM_AES_LAST - SIM_AES_OFFSET + 1);
+		} else if (write && (value & AES_START_bm)) {
+			SIM_AES_Start();
+		}
+		break;
+	case SIM_AES_STATUS:
+		if (write) {
+			aes[reg] = SIM_accessOld & ~(value & (AES_ERROR_bm | AES_SRIF_bm));
+		}
+		break;
+	case SIM_AES_STATE:
+		aes[SIM_AES_STATUS] &= ~AES_SRIF_bm;
+		if (!write) {
+			SIM_aes.stateRead = (SIM_aes.stateRead + 1) % 16;
+			break;
+		}
+		if (aes[SIM_AES_CTRL] & AES_XOR_bm) {
+			value ^= SIM_aes.state[SIM_aes.stateWrite];
+		}
+		SIM_aes.state[SIM_aes.stateWrite] = value;
+		SIM_aes.stateWrite = (SIM_aes.stateWrite + 1) % 16;
+		if ((SIM_aes.stateWrite == 0) && (aes[SIM_AES_CTRL] & AES_AUTO_bm)) {
+			SIM_AES_Start();
+		}
+		break;
+	case SIM_AES_KEY:
+		if (write) {
+			SIM_aes.key[SIM_aes.keyWrite] = value;
+			SIM_aes.keyWrite = (SIM_aes.keyWrite + 1) % 16;
+		} else {
+			SIM_aes.keyRead = (SIM_aes.keyRead + 1) % 16;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief Find the simulated ADC of a module offset, NULL if none. */
+static SIM_ADC_t * SIM_ADC_Find(uint16_t offset)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_ADC_COUNT; i++) {
+		if ((offset >= SIM_adc[i].offset) && (offset < SIM_adc[i].offset + sizeof(ADC_t))) {
+			return &SIM_adc[i];
+		}
+	}
+	return NULL;
+}
+
+
+/*! \brief Find the simulated ADC of a module instance, abort if none. */
+static SIM_ADC_t * SIM_ADC_Get(ADC_t * adc)
+{
+	SIM_ADC_t * d = SIM_ADC_Find((uint8_t *) adc - SIM_ioSpace);
+
+	if ((d == NULL) || (d->offset != (uint8_t *) adc - SIM_ioSpace)) {
+		fprintf(stderr, "sim: %p is not a simulated ADC\n", (void *) adc);
+		abort();
+	}
+	return d;
+}
+
+
+/*! \brief Get the reference voltage of an ADC, in millivolts. */
+static int32_t SIM_ADC_Reference(const SIM_ADC_t * d)
+{
+	int32_t reference;
+
+	switch (SIM_io[d->offset + SIM_ADC_REFCTRL] & ADC_REFSEL_gm) {
+	case ADC_REFSEL_INT1V_gc:
+		reference = SIM_ADC_INT1V_MV;
+		break;
+	case ADC_REFSEL_VCC_gc:
+		reference = SIM_AC_VCC_MV * 10 / 16;
+		break;
+	case ADC_REFSEL_AREFA_gc:
+		reference = SIM_adc[0].input[0];
+		break;
+	default:
+		reference = SIM_adc[1].input[0];
+		break;
+	}
+	return (reference > 0) ? reference : 1;
+}
+
+
+/*! \brief Convert the input of an ADC channel.
+ *
+ *  In unsigned mode the result is (Vin + 0.05 Vref) / Vref * 4096, in
+ *  signed mode Vdiff / Vref * 2048 times the gain, clamped to the range of
+ *  the mode and then scaled to the resolution. The temperature sensor and
+ *  the DAC read as 0 V. Offset and gain errors are not modelled.
+ */
+static uint16_t SIM_ADC_Convert(const SIM_ADC_t * d, uint8_t channel)
+{
+	const uint8_t * adc = &SIM_io[d->offset];
+	const uint8_t * ch = &adc[SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE];
+	uint8_t pos = ((ch[SIM_ADC_CH_MUXCTRL] & ADC_CH_MUXPOS_gm) >> ADC_CH_MUXPOS_gp) % SIM_ADC_INPUTS;
+	uint8_t neg = ch[SIM_ADC_CH_MUXCTRL] & ADC_CH_MUXNEG_gm;
+	uint8_t resolution = adc[SIM_ADC_CTRLB] & ADC_RESOLUTION_gm;
+	bool isSigned = (adc[SIM_ADC_CTRLB] & ADC_CONMODE_bm) != 0;
+	int32_t reference = SIM_ADC_Reference(d);
+	int32_t millivolts;
+	int32_t result;
+
+	switch (ch[SIM_ADC_CH_CTRL] & ADC_CH_INPUTMODE_gm) {
+	case ADC_CH_INPUTMODE_INTERNAL_gc:
+		millivolts = SIM_adcInternalMv[pos % 4];
+		break;
+	case ADC_CH_INPUTMODE_SINGLEENDED_gc:
+		millivolts = d->input[pos];
+		break;
+	case ADC_CH_INPUTMODE_DIFF_gc:
+		millivolts = d->input[pos] - d->input[neg];
+		break;
+	default:
+		millivolts = (d->input[pos] - d->input[neg + 4]) *
+		             (1 << ((ch[SIM_ADC_CH_CTRL] & ADC_CH_GAINFAC_gm) >> ADC_CH_GAINFAC_gp));
+		break;
+	}
+	if (isSigned) {
+		result = millivolts * 2048 / reference;
+		result = (result < -2048) ? -2048 : (result > 2047) ? 2047 : result;
+	} else {
+		result = (millivolts + reference / 20) * 4096 / reference;
+		result = (result < 0) ? 0 : (result > 4095) ? 4095 : result;
+	}
+	if (resolution == ADC_RESOLUTION_8BIT_gc) {
+		result >>= 4;
+	} else if (resolution == ADC_RESOLUTION_LEFT12BIT_gc) {
+		result *= 16;
+	}
+	return (uint16_t) result;
+}
+
+
+/*! \brief Start a conversion on an ADC channel.
+ *
+ *  The input is sampled at once. A conversion takes 1 + RES/2 ADC clock
+ *  cycles, one more with gain, and the pipeline takes a new conversion
+ *  every ADC clock cycle, so channels started together complete one ADC
+ *  clock cycle apart.
+ */
+static void SIM_ADC_Start(SIM_ADC_t * d, uint8_t channel)
+{
+	const uint8_t * adc = &SIM_io[d->offset];
+	uint8_t ctrl = adc[SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE + SIM_ADC_CH_CTRL];
+	uint32_t adcClock = 4UL << (adc[SIM_ADC_PRESCALER] & ADC_PRESCALER_gm);
+	uint8_t clocks = ((adc[SIM_ADC_CTRLB] & ADC_RESOLUTION_gm) == ADC_RESOLUTION_8BIT_gc) ? 5 : 7;
+	uint64_t start = (d->nextSlot > SIM_cycles) ? d->nextSlot : SIM_cycles;
+
+	if ((ctrl & ADC_CH_INPUTMODE_gm) == ADC_CH_INPUTMODE_DIFFWGAIN_gc) {
+		clocks++;
+	}
+	d->result[channel] = SIM_ADC_Convert(d, channel);
+	d->done[channel] = start + clocks * adcClock;
+	d->nextSlot = start + adcClock;
+}
+
+
+/*! \brief A conversion is complete: store the result and set the flag
+ *         selected by the interrupt mode.
+ */
+static void SIM_ADC_Done(SIM_ADC_t * d, uint8_t channel)
+{
+	uint8_t * adc = &SIM_io[d->offset];
+	uint8_t * ch = &adc[SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE];
+	uint16_t result = d->result[channel];
+	uint16_t compare = SIM_Get16(d->offset + SIM_ADC_CMP);
+	bool isSigned = (adc[SIM_ADC_CTRLB] & ADC_CONMODE_bm) != 0;
+	bool below = isSigned ? ((int16_t) result < (int16_t) compare) : (result < compare);
+	bool above = isSigned ? ((int16_t) result > (int16_t) compare) : (result > compare);
+	uint8_t intmode = ch[SIM_ADC_CH_INTCTRL] & ADC_CH_INTMODE_gm;
+
+	d->done[channel] = UINT64_MAX;
+	SIM_Set16(d->offset + SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE + SIM_ADC_CH_RES, result);
+	SIM_Set16(d->offset + SIM_ADC_CH0RES + 2 * channel, result);
+	if ((intmode == ADC_CH_INTMODE_COMPLETE_gc) ||
+	    ((intmode == ADC_CH_INTMODE_BELOW_gc) && below) ||
+	    ((intmode == ADC_CH_INTMODE_ABOVE_gc) && above)) {
+		ch[SIM_ADC_CH_INTFLAGS] |= ADC_CH_CHIF_bm;
+		adc[SIM_ADC_INTFLAGS] |= ADC_CH0IF_bm << channel;
+	}
+}
+
+
+/*! \brief Apply the side effects of an ADC register access.
+ *
+ *  A conversion is started by START in a channel CTRL or by CHnSTART in
+ *  CTRLA, which read back zero; FLUSH and disabling the ADC cancel the
+ *  conversions in progress. The channel flags are cleared by writing one,
+ *  in the channel or in ADC.INTFLAGS, or by taking the interrupt.
+ */
+static void SIM_ADC_Access(SIM_ADC_t * d, uint8_t reg, bool write)
+{
+	uint8_t * adc = &SIM_io[d->offset];
+	uint8_t value = adc[reg];
+	uint8_t channel;
+
+	if (!write) {
+		return;
+	}
+	if (reg == SIM_ADC_CTRLA) {
+		adc[reg] = value & ~(ADC_CH3START_bm | ADC_CH2START_bm | ADC_CH1START_bm |
+		                     ADC_CH0START_bm | ADC_FLUSH_bm);
+		for (channel = 0; channel < SIM_ADC_CH_COUNT; channel++) {
+			if (!(value & ADC_ENABLE_bm) || (value & ADC_FLUSH_bm)) {
+				d->done[channel] = UINT64_MAX;
+			} else if (value & (ADC_CH0START_bm << channel)) {
+				SIM_ADC_Start(d, channel);
+			}
+		}
+	} else if (reg == SIM_ADC_INTFLAGS) {
+		adc[reg] = SIM_accessOld & ~value;
+		for (channel = 0; channel < SIM_ADC_CH_COUNT; channel++) {
+			if (value & (ADC_CH0IF_bm << channel)) {
+				adc[SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE + SIM_ADC_CH_INTFLAGS] &=
+					~ADC_CH_CHIF_bm;
+			}
+		}
+	} else if (reg >= SIM_ADC_CH0) {
+		uint8_t chReg = (reg - SIM_ADC_CH0) % SIM_ADC_CH_SIZE;
+
+		channel = (reg - SIM_ADC_CH0) / SIM_ADC_CH_SIZE;
+		if ((chReg == SIM_ADC_CH_CTRL) && (value & ADC_CH_START_bm)) {
+			adc[reg] = value & ~ADC_CH_START_bm;
+			if (adc[SIM_ADC_CTRLA] & ADC_ENABLE_bm) {
+				SIM_ADC_Start(d, channel);
+			}
+		} else if (chReg == SIM_ADC_CH_INTFLAGS) {
+			adc[reg] = SIM_accessOld & ~(value & ADC_CH_CHIF_bm);
+			if (value & ADC_CH_CHIF_bm) {
+				adc[SIM_ADC_INTFLAGS] &= ~(ADC_CH0IF_bm << channel);
+			}
+		}
+	}
+}
+
+
+/*! \brief Test if the NVM controller is busy. */
+static bool SIM_NVM_IsBusy(void)
+{
+	return SIM_nvmDone != UINT64_MAX;
+}
+
+
+/*! \brief Execute the EEPROM command in NVM.CMD.
+ *
+ *  The erase and write commands act on the bytes loaded in the page
+ *  buffer, of the page in ADDR or, for ERASE_EEPROM, of all pages. They
+ *  take effect at once and keep NVMBUSY set for the typical programming
+ *  time. The write commands clear the page buffer, the erase commands keep
+ *  it for a following split write. A write without erase can only clear
+ *  bits. Other commands are ignored: the flash, its signature rows and the
+ *  fuses are not modelled.
+ */
+static void SIM_NVM_Execute(void)
+{
+	uint8_t * nvm = &SIM_io[SIM_NVM_OFFSET];
+	uint16_t address = (nvm[SIM_NVM_ADDR0] | (nvm[SIM_NVM_ADDR0 + 1] << 8)) & (SIM_EEPROM_SIZE - 1);
+	uint16_t page = address & ~(SIM_EEPROM_PAGE - 1);
+	uint8_t command = nvm[SIM_NVM_CMD];
+	uint32_t busyNs = 0;
+	uint16_t i;
+
+	switch (command) {
+	case NVM_CMD_READ_EEPROM_gc:
+		nvm[SIM_NVM_DATA0] = SIM_eeprom[address];
+		return;
+	case NVM_CMD_ERASE_EEPROM_BUFFER_gc:
+		break;
+	case NVM_CMD_ERASE_EEPROM_gc:
+		for (i = 0; i < SIM_EEPROM_SIZE; i++) {
+			if (SIM_eeLoaded & (1UL << (i % SIM_EEPROM_PAGE))) {
+				SIM_eeprom[i] = 0xFF;
+			}
+		}
+		SIM_nvmDone = SIM_GetNanoseconds() + SIM_NVM_EE_ERASE_NS;
+		nvm[SIM_NVM_STATUS] |= NVM_NVMBUSY_bm;
+		return;
+	case NVM_CMD_ERASE_EEPROM_PAGE_gc:
+	case NVM_CMD_WRITE_EEPROM_PAGE_gc:
+	case NVM_CMD_ERASE_WRITE_EEPROM_PAGE_gc:
+		for (i = 0; i < SIM_EEPROM_PAGE; i++) {
+			uint8_t * cell = &SIM_eeprom[page + i];
+
+			if (!(SIM_eeLoaded & (1UL << i))) {
+				continue;
+			}
+			if (command == NVM_CMD_ERASE_EEPROM_PAGE_gc) {
+				*cell = 0xFF;
+			} else if (command == NVM_CMD_WRITE_EEPROM_PAGE_gc) {
+				*cell &= SIM_eeBuffer[i];
+			} else {
+				*cell = SIM_eeBuffer[i];
+			}
+		}
+		busyNs = (command == NVM_CMD_ERASE_EEPROM_PAGE_gc) ? SIM_NVM_EE_ERASE_NS :
+		         (command == NVM_CMD_WRITE_EEPROM_PAGE_gc) ? SIM_NVM_EE_WRITE_NS :
+		         SIM_NVM_EE_ERASE_NS + SIM_NVM_EE_WRITE_NS;
+		SIM_nvmDone = SIM_GetNanoseconds() + busyNs;
+		nvm[SIM_NVM_STATUS] |= NVM_NVMBUSY_bm;
+		if (command == NVM_CMD_ERASE_EEPROM_PAGE_gc) {
+			return;
+		}
+		break;
+	default:
+		return;
+	}
+
+	SIM_eeLoaded = 0;
+	memset(SIM_eeBuffer, 0xFF, sizeof(SIM_eeBuffer));
+	nvm[SIM_NVM_STATUS] &= ~NVM_EELOAD_bm;
+}
+
+
+/*! \brief Apply the side effects of an NVM register access.
+ *
+ *  With the LOAD_EEPROM_BUFFER command, writing DATA0 loads the page buffer
+ *  byte selected by ADDR0 and sets EELOAD. CMDEX executes the command when
+ *  written within SIM_CCP_CYCLES of the CCP signature and the controller is
+ *  not busy; it reads back zero. STATUS is read only.
+ */
+static void SIM_NVM_Access(uint8_t reg, bool write)
+{
+	uint8_t * nvm = &SIM_io[SIM_NVM_OFFSET];
+
+	if (!write) {
+		return;
+	}
+	switch (reg) {
+	case SIM_NVM_DATA0:
+		if (nvm[SIM_NVM_CMD] == NVM_CMD_LOAD_EEPROM_BUFFER_gc) {
+			uint8_t byte = nvm[SIM_NVM_ADDR0] % SIM_EEPROM_PAGE;
+
+			SIM_eeBuffer[byte] = nvm[SIM_NVM_DATA0];
+			SIM_eeLoaded |= 1UL << byte;
+			nvm[SIM_NVM_STATUS] |= NVM_EELOAD_bm;
+		}
+		break;
+	case SIM_NVM_CTRLA:
+		if ((nvm[reg] & NVM_CMDEX_bm) && SIM_CCP_IsOpen() && !SIM_NVM_IsBusy()) {
+			SIM_NVM_Execute();
+		}
+		nvm[reg] &= ~NVM_CMDEX_bm;
+		break;
+	case SIM_NVM_STATUS:
+		nvm[reg] = SIM_accessOld;
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief End of the EEPROM programming time: clear NVMBUSY. */
+static void SIM_NVM_Update(void)
+{
+	if (SIM_NVM_IsBusy() && (SIM_GetNanoseconds() >= SIM_nvmDone)) {
+		SIM_nvmDone = UINT64_MAX;
+		SIM_io[SIM_NVM_OFFSET + SIM_NVM_STATUS] &= ~NVM_NVMBUSY_bm;
+	}
+}
+
+
+/*! \brief Bring the module of a register up to date before it is accessed.
+ *
+ *  The HiRes module changes how a Timer/Counter counts, so the counter is
+ *  also brought up to date before its HiRes register is accessed.
+ */
+static void SIM_PreAccess(uint16_t offset)
+{
+	SIM_TC_t * t = SIM_TC_Find(offset);
+	uint8_t i;
+
+	if (t != NULL) {
+		SIM_TC_Sync(t);
+	}
+	if ((offset >= SIM_VPORT_FIRST) && (offset <= SIM_VPORT_LAST)) {
+		SIM_io[offset] = SIM_io[SIM_VPORT_Register(offset)];
+	}
+	if ((offset == SIM_WDT_OFFSET + SIM_WDT_STATUS) && (SIM_cycles >= SIM_wdtSynced)) {
+		SIM_io[offset] = 0;
+	}
+	if (offset == SIM_OSC_OFFSET + SIM_OSC_STATUS) {
+		SIM_OSC_UpdateStatus();
+	}
+	if ((offset >= SIM_RTC_OFFSET) && (offset <= SIM_RTC_LAST)) {
+		SIM_RTC_Sync();
+		if ((offset == SIM_RTC_OFFSET + SIM_RTC_STATUS) &&
+		    (SIM_GetNanoseconds() >= SIM_rtcSynced)) {
+			SIM_io[offset] &= ~RTC_SYNCBUSY_bm;
+		}
+	}
+	if ((offset >= SIM_VBAT_OFFSET) && (offset <= SIM_VBAT_LAST)) {
+		SIM_RTC32_Sync();
+	}
+	if ((offset >= SIM_RTC32_OFFSET) && (offset <= SIM_RTC32_LAST)) {
+		SIM_RTC32_Sync();
+		if (SIM_GetNanoseconds() >= SIM_rtc32Synced) {
+			SIM_io[SIM_RTC32_OFFSET + SIM_RTC32_SYNCCTRL] &= ~RTC32_SYNCBUSY_bm;
+		}
+		if (SIM_GetNanoseconds() >= SIM_rtc32CntSynced) {
+			SIM_io[SIM_RTC32_OFFSET + SIM_RTC32_SYNCCTRL] &= ~RTC32_SYNCCNT_bm;
+		}
+	}
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		if (offset == SIM_tc[i].offset + SIM_HIRES_OFFSET) {
+			SIM_TC_Sync(&SIM_tc[i]);
+		}
+	}
+	/* The STATE and KEY registers read the memory bytes at their pointers. */
+	if (offset == SIM_AES_OFFSET + SIM_AES_STATE) {
+		SIM_io[offset] = SIM_aes.busy ? 0 : SIM_aes.state[SIM_aes.stateRead];
+	}
+	if (offset == SIM_AES_OFFSET + SIM_AES_KEY) {
+		SIM_io[offset] = SIM_aes.busy ? 0 : SIM_aes.key[SIM_aes.keyRead];
+	}
+}
+
+
+/*! \brief Get a 24-bit address from three DMA channel registers. */
+static uint32_t SIM_DMA_GetAddress(const uint8_t * reg)
+{
+	return reg[0] | ((uint32_t) reg[1] << 8) | ((uint32_t) reg[2] << 16);
+}
+
+
+/*! \brief Set a 24-bit address in three DMA channel registers. */
+static void SIM_DMA_SetAddress(uint8_t * reg, uint32_t address)
+{
+	reg[0] = (uint8_t) address;
+	reg[1] = (uint8_t) (address >> 8);
+	reg[2] = (uint8_t) (address >> 16);
+}
+
+
+/*! \brief Test if a DMA address points into the I/O memory. */
+static bool SIM_DMA_IsRegister(uint32_t address)
+{
+	return (address >= SIM_IO_ADDRESS) && (address < SIM_IO_ADDRESS + SIM_IO_SIZE);
+}
+
+
+/*! \brief Check that a DMA address can be reached, abort if not. */
+static void SIM_DMA_CheckAddress(uint32_t address)
+{
+	extern char __executable_start;
+
+	if (SIM_DMA_IsRegister(address)) {
+		return;
+	}
+	if ((uintptr_t) &SIM_cycles > SIM_DMA_ADDR_MAX) {
+		fprintf(stderr, "sim: the DMA model needs a program linked with -no-pie\n");
+		abort();
+	}
+	if ((address < (uintptr_t) &__executable_start) || (address >= (uintptr_t) sbrk(0))) {
+		fprintf(stderr, "sim: DMA address 0x%06lx is not in static data or "
+		        "on the heap\n", (unsigned long) address);
+		abort();
+	}
+}
+
+
+/*! \brief Read a byte for a DMA transfer, with register side effects. */
+static uint8_t SIM_DMA_Load(uint32_t address)
+{
+	uint16_t offset = address - SIM_IO_ADDRESS;
+	uint8_t value;
+
+	if (!SIM_DMA_IsRegister(address)) {
+		return *(uint8_t *) (uintptr_t) address;
+	}
+	SIM_PreAccess(offset);
+	value = SIM_io[offset];
+	SIM_accessOld = value;
+	SIM_Access(offset, false);
+	return value;
+}
+
+
+/*! \brief Write a byte for a DMA transfer, with register side effects. */
+static void SIM_DMA_Store(uint32_t address, uint8_t value)
+{
+	uint16_t offset = address - SIM_IO_ADDRESS;
+
+	if (!SIM_DMA_IsRegister(address)) {
+		*(uint8_t *) (uintptr_t) address = value;
+		return;
+	}
+	SIM_PreAccess(offset);
+	SIM_accessOld = SIM_io[offset];
+	SIM_io[offset] = value;
+	SIM_Access(offset, true);
+}
+
+
+/*! \brief Step an address in the given direction (fixed, increment, decrement). */
+static uint32_t SIM_DMA_Step(uint32_t address, uint8_t dir)
+{
+	if (dir == 1) {
+		address++;
+	} else if (dir == 2) {
+		address--;
+	}
+	return address & SIM_DMA_ADDR_MAX;
+}
+
+
+/*! \brief Test if the trigger source of a DMA channel requests a transfer.
+ *
+ *  Of the peripheral triggers, the Timer/Counter capture and the USART
+ *  triggers are modelled here. They follow the capture flags, RXCIF and
+ *  DREIF, which the transfer itself clears by reading or writing the data
+ *  register. Event triggers are noted by SIM_EVSYS_Channel(), and SPI and
+ *  Timer/Counter overflow triggers by SIM_DMA_Request().
+ */
+static bool SIM_DMA_Triggered(uint8_t trigsrc)
+{
+	uint8_t port = (trigsrc >> 5) - 2;
+	uint8_t source = trigsrc & 0x1F;
+	uint16_t offset;
+	uint8_t status;
+
+	if ((port <= 3) && (source >= 0x02) && (source <= 0x05)) {
+		/* Capture channel of TCx0, requesting while its flag is set. */
+		const SIM_TC_t * t = &SIM_tc[port];
+		uint8_t channel = source - 0x02;
+
+		return SIM_TC_IsCapture(t, channel) &&
+		       (SIM_io[t->offset + SIM_TC_INTFLAGS] & (TC0_CCAIF_bm << channel));
+	}
+	if ((port > 3) || (source < 0x0B) || (source == 0x0D) || (source > 0x0F)) {
+		return false;
+	}
+
+	/* USARTx0 or USARTx1 of PORTC, D, E or F. */
+	offset = 0x08A0 + port * 0x0100 + ((source >= 0x0E) ? 0x10 : 0);
+	status = SIM_io[offset + SIM_USART_STATUS];
+	if ((source == 0x0B) || (source == 0x0E)) {
+		return (status & USART_RXCIF_bm) != 0;
+	}
+	return (status & USART_DREIF_bm) != 0;
+}
+
+
+/*! \brief Note a transfer request on the channels using a trigger source.
+ *
+ *  Used for the trigger sources that request once per transfer, like the
+ *  SPI transfer complete or the Timer/Counter overflow, rather than while a
+ *  flag is set. Each enabled
+ *  channel using the source gets one request.
+ */
+static void SIM_DMA_Request(uint8_t trigsrc)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+		const uint8_t * ch = &SIM_io[SIM_dma[i].offset];
+
+		if ((ch[SIM_DMA_CTRLA] & DMA_CH_ENABLE_bm) && (ch[SIM_DMA_TRIGSRC] == trigsrc)) {
+			SIM_DMA_NoteRequest(&SIM_dma[i]);
+		}
+	}
+}
+
+
+/*! \brief Note a request of an event channel or of a trigger source that
+ *         requests once per transfer on a DMA channel.
+ *
+ *  A request noted while an earlier one has not been served is lost.
+ */
+static void SIM_DMA_NoteRequest(SIM_DMA_CH_t * c)
+{
+	if (!c->eventRequest) {
+		c->eventRequest = true;
+		c->requestTime = SIM_cycles;
+	}
+}
+
+
+/*! \brief Time the request noted on a DMA channel is served.
+ *
+ *  The burst completes SIM_dmaLatency cycles after the request, or after
+ *  the previous delayed burst, whichever is later.
+ */
+static uint64_t SIM_DMA_Due(const SIM_DMA_CH_t * c)
+{
+	uint64_t from = (c->requestTime > SIM_dmaFree) ? c->requestTime : SIM_dmaFree;
+
+	return from + SIM_dmaLatency;
+}
+
+
+/*! \brief Test if a DMA channel has a noted request waiting for its time. */
+static bool SIM_DMA_IsWaiting(const SIM_DMA_CH_t * c)
+{
+	return (SIM_io[SIM_DMA_OFFSET + SIM_DMA_CTRL] & DMA_ENABLE_bm) &&
+	       (SIM_io[c->offset + SIM_DMA_CTRLA] & DMA_CH_ENABLE_bm) && c->eventRequest;
+}
+
+
+/*! \brief Update the DMA INTFLAGS and STATUS registers from the channels. */
+static void SIM_DMA_UpdateStatus(void)
+{
+	uint8_t intflags = 0;
+	uint8_t status = 0;
+	uint8_t i;
+
+	for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+		const uint8_t * ch = &SIM_io[SIM_dma[i].offset];
+
+		if (ch[SIM_DMA_CTRLB] & DMA_CH_TRNIF_bm) {
+			intflags |= DMA_CH0TRNIF_bm << i;
+		}
+		if (ch[SIM_DMA_CTRLB] & DMA_CH_ERRIF_bm) {
+			intflags |= DMA_CH0ERRIF_bm << i;
+		}
+		if (ch[SIM_DMA_CTRLA] & DMA_CH_ENABLE_bm) {
+			status |= DMA_CH0BUSY_bm << i;
+		}
+	}
+	SIM_io[SIM_DMA_OFFSET + SIM_DMA_INTFLAGS] = intflags;
+	SIM_io[SIM_DMA_OFFSET + SIM_DMA_STATUS] = status;
+}
+
+
+/*! \brief A DMA channel has been enabled: start a transaction. */
+static void SIM_DMA_Start(SIM_DMA_CH_t * c)
+{
+	uint8_t * ch = &SIM_io[c->offset];
+
+	c->srcTransaction = SIM_DMA_GetAddress(&ch[SIM_DMA_SRCADDR]);
+	c->destTransaction = SIM_DMA_GetAddress(&ch[SIM_DMA_DESTADDR]);
+	c->srcBlock = c->srcTransaction;
+	c->destBlock = c->destTransaction;
+	c->blockSize = ch[SIM_DMA_TRFCNT] | (ch[SIM_DMA_TRFCNT + 1] << 8);
+
+	SIM_DMA_CheckAddress(c->srcTransaction);
+	SIM_DMA_CheckAddress(c->destTransaction);
+}
+
+
+/*! \brief The last burst of a block has been transferred.
+ *
+ *  The channel is disabled and TRNIF set at the end of the transaction. In
+ *  repeat mode, the transaction ends when REPCNT counts down to zero; with
+ *  REPCNT zero it never ends, and TRNIF is set after each block. TRFCNT is
+ *  reloaded at the end of every block.
+ */
+static void SIM_DMA_BlockDone(SIM_DMA_CH_t * c)
+{
+	uint8_t * ch = &SIM_io[c->offset];
+	uint8_t addrctrl = ch[SIM_DMA_ADDRCTRL];
+	uint8_t srcReload = addrctrl & DMA_CH_SRCRELOAD_gm;
+	uint8_t destReload = addrctrl & DMA_CH_DESTRELOAD_gm;
+	bool done = true;
+
+	ch[SIM_DMA_TRFCNT] = (uint8_t) c->blockSize;
+	ch[SIM_DMA_TRFCNT + 1] = (uint8_t) (c->blockSize >> 8);
+
+	if (ch[SIM_DMA_CTRLA] & DMA_CH_REPEAT_bm) {
+		if (ch[SIM_DMA_REPCNT] == 0) {
+			done = false;
+		} else if (--ch[SIM_DMA_REPCNT] != 0) {
+			done = false;
+		}
+	}
+
+	if (srcReload == DMA_CH_SRCRELOAD_BLOCK_gc) {
+		SIM_DMA_SetAddress(&ch[SIM_DMA_SRCADDR], c->srcBlock);
+	} else if (done && (srcReload == DMA_CH_SRCRELOAD_TRANSACTION_gc)) {
+		SIM_DMA_SetAddress(&ch[SIM_DMA_SRCADDR], c->srcTransaction);
+	}
+	if (destReload == DMA_CH_DESTRELOAD_BLOCK_gc) {
+		SIM_DMA_SetAddress(&ch[SIM_DMA_DESTADDR], c->destBlock);
+	} else if (done && (destReload == DMA_CH_DESTRELOAD_TRANSACTION_gc)) {
+		SIM_DMA_SetAddress(&ch[SIM_DMA_DESTADDR], c->destTransaction);
+	}
+	c->srcBlock = SIM_DMA_GetAddress(&ch[SIM_DMA_SRCADDR]);
+	c->destBlock = SIM_DMA_GetAddress(&ch[SIM_DMA_DESTADDR]);
+
+	if (done) {
+		ch[SIM_DMA_CTRLA] &= ~(DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm);
+	}
+	if (done || (ch[SIM_DMA_REPCNT] == 0)) {
+		ch[SIM_DMA_CTRLB] |= DMA_CH_TRNIF_bm;
+	}
+}
+
+
+/*! \brief Transfer one burst on a DMA channel.
+ *
+ *  \return  True if the burst completed a block.
+ */
+static bool SIM_DMA_Burst(SIM_DMA_CH_t * c)
+{
+	uint8_t * ch = &SIM_io[c->offset];
+	uint8_t addrctrl = ch[SIM_DMA_ADDRCTRL];
+	uint32_t src = SIM_DMA_GetAddress(&ch[SIM_DMA_SRCADDR]);
+	uint32_t dest = SIM_DMA_GetAddress(&ch[SIM_DMA_DESTADDR]);
+	uint32_t count = ch[SIM_DMA_TRFCNT] | (ch[SIM_DMA_TRFCNT + 1] << 8);
+	uint8_t burst = 1 << (ch[SIM_DMA_CTRLA] & DMA_CH_BURSTLEN_gm);
+	uint8_t i;
+
+	/* A block size of zero is 64 kB. */
+	if (count == 0) {
+		count = 0x10000;
+	}
+
+	c->srcBurst = src;
+	c->destBurst = dest;
+	for (i = 0; (i < burst) && (count != 0); i++) {
+		SIM_DMA_Store(dest, SIM_DMA_Load(src));
+		src = SIM_DMA_Step(src, (addrctrl & DMA_CH_SRCDIR_gm) >> DMA_CH_SRCDIR_gp);
+		dest = SIM_DMA_Step(dest, (addrctrl & DMA_CH_DESTDIR_gm) >> DMA_CH_DESTDIR_gp);
+		count--;
+	}
+
+	if ((addrctrl & DMA_CH_SRCRELOAD_gm) == DMA_CH_SRCRELOAD_BURST_gc) {
+		src = c->srcBurst;
+	}
+	if ((addrctrl & DMA_CH_DESTRELOAD_gm) == DMA_CH_DESTRELOAD_BURST_gc) {
+		dest = c->destBurst;
+	}
+	SIM_DMA_SetAddress(&ch[SIM_DMA_SRCADDR], src);
+	SIM_DMA_SetAddress(&ch[SIM_DMA_DESTADDR], dest);
+	ch[SIM_DMA_TRFCNT] = (uint8_t) count;
+	ch[SIM_DMA_TRFCNT + 1] = (uint8_t) (count >> 8);
+
+	if (count == 0) {
+		SIM_DMA_BlockDone(c);
+		return true;
+	}
+	return false;
+}
+
+
+/*! \brief Run the DMA channels until no channel has a transfer request.
+ *
+ *  A triggered channel transfers one burst in single shot mode, otherwise a
+ *  whole block. Channel 0 has the highest priority; after each transfer the
+ *  search starts again from channel 0. Transfers take no simulated time,
+ *  but a request noted by SIM_DMA_NoteRequest() waits until it is due.
+ */
+static void SIM_DMA_Service(void)
+{
+	static bool active;
+	uint32_t bursts = 0;
+	uint8_t i = 0;
+
+	if (active || !(SIM_io[SIM_DMA_OFFSET + SIM_DMA_CTRL] & DMA_ENABLE_bm)) {
+		return;
+	}
+
+	/* The transfers access registers, which would call this again. */
+	active = true;
+	while (i < SIM_DMA_CH_COUNT) {
+		SIM_DMA_CH_t * c = &SIM_dma[i];
+		uint8_t * ch = &SIM_io[c->offset];
+
+		bool noted = c->eventRequest && (SIM_DMA_Due(c) <= SIM_cycles);
+
+		if (!(ch[SIM_DMA_CTRLA] & DMA_CH_ENABLE_bm) ||
+		    !((ch[SIM_DMA_CTRLA] & DMA_CH_TRFREQ_bm) || noted ||
+		      SIM_DMA_Triggered(ch[SIM_DMA_TRIGSRC]))) {
+			i++;
+			continue;
+		}
+
+		if (noted) {
+			SIM_dmaFree = SIM_DMA_Due(c);
+		}
+		ch[SIM_DMA_CTRLA] &= ~DMA_CH_TRFREQ_bm;
+		c->eventRequest = false;
+		if (ch[SIM_DMA_CTRLA] & DMA_CH_SINGLE_bm) {
+			SIM_DMA_Burst(c);
+			bursts++;
+		} else {
+			do {
+				bursts++;
+			} while (!SIM_DMA_Burst(c));
+		}
+
+		if (bursts > SIM_DMA_RUNAWAY) {
+			fprintf(stderr, "sim: DMA channel %u is triggered forever\n", i);
+			abort();
+		}
+		SIM_DMA_UpdateStatus();
+		i = 0;
+	}
+	active = false;
+}
+
+
+/*! \brief Apply the side effects of a DMA register access. */
+static void SIM_DMA_Access(uint16_t offset, bool write)
+{
+	uint8_t * reg = &SIM_io[offset];
+	uint8_t i;
+
+	if (!write) {
+		return;
+	}
+
+	if (offset == SIM_DMA_OFFSET + SIM_DMA_CTRL) {
+		if (*reg & DMA_RESET_bm) {
+			memset(&SIM_io[SIM_DMA_OFFSET], 0, SIM_DMA_LAST - SIM_DMA_OFFSET + 1);
+		}
+	} else if (offset == SIM_DMA_OFFSET + SIM_DMA_INTFLAGS) {
+		/* Writing one clears the flag in the channel as well. */
+		for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+			uint8_t * ctrlb = &SIM_io[SIM_dma[i].offset + SIM_DMA_CTRLB];
+
+			if (*reg & (DMA_CH0TRNIF_bm << i)) {
+				*ctrlb &= ~DMA_CH_TRNIF_bm;
+			}
+			if (*reg & (DMA_CH0ERRIF_bm << i)) {
+				*ctrlb &= ~DMA_CH_ERRIF_bm;
+			}
+		}
+	} else if (offset >= SIM_DMA_CH_FIRST) {
+		SIM_DMA_CH_t * c = &SIM_dma[(offset - SIM_DMA_CH_FIRST) / sizeof(DMA_CH_t)];
+		uint8_t flags = DMA_CH_TRNIF_bm | DMA_CH_ERRIF_bm;
+
+		switch ((offset - SIM_DMA_CH_FIRST) % sizeof(DMA_CH_t)) {
+		case SIM_DMA_CTRLA:
+			if (*reg & DMA_CH_RESET_bm) {
+				memset(&SIM_io[c->offset], 0, sizeof(DMA_CH_t));
+				c->eventRequest = false;
+			} else if ((*reg & DMA_CH_ENABLE_bm) &&
+			           !(SIM_accessOld & DMA_CH_ENABLE_bm)) {
+				SIM_DMA_Start(c);
+			}
+			break;
+		case SIM_DMA_CTRLB:
+			/* The flags are cleared by writing one, the busy bits are read-only. */
+			*reg = (*reg & (DMA_CH_ERRINTLVL_gm | DMA_CH_TRNINTLVL_gm)) |
+			       (SIM_accessOld & flags & ~(*reg & flags)) |
+			       (SIM_accessOld & (DMA_CH_CHBUSY_bm | DMA_CH_CHPEND_bm));
+			break;
+		default:
+			break;
+		}
+	}
+	SIM_DMA_UpdateStatus();
+}
+
+
+/*! \brief Apply the side effects of a register access.
+ *
+ *  The access may trigger DMA transfers, which are run before returning.
+ */
+static void SIM_Access(uint16_t offset, bool write)
+{
+	SIM_USART_t * u;
+	SIM_SPI_t * s;
+	SIM_TC_t * t;
+	SIM_AC_t * a;
+	SIM_TWI_t * w;
+	SIM_ADC_t * d;
+
+	if (offset == SIM_PMIC_OFFSET) {
+		SIM_io[SIM_PMIC_OFFSET] = SIM_pmicStatus;
+	} else if ((offset == SIM_CCP_OFFSET) && write) {
+		if (SIM_io[offset] == CCP_IOREG_gc) {
+			SIM_ccpTime = SIM_cycles;
+		}
+		SIM_io[offset] = 0;
+	} else if ((offset >= SIM_VPORT_FIRST) && (offset <= SIM_VPORT_LAST)) {
+		SIM_VPORT_Access(offset, write);
+	} else if ((offset >= SIM_CLK_OFFSET) && (offset < SIM_OSC_OFFSET)) {
+		SIM_CLK_Access(offset - SIM_CLK_OFFSET, write);
+	} else if ((offset >= SIM_OSC_OFFSET) && (offset <= SIM_OSC_OFFSET + SIM_OSC_DFLLCTRL)) {
+		SIM_OSC_Access(offset - SIM_OSC_OFFSET, write);
+	} else if ((offset >= SIM_DFLL_OFFSET) && (offset <= SIM_DFLL_LAST)) {
+		SIM_DFLL_Access(offset, write);
+	} else if ((offset >= SIM_WDT_OFFSET) && (offset <= SIM_WDT_OFFSET + SIM_WDT_STATUS)) {
+		SIM_WDT_Access(offset - SIM_WDT_OFFSET, write);
+	} else if ((offset == SIM_RST_OFFSET) && write) {
+		/* The reset flags are cleared by writing one. */
+		SIM_io[offset] = SIM_accessOld & ~SIM_io[offset];
+	} else if ((offset >= SIM_DMA_OFFSET) && (offset <= SIM_DMA_LAST)) {
+		SIM_DMA_Access(offset, write);
+	} else if ((offset >= SIM_EVSYS_OFFSET) && (offset <= SIM_EVSYS_LAST)) {
+		SIM_EVSYS_Access(offset, write);
+	} else if ((offset >= SIM_RTC_OFFSET) && (offset <= SIM_RTC_LAST)) {
+		SIM_RTC_Access(offset - SIM_RTC_OFFSET, write);
+	} else if ((offset >= SIM_RTC32_OFFSET) && (offset <= SIM_RTC32_LAST)) {
+		SIM_RTC32_Access(offset - SIM_RTC32_OFFSET, write);
+	} else if ((offset >= SIM_VBAT_OFFSET) && (offset <= SIM_VBAT_LAST)) {
+		SIM_VBAT_Access(offset - SIM_VBAT_OFFSET, write);
+	} else if ((t = SIM_TC_Find(offset)) != NULL) {
+		SIM_TC_Access(t, offset - t->offset, write);
+	} else if ((t = SIM_AWEX_Find(offset)) != NULL) {
+		SIM_AWEX_Access(t, offset - t->offset - SIM_AWEX_OFFSET, write);
+	} else if ((offset >= SIM_PORT_FIRST) && (offset <= SIM_PORT_LAST)) {
+		SIM_PORT_Access(offset, write);
+	} else if ((a = SIM_AC_Find(offset)) != NULL) {
+		SIM_AC_Access(a, offset - a->offset, write);
+	} else if ((u = SIM_USART_Find(offset)) != NULL) {
+		SIM_USART_Access(u, offset - u->offset, write);
+	} else if ((s = SIM_SPI_Find(offset)) != NULL) {
+		SIM_SPI_Access(s, offset - s->offset, write);
+	} else if ((w = SIM_TWI_Find(offset)) != NULL) {
+		SIM_TWI_Access(w, offset - w->offset, write);
+	} else if ((d = SIM_ADC_Find(offset)) != NULL) {
+		SIM_ADC_Access(d, offset - d->offset, write);
+	} else if ((offset >= SIM_AES_OFFSET) && (offset <= SIM_AES_LAST)) {
+		SIM_AES_Access(offset - SIM_AES_OFFSET, write);
+	} else if ((offset >= SIM_NVM_OFFSET) && (offset <= SIM_NVM_LAST)) {
+		SIM_NVM_Access(offset - SIM_NVM_OFFSET, write);
+	}
+	SIM_DMA_Service();
+}
+
+
+/*! \brief Time of the next module event, UINT64_MAX if none. */
+static uint64_t SIM_NextEvent(void)
+{
+	uint64_t next = UINT64_MAX;
+	uint8_t i;
+
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		SIM_USART_t * u = &SIM_usart[i];
+
+		if (u->txBusy && (u->txDone < next)) {
+			next = u->txDone;
+		}
+		if ((u->rxLineCount != 0) && !SIM_USART_IsMasterSpi(u) && (u->rxLineDone < next)) {
+			next = u->rxLineDone;
+		}
+		if ((u->rxdBits != 0) && (SIM_USART_RxdNext(u) < next)) {
+			next = SIM_USART_RxdNext(u);
+		}
+		if ((u->edgeCount != 0) && (u->edgeTime < next)) {
+			next = u->edgeTime;
+		}
+		if (u->sampling && (SIM_USART_SampleNext(u) < next)) {
+			next = SIM_USART_SampleNext(u);
+		}
+	}
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		uint64_t tcNext = SIM_TC_NextEvent(&SIM_tc[i]);
+
+		if (tcNext < next) {
+			next = tcNext;
+		}
+	}
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		const SIM_SPI_t * s = &SIM_spi[i];
+
+		if (s->busy && (s->txDone < next)) {
+			next = s->txDone;
+		}
+		if (SIM_SPI_SlavePending(s) && (SIM_SPI_SlaveLoadTime(s) < next)) {
+			next = SIM_SPI_SlaveLoadTime(s);
+		}
+	}
+	for (i = 0; i < SIM_AC_COUNT; i++) {
+		uint64_t acNext = SIM_AC_NextSample(&SIM_ac[i]);
+
+		if (acNext < next) {
+			next = acNext;
+		}
+	}
+	for (i = 0; i < SIM_TWI_COUNT; i++) {
+		if (SIM_TWI_IsClocking(&SIM_twi[i]) && (SIM_twi[i].done < next)) {
+			next = SIM_twi[i].done;
+		}
+	}
+	for (i = 0; i < SIM_ADC_COUNT * SIM_ADC_CH_COUNT; i++) {
+		if (SIM_adc[i / SIM_ADC_CH_COUNT].done[i % SIM_ADC_CH_COUNT] < next) {
+			next = SIM_adc[i / SIM_ADC_CH_COUNT].done[i % SIM_ADC_CH_COUNT];
+		}
+	}
+	if (SIM_aes.busy && (SIM_aes.done < next)) {
+		next = SIM_aes.done;
+	}
+	if (SIM_CLK_NsToCycles(SIM_nvmDone) < next) {
+		next = SIM_CLK_NsToCycles(SIM_nvmDone);
+	}
+	for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+		if (SIM_DMA_IsWaiting(&SIM_dma[i]) && (SIM_DMA_Due(&SIM_dma[i]) < next)) {
+			next = SIM_DMA_Due(&SIM_dma[i]);
+		}
+	}
+	for (i = 0; i < SIM_DFLL_COUNT; i++) {
+		if (SIM_CLK_NsToCycles(SIM_dfllNext[i]) < next) {
+			next = SIM_CLK_NsToCycles(SIM_dfllNext[i]);
+		}
+	}
+	if (SIM_CLK_NsToCycles(SIM_RTC_TickNs(SIM_rtcTicks + 1)) < next) {
+		next = SIM_CLK_NsToCycles(SIM_RTC_TickNs(SIM_rtcTicks + 1));
+	}
+	if (SIM_WDT_Timeout() < next) {
+		next = SIM_WDT_Timeout();
+	}
+	return next;
+}
+
+
+/*! \brief Process the module events that are due. */
+static void SIM_ProcessEvents(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		SIM_USART_t * u = &SIM_usart[i];
+
+		if (u->txBusy && (u->txDone <= SIM_cycles)) {
+			SIM_USART_TransmitDone(u);
+		}
+		if ((u->rxLineCount != 0) && !SIM_USART_IsMasterSpi(u) &&
+		    (u->rxLineDone <= SIM_cycles)) {
+			SIM_USART_LineDone(u);
+		}
+		SIM_USART_UpdateRxd(u);
+		SIM_USART_UpdateEdges(u);
+	}
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		SIM_TC_Sync(&SIM_tc[i]);
+	}
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		SIM_SPI_t * s = &SIM_spi[i];
+
+		if (s->busy && (s->txDone <= SIM_cycles)) {
+			SIM_SPI_TransferDone(s);
+		}
+		if (SIM_SPI_SlavePending(s) && (SIM_SPI_SlaveLoadTime(s) <= SIM_cycles)) {
+			SIM_SPI_SlaveLoad(s);
+		}
+	}
+	for (i = 0; i < SIM_AC_COUNT; i++) {
+		SIM_AC_UpdateTraces(&SIM_ac[i]);
+	}
+	for (i = 0; i < SIM_TWI_COUNT; i++) {
+		SIM_TWI_t * w = &SIM_twi[i];
+
+		if (SIM_TWI_IsClocking(w) && (w->done <= SIM_cycles)) {
+			SIM_TWI_PhaseDone(w);
+		}
+	}
+	for (i = 0; i < SIM_ADC_COUNT * SIM_ADC_CH_COUNT; i++) {
+		if (SIM_adc[i / SIM_ADC_CH_COUNT].done[i % SIM_ADC_CH_COUNT] <= SIM_cycles) {
+			SIM_ADC_Done(&SIM_adc[i / SIM_ADC_CH_COUNT], i % SIM_ADC_CH_COUNT);
+		}
+	}
+	if (SIM_aes.busy && (SIM_aes.done <= SIM_cycles)) {
+		SIM_AES_Done();
+	}
+	SIM_NVM_Update();
+	SIM_DFLL_Update();
+	SIM_RTC_Sync();
+	SIM_RTC32_Sync();
+	SIM_DMA_Service();
+	if (SIM_WDT_Timeout() <= SIM_cycles) {
+		SIM_Reset(RST_WDRF_bm);
+	}
+}
+
+
+/*! \brief Advance time, processing module events and interrupts on the way. */
+static void SIM_Advance(uint32_t cycles)
+{
+	uint64_t target = SIM_cycles + cycles;
+	uint64_t next;
+
+	/* ISRs dispatched on the way advance time themselves. */
+	while ((next = SIM_NextEvent()) <= ((target > SIM_cycles) ? target : SIM_cycles)) {
+		if (next > SIM_cycles) {
+			SIM_cycles = next;
+		}
+		SIM_ProcessEvents();
+		SIM_Dispatch();
+	}
+	if (target > SIM_cycles) {
+		SIM_cycles = target;
+	}
+}
+
+
+/*! \brief Note when a vector becomes pending, for the latency. */
+static void SIM_SetPending(uint8_t vectorNum, bool pending)
+{
+	if (!pending) {
+		SIM_pendingSince[vectorNum] = SIM_NOT_PENDING;
+	} else if (SIM_pendingSince[vectorNum] == SIM_NOT_PENDING) {
+		SIM_pendingSince[vectorNum] = SIM_cycles;
+	}
+}
+
+
+/*! \brief Get the level of a USART interrupt source, 0 if not requested.
+ *
+ *  \param index  USART number times three plus the SIM_USART_Source_t.
+ */
+static uint8_t SIM_USART_Level(uint8_t index)
+{
+	const SIM_USART_t * u = &SIM_usart[index / 3];
+	uint8_t status = SIM_io[u->offset + SIM_USART_STATUS];
+	uint8_t ctrla = SIM_io[u->offset + SIM_USART_CTRLA];
+
+	switch (index % 3) {
+	case SIM_USART_RXC:
+		return (status & USART_RXCIF_bm) ?
+		       (ctrla & USART_RXCINTLVL_gm) >> USART_RXCINTLVL_gp : 0;
+	case SIM_USART_DRE:
+		return (status & USART_DREIF_bm) ?
+		       (ctrla & USART_DREINTLVL_gm) >> USART_DREINTLVL_gp : 0;
+	default:
+		return (status & USART_TXCIF_bm) ?
+		       (ctrla & USART_TXCINTLVL_gm) >> USART_TXCINTLVL_gp : 0;
+	}
+}
+
+
+/*! \brief A USART interrupt is taken: TXCIF is cleared by the vector. */
+static void SIM_USART_Taken(uint8_t index)
+{
+	if (index % 3 == SIM_USART_TXC) {
+		SIM_io[SIM_usart[index / 3].offset + SIM_USART_STATUS] &= ~USART_TXCIF_bm;
+	}
+}
+
+
+/*! \brief Get the level of a Timer/Counter interrupt, 0 if not requested.
+ *
+ *  \param index  Timer/Counter number times SIM_TC_SOURCES plus the source
+ *                number in vector order.
+ */
+static uint8_t SIM_TC_Level(uint8_t index)
+{
+	const uint8_t * tc = &SIM_io[SIM_tc[index / SIM_TC_SOURCES].offset];
+	uint8_t source = index % SIM_TC_SOURCES;
+	/* Two level bits per source, in vector order. */
+	uint16_t intctrl = tc[SIM_TC_INTCTRLA] | (tc[SIM_TC_INTCTRLB] << 4);
+
+	if (!(tc[SIM_TC_INTFLAGS] & SIM_tcFlag[source])) {
+		return 0;
+	}
+	return (intctrl >> (2 * source)) & 0x03;
+}
+
+
+/*! \brief A Timer/Counter interrupt is taken: its flag is cleared by the vector. */
+static void SIM_TC_Taken(uint8_t index)
+{
+	SIM_io[SIM_tc[index / SIM_TC_SOURCES].offset + SIM_TC_INTFLAGS] &=
+		~SIM_tcFlag[index % SIM_TC_SOURCES];
+}
+
+
+/*! \brief Get the level of an SPI interrupt, 0 if not requested.
+ *
+ *  \param index  SPI module number.
+ */
+static uint8_t SIM_SPI_Level(uint8_t index)
+{
+	const uint8_t * spi = &SIM_io[SIM_spi[index].offset];
+
+	return (spi[SIM_SPI_STATUS] & SPI_IF_bm) ? (spi[SIM_SPI_INTCTRL] & SPI_INTLVL_gm) : 0;
+}
+
+
+/*! \brief An SPI interrupt is taken: IF is cleared by the vector. */
+static void SIM_SPI_Taken(uint8_t index)
+{
+	SIM_io[SIM_spi[index].offset + SIM_SPI_STATUS] &= ~SPI_IF_bm;
+	SIM_spi[index].ifRead = false;
+}
+
+
+/*! \brief Get the level of a port interrupt, 0 if not requested.
+ *
+ *  \param index  Port number times two plus the interrupt number.
+ */
+static uint8_t SIM_PORT_Level(uint8_t index)
+{
+	const uint8_t * port = &SIM_io[SIM_PORT_FIRST + (index / 2) * SIM_PORT_SIZE];
+	uint8_t interrupt = index % 2;
+
+	if (!(port[SIM_PORT_INTFLAGS] & (PORT_INT0IF_bm << interrupt))) {
+		return 0;
+	}
+	return (port[SIM_PORT_INTCTRL] >> (2 * interrupt)) & 0x03;
+}
+
+
+/*! \brief A port interrupt is taken: its flag is cleared by the vector. */
+static void SIM_PORT_Taken(uint8_t index)
+{
+	SIM_io[SIM_PORT_FIRST + (index / 2) * SIM_PORT_SIZE + SIM_PORT_INTFLAGS] &=
+		~(PORT_INT0IF_bm << (index % 2));
+}
+
+
+/*! \brief Get the level of an Analog Comparator interrupt, 0 if not requested.
+ *
+ *  \param index  Analog Comparator number times three plus 0 for AC0, 1 for
+ *                AC1 and 2 for the window.
+ */
+static uint8_t SIM_AC_Level(uint8_t index)
+{
+	const uint8_t * ac = &SIM_io[SIM_ac[index / 3].offset];
+	uint8_t source = index % 3;
+
+	if (!(ac[SIM_AC_STATUS] & (AC_AC0IF_bm << source))) {
+		return 0;
+	}
+	if (source == 2) {
+		return (ac[SIM_AC_WINCTRL] & AC_WINTLVL_gm) >> AC_WINTLVL_gp;
+	}
+	return (ac[SIM_AC_AC0CTRL + source] & AC_INTLVL_gm) >> AC_INTLVL_gp;
+}
+
+
+/*! \brief An Analog Comparator interrupt is taken: its flag is cleared. */
+static void SIM_AC_Taken(uint8_t index)
+{
+	SIM_io[SIM_ac[index / 3].offset + SIM_AC_STATUS] &= ~(AC_AC0IF_bm << (index % 3));
+}
+
+
+/*! \brief Get the level of a DMA channel interrupt, 0 if not requested.
+ *
+ *  \param index  Channel number.
+ */
+static uint8_t SIM_DMA_Level(uint8_t index)
+{
+	uint8_t ctrlb = SIM_io[SIM_dma[index].offset + SIM_DMA_CTRLB];
+	uint8_t level = 0;
+
+	if (ctrlb & DMA_CH_TRNIF_bm) {
+		level = (ctrlb & DMA_CH_TRNINTLVL_gm) >> DMA_CH_TRNINTLVL_gp;
+	}
+	if ((ctrlb & DMA_CH_ERRIF_bm) &&
+	    (((ctrlb & DMA_CH_ERRINTLVL_gm) >> DMA_CH_ERRINTLVL_gp) > level)) {
+		level = (ctrlb & DMA_CH_ERRINTLVL_gm) >> DMA_CH_ERRINTLVL_gp;
+	}
+	return level;
+}
+
+
+/*! \brief Get the level of a TWI interrupt, 0 if not requested.
+ *
+ *  \param index  TWI module number times two, plus one for the master.
+ */
+static uint8_t SIM_TWI_Level(uint8_t index)
+{
+	const uint8_t * twi = &SIM_io[SIM_twi[index / 2].offset];
+
+	if (index % 2 == 0) {
+		uint8_t ctrla = twi[SIM_TWIS_CTRLA];
+		uint8_t status = twi[SIM_TWIS_STATUS];
+
+		if (((status & TWI_SLAVE_DIF_bm) && (ctrla & TWI_SLAVE_DIEN_bm)) ||
+		    ((status & TWI_SLAVE_APIF_bm) && (ctrla & TWI_SLAVE_APIEN_bm))) {
+			return (ctrla & TWI_SLAVE_INTLVL_gm) >> TWI_SLAVE_INTLVL_gp;
+		}
+	} else {
+		uint8_t ctrla = twi[SIM_TWIM_CTRLA];
+		uint8_t status = twi[SIM_TWIM_STATUS];
+
+		if (((status & TWI_MASTER_WIF_bm) && (ctrla & TWI_MASTER_WIEN_bm)) ||
+		    ((status & TWI_MASTER_RIF_bm) && (ctrla & TWI_MASTER_RIEN_bm))) {
+			return (ctrla & TWI_MASTER_INTLVL_gm) >> TWI_MASTER_INTLVL_gp;
+		}
+	}
+	return 0;
+}
+
+
+/*! \brief Get the level of the AES interrupt, 0 if not requested. */
+static uint8_t SIM_AES_Level(uint8_t index)
+{
+	const uint8_t * aes = &SIM_io[SIM_AES_OFFSET];
+
+	(void) index;
+	return (aes[SIM_AES_STATUS] & AES_SRIF_bm) ? (aes[SIM_AES_INTCTRL] & AES_INTLVL_gm) : 0;
+}
+
+
+/*! \brief The AES interrupt is taken: SRIF is cleared by the vector. */
+static void SIM_AES_Taken(uint8_t index)
+{
+	(void) index;
+	SIM_io[SIM_AES_OFFSET + SIM_AES_STATUS] &= ~AES_SRIF_bm;
+}
+
+
+/*! \brief Get the level of an ADC channel interrupt, 0 if not requested.
+ *
+ *  \param index  ADC number times SIM_ADC_CH_COUNT plus the channel number.
+ */
+static uint8_t SIM_ADC_Level(uint8_t index)
+{
+	const uint8_t * ch = &SIM_io[SIM_adc[index / SIM_ADC_CH_COUNT].offset + SIM_ADC_CH0 +
+	                             (index % SIM_ADC_CH_COUNT) * SIM_ADC_CH_SIZE];
+
+	if (!(ch[SIM_ADC_CH_INTFLAGS] & ADC_CH_CHIF_bm)) {
+		return 0;
+	}
+	return (ch[SIM_ADC_CH_INTCTRL] & ADC_CH_INTLVL_gm) >> ADC_CH_INTLVL_gp;
+}
+
+
+/*! \brief An ADC channel interrupt is taken: its flag is cleared by the vector. */
+static void SIM_ADC_Taken(uint8_t index)
+{
+	uint16_t offset = SIM_adc[index / SIM_ADC_CH_COUNT].offset;
+	uint8_t channel = index % SIM_ADC_CH_COUNT;
+
+	SIM_io[offset + SIM_ADC_CH0 + channel * SIM_ADC_CH_SIZE + SIM_ADC_CH_INTFLAGS] &=
+		~ADC_CH_CHIF_bm;
+	SIM_io[offset + SIM_ADC_INTFLAGS] &= ~(ADC_CH0IF_bm << channel);
+}
+
+
+/*! \brief Get the level of an NVM interrupt, 0 if not requested.
+ *
+ *  Both interrupts are level interrupts, requested as long as the NVM
+ *  controller is not busy.
+ *
+ *  \param index  0 for the EEPROM interrupt, 1 for the SPM interrupt.
+ */
+static uint8_t SIM_NVM_Level(uint8_t index)
+{
+	uint8_t intctrl = SIM_io[SIM_NVM_OFFSET + SIM_NVM_INTCTRL];
+
+	if (SIM_NVM_IsBusy()) {
+		return 0;
+	}
+	return (index == 0) ? (intctrl & NVM_EELVL_gm) >> NVM_EELVL_gp :
+	                      (intctrl & NVM_SPMLVL_gm) >> NVM_SPMLVL_gp;
+}
+
+
+/*! \brief Add an interrupt source, keeping the sources in vector order. */
+static void SIM_AddSource(uint8_t vectorNum, uint8_t index,
+                          uint8_t (* level)(uint8_t index),
+                          void (* taken)(uint8_t index))
+{
+	uint8_t i = SIM_sourceCount++;
+
+	while ((i > 0) && (SIM_source[i - 1].vectorNum > vectorNum)) {
+		SIM_source[i] = SIM_source[i - 1];
+		i--;
+	}
+	SIM_source[i].vectorNum = vectorNum;
+	SIM_source[i].index = index;
+	SIM_source[i].level = level;
+	SIM_source[i].taken = taken;
+}
+
+
+/*! \brief Execute the ISR of an interrupt source. */
+static void SIM_Execute(const SIM_Source_t * source, uint8_t levelMask)
+{
+	uint8_t vectorNum = source->vectorNum;
+	SIM_IrqStats_t * stats = &SIM_irqStats[vectorNum];
+	uint64_t latency = SIM_cycles - SIM_pendingSince[vectorNum];
+	uint64_t start = SIM_cycles;
+
+	if (SIM_isr[vectorNum] == NULL) {
+		/* The device would jump to an empty vector and restart. */
+		fprintf(stderr, "sim: no ISR for interrupt vector %u\n", vectorNum);
+		abort();
+	}
+
+	if (source->taken != NULL) {
+		source->taken(source->index);
+	}
+	SIM_pendingSince[vectorNum] = SIM_NOT_PENDING;
+
+	SIM_pmicStatus |= levelMask;
+	SIM_io[SIM_PMIC_OFFSET] = SIM_pmicStatus;
+
+	SIM_Advance(SIM_IRQ_ENTRY_CYCLES);
+	SIM_isr[vectorNum]();
+	SIM_Advance(SIM_IRQ_EXIT_CYCLES);
+
+	SIM_pmicStatus &= ~levelMask;
+	SIM_io[SIM_PMIC_OFFSET] = SIM_pmicStatus;
+
+	stats->count++;
+	stats->cycles += SIM_cycles - start;
+	stats->latencyTotal += latency;
+	if (latency > stats->latencyMax) {
+		stats->latencyMax = (uint32_t) latency;
+	}
+}
+
+
+/*! \brief Virtual PMIC: take pending interrupts until none can be taken. */
+static void SIM_Dispatch(void)
+{
+	for (;;) {
+		const SIM_Source_t * best = NULL;
+		uint8_t bestMask = 0;
+		uint8_t enabled = SIM_io[SIM_PMIC_OFFSET + 2];
+		uint8_t i;
+
+		for (i = 0; i < SIM_sourceCount; i++) {
+			const SIM_Source_t * source = &SIM_source[i];
+			uint8_t level = source->level(source->index);
+			uint8_t levelMask = (level != 0) ? (1 << (level - 1)) : 0;
+
+			SIM_SetPending(source->vectorNum, level != 0);
+
+			/* Taken if the level is enabled, above the executing
+			 * levels and, within a level, first in vector order. */
+			if ((levelMask & enabled) && (levelMask > SIM_pmicStatus) &&
+			    (levelMask > bestMask)) {
+				best = source;
+				bestMask = levelMask;
+			}
+		}
+
+		/* Interrupts are held off while a CCP signature is in effect. */
+		if ((best == NULL) || !(SIM_io[SIM_SREG_OFFSET] & CPU_I_bm) ||
+		    ((SIM_ccpTime != SIM_NOT_PENDING) &&
+		     (SIM_cycles - SIM_ccpTime <= SIM_CCP_CYCLES))) {
+			return;
+		}
+		SIM_Execute(best, bestMask);
+	}
+}
+
+
+/*! \brief SIGSEGV handler: start single-stepping a register access. */
+static void SIM_FaultHandler(int sig, siginfo_t * info, void * context)
+{
+	ucontext_t * uc = context;
+	uint8_t * address = info->si_addr;
+	int savedErrno = errno;
+
+	(void) sig;
+	if ((address < SIM_ioSpace) || (address >= SIM_ioSpace + SIM_IO_SIZE)) {
+		/* Not a register access; fault again without the handler. */
+		signal(SIGSEGV, SIG_DFL);
+		return;
+	}
+
+	SIM_accessOffset = address - SIM_ioSpace;
+	SIM_accessWrite = (uc->uc_mcontext.gregs[REG_ERR] & SIM_FAULT_WRITE) != 0;
+	SIM_PreAccess(SIM_accessOffset);
+	SIM_accessOld = SIM_io[SIM_accessOffset];
+	SIM_stepping = 1;
+
+	mprotect(SIM_ioSpace, SIM_IO_SIZE, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+	errno = savedErrno;
+}
+
+
+/*! \brief SIGTRAP handler: the register access has been executed. */
+static void SIM_StepHandler(int sig, siginfo_t * info, void * context)
+{
+	ucontext_t * uc = context;
+	int savedErrno = errno;
+
+	(void) info;
+	if (!SIM_stepping) {
+		signal(sig, SIG_DFL);
+		raise(sig);
+		return;
+	}
+
+	uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+	mprotect(SIM_ioSpace, SIM_IO_SIZE, PROT_NONE);
+	SIM_stepping = 0;
+
+	SIM_Access(SIM_accessOffset, SIM_accessWrite);
+	SIM_Advance(SIM_CYCLES_PER_ACCESS);
+	SIM_Dispatch();
+	errno = savedErrno;
+}
+
+
+/*! \brief Set the registers and the module states to their reset values.
+ *
+ *  The lines and traces driven from outside the device are kept.
+ */
+static void SIM_ResetValues(void)
+{
+	uint16_t i;
+
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		SIM_USART_t * u = &SIM_usart[i];
+
+		u->rxCount = 0;
+		u->txBusy = false;
+		u->txFull = false;
+		u->sampling = false;
+		SIM_io[u->offset + SIM_USART_STATUS] = USART_DREIF_bm;
+	}
+	for (i = 0; i < SIM_TC_COUNT; i++) {
+		SIM_tc[i].lastTick = SIM_cycles;
+		SIM_Set16(SIM_tc[i].offset + SIM_TC_PER, 0xFFFF);
+	}
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		SIM_spi[i].busy = false;
+		SIM_spi[i].ifRead = false;
+	}
+	for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+		SIM_dma[i].eventRequest = false;
+	}
+	for (i = 0; i < (SIM_PORT_LAST - SIM_PORT_FIRST + 1) / SIM_PORT_SIZE; i++) {
+		SIM_io[SIM_PORT_FIRST + i * SIM_PORT_SIZE + SIM_PORT_IN] = SIM_portInput[i];
+	}
+	/* Virtual ports 0 to 3 are mapped to PORTA to PORTD. */
+	SIM_io[SIM_VPCTRLA] = PORTCFG_VP1MAP_PORTB_gc | PORTCFG_VP0MAP_PORTA_gc;
+	SIM_io[SIM_VPCTRLA + 1] = PORTCFG_VP3MAP_PORTD_gc | PORTCFG_VP2MAP_PORTC_gc;
+	for (i = 0; i < _VECTORS_COUNT; i++) {
+		SIM_pendingSince[i] = SIM_NOT_PENDING;
+	}
+	SIM_pmicStatus = 0;
+	SIM_ccpTime = SIM_NOT_PENDING;
+
+	/* The device runs from the 2 MHz internal oscillator, with the factory
+	 * calibration. The drift of the oscillators is kept. */
+	SIM_io[SIM_OSC_OFFSET + SIM_OSC_CTRL] = OSC_RC2MEN_bm;
+	SIM_io[SIM_OSC_OFFSET + SIM_OSC_STATUS] = OSC_RC2MRDY_bm;
+	for (i = 0; i < SIM_DRIFT_COUNT; i++) {
+		SIM_oscCorrection[i] = 0;
+	}
+	for (i = 0; i < SIM_DFLL_COUNT; i++) {
+		SIM_dfllNext[i] = UINT64_MAX;
+	}
+	for (i = 0; i < SIM_TWI_COUNT; i++) {
+		SIM_twi[i].phase = SIM_TWI_IDLE;
+		SIM_twi[i].addressed = false;
+	}
+	for (i = 0; i < SIM_ADC_COUNT * SIM_ADC_CH_COUNT; i++) {
+		SIM_adc[i / SIM_ADC_CH_COUNT].done[i % SIM_ADC_CH_COUNT] = UINT64_MAX;
+	}
+	for (i = 0; i < SIM_ADC_COUNT; i++) {
+		SIM_adc[i].nextSlot = 0;
+	}
+	memset(&SIM_aes, 0, sizeof(SIM_aes));
+	/* An interrupted EEPROM write is not modelled: it completes at once. */
+	SIM_nvmDone = UINT64_MAX;
+	SIM_eeLoaded = 0;
+	memset(SIM_eeBuffer, 0xFF, sizeof(SIM_eeBuffer));
+	SIM_Set16(SIM_RTC_OFFSET + SIM_RTC_PER, 0xFFFF);
+	SIM_RTC_Restart();
+	SIM_rtcSynced = 0;
+	SIM_CLK_Update();
+}
+
+
+/*! \brief Set up the I/O memory and the trap handlers before main(). */
+__attribute__ ((constructor))
+static void SIM_Init(void)
+{
+	struct sigaction action;
+	uint16_t i;
+	int fd;
+
+	fd = memfd_create("xmega-io", 0);
+	if ((fd < 0) || (ftruncate(fd, SIM_IO_SIZE) != 0)) {
+		perror("sim: I/O memory");
+		exit(EXIT_FAILURE);
+	}
+	SIM_io = mmap(NULL, SIM_IO_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	SIM_ioSpace = mmap((void *) SIM_IO_ADDRESS, SIM_IO_SIZE, PROT_NONE,
+	                   MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+	close(fd);
+	if ((SIM_io == MAP_FAILED) || (SIM_ioSpace == MAP_FAILED)) {
+		perror("sim: I/O memory");
+		exit(EXIT_FAILURE);
+	}
+	if (SIM_ioSpace != (uint8_t *) SIM_IO_ADDRESS) {
+		/* Older kernels take the address as a hint only. */
+		fprintf(stderr, "sim: I/O memory not mapped at 0x%06lx\n", SIM_IO_ADDRESS);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Handlers nest when an ISR called from SIGTRAP accesses a register. */
+	memset(&action, 0, sizeof(action));
+	action.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sigemptyset(&action.sa_mask);
+	action.sa_sigaction = SIM_FaultHandler;
+	sigaction(SIGSEGV, &action, NULL);
+	action.sa_sigaction = SIM_StepHandler;
+	sigaction(SIGTRAP, &action, NULL);
+
+	/* The EEPROM is erased. */
+	memset(SIM_eeprom, 0xFF, sizeof(SIM_eeprom));
+	for (i = 0; i < SIM_USART_COUNT; i++) {
+		/* The receive lines are idle. */
+		SIM_USART_SetRxd(&SIM_usart[i], true);
+		SIM_usart[i].edgeLevel = true;
+	}
+	SIM_ResetValues();
+	SIM_io[SIM_RST_OFFSET] = RST_PORF_bm;
+	/* A fresh battery: the backup domain has had a power-on reset. */
+	SIM_io[SIM_VBAT_OFFSET + SIM_VBAT_STATUS] = VBAT_BBPORF_bm;
+	SIM_ClearStats();
+
+	for (i = 0; i < SIM_DMA_CH_COUNT; i++) {
+		SIM_AddSource(DMA_CH0_vect_num + i, i, SIM_DMA_Level, NULL);
+	}
+	for (i = 0; i < SIM_TC_COUNT * SIM_TC_SOURCES; i++) {
+		SIM_AddSource(SIM_tc[i / SIM_TC_SOURCES].ovfVector + i % SIM_TC_SOURCES, i,
+		              SIM_TC_Level, SIM_TC_Taken);
+	}
+	for (i = 0; i < SIM_USART_COUNT * 3; i++) {
+		SIM_AddSource(SIM_usart[i / 3].rxcVector + i % 3, i,
+		              SIM_USART_Level, SIM_USART_Taken);
+	}
+	for (i = 0; i < SIM_SPI_COUNT; i++) {
+		SIM_AddSource(SIM_spi[i].vector, i, SIM_SPI_Level, SIM_SPI_Taken);
+	}
+	for (i = 0; i < SIM_PORT_COUNT * 2; i++) {
+		SIM_AddSource(SIM_portVector[i / 2] + i % 2, i, SIM_PORT_Level, SIM_PORT_Taken);
+	}
+	for (i = 0; i < SIM_AC_COUNT * 3; i++) {
+		SIM_AddSource(SIM_ac[i / 3].vector + i % 3, i, SIM_AC_Level, SIM_AC_Taken);
+	}
+	for (i = 0; i < SIM_TWI_COUNT * 2; i++) {
+		SIM_AddSource(SIM_twi[i / 2].vector + i % 2, i, SIM_TWI_Level, NULL);
+	}
+	for (i = 0; i < SIM_ADC_COUNT * SIM_ADC_CH_COUNT; i++) {
+		SIM_AddSource(SIM_adc[i / SIM_ADC_CH_COUNT].vector + i % SIM_ADC_CH_COUNT, i,
+		              SIM_ADC_Level, SIM_ADC_Taken);
+	}
+	SIM_AddSource(AES_INT_vect_num, 0, SIM_AES_Level, SIM_AES_Taken);
+	SIM_AddSource(NVM_EE_vect_num, 0, SIM_NVM_Level, NULL);
+	SIM_AddSource(NVM_SPM_vect_num, 1, SIM_NVM_Level, NULL);
+}
+
+
+/*! \brief Get the simulated time.
+ *
+ *  \return  CPU cycles since start.
+ */
+uint64_t SIM_GetCycles(void)
+{
+	return SIM_cycles;
+}
+
+
+/*! \brief Get the simulated time in nanoseconds.
+ *
+ *  The CPU cycles are converted at the clock frequency they were executed
+ *  with, so this is the time to use when the program changes the clock.
+ *
+ *  \return  Nanoseconds since start.
+ */
+uint64_t SIM_GetNanoseconds(void)
+{
+	return SIM_nsBase + SIM_CLK_CyclesToNs(SIM_cycles - SIM_nsCycles);
+}
+
+
+/*! \brief Get the CPU clock frequency.
+ *
+ *  \return  Frequency in Hz.
+ */
+uint32_t SIM_CLK_GetCpuHz(void)
+{
+	return SIM_cpuHz;
+}
+
+
+/*! \brief Set the frequency error of oscillators.
+ *
+ *  The error is added to the nominal frequency, for instance to follow the
+ *  temperature, and is kept over a device reset. An enabled DFLL corrects
+ *  its oscillator towards the frequency of its reference in steps of
+ *  SIM_DFLL_STEP_PPM, one step per millisecond. The RTC keeps its count.
+ *
+ *  \param oscillators  OSC.CTRL bit masks of the oscillators: OSC_RC2MEN_bm,
+ *                      OSC_RC32MEN_bm, OSC_RC32KEN_bm or OSC_XOSCEN_bm for
+ *                      the 32.768 kHz crystal.
+ *  \param ppm          Frequency error in ppm.
+ */
+void SIM_OSC_SetDrift(uint8_t oscillators, int32_t ppm)
+{
+	uint64_t tickNs;
+	uint8_t i;
+
+	/* Continue the RTC and RTC32 counts from their last tick at the new
+	 * frequency. */
+	SIM_RTC_Sync();
+	tickNs = SIM_RTC_TickNs(SIM_rtcTicks);
+	SIM_rtcBase = (tickNs == UINT64_MAX) ? SIM_GetNanoseconds() : tickNs;
+	SIM_rtcTicks = 0;
+	SIM_RTC32_Sync();
+	tickNs = SIM_RTC32_TickNs(SIM_rtc32Ticks);
+	SIM_rtc32Base = (tickNs == UINT64_MAX) ? SIM_GetNanoseconds() : tickNs;
+	SIM_rtc32Ticks = 0;
+
+	for (i = 0; i < SIM_DRIFT_COUNT; i++) {
+		if (oscillators & (1 << i)) {
+			SIM_oscDrift[i] = ppm;
+		}
+	}
+	SIM_CLK_Update();
+}
+
+
+/*! \brief Let time pass.
+ *
+ *  Module events and interrupts are processed as they become due. This is
+ *  to be called by code waiting without accessing registers, and is used
+ *  by the delay macros.
+ *
+ *  \param cycles  Number of CPU cycles.
+ */
+void SIM_Run(uint32_t cycles)
+{
+	SIM_Advance(cycles);
+	SIM_Dispatch();
+}
+
+
+/*! \brief Get the statistics of an interrupt vector.
+ *
+ *  \param vectorNum  Vector number, for example USARTC0_RXC_vect_num.
+ *
+ *  \return  Pointer to the statistics.
+ */
+const SIM_IrqStats_t * SIM_GetIrqStats(uint8_t vectorNum)
+{
+	return &SIM_irqStats[vectorNum % _VECTORS_COUNT];
+}
+
+
+/*! \brief Clear the interrupt statistics. */
+void SIM_ClearStats(void)
+{
+	uint8_t i;
+
+	memset(SIM_irqStats, 0, sizeof(SIM_irqStats));
+	for (i = 0; i < _VECTORS_COUNT; i++) {
+		SIM_pendingSince[i] = SIM_NOT_PENDING;
+	}
+}
+
+
+/*! \brief Reset the device.
+ *
+ *  The registers and the module states get their reset values, except for
+ *  RST.STATUS, where the reset flags accumulate, the lines and traces
+ *  driven from outside the device, and the battery backup domain: VBAT and
+ *  the RTC32, which keeps counting. Host memory, the RAM of the device, is
+ *  kept. The reset handler is then called; it does not return.
+ *
+ *  \param flags  RST.STATUS flags of the reset source, for example
+ *                RST_EXTRF_bm.
+ */
+void SIM_Reset(uint8_t flags)
+{
+	uint8_t status = SIM_io[SIM_RST_OFFSET] | flags;
+	uint8_t vbat[SIM_VBAT_LAST - SIM_VBAT_OFFSET + 1];
+	uint8_t rtc32[SIM_RTC32_LAST - SIM_RTC32_OFFSET + 1];
+
+	SIM_RTC32_Sync();
+	memcpy(vbat, &SIM_io[SIM_VBAT_OFFSET], sizeof(vbat));
+	memcpy(rtc32, &SIM_io[SIM_RTC32_OFFSET], sizeof(rtc32));
+	memset(SIM_io, 0, SIM_IO_SIZE);
+	SIM_ResetValues();
+	SIM_io[SIM_RST_OFFSET] = status;
+	memcpy(&SIM_io[SIM_VBAT_OFFSET], vbat, sizeof(vbat));
+	memcpy(&SIM_io[SIM_RTC32_OFFSET], rtc32, sizeof(rtc32));
+	SIM_io[SIM_VBAT_OFFSET + SIM_VBAT_CTRL] &= ~VBAT_ACCEN_bm;
+
+	if (SIM_resetHandler == NULL) {
+		fprintf(stderr, "sim: device reset, RST.STATUS 0x%02x\n", status);
+		exit(EXIT_FAILURE);
+	}
+	SIM_resetHandler();
+	fprintf(stderr, "sim: the reset handler returned\n");
+	abort();
+}
+
+
+/*! \brief Set the function called at each device reset.
+ *
+ *  The handler plays the role of the reset vector: it must not return, but
+ *  restart the program, typically with siglongjmp() to a sigsetjmp() with a
+ *  saved signal mask, as a reset can happen inside the trap handlers. Without
+ *  a handler, a reset ends the program with a message.
+ *
+ *  \param handler  The reset handler, NULL for none.
+ */
+void SIM_SetResetHandler(void (* handler)(void))
+{
+	SIM_resetHandler = handler;
+}
+
+
+/*! \brief Set the clock of the Watchdog Timer.
+ *
+ *  The clock of the Watchdog Timer is the 1 kHz ULP oscillator, which has
+ *  a wide tolerance. This sets its period relative to the CPU clock.
+ *
+ *  \param cycles  CPU cycles per Watchdog Timer clock cycle, 2000 after
+ *                 start, for the 2 MHz reset clock and a nominal 1 kHz.
+ */
+void SIM_WDT_SetClock(uint32_t cycles)
+{
+	SIM_wdtCycles = cycles;
+}
+
+
+/*! \brief The WDR instruction, see <avr/wdt.h>.
+ *
+ *  Restarts the Watchdog Timer. In window mode, a WDR in the closed window
+ *  resets the device.
+ */
+void SIM_WatchdogReset(void)
+{
+	SIM_Advance(1);
+	if ((SIM_io[SIM_WDT_OFFSET + SIM_WDT_CTRL] & WDT_ENABLE_bm) &&
+	    (SIM_cycles < SIM_wdtStart + SIM_WDT_ClosedCycles())) {
+		SIM_Reset(RST_WDRF_bm);
+	}
+	SIM_wdtStart = SIM_cycles;
+	SIM_Dispatch();
+}
+
+
+/*! \brief Apply levels to the input pins of a port.
+ *
+ *  \param port   The port.
+ *  \param value  Pin levels, used for the pins configured as input.
+ */
+void SIM_PORT_SetInput(PORT_t * port, uint8_t value)
+{
+	uint16_t offset = (uint8_t *) port - SIM_ioSpace;
+
+	SIM_portInput[(offset - SIM_PORT_FIRST) / SIM_PORT_SIZE] = value;
+	SIM_PORT_Access(offset, false);
+	SIM_DMA_Service();
+}
+
+
+/*! \brief Apply a voltage to an analog input pin of an Analog Comparator.
+ *
+ *  A trace replayed on the pin is stopped.
+ *
+ *  \param ac          The Analog Comparator, ACA or ACB.
+ *  \param pin         Input pin, 0 to 7 of PORTA for ACA and PORTB for ACB.
+ *  \param millivolts  Voltage on the pin.
+ */
+void SIM_AC_SetInput(AC_t * ac, uint8_t pin, int16_t millivolts)
+{
+	SIM_AC_t * a = SIM_AC_Get(ac);
+
+	a->trace[pin % SIM_AC_INPUTS] = NULL;
+	a->input[pin % SIM_AC_INPUTS] = millivolts;
+	SIM_AC_Update(a);
+	SIM_DMA_Service();
+}
+
+
+/*! \brief Replay a sampled voltage trace on an analog input pin.
+ *
+ *  The first sample is applied at once, and each following sample
+ *  \a sampleCycles later. The comparator outputs are updated after every
+ *  sample, so a comparator output changes at most once per sample. After
+ *  the last sample the trace starts over if \a repeat is set, or the last
+ *  voltage holds. The samples are read while the trace is replayed and must
+ *  stay valid until then.
+ *
+ *  \param ac            The Analog Comparator, ACA or ACB.
+ *  \param pin           Input pin, 0 to 7 of PORTA for ACA and PORTB for ACB.
+ *  \param millivolts    Voltage samples.
+ *  \param count         Number of samples, at least one.
+ *  \param sampleCycles  CPU cycles between samples, at least one.
+ *  \param repeat        True to replay the trace over and over.
+ */
+void SIM_AC_SetTrace(AC_t * ac, uint8_t pin, const int16_t * millivolts,
+                     uint32_t count, uint32_t sampleCycles, bool repeat)
+{
+	SIM_AC_t * a = SIM_AC_Get(ac);
+
+	pin %= SIM_AC_INPUTS;
+	a->trace[pin] = millivolts;
+	a->traceCount[pin] = count;
+	a->traceIndex[pin] = 0;
+	a->traceCycles[pin] = sampleCycles;
+	a->traceRepeat[pin] = repeat;
+	a->traceNext[pin] = SIM_cycles;
+	SIM_AC_UpdateTraces(a);
+	SIM_DMA_Service();
+}
+
+
+/*! \brief Set the voltage on an analog input pin of an ADC.
+ *
+ *  \param adc         The ADC, ADCA or ADCB.
+ *  \param pin         Input pin, 0 to 7 of PORTA for ADCA and PORTB for ADCB.
+ *                     Pin 0 is also the AREF input of the port.
+ *  \param millivolts  Voltage on the pin.
+ */
+void SIM_ADC_SetInput(ADC_t * adc, uint8_t pin, int16_t millivolts)
+{
+	SIM_ADC_Get(adc)->input[pin % SIM_ADC_INPUTS] = millivolts;
+}
+
+
+/*! \brief Send characters to the receiver of a USART.
+ *
+ *  The characters follow each other back-to-back on the line, at the baud
+ *  rate and frame format the USART has when each frame starts.
+ *
+ *  \param usart   The USART.
+ *  \param data    Characters to send.
+ *  \param length  Number of characters.
+ *
+ *  \return  Number of characters queued, less than \a length if the line
+ *           queue is full.
+ */
+uint16_t SIM_USART_Inject(USART_t * usart, const uint8_t * data, uint16_t length)
+{
+	uint16_t i;
+
+	for (i = 0; i < length; i++) {
+		uint16_t character = data[i];
+
+		if (SIM_USART_Inject9(usart, &character, 1) == 0) {
+			break;
+		}
+	}
+	return i;
+}
+
+
+/*! \brief Send 9-bit characters to the receiver of a USART.
+ *
+ *  As SIM_USART_Inject(), with the ninth bit in bit 8 of each character.
+ *  The ninth bit is dropped if the receiver is not set up for 9-bit
+ *  characters when the character arrives.
+ *
+ *  \param usart   The USART.
+ *  \param data    Characters to send.
+ *  \param length  Number of characters.
+ *
+ *  \return  Number of characters queued.
+ */
+uint16_t SIM_USART_Inject9(USART_t * usart, const uint16_t * data, uint16_t length)
+{
+	SIM_USART_t * u = SIM_USART_Get(usart);
+	uint16_t i;
+
+	for (i = 0; (i < length) && (u->rxLineCount < SIM_USART_LINE_SIZE); i++) {
+		uint16_t tail = (u->rxLineHead + u->rxLineCount) % SIM_USART_LINE_SIZE;
+
+		u->rxLine[tail] = data[i] & (SIM_USART_BIT8 | 0xFF);
+		u->rxLineIdle[tail] = u->rxLineGap;
+		u->rxLineGap = 0;
+		if (u->rxLineCount++ == 0) {
+			SIM_USART_StartLine(u, SIM_cycles);
+		}
+	}
+	return i;
+}
+
+
+/*! \brief Keep the receive line of a USART idle before the next character.
+ *
+ *  The idle time goes before the next character given to SIM_USART_Inject()
+ *  or SIM_USART_Inject9(), counted from the end of the character before it,
+ *  or from now if the line is idle. Calls add up.
+ *
+ *  \param usart   The USART.
+ *  \param cycles  Idle time in CPU cycles.
+ */
+void SIM_USART_InjectIdle(USART_t * usart, uint32_t cycles)
+{
+	SIM_USART_Get(usart)->rxLineGap += cycles;
+}
+
+
+/*! \brief Drive the RXD pin of a USART with an edge trace.
+ *
+ *  The trace replaces the line model of SIM_USART_Inject() and must not
+ *  be mixed with it or with SIM_USART_Connect(). The receiver samples the
+ *  trace like the device: a falling edge with the receiver enabled starts
+ *  a frame, each bit is sampled in its middle with the bit time of the
+ *  receiver, and the character is received with a frame error if the stop
+ *  bit is low, so a trace at another baud rate gives wrong characters.
+ *
+ *  The edges are not copied and must stay unchanged until applied; a new
+ *  trace may only be injected when the previous one has been applied.
+ *
+ *  \param usart  The USART.
+ *  \param edges  Edges, each with its delay from the edge before it; the
+ *                delay of the first is counted from now.
+ *  \param count  Number of edges.
+ */
+void SIM_USART_InjectEdges(USART_t * usart, const SIM_Edge_t * edges, uint16_t count)
+{
+	SIM_USART_t * u = SIM_USART_Get(usart);
+
+	if (count != 0) {
+		u->edges = edges;
+		u->edgeCount = count;
+		u->edgeTime = SIM_cycles + edges->delay;
+	}
+}
+
+
+/*! \brief Read the characters sent by a USART.
+ *
+ *  \param usart   The USART.
+ *  \param data    Buffer for the characters.
+ *  \param length  Size of the buffer.
+ *
+ *  \return  Number of characters read.
+ */
+uint16_t SIM_USART_Read(USART_t * usart, uint8_t * data, uint16_t length)
+{
+	uint16_t character;
+	uint16_t i;
+
+	for (i = 0; (i < length) && (SIM_USART_Read9(usart, &character, 1) != 0); i++) {
+		data[i] = (uint8_t) character;
+	}
+	return i;
+}
+
+
+/*! \brief Read the 9-bit characters sent by a USART.
+ *
+ *  As SIM_USART_Read(), with the ninth bit (TXB8 when DATA was written, in
+ *  9-bit mode only) in bit 8 of each character.
+ *
+ *  \param usart   The USART.
+ *  \param data    Buffer for the characters.
+ *  \param length  Size of the buffer, in characters.
+ *
+ *  \return  Number of characters read.
+ */
+uint16_t SIM_USART_Read9(USART_t * usart, uint16_t * data, uint16_t length)
+{
+	SIM_USART_t * u = SIM_USART_Get(usart);
+	uint16_t i;
+
+	for (i = 0; (i < length) && (u->txLineCount != 0); i++) {
+		data[i] = u->txLine[u->txLineHead];
+		u->txLineHead = (u->txLineHead + 1) % SIM_USART_LINE_SIZE;
+		u->txLineCount--;
+	}
+	return i;
+}
+
+
+/*! \brief Get the number of characters sent by a USART since start. */
+uint32_t SIM_USART_GetTxCount(USART_t * usart)
+{
+	return SIM_USART_Get(usart)->txCount;
+}
+
+
+/*! \brief Get the number of characters a USART lost on reception.
+ *
+ *  Characters are lost when they arrive with the receiver disabled or with
+ *  the receive buffer full.
+ */
+uint32_t SIM_USART_GetRxLost(USART_t * usart)
+{
+	return SIM_USART_Get(usart)->rxLost;
+}
+
+
+/*! \brief Test if a USART has nothing left to send or to receive.
+ *
+ *  In master SPI mode only the transmitter is considered.
+ *
+ *  \return  True if the transmitter and the receive line are idle.
+ */
+bool SIM_USART_IsIdle(USART_t * usart)
+{
+	SIM_USART_t * u = SIM_USART_Get(usart);
+
+	if (SIM_USART_IsMasterSpi(u)) {
+		/* Bytes left on MISO wait for the transmitter to clock them in. */
+		return !u->txBusy;
+	}
+	return !u->txBusy && (u->rxLineCount == 0) && (u->edgeCount == 0) && !u->sampling;
+}
+
+
+/*! \brief Put an RS-485 transceiver between a USART and the bus.
+ *
+ *  Characters started with the DE pin low do not reach the bus, that is,
+ *  neither SIM_USART_Read() nor the connected receivers. Connected with
+ *  SIM_USART_SetLoopback(), the receiver of the USART gets its own
+ *  characters back, like a transceiver with the receiver always enabled.
+ *  The timing of DE relative to the characters is available through
+ *  SIM_USART_GetTransceiverStats().
+ *
+ *  \param usart  The USART.
+ *  \param port   Port of the DE pin, NULL to remove the transceiver.
+ *  \param pin    DE pin number.
+ */
+void SIM_USART_SetTransceiver(USART_t * usart, PORT_t * port, uint8_t pin)
+{
+	SIM_USART_t * u = SIM_USART_Get(usart);
+
+	memset(&u->deStats, 0, sizeof(u->deStats));
+	u->deStats.setupMin = UINT32_MAX;
+	u->deStats.gapMin = UINT32_MAX;
+	u->deLastStop = SIM_NOT_PENDING;
+	u->dePort = (port != NULL) ? (uint16_t) ((uint8_t *) port - SIM_ioSpace) : 0;
+	u->deMask = 1 << pin;
+	u->deHigh = (port != NULL) && (SIM_io[u->dePort + SIM_PORT_IN] & u->deMask);
+	u->deFirst = u->deHigh;
+	u->deSet = SIM_cycles;
+}
+
+
+/*! \brief Get the driver enable timing of a USART with transceiver.
+ *
+ *  \return  Pointer to the statistics.
+ */
+const SIM_TransceiverStats_t * SIM_USART_GetTransceiverStats(USART_t * usart)
+{
+	return &SIM_USART_Get(usart)->deStats;
+}
+
+
+/*! \brief Connect the TXD pin of a USART to its RXD pin.
+ *
+ *  \param usart   The USART.
+ *  \param enable  True to connect, false to disconnect.
+ */
+void SIM_USART_SetLoopback(USART_t * usart, bool enable)
+{
+	SIM_USART_Connect(usart, usart, enable);
+}
+
+
+/*! \brief Connect the TXD pin of a USART to the RXD pin of another.
+ *
+ *  A transmitter can be connected to any number of receivers, to model a
+ *  multi-drop bus. A character is received at the end of its frame on the
+ *  transmitting side; the receivers are expected to use the same baud rate
+ *  and frame format.
+ *
+ *  \param from    The transmitting USART.
+ *  \param to      The receiving USART.
+ *  \param enable  True to connect, false to disconnect.
+ */
+void SIM_USART_Connect(USART_t * from, USART_t * to, bool enable)
+{
+	SIM_USART_t * u = SIM_USART_Get(from);
+	uint8_t bit = 1 << (SIM_USART_Get(to) - SIM_usart);
+
+	if (enable) {
+		u->connections |= bit;
+	} else {
+		u->connections &= ~bit;
+	}
+}
+
+
+/*! \brief Get the time the transmitter of a USART has been sending.
+ *
+ *  Divided by the elapsed time, this gives the utilization of the line
+ *  or, in master SPI mode, of the SPI bus.
+ *
+ *  \return  CPU cycles since start.
+ */
+uint64_t SIM_USART_GetShiftCycles(USART_t * usart)
+{
+	return SIM_USART_Get(usart)->shiftCycles;
+}
+
+
+/*! \brief Queue the bytes an SPI module receives.
+ *
+ *  In master mode these are the bytes the slave puts on MISO, each clocked
+ *  in by the next transfer of the SPI module. In slave mode they are the
+ *  bytes the external master sends on MOSI, see SIM_SPI_SetMasterClock().
+ *  The bytes are in wire order, the first bit on the wire in bit 7. For a
+ *  USART in master SPI mode, SIM_USART_Inject() does the same.
+ *
+ *  \param spi     The SPI module.
+ *  \param data    Bytes to receive.
+ *  \param length  Number of bytes.
+ *
+ *  \return  Number of bytes queued, less than \a length if the line queue
+ *           is full.
+ */
+uint16_t SIM_SPI_Inject(SPI_t * spi, const uint8_t * data, uint16_t length)
+{
+	SIM_SPI_t * s = SIM_SPI_Get(spi);
+	uint16_t i;
+
+	for (i = 0; (i < length) && (s->rxLineCount < SIM_SPI_LINE_SIZE); i++) {
+		s->rxLine[(s->rxLineHead + s->rxLineCount) % SIM_SPI_LINE_SIZE] = data[i];
+		s->rxLineCount++;
+	}
+	return i;
+}
+
+
+/*! \brief Read the bytes an SPI module has sent.
+ *
+ *  These are the bytes on MOSI in master mode and on MISO in slave mode, in
+ *  wire order as for SIM_SPI_Inject(). For a USART in master SPI mode,
+ *  SIM_USART_Read() does the same.
+ *
+ *  \param spi     The SPI module.
+ *  \param data    Buffer for the bytes.
+ *  \param length  Size of the buffer.
+ *
+ *  \return  Number of bytes read.
+ */
+uint16_t SIM_SPI_Read(SPI_t * spi, uint8_t * data, uint16_t length)
+{
+	SIM_SPI_t * s = SIM_SPI_Get(spi);
+	uint16_t i;
+
+	for (i = 0; (i < length) && (s->txLineCount != 0); i++) {
+		data[i] = s->txLine[s->txLineHead];
+		s->txLineHead = (s->txLineHead + 1) % SIM_SPI_LINE_SIZE;
+		s->txLineCount--;
+	}
+	return i;
+}
+
+
+/*! \brief Test if an SPI module has no transfer in progress.
+ *
+ *  A selected slave is idle when the external master has sent all bytes.
+ */
+bool SIM_SPI_IsIdle(SPI_t * spi)
+{
+	SIM_SPI_t * s = SIM_SPI_Get(spi);
+
+	return !s->busy && !SIM_SPI_SlavePending(s);
+}
+
+
+/*! \brief Get the time an SPI module has been shifting.
+ *
+ *  Divided by the elapsed time, this gives the utilization of the bus.
+ *
+ *  \return  CPU cycles since start.
+ */
+uint64_t SIM_SPI_GetShiftCycles(SPI_t * spi)
+{
+	return SIM_SPI_Get(spi)->shiftCycles;
+}
+
+
+/*! \brief Set the clock of the external master of an SPI module in slave mode.
+ *
+ *  While SS is low, the external master clocks the bytes queued by
+ *  SIM_SPI_Inject() with the given SCK period, starting one period after
+ *  SS goes low. The slave must have the byte to send in its shift register
+ *  at the first SCK edge, half a period into the byte. SS is pin 4 of the
+ *  port of the module, driven by SIM_PORT_SetInput().
+ *
+ *  \param spi        The SPI module.
+ *  \param bitCycles  SCK period in CPU cycles.
+ *  \param gapCycles  Time between the end of a byte and the start of the next.
+ */
+void SIM_SPI_SetMasterClock(SPI_t * spi, uint32_t bitCycles, uint32_t gapCycles)
+{
+	SIM_SPI_t * s = SIM_SPI_Get(spi);
+
+	s->masterBitCycles = bitCycles;
+	s->masterGapCycles = gapCycles;
+}
+
+
+/*! \brief Set the time the DMA controller takes for a burst.
+ *
+ *  A burst requested once per transfer, by an SPI module or an event
+ *  channel, completes the given number of cycles after its request, and
+ *  such bursts of several channels follow each other in priority order.
+ *  Bursts started by a flag, like the USART triggers, or by a software
+ *  request still take no time. The default is zero.
+ *
+ *  \param cycles  CPU cycles from the request to the end of the burst.
+ */
+void SIM_DMA_SetLatency(uint32_t cycles)
+{
+	SIM_dmaLatency = cycles;
+}
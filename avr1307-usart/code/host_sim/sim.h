@@ -0,0 +1,365 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host-side XMEGA peripheral simulator header file.
+ *
+ *      This file contains the function prototypes and type definitions of the
+ *      host-side simulator. The simulator lets the drivers of this application
+ *      note run unchanged on a Linux x86-64 host, so that they can be tested and
+ *      benchmarked without a board. It is shared with the other application
+ *      notes: their host programs put this directory on the include path and
+ *      build sim.c from here, so that there is a single copy of the models.
+ *
+ *      The register headers in this directory are placed first on the include
+ *      path. They put the modules in a simulated I/O memory area that is mapped
+ *      without access rights. Every register access of the driver then traps;
+ *      the simulator lets the instruction complete by single-stepping it and
+ *      applies the side effects of the register afterwards: clearing flags on
+ *      read, loading the transmitter on a DATA write, write-one-to-clear flags
+ *      and so on.
+ *
+ *      Time is a deterministic cycle counter. It advances by
+ *      SIM_CYCLES_PER_ACCESS for every register access, by the interrupt entry
+ *      and exit times, and by SIM_Run() and the delay macros. The C code between
+ *      register accesses is not counted, so the counter is a reproducible
+ *      measure for comparing driver versions rather than an exact cycle count.
+ *
+ *      Interrupts are dispatched by a virtual PMIC: an interrupt is taken when
+ *      its flag and level are set, the level is enabled in PMIC.CTRL, the I bit
+ *      in SREG is set and no interrupt of the same or a higher level executes.
+ *      Within a level, the lowest vector number wins (round-robin scheduling is
+ *      not modelled).
+ *
+ *      Modelled modules: CPU (SREG, CCP), the clock system, the Real Time
+ *      Counter and the 32-bit RTC with the battery backup module (see below),
+ *      the reset flags, the Watchdog Timer (normal and
+ *      window mode, change protection, synchronization, timeout and closed
+ *      window resets), PMIC,
+ *      PORT (set, clear and toggle registers, IN, pin change events and
+ *      interrupts by the input sense configuration, inverted inputs,
+ *      multi-pin configuration, virtual ports), USART in asynchronous mode
+ *      (baud rate timing from BAUDCTRL, transmit buffer and shift register,
+ *      two level receive FIFO, RXC, DRE and TXC interrupts, buffer overflow,
+ *      frame and parity errors of sampled edge traces, 9-bit characters and
+ *      multi-processor communication mode; and master SPI mode with SCK
+ *      timing from BSEL, double buffered transmitter and data order), SPI in
+ *      master and slave mode (prescaler and CLK2X timing, data order, IF and
+ *      WRCOL, interrupt), DMA (four channels, burst length, single shot and
+ *      repeat modes, address reload and direction, software, USART, SPI,
+ *      Timer/Counter capture and overflow and event system triggers,
+ *      transaction complete interrupt), the event system (channel
+ *      multiplexers and manual strobe), the Analog Comparators (input
+ *      multiplexers, voltage scaler, bandgap, hysteresis, interrupt modes and
+ *      interrupts, events, window mode), Timer/Counter 0 (normal mode
+ *      counting up and the dual-slope modes, prescaler, overflow interrupt,
+ *      compare or capture interrupts in normal mode, buffer registers and the
+ *      update condition, restart and input capture event actions, the pin
+ *      level in bit 15 of a pin capture), the HiRes extension (four counter
+ *      steps per clock tick) and the AWeX dead time registers and fault
+ *      detection (the outputs are not generated), TWI (master and slave
+ *      transactions, see below), AES (see below), the ADCs (see below) and
+ *      the NVM controller for the EEPROM (see below). Other registers of the
+ *      I/O area read back what was last written. A driver that waits on a
+ *      software flag without accessing any register must call SIM_Run() while
+ *      it waits, or time would stand still.
+ *
+ *      DMA transfers take no simulated time and do not slow down the CPU,
+ *      except for the bursts requested once per transfer, which can be given
+ *      a latency with SIM_DMA_SetLatency(). The DMA channels reach registers
+ *      and host memory; a program using DMA must be linked with -no-pie, so
+ *      that its static data and heap get addresses below 16 MB, and can only
+ *      transfer to and from those.
+ *
+ *      USARTs are connected to the host program with SIM_USART_Inject() and
+ *      SIM_USART_Read(), and to each other with SIM_USART_Connect(), which
+ *      can connect one transmitter to several receivers like a multi-drop bus.
+ *      SIM_USART_InjectIdle() puts idle time between injected characters.
+ *      The bits of each received character are also driven onto the RXD pin
+ *      of the port, so that edge events on RXD can be used.
+ *      SIM_USART_InjectEdges() drives RXD with an edge trace of any timing
+ *      instead, which the receiver samples with its own baud rate.
+ *      SIM_USART_SetTransceiver() puts an RS-485 transceiver, controlled by
+ *      a DE pin, between a transmitter and the bus.
+ *
+ *      The clock system selects the system clock from the internal 2 MHz,
+ *      32 MHz and 32 kHz RC oscillators and the PLL, with the prescalers,
+ *      change protection and lock of the device. The oscillators become ready
+ *      after an assumed start-up time, a source that is not ready is not
+ *      selected and the oscillators in use are not stopped. The only external
+ *      oscillator is a 32.768 kHz crystal on TOSC. SIM_OSC_SetDrift() gives
+ *      the oscillators a frequency error, which an enabled DFLL corrects
+ *      towards its reference in steps of an assumed size, once per
+ *      millisecond. The Real Time Counter counts from the crystal, the 32 kHz
+ *      RC or the ULP oscillator, and its overflow and compare events reach
+ *      the Event System; its interrupts are not modelled. The 32-bit RTC of
+ *      ATxmega256A3B counts the 1 Hz or 1.024 kHz output of the same crystal,
+ *      enabled in the battery backup module (VBAT), with synchronization of
+ *      the written registers and SYNCCNT, the overflow and compare flags and
+ *      the access enable and CCP protected reset of VBAT; its interrupts are
+ *      not modelled either. The peripherals run from the CPU clock, as clkPER
+ *      is clkCPU on the device, so the cycle counter counts both; SIM_GetNanoseconds() converts it to time at the
+ *      frequency of each cycle and SIM_CLK_GetCpuHz() returns the frequency.
+ *      A character injected on a receive line keeps its real time when the
+ *      clock changes, and gets a frame error if it has started: the receiver
+ *      samples it with two clocks. Edge traces are timed in CPU cycles.
+ *
+ *      A device reset, by the Watchdog Timer or by SIM_Reset(), sets the
+ *      registers to their reset values, except for the battery backup domain,
+ *      which keeps its registers and the RTC32 count, and calls the handler
+ *      set by SIM_SetResetHandler(), which restarts the program. The RAM of the device
+ *      is host memory and keeps its contents over the reset, like a .noinit
+ *      section on the device. SIM_WDT_SetClock() sets the frequency of the
+ *      Watchdog oscillator, to check timing margins against its tolerance.
+ *
+ *      The analog input pins of the Analog Comparators are driven with
+ *      SIM_AC_SetInput(), or with a sampled voltage trace replayed by
+ *      SIM_AC_SetTrace().
+ *
+ *      SPI masters, the SPI modules and the USARTs in master SPI mode, are
+ *      connected to a slave model that answers with the bytes queued by
+ *      SIM_SPI_Inject() or SIM_USART_Inject(), and records the bytes sent
+ *      for SIM_SPI_Read() or SIM_USART_Read(). The bytes are in wire order,
+ *      so that a wrong data order setting shows. The time each shift
+ *      register has been busy is available for bus utilization figures.
+ *      An SPI module in slave mode is clocked by an external master model
+ *      with the SCK period and byte gap set by SIM_SPI_SetMasterClock(),
+ *      while its SS pin, driven by SIM_PORT_SetInput(), is low. The master
+ *      sends the bytes queued by SIM_SPI_Inject(), and SIM_SPI_Read()
+ *      returns the bytes of the slave.
+ *
+ *      The master and the slave of a TWI module are connected to each other
+ *      as if on the same bus, so a driver can address its own slave. SCL runs
+ *      at the rate set by the master BAUD register: an address byte with
+ *      START takes ten SCL periods, a data byte eight and its acknowledge bit
+ *      one more, and STOP one. An address that the slave does not match is
+ *      not acknowledged. SCL is held while a WIF, RIF, APIF or DIF flag waits
+ *      for a command, as on the device. Arbitration, bus errors, the bus
+ *      timeout, smart mode, ADDRMASK and the pins are not modelled.
+ *
+ *      The AES module encrypts or decrypts the state memory with the key
+ *      memory in SIM_AES_CYCLES cycles, started by START or, with AUTO, by
+ *      the 16th state byte written. XOR mode, the ERROR flag, RESET and the
+ *      interrupt are modelled. After an encryption the key memory holds the
+ *      last subkey, which a decryption expects, and after a decryption the
+ *      original key, as on the device.
+ *
+ *      The analog input pins of the ADCs are driven with SIM_ADC_SetInput().
+ *      A conversion samples its input when it starts and completes after
+ *      1 + RES/2 ADC clock cycles, one more with gain; the conversions of
+ *      several channels follow each other one ADC clock cycle apart through
+ *      the pipeline. The results follow the transfer functions of the data
+ *      sheet, in signed and unsigned mode, with the bandgap and VCC/10 as
+ *      internal inputs. Free running mode, event triggers, DMA and the
+ *      offset and gain errors the calibration corrects are not modelled.
+ *
+ *      The NVM controller reads, erases and writes the EEPROM through the
+ *      page buffer with the commands of the device, CCP protected. The
+ *      contents survive a reset and start erased. An erase or write keeps
+ *      NVMBUSY set for SIM_NVM_EE_ERASE_NS or SIM_NVM_EE_WRITE_NS, and the
+ *      EEPROM and SPM interrupts are level interrupts requested while the
+ *      controller is not busy. Flash programming, the signature rows, the
+ *      fuses and the memory mapped EEPROM are not modelled.
+ *
+ *      IrDA mode of the USART runs as asynchronous mode; the IRCOM pulse
+ *      coding is not modelled and its registers are plain registers.
+ *
+ *      SLEEP.CTRL is a plain register, and the SLEEP instruction of
+ *      <avr/sleep.h> lets one CPU cycle pass. A program that needs the time
+ *      asleep runs the simulator up to its wake-up event itself.
+ *
+ *      The simulator cannot be used together with a debugger that single-steps
+ *      the program, or with tools that handle SIGSEGV or SIGTRAP themselves.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+
+/* Definition of macros. */
+
+#ifndef SIM_CYCLES_PER_ACCESS
+/*! CPU cycles charged for one register access. */
+#define SIM_CYCLES_PER_ACCESS  2
+#endif
+
+/*! CPU cycles from an interrupt being taken until the first ISR instruction. */
+#define SIM_IRQ_ENTRY_CYCLES   5
+
+/*! CPU cycles of the RETI instruction. */
+#define SIM_IRQ_EXIT_CYCLES    5
+
+/*! Size of the receive and transmit line queues of each simulated USART. */
+#define SIM_USART_LINE_SIZE    4096
+
+/*! Size of the receive and transmit line queues of each simulated SPI module. */
+#define SIM_SPI_LINE_SIZE      4096
+
+/*! Supply voltage of the Analog Comparator voltage scaler, in millivolts. */
+#define SIM_AC_VCC_MV          3300
+
+/*! Bandgap reference voltage, in millivolts. */
+#define SIM_AC_BANDGAP_MV      1000
+
+/* Analog Comparator hysteresis in high-speed and low power mode, in
+ * millivolts. Typical figures, the spread between devices is large. */
+#define SIM_AC_HYS_SMALL_HS_MV  13
+#define SIM_AC_HYS_LARGE_HS_MV  30
+#define SIM_AC_HYS_SMALL_LP_MV  30
+#define SIM_AC_HYS_LARGE_LP_MV  60
+
+/*! Frequency change of one DFLL calibration step, in ppm. An assumed figure,
+ *  not a data sheet value. */
+#define SIM_DFLL_STEP_PPM      1000
+
+/*! CPU cycles of an AES encryption or decryption. */
+#define SIM_AES_CYCLES         375
+
+/*! Internal 1.0 V reference of the ADC, in millivolts. */
+#define SIM_ADC_INT1V_MV       1000
+
+/* EEPROM page erase and page write times, in nanoseconds. Typical figures
+ * from the data sheet, the actual times depend on the temperature. */
+#define SIM_NVM_EE_ERASE_NS    4000000UL
+#define SIM_NVM_EE_WRITE_NS    4000000UL
+
+
+/*! \brief Statistics of one interrupt vector.
+ *
+ *  The latency is counted from the interrupt condition becoming true until
+ *  the ISR is entered. The cycles include the entry and exit times and any
+ *  higher level interrupt nested in the ISR.
+ */
+typedef struct SIM_IrqStats_struct {
+	/*! Number of times the ISR was executed. */
+	uint32_t count;
+	/*! CPU cycles spent in the ISR. */
+	uint64_t cycles;
+	/*! Sum of the latencies, for the average. */
+	uint64_t latencyTotal;
+	/*! Longest latency. */
+	uint32_t latencyMax;
+} SIM_IrqStats_t;
+
+
+/*! \brief A level change on a line, see SIM_USART_InjectEdges(). */
+typedef struct SIM_Edge_struct {
+	/*! CPU cycles from the edge before. */
+	uint32_t delay;
+	/*! Level after the edge. */
+	bool level;
+} SIM_Edge_t;
+
+
+/*! \brief Driver enable timing of a simulated RS-485 transceiver.
+ *
+ *  Times are in CPU cycles. A frame is what is sent between DE being set
+ *  and DE being released.
+ */
+typedef struct SIM_TransceiverStats_struct {
+	/*! Number of times DE was released after the end of a frame. */
+	uint32_t releases;
+	/*! Number of times DE was released while a character was on the bus. */
+	uint32_t releasesEarly;
+	/*! Characters started with DE low, which did not reach the bus. */
+	uint32_t charsDropped;
+	/*! Sum of the times from the last stop bit of a frame to DE release. */
+	uint64_t releaseTotal;
+	/*! Longest time from the last stop bit of a frame to DE release. */
+	uint32_t releaseMax;
+	/*! Shortest time from DE being set to the first start bit. */
+	uint32_t setupMin;
+	/*! Shortest bus idle time between the frames of the transmitter. */
+	uint32_t gapMin;
+} SIM_TransceiverStats_t;
+
+
+/* Prototyping of functions. */
+
+uint64_t SIM_GetCycles(void);
+uint64_t SIM_GetNanoseconds(void);
+uint32_t SIM_CLK_GetCpuHz(void);
+void SIM_OSC_SetDrift(uint8_t oscillators, int32_t ppm);
+void SIM_Run(uint32_t cycles);
+const SIM_IrqStats_t * SIM_GetIrqStats(uint8_t vectorNum);
+void SIM_ClearStats(void);
+
+void SIM_Reset(uint8_t flags);
+void SIM_SetResetHandler(void (* handler)(void));
+void SIM_WDT_SetClock(uint32_t cycles);
+void SIM_WatchdogReset(void);
+
+void SIM_PORT_SetInput(PORT_t * port, uint8_t value);
+
+void SIM_AC_SetInput(AC_t * ac, uint8_t pin, int16_t millivolts);
+void SIM_AC_SetTrace(AC_t * ac, uint8_t pin, const int16_t * millivolts,
+                     uint32_t count, uint32_t sampleCycles, bool repeat);
+
+void SIM_ADC_SetInput(ADC_t * adc, uint8_t pin, int16_t millivolts);
+
+uint16_t SIM_USART_Inject(USART_t * usart, const uint8_t * data, uint16_t length);
+uint16_t SIM_USART_Inject9(USART_t * usart, const uint16_t * data, uint16_t length);
+void SIM_USART_InjectIdle(USART_t * usart, uint32_t cycles);
+void SIM_USART_InjectEdges(USART_t * usart, const SIM_Edge_t * edges, uint16_t count);
+uint16_t SIM_USART_Read(USART_t * usart, uint8_t * data, uint16_t length);
+uint16_t SIM_USART_Read9(USART_t * usart, uint16_t * data, uint16_t length);
+uint32_t SIM_USART_GetTxCount(USART_t * usart);
+uint32_t SIM_USART_GetRxLost(USART_t * usart);
+bool SIM_USART_IsIdle(USART_t * usart);
+void SIM_USART_SetTransceiver(USART_t * usart, PORT_t * port, uint8_t pin);
+const SIM_TransceiverStats_t * SIM_USART_GetTransceiverStats(USART_t * usart);
+void SIM_USART_SetLoopback(USART_t * usart, bool enable);
+void SIM_USART_Connect(USART_t * from, USART_t * to, bool enable);
+uint64_t SIM_USART_GetShiftCycles(USART_t * usart);
+
+uint16_t SIM_SPI_Inject(SPI_t * spi, const uint8_t * data, uint16_t length);
+uint16_t SIM_SPI_Read(SPI_t * spi, uint8_t * data, uint16_t length);
+bool SIM_SPI_IsIdle(SPI_t * spi);
+uint64_t SIM_SPI_GetShiftCycles(SPI_t * spi);
+void SIM_SPI_SetMasterClock(SPI_t * spi, uint32_t bitCycles, uint32_t gapCycles);
+
+void SIM_DMA_SetLatency(uint32_t cycles);
+
+#endif
@@ -0,0 +1,267 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART interrupt driver benchmark for the host-side simulator.
+ *
+ *      This program runs the interrupt driven USART driver on the host simulator
+ *      and reports throughput and interrupt latency for a range of baud rates.
+ *      Time is the deterministic cycle counter of the simulator at F_CPU, so the
+ *      results are the same on every run and can be compared between driver
+ *      versions, for example in a CI job.
+ *
+ *      For each baud rate, two scenarios are run on USARTC0:
+ *        - tx: 1024 bytes are written with USART_TXBuffer_PutByte() and sent by
+ *          the DRE interrupt.
+ *        - rx: 1024 bytes arrive back-to-back on RXD and are collected by the
+ *          RXC interrupt and USART_RXBuffer_GetByte().
+ *
+ *      Each scenario prints one line of space separated key=value pairs, and
+ *      the program exits with a non-zero status if data was lost or corrupted.
+ *
+ *      Build and run from the directory holding usart_driver.c:
+ *        gcc -std=gnu99 -O2 -Ihost_sim -I. host_sim/sim.c \
+ *            host_sim/usart_benchmark.c usart_driver.c -o usart_benchmark
+ *        ./usart_benchmark
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "usart_driver.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Number of bytes sent and received in each scenario. */
+#define BENCHMARK_BYTES  1024
+
+/*! CPU cycles charged for one pass of a main loop that finds nothing to do. */
+#define BENCHMARK_IDLE_CYCLES  4
+
+/*! Define that selects the Usart used in the benchmark. */
+#define USART USARTC0
+
+/*! Baud rates benchmarked. */
+static const uint32_t baudrates[] = {9600, 19200, 38400, 57600, 115200};
+
+/*! USART data struct used in the benchmark. */
+USART_data_t USART_data;
+
+
+/*! \brief Set up USARTC0 as in the interrupt driven example.
+ *
+ *  \param baudrate  Baud rate to use.
+ */
+static void Benchmark_Setup(uint32_t baudrate)
+{
+	USART_Baud_t setting;
+
+	USART_InterruptDriver_Initialize(&USART_data, &USART, USART_DREINTLVL_LO_gc);
+	USART_Format_Set(USART_data.usart, USART_CHSIZE_8BIT_gc,
+	                 USART_PMODE_DISABLED_gc, false);
+	USART_RxdInterruptLevel_Set(USART_data.usart, USART_RXCINTLVL_LO_gc);
+
+	USART_Baudrate_Solve(F_CPU, baudrate, &setting);
+	USART_Baudrate_Apply(&USART, &setting);
+
+	USART_Rx_Enable(USART_data.usart);
+	USART_Tx_Enable(USART_data.usart);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	SIM_ClearStats();
+}
+
+
+/*! \brief Print the result of a scenario as one line of key=value pairs.
+ *
+ *  \param name       Scenario name.
+ *  \param baudrate   Baud rate used.
+ *  \param bytes      Number of bytes transferred correctly.
+ *  \param cycles     CPU cycles the scenario took.
+ *  \param vectorNum  Interrupt vector doing the work.
+ */
+static void Benchmark_Print(const char * name, uint32_t baudrate, uint32_t bytes,
+                            uint64_t cycles, uint8_t vectorNum)
+{
+	const SIM_IrqStats_t * stats = SIM_GetIrqStats(vectorNum);
+
+	printf("scenario=%s baud=%lu bytes=%lu cycles=%llu bytes_per_s=%llu "
+	       "isr_count=%lu isr_cycles=%llu isr_load_permille=%llu "
+	       "latency_avg=%llu latency_max=%lu\n",
+	       name,
+	       (unsigned long) baudrate,
+	       (unsigned long) bytes,
+	       (unsigned long long) cycles,
+	       (unsigned long long) (bytes * (uint64_t) F_CPU / cycles),
+	       (unsigned long) stats->count,
+	       (unsigned long long) stats->cycles,
+	       (unsigned long long) (stats->cycles * 1000 / cycles),
+	       (unsigned long long) (stats->count ? stats->latencyTotal / stats->count : 0),
+	       (unsigned long) stats->latencyMax);
+}
+
+
+/*! \brief Send BENCHMARK_BYTES bytes through the software buffer.
+ *
+ *  \return  True if all bytes were sent unchanged.
+ */
+static bool Benchmark_Tx(uint32_t baudrate)
+{
+	uint8_t sent[BENCHMARK_BYTES];
+	uint64_t start;
+	uint16_t count;
+	uint16_t i;
+
+	Benchmark_Setup(baudrate);
+	start = SIM_GetCycles();
+
+	i = 0;
+	while (i < BENCHMARK_BYTES) {
+		if (USART_TXBuffer_PutByte(&USART_data, (uint8_t) (i * 7))) {
+			i++;
+		} else {
+			SIM_Run(BENCHMARK_IDLE_CYCLES);
+		}
+	}
+
+	/* Wait for the last byte to leave the shift register. */
+	while (!SIM_USART_IsIdle(&USART)) {
+		SIM_Run(BENCHMARK_IDLE_CYCLES);
+	}
+
+	count = SIM_USART_Read(&USART, sent, BENCHMARK_BYTES);
+	Benchmark_Print("tx", baudrate, count, SIM_GetCycles() - start,
+	                USARTC0_DRE_vect_num);
+
+	for (i = 0; i < count; i++) {
+		if (sent[i] != (uint8_t) (i * 7)) {
+			return false;
+		}
+	}
+	return count == BENCHMARK_BYTES;
+}
+
+
+/*! \brief Receive BENCHMARK_BYTES bytes through the software buffer.
+ *
+ *  \return  True if all bytes were received unchanged.
+ */
+static bool Benchmark_Rx(uint32_t baudrate)
+{
+	uint8_t data[BENCHMARK_BYTES];
+	uint64_t start;
+	uint16_t received;
+	uint16_t i;
+	bool success = true;
+
+	for (i = 0; i < BENCHMARK_BYTES; i++) {
+		data[i] = (uint8_t) (i * 13);
+	}
+
+	Benchmark_Setup(baudrate);
+	start = SIM_GetCycles();
+	SIM_USART_Inject(&USART, data, BENCHMARK_BYTES);
+
+	received = 0;
+	while (!SIM_USART_IsIdle(&USART) || USART_RXBufferData_Available(&USART_data)) {
+		if (USART_RXBufferData_Available(&USART_data)) {
+			if (USART_RXBuffer_GetByte(&USART_data) != data[received]) {
+				success = false;
+			}
+			received++;
+		} else {
+			SIM_Run(BENCHMARK_IDLE_CYCLES);
+		}
+	}
+
+	Benchmark_Print("rx", baudrate, received, SIM_GetCycles() - start,
+	                USARTC0_RXC_vect_num);
+
+	return success && (received == BENCHMARK_BYTES);
+}
+
+
+/*! \brief Run all scenarios.
+ *
+ *  \return  0 if no data was lost or corrupted, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	/* PC3 (TXD0) as output. */
+	PORTC.DIRSET = PIN3_bm;
+	/* PC2 (RXD0) as input. */
+	PORTC.DIRCLR = PIN2_bm;
+
+	for (i = 0; i < sizeof(baudrates) / sizeof(baudrates[0]); i++) {
+		success &= Benchmark_Tx(baudrates[i]);
+		success &= Benchmark_Rx(baudrates[i]);
+	}
+
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Receive complete interrupt service routine.
+ *
+ *  Receive complete interrupt service routine.
+ *  Calls the common receive complete handler with pointer to the correct USART
+ *  as argument.
+ */
+ISR(USARTC0_RXC_vect)
+{
+	USART_RXComplete(&USART_data);
+}
+
+
+/*! \brief Data register empty  interrupt service routine.
+ *
+ *  Data register empty  interrupt service routine.
+ *  Calls the common data register empty complete handler with pointer to the
+ *  correct USART as argument.
+ */
+ISR(USARTC0_DRE_vect)
+{
+	USART_DataRegEmpty(&USART_data);
+}
@@ -0,0 +1,335 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host decoder for the XMEGA interrupt trace.
+ *
+ *      This program decodes a trace exported by TRACE_Export() and reports
+ *      per-vector interrupt statistics: number of calls, self time (time in
+ *      the ISR minus time in ISRs nesting on top of it), longest call, deepest
+ *      nesting, latency from TRACE_RAISE() to ISR entry and share of the CPU.
+ *
+ *      The trace is read from the file given as argument, or from standard
+ *      input, e.g. a capture of the USART with a terminal program. Data before
+ *      the 'T', 'R' sync bytes is skipped. Each vector prints one line of space
+ *      separated key=value pairs, followed by one summary line.
+ *
+ *      The 16-bit timestamps are unwrapped assuming less than 65536 ticks
+ *      between two records. Calls that started before the oldest record in the
+ *      ring, or did not end before TRACE_Stop(), are counted as truncated and
+ *      left out of the statistics.
+ *
+ *      Build and run on the host, from the directory holding trace_driver.h:
+ *        gcc -std=gnu99 -O2 tools/trace_decode.c -o trace_decode
+ *        ./trace_decode capture.bin
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*! Event ids and format version, as in trace_driver.h. */
+#define TRACE_ID_EXIT_bm  0x80
+#define TRACE_ID_USER     0x7D
+#define TRACE_ID_RAISE    0x7E
+#define TRACE_ID_EMPTY    0xFF
+#define TRACE_VERSION     1
+
+/*! Size of the export header in bytes. */
+#define TRACE_HEADER_SIZE  10
+
+/*! Size of one record in bytes. */
+#define TRACE_RECORD_SIZE  4
+
+/*! Largest input accepted, enough for a ring of 256 records. */
+#define DECODE_INPUT_MAX   4096
+
+/*! Deepest nesting tracked: three interrupt levels plus NMI. */
+#define DECODE_STACK_MAX   8
+
+/*! Number of interrupt vector ids. */
+#define DECODE_VECTORS     TRACE_ID_USER
+
+/*! Statistics of one interrupt vector. */
+typedef struct Decode_Vector_struct {
+	uint32_t count;
+	uint64_t selfTicks;
+	uint64_t maxTicks;
+	uint8_t maxDepth;
+	uint32_t latencyCount;
+	uint64_t latencyTotal;
+	uint64_t latencyMax;
+	bool raised;
+	uint64_t raiseTime;
+} Decode_Vector_t;
+
+/*! ISR call in progress. */
+typedef struct Decode_Call_struct {
+	uint8_t vectorNum;
+	uint64_t start;
+	uint64_t childTicks;
+} Decode_Call_t;
+
+static uint8_t input[DECODE_INPUT_MAX];
+static Decode_Vector_t vectors[DECODE_VECTORS];
+static Decode_Call_t stack[DECODE_STACK_MAX];
+static uint8_t depth;
+static uint32_t truncated;
+static uint32_t userEvents;
+
+
+/*! \brief Read a little endian value.
+ *
+ *  \param data   First byte.
+ *  \param bytes  Size of the value, 2 or 4.
+ */
+static uint32_t Decode_Read(const uint8_t * data, uint8_t bytes)
+{
+	uint32_t value = 0;
+
+	while (bytes--) {
+		value = (value << 8) | data[bytes];
+	}
+	return value;
+}
+
+
+/*! \brief Convert ticks to microseconds.
+ *
+ *  \param ticks   Number of ticks.
+ *  \param tickHz  Tick rate from the header.
+ */
+static unsigned long long Decode_Us(uint64_t ticks, uint32_t tickHz)
+{
+	return (unsigned long long) (ticks * 1000000 / tickHz);
+}
+
+
+/*! \brief Handle ISR entry.
+ *
+ *  \param vectorNum  Vector number.
+ *  \param time       Unwrapped timestamp.
+ */
+static void Decode_Enter(uint8_t vectorNum, uint64_t time)
+{
+	Decode_Vector_t * vector = &vectors[vectorNum];
+
+	if (vector->raised) {
+		uint64_t latency = time - vector->raiseTime;
+
+		vector->raised = false;
+		vector->latencyCount++;
+		vector->latencyTotal += latency;
+		if (latency > vector->latencyMax) {
+			vector->latencyMax = latency;
+		}
+	}
+
+	if (depth == DECODE_STACK_MAX) {
+		/* Entries without exits, the trace is not balanced. */
+		truncated += depth;
+		depth = 0;
+	}
+	stack[depth].vectorNum = vectorNum;
+	stack[depth].start = time;
+	stack[depth].childTicks = 0;
+	depth++;
+	if (depth > vector->maxDepth) {
+		vector->maxDepth = depth;
+	}
+}
+
+
+/*! \brief Handle ISR exit.
+ *
+ *  Calls above the matching entry that have no exit of their own are
+ *  dropped as truncated, as is an exit without an entry.
+ *
+ *  \param vectorNum  Vector number.
+ *  \param time       Unwrapped timestamp.
+ */
+static void Decode_Exit(uint8_t vectorNum, uint64_t time)
+{
+	Decode_Vector_t * vector = &vectors[vectorNum];
+	uint8_t level = depth;
+	uint64_t duration;
+
+	while (level > 0 && stack[level - 1].vectorNum != vectorNum) {
+		level--;
+	}
+	if (level == 0) {
+		truncated++;
+		return;
+	}
+	truncated += depth - level;
+	depth = level - 1;
+
+	duration = time - stack[depth].start;
+	vector->count++;
+	vector->selfTicks += duration - stack[depth].childTicks;
+	if (duration > vector->maxTicks) {
+		vector->maxTicks = duration;
+	}
+	if (depth > 0) {
+		stack[depth - 1].childTicks += duration;
+	}
+}
+
+
+/*! \brief Decode a trace and print the statistics.
+ *
+ *  \param argc  Number of arguments.
+ *  \param argv  Optional input file name.
+ *
+ *  \return  0 on success, 1 if the input is not a valid trace.
+ */
+int main(int argc, char * argv[])
+{
+	FILE * file = stdin;
+	size_t length;
+	size_t offset;
+	const uint8_t * ring;
+	uint8_t head;
+	uint16_t ringSize;
+	uint32_t tickHz;
+	uint16_t i;
+	uint16_t lastStamp = 0;
+	uint64_t time = 0;
+	uint32_t records = 0;
+
+	if (argc > 1) {
+		file = fopen(argv[1], "rb");
+		if (file == NULL) {
+			perror(argv[1]);
+			return 1;
+		}
+	}
+	length = fread(input, 1, sizeof(input), file);
+	if (file != stdin) {
+		fclose(file);
+	}
+
+	/* Find the header. */
+	for (offset = 0; offset + TRACE_HEADER_SIZE <= length; offset++) {
+		if (input[offset] == 'T' && input[offset + 1] == 'R' &&
+		    input[offset + 2] == TRACE_VERSION) {
+			break;
+		}
+	}
+	if (offset + TRACE_HEADER_SIZE > length) {
+		fprintf(stderr, "no trace header found\n");
+		return 1;
+	}
+	head = input[offset + 3];
+	ringSize = Decode_Read(&input[offset + 4], 2);
+	tickHz = Decode_Read(&input[offset + 6], 4);
+	ring = &input[offset + TRACE_HEADER_SIZE];
+	if (ringSize == 0 || ringSize > 256 || head >= ringSize || tickHz == 0 ||
+	    offset + TRACE_HEADER_SIZE + ringSize * TRACE_RECORD_SIZE > length) {
+		fprintf(stderr, "trace header invalid or trace incomplete\n");
+		return 1;
+	}
+
+	/* Walk the ring from the oldest record. */
+	for (i = 0; i < ringSize; i++) {
+		const uint8_t * record = &ring[((head + i) % ringSize) * TRACE_RECORD_SIZE];
+		uint16_t stamp = Decode_Read(record, 2);
+		uint8_t id = record[2];
+		uint8_t arg = record[3];
+
+		if (id == TRACE_ID_EMPTY) {
+			continue;
+		}
+		if (records == 0) {
+			lastStamp = stamp;
+		}
+		time += (uint16_t) (stamp - lastStamp);
+		lastStamp = stamp;
+		records++;
+
+		if (id == TRACE_ID_USER) {
+			userEvents++;
+		} else if (id == TRACE_ID_RAISE) {
+			if (arg < DECODE_VECTORS && !vectors[arg].raised) {
+				vectors[arg].raised = true;
+				vectors[arg].raiseTime = time;
+			}
+		} else if (id & TRACE_ID_EXIT_bm) {
+			if ((id & ~TRACE_ID_EXIT_bm) < DECODE_VECTORS) {
+				Decode_Exit(id & ~TRACE_ID_EXIT_bm, time);
+			}
+		} else {
+			Decode_Enter(id, time);
+		}
+	}
+	truncated += depth;
+
+	for (i = 0; i < DECODE_VECTORS; i++) {
+		const Decode_Vector_t * vector = &vectors[i];
+		uint64_t span = time;
+
+		if (vector->count == 0 && vector->latencyCount == 0) {
+			continue;
+		}
+		printf("vector=%u count=%lu self_us=%llu max_us=%llu max_depth=%u "
+		       "latency_count=%lu latency_avg_us=%llu latency_max_us=%llu "
+		       "load_permille=%llu\n",
+		       i,
+		       (unsigned long) vector->count,
+		       Decode_Us(vector->selfTicks, tickHz),
+		       Decode_Us(vector->maxTicks, tickHz),
+		       vector->maxDepth,
+		       (unsigned long) vector->latencyCount,
+		       Decode_Us(vector->latencyCount ?
+		                 vector->latencyTotal / vector->latencyCount : 0, tickHz),
+		       Decode_Us(vector->latencyMax, tickHz),
+		       (unsigned long long) (span ? vector->selfTicks * 1000 / span : 0));
+	}
+	printf("records=%lu span_us=%llu tick_hz=%lu truncated=%lu user_events=%lu\n",
+	       (unsigned long) records,
+	       Decode_Us(time, tickHz),
+	       (unsigned long) tickHz,
+	       (unsigned long) truncated,
+	       (unsigned long) userEvents);
+
+	return 0;
+}
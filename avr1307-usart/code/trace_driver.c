@@ -0,0 +1,179 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA interrupt trace driver source file.
+ *
+ *      This file contains the function implementations of the interrupt trace
+ *      driver: setting up the timestamp Timer/Counter, starting and stopping
+ *      the recording, and the DMA export of the ring. See trace_driver.h.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "trace_driver.h"
+
+/*! Trace buffer: export header and ring. */
+volatile TRACE_Buffer_t TRACE_buffer;
+
+/*! Records are only stored while this is set. */
+volatile bool TRACE_running;
+
+/*! Timer/Counter clock prescaler of each TC_CLKSEL_DIVn_gc setting. */
+static const uint16_t TRACE_prescaler[] = {0, 1, 2, 4, 8, 64, 256, 1024};
+
+
+
+/*! \brief Set up the timestamp Timer/Counter and start recording.
+ *
+ *  TRACE_TC is set up to count from 0 to 0xFFFF and wrap. The decoder
+ *  unwraps the timestamps, assuming records are less than 65536 ticks
+ *  apart. Select a prescaler that keeps the longest gap between events
+ *  below this, e.g. TC_CLKSEL_DIV8_gc gives 1 us resolution and 65 ms
+ *  range at 8 MHz.
+ *
+ *  \param clockSelect  Timer/Counter prescaler, TC_CLKSEL_DIV1_gc to
+ *                      TC_CLKSEL_DIV1024_gc.
+ */
+void TRACE_Init( TC_CLKSEL_t clockSelect )
+{
+	TRACE_TC.CTRLA = TC_CLKSEL_OFF_gc;
+	TRACE_TC.CTRLB = TC_WGMODE_NORMAL_gc;
+	TRACE_TC.PER = 0xFFFF;
+	TRACE_TC.CNT = 0;
+	TRACE_TC.CTRLA = clockSelect;
+
+	TRACE_buffer.header.sync[0] = 'T';
+	TRACE_buffer.header.sync[1] = 'R';
+	TRACE_buffer.header.version = TRACE_VERSION;
+	TRACE_buffer.header.ringSize = TRACE_RING_SIZE;
+	TRACE_buffer.header.tickHz = F_CPU / TRACE_prescaler[clockSelect & TC0_CLKSEL_gm];
+
+	TRACE_Start();
+}
+
+
+
+/*! \brief Clear the ring and start recording. */
+void TRACE_Start( void )
+{
+	uint16_t i;
+
+	TRACE_running = false;
+	for ( i = 0; i < TRACE_RING_SIZE; i++ ) {
+		TRACE_buffer.ring[i].id = TRACE_ID_EMPTY;
+	}
+	TRACE_buffer.header.head = 0;
+	TRACE_running = true;
+}
+
+
+
+/*! \brief Stop recording.
+ *
+ *  The ring keeps the records up to this point, like a logic analyzer
+ *  stopped by a trigger. Call it when a latency spike has been detected,
+ *  before TRACE_Export().
+ */
+void TRACE_Stop( void )
+{
+	TRACE_running = false;
+}
+
+
+
+/*! \brief Send the trace buffer over a USART by DMA.
+ *
+ *  Recording is stopped, and the header and the ring are sent as one DMA
+ *  block transfer, one byte per data register empty trigger. The USART
+ *  must be set up with the transmitter enabled, and its baud rate known
+ *  to the host. The CPU is free while the export runs; check
+ *  TRACE_IsExportDone() before starting recording again.
+ *
+ *  \param usart    USART to send on.
+ *  \param channel  DMA channel to use.
+ *  \param trigger  Data register empty trigger of the USART, e.g.
+ *                  DMA_CH_TRIGSRC_USARTD0_DRE_gc.
+ */
+void TRACE_Export( USART_t * usart,
+                   volatile DMA_CH_t * channel,
+                   DMA_CH_TRIGSRC_t trigger )
+{
+	uint32_t srcAddr = (uint32_t) &TRACE_buffer;
+	uint32_t destAddr = (uint32_t) &usart->DATA;
+
+	TRACE_Stop();
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+	channel->ADDRCTRL = DMA_CH_SRCRELOAD_NONE_gc | DMA_CH_SRCDIR_INC_gc |
+	                    DMA_CH_DESTRELOAD_NONE_gc | DMA_CH_DESTDIR_FIXED_gc;
+	channel->TRIGSRC = trigger;
+	channel->TRFCNT = sizeof( TRACE_buffer );
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = ( srcAddr >> 0*8 ) & 0xFF;
+	channel->SRCADDR1 = ( srcAddr >> 1*8 ) & 0xFF;
+	channel->SRCADDR2 = ( srcAddr >> 2*8 ) & 0xFF;
+
+	channel->DESTADDR0 = ( destAddr >> 0*8 ) & 0xFF;
+	channel->DESTADDR1 = ( destAddr >> 1*8 ) & 0xFF;
+	channel->DESTADDR2 = ( destAddr >> 2*8 ) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Test if the export has been sent.
+ *
+ *  \param channel  DMA channel given to TRACE_Export().
+ *
+ *  \retval true   The whole trace buffer has been handed to the USART.
+ *  \retval false  The export is still running.
+ */
+bool TRACE_IsExportDone( volatile DMA_CH_t * channel )
+{
+	return ( channel->CTRLB & ( DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm ) ) != 0;
+}
@@ -0,0 +1,227 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA interrupt trace driver header file.
+ *
+ *      This file contains the record macros, type definitions and function
+ *      prototypes of the interrupt trace driver. The driver records ISR entry
+ *      and exit, interrupt requests and user events as 4-byte records
+ *      {timestamp, event id, argument} in a RAM ring, and exports the ring over
+ *      a spare USART by DMA in a compact binary format. The host decoder in
+ *      tools/trace_decode.c reconstructs per-ISR execution time, latency,
+ *      nesting and CPU share from the export.
+ *
+ *      Recording takes a timestamp from a free running Timer/Counter and stores
+ *      the record with interrupts disabled for the few instructions needed to
+ *      claim a ring slot, so nested interrupts of a higher level cannot tear a
+ *      record. There is no formatting and no other locking.
+ *
+ *      The trace macros are opt-in: unless TRACE_ENABLED is defined, they expand
+ *      to nothing and trace_driver.c does not need to be part of the project.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef TRACE_DRIVER_H
+#define TRACE_DRIVER_H
+
+#include "avr_compiler.h"
+
+/* Definition of macros. */
+
+#ifndef TRACE_RING_SIZE
+/*! Number of records in the ring, a power of 2 of at most 256. */
+#define TRACE_RING_SIZE   128
+#endif
+
+#ifndef TRACE_TC
+/*! Timer/Counter giving the timestamps. It is left free running. */
+#define TRACE_TC          TCD1
+#endif
+
+#define TRACE_RING_MASK   ( TRACE_RING_SIZE - 1 )
+
+#if ( TRACE_RING_SIZE & TRACE_RING_MASK ) || ( TRACE_RING_SIZE > 256 )
+#error Trace ring size must be a power of 2 of at most 256
+#endif
+
+/*! \brief Event ids.
+ *
+ *  Ids below TRACE_ID_USER are interrupt vector numbers and mark ISR
+ *  entry; the same id with TRACE_ID_EXIT_bm set marks ISR exit.
+ */
+#define TRACE_ID_EXIT_bm  0x80
+/*! User event, the argument is free for the application. */
+#define TRACE_ID_USER     0x7D
+/*! Interrupt requested, the argument is the vector number. */
+#define TRACE_ID_RAISE    0x7E
+/*! Id of a ring slot that has not been written. */
+#define TRACE_ID_EMPTY    0xFF
+
+/*! Export format version, see TRACE_Header_t. */
+#define TRACE_VERSION     1
+
+#ifdef TRACE_ENABLED
+
+/*! \brief Record ISR entry.
+ *
+ *  Put first in the ISR. The argument is PMIC.STATUS, which shows the
+ *  interrupt levels executing.
+ *
+ *  \param _vectorNum  Vector number of the ISR, e.g. USARTC0_RXC_vect_num.
+ */
+#define TRACE_ISR_ENTER( _vectorNum )  TRACE_Record( (_vectorNum), PMIC.STATUS )
+
+/*! \brief Record ISR exit.
+ *
+ *  Put last in the ISR.
+ *
+ *  \param _vectorNum  Vector number of the ISR.
+ */
+#define TRACE_ISR_EXIT( _vectorNum )   TRACE_Record( (_vectorNum) | TRACE_ID_EXIT_bm, 0 )
+
+/*! \brief Record that an interrupt is requested.
+ *
+ *  Put where the software causes an interrupt request, e.g. when the DRE
+ *  interrupt is enabled or an ADC conversion is started. The decoder
+ *  reports the time from here to the next entry of the ISR as its latency.
+ *
+ *  \param _vectorNum  Vector number of the interrupt requested.
+ */
+#define TRACE_RAISE( _vectorNum )      TRACE_Record( TRACE_ID_RAISE, (_vectorNum) )
+
+/*! \brief Record a user event.
+ *
+ *  \param _arg  Any 8-bit value.
+ */
+#define TRACE_USER( _arg )             TRACE_Record( TRACE_ID_USER, (_arg) )
+
+#else
+
+#define TRACE_ISR_ENTER( _vectorNum )
+#define TRACE_ISR_EXIT( _vectorNum )
+#define TRACE_RAISE( _vectorNum )
+#define TRACE_USER( _arg )
+
+#endif
+
+
+/*! \brief Trace record, as exported. */
+typedef struct TRACE_Record_struct {
+	/*! TRACE_TC count when the event was recorded. */
+	uint16_t timestamp;
+	/*! Event id, see TRACE_ID_USER. */
+	uint8_t id;
+	/*! Event argument. */
+	uint8_t arg;
+} TRACE_Record_t;
+
+/*! \brief Export header, followed by the ring.
+ *
+ *  All fields are little endian. The ring is exported in memory order;
+ *  the oldest record is at index \a head. Slots with id TRACE_ID_EMPTY
+ *  have not been written since TRACE_Start().
+ */
+typedef struct TRACE_Header_struct {
+	/*! 'T', 'R'. */
+	uint8_t sync[2];
+	/*! TRACE_VERSION. */
+	uint8_t version;
+	/*! Index of the next record to write, which is the oldest record. */
+	uint8_t head;
+	/*! Number of records in the ring. */
+	uint16_t ringSize;
+	/*! TRACE_TC count rate in Hz. */
+	uint32_t tickHz;
+} TRACE_Header_t;
+
+/*! \brief Trace buffer: the export header directly followed by the ring,
+ *         so it is sent by a single DMA block transfer.
+ */
+typedef struct TRACE_Buffer_struct {
+	TRACE_Header_t header;
+	TRACE_Record_t ring[TRACE_RING_SIZE];
+} TRACE_Buffer_t;
+
+extern volatile TRACE_Buffer_t TRACE_buffer;
+extern volatile bool TRACE_running;
+
+
+/* Prototyping of functions. */
+
+void TRACE_Init( TC_CLKSEL_t clockSelect );
+void TRACE_Start( void );
+void TRACE_Stop( void );
+void TRACE_Export( USART_t * usart,
+                   volatile DMA_CH_t * channel,
+                   DMA_CH_TRIGSRC_t trigger );
+bool TRACE_IsExportDone( volatile DMA_CH_t * channel );
+
+
+/*! \brief Store a record in the ring.
+ *
+ *  Use the TRACE_ macros rather than calling this directly, so that the
+ *  calls go away when TRACE_ENABLED is not defined.
+ *
+ *  \param id   Event id.
+ *  \param arg  Event argument.
+ */
+INLINE void TRACE_Record( uint8_t id, uint8_t arg )
+{
+	if ( TRACE_running ) {
+		/* Not AVR_ENTER_CRITICAL_REGION(), its volatile copy of SREG
+		 * would need a stack frame. */
+		uint8_t sreg = SREG;
+		uint8_t head;
+		volatile TRACE_Record_t * record;
+
+		cli();
+		head = TRACE_buffer.header.head;
+		record = &TRACE_buffer.ring[head];
+		record->timestamp = TRACE_TC.CNT;
+		record->id = id;
+		record->arg = arg;
+		TRACE_buffer.header.head = ( head + 1 ) & TRACE_RING_MASK;
+		SREG = sreg;
+	}
+}
+
+#endif
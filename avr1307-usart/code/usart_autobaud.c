@@ -0,0 +1,369 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART auto-baud detector source file.
+ *
+ *      This file contains the function implementations of the auto-baud
+ *      detector. See usart_autobaud.h for how the detector works.
+ *
+ *      AUTOBAUD_CaptureComplete() runs between the last falling edge of the sync
+ *      character and the start bit of the verify character, two bit times later.
+ *      It takes a fixed number of 16-bit operations and shifts; there is no
+ *      division on this path.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "usart_autobaud.h"
+
+/*! Timer/Counter clock prescaler of each TC_CLKSEL_DIVn_gc setting, as a
+ *  power of two. */
+static const uint8_t AUTOBAUD_prescalerShift[] = {0, 0, 1, 2, 3, 6, 8, 10};
+
+
+
+/*! \brief Start the DMA channel copying capture values.
+ *
+ *  The channel copies CCA to the capture buffer on each capture, two bytes
+ *  per capture A trigger, until the buffer is full.
+ *
+ *  \param ab     The detector.
+ *  \param first  Index of the first capture value to write.
+ */
+static void AUTOBAUD_DMA_Start(AUTOBAUD_t * ab, uint8_t first)
+{
+	volatile DMA_CH_t * channel = ab->dmaChannel;
+	uint32_t srcAddr = (uint32_t) (uintptr_t) &ab->tc->CCA;
+	uint32_t destAddr = (uint32_t) (uintptr_t) &ab->captures[first];
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm | ab->dmaIntLevel;
+	channel->ADDRCTRL = DMA_CH_SRCRELOAD_BURST_gc | DMA_CH_SRCDIR_INC_gc |
+	                    DMA_CH_DESTRELOAD_NONE_gc | DMA_CH_DESTDIR_INC_gc;
+	channel->TRIGSRC = ab->captureTrigger;
+	channel->TRFCNT = (AUTOBAUD_EDGES - first) * sizeof(uint16_t);
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_2BYTE_gc;
+}
+
+
+
+/*! \brief Calculate the bit time error of a baud rate setting.
+ *
+ *  \param cycles8  Measured time of eight bits, in CPU cycles.
+ *  \param setting  Setting found by AUTOBAUD_Solve().
+ *
+ *  \return  Error in units of 0.01 %.
+ */
+static uint16_t AUTOBAUD_Error(uint32_t cycles8, const USART_Baud_t * setting)
+{
+	uint32_t d = setting->clk2x ? 64 : 128;
+	uint32_t measured;
+	uint32_t actual;
+	uint32_t diff;
+
+	/* Eight bit times, scaled by 2^-BSCALE for a negative BSCALE. */
+	if (setting->bscale < 0) {
+		uint8_t shift = -setting->bscale;
+
+		measured = cycles8 << shift;
+		actual = setting->bsel * d + (d << shift);
+	} else {
+		measured = cycles8;
+		actual = ((setting->bsel + 1) * d) << setting->bscale;
+	}
+
+	diff = (actual > measured) ? actual - measured : measured - actual;
+	return (uint16_t) (diff * 10000 / measured);
+}
+
+
+
+/*! \brief Initialize the auto-baud detector and start looking for the
+ *         sync character.
+ *
+ *  The USART must have been set up for the frame format, with the receiver
+ *  disabled. The timer runs from the CPU clock with the smallest prescaler
+ *  that fits two and a half bit times of the lowest baud rate in 16 bits,
+ *  so a low minBaudrate costs resolution at high baud rates.
+ *
+ *  \param ab              The detector.
+ *  \param usart           USART whose baud rate is detected.
+ *  \param tc              Timer/Counter capturing the falling edges.
+ *  \param eventChannel    Event channel routing RXD to the timer, 0 to 7.
+ *  \param rxdPin          Event source of the RXD pin, e.g.
+ *                         EVSYS_CHMUX_PORTC_PIN2_gc for USARTC0.
+ *  \param dmaChannel      DMA channel copying the capture values.
+ *  \param captureTrigger  Capture A trigger of the timer, e.g.
+ *                         DMA_CH_TRIGSRC_TCC0_CCA_gc.
+ *  \param minBaudrate     Lowest baud rate to detect.
+ *  \param verifyChar      Character the peer sends after the sync character.
+ *  \param dmaIntLevel     DMA transaction complete interrupt level.
+ *  \param rxIntLevel      RXC interrupt level.
+ */
+void AUTOBAUD_Init(AUTOBAUD_t * ab,
+                   USART_t * usart,
+                   TC0_t * tc,
+                   uint8_t eventChannel,
+                   EVSYS_CHMUX_t rxdPin,
+                   volatile DMA_CH_t * dmaChannel,
+                   DMA_CH_TRIGSRC_t captureTrigger,
+                   uint32_t minBaudrate,
+                   uint8_t verifyChar,
+                   DMA_CH_TRNINTLVL_t dmaIntLevel,
+                   USART_RXCINTLVL_t rxIntLevel)
+{
+	/* PORTA to PORTF follow each other in the I/O memory, like their
+	 * event sources. The ports are 0x20 bytes apart, more than the size
+	 * of PORT_t. */
+	PORT_t * port = (PORT_t *) ((uintptr_t) &PORTA +
+	                            ((rxdPin - EVSYS_CHMUX_PORTA_PIN0_gc) >> 3) * 0x20);
+	volatile uint8_t * pinCtrl = &port->PIN0CTRL + (rxdPin & 0x07);
+	uint32_t cycles = (uint32_t) (((uint64_t) F_CPU * 5) / (2 * minBaudrate));
+	uint8_t clockSelect = TC_CLKSEL_DIV1_gc;
+
+	ab->usart = usart;
+	ab->tc = tc;
+	ab->dmaChannel = dmaChannel;
+	ab->captureTrigger = captureTrigger;
+	ab->dmaIntLevel = dmaIntLevel;
+	ab->rxIntLevel = rxIntLevel;
+	ab->verifyChar = verifyChar;
+	ab->measurements = 0;
+	ab->failures = 0;
+
+	while ((clockSelect < TC_CLKSEL_DIV1024_gc) &&
+	       ((cycles >> AUTOBAUD_prescalerShift[clockSelect]) > 0xFFFF)) {
+		clockSelect++;
+	}
+	ab->clockSelect = (TC_CLKSEL_t) clockSelect;
+	ab->prescalerShift = AUTOBAUD_prescalerShift[clockSelect];
+
+	/* Every falling edge on RXD is captured in CCA. */
+	*pinCtrl = (*pinCtrl & ~PORT_ISC_gm) | PORT_ISC_FALLING_gc;
+	EVSYS_SetEventSource(eventChannel, rxdPin);
+
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->CTRLB = TC0_CCAEN_bm | TC_WGMODE_NORMAL_gc;
+	tc->CTRLD = TC_EVACT_CAPT_gc | (TC_EVSEL_CH0_gc + eventChannel);
+	tc->PER = 0xFFFF;
+	tc->CNT = 0;
+	tc->CTRLA = clockSelect;
+
+	USART_RxdInterruptLevel_Set(usart, rxIntLevel);
+	DMA.CTRL |= DMA_ENABLE_bm;
+	AUTOBAUD_Start(ab);
+}
+
+
+
+/*! \brief Look for a new sync character.
+ *
+ *  The receiver is disabled until the next sync character has been
+ *  measured. Call this to follow a peer that changes its baud rate.
+ *
+ *  \param ab  The detector.
+ */
+void AUTOBAUD_Start(AUTOBAUD_t * ab)
+{
+	USART_Rx_Disable(ab->usart);
+	ab->state = AUTOBAUD_STATE_SYNC;
+
+	/* Drop a capture made before now. */
+	ab->tc->INTFLAGS = TC0_CCAIF_bm;
+	AUTOBAUD_DMA_Start(ab, 0);
+}
+
+
+
+/*! \brief Find the baud rate setting for a measured bit time.
+ *
+ *  Normal speed is used when a bit is at least 32 CPU cycles, double speed
+ *  (CLK2X) down to 16 cycles. The finest BSCALE that keeps BSEL within 12
+ *  bits is chosen, starting from -7, where BSEL is the eight bit time minus
+ *  128 cycles. With the 2^BSCALE steps and the 8 or 16 samples per bit both
+ *  powers of two, only shifts are needed.
+ *
+ *  \param cycles8  Time of eight bits, in CPU cycles.
+ *  \param setting  Setting found, without the error.
+ *
+ *  \retval true   A setting was found.
+ *  \retval false  The bit time is too short or too long.
+ */
+bool AUTOBAUD_Solve(uint32_t cycles8, USART_Baud_t * setting)
+{
+	bool clk2x = (cycles8 < 256);
+	uint8_t dShift = clk2x ? 6 : 7;
+	uint32_t d = 1UL << dShift;
+	int8_t bscale;
+	uint32_t bsel;
+
+	if (cycles8 < 2 * d) {
+		return false;
+	}
+	setting->clk2x = clk2x;
+
+	/* f_baud = f / ( d / 8 * ( 2^BSCALE * BSEL + 1 ) ). */
+	for (bscale = -7; bscale < 0; bscale++) {
+		uint8_t shift = -bscale;
+
+		if (cycles8 <= d + ((4095UL << dShift) >> shift)) {
+			bsel = (((cycles8 - d) << shift) + d / 2) >> dShift;
+			setting->bsel = (uint16_t) bsel;
+			setting->bscale = bscale;
+			return true;
+		}
+	}
+
+	/* f_baud = f / ( d / 8 * 2^BSCALE * ( BSEL + 1 ) ). */
+	for (bscale = 0; bscale <= 7; bscale++) {
+		uint8_t shift = dShift + bscale;
+
+		bsel = ((cycles8 + (1UL << (shift - 1))) >> shift) - 1;
+		if (bsel <= 4095) {
+			setting->bsel = (uint16_t) bsel;
+			setting->bscale = bscale;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+/*! \brief DMA transaction complete Interrupt Service Routine.
+ *
+ *  To be called from the interrupt of the DMA channel, when the five
+ *  capture values are in. If the intervals between them are within a
+ *  quarter of their average, the time of eight bits is programmed and the
+ *  receiver enabled for the verify character. Otherwise the oldest edge is
+ *  dropped and the channel copies one more capture value.
+ *
+ *  \param ab  The detector.
+ */
+void AUTOBAUD_CaptureComplete(AUTOBAUD_t * ab)
+{
+	volatile uint16_t * captures = ab->captures;
+	uint32_t ticks8 = 0;
+	uint16_t interval;
+	uint16_t average;
+	uint16_t tolerance;
+	bool even = true;
+	uint8_t i;
+
+	/* Clear the flags by writing one. */
+	ab->dmaChannel->CTRLB |= DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+
+	/* The timer wraps, but each interval fits in 16 bits. */
+	for (i = 1; i < AUTOBAUD_EDGES; i++) {
+		ticks8 += (uint16_t) (captures[i] - captures[i - 1]);
+	}
+	average = (uint16_t) (ticks8 >> 2);
+	tolerance = average >> 2;
+	for (i = 1; i < AUTOBAUD_EDGES; i++) {
+		interval = captures[i] - captures[i - 1];
+		if ((interval + tolerance < average) || (interval > average + tolerance)) {
+			even = false;
+		}
+	}
+
+	if (even) {
+		ab->cycles8 = ticks8 << ab->prescalerShift;
+		if (AUTOBAUD_Solve(ab->cycles8, &ab->setting)) {
+			USART_Baudrate_Apply(ab->usart, &ab->setting);
+			USART_Rx_Enable(ab->usart);
+			ab->state = AUTOBAUD_STATE_VERIFY;
+			ab->measurements++;
+			return;
+		}
+	}
+
+	/* Not a sync character: slide the window by one edge. */
+	for (i = 1; i < AUTOBAUD_EDGES; i++) {
+		captures[i - 1] = captures[i];
+	}
+	AUTOBAUD_DMA_Start(ab, AUTOBAUD_EDGES - 1);
+}
+
+
+
+/*! \brief Receive Complete Interrupt Service Routine while not locked.
+ *
+ *  To be called from the RXC interrupt of the USART until the detector is
+ *  locked; after that the interrupt belongs to the application. The
+ *  character after the sync character must be the verify character,
+ *  without frame, parity or overflow error. Otherwise the measurement was
+ *  wrong and the detector looks for a new sync character.
+ *
+ *  \param ab  The detector.
+ *
+ *  \retval true   The baud rate is verified and the detector locked.
+ *  \retval false  Verification failed.
+ */
+bool AUTOBAUD_RXComplete(AUTOBAUD_t * ab)
+{
+	USART_t * usart = ab->usart;
+	uint8_t status = usart->STATUS;
+	uint8_t data = usart->DATA;
+
+	if ((ab->state == AUTOBAUD_STATE_VERIFY) &&
+	    !(status & (USART_FERR_bm | USART_PERR_bm | USART_BUFOVF_bm)) &&
+	    (data == ab->verifyChar)) {
+		ab->setting.error = AUTOBAUD_Error(ab->cycles8, &ab->setting);
+		ab->state = AUTOBAUD_STATE_LOCKED;
+		return true;
+	}
+
+	ab->failures++;
+	AUTOBAUD_Start(ab);
+	return false;
+}
@@ -0,0 +1,170 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART auto-baud detector header file.
+ *
+ *      This file contains the type definitions, macros and function prototypes
+ *      of the auto-baud detector. The detector measures the bit time of a sync
+ *      character on the RXD pin, programs the closest baud rate setting and
+ *      verifies it on the character that follows, so a peer can change its baud
+ *      rate without a fixed setting on this side.
+ *
+ *      The sync character is 0x55 ('U'), which has a falling edge every second
+ *      bit time: at the start bit and at data bits 1, 3, 5 and 7. The falling
+ *      edges on RXD are routed through the event system to an input capture
+ *      channel of a Timer/Counter 0, and a DMA channel copies the five capture
+ *      values to memory, so the CPU is not involved while the character is
+ *      received. The DMA transaction complete interrupt then checks that the
+ *      edges are evenly spaced, takes the time of eight bits from the first to
+ *      the last edge, and programs BSEL, BSCALE and CLK2X. The setting is found
+ *      with shifts only: the finest BSCALE that keeps BSEL within 12 bits is
+ *      used, so the bit time is matched to one CPU cycle over eight bits at
+ *      high baud rates.
+ *
+ *      The receiver is enabled before the stop bit of the sync character has
+ *      ended, and the next character received must be the verify character
+ *      without frame or parity error. Otherwise the detector starts over. The
+ *      whole sequence takes no CPU time until the fifth edge, and the interrupt
+ *      must finish within the two bit times before the verify character starts.
+ *      With about 300 CPU cycles for the interrupt, this limits the detector to
+ *      about 190 kbaud at 32 MHz.
+ *
+ *      Edges that do not belong to a sync character are dropped one at a time,
+ *      so the detector finds a sync character inside other traffic. Evenly
+ *      spaced edges of other characters, or a pause that wraps the timer, can
+ *      give a wrong measurement, which the verify character then rejects. The
+ *      peer should send the sync and verify characters again until it gets an
+ *      answer.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef USART_AUTOBAUD_H
+#define USART_AUTOBAUD_H
+
+#include "avr_compiler.h"
+#include "usart_driver.h"
+#include "event_system_driver.h"
+
+/* Definition of macros. */
+
+/*! Sync character sent by the peer before the verify character. */
+#define AUTOBAUD_SYNC_CHAR     0x55
+
+/*! Falling edges of the sync character, two bit times apart. */
+#define AUTOBAUD_EDGES         5
+
+
+/*! \brief Test if the detector has found and verified the baud rate.
+ *
+ *  \param _ab  Pointer to the detector.
+ */
+#define AUTOBAUD_IsLocked(_ab)  ((_ab)->state == AUTOBAUD_STATE_LOCKED)
+
+
+/*! \brief State of the detector. */
+typedef enum AUTOBAUD_State_enum {
+	/*! Capturing the falling edges of the sync character. */
+	AUTOBAUD_STATE_SYNC = 0,
+	/*! Baud rate set, waiting for the verify character. */
+	AUTOBAUD_STATE_VERIFY = 1,
+	/*! Baud rate verified. */
+	AUTOBAUD_STATE_LOCKED = 2,
+} AUTOBAUD_State_t;
+
+
+/*! \brief Auto-baud detector.
+ *
+ *  The struct holds the USART, timer and DMA channel setup, and the capture
+ *  values written by the DMA channel, so it must be in internal SRAM.
+ */
+typedef struct AUTOBAUD_struct {
+	/*! USART whose baud rate is detected. */
+	USART_t * usart;
+	/*! Timer/Counter capturing the falling edges on channel A. */
+	TC0_t * tc;
+	/*! DMA channel copying the capture values. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! Capture A trigger of the timer, e.g. DMA_CH_TRIGSRC_TCC0_CCA_gc. */
+	DMA_CH_TRIGSRC_t captureTrigger;
+	/*! DMA transaction complete interrupt level. */
+	DMA_CH_TRNINTLVL_t dmaIntLevel;
+	/*! RXC interrupt level, kept when locked. */
+	USART_RXCINTLVL_t rxIntLevel;
+	/*! Clock selection of the timer. */
+	TC_CLKSEL_t clockSelect;
+	/*! Timer prescaler as a power of two. */
+	uint8_t prescalerShift;
+	/*! Character expected after the sync character. */
+	uint8_t verifyChar;
+	/*! Detector state. */
+	volatile AUTOBAUD_State_t state;
+	/*! Capture values of the falling edges, oldest first. */
+	volatile uint16_t captures[AUTOBAUD_EDGES];
+	/*! Measured time of eight bits, in CPU cycles. */
+	uint32_t cycles8;
+	/*! Baud rate setting programmed; the error is set when locked. */
+	USART_Baud_t setting;
+	/*! Measurements made, and those rejected by the verify character. */
+	uint16_t measurements;
+	uint16_t failures;
+} AUTOBAUD_t;
+
+
+/* Prototyping of functions. */
+
+void AUTOBAUD_Init(AUTOBAUD_t * ab,
+                   USART_t * usart,
+                   TC0_t * tc,
+                   uint8_t eventChannel,
+                   EVSYS_CHMUX_t rxdPin,
+                   volatile DMA_CH_t * dmaChannel,
+                   DMA_CH_TRIGSRC_t captureTrigger,
+                   uint32_t minBaudrate,
+                   uint8_t verifyChar,
+                   DMA_CH_TRNINTLVL_t dmaIntLevel,
+                   USART_RXCINTLVL_t rxIntLevel);
+void AUTOBAUD_Start(AUTOBAUD_t * ab);
+bool AUTOBAUD_Solve(uint32_t cycles8, USART_Baud_t * setting);
+void AUTOBAUD_CaptureComplete(AUTOBAUD_t * ab);
+bool AUTOBAUD_RXComplete(AUTOBAUD_t * ab);
+
+#endif
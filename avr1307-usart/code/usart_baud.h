@@ -0,0 +1,465 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART compile-time baud rate solver.
+ *
+ *      This file selects the baud rate settings for a USART at compile time.
+ *      All combinations of BSCALE (-7 to 7) and CLK2X are tried, and the BSEL,
+ *      BSCALE and CLK2X setting giving the smallest bit time error is chosen.
+ *      Compilation fails if the error is above a limit.
+ *
+ *      The file has no include guard. To select another baud rate later in the
+ *      same file, undefine USART_BAUD_RATE, define the new rate and include
+ *      the file again. The results then refer to the new rate.
+ *
+ *      \code
+ *      #define USART_BAUD_RATE 115200
+ *      #include "usart_baud.h"
+ *
+ *      USART_Baudrate_Set(&USARTC0, USART_BSEL_VALUE, USART_BSCALE_VALUE);
+ *      \endcode
+ *
+ *      Input macros:
+ *      - USART_BAUD_RATE: Baud rate in bit/s. Required.
+ *      - USART_BAUD_CLOCK: Peripheral clock in Hz. Defaults to F_CPU.
+ *      - USART_BAUD_MAX_ERROR: Largest error accepted, in units of 0.01 %.
+ *        Defaults to 100 (1 %).
+ *
+ *      Output macros:
+ *      - USART_BSEL_VALUE, USART_BSCALE_VALUE: Baud rate register settings.
+ *      - USART_CLK2X_VALUE: 1 if double speed mode (CLK2X) must be enabled.
+ *      - USART_BAUD_ERROR: Bit time error, in units of 0.01 %.
+ *
+ *      The same search is done at runtime by USART_Baudrate_Solve().
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "avr_compiler.h"
+
+#ifndef USART_BAUD_RATE
+#error USART_BAUD_RATE must be defined before including usart_baud.h
+#endif
+
+#ifndef USART_BAUD_CLOCK
+#define USART_BAUD_CLOCK F_CPU
+#endif
+
+#ifndef USART_BAUD_MAX_ERROR
+#define USART_BAUD_MAX_ERROR 100
+#endif
+
+#undef USART_BSEL_VALUE
+#undef USART_BSCALE_VALUE
+#undef USART_CLK2X_VALUE
+#undef USART_BAUD_ERROR
+
+
+/* Helper macros. _d is the number of samples per bit, 16 or 8 with CLK2X,
+ * and _s is BSCALE.
+ */
+
+/*! \brief Ideal clock to baud rate ratio, with 7 fraction bits. */
+#define USART_BAUD_R128( _d ) \
+	( ( (USART_BAUD_CLOCK) * 128LL + (_d) * (USART_BAUD_RATE) / 2 ) / \
+	  ( (_d) * 1LL * (USART_BAUD_RATE) ) )
+
+/*! \brief 2^BSCALE for positive BSCALE, else 1. */
+#define USART_BAUD_POS( _s )   ( 1LL << ( (_s) > 0 ? (_s) : 0 ) )
+
+/*! \brief 2^-BSCALE for negative BSCALE, else 1. */
+#define USART_BAUD_NEG( _s )   ( 1LL << ( (_s) < 0 ? -(_s) : 0 ) )
+
+/*! \brief Rounded BSEL for a setting.
+ *
+ *  BSCALE >= 0: f_baud = f / ( d * 2^BSCALE * (BSEL + 1) ).
+ *  BSCALE < 0:  f_baud = f / ( d * ( 2^BSCALE * BSEL + 1 ) ).
+ */
+#define USART_BAUD_BSEL( _d, _s ) \
+	( (_s) >= 0 ? \
+	  ( USART_BAUD_R128(_d) + 64 * USART_BAUD_POS(_s) ) / ( 128 * USART_BAUD_POS(_s) ) - 1 : \
+	  ( ( USART_BAUD_R128(_d) - 128 ) * USART_BAUD_NEG(_s) + 64 ) / 128 )
+
+/*! \brief Actual clock to baud rate ratio, with 7 fraction bits. */
+#define USART_BAUD_A128( _d, _s ) \
+	( (_s) >= 0 ? \
+	  ( USART_BAUD_BSEL(_d, _s) + 1 ) * 128 * USART_BAUD_POS(_s) : \
+	  128 + USART_BAUD_BSEL(_d, _s) * 128 / USART_BAUD_NEG(_s) )
+
+/*! \brief Non-zero if the setting can be used. With negative BSCALE, the
+ *         integer part of the ratio must be at least two.
+ */
+#define USART_BAUD_VALID( _d, _s ) \
+	( ( USART_BAUD_BSEL(_d, _s) >= 0 ) && ( USART_BAUD_BSEL(_d, _s) <= 4095 ) && \
+	  ( (_s) >= 0 || USART_BAUD_BSEL(_d, _s) >= USART_BAUD_NEG(_s) ) )
+
+/*! \brief Bit time error of a setting, scaled by 128 x f. */
+#define USART_BAUD_DIFF( _d, _s ) \
+	( (USART_BAUD_CLOCK) * 128LL > USART_BAUD_A128(_d, _s) * (_d) * (USART_BAUD_RATE) ? \
+	  (USART_BAUD_CLOCK) * 128LL - USART_BAUD_A128(_d, _s) * (_d) * (USART_BAUD_RATE) : \
+	  USART_BAUD_A128(_d, _s) * (_d) * (USART_BAUD_RATE) - (USART_BAUD_CLOCK) * 128LL )
+
+/* Internal state of the search. The initial best setting is only used
+ * for comparison when no valid setting has been found yet.
+ */
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  0
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 0
+
+
+/* Try all settings, normal speed first. Ties keep the earlier setting. */
+#if USART_BAUD_VALID( 16, 0 )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 0
+#endif
+#if USART_BAUD_VALID( 16, -1 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -1 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -1
+#endif
+#if USART_BAUD_VALID( 16, -2 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -2 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -2
+#endif
+#if USART_BAUD_VALID( 16, -3 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -3 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -3
+#endif
+#if USART_BAUD_VALID( 16, -4 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -4 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -4
+#endif
+#if USART_BAUD_VALID( 16, -5 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -5 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -5
+#endif
+#if USART_BAUD_VALID( 16, -6 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -6 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -6
+#endif
+#if USART_BAUD_VALID( 16, -7 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, -7 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S -7
+#endif
+#if USART_BAUD_VALID( 16, 1 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 1 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 1
+#endif
+#if USART_BAUD_VALID( 16, 2 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 2 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 2
+#endif
+#if USART_BAUD_VALID( 16, 3 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 3 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 3
+#endif
+#if USART_BAUD_VALID( 16, 4 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 4 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 4
+#endif
+#if USART_BAUD_VALID( 16, 5 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 5 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 5
+#endif
+#if USART_BAUD_VALID( 16, 6 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 6 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 6
+#endif
+#if USART_BAUD_VALID( 16, 7 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 16, 7 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 16
+#define USART_BAUD_BEST_S 7
+#endif
+#if USART_BAUD_VALID( 8, 0 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 0 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 0
+#endif
+#if USART_BAUD_VALID( 8, -1 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -1 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -1
+#endif
+#if USART_BAUD_VALID( 8, -2 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -2 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -2
+#endif
+#if USART_BAUD_VALID( 8, -3 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -3 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -3
+#endif
+#if USART_BAUD_VALID( 8, -4 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -4 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -4
+#endif
+#if USART_BAUD_VALID( 8, -5 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -5 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -5
+#endif
+#if USART_BAUD_VALID( 8, -6 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -6 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -6
+#endif
+#if USART_BAUD_VALID( 8, -7 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, -7 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S -7
+#endif
+#if USART_BAUD_VALID( 8, 1 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 1 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 1
+#endif
+#if USART_BAUD_VALID( 8, 2 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 2 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 2
+#endif
+#if USART_BAUD_VALID( 8, 3 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 3 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 3
+#endif
+#if USART_BAUD_VALID( 8, 4 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 4 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 4
+#endif
+#if USART_BAUD_VALID( 8, 5 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 5 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 5
+#endif
+#if USART_BAUD_VALID( 8, 6 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 6 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 6
+#endif
+#if USART_BAUD_VALID( 8, 7 ) && \
+    ( !USART_BAUD_FOUND || \
+      USART_BAUD_DIFF( 8, 7 ) < USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#undef USART_BAUD_FOUND
+#undef USART_BAUD_BEST_D
+#undef USART_BAUD_BEST_S
+#define USART_BAUD_FOUND  1
+#define USART_BAUD_BEST_D 8
+#define USART_BAUD_BEST_S 7
+#endif
+
+#if !USART_BAUD_FOUND
+#error No USART baud rate setting for USART_BAUD_RATE at USART_BAUD_CLOCK
+#endif
+
+/* Results. */
+#define USART_BSEL_VALUE    ( (uint16_t) USART_BAUD_BSEL( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) )
+#define USART_BSCALE_VALUE  ( USART_BAUD_BEST_S )
+#define USART_CLK2X_VALUE   ( USART_BAUD_BEST_D == 8 )
+#define USART_BAUD_ERROR \
+	( USART_BAUD_DIFF( USART_BAUD_BEST_D, USART_BAUD_BEST_S ) * 10000 / \
+	  ( (USART_BAUD_CLOCK) * 128LL ) )
+
+#if USART_BAUD_ERROR > USART_BAUD_MAX_ERROR
+#error USART baud rate error above USART_BAUD_MAX_ERROR
+#endif
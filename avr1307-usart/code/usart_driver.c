@@ -312,9 +312,125 @@ void USART_NineBits_PutChar(USART_t * usart, uint16_t data)
  */
 uint16_t USART_NineBits_GetChar(USART_t * usart)
 {
-	if(usart->CTRLB & USART_RXB8_bm) {
+	if(usart->STATUS & USART_RXB8_bm) {
 		return(0x0100 | usart->DATA);
 	}else {
 		return(usart->DATA);
 	}
 }
+
+
+/*! \brief Order in which the baud rate scale factors are tried. */
+static const int8_t USART_bscaleOrder[15] = {
+	0, -1, -2, -3, -4, -5, -6, -7, 1, 2, 3, 4, 5, 6, 7
+};
+
+
+/*! \brief Find the baud rate setting with the smallest error.
+ *
+ *  This function tries all combinations of BSCALE (-7 to 7) and CLK2X, the
+ *  same way as usart_baud.h does at compile time, and returns the BSEL,
+ *  BSCALE and CLK2X setting giving the smallest bit time error. Normal
+ *  speed and small scale factors are preferred on equal error. Use it
+ *  when the peripheral clock changes at runtime.
+ *
+ *  With 32-bit arithmetic, the clock is limited to 32 MHz, which is the
+ *  highest peripheral clock.
+ *
+ *  \param clockHz   Peripheral clock frequency in Hz.
+ *  \param baudrate  Baud rate in bit/s.
+ *  \param setting   Pointer to where the setting is stored.
+ *
+ *  \retval true   A setting was found.
+ *  \retval false  The baud rate cannot be generated from the clock.
+ */
+bool USART_Baudrate_Solve(uint32_t clockHz, uint32_t baudrate, USART_Baud_t * setting)
+{
+	uint32_t bestDiff = 0xFFFFFFFF;
+	uint32_t clock128 = clockHz * 128;
+	uint32_t errorDivisor;
+	uint8_t clk2x;
+	uint8_t i;
+	bool found = false;
+
+	for(clk2x = 0; clk2x < 2; clk2x++) {
+		uint32_t divisor = (clk2x ? 8 : 16) * baudrate;
+
+		/* Ideal clock to baud rate ratio with 7 fraction bits. */
+		uint32_t ratio128 = (clock128 + divisor / 2) / divisor;
+
+		for(i = 0; i < sizeof(USART_bscaleOrder); i++) {
+			int8_t bscale = USART_bscaleOrder[i];
+			uint32_t bsel;
+			uint32_t actual128;
+			uint32_t diff;
+
+			if(bscale >= 0) {
+				/* f_baud = f / ( d * 2^BSCALE * (BSEL + 1) ). */
+				uint32_t step = 128UL << bscale;
+
+				if(ratio128 + step / 2 < step) {
+					continue;
+				}
+				bsel = (ratio128 + step / 2) / step - 1;
+				actual128 = (bsel + 1) * step;
+			} else {
+				/* f_baud = f / ( d * ( 2^BSCALE * BSEL + 1 ) ), with the
+				 * integer part of the ratio at least two. */
+				uint8_t shift = -bscale;
+
+				if((ratio128 < 128) ||
+				   (ratio128 - 128 > (4096UL * 128) >> shift)) {
+					continue;
+				}
+				bsel = (((ratio128 - 128) << shift) + 64) / 128;
+				if(bsel < (1UL << shift)) {
+					continue;
+				}
+				actual128 = 128 + (bsel << (7 - shift));
+			}
+
+			if((bsel > 4095) || (actual128 > 0xFFFFFFFF / divisor)) {
+				continue;
+			}
+
+			actual128 *= divisor;
+			diff = (actual128 > clock128) ? actual128 - clock128 : clock128 - actual128;
+
+			if(diff < bestDiff) {
+				bestDiff = diff;
+				setting->bsel = (uint16_t) bsel;
+				setting->bscale = bscale;
+				setting->clk2x = clk2x;
+				found = true;
+			}
+		}
+	}
+
+	/* Error in units of 0.01 %: bestDiff * 10000 / clock128. */
+	errorDivisor = (clockHz * 8) / 625;
+	if(found && (errorDivisor != 0) && (bestDiff / errorDivisor < 0xFFFF)) {
+		setting->error = (uint16_t) (bestDiff / errorDivisor);
+	} else {
+		setting->error = 0xFFFF;
+	}
+
+	return found;
+}
+
+
+/*! \brief Write a baud rate setting to the USART.
+ *
+ *  \param usart    The USART module.
+ *  \param setting  Setting found by USART_Baudrate_Solve().
+ */
+void USART_Baudrate_Apply(USART_t * usart, const USART_Baud_t * setting)
+{
+	USART_Baudrate_Set(usart, setting->bsel, setting->bscale);
+
+	if(setting->clk2x) {
+		usart->CTRLB |= USART_CLK2X_bm;
+	}else {
+		usart->CTRLB &= ~USART_CLK2X_bm;
+	}
+}
@@ -115,6 +115,20 @@ typedef struct Usart_and_buffer
 } USART_data_t;
 
 
+/*! \brief Baud rate setting found by USART_Baudrate_Solve(). */
+typedef struct USART_Baud
+{
+	/* \brief Baud rate select value. */
+	uint16_t bsel;
+	/* \brief Baud rate scale factor, -7 to 7. */
+	int8_t bscale;
+	/* \brief True if double speed mode (CLK2X) is used. */
+	bool clk2x;
+	/* \brief Bit time error, in units of 0.01 %. */
+	uint16_t error;
+} USART_Baud_t;
+
+
 /* Macros. */
 
 /*! \brief Macro that sets the USART frame format.
@@ -150,12 +164,15 @@ typedef struct Usart_and_buffer
  *  \param _usart          Pointer to the USART module.
  *  \param _bselValue      Value to write to BSEL part of Baud control register.
  *                         Use uint16_t type.
- *  \param _bScaleFactor   USART baud rate scale factor.
- *                         Use uint8_t type
+ *  \param _bScaleFactor   USART baud rate scale factor, -7 to 7.
+ *                         Use int8_t type
+ *
+ *  \note For a compile-time choice of the settings, see usart_baud.h. For
+ *        a choice at runtime, see USART_Baudrate_Solve().
  */
 #define USART_Baudrate_Set(_usart, _bselValue, _bScaleFactor)                  \
 	(_usart)->BAUDCTRLA =(uint8_t)_bselValue;                                           \
-	(_usart)->BAUDCTRLB =(_bScaleFactor << USART_BSCALE0_bp)|(_bselValue >> 8)
+	(_usart)->BAUDCTRLB =(uint8_t)((uint8_t)(_bScaleFactor) << USART_BSCALE0_bp)|(_bselValue >> 8)
 
 
 /*! \brief Enable USART receiver.
@@ -303,4 +320,8 @@ void USART_DataRegEmpty(USART_data_t * usart_data);
 void USART_NineBits_PutChar(USART_t * usart, uint16_t data);
 uint16_t USART_NineBits_GetChar(USART_t * usart);
 
+/* Functions for baud rate calculation. */
+bool USART_Baudrate_Solve(uint32_t clockHz, uint32_t baudrate, USART_Baud_t * setting);
+void USART_Baudrate_Apply(USART_t * usart, const USART_Baud_t * setting);
+
 #endif
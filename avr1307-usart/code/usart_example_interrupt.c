@@ -50,11 +50,18 @@
  *****************************************************************************/
 #include "usart_driver.h"
 #include "avr_compiler.h"
+#include "trace_driver.h"
+
+/*! Baud rate used in the example. The settings are found by usart_baud.h. */
+#define USART_BAUD_RATE 9600
+#include "usart_baud.h"
 
 /*! Number of bytes to send in test example. */
 #define NUM_BYTES  3
 /*! Define that selects the Usart used in example. */
 #define USART USARTC0
+/*! USART the interrupt trace is exported on when TRACE_ENABLED is defined. */
+#define TRACE_USART USARTD0
 
 /*! USART data struct used in example. */
 USART_data_t USART_data;
@@ -102,18 +109,25 @@ int main(void)
 	USART_RxdInterruptLevel_Set(USART_data.usart, USART_RXCINTLVL_LO_gc);
 
 	/* Set Baudrate to 9600 bps:
-	 * Use the default I/O clock frequency that is 2 MHz.
-	 * Do not use the baudrate scale factor
-	 *
-	 * Baudrate select = (1/(16*(((I/O clock frequency)/Baudrate)-1)
-	 *                 = 12
+	 * Use the default I/O clock frequency that is 2 MHz. usart_baud.h
+	 * selects the setting with the smallest error, BSCALE = -7 and
+	 * BSEL = 3205 in double speed mode, giving 0.01 % error instead of
+	 * the 0.16 % of BSEL = 12 without scale factor.
 	 */
-	USART_Baudrate_Set(&USART, 12 , 0);
+	USART_Baudrate_Set(&USART, USART_BSEL_VALUE, USART_BSCALE_VALUE);
+#if USART_CLK2X_VALUE
+	USART.CTRLB |= USART_CLK2X_bm;
+#endif
 
 	/* Enable both RX and TX. */
 	USART_Rx_Enable(USART_data.usart);
 	USART_Tx_Enable(USART_data.usart);
 
+#ifdef TRACE_ENABLED
+	/* Timestamp the ISRs with 4 us resolution. */
+	TRACE_Init(TC_CLKSEL_DIV8_gc);
+#endif
+
 	/* Enable PMIC interrupt level low. */
 	PMIC.CTRL |= PMIC_LOLVLEX_bm;
 
@@ -149,6 +163,23 @@ int main(void)
 		}
 	}
 
+#ifdef TRACE_ENABLED
+	/* Send the ISR trace on PD3 (TXD0 of USARTD0), with the same frame
+	 * format and baud rate as the example. Decode it with
+	 * tools/trace_decode.c.
+	 */
+	PORTD.DIRSET = PIN3_bm;
+	USART_Format_Set(&TRACE_USART, USART_CHSIZE_8BIT_gc,
+                     USART_PMODE_DISABLED_gc, false);
+	USART_Baudrate_Set(&TRACE_USART, USART_BSEL_VALUE, USART_BSCALE_VALUE);
+#if USART_CLK2X_VALUE
+	TRACE_USART.CTRLB |= USART_CLK2X_bm;
+#endif
+	USART_Tx_Enable(&TRACE_USART);
+	TRACE_Export(&TRACE_USART, &DMA.CH0, DMA_CH_TRIGSRC_USARTD0_DRE_gc);
+	while (!TRACE_IsExportDone(&DMA.CH0));
+#endif
+
 	/* If success the program ends up inside the if statement.*/
 	if(success){
 		while(true);
@@ -166,7 +197,9 @@ int main(void)
  */
 ISR(USARTC0_RXC_vect)
 {
+	TRACE_ISR_ENTER(USARTC0_RXC_vect_num);
 	USART_RXComplete(&USART_data);
+	TRACE_ISR_EXIT(USARTC0_RXC_vect_num);
 }
 
 
@@ -178,5 +211,7 @@ ISR(USARTC0_RXC_vect)
  */
 ISR(USARTC0_DRE_vect)
 {
+	TRACE_ISR_ENTER(USARTC0_DRE_vect_num);
 	USART_DataRegEmpty(&USART_data);
+	TRACE_ISR_EXIT(USARTC0_DRE_vect_num);
 }
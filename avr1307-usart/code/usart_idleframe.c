@@ -0,0 +1,281 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART idle line framing driver source file.
+ *
+ *      This file contains the function implementations of the idle line framing
+ *      driver. See usart_idleframe.h for how the modules work together.
+ *
+ *      IDLEFRAME_Timeout() must run, and restart the DMA channel, before the
+ *      first character of the next frame is complete. While the line stays
+ *      idle, the timer keeps counting and wraps, so the compare match repeats
+ *      once per timer period; the repeated call finds no characters and returns
+ *      at once. With the prescaler chosen by IDLEFRAME_Init() this is at most
+ *      once per 128 idle times.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "usart_idleframe.h"
+
+/*! Timer/Counter clock prescaler of each TC_CLKSEL_DIVn_gc setting. */
+static const uint16_t IDLEFRAME_prescaler[] = {0, 1, 2, 4, 8, 64, 256, 1024};
+
+
+
+/*! \brief Start the DMA channel on the active buffer.
+ *
+ *  The channel is reset and set up for one block of IDLEFRAME_MAX_FRAME
+ *  bytes, one byte per RXC trigger, without interrupts.
+ *
+ *  \param rx  The receiver.
+ */
+static void IDLEFRAME_DMA_Start(IDLEFRAME_Receiver_t * rx)
+{
+	volatile DMA_CH_t * channel = rx->dmaChannel;
+	uint32_t srcAddr = (uint32_t) (uintptr_t) &rx->usart->DATA;
+	uint32_t destAddr = (uint32_t) (uintptr_t) rx->buffer[rx->active];
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+	channel->ADDRCTRL = DMA_CH_SRCDIR_FIXED_gc | DMA_CH_DESTDIR_INC_gc;
+	channel->TRIGSRC = rx->rxTrigger;
+	channel->TRFCNT = IDLEFRAME_MAX_FRAME;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Get the number of bits of a character frame of a USART.
+ *
+ *  \param usart  The USART, with the frame format set.
+ *
+ *  \return  Start bit, data bits, parity bit and stop bits.
+ */
+static uint8_t IDLEFRAME_FrameBits(USART_t * usart)
+{
+	uint8_t ctrlc = usart->CTRLC;
+	uint8_t chsize = ctrlc & USART_CHSIZE_gm;
+	uint8_t bits = 1 + ((chsize == USART_CHSIZE_9BIT_gc) ? 9 : chsize + 5);
+
+	bits += (ctrlc & USART_PMODE_gm) ? 1 : 0;
+	bits += (ctrlc & USART_SBMODE_bm) ? 2 : 1;
+	return bits;
+}
+
+
+
+/*! \brief Initialize an idle line frame receiver.
+ *
+ *  The frame format and baud rate of the USART must be set before, and
+ *  the interrupt level enabled in the PMIC. The receiver is enabled, the
+ *  RXD pin set to sense falling edges and routed to the timer through the
+ *  event channel. The timer and the event channel are used by this
+ *  receiver only.
+ *
+ *  The idle time is counted from the last falling edge, so the timeout is
+ *  set to \a idleBits plus one character frame: a frame ends after an
+ *  idle line of \a idleBits to \a idleBits plus the frame bits minus two,
+ *  depending on the last character. The largest prescaler that gives at
+ *  least IDLEFRAME_MIN_TICKS ticks for the timeout is used.
+ *
+ *  \param rx            The receiver struct to initialize.
+ *  \param usart         USART receiving the frames.
+ *  \param dmaChannel    DMA channel, used by this receiver only.
+ *  \param rxTrigger     RXC trigger of the USART, e.g.
+ *                       DMA_CH_TRIGSRC_USARTC0_RXC_gc.
+ *  \param tc            Timer/Counter measuring the idle time.
+ *  \param eventChannel  Event channel, 0 to 7.
+ *  \param rxdPin        Event source of the RXD pin of the USART, e.g.
+ *                       EVSYS_CHMUX_PORTC_PIN2_gc for USARTC0.
+ *  \param baudrate      Baud rate of the USART.
+ *  \param idleBits      Idle time ending a frame, in bit times, see
+ *                       IDLEFRAME_MODBUS_IDLE_BITS().
+ *  \param intLevel      Compare match A interrupt level of the timer.
+ */
+void IDLEFRAME_Init(IDLEFRAME_Receiver_t * rx,
+                    USART_t * usart,
+                    volatile DMA_CH_t * dmaChannel,
+                    DMA_CH_TRIGSRC_t rxTrigger,
+                    TC0_t * tc,
+                    uint8_t eventChannel,
+                    EVSYS_CHMUX_t rxdPin,
+                    uint32_t baudrate,
+                    uint8_t idleBits,
+                    TC_CCAINTLVL_t intLevel)
+{
+	/* PORTA to PORTF follow each other in the I/O memory, like their
+	 * event sources. The ports are 0x20 bytes apart, more than the size
+	 * of PORT_t. */
+	PORT_t * port = (PORT_t *) ((uintptr_t) &PORTA +
+	                            ((rxdPin - EVSYS_CHMUX_PORTA_PIN0_gc) >> 3) * 0x20);
+	volatile uint8_t * pinCtrl = &port->PIN0CTRL + (rxdPin & 0x07);
+	uint16_t bits = idleBits + IDLEFRAME_FrameBits(usart);
+	uint32_t cycles = (uint32_t) ((uint64_t) F_CPU * bits / baudrate);
+	uint8_t clockSelect = TC_CLKSEL_DIV1024_gc;
+
+	rx->usart = usart;
+	rx->tc = tc;
+	rx->dmaChannel = dmaChannel;
+	rx->rxTrigger = rxTrigger;
+	rx->baudrate = baudrate;
+	rx->active = 0;
+	rx->frameReady = false;
+	rx->framesDropped = 0;
+	rx->framesTooLong = 0;
+
+	while ((clockSelect > TC_CLKSEL_DIV1_gc) &&
+	       (cycles / IDLEFRAME_prescaler[clockSelect] < IDLEFRAME_MIN_TICKS)) {
+		clockSelect--;
+	}
+	rx->prescaler = IDLEFRAME_prescaler[clockSelect];
+
+	/* Every falling edge on RXD restarts the timer. */
+	*pinCtrl = (*pinCtrl & ~PORT_ISC_gm) | PORT_ISC_FALLING_gc;
+	EVSYS_SetEventSource(eventChannel, rxdPin);
+
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->CTRLB = TC_WGMODE_NORMAL_gc;
+	tc->CTRLD = TC_EVACT_RESTART_gc | (TC_EVSEL_CH0_gc + eventChannel);
+	tc->PER = 0xFFFF;
+	tc->CCA = IDLEFRAME_BitsToTicks(rx, bits);
+	tc->CNT = 0;
+	tc->INTFLAGS = TC0_CCAIF_bm;
+	tc->INTCTRLB = (tc->INTCTRLB & ~TC0_CCAINTLVL_gm) | intLevel;
+	tc->CTRLA = clockSelect;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+	IDLEFRAME_DMA_Start(rx);
+	USART_Rx_Enable(usart);
+}
+
+
+
+/*! \brief Convert a time in bit times to ticks of the receiver's timer.
+ *
+ *  The timer counts from the last falling edge on RXD, so the result can
+ *  also be used for the other compare channels, to get a flag a given time
+ *  after the last character started.
+ *
+ *  \param rx    The receiver, initialized.
+ *  \param bits  Time in bit times.
+ *
+ *  \return  Timer ticks, limited to 0xFFFF.
+ */
+uint16_t IDLEFRAME_BitsToTicks(const IDLEFRAME_Receiver_t * rx, uint16_t bits)
+{
+	uint32_t ticks = (uint32_t) ((uint64_t) F_CPU * bits / rx->baudrate) / rx->prescaler;
+
+	return (ticks > 0xFFFF) ? 0xFFFF : (uint16_t) ticks;
+}
+
+
+
+/*! \brief Timer compare match A Interrupt Service Routine.
+ *
+ *  To be called from the CCA interrupt of the receiver's timer. The line
+ *  has been idle for the set time: the characters stored by the DMA
+ *  channel are a frame. The frame is handed to the application, and the
+ *  channel restarted on the other buffer.
+ *
+ *  A frame that fills the buffer with characters left in the USART is too
+ *  long; it is dropped with the rest of it. A frame is also dropped if the
+ *  application has not released the previous one yet; the channel then
+ *  starts again on the same buffer.
+ *
+ *  \param rx  The receiver.
+ */
+void IDLEFRAME_Timeout(IDLEFRAME_Receiver_t * rx)
+{
+	volatile DMA_CH_t * channel = rx->dmaChannel;
+	USART_t * usart = rx->usart;
+	bool full = (channel->CTRLB & DMA_CH_TRNIF_bm) != 0;
+	uint16_t length;
+
+	/* TRFCNT is reloaded when the block is complete. */
+	length = full ? IDLEFRAME_MAX_FRAME : IDLEFRAME_MAX_FRAME - channel->TRFCNT;
+	if (length == 0) {
+		/* The timer wrapped on an idle line. */
+		return;
+	}
+
+	if (full && USART_IsRXComplete(usart)) {
+		while (USART_IsRXComplete(usart)) {
+			(void) usart->DATA;
+		}
+		rx->framesTooLong++;
+	} else if (rx->frameReady) {
+		rx->framesDropped++;
+	} else {
+		rx->frame = rx->buffer[rx->active];
+		rx->frameLength = length;
+		rx->frameReady = true;
+		rx->active ^= 1;
+	}
+
+	IDLEFRAME_DMA_Start(rx);
+}
+
+
+
+/*! \brief Release the received frame.
+ *
+ *  To be called when the application is done with the frame. Until then,
+ *  new frames are dropped.
+ *
+ *  \param rx  The receiver.
+ */
+void IDLEFRAME_ReleaseFrame(IDLEFRAME_Receiver_t * rx)
+{
+	rx->frameReady = false;
+}
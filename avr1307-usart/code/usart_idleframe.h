@@ -0,0 +1,169 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART idle line framing driver header file.
+ *
+ *      This file contains the type definitions, macros and function prototypes
+ *      of the idle line framing driver. The driver receives frames whose only
+ *      delimiter is a pause on the line, like Modbus RTU frames, with one
+ *      interrupt per frame instead of one per character.
+ *
+ *      The characters are stored by a DMA channel triggered by RXC. A 16-bit
+ *      Timer/Counter measures the idle time: the RXD pin is set to sense falling
+ *      edges, and an event channel routes them to the timer, whose restart event
+ *      action clears the count on every start bit and on every falling edge
+ *      within a character. The compare match A interrupt therefore only fires
+ *      when the line has been idle for the set time, and hands the frame to the
+ *      application. The USART cannot generate events itself, so the pin is
+ *      used as the event source.
+ *
+ *      The receiver has two buffers: the frame stays in one until the
+ *      application releases it, while the DMA channel fills the other.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef USART_IDLEFRAME_H
+#define USART_IDLEFRAME_H
+
+#include "avr_compiler.h"
+#include "usart_driver.h"
+#include "event_system_driver.h"
+
+/* Definition of macros. */
+
+#ifndef IDLEFRAME_MAX_FRAME
+/*! Largest frame, in bytes. Longer frames are dropped. */
+#define IDLEFRAME_MAX_FRAME  256
+#endif
+
+/*! Smallest number of timer ticks for the idle time; sets the resolution. */
+#define IDLEFRAME_MIN_TICKS  64
+
+
+/*! \brief Idle time for Modbus RTU framing, in bit times.
+ *
+ *  The timer is restarted by the last falling edge on the line, which is
+ *  the start bit or a later edge within the last character, so a gap of
+ *  between idleBits and idleBits + frame bits - 2 ends a frame. With 2.5
+ *  characters, a gap of 3.5 characters always ends a frame, and a gap of
+ *  1.5 characters within a frame never does.
+ *
+ *  \param _frameBits  Bits of a character frame, start and stop bits
+ *                     included; 11 for Modbus RTU.
+ */
+#define IDLEFRAME_MODBUS_IDLE_BITS(_frameBits)  (((_frameBits) * 5) / 2)
+
+
+/*! \brief Test if a receiver has a frame for the application.
+ *
+ *  \param _rx  Pointer to the receiver.
+ */
+#define IDLEFRAME_FrameAvailable(_rx)  ((_rx)->frameReady)
+
+
+/*! \brief Get the length of the received frame.
+ *
+ *  \param _rx  Pointer to the receiver.
+ */
+#define IDLEFRAME_FrameLength(_rx)     ((_rx)->frameLength)
+
+
+/*! \brief Get a pointer to the received frame.
+ *
+ *  \param _rx  Pointer to the receiver.
+ */
+#define IDLEFRAME_Frame(_rx)           ((_rx)->frame)
+
+
+/*! \brief Idle line frame receiver.
+ *
+ *  The struct holds the modules used by the receiver and its two frame
+ *  buffers. The buffers are written by the DMA channel, so the struct
+ *  must be in internal SRAM.
+ */
+typedef struct IDLEFRAME_Receiver_struct {
+	/*! USART receiving the frames. */
+	USART_t * usart;
+	/*! Timer/Counter measuring the idle time. */
+	TC0_t * tc;
+	/*! DMA channel storing the characters. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! RXC trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_RXC_gc. */
+	DMA_CH_TRIGSRC_t rxTrigger;
+	/*! Baud rate of the USART. */
+	uint32_t baudrate;
+	/*! Clock prescaler of the timer. */
+	uint16_t prescaler;
+	/*! Buffer the DMA channel writes to, 0 or 1. */
+	uint8_t active;
+	/*! The received frame, in one of the buffers. */
+	volatile uint8_t * frame;
+	/*! Length of the received frame. */
+	volatile uint16_t frameLength;
+	/*! A frame is available, until IDLEFRAME_ReleaseFrame(). */
+	volatile bool frameReady;
+	/*! Frames dropped because the previous frame was not released. */
+	volatile uint16_t framesDropped;
+	/*! Frames dropped because they were longer than IDLEFRAME_MAX_FRAME. */
+	volatile uint16_t framesTooLong;
+	/*! Frame buffers. */
+	volatile uint8_t buffer[2][IDLEFRAME_MAX_FRAME];
+} IDLEFRAME_Receiver_t;
+
+
+/* Prototyping of functions. */
+
+void IDLEFRAME_Init(IDLEFRAME_Receiver_t * rx,
+                    USART_t * usart,
+                    volatile DMA_CH_t * dmaChannel,
+                    DMA_CH_TRIGSRC_t rxTrigger,
+                    TC0_t * tc,
+                    uint8_t eventChannel,
+                    EVSYS_CHMUX_t rxdPin,
+                    uint32_t baudrate,
+                    uint8_t idleBits,
+                    TC_CCAINTLVL_t intLevel);
+uint16_t IDLEFRAME_BitsToTicks(const IDLEFRAME_Receiver_t * rx, uint16_t bits);
+void IDLEFRAME_Timeout(IDLEFRAME_Receiver_t * rx);
+void IDLEFRAME_ReleaseFrame(IDLEFRAME_Receiver_t * rx);
+
+#endif
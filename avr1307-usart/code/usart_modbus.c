@@ -0,0 +1,573 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART Modbus RTU slave source file.
+ *
+ *      This file contains the function implementations of the Modbus RTU slave.
+ *      See usart_modbus.h for how the slave works.
+ *
+ *      MODBUS_Slave_Poll() works on the frame in the receiver buffer, and only
+ *      then releases it, so a request that arrives while the previous one is
+ *      executed is dropped by the receiver. The Modbus master waits for the
+ *      response before the next request, so this only happens when the
+ *      application calls MODBUS_Slave_Poll() too rarely.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "usart_modbus.h"
+
+/*! Frame bits of Modbus RTU: start, 8 data bits, parity or a second stop
+ *  bit, stop. */
+#define MODBUS_FRAME_BITS  11
+
+
+/*! \brief CRC-16 table of the Modbus polynomial 0xA001 (reflected 0x8005).
+ *
+ *  Entry n is the CRC register change for a low byte of n, so the CRC is
+ *  updated with one table lookup per byte.
+ */
+FLASH_DECLARE(static const uint16_t MODBUS_crcTable[256]) = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+
+
+/*! \brief Calculate the Modbus CRC-16 of a block.
+ *
+ *  The CRC is sent low byte first after the frame. The CRC of a frame
+ *  including its CRC is zero.
+ *
+ *  \param data    Data.
+ *  \param length  Number of bytes.
+ *
+ *  \return  CRC-16.
+ */
+uint16_t MODBUS_CRC16(const uint8_t * data, uint16_t length)
+{
+	uint16_t crc = 0xFFFF;
+
+	while (length-- != 0) {
+		crc = (crc >> 8) ^ PGM_READ_WORD(&MODBUS_crcTable[(uint8_t) (crc ^ *data++)]);
+	}
+	return crc;
+}
+
+
+
+/*! \brief Copy a run of bits.
+ *
+ *  \param dest     Destination bit table.
+ *  \param destBit  First destination bit.
+ *  \param src      Source bit table.
+ *  \param srcBit   First source bit.
+ *  \param count    Number of bits.
+ */
+static void MODBUS_CopyBits(uint8_t * dest,
+                            uint16_t destBit,
+                            const uint8_t * src,
+                            uint16_t srcBit,
+                            uint16_t count)
+{
+	while (count-- != 0) {
+		uint8_t mask = 1 << (destBit & 0x07);
+
+		if (src[srcBit >> 3] & (1 << (srcBit & 0x07))) {
+			dest[destBit >> 3] |= mask;
+		} else {
+			dest[destBit >> 3] &= ~mask;
+		}
+		srcBit++;
+		destBit++;
+	}
+}
+
+
+
+/*! \brief Get a 16-bit big endian value from a frame. */
+static uint16_t MODBUS_GetWord(const uint8_t * data)
+{
+	return ((uint16_t) data[0] << 8) | data[1];
+}
+
+
+
+/*! \brief Put a 16-bit big endian value into a frame. */
+static void MODBUS_PutWord(uint8_t * data, uint16_t value)
+{
+	data[0] = value >> 8;
+	data[1] = value & 0xFF;
+}
+
+
+
+/*! \brief Look up an address range in a table.
+ *
+ *  \param slave     The slave.
+ *  \param table     Table to look in.
+ *  \param address   Modbus address of the first entry.
+ *  \param quantity  Number of entries, at least one.
+ *
+ *  \return  Index of the first entry in the table data, or -1 if the
+ *           range is not completely in the table.
+ */
+static int32_t MODBUS_Lookup(const MODBUS_Slave_t * slave,
+                             MODBUS_Table_t table,
+                             uint16_t address,
+                             uint16_t quantity)
+{
+	const MODBUS_TableMap_t * map = &slave->tables[table];
+
+	if ((map->data == NULL) || (address < map->start) ||
+	    (quantity > map->count) || (address - map->start > map->count - quantity)) {
+		return -1;
+	}
+	return address - map->start;
+}
+
+
+
+/*! \brief Execute a request.
+ *
+ *  \param slave     The slave.
+ *  \param request   Request frame, CRC checked.
+ *  \param length    Length of the request, CRC included.
+ *  \param response  Buffer for the response. The address is already set.
+ *
+ *  \return  Response length without the CRC, or 0 for an exception, whose
+ *           code is then in response[2].
+ */
+static uint16_t MODBUS_Execute(MODBUS_Slave_t * slave,
+                               const uint8_t * request,
+                               uint16_t length,
+                               uint8_t * response)
+{
+	uint8_t function = request[1];
+	uint16_t address = MODBUS_GetWord(&request[2]);
+	uint16_t quantity = MODBUS_GetWord(&request[4]);
+	uint8_t exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+	uint16_t * registers;
+	int32_t index;
+	uint16_t i;
+
+	response[1] = function;
+
+	switch (function) {
+	case 1:
+	case 2:
+		/* Read coils or discrete inputs: the table is function - 1. */
+		if ((length != 8) || (quantity == 0) || (quantity > 2000)) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, (MODBUS_Table_t) (function - 1), address, quantity);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		response[2] = (quantity + 7) / 8;
+		response[2 + response[2]] = 0;
+		MODBUS_CopyBits(&response[3], 0,
+		                slave->tables[function - 1].data, index, quantity);
+		return 3 + response[2];
+
+	case 3:
+	case 4:
+		/* Read holding or input registers. */
+		if ((length != 8) || (quantity == 0) || (quantity > 125)) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, (MODBUS_Table_t) (function - 1), address, quantity);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		registers = (uint16_t *) slave->tables[function - 1].data + index;
+		response[2] = quantity * 2;
+		for (i = 0; i < quantity; i++) {
+			MODBUS_PutWord(&response[3 + 2 * i], registers[i]);
+		}
+		return 3 + response[2];
+
+	case 5:
+		/* Write single coil: the value is 0xFF00 or 0x0000. */
+		if ((length != 8) || ((quantity != 0xFF00) && (quantity != 0x0000))) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, MODBUS_TABLE_COILS, address, 1);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		MODBUS_CopyBits(slave->tables[MODBUS_TABLE_COILS].data, index,
+		                &request[4], 0, 1);
+		for (i = 2; i < 6; i++) {
+			response[i] = request[i];
+		}
+		return 6;
+
+	case 6:
+		/* Write single register. */
+		if (length != 8) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, MODBUS_TABLE_HOLDING_REGISTERS, address, 1);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		registers = slave->tables[MODBUS_TABLE_HOLDING_REGISTERS].data;
+		registers[index] = quantity;
+		for (i = 2; i < 6; i++) {
+			response[i] = request[i];
+		}
+		return 6;
+
+	case 15:
+		/* Write multiple coils. */
+		if ((length < 10) || (length != 9 + request[6]) ||
+		    (quantity == 0) || (quantity > 1968) ||
+		    (request[6] != (quantity + 7) / 8)) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, MODBUS_TABLE_COILS, address, quantity);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		MODBUS_CopyBits(slave->tables[MODBUS_TABLE_COILS].data, index,
+		                &request[7], 0, quantity);
+		for (i = 2; i < 6; i++) {
+			response[i] = request[i];
+		}
+		return 6;
+
+	case 16:
+		/* Write multiple registers. */
+		if ((length < 11) || (length != 9 + request[6]) ||
+		    (quantity == 0) || (quantity > 123) || (request[6] != quantity * 2)) {
+			break;
+		}
+		index = MODBUS_Lookup(slave, MODBUS_TABLE_HOLDING_REGISTERS, address, quantity);
+		if (index < 0) {
+			exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			break;
+		}
+		registers = (uint16_t *) slave->tables[MODBUS_TABLE_HOLDING_REGISTERS].data + index;
+		for (i = 0; i < quantity; i++) {
+			registers[i] = MODBUS_GetWord(&request[7 + 2 * i]);
+		}
+		for (i = 2; i < 6; i++) {
+			response[i] = request[i];
+		}
+		return 6;
+
+	default:
+		exception = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+		break;
+	}
+
+	response[2] = exception;
+	return 0;
+}
+
+
+
+/*! \brief Start sending the response in the transmit buffer.
+ *
+ *  DE is set, and the DMA channel is set up to write one byte to DATA per
+ *  DRE trigger. The TXC interrupt ends the response.
+ *
+ *  \param slave   The slave.
+ *  \param length  Response length, CRC included.
+ */
+static void MODBUS_Transmit(MODBUS_Slave_t * slave, uint16_t length)
+{
+	volatile DMA_CH_t * channel = slave->txChannel;
+	USART_t * usart = slave->rx->usart;
+	uint32_t srcAddr = (uint32_t) (uintptr_t) slave->txBuffer;
+	uint32_t destAddr = (uint32_t) (uintptr_t) &usart->DATA;
+
+	slave->txBusy = true;
+	slave->dePort->OUTSET = slave->deMask;
+
+	/* Clear TXC from an earlier response by writing one. */
+	usart->STATUS = USART_TXCIF_bm;
+	USART_TxdInterruptLevel_Set(usart, slave->txcIntLevel);
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+	channel->ADDRCTRL = DMA_CH_SRCDIR_INC_gc | DMA_CH_DESTDIR_FIXED_gc;
+	channel->TRIGSRC = slave->dreTrigger;
+	channel->TRFCNT = length;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Initialize a Modbus RTU slave.
+ *
+ *  The receiver must be initialized before with IDLEFRAME_Init(), using
+ *  MODBUS_IDLE_BITS() for the idle time, and the USART set to 8 data bits
+ *  with even parity, or with no parity and two stop bits. The DE pin is
+ *  made an output and cleared, and the transmitter enabled. Compare
+ *  match B of the framing timer is set to the end of the silent interval
+ *  after a request. The tables are empty until MODBUS_Slave_SetTable().
+ *
+ *  The TXC and the framing timer's compare match A interrupt levels must
+ *  be enabled in the PMIC.
+ *
+ *  \param slave        The slave struct to initialize.
+ *  \param rx           Initialized idle line frame receiver.
+ *  \param address      Own address, 1 to 247.
+ *  \param txChannel    DMA channel sending the response, used by this slave
+ *                      only.
+ *  \param dreTrigger   DRE trigger of the USART, e.g.
+ *                      DMA_CH_TRIGSRC_USARTC0_DRE_gc.
+ *  \param dePort       Port of the transceiver driver enable pin.
+ *  \param deMask       Bit mask of the driver enable pin.
+ *  \param txcIntLevel  TXC interrupt level.
+ */
+void MODBUS_Slave_Init(MODBUS_Slave_t * slave,
+                       IDLEFRAME_Receiver_t * rx,
+                       uint8_t address,
+                       volatile DMA_CH_t * txChannel,
+                       DMA_CH_TRIGSRC_t dreTrigger,
+                       PORT_t * dePort,
+                       uint8_t deMask,
+                       USART_TXCINTLVL_t txcIntLevel)
+{
+	uint8_t i;
+
+	slave->rx = rx;
+	slave->address = address;
+	slave->txChannel = txChannel;
+	slave->dreTrigger = dreTrigger;
+	slave->dePort = dePort;
+	slave->deMask = deMask;
+	slave->txcIntLevel = txcIntLevel;
+	slave->responseLength = 0;
+	slave->txBusy = false;
+	slave->requests = 0;
+	slave->crcErrors = 0;
+	slave->exceptions = 0;
+	for (i = 0; i < 4; i++) {
+		slave->tables[i].data = NULL;
+		slave->tables[i].count = 0;
+	}
+
+	/* The timer counts from the last falling edge, so the silent interval
+	 * ends at most one character frame later than this. */
+	rx->tc->CCB = IDLEFRAME_BitsToTicks(rx,
+		MODBUS_GAP_BITS(rx->baudrate, MODBUS_FRAME_BITS) + MODBUS_FRAME_BITS) + 1;
+
+	dePort->OUTCLR = deMask;
+	dePort->DIRSET = deMask;
+	USART_Tx_Enable(rx->usart);
+}
+
+
+
+/*! \brief Map a data table to application memory.
+ *
+ *  \param slave  The slave.
+ *  \param table  Table to map.
+ *  \param data   Table data: bytes of eight bits for coils and discrete
+ *                inputs, uint16_t for registers.
+ *  \param start  Modbus address of the first entry.
+ *  \param count  Number of entries.
+ */
+void MODBUS_Slave_SetTable(MODBUS_Slave_t * slave,
+                           MODBUS_Table_t table,
+                           void * data,
+                           uint16_t start,
+                           uint16_t count)
+{
+	slave->tables[table].data = data;
+	slave->tables[table].start = start;
+	slave->tables[table].count = count;
+}
+
+
+
+/*! \brief Handle a received request.
+ *
+ *  To be called from the main loop. The request is checked, executed and
+ *  the response built in the transmit buffer. The response is started on
+ *  a later call, once the silent interval after the request has passed.
+ *
+ *  \param slave  The slave.
+ *
+ *  \retval true   A request was handled or a response started.
+ *  \retval false  Nothing to do.
+ */
+bool MODBUS_Slave_Poll(MODBUS_Slave_t * slave)
+{
+	IDLEFRAME_Receiver_t * rx = slave->rx;
+	const uint8_t * request;
+	uint16_t length;
+	uint16_t crc;
+
+	if (slave->txBusy) {
+		return false;
+	}
+
+	if (slave->responseLength != 0) {
+		if (!(rx->tc->INTFLAGS & TC0_CCBIF_bm)) {
+			return false;
+		}
+		MODBUS_Transmit(slave, slave->responseLength);
+		slave->responseLength = 0;
+		return true;
+	}
+
+	if (!IDLEFRAME_FrameAvailable(rx)) {
+		return false;
+	}
+
+	request = (const uint8_t *) IDLEFRAME_Frame(rx);
+	length = IDLEFRAME_FrameLength(rx);
+
+	if ((length < 4) || (MODBUS_CRC16(request, length) != 0)) {
+		slave->crcErrors++;
+	} else if ((request[0] == slave->address) || (request[0] == MODBUS_BROADCAST)) {
+		uint8_t * response = slave->txBuffer;
+		uint16_t responseLength;
+
+		slave->requests++;
+		response[0] = slave->address;
+		responseLength = MODBUS_Execute(slave, request, length, response);
+		if (responseLength == 0) {
+			response[1] |= 0x80;
+			responseLength = 3;
+			slave->exceptions++;
+		}
+		if (request[0] != MODBUS_BROADCAST) {
+			crc = MODBUS_CRC16(response, responseLength);
+			response[responseLength] = crc & 0xFF;
+			response[responseLength + 1] = crc >> 8;
+			slave->responseLength = responseLength + 2;
+		}
+	}
+
+	IDLEFRAME_ReleaseFrame(rx);
+	return true;
+}
+
+
+
+/*! \brief Timer compare match A Interrupt Service Routine.
+ *
+ *  To be called from the CCA interrupt of the framing timer instead of
+ *  IDLEFRAME_Timeout(). The compare match B flag is cleared, so that it
+ *  marks the end of the silent interval after this request.
+ *
+ *  \param slave  The slave.
+ */
+void MODBUS_Slave_FrameTimeout(MODBUS_Slave_t * slave)
+{
+	slave->rx->tc->INTFLAGS = TC0_CCBIF_bm;
+	IDLEFRAME_Timeout(slave->rx);
+}
+
+
+
+/*! \brief Transmit Complete Interrupt Service Routine.
+ *
+ *  To be called from the TXC interrupt of the slave's USART. The last stop
+ *  bit of the response has been sent: DE is released and the TXC interrupt
+ *  disabled. A TXC while the DMA channel still has bytes to send is
+ *  ignored.
+ *
+ *  \param slave  The slave.
+ */
+void MODBUS_Slave_TXComplete(MODBUS_Slave_t * slave)
+{
+	if (slave->txChannel->CTRLA & DMA_CH_ENABLE_bm) {
+		return;
+	}
+	slave->dePort->OUTCLR = slave->deMask;
+	USART_TxdInterruptLevel_Set(slave->rx->usart, USART_TXCINTLVL_OFF_gc);
+	slave->txBusy = false;
+}
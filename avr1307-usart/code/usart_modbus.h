@@ -0,0 +1,215 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART Modbus RTU slave header file.
+ *
+ *      This file contains the type definitions, macros and function prototypes
+ *      of the Modbus RTU slave. The slave receives requests with the idle line
+ *      framing driver, executes them on register and coil tables in application
+ *      memory, and sends the response by DMA on an RS-485 transceiver.
+ *
+ *      Frame handling costs two short interrupts per request: the compare match
+ *      A interrupt of the framing timer ending the request, and the TXC
+ *      interrupt releasing the transceiver driver enable (DE) pin after the last
+ *      stop bit of the response. The request is checked and executed, and the
+ *      response built, by MODBUS_Slave_Poll() in the main loop. The CRC-16 is
+ *      calculated with a 256 entry table in flash.
+ *
+ *      The response is not started before the line has been idle for 3.5
+ *      character times after the request, measured with compare match B of the
+ *      framing timer, so the idle time ending the request can be shorter.
+ *
+ *      Supported function codes: read coils (1), read discrete inputs (2), read
+ *      holding registers (3), read input registers (4), write single coil (5),
+ *      write single register (6), write multiple coils (15) and write multiple
+ *      registers (16). Broadcast requests (address 0) are executed for the write
+ *      functions, without a response.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef USART_MODBUS_H
+#define USART_MODBUS_H
+
+#include "avr_compiler.h"
+#include "usart_driver.h"
+#include "usart_idleframe.h"
+
+/* Definition of macros. */
+
+/*! Largest Modbus RTU frame, address and CRC included. */
+#define MODBUS_MAX_ADU         256
+
+/*! Address of broadcast requests. */
+#define MODBUS_BROADCAST       0
+
+/*! Exception code: function code not supported. */
+#define MODBUS_EXCEPTION_ILLEGAL_FUNCTION      0x01
+
+/*! Exception code: address range outside the table. */
+#define MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS  0x02
+
+/*! Exception code: quantity, byte count or value not allowed. */
+#define MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE    0x03
+
+
+/*! \brief Idle time ending a request, in bit times.
+ *
+ *  Up to 19200 baud, this is IDLEFRAME_MODBUS_IDLE_BITS(). Above, Modbus
+ *  uses fixed times of 750 us for the longest gap within a frame and
+ *  1.75 ms between frames, and 1.25 ms is used. The result must be passed
+ *  to IDLEFRAME_Init() and is at most 255 up to 204000 baud.
+ *
+ *  \param _baudrate   Baud rate.
+ *  \param _frameBits  Bits of a character frame, 11 for Modbus RTU.
+ */
+#define MODBUS_IDLE_BITS(_baudrate, _frameBits)                                \
+	(((_baudrate) > 19200) ? (uint8_t) (((_baudrate) * 5UL) / 4000) :          \
+	                         IDLEFRAME_MODBUS_IDLE_BITS(_frameBits))
+
+
+/*! \brief Silent interval between frames, in bit times.
+ *
+ *  3.5 character times up to 19200 baud, 1.75 ms above.
+ *
+ *  \param _baudrate   Baud rate.
+ *  \param _frameBits  Bits of a character frame, 11 for Modbus RTU.
+ */
+#define MODBUS_GAP_BITS(_baudrate, _frameBits)                                 \
+	(((_baudrate) > 19200) ? (uint16_t) (((_baudrate) * 7UL + 3999) / 4000) :  \
+	                         (uint16_t) (((_frameBits) * 7 + 1) / 2))
+
+
+/*! \brief Test if the slave is sending a response.
+ *
+ *  \param _slave  Pointer to the slave.
+ */
+#define MODBUS_Slave_IsTransmitting(_slave)  ((_slave)->txBusy)
+
+
+/*! \brief Data tables of a slave. */
+typedef enum MODBUS_Table_enum {
+	/*! Coils, read and written as bits. */
+	MODBUS_TABLE_COILS = 0,
+	/*! Discrete inputs, read as bits. */
+	MODBUS_TABLE_DISCRETE_INPUTS = 1,
+	/*! Holding registers, read and written as 16-bit words. */
+	MODBUS_TABLE_HOLDING_REGISTERS = 2,
+	/*! Input registers, read as 16-bit words. */
+	MODBUS_TABLE_INPUT_REGISTERS = 3,
+} MODBUS_Table_t;
+
+
+/*! \brief A data table in application memory.
+ *
+ *  Bit tables hold eight coils or inputs per byte, the lowest address in
+ *  bit 0 of the first byte. Register tables are arrays of uint16_t.
+ */
+typedef struct MODBUS_TableMap_struct {
+	/*! Table data, NULL if the table is not used. */
+	void * data;
+	/*! Modbus address of the first entry. */
+	uint16_t start;
+	/*! Number of coils, inputs or registers. */
+	uint16_t count;
+} MODBUS_TableMap_t;
+
+
+/*! \brief Modbus RTU slave.
+ *
+ *  The struct holds the receiver and transmitter setup, the table maps and
+ *  the response buffer. The buffer is read by the DMA channel, so the
+ *  struct must be in internal SRAM.
+ */
+typedef struct MODBUS_Slave_struct {
+	/*! Idle line frame receiver of the slave's USART. */
+	IDLEFRAME_Receiver_t * rx;
+	/*! Own address, 1 to 247. */
+	uint8_t address;
+	/*! DMA channel sending the response. */
+	volatile DMA_CH_t * txChannel;
+	/*! DRE trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_DRE_gc. */
+	DMA_CH_TRIGSRC_t dreTrigger;
+	/*! Port of the transceiver driver enable pin. */
+	PORT_t * dePort;
+	/*! Bit mask of the driver enable pin. */
+	uint8_t deMask;
+	/*! TXC interrupt level used while sending. */
+	USART_TXCINTLVL_t txcIntLevel;
+	/*! Data tables, indexed by MODBUS_Table_t. */
+	MODBUS_TableMap_t tables[4];
+	/*! Length of the response waiting for the silent interval, or 0. */
+	uint16_t responseLength;
+	/*! A response is being sent; DE is set. */
+	volatile bool txBusy;
+	/*! Requests for this slave or broadcast, with a valid CRC. */
+	uint16_t requests;
+	/*! Frames dropped for a wrong CRC or a length below four bytes. */
+	uint16_t crcErrors;
+	/*! Exception responses sent. */
+	uint16_t exceptions;
+	/*! Response being sent. */
+	uint8_t txBuffer[MODBUS_MAX_ADU];
+} MODBUS_Slave_t;
+
+
+/* Prototyping of functions. */
+
+uint16_t MODBUS_CRC16(const uint8_t * data, uint16_t length);
+
+void MODBUS_Slave_Init(MODBUS_Slave_t * slave,
+                       IDLEFRAME_Receiver_t * rx,
+                       uint8_t address,
+                       volatile DMA_CH_t * txChannel,
+                       DMA_CH_TRIGSRC_t dreTrigger,
+                       PORT_t * dePort,
+                       uint8_t deMask,
+                       USART_TXCINTLVL_t txcIntLevel);
+void MODBUS_Slave_SetTable(MODBUS_Slave_t * slave,
+                           MODBUS_Table_t table,
+                           void * data,
+                           uint16_t start,
+                           uint16_t count);
+bool MODBUS_Slave_Poll(MODBUS_Slave_t * slave);
+void MODBUS_Slave_FrameTimeout(MODBUS_Slave_t * slave);
+void MODBUS_Slave_TXComplete(MODBUS_Slave_t * slave);
+
+#endif
@@ -0,0 +1,329 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART multi-drop bus driver source file.
+ *
+ *      This file contains the function implementations of the multi-drop bus
+ *      driver: the node receive state machine, run from the RXC and DMA
+ *      interrupts, and the master send function. See usart_multidrop.h for the
+ *      frame format.
+ *
+ *      The node relies on the interrupt response: the length character must be
+ *      read and the DMA channel enabled before the receive buffer overflows,
+ *      which leaves about two character times. The payload is safe once the
+ *      DMA channel runs.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "usart_multidrop.h"
+
+
+
+/*! \brief Set up a DMA channel for a transfer between a USART and a buffer.
+ *
+ *  The channel is reset and set up for one block, one byte per trigger.
+ *  The address that is not the USART data register is incremented.
+ *
+ *  \param channel   DMA channel.
+ *  \param trigger   Trigger source.
+ *  \param srcAddr   Source address.
+ *  \param destAddr  Destination address.
+ *  \param srcInc    True to increment the source, false to increment the
+ *                   destination.
+ *  \param count     Number of bytes.
+ *  \param intLevel  Transaction complete interrupt level.
+ */
+static void MULTIDROP_DMA_Start(volatile DMA_CH_t * channel,
+                                DMA_CH_TRIGSRC_t trigger,
+                                uint32_t srcAddr,
+                                uint32_t destAddr,
+                                bool srcInc,
+                                uint8_t count,
+                                DMA_CH_TRNINTLVL_t intLevel)
+{
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm | intLevel;
+	channel->ADDRCTRL = (srcInc ? DMA_CH_SRCDIR_INC_gc : DMA_CH_SRCDIR_FIXED_gc) |
+	                    (srcInc ? DMA_CH_DESTDIR_FIXED_gc : DMA_CH_DESTDIR_INC_gc);
+	channel->TRIGSRC = trigger;
+	channel->TRFCNT = count;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Go back to address filtering.
+ *
+ *  MPCM is set, so data characters are ignored by the receiver, and the
+ *  RXC interrupt is enabled for the next address character.
+ *
+ *  \param node  The node.
+ */
+static void MULTIDROP_WaitForAddress(MULTIDROP_Node_t * node)
+{
+	node->state = MULTIDROP_STATE_ADDRESS;
+	node->usart->CTRLB |= USART_MPCM_bm;
+	USART_RxdInterruptLevel_Set(node->usart, node->rxIntLevel);
+}
+
+
+
+/*! \brief Initialize a multi-drop bus node.
+ *
+ *  The USART is set to 9-bit characters without parity and one stop bit,
+ *  MPCM and the receiver are enabled. The baud rate must be set by the
+ *  application, as must the interrupt levels in the PMIC.
+ *
+ *  \param node         The node struct to initialize.
+ *  \param usart        USART connected to the bus.
+ *  \param dmaChannel   DMA channel for the payload, used by this node only.
+ *  \param rxTrigger    RXC trigger of the USART, e.g.
+ *                      DMA_CH_TRIGSRC_USARTC0_RXC_gc.
+ *  \param address      Own address, 0 to 254.
+ *  \param rxIntLevel   RXC interrupt level.
+ *  \param dmaIntLevel  DMA transaction complete interrupt level.
+ */
+void MULTIDROP_Node_Init(MULTIDROP_Node_t * node,
+                         USART_t * usart,
+                         volatile DMA_CH_t * dmaChannel,
+                         DMA_CH_TRIGSRC_t rxTrigger,
+                         uint8_t address,
+                         USART_RXCINTLVL_t rxIntLevel,
+                         DMA_CH_TRNINTLVL_t dmaIntLevel)
+{
+	node->usart = usart;
+	node->dmaChannel = dmaChannel;
+	node->rxTrigger = rxTrigger;
+	node->address = address;
+	node->rxIntLevel = rxIntLevel;
+	node->dmaIntLevel = dmaIntLevel;
+	node->frameReady = false;
+	node->framesDropped = 0;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	USART_Format_Set(usart, USART_CHSIZE_9BIT_gc, USART_PMODE_DISABLED_gc, false);
+	MULTIDROP_WaitForAddress(node);
+	USART_Rx_Enable(usart);
+}
+
+
+
+/*! \brief RX Complete Interrupt Service Routine.
+ *
+ *  To be called from the RXC interrupt of the node's USART. With MPCM set,
+ *  only address characters get here; an address that is not for this node
+ *  costs this one call. For an own or broadcast address, MPCM is cleared to
+ *  receive the length. The length starts the DMA channel for the payload,
+ *  and the RXC interrupt is disabled until the channel is done.
+ *
+ *  A frame is dropped if it is too long, or if the application has not
+ *  released the previous frame yet.
+ *
+ *  \param node  The node.
+ */
+void MULTIDROP_RXComplete(MULTIDROP_Node_t * node)
+{
+	USART_t * usart = node->usart;
+	bool isAddress = (usart->STATUS & USART_RXB8_bm) != 0;
+	uint8_t data = usart->DATA;
+
+	if (isAddress) {
+		if ((data != node->address) && (data != MULTIDROP_BROADCAST)) {
+			MULTIDROP_WaitForAddress(node);
+		} else if (node->frameReady) {
+			node->framesDropped++;
+			MULTIDROP_WaitForAddress(node);
+		} else {
+			node->frameAddress = data;
+			node->state = MULTIDROP_STATE_LENGTH;
+			usart->CTRLB &= ~USART_MPCM_bm;
+		}
+	} else if (node->state == MULTIDROP_STATE_LENGTH) {
+		if (data > MULTIDROP_MAX_PAYLOAD) {
+			node->framesDropped++;
+			MULTIDROP_WaitForAddress(node);
+		} else if (data == 0) {
+			node->frameLength = 0;
+			node->frameReady = true;
+			MULTIDROP_WaitForAddress(node);
+		} else {
+			node->frameLength = data;
+			node->state = MULTIDROP_STATE_PAYLOAD;
+			USART_RxdInterruptLevel_Set(usart, USART_RXCINTLVL_OFF_gc);
+			MULTIDROP_DMA_Start(node->dmaChannel, node->rxTrigger,
+			                    (uint32_t) (uintptr_t) &usart->DATA,
+			                    (uint32_t) (uintptr_t) node->buffer,
+			                    false, data, node->dmaIntLevel);
+		}
+	}
+
+	/* Data characters in the address state are the tail of a frame for
+	 * another node, received before MPCM was set again; they are ignored.
+	 */
+}
+
+
+
+/*! \brief DMA transaction complete Interrupt Service Routine.
+ *
+ *  To be called from the interrupt of the node's DMA channel. The payload
+ *  has been received: the frame is handed to the application, and the node
+ *  goes back to address filtering.
+ *
+ *  \param node  The node.
+ */
+void MULTIDROP_DMAComplete(MULTIDROP_Node_t * node)
+{
+	volatile DMA_CH_t * channel = node->dmaChannel;
+
+	if (channel->CTRLB & DMA_CH_ERRIF_bm) {
+		node->framesDropped++;
+	} else {
+		node->frameReady = true;
+	}
+
+	/* Clear the flags by writing one. */
+	channel->CTRLB |= DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+	MULTIDROP_WaitForAddress(node);
+}
+
+
+
+/*! \brief Release the received frame.
+ *
+ *  To be called when the application is done with the buffer. Until then,
+ *  frames for this node are dropped.
+ *
+ *  \param node  The node.
+ */
+void MULTIDROP_ReleaseFrame(MULTIDROP_Node_t * node)
+{
+	node->frameReady = false;
+}
+
+
+
+/*! \brief Initialize a multi-drop bus master.
+ *
+ *  The USART is set to 9-bit characters without parity and one stop bit,
+ *  and the transmitter is enabled. The baud rate must be set by the
+ *  application.
+ *
+ *  \param master      The master struct to initialize.
+ *  \param usart       USART connected to the bus.
+ *  \param dmaChannel  DMA channel for length and payload.
+ *  \param dreTrigger  DRE trigger of the USART, e.g.
+ *                     DMA_CH_TRIGSRC_USARTC0_DRE_gc.
+ */
+void MULTIDROP_Master_Init(MULTIDROP_Master_t * master,
+                           USART_t * usart,
+                           volatile DMA_CH_t * dmaChannel,
+                           DMA_CH_TRIGSRC_t dreTrigger)
+{
+	master->usart = usart;
+	master->dmaChannel = dmaChannel;
+	master->dreTrigger = dreTrigger;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	USART_Format_Set(usart, USART_CHSIZE_9BIT_gc, USART_PMODE_DISABLED_gc, false);
+	USART_Tx_Enable(usart);
+}
+
+
+
+/*! \brief Send a frame.
+ *
+ *  The address is written with TXB8 set. The length and the payload are
+ *  copied to the master buffer and sent by the DMA channel, so the caller
+ *  can reuse \a data at once and the CPU is free while the frame is sent.
+ *
+ *  \param master   The master.
+ *  \param address  Address of the node, or MULTIDROP_BROADCAST.
+ *  \param data     Payload.
+ *  \param length   Payload length, at most MULTIDROP_MAX_PAYLOAD.
+ *
+ *  \retval true   The frame is being sent.
+ *  \retval false  The previous frame is still being sent, or the payload is
+ *                 too long. Nothing was sent.
+ */
+bool MULTIDROP_Master_Send(MULTIDROP_Master_t * master,
+                           uint8_t address,
+                           const uint8_t * data,
+                           uint8_t length)
+{
+	USART_t * usart = master->usart;
+	uint8_t i;
+
+	if ((length > MULTIDROP_MAX_PAYLOAD) || MULTIDROP_Master_IsBusy(master) ||
+	    !USART_IsTXDataRegisterEmpty(usart)) {
+		return false;
+	}
+
+	master->buffer[0] = length;
+	for (i = 0; i < length; i++) {
+		master->buffer[i + 1] = data[i];
+	}
+
+	/* TXB8 must be written before DATA. */
+	USART_NineBits_PutChar(usart, 0x0100 | address);
+	usart->CTRLB &= ~USART_TXB8_bm;
+
+	MULTIDROP_DMA_Start(master->dmaChannel, master->dreTrigger,
+	                    (uint32_t) (uintptr_t) master->buffer,
+	                    (uint32_t) (uintptr_t) &usart->DATA,
+	                    true, length + 1, DMA_CH_TRNINTLVL_OFF_gc);
+	return true;
+}
@@ -0,0 +1,196 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART multi-drop bus driver header file.
+ *
+ *      This file contains the type definitions, macros and function prototypes
+ *      of the multi-drop bus driver. The driver uses the 9-bit character size
+ *      and the multi-processor communication mode (MPCM) of the USART, so that
+ *      a node is only interrupted by the frames sent to it.
+ *
+ *      A frame on the bus is an address character with the ninth bit set,
+ *      followed by a length character and the payload, all with the ninth bit
+ *      cleared:
+ *
+ *        [address, bit 8 = 1] [length] [payload 0] ... [payload length-1]
+ *
+ *      A node waits with MPCM set, so the receiver ignores every character with
+ *      the ninth bit cleared, and takes one RXC interrupt per address character
+ *      on the bus. If the address is its own or MULTIDROP_BROADCAST, MPCM is
+ *      cleared and the next RXC interrupt reads the length. The payload is then
+ *      received by a DMA channel triggered by RXC, with the RXC interrupt
+ *      disabled, and the transaction complete interrupt of the channel hands the
+ *      frame to the application and sets MPCM again. A node therefore takes two
+ *      RXC interrupts and one DMA interrupt per frame sent to it, and one RXC
+ *      interrupt per frame sent to another node, whatever the payload length.
+ *
+ *      The master sends the address with TXB8 set, and the length and payload
+ *      by a DMA channel triggered by the data register empty flag.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef USART_MULTIDROP_H
+#define USART_MULTIDROP_H
+
+#include "avr_compiler.h"
+#include "usart_driver.h"
+
+/* Definition of macros. */
+
+#ifndef MULTIDROP_MAX_PAYLOAD
+/*! Largest payload of a frame, in bytes. Longer frames are dropped. */
+#define MULTIDROP_MAX_PAYLOAD  32
+#endif
+
+/*! Address accepted by every node. */
+#define MULTIDROP_BROADCAST    0xFF
+
+
+/*! \brief Test if a node has a received frame for the application.
+ *
+ *  \param _node  Pointer to the node.
+ */
+#define MULTIDROP_FrameAvailable(_node)  ((_node)->frameReady)
+
+
+/*! \brief Get the payload length of the received frame.
+ *
+ *  \param _node  Pointer to the node.
+ */
+#define MULTIDROP_FrameLength(_node)     ((_node)->frameLength)
+
+
+/*! \brief Test if the master is still sending a frame.
+ *
+ *  The last two characters may still be in the USART when this turns false.
+ *
+ *  \param _master  Pointer to the master.
+ */
+#define MULTIDROP_Master_IsBusy(_master)                                       \
+	(((_master)->dmaChannel->CTRLA & DMA_CH_ENABLE_bm) != 0)
+
+
+/*! \brief Receive state of a node. */
+typedef enum MULTIDROP_State_enum {
+	/*! MPCM set, waiting for an address character. */
+	MULTIDROP_STATE_ADDRESS = 0,
+	/*! Addressed, waiting for the length character. */
+	MULTIDROP_STATE_LENGTH = 1,
+	/*! Payload being received by DMA. */
+	MULTIDROP_STATE_PAYLOAD = 2,
+} MULTIDROP_State_t;
+
+
+/*! \brief Multi-drop bus node.
+ *
+ *  The struct holds the USART and DMA channel of the node, the receive
+ *  state and a buffer for one frame. The buffer is written by the DMA
+ *  channel, so the struct must be in internal SRAM.
+ */
+typedef struct MULTIDROP_Node_struct {
+	/*! USART connected to the bus. */
+	USART_t * usart;
+	/*! DMA channel receiving the payload. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! RXC trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_RXC_gc. */
+	DMA_CH_TRIGSRC_t rxTrigger;
+	/*! RXC interrupt level while waiting for address and length. */
+	USART_RXCINTLVL_t rxIntLevel;
+	/*! DMA transaction complete interrupt level. */
+	DMA_CH_TRNINTLVL_t dmaIntLevel;
+	/*! Own address, 0 to 254. */
+	uint8_t address;
+	/*! Receive state. */
+	volatile MULTIDROP_State_t state;
+	/*! Address of the received frame, own or MULTIDROP_BROADCAST. */
+	volatile uint8_t frameAddress;
+	/*! Payload length of the received frame. */
+	volatile uint8_t frameLength;
+	/*! A frame is in the buffer, until MULTIDROP_ReleaseFrame(). */
+	volatile bool frameReady;
+	/*! Frames for this node dropped: buffer not released, or too long. */
+	volatile uint16_t framesDropped;
+	/*! Payload of the received frame. */
+	volatile uint8_t buffer[MULTIDROP_MAX_PAYLOAD];
+} MULTIDROP_Node_t;
+
+
+/*! \brief Multi-drop bus master.
+ *
+ *  The struct holds the USART and DMA channel of the master and a copy of
+ *  the length and payload of the frame being sent, read by the DMA channel.
+ */
+typedef struct MULTIDROP_Master_struct {
+	/*! USART connected to the bus. */
+	USART_t * usart;
+	/*! DMA channel sending length and payload. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! DRE trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_DRE_gc. */
+	DMA_CH_TRIGSRC_t dreTrigger;
+	/*! Length and payload of the frame being sent. */
+	uint8_t buffer[MULTIDROP_MAX_PAYLOAD + 1];
+} MULTIDROP_Master_t;
+
+
+/* Prototyping of functions. */
+
+void MULTIDROP_Node_Init(MULTIDROP_Node_t * node,
+                         USART_t * usart,
+                         volatile DMA_CH_t * dmaChannel,
+                         DMA_CH_TRIGSRC_t rxTrigger,
+                         uint8_t address,
+                         USART_RXCINTLVL_t rxIntLevel,
+                         DMA_CH_TRNINTLVL_t dmaIntLevel);
+void MULTIDROP_RXComplete(MULTIDROP_Node_t * node);
+void MULTIDROP_DMAComplete(MULTIDROP_Node_t * node);
+void MULTIDROP_ReleaseFrame(MULTIDROP_Node_t * node);
+
+void MULTIDROP_Master_Init(MULTIDROP_Master_t * master,
+                           USART_t * usart,
+                           volatile DMA_CH_t * dmaChannel,
+                           DMA_CH_TRIGSRC_t dreTrigger);
+bool MULTIDROP_Master_Send(MULTIDROP_Master_t * master,
+                           uint8_t address,
+                           const uint8_t * data,
+                           uint8_t length);
+
+#endif
@@ -0,0 +1,295 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART RS-485 half-duplex transmitter source file.
+ *
+ *      This file contains the function implementations of the RS-485 half-duplex
+ *      transmitter. See usart_rs485.h for how the transmitter works.
+ *
+ *      The queue is shared with the interrupt handlers: RS485_Send() only writes
+ *      the head, and the handlers only write the tail, so the queue itself needs
+ *      no critical region. Starting the first frame from RS485_Send() does, as
+ *      it races with the handler finishing the previous one.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "usart_rs485.h"
+
+/*! Timer/Counter clock prescaler of each TC_CLKSEL_DIVn_gc setting. */
+static const uint16_t RS485_prescaler[] = {0, 1, 2, 4, 8, 64, 256, 1024};
+
+
+
+/*! \brief Start sending the frame at the tail of the queue.
+ *
+ *  The receiver is disabled first if the echo is suppressed, then DE is set
+ *  and the DMA channel started on the data register empty trigger, which
+ *  is already set, so the first start bit follows within a few cycles.
+ *
+ *  \param tx  The transmitter.
+ */
+static void RS485_StartFrame(RS485_Transmitter_t * tx)
+{
+	volatile DMA_CH_t * channel = tx->dmaChannel;
+	USART_t * usart = tx->usart;
+	const RS485_Frame_t * frame = &tx->queue[tx->tail];
+	uint32_t srcAddr = (uint32_t) (uintptr_t) frame->data;
+	uint32_t destAddr = (uint32_t) (uintptr_t) &usart->DATA;
+
+	tx->state = RS485_STATE_SENDING;
+	if (tx->suppressEcho) {
+		USART_Rx_Disable(usart);
+	}
+	tx->dePort->OUTSET = tx->deMask;
+
+	/* Clear TXC from the previous frame by writing one. */
+	usart->STATUS = USART_TXCIF_bm;
+	USART_TxdInterruptLevel_Set(usart, tx->txcIntLevel);
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+	channel->ADDRCTRL = DMA_CH_SRCDIR_INC_gc | DMA_CH_DESTDIR_FIXED_gc;
+	channel->TRIGSRC = tx->dreTrigger;
+	channel->TRFCNT = frame->length;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Start the next queued frame, or go idle.
+ *
+ *  Called from the interrupt handlers with DE released.
+ *
+ *  \param tx  The transmitter.
+ */
+static void RS485_Next(RS485_Transmitter_t * tx)
+{
+	if (tx->tail != tx->head) {
+		RS485_StartFrame(tx);
+	} else {
+		tx->state = RS485_STATE_IDLE;
+	}
+}
+
+
+
+/*! \brief Initialize the RS-485 transmitter.
+ *
+ *  The USART must have been set up for the baud rate and frame format. The
+ *  DE pin is made an output and driven low, and the transmitter of the
+ *  USART is enabled. The receiver is left as it is; with echo suppression
+ *  it is disabled while sending and enabled after each frame.
+ *
+ *  The gap timer runs from the CPU clock with the smallest prescaler that
+ *  fits the gap in 16 bits, and the gap is rounded up to whole ticks.
+ *
+ *  \param tx            The transmitter.
+ *  \param usart         USART connected to the transceiver.
+ *  \param dmaChannel    DMA channel sending the frames.
+ *  \param dreTrigger    DRE trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_DRE_gc.
+ *  \param dePort        Port of the transceiver driver enable pin.
+ *  \param deMask        Bit mask of the driver enable pin.
+ *  \param tc            Timer/Counter timing the turnaround gap, may be NULL
+ *                       if gapBits is 0.
+ *  \param baudrate      Baud rate, used to convert the gap to timer ticks.
+ *  \param gapBits       Bus idle time between frames in bit times, counted
+ *                       from the last stop bit of a frame; 0 for none.
+ *  \param suppressEcho  True to disable the receiver while DE is set.
+ *  \param txcIntLevel   TXC interrupt level, used while sending.
+ *  \param gapIntLevel   Overflow interrupt level of the gap timer.
+ */
+void RS485_Init(RS485_Transmitter_t * tx,
+                USART_t * usart,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dreTrigger,
+                PORT_t * dePort,
+                uint8_t deMask,
+                TC0_t * tc,
+                uint32_t baudrate,
+                uint16_t gapBits,
+                bool suppressEcho,
+                USART_TXCINTLVL_t txcIntLevel,
+                TC_OVFINTLVL_t gapIntLevel)
+{
+	uint32_t cycles = (uint32_t) (((uint64_t) F_CPU * gapBits + baudrate - 1) / baudrate);
+	uint8_t clockSelect = TC_CLKSEL_DIV1_gc;
+	uint16_t prescaler;
+
+	tx->usart = usart;
+	tx->dmaChannel = dmaChannel;
+	tx->dreTrigger = dreTrigger;
+	tx->dePort = dePort;
+	tx->deMask = deMask;
+	tx->tc = tc;
+	tx->txcIntLevel = txcIntLevel;
+	tx->gapIntLevel = gapIntLevel;
+	tx->suppressEcho = suppressEcho;
+	tx->state = RS485_STATE_IDLE;
+	tx->head = 0;
+	tx->tail = 0;
+	tx->framesSent = 0;
+
+	while ((clockSelect < TC_CLKSEL_DIV1024_gc) &&
+	       (cycles > 0xFFFFUL * RS485_prescaler[clockSelect])) {
+		clockSelect++;
+	}
+	prescaler = RS485_prescaler[clockSelect];
+	cycles = (cycles + prescaler - 1) / prescaler;
+	tx->gapTicks = (cycles > 0xFFFF) ? 0xFFFF : (uint16_t) cycles;
+	tx->clockSelect = (TC_CLKSEL_t) clockSelect;
+
+	if (tx->gapTicks != 0) {
+		/* The timer overflows PER + 1 ticks after being started at 0. */
+		tc->CTRLA = TC_CLKSEL_OFF_gc;
+		tc->CTRLB = TC_WGMODE_NORMAL_gc;
+		tc->PER = tx->gapTicks - 1;
+		tc->INTFLAGS = TC0_OVFIF_bm;
+		tc->INTCTRLA = (tc->INTCTRLA & ~TC0_OVFINTLVL_gm) | gapIntLevel;
+	}
+
+	dePort->OUTCLR = deMask;
+	dePort->DIRSET = deMask;
+	DMA.CTRL |= DMA_ENABLE_bm;
+	USART_Tx_Enable(usart);
+}
+
+
+
+/*! \brief Queue a frame for sending.
+ *
+ *  The data is not copied; it is read by the DMA channel while the frame is
+ *  sent and must not be changed before RS485_FramesSent() has counted it.
+ *
+ *  \param tx      The transmitter.
+ *  \param data    Frame data.
+ *  \param length  Number of bytes, 1 or more.
+ *
+ *  \retval true   The frame was queued.
+ *  \retval false  The queue is full.
+ */
+bool RS485_Send(RS485_Transmitter_t * tx, const uint8_t * data, uint16_t length)
+{
+	uint8_t head = tx->head;
+	uint8_t next = (head + 1) & (RS485_QUEUE_SIZE - 1);
+
+	if (next == tx->tail) {
+		return false;
+	}
+	tx->queue[head].data = data;
+	tx->queue[head].length = length;
+
+	AVR_ENTER_CRITICAL_REGION();
+	tx->head = next;
+	if (tx->state == RS485_STATE_IDLE) {
+		RS485_StartFrame(tx);
+	}
+	AVR_LEAVE_CRITICAL_REGION();
+
+	return true;
+}
+
+
+
+/*! \brief Transmit Complete Interrupt Service Routine.
+ *
+ *  To be called first thing in the TXC interrupt of the USART, so nothing
+ *  delays the release of DE. The last stop bit of the frame has been sent:
+ *  DE is released, the receiver enabled again if the echo is suppressed,
+ *  and the gap timer or the next frame started. A TXC while the DMA channel
+ *  still has bytes to send is ignored.
+ *
+ *  \param tx  The transmitter.
+ */
+void RS485_TXComplete(RS485_Transmitter_t * tx)
+{
+	if (tx->dmaChannel->CTRLA & DMA_CH_ENABLE_bm) {
+		return;
+	}
+	tx->dePort->OUTCLR = tx->deMask;
+	USART_TxdInterruptLevel_Set(tx->usart, USART_TXCINTLVL_OFF_gc);
+	if (tx->suppressEcho) {
+		USART_Rx_Enable(tx->usart);
+	}
+
+	tx->tail = (tx->tail + 1) & (RS485_QUEUE_SIZE - 1);
+	tx->framesSent++;
+
+	if (tx->gapTicks != 0) {
+		TC0_t * tc = tx->tc;
+
+		tx->state = RS485_STATE_GAP;
+		tc->CNT = 0;
+		tc->CTRLA = tx->clockSelect;
+	} else {
+		RS485_Next(tx);
+	}
+}
+
+
+
+/*! \brief Gap timer overflow Interrupt Service Routine.
+ *
+ *  To be called from the overflow interrupt of the gap timer. The timer is
+ *  stopped and the next queued frame started.
+ *
+ *  \param tx  The transmitter.
+ */
+void RS485_GapElapsed(RS485_Transmitter_t * tx)
+{
+	TC0_t * tc = tx->tc;
+
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->INTFLAGS = TC0_OVFIF_bm;
+	RS485_Next(tx);
+}
@@ -0,0 +1,184 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART RS-485 half-duplex transmitter header file.
+ *
+ *      This file contains the type definitions, macros and function prototypes
+ *      of the RS-485 half-duplex transmitter. The transmitter sends queued frames
+ *      by DMA and switches the transceiver driver enable (DE) pin around each
+ *      frame, so the application neither toggles DE nor waits for the last stop
+ *      bit.
+ *
+ *      DE is set just before the DMA channel is started on the data register
+ *      empty trigger, and released by the TXC interrupt, which is raised when the
+ *      stop bit of the last character has left the shift register. The USART has
+ *      no TXC event for the event system, and the event system cannot drive a
+ *      port pin to a level, so the release is done in a minimal interrupt service
+ *      routine; the delay after the stop bit is the interrupt response time plus
+ *      a few cycles.
+ *
+ *      Frames are queued without copying: RS485_Send() stores a pointer to the
+ *      data, which must be left unchanged until the frame has been sent. After
+ *      each frame the next one is started when the turnaround gap, counted from
+ *      the TXC interrupt with a Timer/Counter 0 in one-shot use, has elapsed.
+ *      Without gap the next frame is started from the TXC interrupt.
+ *
+ *      With local echo suppression the receiver of the USART is disabled while
+ *      DE is set, so the characters echoed by the transceiver are not received.
+ *      Disabling the receiver flushes its buffer, so a frame to be sent should
+ *      only be queued when no reception is expected.
+ *
+ * \par Application note:
+ *      AVR1307: Using the XMEGA USART
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef USART_RS485_H
+#define USART_RS485_H
+
+#include "avr_compiler.h"
+#include "usart_driver.h"
+
+/* Definition of macros. */
+
+#ifndef RS485_QUEUE_SIZE
+/*! Number of frames in the transmit queue, a power of two up to 128. */
+#define RS485_QUEUE_SIZE  4
+#endif
+
+
+/*! \brief Test if the transmitter has sent every queued frame.
+ *
+ *  DE is released and no gap is running when this is true.
+ *
+ *  \param _tx  Pointer to the transmitter.
+ */
+#define RS485_IsIdle(_tx)  ((_tx)->state == RS485_STATE_IDLE)
+
+
+/*! \brief Get the number of frames sent since initialization.
+ *
+ *  The counter wraps at 65536.
+ *
+ *  \param _tx  Pointer to the transmitter.
+ */
+#define RS485_FramesSent(_tx)  ((_tx)->framesSent)
+
+
+/*! \brief State of the transmitter. */
+typedef enum RS485_State_enum {
+	/*! Nothing to send, DE released. */
+	RS485_STATE_IDLE = 0,
+	/*! Frame being sent, DE set. */
+	RS485_STATE_SENDING = 1,
+	/*! Turnaround gap after a frame, DE released. */
+	RS485_STATE_GAP = 2,
+} RS485_State_t;
+
+
+/*! \brief A frame in the transmit queue. */
+typedef struct RS485_Frame_struct {
+	/*! Frame data, read by the DMA channel. */
+	const uint8_t * data;
+	/*! Number of bytes, 1 or more. */
+	uint16_t length;
+} RS485_Frame_t;
+
+
+/*! \brief RS-485 half-duplex transmitter.
+ *
+ *  The struct holds the USART, DMA channel, DE pin and gap timer setup,
+ *  and the queue of frames to send. The frame at the tail of the queue is
+ *  the one being sent.
+ */
+typedef struct RS485_Transmitter_struct {
+	/*! USART connected to the transceiver. */
+	USART_t * usart;
+	/*! DMA channel sending the frames. */
+	volatile DMA_CH_t * dmaChannel;
+	/*! DRE trigger of the USART, e.g. DMA_CH_TRIGSRC_USARTC0_DRE_gc. */
+	DMA_CH_TRIGSRC_t dreTrigger;
+	/*! Port of the transceiver driver enable pin. */
+	PORT_t * dePort;
+	/*! Bit mask of the driver enable pin. */
+	uint8_t deMask;
+	/*! Timer/Counter timing the turnaround gap, NULL without gap. */
+	TC0_t * tc;
+	/*! Clock selection of the gap timer. */
+	TC_CLKSEL_t clockSelect;
+	/*! Turnaround gap in timer ticks, 0 for back to back frames. */
+	uint16_t gapTicks;
+	/*! TXC interrupt level used while sending. */
+	USART_TXCINTLVL_t txcIntLevel;
+	/*! Overflow interrupt level of the gap timer. */
+	TC_OVFINTLVL_t gapIntLevel;
+	/*! Disable the receiver while DE is set. */
+	bool suppressEcho;
+	/*! Transmitter state. */
+	volatile RS485_State_t state;
+	/*! Frames to send, from tail to head. */
+	RS485_Frame_t queue[RS485_QUEUE_SIZE];
+	/*! Index of the next free queue entry. */
+	volatile uint8_t head;
+	/*! Index of the frame being sent or sent next. */
+	volatile uint8_t tail;
+	/*! Frames sent, see RS485_FramesSent(). */
+	volatile uint16_t framesSent;
+} RS485_Transmitter_t;
+
+
+/* Prototyping of functions. */
+
+void RS485_Init(RS485_Transmitter_t * tx,
+                USART_t * usart,
+                volatile DMA_CH_t * dmaChannel,
+                DMA_CH_TRIGSRC_t dreTrigger,
+                PORT_t * dePort,
+                uint8_t deMask,
+                TC0_t * tc,
+                uint32_t baudrate,
+                uint16_t gapBits,
+                bool suppressEcho,
+                USART_TXCINTLVL_t txcIntLevel,
+                TC_OVFINTLVL_t gapIntLevel);
+bool RS485_Send(RS485_Transmitter_t * tx, const uint8_t * data, uint16_t length);
+void RS485_TXComplete(RS485_Transmitter_t * tx);
+void RS485_GapElapsed(RS485_Transmitter_t * tx);
+
+#endif
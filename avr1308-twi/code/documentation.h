@@ -16,6 +16,22 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section trace Interrupt Tracing
+ * The TWI master and slave ISRs of the example record their entry and exit
+ * with the interrupt trace driver of application note AVR1307, whose
+ * directory is in the include path of the project. The trace macros are
+ * empty unless TRACE_ENABLED is defined. Define it and add trace_driver.c to
+ * the project to send the trace on PC3 after each transaction, at a baud
+ * rate chosen by usart_baud.h of AVR1307 from F_CPU. The trace is decoded on
+ * the host by tools/trace_decode.c of AVR1307. \n
+ *
+ * \section hostsim Host Simulation
+ * The drivers can also be built for a Linux x86-64 host, using the register
+ * headers and the simulator in the host_sim directory of AVR1307. See
+ * host_sim/twi_transaction.c for master transactions with the slave driver on
+ * the same bus, timed against the bus bit rate, and sim.h for what is
+ * modelled. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
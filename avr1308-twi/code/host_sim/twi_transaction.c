@@ -0,0 +1,280 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host transaction test of the TWI master and slave drivers.
+ *
+ *      This program runs the set-up of twi_example.c on the host simulator:
+ *      the master and the slave of TWIC talk to each other at 100 kHz, with
+ *      a 2 MHz CPU clock, and the slave returns the inverted bytes it
+ *      received.
+ *
+ *      Scenarios:
+ *        - write_read: eight bytes written and eight read back with a
+ *          repeated START, as benchmarked by asf_benchmark_example. The
+ *          bytes read must be the inverted bytes written, and the
+ *          transaction must take the SCL periods of its bits plus no more
+ *          than the time the ISRs held SCL.
+ *        - write: three bytes written. The slave must see the STOP.
+ *        - read: four bytes read, the inverted bytes of write_read.
+ *        - nack: a write to an address without a slave must end with
+ *          TWIM_RESULT_NACK_RECEIVED, without the slave being involved.
+ *        - oversize: a request beyond the eight byte buffers is refused.
+ *
+ *      Each scenario prints one line of space separated key=value pairs, with
+ *      the transaction time in CPU cycles. The program exits with a non-zero
+ *      status if a check fails.
+ *
+ *      Build and run from the directory holding twi_master_driver.c. The
+ *      simulator is shared with AVR1307:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/twi_transaction.c \
+ *            twi_master_driver.c twi_slave_driver.c -o twi_transaction
+ *        ./twi_transaction
+ *
+ * \par Application note:
+ *      AVR1308: Using the XMEGA TWI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2660 $
+ * $Date: 2009-08-11 12:28:58 +0200 (ti, 11 aug 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "avr_compiler.h"
+#include "twi_master_driver.h"
+#include "twi_slave_driver.h"
+#include "sim.h"
+
+/*! Address of the slave, and an address without a slave. */
+#define SLAVE_ADDRESS     0x55
+#define ABSENT_ADDRESS    0x33
+
+/*! Number of bytes in the buffers. */
+#define NUM_BYTES         8
+
+/*! SCL frequency and baud register setting, as in twi_example.c. */
+#define BAUDRATE          100000
+#define TWI_BAUDSETTING   TWI_BAUD_MAX(F_CPU, BAUDRATE)
+
+/*! CPU cycles per SCL period, from the baud register setting. */
+#define BIT_CYCLES        (2 * (TWI_BAUDSETTING + 5))
+
+/*! SCL periods of START or repeated START, an address byte and its ACK. */
+#define ADDRESS_BITS      10
+
+/*! SCL periods of a data byte and its ACK, and of STOP. */
+#define BYTE_BITS         9
+#define STOP_BITS         1
+
+/*! Longest time a transaction may take, in CPU cycles. */
+#define TIMEOUT_CYCLES    100000UL
+
+
+/* Global variables */
+TWI_Master_t twiMaster;    /*!< TWI master module. */
+TWI_Slave_t twiSlave;      /*!< TWI slave module. */
+
+/*! Test data, as in twi_example.c. */
+static uint8_t sendBuffer[NUM_BYTES] = {0x55, 0xAA, 0xF0, 0x0F, 0xB0, 0x0B, 0xDE, 0xAD};
+
+
+/*! \brief Invert the received byte into the send buffer of the slave. */
+static void TWIC_SlaveProcessData(void)
+{
+	uint8_t bufIndex = twiSlave.bytesReceived;
+	twiSlave.sendData[bufIndex] = (~twiSlave.receivedData[bufIndex]);
+}
+
+
+/*! TWIC Master Interrupt vector. */
+ISR(TWIC_TWIM_vect)
+{
+	TWI_MasterInterruptHandler(&twiMaster);
+}
+
+
+/*! TWIC Slave Interrupt vector. */
+ISR(TWIC_TWIS_vect)
+{
+	TWI_SlaveInterruptHandler(&twiSlave);
+}
+
+
+/*! \brief Wait until the master driver is ready and the bus is idle.
+ *
+ *  \return  CPU cycles since \a start, or 0 on timeout.
+ */
+static uint32_t Test_Wait(uint64_t start)
+{
+	while ((twiMaster.status != TWIM_STATUS_READY) ||
+	       (TWI_MasterState(&twiMaster) != TWI_MASTER_BUSSTATE_IDLE_gc)) {
+		if (SIM_GetCycles() - start > TIMEOUT_CYCLES) {
+			return 0;
+		}
+		SIM_Run(1);
+	}
+	return (uint32_t) (SIM_GetCycles() - start);
+}
+
+
+/*! \brief CPU cycles spent in the TWIC ISRs since the statistics were cleared. */
+static uint64_t Test_IsrCycles(void)
+{
+	return SIM_GetIrqStats(TWIC_TWIM_vect_num)->cycles +
+	       SIM_GetIrqStats(TWIC_TWIS_vect_num)->cycles;
+}
+
+
+/*! \brief Run one transaction, check it and report.
+ *
+ *  \param name     Name of the scenario.
+ *  \param address  Slave address.
+ *  \param toWrite  Number of bytes of sendBuffer to write.
+ *  \param toRead   Number of bytes to read.
+ *  \param result   Expected result of the master driver.
+ *
+ *  \return  true if the checks passed.
+ */
+static bool Test_Transaction(const char * name, uint8_t address, uint8_t toWrite,
+                             uint8_t toRead, TWIM_RESULT_t result)
+{
+	bool isSlave = (address == SLAVE_ADDRESS);
+	uint32_t bits;
+	uint32_t cycles;
+	uint64_t start;
+	uint64_t isrCycles;
+	bool dataOk = true;
+	bool timeOk;
+	bool success;
+	uint8_t i;
+
+	SIM_ClearStats();
+	twiSlave.result = TWIS_RESULT_UNKNOWN;
+	start = SIM_GetCycles();
+	success = TWI_MasterWriteRead(&twiMaster, address, sendBuffer, toWrite, toRead);
+	cycles = Test_Wait(start);
+	isrCycles = Test_IsrCycles();
+
+	/* A NACK ends the transaction after the address; every ACK bit is
+	 * counted with its byte. */
+	if (!isSlave) {
+		bits = ADDRESS_BITS + STOP_BITS;
+	} else {
+		bits = ((toWrite > 0) + (toRead > 0)) * ADDRESS_BITS +
+		       (toWrite + toRead) * BYTE_BITS + STOP_BITS;
+	}
+	timeOk = (cycles >= bits * BIT_CYCLES) && (cycles <= bits * BIT_CYCLES + isrCycles);
+
+	for (i = 0; isSlave && (i < toWrite); i++) {
+		dataOk &= (twiSlave.receivedData[i] == sendBuffer[i]);
+	}
+	for (i = 0; isSlave && (i < toRead); i++) {
+		dataOk &= ((twiMaster.readData[i] ^ sendBuffer[i]) == 0xFF);
+	}
+	success &= (cycles != 0) && (twiMaster.result == result) && dataOk && timeOk;
+	if (isSlave) {
+		success &= (twiSlave.status == TWIS_STATUS_READY) &&
+		           (twiSlave.result == TWIS_RESULT_OK) && (twiSlave.bytesSent == toRead);
+	} else {
+		success &= (twiSlave.result == TWIS_RESULT_UNKNOWN);
+	}
+
+	printf("scenario=%s address=0x%02X write=%u read=%u master_result=%u slave_result=%u "
+	       "data=%s bits=%lu bus_cycles=%lu cycles=%lu isr_cycles=%lu bytes_per_s=%lu result=%s\n",
+	       name,
+	       address,
+	       toWrite,
+	       toRead,
+	       twiMaster.result,
+	       twiSlave.result,
+	       dataOk ? "ok" : "wrong",
+	       (unsigned long) bits,
+	       (unsigned long) (bits * BIT_CYCLES),
+	       (unsigned long) cycles,
+	       (unsigned long) isrCycles,
+	       (cycles != 0) ? (unsigned long) ((toWrite + toRead) * (uint64_t) F_CPU / cycles) : 0UL,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Check that a request beyond the buffers is refused and report. */
+static bool Test_Oversize(void)
+{
+	uint8_t data[NUM_BYTES + 1] = { 0 };
+	bool writeRefused = !TWI_MasterWriteRead(&twiMaster, SLAVE_ADDRESS, data, NUM_BYTES + 1, 0);
+	bool readRefused = !TWI_MasterWriteRead(&twiMaster, SLAVE_ADDRESS, data, 0, NUM_BYTES + 1);
+	bool success = writeRefused && readRefused && (twiMaster.status == TWIM_STATUS_READY);
+
+	printf("scenario=oversize write_refused=%s read_refused=%s result=%s\n",
+	       writeRefused ? "yes" : "no",
+	       readRefused ? "yes" : "no",
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Run the scenarios and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+
+	TWI_MasterInit(&twiMaster, &TWIC, TWI_MASTER_INTLVL_LO_gc, TWI_BAUDSETTING);
+	TWI_SlaveInitializeDriver(&twiSlave, &TWIC, TWIC_SlaveProcessData);
+	TWI_SlaveInitializeModule(&twiSlave, SLAVE_ADDRESS, TWI_SLAVE_INTLVL_LO_gc);
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	success &= Test_Transaction("write_read", SLAVE_ADDRESS, NUM_BYTES, NUM_BYTES, TWIM_RESULT_OK);
+	success &= Test_Transaction("write", SLAVE_ADDRESS, 3, 0, TWIM_RESULT_OK);
+	success &= Test_Transaction("read", SLAVE_ADDRESS, 0, 4, TWIM_RESULT_OK);
+	success &= Test_Transaction("nack", ABSENT_ADDRESS, 1, 0, TWIM_RESULT_NACK_RECEIVED);
+	success &= Test_Oversize();
+
+	printf("summary baud=%u scl_hz=%lu bit_cycles=%u result=%s\n",
+	       (unsigned) TWI_BAUDSETTING,
+	       (unsigned long) TWI_FREQUENCY(F_CPU, TWI_BAUDSETTING),
+	       (unsigned) BIT_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -55,6 +55,17 @@
 #include "twi_master_driver.h"
 #include "twi_slave_driver.h"
 
+/* The interrupt trace driver and baud rate solver of application note
+ * AVR1307. The trace macros are empty unless TRACE_ENABLED is defined.
+ */
+#include "trace_driver.h"
+
+#ifdef TRACE_ENABLED
+/*! Baud rate the trace is sent at. */
+#define USART_BAUD_RATE  9600
+#include "usart_baud.h"
+#endif
+
 /*! Defining an example slave address. */
 #define SLAVE_ADDRESS    0x55
 
@@ -64,7 +75,11 @@
 /*! CPU speed 2MHz, BAUDRATE 100kHz and Baudrate Register Settings */
 #define CPU_SPEED       2000000
 #define BAUDRATE	100000
-#define TWI_BAUDSETTING TWI_BAUD(CPU_SPEED, BAUDRATE)
+#define TWI_BAUDSETTING TWI_BAUD_MAX(CPU_SPEED, BAUDRATE)
+
+#if (TWI_BAUDSETTING < 0) || (TWI_BAUDSETTING > 255)
+#error BAUDRATE cannot be generated from CPU_SPEED
+#endif
 
 
 /* Global variables */
@@ -120,6 +135,24 @@ int main(void)
 	                          SLAVE_ADDRESS,
 	                          TWI_SLAVE_INTLVL_LO_gc);
 
+#ifdef TRACE_ENABLED
+	/* Timestamp the ISRs with 4 us resolution, and send the trace on
+	 * PC3 (TXD0 of USARTC0) at 9600 baud, 8N1, after each transaction.
+	 */
+	TRACE_Init(TC_CLKSEL_DIV8_gc);
+	PORTC.DIRSET = PIN3_bm;
+	USARTC0.BAUDCTRLA = (uint8_t)USART_BSEL_VALUE;
+	USARTC0.BAUDCTRLB = (uint8_t)((uint8_t)USART_BSCALE_VALUE << USART_BSCALE0_bp) |
+	                    (USART_BSEL_VALUE >> 8);
+	USARTC0.CTRLC = USART_CMODE_ASYNCHRONOUS_gc | USART_PMODE_DISABLED_gc |
+	                USART_CHSIZE_8BIT_gc;
+#if USART_CLK2X_VALUE
+	USARTC0.CTRLB = USART_TXEN_bm | USART_CLK2X_bm;
+#else
+	USARTC0.CTRLB = USART_TXEN_bm;
+#endif
+#endif
+
 	/* Enable LO interrupt level. */
 	PMIC.CTRL |= PMIC_LOLVLEN_bm;
 	sei();
@@ -145,6 +178,7 @@ int main(void)
 			PORTE.OUT = sendBuffer[BufPos];
 		}
 
+		TRACE_RAISE(TWIC_TWIM_vect_num);
 		TWI_MasterWriteRead(&twiMaster,
 		                    SLAVE_ADDRESS,
 		                    &sendBuffer[BufPos],
@@ -158,6 +192,13 @@ int main(void)
 
 		/* Show the sent byte received and processed on LEDs. */
 		PORTE.OUT = (twiMaster.readData[0]);
+
+#ifdef TRACE_ENABLED
+		/* Decode the trace with tools/trace_decode.c of AVR1307. */
+		TRACE_Export(&USARTC0, &DMA.CH0, DMA_CH_TRIGSRC_USARTC0_DRE_gc);
+		while (!TRACE_IsExportDone(&DMA.CH0));
+		TRACE_Start();
+#endif
                 
                 while(PORTD.IN); /* Wait for user to release button */
 	}
@@ -166,11 +207,15 @@ int main(void)
 /*! TWIC Master Interrupt vector. */
 ISR(TWIC_TWIM_vect)
 {
+	TRACE_ISR_ENTER(TWIC_TWIM_vect_num);
 	TWI_MasterInterruptHandler(&twiMaster);
+	TRACE_ISR_EXIT(TWIC_TWIM_vect_num);
 }
 
 /*! TWIC Slave Interrupt vector. */
 ISR(TWIC_TWIS_vect)
 {
+	TRACE_ISR_ENTER(TWIC_TWIS_vect_num);
 	TWI_SlaveInterruptHandler(&twiSlave);
+	TRACE_ISR_EXIT(TWIC_TWIS_vect_num);
 }
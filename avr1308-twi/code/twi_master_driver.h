@@ -64,6 +64,12 @@
 /*! Baud register setting calculation. Formula described in datasheet. */
 #define TWI_BAUD(F_SYS, F_TWI) ((F_SYS / (2 * F_TWI)) - 5)
 
+/*! Baud register setting for the highest SCL frequency not above F_TWI. */
+#define TWI_BAUD_MAX(F_SYS, F_TWI) ((((F_SYS) + 2 * (F_TWI) - 1) / (2 * (F_TWI))) - 5)
+
+/*! SCL frequency given by a baud register setting, ignoring rise times. */
+#define TWI_FREQUENCY(F_SYS, BAUD) ((F_SYS) / (2 * ((BAUD) + 5)))
+
 
 /*! Transaction status defines. */
 #define TWIM_STATUS_READY              0
@@ -16,6 +16,31 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section usartspi USART in Master SPI Mode
+ * usart_spi_driver.c uses a USART in master SPI mode as an SPI master. The
+ * transmitter is double buffered, so the next byte can be written while
+ * the previous one is shifted out, and SCK runs without gaps between the
+ * bytes. Packets are transferred polled, one RXC interrupt per byte, or
+ * by two DMA channels with one interrupt per packet. SPI modes 2 and 3
+ * invert the XCK pin. \n
+ *
+ * \section spislavedma DMA-Driven SPI Slave
+ * spi_slave_dma_driver.c runs an SPI module as slave with two DMA channels,
+ * one storing the bytes received and one writing a response frame staged
+ * in advance. The rising edge of SS, sensed by port interrupt 0, ends a
+ * frame: the two receive buffers are swapped, and the next response is
+ * taken into use. The application stages a response by pointer, so the
+ * response buffers are swapped without copying. \n
+ *
+ * \section hostsim Host Simulation
+ * The drivers can also be built for a Linux x86-64 host, using the register
+ * headers and the simulator in the host_sim directory of AVR1307, which the
+ * host programs in the host_sim directory here share. See sim.h for what is
+ * modelled, usart_spi_benchmark.c for a comparison of the bus
+ * utilization and CPU load of the SPI module and of the USART in master
+ * SPI mode, and spi_slave_dma_master.c for the highest SCK rate of the
+ * DMA-driven slave. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
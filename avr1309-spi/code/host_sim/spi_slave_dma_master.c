@@ -0,0 +1,466 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host master model for the XMEGA SPI slave DMA driver.
+ *
+ *      This program is a host-side SPI master model for the DMA-driven SPI
+ *      slave in spi_slave_dma_driver.c. It measures the highest SCK rate the
+ *      slave sustains, and checks the frame handling of the driver.
+ *
+ *      The master sends frames to SPIC with the bytes of each frame back to
+ *      back, and holds SS high for SS_HIGH_CYCLES between frames. The slave
+ *      application answers frame k in frame k + 1: after each frame it takes
+ *      the bytes received and stages the response, each byte plus one, in the
+ *      response buffer that is not in use.
+ *
+ *      Scenarios:
+ *        - dma_tx_first: the response channel has the higher priority (CH0).
+ *        - dma_rx_first: the receive channel has the higher priority (CH0).
+ *        - int: one SPI interrupt per byte, which writes the next response
+ *          byte, as a baseline.
+ *        - frames: short and long frames and lost frames.
+ *
+ *      For each of the first three scenarios, the SCK period is swept from
+ *      2 to MAX_SCK_PERIOD CPU cycles. The lowest period from which all runs
+ *      pass is reported as the highest sustainable SCK rate, with the number
+ *      of interrupts and the CPU load of a run at that rate. The time the DMA
+ *      controller takes for a burst is set by DMA_LATENCY, an assumed figure.
+ *      The simulator does not count the C code between register accesses,
+ *      so each ISR is charged ISR_CYCLES for its body, of which
+ *      ISR_PROLOGUE_CYCLES come before the handler.
+ *
+ *      The slave must write the next response byte within half an SCK
+ *      period of the end of a byte. With the response channel first, the
+ *      DMA takes one burst for this; with the receive channel first, two.
+ *      The interrupt-driven slave also waits for the interrupt response and
+ *      the prologue. The slave limit of the datasheet, fPER/4, is not
+ *      modeled.
+ *
+ *      Each scenario prints one line of space separated key=value pairs,
+ *      and the program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding spi_driver.c. The simulator
+ *      is shared with AVR1307, and the DMA model needs a program linked with
+ *      -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/spi_slave_dma_master.c spi_driver.c spi_slave_dma_driver.c \
+ *            -o spi_slave_dma_master
+ *        ./spi_slave_dma_master
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "spi_driver.h"
+#include "spi_slave_dma_driver.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Assumed CPU cycles from a DMA trigger to the end of a one byte burst. */
+#define DMA_LATENCY     5
+
+/*! Estimated CPU cycles of the body of an ISR without its register accesses. */
+#define ISR_CYCLES      40
+
+/*! Part of ISR_CYCLES spent saving registers before the handler runs. */
+#define ISR_PROLOGUE_CYCLES  20
+
+/*! Bytes per frame of the sweep. */
+#define FRAME_BYTES     32
+
+/*! Frames per run of the sweep. */
+#define FRAMES          8
+
+/*! Size of each receive buffer. */
+#define RX_SIZE         48
+
+/*! Time SS is kept high between frames. */
+#define SS_HIGH_CYCLES  400
+
+/*! Longest SCK period of the sweep, in CPU cycles. */
+#define MAX_SCK_PERIOD  256
+
+/*! SS pin of SPIC (PC4). */
+#define SS_PIN_bm       PIN4_bm
+
+
+/*! \brief Slaves, by the driver and transfer method used. */
+typedef enum Slave_enum {
+	SLAVE_DMA_TX_FIRST,
+	SLAVE_DMA_RX_FIRST,
+	SLAVE_INT,
+} Slave_t;
+
+/*! Scenario names of the slaves. */
+static const char * const slaveNames[] = { "dma_tx_first", "dma_rx_first", "int" };
+
+/*! Slave in use. */
+static Slave_t slaveType;
+
+/*! DMA-driven slave on SPIC. */
+SPI_SlaveDMA_t dmaSlave;
+
+/*! Interrupt-driven slave on SPIC. */
+SPI_Slave_t intSlave;
+
+/*! Receive buffers and response buffers. In static data for the DMA. */
+uint8_t rxBuffer[2][RX_SIZE];
+uint8_t response[2][RX_SIZE];
+
+/*! Bytes received and response of the frame in progress, interrupt-driven slave. */
+static uint8_t intReceived[RX_SIZE];
+static const uint8_t *intResponse;
+static volatile uint8_t intCount;
+static volatile uint8_t intFrameLength;
+
+
+/*! \brief Start the slave of a scenario with a first response of FRAME_BYTES bytes. */
+static void Slave_Start(Slave_t type)
+{
+	uint8_t i;
+
+	slaveType = type;
+	for (i = 0; i < FRAME_BYTES; i++) {
+		response[0][i] = (uint8_t) (0xA0 + i);
+	}
+
+	if (type == SLAVE_INT) {
+		intResponse = response[0];
+		intCount = 0;
+		intFrameLength = 0;
+
+		/* Clear the flag left by the DMA, which does not clear it. */
+		(void) SPIC.STATUS;
+		(void) SPIC.DATA;
+		SPI_SlaveInit(&intSlave, &SPIC, &PORTC, false, SPI_MODE_0_gc, SPI_INTLVL_LO_gc);
+		PORTC.PIN4CTRL = PORT_ISC_RISING_gc;
+		PORTC.INT0MASK = SS_PIN_bm;
+		PORTC.INTCTRL = PORT_INT0LVL_LO_gc;
+		SPI_SlaveWriteByte(&intSlave, intResponse[0]);
+	} else {
+		SPI_SlaveDMA_Init(&dmaSlave, &SPIC, &PORTC, false, SPI_MODE_0_gc, PORT_INT0LVL_LO_gc);
+		SPI_SlaveDMA_SetResponse(&dmaSlave, response[0], FRAME_BYTES);
+		if (type == SLAVE_DMA_TX_FIRST) {
+			SPI_SlaveDMA_Start(&dmaSlave, &DMA.CH1, &DMA.CH0, DMA_CH_TRIGSRC_SPIC_gc,
+			                   rxBuffer[0], rxBuffer[1], RX_SIZE);
+		} else {
+			SPI_SlaveDMA_Start(&dmaSlave, &DMA.CH0, &DMA.CH1, DMA_CH_TRIGSRC_SPIC_gc,
+			                   rxBuffer[0], rxBuffer[1], RX_SIZE);
+		}
+	}
+}
+
+
+/*! \brief Take the frame received by the slave.
+ *
+ *  \return  Pointer to the bytes received, NULL if none.
+ */
+static const uint8_t * Slave_TakeFrame(uint8_t * length)
+{
+	if (slaveType != SLAVE_INT) {
+		return SPI_SlaveDMA_TakeFrame(&dmaSlave, length);
+	}
+	*length = intFrameLength;
+	return intReceived;
+}
+
+
+/*! \brief Stage the response of the slave for the next frame. */
+static void Slave_SetResponse(const uint8_t * data, uint8_t length)
+{
+	(void) length;
+	if (slaveType != SLAVE_INT) {
+		SPI_SlaveDMA_SetResponse(&dmaSlave, data, length);
+	} else {
+		intResponse = data;
+		SPI_SlaveWriteByte(&intSlave, intResponse[0]);
+	}
+}
+
+
+/*! \brief Send a frame from the master model and wait for its end.
+ *
+ *  SS is kept low for one SCK period after the last byte, then kept high
+ *  for SS_HIGH_CYCLES.
+ *
+ *  \return  Number of bytes received from the slave.
+ */
+static uint16_t Master_Frame(const uint8_t * mosi, uint16_t length, uint8_t * miso,
+                             uint32_t period)
+{
+	uint16_t count;
+
+	SIM_SPI_Inject(&SPIC, mosi, length);
+	SIM_PORT_SetInput(&PORTC, 0x00);
+	while (!SIM_SPI_IsIdle(&SPIC)) {
+		SIM_Run(period);
+	}
+	SIM_Run(period);
+	SIM_PORT_SetInput(&PORTC, SS_PIN_bm);
+	count = SIM_SPI_Read(&SPIC, miso, length);
+	SIM_Run(SS_HIGH_CYCLES);
+	return count;
+}
+
+
+/*! \brief Get the CPU cycles spent in the ISRs since the statistics were cleared. */
+static uint64_t Master_IsrCycles(void)
+{
+	return SIM_GetIrqStats(PORTC_INT0_vect_num)->cycles +
+	       SIM_GetIrqStats(SPIC_INT_vect_num)->cycles;
+}
+
+
+/*! \brief Get the number of ISRs executed since the statistics were cleared. */
+static uint32_t Master_IsrCount(void)
+{
+	return SIM_GetIrqStats(PORTC_INT0_vect_num)->count +
+	       SIM_GetIrqStats(SPIC_INT_vect_num)->count;
+}
+
+
+/*! \brief Run FRAMES frames of FRAME_BYTES bytes at an SCK period.
+ *
+ *  \param cpuPermille  Where to store the CPU load of the ISRs.
+ *
+ *  \return  True if the slave received and answered all bytes.
+ */
+static bool Master_Run(Slave_t type, uint32_t period, uint32_t * cpuPermille)
+{
+	uint8_t mosi[FRAME_BYTES];
+	uint8_t miso[FRAME_BYTES];
+	uint8_t expected[FRAME_BYTES];
+	const uint8_t * frame;
+	uint8_t length;
+	uint64_t start;
+	bool success = true;
+	uint8_t k;
+	uint8_t i;
+
+	SIM_SPI_SetMasterClock(&SPIC, period, 0);
+	Slave_Start(type);
+	for (i = 0; i < FRAME_BYTES; i++) {
+		expected[i] = response[0][i];
+	}
+
+	SIM_ClearStats();
+	start = SIM_GetCycles();
+
+	for (k = 0; k < FRAMES; k++) {
+		for (i = 0; i < FRAME_BYTES; i++) {
+			mosi[i] = (uint8_t) (k * 37 + i * 11 + period);
+		}
+		success &= Master_Frame(mosi, FRAME_BYTES, miso, period) == FRAME_BYTES;
+
+		/* The slave application answers the frame in the next one. */
+		frame = Slave_TakeFrame(&length);
+		success &= (frame != NULL) && (length == FRAME_BYTES);
+		for (i = 0; success && (i < FRAME_BYTES); i++) {
+			success = (miso[i] == expected[i]) && (frame[i] == mosi[i]);
+			response[(k + 1) & 1][i] = (uint8_t) (frame[i] + 1);
+			expected[i] = (uint8_t) (mosi[i] + 1);
+		}
+		Slave_SetResponse(response[(k + 1) & 1], FRAME_BYTES);
+	}
+
+	*cpuPermille = (uint32_t) (Master_IsrCycles() * 1000 / (SIM_GetCycles() - start));
+	if (type != SLAVE_INT) {
+		success &= (dmaSlave.framesLost == 0);
+	}
+	return success;
+}
+
+
+/*! \brief Find the highest SCK rate a slave sustains, and print it.
+ *
+ *  \return  Shortest SCK period from which all runs pass, 0 if none.
+ */
+static uint32_t Master_Sweep(Slave_t type)
+{
+	uint32_t cpuPermille;
+	uint32_t period;
+	uint32_t minPeriod = 0;
+	uint32_t isrCount = 0;
+	uint32_t cpuAtMin = 0;
+
+	for (period = MAX_SCK_PERIOD; period >= 2; period--) {
+		if (!Master_Run(type, period, &cpuPermille)) {
+			break;
+		}
+		minPeriod = period;
+		isrCount = Master_IsrCount();
+		cpuAtMin = cpuPermille;
+	}
+
+	printf("scenario=%s dma_latency=%u frame_bytes=%u min_sck_period=%lu "
+	       "max_sck_hz=%lu isr_count=%lu cpu_permille=%lu result=%s\n",
+	       slaveNames[type],
+	       DMA_LATENCY,
+	       FRAME_BYTES,
+	       (unsigned long) minPeriod,
+	       (unsigned long) (minPeriod ? F_CPU / minPeriod : 0),
+	       (unsigned long) isrCount,
+	       (unsigned long) cpuAtMin,
+	       (minPeriod != 0) ? "pass" : "fail");
+	return minPeriod;
+}
+
+
+/*! \brief Check short, long and lost frames of the DMA-driven slave.
+ *
+ *  A frame shorter than the response ends the response early, and the next
+ *  frame starts it again. In a frame longer than the response, the slave
+ *  sends back the bytes received after the response, and only RX_SIZE bytes
+ *  are stored. A frame received before the previous one is taken is
+ *  counted as lost.
+ *
+ *  \return  True if the checks passed.
+ */
+static bool Master_Frames(void)
+{
+	uint8_t mosi[RX_SIZE + 4];
+	uint8_t miso[RX_SIZE + 4];
+	const uint8_t * frame;
+	uint8_t length = 0;
+	bool success = true;
+	uint8_t i;
+
+	SIM_SPI_SetMasterClock(&SPIC, 32, 0);
+	Slave_Start(SLAVE_DMA_TX_FIRST);
+	for (i = 0; i < sizeof(mosi); i++) {
+		mosi[i] = (uint8_t) (i * 5 + 1);
+	}
+
+	/* Short frame. */
+	Master_Frame(mosi, 3, miso, 32);
+	frame = SPI_SlaveDMA_TakeFrame(&dmaSlave, &length);
+	success &= (frame != NULL) && (length == 3) && (frame[2] == mosi[2]);
+	success &= (miso[0] == response[0][0]) && (miso[2] == response[0][2]);
+
+	/* Long frame: the response again, then the bytes received. */
+	Master_Frame(mosi, sizeof(mosi), miso, 32);
+	frame = SPI_SlaveDMA_TakeFrame(&dmaSlave, &length);
+	success &= (frame != NULL) && (length == RX_SIZE);
+	for (i = 0; success && (i < sizeof(mosi)); i++) {
+		success = (i < RX_SIZE) ? (frame[i] == mosi[i]) : true;
+		success &= (i < FRAME_BYTES) ? (miso[i] == response[0][i]) :
+		                               (miso[i] == mosi[i - 1]);
+	}
+
+	/* Two frames without taking the first. */
+	Master_Frame(mosi, 4, miso, 32);
+	Master_Frame(mosi + 4, 4, miso, 32);
+	frame = SPI_SlaveDMA_TakeFrame(&dmaSlave, &length);
+	success &= (frame != NULL) && (length == 4) && (frame[0] == mosi[4]);
+	success &= (dmaSlave.framesLost == 1);
+	success &= (SPI_SlaveDMA_TakeFrame(&dmaSlave, &length) == NULL);
+
+	printf("scenario=frames short=3 long=%u rx_size=%u frames_lost=%u result=%s\n",
+	       (unsigned) sizeof(mosi), RX_SIZE, dmaSlave.framesLost,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Run all scenarios.
+ *
+ *  \return  0 if all checks passed, 1 otherwise.
+ */
+int main(void)
+{
+	uint32_t txFirst;
+	uint32_t rxFirst;
+	uint32_t interrupt;
+	bool success;
+
+	/* SS high. */
+	SIM_PORT_SetInput(&PORTC, SS_PIN_bm);
+	SIM_DMA_SetLatency(DMA_LATENCY);
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	txFirst = Master_Sweep(SLAVE_DMA_TX_FIRST);
+	rxFirst = Master_Sweep(SLAVE_DMA_RX_FIRST);
+	interrupt = Master_Sweep(SLAVE_INT);
+	success = (txFirst != 0) && (rxFirst != 0) && (interrupt != 0);
+	success &= (txFirst < rxFirst) && (rxFirst < interrupt);
+	success &= Master_Frames();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
+
+
+/*! \brief SS rising edge interrupt service routine. */
+ISR(PORTC_INT0_vect)
+{
+	SIM_Run(ISR_PROLOGUE_CYCLES);
+	if (slaveType != SLAVE_INT) {
+		SPI_SlaveDMA_SSHandler(&dmaSlave);
+	} else {
+		intFrameLength = intCount;
+		intCount = 0;
+		SPI_SlaveWriteByte(&intSlave, intResponse[0]);
+	}
+	SIM_Run(ISR_CYCLES - ISR_PROLOGUE_CYCLES);
+}
+
+
+/*! \brief SPI interrupt service routine of the interrupt-driven slave. */
+ISR(SPIC_INT_vect)
+{
+	uint8_t count;
+
+	SIM_Run(ISR_PROLOGUE_CYCLES);
+	count = intCount;
+	if (count < RX_SIZE) {
+		intReceived[count] = SPI_SlaveReadByte(&intSlave);
+		count++;
+		if (count < FRAME_BYTES) {
+			SPI_SlaveWriteByte(&intSlave, intResponse[count]);
+		}
+	}
+	intCount = count;
+	SIM_Run(ISR_CYCLES - ISR_PROLOGUE_CYCLES);
+}
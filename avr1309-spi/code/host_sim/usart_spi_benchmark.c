@@ -0,0 +1,391 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA SPI and USART master SPI benchmark for the host-side simulator.
+ *
+ *      This program compares the bus utilization of the SPI module driven by
+ *      SPI_MasterInterruptTransceivePacket() with the USART in master SPI mode
+ *      on the host simulator, for a range of SCK rates and packet lengths.
+ *
+ *      Scenarios, each transferring one packet with SS low from start to end:
+ *        - spi_int: SPIC, one SPI interrupt per byte (spi_driver.c).
+ *        - spi_polled: SPIC, SPI_MasterTransceivePacket().
+ *        - usart_polled: USARTD0, USART_SPI_MasterTransceivePacket().
+ *        - usart_int: USARTD0, one RXC interrupt per byte, one byte ahead.
+ *        - usart_dma: USARTD0, two DMA channels, one interrupt per packet.
+ *
+ *      The SCK divisor is the number of CPU cycles per SCK period, from 2 (the
+ *      fastest rate of both modules) to 32. The utilization is the time the
+ *      shift register was busy over the time from the start of the transfer
+ *      until the complete flag is seen. The simulator does not count the C
+ *      code between register accesses, so each ISR is charged ISR_CYCLES for
+ *      its body. The CPU load is the time spent in the ISRs, or all of the
+ *      time for the polled scenarios.
+ *
+ *      The slave answers with a known pattern on MISO, and the program checks
+ *      the bytes on MOSI and the bytes received. A second set of scenarios
+ *      checks the SPI mode and data order settings of the USART. Each scenario
+ *      prints one line of space separated key=value pairs, and the program
+ *      exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding spi_driver.c. The simulator
+ *      is shared with AVR1307, and the DMA model needs a program linked with
+ *      -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/usart_spi_benchmark.c spi_driver.c usart_spi_driver.c \
+ *            -o usart_spi_benchmark
+ *        ./usart_spi_benchmark
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1694 $
+ * $Date: 2008-07-29 14:21:58 +0200 (ti, 29 jul 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include "spi_driver.h"
+#include "usart_spi_driver.h"
+#include "avr_compiler.h"
+#include "sim.h"
+
+/*! Estimated CPU cycles of the body of an ISR without its register accesses. */
+#define ISR_CYCLES  40
+
+/*! Largest packet length. */
+#define MAX_BYTES   255
+
+/*! Shortest packet transferred by DMA. */
+#define DMA_THRESHOLD  16
+
+/*! Define that selects the USART used in the benchmark. */
+#define USART       USARTD0
+
+/*! SS pin of the slave on the SPI module (PC4) and on the USART (PD4). */
+#define SS_PIN_bm   PIN4_bm
+
+/*! SCK divisors benchmarked, CPU cycles per SCK period. */
+static const uint8_t divisors[] = {2, 4, 8, 16, 32};
+
+/*! Packet lengths benchmarked. */
+static const uint8_t lengths[] = {4, 32, 255};
+
+/*! SPI master on PORT C. */
+SPI_Master_t spiMaster;
+
+/*! USART SPI master on PORT D. */
+USART_SPI_Master_t usartSpi;
+
+/*! Data packet. */
+SPI_DataPacket_t dataPacket;
+
+/*! Bytes sent, received, and answered by the slave. In static data for the DMA. */
+uint8_t sendData[MAX_BYTES];
+uint8_t receivedData[MAX_BYTES];
+uint8_t slaveData[MAX_BYTES];
+
+
+/*! \brief Scenarios, by the driver and transfer method used. */
+typedef enum Scenario_enum {
+	SCENARIO_SPI_INT,
+	SCENARIO_SPI_POLLED,
+	SCENARIO_USART_POLLED,
+	SCENARIO_USART_INT,
+	SCENARIO_USART_DMA,
+	SCENARIO_COUNT,
+} Scenario_t;
+
+/*! Scenario names. */
+static const char * const scenarioNames[SCENARIO_COUNT] = {
+	"spi_int", "spi_polled", "usart_polled", "usart_int", "usart_dma"
+};
+
+
+/*! \brief Set up SPIC as master with an SCK divisor.
+ *
+ *  The polled driver needs the interrupt off, or the ISR would clear the
+ *  interrupt flag it waits for.
+ */
+static void Benchmark_SetupSpi(uint8_t divisor, SPI_INTLVL_t intLevel)
+{
+	uint32_t sck = F_CPU / divisor;
+
+	SPI_MasterInit(&spiMaster, &SPIC, &PORTC, false, SPI_MODE_0_gc,
+	               intLevel, SPI_CLK2X(F_CPU, sck), SPI_PRESCALER(F_CPU, sck));
+}
+
+
+/*! \brief Set up USARTD0 as SPI master with an SCK divisor.
+ *
+ *  Packets from DMA_THRESHOLD bytes on are transferred by DMA channels 0 and 1.
+ */
+static void Benchmark_SetupUsart(uint8_t divisor, bool lsbFirst, SPI_MODE_t mode)
+{
+	USART_SPI_MasterInit(&usartSpi, &USART, &PORTD, lsbFirst, mode,
+	                     USART_RXCINTLVL_LO_gc, USART_SPI_BSEL(F_CPU, F_CPU / divisor));
+	USART_SPI_MasterSetDMA(&usartSpi, &DMA.CH0, &DMA.CH1,
+	                       DMA_CH_TRIGSRC_USARTD0_RXC_gc, DMA_CH_TRNINTLVL_LO_gc, DMA_THRESHOLD);
+}
+
+
+/*! \brief Wait for the complete flag of the data packet. */
+static void Benchmark_WaitComplete(void)
+{
+	while (!dataPacket.complete) {
+		SIM_Run(1);
+	}
+}
+
+
+/*! \brief Get the CPU cycles spent in the ISRs since the statistics were cleared. */
+static uint64_t Benchmark_IsrCycles(void)
+{
+	return SIM_GetIrqStats(SPIC_INT_vect_num)->cycles +
+	       SIM_GetIrqStats(USARTD0_RXC_vect_num)->cycles +
+	       SIM_GetIrqStats(DMA_CH0_vect_num)->cycles;
+}
+
+
+/*! \brief Get the number of ISRs executed since the statistics were cleared. */
+static uint32_t Benchmark_IsrCount(void)
+{
+	return SIM_GetIrqStats(SPIC_INT_vect_num)->count +
+	       SIM_GetIrqStats(USARTD0_RXC_vect_num)->count +
+	       SIM_GetIrqStats(DMA_CH0_vect_num)->count;
+}
+
+
+/*! \brief Transfer one packet and print the result.
+ *
+ *  \return  True if MOSI and the received bytes are as expected.
+ */
+static bool Benchmark_Run(Scenario_t scenario, uint8_t divisor, uint8_t length)
+{
+	bool spi = (scenario == SCENARIO_SPI_INT) || (scenario == SCENARIO_SPI_POLLED);
+	bool polled = (scenario == SCENARIO_SPI_POLLED) || (scenario == SCENARIO_USART_POLLED);
+	uint8_t mosi[MAX_BYTES];
+	uint64_t shiftStart;
+	uint64_t shift;
+	uint64_t start;
+	uint64_t cycles;
+	uint64_t isrCycles;
+	uint16_t count;
+	bool success = true;
+	uint16_t i;
+
+	/* The DMA path is only taken from its threshold on. */
+	if ((scenario == SCENARIO_USART_DMA) && (length < DMA_THRESHOLD)) {
+		return true;
+	}
+
+	for (i = 0; i < length; i++) {
+		sendData[i] = (uint8_t) (i * 7 + divisor);
+		slaveData[i] = (uint8_t) (i * 13 + length);
+		receivedData[i] = 0;
+	}
+
+	if (spi) {
+		Benchmark_SetupSpi(divisor, polled ? SPI_INTLVL_OFF_gc : SPI_INTLVL_LO_gc);
+		SIM_SPI_Inject(&SPIC, slaveData, length);
+		SPI_MasterCreateDataPacket(&dataPacket, sendData, receivedData, length,
+		                           &PORTC, SS_PIN_bm);
+		shiftStart = SIM_SPI_GetShiftCycles(&SPIC);
+	} else {
+		Benchmark_SetupUsart(divisor, false, SPI_MODE_0_gc);
+		SIM_USART_Inject(&USART, slaveData, length);
+		SPI_MasterCreateDataPacket(&dataPacket, sendData, receivedData, length,
+		                           &PORTD, SS_PIN_bm);
+		shiftStart = SIM_USART_GetShiftCycles(&USART);
+	}
+
+	/* The interrupt path is forced by leaving out the DMA channels. */
+	if ((scenario == SCENARIO_USART_INT) && (length >= DMA_THRESHOLD)) {
+		usartSpi.rxChannel = NULL;
+	}
+
+	SIM_ClearStats();
+	start = SIM_GetCycles();
+
+	switch (scenario) {
+	case SCENARIO_SPI_INT:
+		while (SPI_MasterInterruptTransceivePacket(&spiMaster, &dataPacket) != SPI_OK) {
+		}
+		Benchmark_WaitComplete();
+		break;
+	case SCENARIO_SPI_POLLED:
+		SPI_MasterTransceivePacket(&spiMaster, &dataPacket);
+		break;
+	case SCENARIO_USART_POLLED:
+		USART_SPI_MasterTransceivePacket(&usartSpi, &dataPacket);
+		break;
+	default:
+		while (USART_SPI_MasterInterruptTransceivePacket(&usartSpi, &dataPacket) != SPI_OK) {
+		}
+		Benchmark_WaitComplete();
+		break;
+	}
+
+	cycles = SIM_GetCycles() - start;
+	if (spi) {
+		shift = SIM_SPI_GetShiftCycles(&SPIC) - shiftStart;
+		count = SIM_SPI_Read(&SPIC, mosi, sizeof(mosi));
+	} else {
+		shift = SIM_USART_GetShiftCycles(&USART) - shiftStart;
+		count = SIM_USART_Read(&USART, mosi, sizeof(mosi));
+	}
+	isrCycles = polled ? cycles : Benchmark_IsrCycles();
+
+	success = (count == length) && (dataPacket.bytesTransceived == length);
+	for (i = 0; success && (i < length); i++) {
+		success = (mosi[i] == sendData[i]) && (receivedData[i] == slaveData[i]);
+	}
+
+	printf("scenario=%s sck_div=%u bytes=%u cycles=%llu bus_cycles=%llu "
+	       "utilization_permille=%llu isr_count=%lu cpu_permille=%llu result=%s\n",
+	       scenarioNames[scenario],
+	       divisor,
+	       length,
+	       (unsigned long long) cycles,
+	       (unsigned long long) shift,
+	       (unsigned long long) (shift * 1000 / cycles),
+	       (unsigned long) Benchmark_IsrCount(),
+	       (unsigned long long) (isrCycles * 1000 / cycles),
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Check the SPI mode and data order settings of the USART.
+ *
+ *  The clock phase and the data order must be set in CTRLC and the clock
+ *  polarity by inverting XCK (PD1). The MOSI and MISO lines of the
+ *  simulator are in wire order, so 0x01 must go out as 0x80 with LSB first.
+ *
+ *  \return  True if the settings are right.
+ */
+static bool Benchmark_Config(uint8_t modeNumber, bool lsbFirst)
+{
+	static const SPI_MODE_t modes[4] = {
+		SPI_MODE_0_gc, SPI_MODE_1_gc, SPI_MODE_2_gc, SPI_MODE_3_gc
+	};
+	uint8_t wire = 0x80;
+	uint8_t mosi = 0;
+	uint8_t received;
+	bool success;
+
+	Benchmark_SetupUsart(2, lsbFirst, modes[modeNumber]);
+	SIM_USART_Inject(&USART, &wire, 1);
+	PORTD.OUTCLR = SS_PIN_bm;
+	received = USART_SPI_MasterTransceiveByte(&usartSpi, 0x01);
+	PORTD.OUTSET = SS_PIN_bm;
+	SIM_USART_Read(&USART, &mosi, 1);
+
+	success = ((USART.CTRLC & USART_CMODE_gm) == USART_CMODE_MSPI_gc) &&
+	          (((USART.CTRLC & USART_UCPHA_bm) != 0) == ((modeNumber & 1) != 0)) &&
+	          (((USART.CTRLC & USART_UDORD_bm) != 0) == lsbFirst) &&
+	          (((PORTD.PIN1CTRL & PORT_INVEN_bm) != 0) == (modeNumber >= 2)) &&
+	          (mosi == (lsbFirst ? 0x80 : 0x01)) &&
+	          (received == (lsbFirst ? 0x01 : 0x80));
+
+	printf("scenario=config mode=%u lsb_first=%u result=%s\n",
+	       modeNumber, lsbFirst, success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Run all scenarios.
+ *
+ *  \return  0 if all checks passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+	uint8_t mode;
+	uint8_t i;
+	uint8_t j;
+	uint8_t k;
+
+	/* SS pins as output, high. */
+	PORTC.OUTSET = SS_PIN_bm;
+	PORTC.DIRSET = SS_PIN_bm;
+	PORTD.OUTSET = SS_PIN_bm;
+	PORTD.DIRSET = SS_PIN_bm;
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	for (i = 0; i < sizeof(divisors); i++) {
+		for (j = 0; j < sizeof(lengths); j++) {
+			for (k = 0; k < SCENARIO_COUNT; k++) {
+				success &= Benchmark_Run((Scenario_t) k, divisors[i], lengths[j]);
+			}
+		}
+	}
+	for (mode = 0; mode < 4; mode++) {
+		success &= Benchmark_Config(mode, false);
+		success &= Benchmark_Config(mode, true);
+	}
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
+
+
+/*! \brief SPI master interrupt service routine. */
+ISR(SPIC_INT_vect)
+{
+	SPI_MasterInterruptHandler(&spiMaster);
+	SIM_Run(ISR_CYCLES);
+}
+
+
+/*! \brief USART SPI master RXC interrupt service routine. */
+ISR(USARTD0_RXC_vect)
+{
+	USART_SPI_MasterInterruptHandler(&usartSpi);
+	SIM_Run(ISR_CYCLES);
+}
+
+
+/*! \brief USART SPI master DMA interrupt service routine. */
+ISR(DMA_CH0_vect)
+{
+	USART_SPI_MasterDMAHandler(&usartSpi);
+	SIM_Run(ISR_CYCLES);
+}
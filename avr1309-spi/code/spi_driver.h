@@ -78,6 +78,38 @@
 #define SPI_BUSY            2     /*!< \brief The SPI module is busy with another transmission. */
 
 
+/* SPI clock rate selection. */
+
+/*! \brief Smallest SCK division factor giving at most the requested rate.
+ *
+ *  The result is 2, 4, 8, 16, 32, 64 or 128. The macro can be evaluated
+ *  by the preprocessor, and at runtime when the clock changes.
+ *
+ *  \param _fsys  Peripheral clock frequency in Hz.
+ *  \param _fsck  Highest SCK frequency wanted, in Hz.
+ */
+#define SPI_DIVISOR(_fsys, _fsck)                    \
+	( ( (_fsys) <= 2 * (_fsck) ) ? 2 :                \
+	  ( (_fsys) <= 4 * (_fsck) ) ? 4 :                \
+	  ( (_fsys) <= 8 * (_fsck) ) ? 8 :                \
+	  ( (_fsys) <= 16 * (_fsck) ) ? 16 :              \
+	  ( (_fsys) <= 32 * (_fsck) ) ? 32 :              \
+	  ( (_fsys) <= 64 * (_fsck) ) ? 64 : 128 )
+
+/*! \brief Double speed setting for SPI_DIVISOR(_fsys, _fsck). */
+#define SPI_CLK2X(_fsys, _fsck)                                       \
+	( ( SPI_DIVISOR(_fsys, _fsck) == 2 ) ||                          \
+	  ( SPI_DIVISOR(_fsys, _fsck) == 8 ) ||                          \
+	  ( SPI_DIVISOR(_fsys, _fsck) == 32 ) )
+
+/*! \brief Prescaler setting for SPI_DIVISOR(_fsys, _fsck). */
+#define SPI_PRESCALER(_fsys, _fsck)                                   \
+	( ( SPI_DIVISOR(_fsys, _fsck) <= 4 ) ? SPI_PRESCALER_DIV4_gc :   \
+	  ( SPI_DIVISOR(_fsys, _fsck) <= 16 ) ? SPI_PRESCALER_DIV16_gc : \
+	  ( SPI_DIVISOR(_fsys, _fsck) <= 64 ) ? SPI_PRESCALER_DIV64_gc : \
+	  SPI_PRESCALER_DIV128_gc )
+
+
 /*! \brief SPI data packet struct. */
 typedef struct SPI_DataPacket
 {
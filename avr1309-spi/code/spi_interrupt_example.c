@@ -56,6 +56,13 @@
 /*! \brief Number of test data bytes. */
 #define NUM_BYTES   2
 
+/*! \brief Highest SCK frequency. */
+#define SPI_SCK_HZ    500000UL
+
+#if ( F_CPU / 128 ) > SPI_SCK_HZ
+#error SPI_SCK_HZ cannot be reached from F_CPU
+#endif
+
 /* Global variables. */
 
 /*! \brief SPI master on PORT C. */
@@ -120,8 +127,8 @@ int main( void )
 				   false,
 	               SPI_MODE_0_gc,
 	               SPI_INTLVL_LO_gc,
-	               false,
-	               SPI_PRESCALER_DIV4_gc);
+	               SPI_CLK2X(F_CPU, SPI_SCK_HZ),
+	               SPI_PRESCALER(F_CPU, SPI_SCK_HZ));
 
 	/* Initialize SPI slave on port D. */
 	SPI_SlaveInit(&spiSlaveD,
@@ -0,0 +1,366 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA SPI slave DMA driver source file.
+ *
+ *      This file contains the function implementations of the DMA-driven SPI
+ *      slave driver. See spi_slave_dma_driver.h for an overview.
+ *
+ *      The frames are delimited by the SS pin of the SPI module, pin 4 of its
+ *      port, which is also sensed by port interrupt 0. The ISR of that
+ *      interrupt must call SPI_SlaveDMA_SSHandler().
+ *
+ *      The response byte for the next transfer must be in DATA before the first
+ *      SCK edge of that transfer, which on a master without gaps between the
+ *      bytes is half an SCK period after the previous transfer completed. The
+ *      byte received can wait for a whole transfer. The DMA channel writing the
+ *      response should therefore have the higher priority, i.e. the lower
+ *      channel number.
+ *
+ *      The master must keep SS low until the DMA has stored the last byte,
+ *      and high until SPI_SlaveDMA_SSHandler() has prepared the next frame.
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5407 $
+ * $Date: 2011-10-12 14:53:14 +0200 (on, 12 okt 2011) $  \n
+ *
+ * Copyright (c) 2009 Atmel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "spi_slave_dma_driver.h"
+
+
+/*! \brief Set up a DMA channel for a transfer between the SPI module and a buffer.
+ *
+ *  The channel is reset and set up for one block, one byte per trigger.
+ *  The address that is not the SPI data register is incremented.
+ *
+ *  \param channel   DMA channel.
+ *  \param trigger   Trigger source.
+ *  \param srcAddr   Source address.
+ *  \param destAddr  Destination address.
+ *  \param srcInc    True to increment the source, false to increment the
+ *                   destination.
+ *  \param count     Number of bytes.
+ */
+static void SPI_SlaveDMA_StartChannel(volatile DMA_CH_t *channel,
+                                      DMA_CH_TRIGSRC_t trigger,
+                                      uint32_t srcAddr,
+                                      uint32_t destAddr,
+                                      bool srcInc,
+                                      uint8_t count)
+{
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->ADDRCTRL = (srcInc ? DMA_CH_SRCDIR_INC_gc : DMA_CH_SRCDIR_FIXED_gc) |
+	                    (srcInc ? DMA_CH_DESTDIR_FIXED_gc : DMA_CH_DESTDIR_INC_gc);
+	channel->TRIGSRC = trigger;
+	channel->TRFCNT = count;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Prepare the response for the next frame.
+ *
+ *  The first byte is written to DATA, and the DMA channel writes the rest,
+ *  one byte after each transfer. Without a response, the dummy byte is
+ *  sent. After the last byte of the response, the slave sends back the
+ *  bytes it receives.
+ *
+ *  \param spi  The SPI_SlaveDMA_t struct instance.
+ */
+static void SPI_SlaveDMA_PrepareResponse(SPI_SlaveDMA_t *spi)
+{
+	const uint8_t *response = spi->response;
+	uint8_t length = spi->responseLength;
+
+	spi->txChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+
+	if ((response == NULL) || (length == 0)) {
+		spi->slave.module->DATA = SPI_SLAVE_DMA_DUMMY;
+		return;
+	}
+
+	if (length > 1) {
+		SPI_SlaveDMA_StartChannel(spi->txChannel, spi->trigger,
+		                          (uint32_t) (uintptr_t) (response + 1),
+		                          (uint32_t) (uintptr_t) &spi->slave.module->DATA,
+		                          true, length - 1);
+	}
+	spi->slave.module->DATA = response[0];
+}
+
+
+
+/*! \brief Prepare the reception of the next frame.
+ *
+ *  \param spi  The SPI_SlaveDMA_t struct instance.
+ */
+static void SPI_SlaveDMA_PrepareReceive(SPI_SlaveDMA_t *spi)
+{
+	SPI_SlaveDMA_StartChannel(spi->rxChannel, spi->trigger,
+	                          (uint32_t) (uintptr_t) &spi->slave.module->DATA,
+	                          (uint32_t) (uintptr_t) spi->rxBuffer[spi->rxIndex],
+	                          false, spi->rxSize);
+}
+
+
+
+/*! \brief Take the staged response into use and prepare the next frame.
+ *
+ *  \param spi  The SPI_SlaveDMA_t struct instance.
+ */
+static void SPI_SlaveDMA_PrepareFrame(SPI_SlaveDMA_t *spi)
+{
+	if (spi->nextResponse != NULL) {
+		spi->response = spi->nextResponse;
+		spi->responseLength = spi->nextResponseLength;
+		spi->nextResponse = NULL;
+	}
+
+	SPI_SlaveDMA_PrepareResponse(spi);
+	SPI_SlaveDMA_PrepareReceive(spi);
+}
+
+
+
+/*! \brief Initialize SPI module as DMA-driven slave.
+ *
+ *  This function initializes the SPI module as slave with the SPI interrupt
+ *  off, and sets port interrupt 0 to sense the rising edge of SS. The
+ *  pin configuration of SS is otherwise kept, and port interrupt 1 is left
+ *  to the application. SPI_SlaveDMA_Start() must be called to receive
+ *  frames.
+ *
+ *  \param spi          The SPI_SlaveDMA_t struct instance.
+ *  \param module       Pointer to the SPI module.
+ *  \param port         The I/O port where the SPI module is connected.
+ *  \param lsbFirst     Data order will be LSB first if this is set to true.
+ *  \param mode         SPI mode (Clock polarity and phase).
+ *  \param ssIntLevel   Level of the port interrupt ending the frames.
+ */
+void SPI_SlaveDMA_Init(SPI_SlaveDMA_t *spi,
+                       SPI_t *module,
+                       PORT_t *port,
+                       bool lsbFirst,
+                       SPI_MODE_t mode,
+                       PORT_INT0LVL_t ssIntLevel)
+{
+	SPI_SlaveInit(&spi->slave, module, port, lsbFirst, mode, SPI_INTLVL_OFF_gc);
+
+	spi->rxChannel      = NULL;
+	spi->txChannel      = NULL;
+	spi->response       = NULL;
+	spi->responseLength = 0;
+	spi->nextResponse   = NULL;
+	spi->frameLength    = 0;
+	spi->frameReceived  = false;
+	spi->framesLost     = 0;
+
+	/* Rising edge of SS on port interrupt 0. */
+	port->PIN4CTRL = (port->PIN4CTRL & ~PORT_ISC_gm) | PORT_ISC_RISING_gc;
+	port->INT0MASK |= SPI_SS_bm;
+	port->INTFLAGS = PORT_INT0IF_bm;
+	port->INTCTRL = (port->INTCTRL & ~PORT_INT0LVL_gm) | ssIntLevel;
+}
+
+
+
+/*! \brief Start receiving frames.
+ *
+ *  This function sets up the DMA channels for the first frame. It must be
+ *  called while SS is high. A response staged before with
+ *  SPI_SlaveDMA_SetResponse() is sent in the first frame, otherwise the
+ *  dummy byte.
+ *
+ *  The two receive buffers are used in turn: the frame received in one is
+ *  valid while the next frame is received in the other. Bytes beyond the
+ *  size of the buffers are not stored.
+ *
+ *  \param spi        The SPI_SlaveDMA_t struct instance.
+ *  \param rxChannel  DMA channel storing the bytes received.
+ *  \param txChannel  DMA channel writing the response, should have a lower
+ *                    number than \a rxChannel.
+ *  \param trigger    Transfer complete trigger of the SPI module, e.g.
+ *                    DMA_CH_TRIGSRC_SPIC_gc.
+ *  \param rxBuffer0  First receive buffer.
+ *  \param rxBuffer1  Second receive buffer.
+ *  \param rxSize     Size of each receive buffer, at least 1.
+ */
+void SPI_SlaveDMA_Start(SPI_SlaveDMA_t *spi,
+                        volatile DMA_CH_t *rxChannel,
+                        volatile DMA_CH_t *txChannel,
+                        DMA_CH_TRIGSRC_t trigger,
+                        uint8_t *rxBuffer0,
+                        uint8_t *rxBuffer1,
+                        uint8_t rxSize)
+{
+	spi->rxChannel   = rxChannel;
+	spi->txChannel   = txChannel;
+	spi->trigger     = trigger;
+	spi->rxBuffer[0] = rxBuffer0;
+	spi->rxBuffer[1] = rxBuffer1;
+	spi->rxSize      = rxSize;
+	spi->rxIndex     = 0;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	SPI_SlaveDMA_PrepareFrame(spi);
+}
+
+
+
+/*! \brief Stage the response to send.
+ *
+ *  Only the pointer and the length are stored, the response is not copied.
+ *  While SS is high, the response is prepared at once and sent in the next
+ *  frame. During a frame, it is staged and sent from the frame after; a
+ *  response staged before it and not yet taken into use is replaced. The
+ *  same response is sent in every frame until another one is set.
+ *
+ *  Before SPI_SlaveDMA_Start(), the response is staged for the first frame.
+ *
+ *  The buffer must not be changed while the response is staged or sent.
+ *  Once SPI_SlaveDMA_ResponsePending() is false after staging, the buffer
+ *  of the response before is free.
+ *
+ *  \param spi       The SPI_SlaveDMA_t struct instance.
+ *  \param response  Response to send.
+ *  \param length    Length of the response.
+ */
+void SPI_SlaveDMA_SetResponse(SPI_SlaveDMA_t *spi,
+                              const uint8_t *response,
+                              uint8_t length)
+{
+	AVR_ENTER_CRITICAL_REGION();
+
+	spi->nextResponse = response;
+	spi->nextResponseLength = length;
+
+	/* If started and no frame in progress. */
+	if ((spi->txChannel != NULL) && (spi->slave.port->IN & SPI_SS_bm)) {
+		spi->response = response;
+		spi->responseLength = length;
+		spi->nextResponse = NULL;
+		SPI_SlaveDMA_PrepareResponse(spi);
+	}
+
+	AVR_LEAVE_CRITICAL_REGION();
+}
+
+
+
+/*! \brief Take the last frame received.
+ *
+ *  The frame stays valid until the end of the next frame.
+ *
+ *  \param spi     The SPI_SlaveDMA_t struct instance.
+ *  \param length  Where to store the number of bytes received.
+ *
+ *  \return        Pointer to the bytes received, NULL if no frame has been
+ *                 received since the last one was taken.
+ */
+const uint8_t *SPI_SlaveDMA_TakeFrame(SPI_SlaveDMA_t *spi, uint8_t *length)
+{
+	const uint8_t *frame = NULL;
+
+	AVR_ENTER_CRITICAL_REGION();
+
+	if (spi->frameReceived) {
+		frame = spi->rxBuffer[spi->rxIndex ^ 1];
+		*length = spi->frameLength;
+		spi->frameReceived = false;
+	}
+
+	AVR_LEAVE_CRITICAL_REGION();
+
+	return frame;
+}
+
+
+
+/*! \brief Common SS interrupt service routine function.
+ *
+ *  This function is called by the port interrupt 0 service routine, when
+ *  SS has gone high. The number of bytes received is taken from the
+ *  receiving DMA channel, the receive buffers are swapped, and the staged
+ *  response, if any, is taken into use. Frames without any byte are not
+ *  reported.
+ *
+ *  The master must keep SS high until this function has prepared the next
+ *  frame.
+ *
+ *  \param spi  Pointer to the modules own SPI_SlaveDMA_t struct.
+ */
+void SPI_SlaveDMA_SSHandler(SPI_SlaveDMA_t *spi)
+{
+	volatile DMA_CH_t *channel = spi->rxChannel;
+	uint8_t length = spi->rxSize;
+
+	/* The channel disables itself when the buffer is full. */
+	if (channel->CTRLA & DMA_CH_ENABLE_bm) {
+		channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+		length -= (uint8_t) channel->TRFCNT;
+	}
+
+	if (length != 0) {
+		if (spi->frameReceived) {
+			spi->framesLost++;
+		}
+		spi->frameLength = length;
+		spi->frameReceived = true;
+		spi->rxIndex ^= 1;
+	}
+
+	SPI_SlaveDMA_PrepareFrame(spi);
+}
@@ -0,0 +1,154 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA SPI slave DMA driver header file.
+ *
+ *      This file contains the function prototypes, type definitions and macros
+ *      of the DMA-driven SPI slave driver. The slave answers each frame of the
+ *      master, from SS low to SS high, with a response prepared before the
+ *      frame starts, so the answer to a command is not one byte late and the
+ *      CPU does not have to serve each byte in time.
+ *
+ *      Two DMA channels are triggered by the transfer complete of the SPI
+ *      module. One stores the bytes received in a receive buffer, the other
+ *      writes the bytes of the response to DATA, so the byte to send is in the
+ *      shift register before the master clocks it out. The first byte of the
+ *      response is written by the CPU before the frame starts. The port
+ *      interrupt on the rising edge of SS ends the frame: the length received
+ *      is taken from the DMA channel, the receive buffers are swapped, and both
+ *      channels are set up again for the next frame.
+ *
+ *      The application stages the next response with SPI_SlaveDMA_SetResponse(),
+ *      which only stores a pointer and a length, and takes the frames received
+ *      with SPI_SlaveDMA_TakeFrame().
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5407 $
+ * $Date: 2011-10-12 14:53:14 +0200 (on, 12 okt 2011) $  \n
+ *
+ * Copyright (c) 2009 Atmel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef SPI_SLAVE_DMA_DRIVER_H
+#define SPI_SLAVE_DMA_DRIVER_H
+
+#include "avr_compiler.h"
+#include "spi_driver.h"
+
+/* Hardware defines */
+
+/*! \brief Byte sent when no response has been staged. */
+#define SPI_SLAVE_DMA_DUMMY   0xFF
+
+
+/*! \brief SPI slave DMA struct. Holds the SPI module, the DMA channels and
+ *         the buffers of the frames.
+ */
+typedef struct SPI_SlaveDMA
+{
+	SPI_Slave_t slave;                         /*!< \brief SPI module and port. */
+	volatile DMA_CH_t *rxChannel;              /*!< \brief DMA channel storing the bytes received. */
+	volatile DMA_CH_t *txChannel;              /*!< \brief DMA channel writing the response. */
+	DMA_CH_TRIGSRC_t trigger;                  /*!< \brief Transfer complete trigger of the SPI module. */
+	uint8_t *rxBuffer[2];                      /*!< \brief Receive buffers, used in turn. */
+	uint8_t rxSize;                            /*!< \brief Size of each receive buffer. */
+	uint8_t rxIndex;                           /*!< \brief Receive buffer of the frame in progress. */
+	const uint8_t *response;                   /*!< \brief Response of the frame in progress, NULL if none. */
+	uint8_t responseLength;                    /*!< \brief Length of the response. */
+	const uint8_t * volatile nextResponse;     /*!< \brief Staged response, NULL if none. */
+	volatile uint8_t nextResponseLength;       /*!< \brief Length of the staged response. */
+	volatile uint8_t frameLength;              /*!< \brief Bytes received in the last frame. */
+	volatile bool frameReceived;               /*!< \brief A frame has been received and not taken. */
+	volatile uint8_t framesLost;               /*!< \brief Frames received before the previous one was taken. */
+} SPI_SlaveDMA_t;
+
+
+/* Definitions of macros. */
+
+
+/*! \brief Checks if a frame has been received.
+ *
+ *  \param _spi     Pointer to SPI_SlaveDMA_t struct instance.
+ *
+ *  \retval true    A frame is waiting for SPI_SlaveDMA_TakeFrame().
+ *  \retval false   No frame has been received since the last one was taken.
+ */
+#define SPI_SlaveDMA_FrameAvailable(_spi) ( (_spi)->frameReceived )
+
+
+
+/*! \brief Checks if the staged response is still waiting for a frame.
+ *
+ *  When the staged response is taken into use, the buffer of the response
+ *  before it is no longer read and can be reused.
+ *
+ *  \param _spi     Pointer to SPI_SlaveDMA_t struct instance.
+ *
+ *  \retval true    The staged response has not been taken into use.
+ *  \retval false   The staged response is being sent, or none was staged.
+ */
+#define SPI_SlaveDMA_ResponsePending(_spi) ( (_spi)->nextResponse != NULL )
+
+
+/* Prototype functions. Documentation found in source file */
+
+void SPI_SlaveDMA_Init(SPI_SlaveDMA_t *spi,
+                       SPI_t *module,
+                       PORT_t *port,
+                       bool lsbFirst,
+                       SPI_MODE_t mode,
+                       PORT_INT0LVL_t ssIntLevel);
+
+void SPI_SlaveDMA_Start(SPI_SlaveDMA_t *spi,
+                        volatile DMA_CH_t *rxChannel,
+                        volatile DMA_CH_t *txChannel,
+                        DMA_CH_TRIGSRC_t trigger,
+                        uint8_t *rxBuffer0,
+                        uint8_t *rxBuffer1,
+                        uint8_t rxSize);
+
+void SPI_SlaveDMA_SetResponse(SPI_SlaveDMA_t *spi,
+                              const uint8_t *response,
+                              uint8_t length);
+
+const uint8_t *SPI_SlaveDMA_TakeFrame(SPI_SlaveDMA_t *spi, uint8_t *length);
+
+void SPI_SlaveDMA_SSHandler(SPI_SlaveDMA_t *spi);
+
+#endif
@@ -0,0 +1,447 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART master SPI driver source file.
+ *
+ *      This file contains the function implementations of the driver for the
+ *      USART in master SPI mode. See usart_spi_driver.h for an overview.
+ *
+ *      The USART pins are used as SCK (XCK), MOSI (TXD) and MISO (RXD). SS is
+ *      any port pin, given in the data packet as for the SPI module driver.
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5407 $
+ * $Date: 2011-10-12 14:53:14 +0200 (on, 12 okt 2011) $  \n
+ *
+ * Copyright (c) 2009 Atmel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "usart_spi_driver.h"
+
+
+
+/*! \brief Set the RXC interrupt level of the USART.
+ *
+ *  \param spi       The USART_SPI_Master_t struct instance.
+ *  \param intLevel  RXC interrupt level.
+ */
+static void USART_SPI_SetRxcLevel(USART_SPI_Master_t *spi, USART_RXCINTLVL_t intLevel)
+{
+	spi->usart->CTRLA = (spi->usart->CTRLA & ~USART_RXCINTLVL_gm) | intLevel;
+}
+
+
+
+/*! \brief Set up a DMA channel for a transfer between the USART and a buffer.
+ *
+ *  The channel is reset and set up for one block, one byte per trigger.
+ *  The address that is not the USART data register is incremented.
+ *
+ *  \param channel   DMA channel.
+ *  \param trigger   Trigger source.
+ *  \param srcAddr   Source address.
+ *  \param destAddr  Destination address.
+ *  \param srcInc    True to increment the source, false to increment the
+ *                   destination.
+ *  \param count     Number of bytes.
+ *  \param intLevel  Transaction complete interrupt level.
+ */
+static void USART_SPI_DMA_Start(volatile DMA_CH_t *channel,
+                                DMA_CH_TRIGSRC_t trigger,
+                                uint32_t srcAddr,
+                                uint32_t destAddr,
+                                bool srcInc,
+                                uint8_t count,
+                                DMA_CH_TRNINTLVL_t intLevel)
+{
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->CTRLB = DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm | intLevel;
+	channel->ADDRCTRL = (srcInc ? DMA_CH_SRCDIR_INC_gc : DMA_CH_SRCDIR_FIXED_gc) |
+	                    (srcInc ? DMA_CH_DESTDIR_FIXED_gc : DMA_CH_DESTDIR_INC_gc);
+	channel->TRIGSRC = trigger;
+	channel->TRFCNT = count;
+	channel->REPCNT = 0;
+
+	channel->SRCADDR0 = (srcAddr >> 0*8) & 0xFF;
+	channel->SRCADDR1 = (srcAddr >> 1*8) & 0xFF;
+	channel->SRCADDR2 = (srcAddr >> 2*8) & 0xFF;
+
+	channel->DESTADDR0 = (destAddr >> 0*8) & 0xFF;
+	channel->DESTADDR1 = (destAddr >> 1*8) & 0xFF;
+	channel->DESTADDR2 = (destAddr >> 2*8) & 0xFF;
+
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+
+
+/*! \brief Initialize a USART as SPI master.
+ *
+ *  This function sets the USART in master SPI mode with the given SCK
+ *  rate, SPI mode and data order, and enables the receiver and the
+ *  transmitter. XCK (SCK) and TXD (MOSI) are set to output, RXD (MISO) to
+ *  input. For SPI mode 2 and 3 the XCK pin is inverted, which gives the
+ *  high idle level of the clock; the pin configuration is shared with the
+ *  rest of the application, so only the invert bit is changed.
+ *
+ *  The USART pins are pin 1 to 3 of the port for USARTx0 and pin 5 to 7 for
+ *  USARTx1.
+ *
+ *  \param spi       The USART_SPI_Master_t struct instance.
+ *  \param usart     The USART.
+ *  \param port      The I/O port where the USART is connected.
+ *  \param lsbFirst  Data order will be LSB first if this is set to true.
+ *  \param mode      SPI mode (Clock polarity and phase).
+ *  \param intLevel  RXC interrupt level of interrupt-driven transfers.
+ *  \param bsel      Baud rate setting, see USART_SPI_BSEL().
+ */
+void USART_SPI_MasterInit(USART_SPI_Master_t *spi,
+                          USART_t *usart,
+                          PORT_t *port,
+                          bool lsbFirst,
+                          SPI_MODE_t mode,
+                          USART_RXCINTLVL_t intLevel,
+                          uint16_t bsel)
+{
+	/* USARTx1 is 0x10 above USARTx0 and uses the upper half of the port. */
+	uint8_t pinOffset = ( (uintptr_t) usart & 0x10 ) ? USART_SPI_PIN_OFFSET : 0;
+	register8_t *xckCtrl = &port->PIN1CTRL + pinOffset;
+
+	spi->usart         = usart;
+	spi->port          = port;
+	spi->intLevel      = intLevel;
+	spi->rxChannel     = NULL;
+	spi->txChannel     = NULL;
+	spi->dmaThreshold  = 0;
+	spi->dataPacket    = NULL;
+
+	/* XCK and TXD as output, RXD as input. */
+	port->OUTCLR = (USART_SPI_XCK0_bm | USART_SPI_TXD0_bm) << pinOffset;
+	port->DIRSET = (USART_SPI_XCK0_bm | USART_SPI_TXD0_bm) << pinOffset;
+	port->DIRCLR = USART_SPI_RXD0_bm << pinOffset;
+
+	/* Clock polarity, the CPOL bit of the SPI mode. */
+	if (mode & SPI_MODE_2_gc) {
+		*xckCtrl |= PORT_INVEN_bm;
+	} else {
+		*xckCtrl &= ~PORT_INVEN_bm;
+	}
+
+	/* SCK rate. BSCALE is not used in master SPI mode. */
+	usart->BAUDCTRLA = (uint8_t) bsel;
+	usart->BAUDCTRLB = (uint8_t) (bsel >> 8) & USART_BSEL_gm;
+
+	usart->CTRLC = USART_CMODE_MSPI_gc |                      /* Master SPI mode. */
+	               (lsbFirst ? USART_UDORD_bm : 0) |          /* Data order. */
+	               ((mode & SPI_MODE_1_gc) ? USART_UCPHA_bm : 0); /* Clock phase. */
+
+	/* Interrupts are only enabled during interrupt-driven transfers. */
+	usart->CTRLA = 0;
+	usart->CTRLB = USART_RXEN_bm | USART_TXEN_bm;
+}
+
+
+
+/*! \brief Use DMA for long packets.
+ *
+ *  Packets of at least \a dmaThreshold bytes given to
+ *  USART_SPI_MasterInterruptTransceivePacket() are then transferred by two
+ *  DMA channels, without interrupts per byte. The receiving channel must
+ *  have the higher priority, that is the lower channel number, so that a
+ *  byte is always stored before the next byte to send is written. The
+ *  transaction complete interrupt of the receiving channel must call
+ *  USART_SPI_MasterDMAHandler().
+ *
+ *  The buffers of a packet transferred by DMA must be in internal SRAM.
+ *
+ *  \param spi           The USART_SPI_Master_t struct instance.
+ *  \param rxChannel     DMA channel storing the bytes received.
+ *  \param txChannel     DMA channel writing the bytes to send.
+ *  \param rxTrigger     RXC trigger of the USART, e.g.
+ *                       DMA_CH_TRIGSRC_USARTC0_RXC_gc.
+ *  \param dmaIntLevel   Transaction complete interrupt level.
+ *  \param dmaThreshold  Shortest packet transferred by DMA.
+ */
+void USART_SPI_MasterSetDMA(USART_SPI_Master_t *spi,
+                            volatile DMA_CH_t *rxChannel,
+                            volatile DMA_CH_t *txChannel,
+                            DMA_CH_TRIGSRC_t rxTrigger,
+                            DMA_CH_TRNINTLVL_t dmaIntLevel,
+                            uint8_t dmaThreshold)
+{
+	spi->rxChannel    = rxChannel;
+	spi->txChannel    = txChannel;
+	spi->rxTrigger    = rxTrigger;
+	spi->dmaIntLevel  = dmaIntLevel;
+	spi->dmaThreshold = dmaThreshold;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+}
+
+
+
+/*! \brief USART SPI master transceive byte
+ *
+ *  This function clocks one byte out to the slave, while the byte from the
+ *  slave is clocked in. SS line(s) must be pulled low before calling this
+ *  function and released when finished.
+ *
+ *  \note This function is blocking, and must not be called while a packet
+ *        is being transferred.
+ *
+ *  \param spi        The USART_SPI_Master_t struct instance.
+ *  \param TXdata     Data to transmit to slave.
+ *
+ *  \return           Data received from slave.
+ */
+uint8_t USART_SPI_MasterTransceiveByte(USART_SPI_Master_t *spi, uint8_t TXdata)
+{
+	USART_t *usart = spi->usart;
+
+	/* Send pattern. */
+	usart->DATA = TXdata;
+
+	/* Wait for the byte from the slave. */
+	while (!(usart->STATUS & USART_RXCIF_bm)) {
+
+	}
+	return usart->DATA;
+}
+
+
+
+/*! \brief USART SPI master transceive data packet
+ *
+ *  This function transceives a number of bytes contained in a data packet
+ *  struct, polling the USART flags. The next byte is written as soon as
+ *  the transmit data register is empty, so the bytes follow each other
+ *  without gaps as long as the loop keeps up. At most two bytes are ahead
+ *  of the bytes read, so the receive buffer cannot overflow.
+ *
+ *  \param spi         The USART_SPI_Master_t struct instance.
+ *  \param dataPacket  The SPI_DataPacket_t struct instance.
+ *
+ *  \return            Whether the function was successfully completed
+ *  \retval true       Success
+ *  \retval false      Failure
+ */
+bool USART_SPI_MasterTransceivePacket(USART_SPI_Master_t *spi,
+                                      SPI_DataPacket_t *dataPacket)
+{
+	USART_t *usart = spi->usart;
+	uint8_t bytesToTransceive;
+	uint8_t bytesTransceived = 0;
+	uint8_t bytesSent = 0;
+
+	/* Check if data packet has been created. */
+	if (dataPacket == NULL) {
+		return false;
+	}
+
+	spi->dataPacket = dataPacket;
+	bytesToTransceive = dataPacket->bytesToTransceive;
+
+	/* If SS signal to slave(s). */
+	if (dataPacket->ssPort != NULL) {
+		SPI_MasterSSLow(dataPacket->ssPort, dataPacket->ssPinMask);
+	}
+
+	while (bytesTransceived < bytesToTransceive) {
+		uint8_t status = usart->STATUS;
+
+		/* Read received data. */
+		if (status & USART_RXCIF_bm) {
+			dataPacket->receiveData[bytesTransceived] = usart->DATA;
+			bytesTransceived++;
+		}
+
+		/* Keep the transmitter one byte ahead. */
+		if ((status & USART_DREIF_bm) &&
+		    (bytesSent < bytesToTransceive) &&
+		    ((uint8_t) (bytesSent - bytesTransceived) < 2)) {
+			usart->DATA = dataPacket->transmitData[bytesSent];
+			bytesSent++;
+		}
+	}
+
+	/* If SS signal to slave(s). */
+	if (dataPacket->ssPort != NULL) {
+		SPI_MasterSSHigh(dataPacket->ssPort, dataPacket->ssPinMask);
+	}
+
+	/* Set variables to indicate that transmission is complete. */
+	dataPacket->bytesTransceived = bytesTransceived;
+	dataPacket->complete = true;
+
+	/* Report success. */
+	return true;
+}
+
+
+
+/*! \brief Start interrupt-driven or DMA transmission.
+ *
+ *  This function starts a transfer of a data packet and returns. The
+ *  packet is transferred by the DMA channels if set up with
+ *  USART_SPI_MasterSetDMA() and the packet is long enough, or else by the
+ *  RXC interrupt, which must call USART_SPI_MasterInterruptHandler(). The
+ *  first two bytes fill the shift register and the transmit buffer, so the
+ *  interrupt has a whole byte time to write the next byte.
+ *
+ *  \param spi                The USART_SPI_Master_t struct instance.
+ *  \param dataPacket         The SPI_DataPacket_t struct instance.
+ *
+ *  \return                   Status code
+ *  \retval SPI_OK            The transmission was started.
+ *  \retval SPI_BUSY          The USART is busy with another packet.
+ */
+uint8_t USART_SPI_MasterInterruptTransceivePacket(USART_SPI_Master_t *spi,
+                                                  SPI_DataPacket_t *dataPacket)
+{
+	USART_t *usart = spi->usart;
+	uint8_t bytesToTransceive = dataPacket->bytesToTransceive;
+
+	/* If ongoing transmission. */
+	if ((spi->dataPacket != NULL) && (spi->dataPacket->complete == false)) {
+		return (SPI_BUSY);
+	}
+
+	spi->dataPacket = dataPacket;
+	dataPacket->complete = false;
+	dataPacket->bytesTransceived = 0;
+
+	/* SS to slave(s) low. */
+	SPI_MasterSSLow(dataPacket->ssPort, dataPacket->ssPinMask);
+
+	if ((spi->rxChannel != NULL) && (bytesToTransceive >= spi->dmaThreshold)) {
+		/* The receiving channel first, as the DRE trigger is already set. */
+		USART_SPI_DMA_Start(spi->rxChannel, spi->rxTrigger,
+		                    (uint32_t) (uintptr_t) &usart->DATA,
+		                    (uint32_t) (uintptr_t) dataPacket->receiveData,
+		                    false, bytesToTransceive, spi->dmaIntLevel);
+		USART_SPI_DMA_Start(spi->txChannel, spi->rxTrigger + 1,
+		                    (uint32_t) (uintptr_t) dataPacket->transmitData,
+		                    (uint32_t) (uintptr_t) &usart->DATA,
+		                    true, bytesToTransceive, DMA_CH_TRNINTLVL_OFF_gc);
+		return (SPI_OK);
+	}
+
+	/* Fill the shift register and the transmit buffer. */
+	usart->DATA = dataPacket->transmitData[0];
+	spi->bytesSent = 1;
+	if (bytesToTransceive > 1) {
+		usart->DATA = dataPacket->transmitData[1];
+		spi->bytesSent = 2;
+	}
+	USART_SPI_SetRxcLevel(spi, spi->intLevel);
+
+	/* Success. */
+	return (SPI_OK);
+}
+
+
+
+/*! \brief Common USART SPI master RXC interrupt service routine.
+ *
+ *  This function is called by the RXC interrupt service handler of the
+ *  USART. A byte has been received, so the transmit buffer is free again:
+ *  the received byte is stored and the next byte but one is written. After
+ *  the last byte SS is released and the RXC interrupt disabled.
+ *
+ *  \param spi        Pointer to the USART_SPI_Master_t struct.
+ */
+void USART_SPI_MasterInterruptHandler(USART_SPI_Master_t *spi)
+{
+	SPI_DataPacket_t *dataPacket = spi->dataPacket;
+	uint8_t bytesTransceived = dataPacket->bytesTransceived;
+	uint8_t bytesSent = spi->bytesSent;
+
+	/* Store received data. */
+	dataPacket->receiveData[bytesTransceived] = spi->usart->DATA;
+	bytesTransceived++;
+
+	/* If more data. */
+	if (bytesSent < dataPacket->bytesToTransceive) {
+		spi->usart->DATA = dataPacket->transmitData[bytesSent];
+		spi->bytesSent = bytesSent + 1;
+	}
+
+	/* Transmission complete. */
+	if (bytesTransceived == dataPacket->bytesToTransceive) {
+		USART_SPI_SetRxcLevel(spi, USART_RXCINTLVL_OFF_gc);
+		SPI_MasterSSHigh(dataPacket->ssPort, dataPacket->ssPinMask);
+		dataPacket->complete = true;
+	}
+
+	/* Write back bytesTransceived to data packet. */
+	dataPacket->bytesTransceived = bytesTransceived;
+}
+
+
+
+/*! \brief Common USART SPI master DMA interrupt service routine.
+ *
+ *  This function is called by the transaction complete interrupt of the
+ *  receiving DMA channel. All bytes have been received, so SS is released.
+ *  If the channel stopped on an error, bytesTransceived tells how many
+ *  bytes were received.
+ *
+ *  \param spi        Pointer to the USART_SPI_Master_t struct.
+ */
+void USART_SPI_MasterDMAHandler(USART_SPI_Master_t *spi)
+{
+	SPI_DataPacket_t *dataPacket = spi->dataPacket;
+	volatile DMA_CH_t *channel = spi->rxChannel;
+
+	if (channel->CTRLB & DMA_CH_ERRIF_bm) {
+		spi->txChannel->CTRLA &= ~DMA_CH_ENABLE_bm;
+		dataPacket->bytesTransceived = dataPacket->bytesToTransceive - channel->TRFCNT;
+	} else {
+		dataPacket->bytesTransceived = dataPacket->bytesToTransceive;
+	}
+
+	/* Clear the flags by writing one. */
+	channel->CTRLB |= DMA_CH_ERRIF_bm | DMA_CH_TRNIF_bm;
+
+	SPI_MasterSSHigh(dataPacket->ssPort, dataPacket->ssPinMask);
+	dataPacket->complete = true;
+}
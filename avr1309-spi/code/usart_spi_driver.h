@@ -0,0 +1,166 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA USART master SPI driver header file.
+ *
+ *      This file contains the function prototypes, type definitions and macros
+ *      of the driver for the USART in master SPI mode. Each USART of the device
+ *      can be set up as an SPI master, which gives up to eight SPI buses in
+ *      addition to the SPI modules. The driver has the same data packet based
+ *      interface as the SPI master driver in spi_driver.h.
+ *
+ *      Unlike the SPI module, the USART has a buffered transmit data register.
+ *      The next byte can be written while the current byte is shifted, so the
+ *      driver keeps the transmitter one byte ahead and the bytes of a packet
+ *      follow each other on the bus without gaps. Packets can be transferred
+ *      polled, by the RXC interrupt, or, from a length set with
+ *      USART_SPI_MasterSetDMA(), by two DMA channels: one triggered by the data
+ *      register empty flag writes the bytes to send, one triggered by RXC stores
+ *      the bytes received, and the transaction complete interrupt of the
+ *      receiving channel releases SS.
+ *
+ *      The SPI mode (clock polarity and phase) and the data order are set in
+ *      USART_SPI_MasterInit(). The clock phase and data order are set in CTRLC,
+ *      the clock polarity by inverting the XCK pin.
+ *
+ * \par Application note:
+ *      AVR1309: Using the XMEGA SPI
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5407 $
+ * $Date: 2011-10-12 14:53:14 +0200 (on, 12 okt 2011) $  \n
+ *
+ * Copyright (c) 2009 Atmel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef USART_SPI_DRIVER_H
+#define USART_SPI_DRIVER_H
+
+#include "avr_compiler.h"
+#include "spi_driver.h"
+
+/* Hardware defines */
+
+#ifndef USART_UDORD_bm
+#define USART_UDORD_bm        0x04 /*!< \brief Data order bit mask of CTRLC in master SPI mode. */
+#endif
+#ifndef USART_UCPHA_bm
+#define USART_UCPHA_bm        0x02 /*!< \brief Clock phase bit mask of CTRLC in master SPI mode. */
+#endif
+
+#define USART_SPI_XCK0_bm     0x02 /*!< \brief Bit mask for the XCK (SCK) pin of USARTx0. */
+#define USART_SPI_RXD0_bm     0x04 /*!< \brief Bit mask for the RXD (MISO) pin of USARTx0. */
+#define USART_SPI_TXD0_bm     0x08 /*!< \brief Bit mask for the TXD (MOSI) pin of USARTx0. */
+
+/*! \brief Pin offset of USARTx1 from USARTx0 in the port. */
+#define USART_SPI_PIN_OFFSET  4
+
+
+/*! \brief BSEL value giving at most the requested SCK rate.
+ *
+ *  In master SPI mode the SCK frequency is fPER / (2 * (BSEL + 1)), so
+ *  the fastest rate is half the peripheral clock. The macro can be
+ *  evaluated by the preprocessor.
+ *
+ *  \param _fper  Peripheral clock frequency in Hz.
+ *  \param _fsck  Highest SCK frequency wanted, in Hz.
+ */
+#define USART_SPI_BSEL(_fper, _fsck) \
+	( ( ( (_fper) + 2 * (_fsck) - 1 ) / ( 2 * (_fsck) ) ) - 1 )
+
+
+/*! \brief USART SPI master struct. Holds pointers to the USART, the DMA
+ *         channels and the packet being transferred.
+ */
+typedef struct USART_SPI_Master
+{
+	USART_t *usart;                  /*!< \brief Pointer to the USART used. */
+	PORT_t *port;                    /*!< \brief Pointer to the port of the USART pins. */
+	USART_RXCINTLVL_t intLevel;      /*!< \brief RXC interrupt level of interrupt-driven transfers. */
+	volatile DMA_CH_t *rxChannel;    /*!< \brief DMA channel storing the bytes received, NULL without DMA. */
+	volatile DMA_CH_t *txChannel;    /*!< \brief DMA channel writing the bytes to send. */
+	DMA_CH_TRIGSRC_t rxTrigger;      /*!< \brief RXC trigger of the USART, the DRE trigger follows it. */
+	DMA_CH_TRNINTLVL_t dmaIntLevel;  /*!< \brief Transaction complete interrupt level of the receiving channel. */
+	uint8_t dmaThreshold;            /*!< \brief Shortest packet transferred by DMA. */
+	volatile uint8_t bytesSent;      /*!< \brief Bytes written to DATA, interrupt-driven transfers only. */
+	SPI_DataPacket_t *dataPacket;    /*!< \brief Holds transceive data. */
+} USART_SPI_Master_t;
+
+
+/* Definitions of macros. */
+
+
+/*! \brief Checks if transmission is complete.
+ *
+ *  \param _spi     Pointer to USART_SPI_Master_t struct instance.
+ *
+ *  \return         The current status of the transmission.
+ *  \retval true    The transmission is complete.
+ *  \retval false   The transmission is in progress.
+ */
+#define USART_SPI_MasterTransmissionComplete(_spi) ( (_spi)->dataPacket->complete )
+
+
+/* Prototype functions. Documentation found in source file */
+
+void USART_SPI_MasterInit(USART_SPI_Master_t *spi,
+                          USART_t *usart,
+                          PORT_t *port,
+                          bool lsbFirst,
+                          SPI_MODE_t mode,
+                          USART_RXCINTLVL_t intLevel,
+                          uint16_t bsel);
+
+void USART_SPI_MasterSetDMA(USART_SPI_Master_t *spi,
+                            volatile DMA_CH_t *rxChannel,
+                            volatile DMA_CH_t *txChannel,
+                            DMA_CH_TRIGSRC_t rxTrigger,
+                            DMA_CH_TRNINTLVL_t dmaIntLevel,
+                            uint8_t dmaThreshold);
+
+uint8_t USART_SPI_MasterTransceiveByte(USART_SPI_Master_t *spi, uint8_t TXdata);
+
+bool USART_SPI_MasterTransceivePacket(USART_SPI_Master_t *spi,
+                                      SPI_DataPacket_t *dataPacket);
+
+uint8_t USART_SPI_MasterInterruptTransceivePacket(USART_SPI_Master_t *spi,
+                                                  SPI_DataPacket_t *dataPacket);
+
+void USART_SPI_MasterInterruptHandler(USART_SPI_Master_t *spi);
+
+void USART_SPI_MasterDMAHandler(USART_SPI_Master_t *spi);
+
+#endif
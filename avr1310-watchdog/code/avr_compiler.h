@@ -122,6 +122,9 @@
 #define PGM_READ_BYTE(x) *(x)
 #define PGM_READ_WORD(x) *(x)
 
+/*! \brief Place a variable in RAM that is not initialized at startup. */
+#define NO_INIT __no_init
+
 #define SHORTENUM /**/
 
 #elif defined( __GNUC__ )
@@ -129,6 +132,7 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
+#include <avr/wdt.h>
 #include <util/delay.h>
 
 /*! \brief Define the delay_us macro for GCC. */
@@ -139,6 +143,9 @@
 /*! \brief Define the no operation macro. */
 #define nop()   do { __asm__ __volatile__ ("nop"); } while (0)
 
+/*! \brief Define the watchdog reset macro. */
+#define watchdog_reset( ) (wdt_reset( ))
+
 #define MAIN_TASK_PROLOGUE int
 
 
@@ -146,6 +153,9 @@
 
 #define SHORTENUM __attribute__ ((packed))
 
+/*! \brief Place a variable in RAM that is not initialized at startup. */
+#define NO_INIT __attribute__ ((section (".noinit")))
+
 #else
 #error Compiler not supported.
 #endif
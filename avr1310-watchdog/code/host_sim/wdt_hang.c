@@ -0,0 +1,465 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host hang injection test of the Watchdog supervisor.
+ *
+ *      This program runs the supervised application of wdt_supervisor_example.c
+ *      on the host simulator, with the Watchdog Timer in window mode and the reset
+ *      controller modelled, and injects faults. A Watchdog reset restarts the
+ *      application from a reset handler; the post-mortem record, like the RAM of
+ *      the device, keeps its contents, and is filled with random data before each
+ *      power-on. TCC1 is not modelled, so TCD0 runs the interrupt task.
+ *
+ *      Scenarios:
+ *        - healthy: no fault, at Watchdog oscillator frequencies of 70%, 100% and
+ *          130% of nominal. The kicks must stay in the open window, without reset.
+ *        - main_hang: the main loop hangs (PF0 low) after a while, at the same
+ *          frequencies. The reset must come within the task deadline, one tick
+ *          and the longest Watchdog period, and report the main task.
+ *        - timer_hang: the interrupt task stops checking in (PF1 low).
+ *        - repeat_hang: two hangs in a row must give reset counts 1 and 2; an
+ *          external reset must end the sequence, so the next hang counts 1 again.
+ *        - tick_stop: the supervisor tick interrupt is disabled. The Watchdog
+ *          resets the device without a task recorded, reported as unknown.
+ *        - early_kick: the supervisor kicks inside the closed window, which the
+ *          Watchdog must punish with a reset, reported as unknown.
+ *        - register: registration beyond WDTS_MAX_TASKS must return
+ *          WDTS_TASK_INVALID, distinct from the post-mortem results.
+ *
+ *      Each scenario prints one line of space separated key=value pairs: the
+ *      post-mortem result and reset count of each boot, and the time from each
+ *      hang to the reset with its bound. The program exits with a non-zero status
+ *      if a check fails.
+ *
+ *      Build and run from the directory holding wdt_supervisor.c. The simulator
+ *      is shared with AVR1307:
+ *        gcc -std=gnu99 -O2 -no-pie -Wno-attributes -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/wdt_hang.c wdt_supervisor.c wdt_driver.c -o wdt_hang
+ *        ./wdt_hang
+ *
+ * \par Application note:
+ *      AVR1310: Using the XMEGA Watchdog
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2303 $
+ * $Date: 2009-04-16 14:47:58 +0200 (to, 16 apr 2009) $  \n
+ *
+ * Copyright (c) 2009, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "wdt_supervisor.h"
+#include "sim.h"
+
+/*! CPU cycles per millisecond. */
+#define CYCLES_PER_MS     ( F_CPU / 1000UL )
+
+/*! \brief Supervisor tick period in Timer/Counter clock cycles (8 ms). */
+#define TICK_PERIOD       ( F_CPU / 1000 * 8 / 64 )
+
+/*! Supervisor tick period in CPU cycles. */
+#define TICK_CYCLES       ( TICK_PERIOD * 64 )
+
+/*! \brief Supervisor ticks between Watchdog resets (96 ms). */
+#define KICK_TICKS        12
+
+/*! \brief Kick interval of the early kick fault, inside the closed window. */
+#define EARLY_KICK_TICKS  4
+
+/*! \brief Deadline of the main loop task (40 ms). */
+#define MAIN_DEADLINE     5
+
+/*! \brief Deadline of the interrupt task (80 ms). */
+#define TIMER_DEADLINE    10
+
+/*! Watchdog timeout and closed window, in Watchdog clock cycles. */
+#define WDT_TIMEOUT_CLOCKS  128
+#define WDT_WINDOW_CLOCKS   64
+
+/*! Main loop period. */
+#define LOOP_US           10000
+
+/*! Largest number of boots recorded per scenario. */
+#define MAX_BOOTS         8
+
+/*! Expected post-mortem result of a boot without a reset count. */
+#define ANY_COUNT         0
+
+
+/*! \brief Fault injected after a boot. */
+typedef enum Fault_enum {
+	FAULT_NONE,        /*!< The application runs normally. */
+	FAULT_MAIN_HANG,   /*!< The main loop hangs, PF0 low. */
+	FAULT_TIMER_HANG,  /*!< The interrupt task stops checking in, PF1 low. */
+	FAULT_TICK_STOP,   /*!< The supervisor tick interrupt is disabled. */
+	FAULT_EARLY_KICK,  /*!< The supervisor kicks inside the closed window. */
+	FAULT_EXT_RESET,   /*!< External reset, ends a sequence of resets. */
+} Fault_t;
+
+/*! \brief Fault of one boot and the post-mortem result expected at the boot. */
+typedef struct Boot_struct {
+	/*! Fault injected after this boot. */
+	Fault_t fault;
+	/*! Time of the fault after the boot, in milliseconds. */
+	uint16_t faultMs;
+	/*! Result of WDTS_GetResetTask() expected at this boot. */
+	uint8_t expectedTask;
+	/*! Consecutive reset count expected at this boot, or ANY_COUNT. */
+	uint8_t expectedCount;
+} Boot_t;
+
+/*! \brief Test scenario. */
+typedef struct Scenario_struct {
+	/*! Name of the scenario. */
+	const char * name;
+	/*! Watchdog oscillator frequency, in permille of the nominal 1 kHz. */
+	uint16_t clockPermille;
+	/*! Run time from power-on, in milliseconds. */
+	uint16_t durationMs;
+	/*! Boots expected, the first from power-on. */
+	uint8_t bootCount;
+	Boot_t boots[MAX_BOOTS];
+} Scenario_t;
+
+/*! \brief What happened at one boot. */
+typedef struct BootLog_struct {
+	/*! Time of the boot. */
+	uint64_t cycles;
+	/*! Result of WDTS_GetResetTask(). */
+	uint8_t task;
+	/*! Consecutive reset count of the post-mortem record. */
+	uint8_t resetCount;
+} BootLog_t;
+
+
+static const Scenario_t scenarios[] = {
+	{ "healthy",      700, 3000, 1, { { FAULT_NONE, 0, WDTS_TASK_NONE, ANY_COUNT } } },
+	{ "healthy",     1000, 3000, 1, { { FAULT_NONE, 0, WDTS_TASK_NONE, ANY_COUNT } } },
+	{ "healthy",     1300, 3000, 1, { { FAULT_NONE, 0, WDTS_TASK_NONE, ANY_COUNT } } },
+	{ "main_hang",    700, 2000, 2, { { FAULT_MAIN_HANG, 500, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, 0, 1 } } },
+	{ "main_hang",   1000, 2000, 2, { { FAULT_MAIN_HANG, 500, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, 0, 1 } } },
+	{ "main_hang",   1300, 2000, 2, { { FAULT_MAIN_HANG, 500, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, 0, 1 } } },
+	{ "timer_hang",  1000, 2000, 2, { { FAULT_TIMER_HANG, 500, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, 1, 1 } } },
+	{ "repeat_hang", 1000, 4000, 5, { { FAULT_MAIN_HANG, 300, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_TIMER_HANG, 300, 0, 1 },
+	                                  { FAULT_EXT_RESET, 300, 1, 2 },
+	                                  { FAULT_MAIN_HANG, 300, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, 0, 1 } } },
+	{ "tick_stop",   1000, 2000, 2, { { FAULT_TICK_STOP, 500, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, WDTS_TASK_UNKNOWN, ANY_COUNT } } },
+	{ "early_kick",  1000, 2000, 2, { { FAULT_EARLY_KICK, 0, WDTS_TASK_NONE, ANY_COUNT },
+	                                  { FAULT_NONE, 0, WDTS_TASK_UNKNOWN, ANY_COUNT } } },
+};
+
+/*! Post-mortem record in wdt_supervisor.c, filled at power-on here. */
+extern WDTS_PostMortem_t WDTS_postMortem;
+
+/*! \brief The Watchdog supervisor. */
+WDTS_Supervisor_t supervisor;
+
+/*! \brief Task identifiers. */
+uint8_t mainTask;
+uint8_t timerTask;
+
+/*! Restart point of the reset handler. */
+static sigjmp_buf bootPoint;
+
+/*! Scenario being run, its end and the boots so far. The harness keeps
+ *  these over the simulated resets. */
+static const Scenario_t * scenario;
+static uint64_t scenarioEnd;
+static BootLog_t bootLog[MAX_BOOTS];
+static uint8_t bootCount;
+
+/*! Time the fault of each boot was injected, 0 if it was not. */
+static uint64_t faultCycles[MAX_BOOTS];
+
+/*! State of the random sequence filling the RAM at power-on. */
+static uint32_t randomSeed = 1;
+
+
+/*! \brief Reset handler: restart the application. */
+static void Harness_Reset(void)
+{
+	siglongjmp(bootPoint, 1);
+}
+
+
+/*! \brief Name of a post-mortem result, the task number otherwise. */
+static const char * Task_Name(uint8_t task, char * buffer)
+{
+	switch (task) {
+	case WDTS_TASK_NONE:    return "none";
+	case WDTS_TASK_UNKNOWN: return "unknown";
+	case WDTS_TASK_INVALID: return "invalid";
+	default:
+		sprintf(buffer, "%u", task);
+		return buffer;
+	}
+}
+
+
+/*! \brief Inject the fault of a boot. */
+static void Fault_Inject(Fault_t fault)
+{
+	switch (fault) {
+	case FAULT_MAIN_HANG:
+		SIM_PORT_SetInput(&PORTF, PIN1_bm);
+		break;
+	case FAULT_TIMER_HANG:
+		SIM_PORT_SetInput(&PORTF, PIN0_bm);
+		break;
+	case FAULT_TICK_STOP:
+		TCC0.INTCTRLA = TC_OVFINTLVL_OFF_gc;
+		break;
+	case FAULT_EXT_RESET:
+		SIM_Reset(RST_EXTRF_bm);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/*! \brief The application, as wdt_supervisor_example.c, with the fault of
+ *         the boot injected. Returns at the end of the scenario.
+ */
+static void App_Main(void)
+{
+	const Boot_t * boot = &scenario->boots[(bootCount < scenario->bootCount) ?
+	                                       bootCount : (scenario->bootCount - 1)];
+	BootLog_t * log = &bootLog[bootCount];
+	WDTS_PostMortem_t record;
+	uint64_t faultAt;
+
+	log->cycles = SIM_GetCycles();
+	log->task = WDTS_GetResetTask( &record );
+	log->resetCount = (log->task < WDTS_MAX_TASKS) ? record.resetCount : 0;
+	faultAt = log->cycles + (uint64_t) boot->faultMs * CYCLES_PER_MS;
+	if (++bootCount == MAX_BOOTS) {
+		/* Reset loop, give up. */
+		return;
+	}
+
+	/* Cleared by the C startup code, unlike the post-mortem record. */
+	memset(&supervisor, 0, sizeof(supervisor));
+
+	/* The pull-ups hold the hang inputs high, the faults are transient. */
+	SIM_PORT_SetInput(&PORTF, PIN1_bm | PIN0_bm);
+	PORTF.PIN0CTRL = PORT_OPC_PULLUP_gc;
+	PORTF.PIN1CTRL = PORT_OPC_PULLUP_gc;
+
+	WDTS_Init( &supervisor, (boot->fault == FAULT_EARLY_KICK) ? EARLY_KICK_TICKS : KICK_TICKS );
+	mainTask = WDTS_RegisterTask( &supervisor, MAIN_DEADLINE );
+	timerTask = WDTS_RegisterTask( &supervisor, TIMER_DEADLINE );
+
+	WDT_EnableAndSetTimeout( WDT_PER_128CLK_gc );
+	WDT_EnableWindowModeAndSetTimeout( WDT_WPER_64CLK_gc );
+
+	TCC0.PER = TICK_PERIOD - 1;
+	TCC0.INTCTRLA = TC_OVFINTLVL_HI_gc;
+	/* TCC1 is not modelled, TCD0 runs the interrupt task. */
+	TCD0.PER = TICK_PERIOD - 1;
+	TCD0.INTCTRLA = TC_OVFINTLVL_LO_gc;
+	TCC0.CTRLA = TC_CLKSEL_DIV64_gc;
+	TCD0.CTRLA = TC_CLKSEL_DIV64_gc;
+
+	PMIC.CTRL |= PMIC_HILVLEN_bm | PMIC_LOLVLEN_bm;
+	sei();
+
+	while (SIM_GetCycles() < scenarioEnd) {
+		if ((faultCycles[bootCount - 1] == 0) && (boot->fault != FAULT_NONE) &&
+		    (SIM_GetCycles() >= faultAt)) {
+			faultCycles[bootCount - 1] = SIM_GetCycles();
+			Fault_Inject(boot->fault);
+		}
+
+		/* Simulate a hang of the main loop. */
+		while ((PORTF.IN & PIN0_bm) == 0) {
+		}
+
+		WDTS_CheckIn( &supervisor, mainTask );
+
+		delay_us( LOOP_US );
+	}
+}
+
+
+/*! \brief Supervisor tick. */
+ISR(TCC0_OVF_vect)
+{
+	WDTS_Tick( &supervisor );
+}
+
+
+/*! \brief Interrupt task. Stops checking in while PF1 is low. */
+ISR(TCD0_OVF_vect)
+{
+	if (PORTF.IN & PIN1_bm) {
+		WDTS_CheckIn( &supervisor, timerTask );
+	}
+}
+
+
+/*! \brief Run a scenario from power-on.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool Scenario_Run(const Scenario_t * sc)
+{
+	uint32_t wdtCycles = (uint32_t) ((uint64_t) F_CPU * 1000 / 1000 / sc->clockPermille);
+	uint64_t watchdogCycles = (uint64_t) (WDT_TIMEOUT_CLOCKS + WDT_WINDOW_CLOCKS) * wdtCycles;
+	uint8_t * ram = (uint8_t *) &WDTS_postMortem;
+	bool success;
+	char buffer[4];
+	uint8_t i;
+
+	scenario = sc;
+	bootCount = 0;
+	memset(faultCycles, 0, sizeof(faultCycles));
+	SIM_WDT_SetClock(wdtCycles);
+
+	/* The RAM holds random data at power-on. */
+	for (i = 0; i < sizeof(WDTS_postMortem); i++) {
+		randomSeed = randomSeed * 1103515245UL + 12345UL;
+		ram[i] = (uint8_t) (randomSeed >> 16);
+	}
+	RST.STATUS = 0xFF;
+
+	SIM_SetResetHandler(Harness_Reset);
+	if (sigsetjmp(bootPoint, 1) == 0) {
+		scenarioEnd = SIM_GetCycles() + (uint64_t) sc->durationMs * CYCLES_PER_MS;
+		SIM_Reset(RST_PORF_bm);
+	}
+	App_Main();
+	SIM_SetResetHandler(NULL);
+
+	/* Stop the application before the next scenario. */
+	cli();
+	TCC0.CTRLA = TC_CLKSEL_OFF_gc;
+	TCD0.CTRLA = TC_CLKSEL_OFF_gc;
+	WDT_DisableWindowMode();
+	WDT_Disable();
+
+	success = (bootCount == sc->bootCount);
+	printf("scenario=%s wdt_clock_permille=%u boots=%u tasks=",
+	       sc->name, sc->clockPermille, bootCount);
+	for (i = 0; i < bootCount; i++) {
+		const Boot_t * expected = &sc->boots[(i < sc->bootCount) ? i : (sc->bootCount - 1)];
+
+		printf("%s%s", (i == 0) ? "" : ",", Task_Name(bootLog[i].task, buffer));
+		if ((i < sc->bootCount) &&
+		    ((bootLog[i].task != expected->expectedTask) ||
+		     ((expected->expectedCount != ANY_COUNT) &&
+		      (bootLog[i].resetCount != expected->expectedCount)))) {
+			success = false;
+		}
+	}
+	printf(" reset_counts=");
+	for (i = 0; i < bootCount; i++) {
+		printf("%s%u", (i == 0) ? "" : ",", bootLog[i].resetCount);
+	}
+
+	/* Time from each hang to the reset, against the deadline of the task,
+	 * the supervisor tick and the longest time the Watchdog can run after
+	 * the last kick. */
+	for (i = 0; i + 1 < bootCount; i++) {
+		Fault_t fault = sc->boots[i].fault;
+		uint8_t deadline = (fault == FAULT_MAIN_HANG) ? MAIN_DEADLINE : TIMER_DEADLINE;
+		uint64_t bound = (uint64_t) (deadline + 1) * TICK_CYCLES + watchdogCycles;
+		uint64_t latency = bootLog[i + 1].cycles - faultCycles[i];
+
+		if ((fault != FAULT_MAIN_HANG) && (fault != FAULT_TIMER_HANG)) {
+			continue;
+		}
+		printf(" reset_ms_%u=%.1f bound_ms_%u=%.1f", i + 1,
+		       (double) latency / CYCLES_PER_MS, i + 1, (double) bound / CYCLES_PER_MS);
+		if ((faultCycles[i] == 0) || (latency > bound)) {
+			success = false;
+		}
+	}
+	printf(" tick_isr=%lu result=%s\n",
+	       (unsigned long) SIM_GetIrqStats(TCC0_OVF_vect_num)->count,
+	       success ? "pass" : "fail");
+	SIM_ClearStats();
+	return success;
+}
+
+
+/*! \brief Task registration beyond WDTS_MAX_TASKS.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool Register_Run(void)
+{
+	uint8_t tasks = 0;
+	uint8_t last;
+	bool success;
+	char buffer[4];
+
+	WDTS_Init( &supervisor, KICK_TICKS );
+	while ((last = WDTS_RegisterTask( &supervisor, MAIN_DEADLINE )) < WDTS_MAX_TASKS) {
+		tasks++;
+	}
+	success = (tasks == WDTS_MAX_TASKS) && (last == WDTS_TASK_INVALID) &&
+	          (last != WDTS_TASK_NONE) && (last != WDTS_TASK_UNKNOWN) &&
+	          !WDTS_IsStarving( &supervisor );
+	printf("scenario=register tasks=%u overflow=%s result=%s\n",
+	       tasks, Task_Name(last, buffer), success ? "pass" : "fail");
+	return success;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+		success &= Scenario_Run(&scenarios[i]);
+	}
+	success &= Register_Run();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
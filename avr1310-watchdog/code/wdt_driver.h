@@ -69,7 +69,7 @@
 #define WDT_IsSyncBusy() ( WDT.STATUS & WDT_SYNCBUSY_bm )
 
 /*! \brief This macro resets the Watchdog Timer. */
-#define WDT_Reset()	asm("wdr") //( watchdog_reset( ) )
+#define WDT_Reset()	( watchdog_reset( ) )
 
 
 /* Prototypes of funtions. */
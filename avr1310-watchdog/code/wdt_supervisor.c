@@ -0,0 +1,196 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Watchdog supervisor source file.
+ *
+ *      This file contains the function implementations of the Watchdog
+ *      supervisor.
+ *
+ * \par Application note:
+ *      AVR1310: Using the XMEGA Watchdog
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2303 $
+ * $Date: 2009-04-16 14:47:58 +0200 (to, 16 apr 2009) $  \n
+ *
+ * Copyright (c) 2009, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "wdt_supervisor.h"
+
+
+/*! \brief Post-mortem record. Not initialized at startup, so it survives
+ *         the Watchdog reset.
+ */
+NO_INIT WDTS_PostMortem_t WDTS_postMortem;
+
+
+
+/*! \brief Get the task that caused the last reset.
+ *
+ *  This function must be called once after reset, before WDTS_Init(). It
+ *  reads and clears the Watchdog reset flag and consumes the post-mortem
+ *  record.
+ *
+ *  \param  record  Pointer to where a copy of the post-mortem record is
+ *                  stored, or NULL. The copy is only valid if a task
+ *                  identifier is returned.
+ *
+ *  \return  Identifier of the task that missed its deadline,
+ *           WDTS_TASK_UNKNOWN if the Watchdog reset was not caused by a
+ *           task, or WDTS_TASK_NONE if the last reset was not a Watchdog
+ *           reset.
+ */
+uint8_t WDTS_GetResetTask( WDTS_PostMortem_t * record )
+{
+	uint8_t task = WDTS_TASK_NONE;
+
+	if (RST.STATUS & RST_WDRF_bm) {
+		RST.STATUS = RST_WDRF_bm;
+
+		if ((WDTS_postMortem.magic == WDTS_POSTMORTEM_MAGIC) &&
+		    ((uint8_t) (WDTS_postMortem.task ^ WDTS_postMortem.taskInverted) == 0xFF)) {
+			task = WDTS_postMortem.task;
+			if (record != NULL) {
+				*record = WDTS_postMortem;
+			}
+
+			/* Consume the task, but keep counting consecutive resets. */
+			WDTS_postMortem.taskInverted = WDTS_postMortem.task;
+		} else {
+			task = WDTS_TASK_UNKNOWN;
+		}
+	} else {
+		/* Any other reset ends the sequence of supervisor resets. */
+		WDTS_postMortem.magic = 0;
+	}
+
+	return task;
+}
+
+
+
+/*! \brief Initialize the Watchdog supervisor.
+ *
+ *  The Watchdog must be enabled by fuses or by the Watchdog driver. The
+ *  supervisor resets the Watchdog every \c kickTicks calls to WDTS_Tick().
+ *  The kick interval must be longer than the closed window period if
+ *  window mode is used, and shorter than the Watchdog timeout period, both
+ *  with a margin for the Watchdog oscillator tolerance (see the
+ *  application note).
+ *
+ *  \param  sup        Pointer to the supervisor.
+ *  \param  kickTicks  Supervisor ticks between Watchdog resets.
+ */
+void WDTS_Init( WDTS_Supervisor_t * sup, uint8_t kickTicks )
+{
+	sup->taskCount = 0;
+	sup->kickTicks = kickTicks;
+	sup->ticksSinceKick = 0;
+	sup->starvingTask = WDTS_TASK_NONE;
+}
+
+
+
+/*! \brief Register a task to supervise.
+ *
+ *  The deadline is checked with a resolution of one supervisor tick, so it
+ *  should be one tick longer than the longest time allowed between two
+ *  check-ins. The task is considered checked in when registered.
+ *
+ *  \param  sup            Pointer to the supervisor.
+ *  \param  deadlineTicks  Deadline in supervisor ticks, 1 to 255.
+ *
+ *  \return  Task identifier to use with WDTS_CheckIn(), or
+ *           WDTS_TASK_INVALID if all task slots are in use.
+ */
+uint8_t WDTS_RegisterTask( WDTS_Supervisor_t * sup, uint8_t deadlineTicks )
+{
+	uint8_t task = sup->taskCount;
+
+	if (task >= WDTS_MAX_TASKS) {
+		return WDTS_TASK_INVALID;
+	}
+
+	sup->deadline[task] = deadlineTicks;
+	sup->remaining[task] = deadlineTicks;
+
+	/* Make the task visible to WDTS_Tick() when fully set up. */
+	sup->taskCount = task + 1;
+
+	return task;
+}
+
+
+
+/*! \brief Supervisor tick.
+ *
+ *  This function must be called periodically, typically from a timer
+ *  interrupt. It counts down the deadline of every task and resets the
+ *  Watchdog every \c kickTicks ticks while all tasks are healthy.
+ *
+ *  When a task misses its deadline, the task is recorded in the post-mortem
+ *  record and the Watchdog is no longer reset, so the device is reset when
+ *  the Watchdog times out.
+ *
+ *  \param  sup  Pointer to the supervisor.
+ */
+void WDTS_Tick( WDTS_Supervisor_t * sup )
+{
+	uint8_t task;
+
+	if (sup->starvingTask != WDTS_TASK_NONE) {
+		return;
+	}
+
+	for (task = 0; task < sup->taskCount; ++task) {
+		if (--sup->remaining[task] == 0) {
+			if (WDTS_postMortem.magic == WDTS_POSTMORTEM_MAGIC) {
+				++WDTS_postMortem.resetCount;
+			} else {
+				WDTS_postMortem.magic = WDTS_POSTMORTEM_MAGIC;
+				WDTS_postMortem.resetCount = 1;
+			}
+			WDTS_postMortem.task = task;
+			WDTS_postMortem.taskInverted = ~task;
+
+			sup->starvingTask = task;
+			return;
+		}
+	}
+
+	if (++sup->ticksSinceKick >= sup->kickTicks) {
+		sup->ticksSinceKick = 0;
+		WDT_Reset();
+	}
+}
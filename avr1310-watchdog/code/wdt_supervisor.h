@@ -0,0 +1,141 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Watchdog supervisor header file.
+ *
+ *      This file contains the function prototypes, macros and type definitions
+ *      for the Watchdog supervisor. The supervisor extends the Watchdog driver
+ *      with per-task monitoring: each registered task must check in within its
+ *      own deadline, and the hardware Watchdog is only reset while all tasks are
+ *      healthy. The identity of a task that missed its deadline is kept in a RAM
+ *      section that is not initialized at startup, so it can be read after the
+ *      Watchdog reset.
+ *
+ * \par Application note:
+ *      AVR1310: Using the XMEGA Watchdog
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2303 $
+ * $Date: 2009-04-16 14:47:58 +0200 (to, 16 apr 2009) $  \n
+ *
+ * Copyright (c) 2009, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef WDT_SUPERVISOR_H
+#define WDT_SUPERVISOR_H
+
+#include "avr_compiler.h"
+#include "wdt_driver.h"
+
+
+/* Definition of macros */
+
+/*! \brief Maximum number of supervised tasks. */
+#define WDTS_MAX_TASKS       8
+
+/*! \brief Post-mortem result: the last reset was not a Watchdog reset.
+ *         Also the value of WDTS_Supervisor_t::starvingTask while all tasks
+ *         are healthy.
+ */
+#define WDTS_TASK_NONE       0xFF
+
+/*! \brief Post-mortem result: Watchdog reset without a starving task
+ *         recorded, i.e. the supervisor tick itself stopped.
+ */
+#define WDTS_TASK_UNKNOWN    0xFE
+
+/*! \brief Task identifier returned when no more tasks can be registered. */
+#define WDTS_TASK_INVALID    0xFD
+
+/*! \brief Marker identifying a valid post-mortem record. */
+#define WDTS_POSTMORTEM_MAGIC  0xA55A
+
+/*! \brief Check in a task.
+ *
+ *  This macro restarts the deadline of a task and must be called by the
+ *  task at least once per deadline. It compiles to a load and a store of
+ *  one byte each. Tasks checking in from interrupt handlers must not run
+ *  at a higher interrupt level than WDTS_Tick(), or a check-in coinciding
+ *  with the tick may be lost.
+ *
+ *  \param _sup   Pointer to the supervisor.
+ *  \param _task  Task identifier returned by WDTS_RegisterTask().
+ */
+#define WDTS_CheckIn( _sup, _task ) \
+        ( (_sup)->remaining[_task] = (_sup)->deadline[_task] )
+
+/*! \brief Check if a task has missed its deadline.
+ *
+ *  \param _sup  Pointer to the supervisor.
+ */
+#define WDTS_IsStarving( _sup )   ( (_sup)->starvingTask != WDTS_TASK_NONE )
+
+
+/*! \brief Post-mortem record kept over a reset. */
+typedef struct WDTS_PostMortem_struct {
+	/*! WDTS_POSTMORTEM_MAGIC when the record is valid. */
+	uint16_t magic;
+	/*! Identifier of the task that missed its deadline. */
+	uint8_t task;
+	/*! Inverted task identifier, used to validate the record. */
+	uint8_t taskInverted;
+	/*! Number of consecutive resets caused by the supervisor. */
+	uint8_t resetCount;
+} WDTS_PostMortem_t;
+
+
+/*! \brief Watchdog supervisor instance. */
+typedef struct WDTS_Supervisor_struct {
+	/*! Number of registered tasks. */
+	uint8_t taskCount;
+	/*! Deadline of each task, in supervisor ticks. */
+	uint8_t deadline[WDTS_MAX_TASKS];
+	/*! Ticks left until each task must check in again. */
+	volatile uint8_t remaining[WDTS_MAX_TASKS];
+	/*! Supervisor ticks between Watchdog resets. */
+	uint8_t kickTicks;
+	/*! Supervisor ticks since the last Watchdog reset. */
+	uint8_t ticksSinceKick;
+	/*! First task that missed its deadline, or WDTS_TASK_NONE. */
+	volatile uint8_t starvingTask;
+} WDTS_Supervisor_t;
+
+
+/* Prototypes of functions. */
+
+uint8_t WDTS_GetResetTask( WDTS_PostMortem_t * record );
+void WDTS_Init( WDTS_Supervisor_t * sup, uint8_t kickTicks );
+uint8_t WDTS_RegisterTask( WDTS_Supervisor_t * sup, uint8_t deadlineTicks );
+void WDTS_Tick( WDTS_Supervisor_t * sup );
+
+#endif
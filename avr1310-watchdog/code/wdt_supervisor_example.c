@@ -0,0 +1,148 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA Watchdog supervisor example source.
+ *
+ *      This file contains an example application that demonstrates the Watchdog
+ *      supervisor. Two tasks are supervised: the main loop and a Timer/Counter
+ *      interrupt. The supervisor tick runs from the TCC0 overflow interrupt
+ *      every 8 ms, and the Watchdog is run in window mode.
+ *
+ *      Pulling PF0 low hangs the main loop, and pulling PF1 low stops the
+ *      interrupt task. The supervisor then stops resetting the Watchdog, and
+ *      after the Watchdog reset the starving task is shown on PORTD.
+ *
+ * \par Application note:
+ *      AVR1310: Using the XMEGA Watchdog
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2303 $
+ * $Date: 2009-04-16 14:47:58 +0200 (to, 16 apr 2009) $  \n
+ *
+ * Copyright (c) 2009, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+/*! \brief System clock used when running the code example. */
+#define F_CPU (2000000UL)
+
+#include "avr_compiler.h"
+#include "wdt_supervisor.h"
+
+/*! \brief Supervisor tick period in Timer/Counter clock cycles (8 ms). */
+#define TICK_PERIOD       ( F_CPU / 1000 * 8 / 64 )
+
+/*! \brief Supervisor ticks between Watchdog resets (96 ms). With the 64 ms
+ *         closed window and 128 ms timeout this is inside the open window
+ *         with margin for the Watchdog oscillator tolerance.
+ */
+#define KICK_TICKS        12
+
+/*! \brief Deadline of the main loop task (40 ms). */
+#define MAIN_DEADLINE     5
+
+/*! \brief Deadline of the interrupt task (80 ms). */
+#define TIMER_DEADLINE    10
+
+/*! \brief The Watchdog supervisor. */
+WDTS_Supervisor_t supervisor;
+
+/*! \brief Task identifiers. */
+uint8_t mainTask;
+uint8_t timerTask;
+
+
+int main( void )
+{
+	uint8_t resetTask;
+	WDTS_PostMortem_t record;
+
+	/* Show the post-mortem result on PORTD: task identifier and the number
+	 * of consecutive supervisor resets, all high if there was none. */
+	PORTD.DIRSET = 0xFF;
+	resetTask = WDTS_GetResetTask( &record );
+	if (resetTask < WDTS_MAX_TASKS) {
+		PORTD.OUT = (uint8_t) ~( ( record.resetCount << 4 ) | resetTask );
+	} else {
+		PORTD.OUT = resetTask;
+	}
+
+	/* Enable pull-ups on the hang inputs. */
+	PORTF.PIN0CTRL = PORT_OPC_PULLUP_gc;
+	PORTF.PIN1CTRL = PORT_OPC_PULLUP_gc;
+
+	/* Register the tasks before the supervisor tick starts. */
+	WDTS_Init( &supervisor, KICK_TICKS );
+	mainTask = WDTS_RegisterTask( &supervisor, MAIN_DEADLINE );
+	timerTask = WDTS_RegisterTask( &supervisor, TIMER_DEADLINE );
+
+	/* Enable the Watchdog with 128 ms timeout and 64 ms closed window. */
+	WDT_EnableAndSetTimeout( WDT_PER_128CLK_gc );
+	WDT_EnableWindowModeAndSetTimeout( WDT_WPER_64CLK_gc );
+
+	/* Supervisor tick at high level, the interrupt task at low level. */
+	TCC0.PER = TICK_PERIOD - 1;
+	TCC0.INTCTRLA = TC_OVFINTLVL_HI_gc;
+	TCC1.PER = TICK_PERIOD - 1;
+	TCC1.INTCTRLA = TC_OVFINTLVL_LO_gc;
+	TCC0.CTRLA = TC_CLKSEL_DIV64_gc;
+	TCC1.CTRLA = TC_CLKSEL_DIV64_gc;
+
+	PMIC.CTRL |= PMIC_HILVLEN_bm | PMIC_LOLVLEN_bm;
+	sei();
+
+	while (true) {
+		/* Simulate a hang of the main loop. */
+		while ((PORTF.IN & PIN0_bm) == 0) {
+		}
+
+		WDTS_CheckIn( &supervisor, mainTask );
+
+		delay_us( 10000 );
+	}
+}
+
+
+/*! \brief Supervisor tick. */
+ISR(TCC0_OVF_vect)
+{
+	WDTS_Tick( &supervisor );
+}
+
+
+/*! \brief Interrupt task. Stops checking in while PF1 is low. */
+ISR(TCC1_OVF_vect)
+{
+	if (PORTF.IN & PIN1_bm) {
+		WDTS_CheckIn( &supervisor, timerTask );
+	}
+}
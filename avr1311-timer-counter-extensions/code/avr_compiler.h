@@ -144,6 +144,10 @@
 
 #define MAIN_TASK_EPILOGUE() return -1;
 
+#define FLASH_DECLARE(x) x __attribute__((__progmem__))
+#define PGM_READ_BYTE(x) pgm_read_byte(x)
+#define PGM_READ_WORD(x) pgm_read_word(x)
+
 #define SHORTENUM __attribute__ ((packed))
 
 #else
@@ -16,6 +16,12 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section hostsim Host Simulation
+ * The 3-phase waveform generator can also be built for a Linux x86-64 host,
+ * using the register headers and the simulator in the host_sim directory of
+ * AVR1307. See host_sim/mc_waveform_sim.c for the dead-time, compare range
+ * and update timing checks, and sim.h for what is modelled. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
@@ -0,0 +1,498 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host dead-time and update timing test of the 3-phase waveform generator.
+ *
+ *      This program runs the waveform generator in mc_waveform_driver.c on the
+ *      host simulator and checks the invariants the driver is built around: the
+ *      complementary outputs keep the dead time, no pulse is swallowed by the
+ *      dead-time insertion, the compare values stay within the allowed range,
+ *      and each update is written before the update condition that latches it.
+ *
+ *      Scenarios, each run for PERIODS PWM periods with a phase step of 256:
+ *        - isr_sine: period 800, sine mode, updates in the overflow interrupt.
+ *        - isr_svpwm_load: period 1600, space-vector mode at the highest
+ *          modulation index, with a high level interrupt of LOAD_CYCLES every
+ *          LOAD_PERIOD cycles delaying the update.
+ *        - isr_hires_40000 and isr_hires_65000: periods above 32767 with HiRes,
+ *          the latter also loaded.
+ *        - dma_sine and dma_hires_40000: compare values fed from a frame table
+ *          by DMA on the overflow.
+ *        - frame_table: the frame count limits of MCW_BuildFrameTable().
+ *
+ *      At each overflow (BOTTOM) the program reads the compare values just
+ *      latched and checks them against a 64-bit reference calculation from the
+ *      same sine table. After the run, the PWM signal of each phase is rebuilt
+ *      from these values, tick by tick of the dual-slope counter (high while CNT
+ *      is below the compare value), and the dead-time insertion is applied with
+ *      the dead times read back from the AWeX: the high side turns on DTHS after
+ *      the rising edge, the low side DTLS after the falling edge, and a pulse
+ *      shorter than the dead time gives no output. The shortest output pulse
+ *      must be at least the dead time.
+ *
+ *      The update latency is CNT at entry of the overflow interrupt, in timer
+ *      ticks from BOTTOM; its spread is reported as the jitter. The simulator
+ *      does not count the C code between register accesses, so each interrupt
+ *      is charged ISR_PROLOGUE_CYCLES before the handler, and UPDATE_CYCLES for
+ *      the calculation in MCW_Update(), an assumed figure. The worst case update
+ *      time of the driver must stay below the period, so the new values are
+ *      written while the counter still counts up.
+ *
+ *      Each scenario prints one line of space separated key=value pairs, and the
+ *      program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding mc_waveform_driver.c. The
+ *      simulator is shared with AVR1307, the DMA model needs a program linked
+ *      with -no-pie, and the flash attribute of avr_compiler.h means nothing on
+ *      the host:
+ *        gcc -std=gnu99 -O2 -no-pie -Wno-attributes -DF_CPU=32000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c \
+ *            host_sim/mc_waveform_sim.c mc_waveform_driver.c awex_driver.c \
+ *            hires_driver.c -o mc_waveform_sim
+ *        ./mc_waveform_sim
+ *
+ * \par Application note:
+ *      AVR1311: Using the XMEGA Timer/Counter Extensions.
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "mc_waveform_driver.h"
+#include "sim.h"
+
+/*! PWM periods run per scenario. */
+#define PERIODS              300
+
+/*! Phase step of all scenarios, one electrical turn in 256 PWM periods. */
+#define PHASE_STEP           256
+
+/*! Frames in one electrical turn at PHASE_STEP. */
+#define FRAMES               ( 0x10000UL / PHASE_STEP )
+
+/*! Dead time in peripheral clock cycles. */
+#define DEAD_TIME            16
+
+/*! Part of the ISR body spent saving registers before the handler runs. */
+#define ISR_PROLOGUE_CYCLES  20
+
+/*! Assumed CPU cycles of the calculation in MCW_Update(). */
+#define UPDATE_CYCLES        180
+
+/*! CPU cycles of the competing high level interrupt. */
+#define LOAD_CYCLES          300
+
+/*! Period of the competing high level interrupt, in CPU cycles. */
+#define LOAD_PERIOD          997
+
+
+/*! \brief A test scenario of the waveform generator. */
+typedef struct Scenario_struct {
+	/*! Name printed. */
+	const char * name;
+	/*! PWM period in timer ticks. */
+	uint16_t period;
+	/*! HiRes enabled. */
+	bool hires;
+	/*! Modulation mode. */
+	MCW_Mode_t mode;
+	/*! Compare values fed by DMA instead of the overflow interrupt. */
+	bool dma;
+	/*! Competing high level interrupt running. */
+	bool load;
+} Scenario_t;
+
+/*! The scenarios. */
+static const Scenario_t scenarios[] = {
+	{ "isr_sine",        800,   false, MCW_MODE_SINE,  false, false },
+	{ "isr_svpwm_load",  1600,  false, MCW_MODE_SVPWM, false, true  },
+	{ "isr_hires_40000", 40000, true,  MCW_MODE_SVPWM, false, false },
+	{ "isr_hires_65000", 65000, true,  MCW_MODE_SINE,  false, true  },
+	{ "dma_sine",        800,   false, MCW_MODE_SVPWM, true,  false },
+	{ "dma_hires_40000", 40000, true,  MCW_MODE_SINE,  true,  false },
+};
+
+
+/*! Sine table of the driver. */
+extern const int16_t MCW_sineTable[MCW_SINE_TABLE_SIZE];
+
+/*! The waveform generator under test, on TCC0. */
+static MCW_Generator_t gen;
+
+/*! Frame table of the DMA scenarios. In static data for the DMA. */
+uint16_t frames[FRAMES * MCW_DMA_FRAME_SIZE / 2];
+
+/*! Compare values in effect in each PWM period, latched at its start. */
+static uint16_t periodCompare[PERIODS + 2][3];
+
+/*! The scenario runs with DMA. */
+static volatile bool dmaMode;
+
+/*! Time the counter was started. */
+static uint64_t startCycles;
+
+/*! CPU cycles per PWM period. */
+static uint32_t periodCycles;
+
+/*! Overflow interrupts seen, and those that came a period late or more. */
+static volatile uint16_t overflows;
+static volatile uint16_t missed;
+
+/*! Shortest and longest CNT at entry of the overflow interrupt. */
+static uint16_t latencyMin;
+static uint16_t latencyMax;
+
+
+/*! \brief Calculate a compare value as the driver should, in 64 bits. */
+static uint16_t Reference_Compare(uint16_t phase, uint8_t i)
+{
+	static const uint16_t offsets[3] = { 0, MCW_PHASE_OFFSET_V, MCW_PHASE_OFFSET_W };
+	int16_t voltage[3];
+	int64_t compare;
+	uint8_t j;
+
+	for (j = 0; j < 3; j++) {
+		voltage[j] = MCW_sineTable[MCW_PHASE_TO_INDEX((uint16_t) (phase - offsets[j]))];
+	}
+	if (gen.mode == MCW_MODE_SVPWM) {
+		int16_t max = voltage[0];
+		int16_t min = voltage[0];
+
+		for (j = 1; j < 3; j++) {
+			max = (voltage[j] > max) ? voltage[j] : max;
+			min = (voltage[j] < min) ? voltage[j] : min;
+		}
+		voltage[i] -= (max >> 1) + (min >> 1);
+	}
+
+	compare = (gen.period >> 1) + (((int64_t) voltage[i] * gen.amplitude) >> 15);
+	if (compare < gen.minCompare) {
+		return gen.minCompare;
+	}
+	if (compare > gen.maxCompare) {
+		return gen.maxCompare;
+	}
+	return (uint16_t) compare;
+}
+
+
+/*! \brief Output timing of one phase, rebuilt from the compare values. */
+typedef struct Render_struct {
+	/*! Output pulses shorter than one tick, swallowed by the dead time. */
+	uint32_t swallowed;
+	/*! Shortest output pulse, high or low side, in ticks. */
+	uint32_t pulseMin;
+} Render_t;
+
+
+/*! \brief Rebuild the outputs of one phase and apply the dead time.
+ *
+ *  \param phase   0 to 2 for phase U to W.
+ *  \param count   Number of PWM periods in periodCompare.
+ *  \param deadHs  High side dead time in ticks.
+ *  \param deadLs  Low side dead time in ticks.
+ */
+static void Render_Phase(Render_t * r, uint8_t phase, uint16_t count,
+                         uint32_t deadHs, uint32_t deadLs)
+{
+	uint32_t top = gen.period;
+	uint64_t lastRise = 0;
+	uint64_t lastFall = 0;
+	bool high = true;
+	uint16_t p;
+
+	r->swallowed = 0;
+	r->pulseMin = UINT32_MAX;
+
+	/* Each period starts at BOTTOM, high while CNT is below the compare
+	 * value: falling on the way up, rising again on the way down.
+	 */
+	for (p = 0; p < count; p++) {
+		uint64_t start = (uint64_t) p * 2 * top;
+		uint32_t compare = periodCompare[p][phase];
+		uint64_t edges[2] = { start + compare, start + 2 * top - compare };
+		uint8_t e;
+
+		if ((compare == 0) || (compare >= top)) {
+			continue;
+		}
+		for (e = 0; e < 2; e++) {
+			uint64_t length;
+			uint32_t dead;
+
+			if (high) {
+				/* The high side was on from lastRise + deadHs. */
+				length = edges[e] - lastRise;
+				dead = deadHs;
+				lastFall = edges[e];
+			} else {
+				length = edges[e] - lastFall;
+				dead = deadLs;
+				lastRise = edges[e];
+			}
+			/* The first edge ends a pulse that started before the run. */
+			if ((p != 0) || (e != 0)) {
+				if (length <= dead) {
+					r->swallowed++;
+				} else if (length - dead < r->pulseMin) {
+					r->pulseMin = (uint32_t) (length - dead);
+				}
+			}
+			high = !high;
+		}
+	}
+}
+
+
+/*! \brief Run one scenario.
+ *
+ *  \return  true if all checks pass.
+ */
+static bool Scenario_Run(const Scenario_t * s)
+{
+	uint8_t resolution = s->hires ? 4 : 1;
+	uint16_t frameCount = 0;
+	uint16_t mismatches = 0;
+	uint16_t outOfRange = 0;
+	uint32_t pulseMin = UINT32_MAX;
+	uint32_t swallowed = 0;
+	uint32_t deadHs;
+	uint32_t deadLs;
+	uint16_t count;
+	uint16_t p;
+	uint8_t i;
+	bool success;
+
+	HIRES_Enable(&HIRESC, HIRES_HREN_NONE_gc);
+	MCW_Init(&gen, &TCC0, &AWEXC, s->hires ? &HIRESC : NULL, s->period, DEAD_TIME);
+	MCW_SetMode(&gen, s->mode);
+	MCW_SetModulationIndex(&gen, (s->mode == MCW_MODE_SVPWM) ?
+	                             MCW_MODINDEX_MAX_SVPWM : MCW_MODINDEX_ONE);
+	MCW_SetPhaseStep(&gen, PHASE_STEP);
+
+	memset(periodCompare, 0, sizeof(periodCompare));
+	for (i = 0; i < 3; i++) {
+		periodCompare[0][i] = s->period >> 1;
+	}
+	overflows = 0;
+	missed = 0;
+	latencyMin = UINT16_MAX;
+	latencyMax = 0;
+	periodCycles = 2UL * s->period / resolution;
+	dmaMode = s->dma;
+
+	if (s->load) {
+		TCD0.PER = LOAD_PERIOD - 1;
+		TCD0.INTCTRLA = TC_OVFINTLVL_HI_gc;
+		TCD0.CTRLA = TC_CLKSEL_DIV1_gc;
+	}
+	if (s->dma) {
+		frameCount = MCW_BuildFrameTable(&gen, frames, FRAMES);
+		MCW_StartDMA(&gen, &DMA.CH0, DMA_CH_TRIGSRC_TCC0_OVF_gc, frames, frameCount);
+		MCW_Start(&gen, TC_OVFINTLVL_OFF_gc);
+		/* Only to observe the compare values latched. */
+		TCC0.INTCTRLA = TC_OVFINTLVL_LO_gc;
+	} else {
+		MCW_Start(&gen, TC_OVFINTLVL_LO_gc);
+	}
+	startCycles = SIM_GetCycles();
+
+	while (overflows < PERIODS) {
+		SIM_Run(periodCycles / 4);
+	}
+
+	if (s->dma) {
+		MCW_StopDMA(&gen, &DMA.CH0);
+	}
+	MCW_Stop(&gen);
+	TCD0.CTRLA = TC_CLKSEL_OFF_gc;
+	TCD0.INTCTRLA = TC_OVFINTLVL_OFF_gc;
+
+	/* Overflow k latched the values of period k + 1; the values of the
+	 * first two periods are those set by MCW_Init(), and the first update
+	 * is latched from the third.
+	 */
+	count = PERIODS + 1;
+	for (p = 1; p < count; p++) {
+		uint16_t phase = s->dma ? (uint16_t) (((p - 2) % frameCount) * PHASE_STEP) :
+		                          (uint16_t) ((p - 1) * PHASE_STEP);
+
+		for (i = 0; i < 3; i++) {
+			uint16_t compare = periodCompare[p][i];
+			uint16_t expected = (p < 2) ? (s->period >> 1) : Reference_Compare(phase, i);
+
+			if ((compare < gen.minCompare) || (compare > gen.maxCompare)) {
+				outOfRange++;
+			}
+			if (compare != expected) {
+				mismatches++;
+			}
+		}
+	}
+
+	deadHs = (uint32_t) AWEXC.DTHS * resolution;
+	deadLs = (uint32_t) AWEXC.DTLS * resolution;
+	for (i = 0; i < 3; i++) {
+		Render_t r;
+
+		Render_Phase(&r, i, count, deadHs, deadLs);
+		swallowed += r.swallowed;
+		if (r.pulseMin < pulseMin) {
+			pulseMin = r.pulseMin;
+		}
+	}
+
+	success = (mismatches == 0) && (outOfRange == 0) && (missed == 0) &&
+	          (swallowed == 0) && (pulseMin >= DEAD_TIME * resolution) &&
+	          (deadHs == DEAD_TIME * resolution) && (deadLs == DEAD_TIME * resolution);
+	if (s->dma) {
+		success &= (frameCount == FRAMES);
+	} else {
+		success &= (MCW_GetWorstCaseUpdateTicks(&gen) < s->period);
+	}
+
+	printf("scenario=%s period=%u hires=%u mode=%s periods=%u missed=%u "
+	       "mismatches=%u out_of_range=%u dead_ticks=%lu swallowed=%lu "
+	       "pulse_min_ticks=%lu latency_min=%u latency_max=%u jitter_ticks=%u "
+	       "update_ticks_max=%u result=%s\n",
+	       s->name, s->period, s->hires, (s->mode == MCW_MODE_SVPWM) ? "svpwm" : "sine",
+	       PERIODS, missed, mismatches, outOfRange, (unsigned long) deadHs,
+	       (unsigned long) swallowed, (unsigned long) pulseMin, latencyMin, latencyMax,
+	       latencyMax - latencyMin, s->dma ? 0 : MCW_GetWorstCaseUpdateTicks(&gen),
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Check the frame count limits of MCW_BuildFrameTable().
+ *
+ *  A phase step of one gives 65536 frames, which does not fit in 16 bits;
+ *  it must be rejected rather than wrapped to zero frames. The buffer must
+ *  be left untouched whenever the table does not fit.
+ */
+static bool FrameTable_Check(void)
+{
+	uint16_t stepOne;
+	uint16_t stepTwo;
+	uint16_t fits;
+	uint16_t i;
+	bool untouched = true;
+
+	MCW_Init(&gen, &TCC0, &AWEXC, NULL, 800, DEAD_TIME);
+	MCW_SetModulationIndex(&gen, MCW_MODINDEX_ONE);
+	memset(frames, 0xA5, sizeof(frames));
+
+	MCW_SetPhaseStep(&gen, 1);
+	stepOne = MCW_BuildFrameTable(&gen, frames, UINT16_MAX);
+	MCW_SetPhaseStep(&gen, 2);
+	stepTwo = MCW_BuildFrameTable(&gen, frames, FRAMES);
+	for (i = 0; i < sizeof(frames) / sizeof(frames[0]); i++) {
+		untouched &= (frames[i] == 0xA5A5);
+	}
+	MCW_SetPhaseStep(&gen, PHASE_STEP);
+	fits = MCW_BuildFrameTable(&gen, frames, FRAMES);
+
+	printf("scenario=frame_table step_1=%u step_2=%u step_%u=%u untouched=%s result=%s\n",
+	       stepOne, stepTwo, PHASE_STEP, fits, untouched ? "yes" : "no",
+	       ((stepOne == 0) && (stepTwo == 0) && (fits == FRAMES) && untouched) ?
+	       "pass" : "fail");
+	return (stepOne == 0) && (stepTwo == 0) && (fits == FRAMES) && untouched;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm | PMIC_HILVLEN_bm;
+	sei();
+
+	for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+		success &= Scenario_Run(&scenarios[i]);
+	}
+	success &= FrameTable_Check();
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
+
+
+/*! \brief Overflow (BOTTOM) interrupt service routine of TCC0.
+ *
+ *  Updates the compare buffers unless they are fed by DMA, and notes the
+ *  values latched at this BOTTOM for the period that starts.
+ */
+ISR(TCC0_OVF_vect)
+{
+	uint16_t latency = TCC0.CNT;
+	uint32_t period = (uint32_t) ((SIM_GetCycles() - startCycles) / periodCycles);
+
+	SIM_Run(ISR_PROLOGUE_CYCLES);
+	if (!dmaMode) {
+		SIM_Run(UPDATE_CYCLES);
+		MCW_Update(&gen);
+	}
+
+	if (latency < latencyMin) {
+		latencyMin = latency;
+	}
+	if (latency > latencyMax) {
+		latencyMax = latency;
+	}
+
+	/* The interrupt of the BOTTOM ending period k runs in period k + 1. */
+	if (period != (uint32_t) overflows + 1) {
+		missed++;
+	}
+	if (period <= PERIODS) {
+		periodCompare[period][0] = TCC0.CCA;
+		periodCompare[period][1] = TCC0.CCB;
+		periodCompare[period][2] = TCC0.CCC;
+	}
+	overflows++;
+}
+
+
+/*! \brief Competing high level interrupt. */
+ISR(TCD0_OVF_vect)
+{
+	SIM_Run(LOAD_CYCLES);
+}
@@ -0,0 +1,470 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief
+ *      XMEGA 3-phase motor control waveform generator source file.
+ *
+ *      This file contains the function implementations of the 3-phase
+ *      waveform generator. It combines Timer/Counter 0 in dual-slope PWM
+ *      mode, the AWeX dead-time insertion and optionally the HiRes extension
+ *      to drive three complementary half-bridges from a single timer.
+ *
+ * \par Application note:
+ *      AVR1311: Using the XMEGA Timer/Counter Extensions.
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "mc_waveform_driver.h"
+
+/*! \brief 16-bit signed sine table with 256 elements, Q15 format.
+ *
+ *  The table is placed in flash to save SRAM. One entry covers 1.4 degrees
+ *  of electrical angle.
+ */
+FLASH_DECLARE( const int16_t MCW_sineTable[MCW_SINE_TABLE_SIZE] ) = {
+	     0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+	  6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+	 12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+	 18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+	 23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+	 27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+	 30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+	 32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+	 32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+	 32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+	 30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+	 27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+	 23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+	 18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+	 12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+	  6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+	     0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+	 -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+	-12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+	-18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+	-23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+	-27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+	-30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+	-32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+	-32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+	-32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+	-30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+	-27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+	-23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+	-18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+	-12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+	 -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+
+/*! \brief Limit a compare value to the allowed range.
+ *
+ *  Pulses shorter than the dead time would be swallowed by the AWeX, so the
+ *  duty cycle is clamped to keep both switches of a half-bridge switching
+ *  cleanly.
+ *
+ *  The compare value is taken as 32 bits, since periods above 32767 (which
+ *  HiRes makes useful) do not fit a signed 16-bit value.
+ *
+ *  \param gen      Pointer to the waveform generator.
+ *  \param compare  Unlimited compare value.
+ *
+ *  \return  Compare value within [minCompare, maxCompare].
+ */
+static uint16_t MCW_ClampCompare( MCW_Generator_t * gen, int32_t compare )
+{
+	if ( compare < (int32_t) gen->minCompare ) {
+		return gen->minCompare;
+	}
+	if ( compare > (int32_t) gen->maxCompare ) {
+		return gen->maxCompare;
+	}
+	return (uint16_t) compare;
+}
+
+
+/*! \brief Initialize the waveform generator.
+ *
+ *  This function configures the Timer/Counter for dual-slope PWM with
+ *  compare channels A, B and C enabled, and the AWeX for dead-time insertion
+ *  on the same channels. The complementary outputs for phase U, V and W are
+ *  pin 0/1, 2/3 and 4/5 of the port belonging to the Timer/Counter. The
+ *  application must set these pins as outputs.
+ *
+ *  The overflow flag is set at BOTTOM, which is also where the buffered
+ *  compare values are latched, so MCW_Update() always has a full PWM
+ *  period to prepare the next values.
+ *
+ *  The generator is left stopped with 50% duty cycle on all phases, sine
+ *  mode and zero modulation index.
+ *
+ *  \note The HiRes extension requires the Timer/Counter to run from the
+ *        non-prescaled peripheral clock, and clkPER4 to run at four times
+ *        clkPER. Only Timer/Counter 0 is enabled in the HiRes module.
+ *
+ *  \param gen       Pointer to the waveform generator.
+ *  \param tc        The Timer/Counter 0 module to use.
+ *  \param awex      The AWeX module belonging to the Timer/Counter.
+ *  \param hires     The HiRes module belonging to the Timer/Counter, or NULL
+ *                   to run without HiRes.
+ *  \param period    PWM period (TOP value) in timer ticks. The PWM frequency
+ *                   is f_clk / (2 * period).
+ *  \param deadTime  The dead time, in peripheral clock cycles.
+ */
+void MCW_Init( MCW_Generator_t * gen,
+               TC0_t * tc,
+               AWEX_t * awex,
+               HIRES_t * hires,
+               uint16_t period,
+               uint8_t deadTime )
+{
+	uint16_t deadTicks = deadTime;
+
+	gen->tc = tc;
+	gen->awex = awex;
+	gen->period = period;
+	gen->phase = 0;
+	gen->phaseStep = 0;
+	gen->modIndex = 0;
+	gen->amplitude = 0;
+	gen->mode = MCW_MODE_SINE;
+	gen->updateTicksMax = 0;
+
+	/* With HiRes, one timer tick is a quarter of a dead-time step. */
+	if ( hires != NULL ) {
+		HIRES_Enable( hires, HIRES_HREN_TC0_gc );
+		deadTicks <<= 2;
+	}
+
+	gen->minCompare = deadTicks;
+	gen->maxCompare = period - deadTicks;
+
+	/* Configure the timer for dual-slope PWM, starting at 50% duty cycle. */
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->PER = period;
+	tc->CCA = period >> 1;
+	tc->CCB = period >> 1;
+	tc->CCC = period >> 1;
+	tc->CTRLB = TC0_CCAEN_bm | TC0_CCBEN_bm | TC0_CCCEN_bm | TC_WGMODE_DS_B_gc;
+
+	/* Discard compare values left in the buffers by an earlier run, which
+	 * would otherwise be latched on the first update.
+	 */
+	tc->CTRLGCLR = TC0_PERBV_bm | TC0_CCABV_bm | TC0_CCBBV_bm | TC0_CCCBV_bm;
+
+	/* Configure dead-time insertion, outputs are enabled by MCW_Start(). */
+	AWEX_EnableDeadTimeInsertion( awex, AWEX_DTICCAEN_bm |
+	                                    AWEX_DTICCBEN_bm |
+	                                    AWEX_DTICCCEN_bm );
+	AWEX_SetOutputOverrideValue( (*awex), 0x00 );
+	AWEX_SetDeadTimesSymmetricalUnbuffered( (*awex), deadTime );
+}
+
+
+/*! \brief Select the modulation mode.
+ *
+ *  The modulation index is re-applied, since the allowed range depends on
+ *  the mode.
+ *
+ *  \param gen   Pointer to the waveform generator.
+ *  \param mode  MCW_MODE_SINE or MCW_MODE_SVPWM.
+ */
+void MCW_SetMode( MCW_Generator_t * gen, MCW_Mode_t mode )
+{
+	gen->mode = mode;
+	MCW_SetModulationIndex( gen, gen->modIndex );
+}
+
+
+/*! \brief Set the electrical angle increment per PWM period.
+ *
+ *  Use MCW_PHASE_STEP() to derive the step from the wanted output
+ *  frequency. The new value is used from the next update.
+ *
+ *  \param gen        Pointer to the waveform generator.
+ *  \param phaseStep  Angle increment, a full turn is 65536.
+ */
+void MCW_SetPhaseStep( MCW_Generator_t * gen, uint16_t phaseStep )
+{
+	AVR_ENTER_CRITICAL_REGION( );
+	gen->phaseStep = phaseStep;
+	AVR_LEAVE_CRITICAL_REGION( );
+}
+
+
+/*! \brief Set the modulation index.
+ *
+ *  The index is limited to 1.0 in sine mode and to 2/sqrt(3) in space-vector
+ *  mode. The peak amplitude in timer ticks is precomputed here, so that the
+ *  update does not need to know the period.
+ *
+ *  \param gen       Pointer to the waveform generator.
+ *  \param modIndex  Modulation index in Q15 format.
+ */
+void MCW_SetModulationIndex( MCW_Generator_t * gen, uint16_t modIndex )
+{
+	uint16_t maxIndex = ( gen->mode == MCW_MODE_SVPWM ) ?
+	                    MCW_MODINDEX_MAX_SVPWM : MCW_MODINDEX_ONE;
+	uint16_t amplitude;
+
+	if ( modIndex > maxIndex ) {
+		modIndex = maxIndex;
+	}
+	amplitude = (uint16_t) ( ( (uint32_t) modIndex * ( gen->period >> 1 ) ) >> 15 );
+
+	AVR_ENTER_CRITICAL_REGION( );
+	gen->modIndex = modIndex;
+	gen->amplitude = amplitude;
+	AVR_LEAVE_CRITICAL_REGION( );
+}
+
+
+/*! \brief Start the PWM outputs.
+ *
+ *  This function enables the AWeX output override on the six phase pins
+ *  and starts the timer from the non-prescaled peripheral clock.
+ *
+ *  \param gen       Pointer to the waveform generator.
+ *  \param intLevel  Interrupt level of the overflow interrupt calling
+ *                   MCW_Update(). Use TC_OVFINTLVL_OFF_gc when the compare
+ *                   values are fed by DMA.
+ */
+void MCW_Start( MCW_Generator_t * gen, TC_OVFINTLVL_t intLevel )
+{
+	TC0_t * tc = gen->tc;
+
+	gen->updateTicksMax = 0;
+
+	AWEX_SetOutputOverrideValue( (*gen->awex), 0x3F );
+
+	tc->INTFLAGS = TC0_OVFIF_bm;
+	tc->INTCTRLA = ( tc->INTCTRLA & ~TC0_OVFINTLVL_gm ) | intLevel;
+	tc->CTRLA = TC_CLKSEL_DIV1_gc;
+}
+
+
+/*! \brief Stop the PWM outputs.
+ *
+ *  The AWeX output override is released first, so the pins fall back to
+ *  the port output value. The application should keep this value low so
+ *  all switches are off while the generator is stopped.
+ *
+ *  \param gen  Pointer to the waveform generator.
+ */
+void MCW_Stop( MCW_Generator_t * gen )
+{
+	TC0_t * tc = gen->tc;
+
+	AWEX_SetOutputOverrideValue( (*gen->awex), 0x00 );
+
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->INTCTRLA &= ~TC0_OVFINTLVL_gm;
+	tc->CTRLFSET = TC_CMD_RESTART_gc;
+}
+
+
+/*! \brief Calculate the compare values for a given electrical angle.
+ *
+ *  In space-vector mode, the mean of the largest and the smallest phase
+ *  voltage is subtracted from all three phases. This zero-sequence
+ *  injection gives the same switching pattern as classic space-vector
+ *  modulation, without the sector calculation.
+ *
+ *  \param gen            Pointer to the waveform generator.
+ *  \param phase          Electrical angle of phase U.
+ *  \param compareValues  Array receiving the compare values for phase U, V
+ *                        and W.
+ */
+void MCW_CalculateCompareValues( MCW_Generator_t * gen,
+                                 uint16_t phase,
+                                 uint16_t * compareValues )
+{
+	int16_t voltage[3];
+	int32_t center = gen->period >> 1;
+	uint16_t amplitude = gen->amplitude;
+	uint8_t i;
+
+	voltage[0] = PGM_READ_WORD( &MCW_sineTable[MCW_PHASE_TO_INDEX( phase )] );
+	voltage[1] = PGM_READ_WORD( &MCW_sineTable[MCW_PHASE_TO_INDEX( phase - MCW_PHASE_OFFSET_V )] );
+	voltage[2] = PGM_READ_WORD( &MCW_sineTable[MCW_PHASE_TO_INDEX( phase - MCW_PHASE_OFFSET_W )] );
+
+	if ( gen->mode == MCW_MODE_SVPWM ) {
+		int16_t max = voltage[0];
+		int16_t min = voltage[0];
+		int16_t offset;
+
+		for ( i = 1; i < 3; i++ ) {
+			if ( voltage[i] > max ) {
+				max = voltage[i];
+			}
+			if ( voltage[i] < min ) {
+				min = voltage[i];
+			}
+		}
+
+		/* Halve before adding to stay within 16 bits. */
+		offset = ( max >> 1 ) + ( min >> 1 );
+		for ( i = 0; i < 3; i++ ) {
+			voltage[i] -= offset;
+		}
+	}
+
+	for ( i = 0; i < 3; i++ ) {
+		int32_t delta = ( (int32_t) voltage[i] * amplitude ) >> 15;
+		compareValues[i] = MCW_ClampCompare( gen, center + delta );
+	}
+}
+
+
+/*! \brief Precompute the compare values for one electrical period.
+ *
+ *  The table is laid out as consecutive frames of four words, matching the
+ *  CCABUF to CCDBUF registers, so it can be fed to the timer by
+ *  MCW_StartDMA() without any CPU involvement. The number of frames is the
+ *  number of PWM periods in one electrical period, rounded to the nearest
+ *  integer. The output frequency is therefore slightly quantized compared
+ *  to the interrupt-driven update.
+ *
+ *  \param gen        Pointer to the waveform generator.
+ *  \param frames     Buffer for the frames, 4 words per frame.
+ *  \param maxFrames  Number of frames the buffer can hold.
+ *
+ *  \return  The number of frames written, or zero if the phase step is zero
+ *           or the electrical period does not fit in the buffer. A phase
+ *           step of one gives 65536 frames, which never fits.
+ */
+uint16_t MCW_BuildFrameTable( MCW_Generator_t * gen,
+                              uint16_t * frames,
+                              uint16_t maxFrames )
+{
+	uint32_t frameCount;
+	uint16_t phase = 0;
+	uint16_t i;
+
+	if ( gen->phaseStep == 0 ) {
+		return 0;
+	}
+
+	frameCount = ( 0x10000UL + ( gen->phaseStep >> 1 ) ) / gen->phaseStep;
+	if ( frameCount > maxFrames ) {
+		return 0;
+	}
+
+	for ( i = 0; i < frameCount; i++ ) {
+		MCW_CalculateCompareValues( gen, phase, frames );
+		frames[3] = 0;
+		frames += MCW_DMA_FRAME_SIZE / 2;
+		phase += gen->phaseStep;
+	}
+
+	return (uint16_t) frameCount;
+}
+
+
+/*! \brief Feed the compare buffers from a frame table by DMA.
+ *
+ *  The DMA channel is triggered by the Timer/Counter overflow and copies one
+ *  8-byte frame per PWM period to CCABUF..CCDBUF. The table is repeated
+ *  until MCW_StopDMA() is called. Start the timer with MCW_Start() and the
+ *  overflow interrupt disabled after calling this function.
+ *
+ *  \param gen         Pointer to the waveform generator.
+ *  \param channel     The DMA channel to use.
+ *  \param trigger     The overflow trigger source of the Timer/Counter,
+ *                     e.g. DMA_CH_TRIGSRC_TCC0_OVF_gc.
+ *  \param frames      Frame table built by MCW_BuildFrameTable().
+ *  \param frameCount  Number of frames in the table, max 8191.
+ */
+void MCW_StartDMA( MCW_Generator_t * gen,
+                   volatile DMA_CH_t * channel,
+                   DMA_CH_TRIGSRC_t trigger,
+                   const uint16_t * frames,
+                   uint16_t frameCount )
+{
+	uint32_t srcAddr = (uint32_t) (uintptr_t) frames;
+	uint32_t destAddr = (uint32_t) (uintptr_t) &gen->tc->CCABUF;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+
+	/* Reset the channel before reconfiguring it. */
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	channel->CTRLA |= DMA_CH_RESET_bm;
+
+	channel->SRCADDR0 = ( srcAddr >> 0*8 ) & 0xFF;
+	channel->SRCADDR1 = ( srcAddr >> 1*8 ) & 0xFF;
+	channel->SRCADDR2 = ( srcAddr >> 2*8 ) & 0xFF;
+
+	channel->DESTADDR0 = ( destAddr >> 0*8 ) & 0xFF;
+	channel->DESTADDR1 = ( destAddr >> 1*8 ) & 0xFF;
+	channel->DESTADDR2 = ( destAddr >> 2*8 ) & 0xFF;
+
+	/* Walk through the table and restart at the end, write one frame to
+	 * the four compare buffers per burst.
+	 */
+	channel->ADDRCTRL = DMA_CH_SRCRELOAD_BLOCK_gc | DMA_CH_SRCDIR_INC_gc |
+	                    DMA_CH_DESTRELOAD_BURST_gc | DMA_CH_DESTDIR_INC_gc;
+	channel->TRFCNT = frameCount * MCW_DMA_FRAME_SIZE;
+	channel->REPCNT = 0;
+	channel->TRIGSRC = trigger;
+
+	/* One burst per trigger. Repeat count zero and repeat mode gives
+	 * unlimited repeats.
+	 */
+	channel->CTRLA = DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm | DMA_CH_SINGLE_bm |
+	                 DMA_CH_BURSTLEN_8BYTE_gc;
+}
+
+
+/*! \brief Stop feeding the compare buffers by DMA.
+ *
+ *  The last frame written stays in the compare registers, so call
+ *  MCW_Stop() as well to stop the outputs.
+ *
+ *  \param gen      Pointer to the waveform generator.
+ *  \param channel  The DMA channel used by MCW_StartDMA().
+ */
+void MCW_StopDMA( MCW_Generator_t * gen, volatile DMA_CH_t * channel )
+{
+	(void) gen;
+
+	channel->CTRLA &= ~DMA_CH_ENABLE_bm;
+	do {
+		/* Wait for an ongoing burst to complete. */
+	} while ( channel->CTRLB & DMA_CH_CHBUSY_bm );
+}
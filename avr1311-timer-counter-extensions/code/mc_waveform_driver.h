@@ -0,0 +1,227 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA 3-phase motor control waveform generator header file.
+ *
+ *      This file contains the function prototypes, macros and type
+ *      definitions for the 3-phase waveform generator. The generator drives
+ *      the three complementary output pairs of a Timer/Counter 0 through the
+ *      AWeX dead-time insertion unit and produces sinusoidal or space-vector
+ *      modulated phase voltages for BLDC/PMSM motor control.
+ *
+ *      The phase angle is kept in a 16-bit accumulator, and the phase
+ *      voltages are looked up in a sine table stored in flash. The compare
+ *      values for the next PWM period are written to the buffered compare
+ *      registers either from the Timer/Counter overflow interrupt
+ *      (MCW_Update()) or, for constant speed operation, by a DMA channel
+ *      triggered by the overflow (MCW_StartDMA()).
+ *
+ * \par Application note:
+ *      AVR1311: Using the XMEGA Timer/Counter Extensions.
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef __MC_WAVEFORM_DRIVER_H__
+#define __MC_WAVEFORM_DRIVER_H__
+
+#include "avr_compiler.h"
+#include "awex_driver.h"
+#include "hires_driver.h"
+
+/* Definition of macros */
+
+/*! Number of entries in the flash sine table. */
+#define MCW_SINE_TABLE_SIZE      256
+
+/*! Convert an electrical angle to a sine table index. */
+#define MCW_PHASE_TO_INDEX( _phase )   ( (uint8_t) ( (_phase) >> 8 ) )
+
+/*! Phase accumulator offset of phase V relative to phase U (120 degrees). */
+#define MCW_PHASE_OFFSET_V       21845U
+
+/*! Phase accumulator offset of phase W relative to phase U (240 degrees). */
+#define MCW_PHASE_OFFSET_W       43691U
+
+/*! Modulation index 1.0 in Q15 format. */
+#define MCW_MODINDEX_ONE         32767U
+
+/*! Maximum modulation index in space-vector mode (2/sqrt(3) in Q15). The
+ *  zero-sequence injection keeps the phase-to-phase voltage linear up to
+ *  this value.
+ */
+#define MCW_MODINDEX_MAX_SVPWM   37837U
+
+/*! Number of bytes written by the DMA channel per PWM period: CCABUF,
+ *  CCBBUF, CCCBUF and the unused CCDBUF, giving one 8-byte burst.
+ */
+#define MCW_DMA_FRAME_SIZE       8
+
+/*! \brief Calculate the phase accumulator step.
+ *
+ *  The phase accumulator is advanced once every PWM period, so the step
+ *  depends on both the electrical output frequency and the PWM frequency.
+ *
+ *  \param _outputHz  Electrical output frequency in Hz.
+ *  \param _pwmHz     PWM (update) frequency in Hz.
+ *
+ *  \return  Phase step for MCW_SetPhaseStep().
+ */
+#define MCW_PHASE_STEP( _outputHz, _pwmHz ) \
+        ( (uint16_t) ( ( (uint32_t) (_outputHz) << 16 ) / (_pwmHz) ) )
+
+/*! \brief This macro returns the worst-case update time seen so far.
+ *
+ *  The value is given in Timer/Counter ticks counted from the update
+ *  condition (BOTTOM) until MCW_Update() had written all three compare
+ *  buffers, and therefore includes the interrupt response time. It must
+ *  stay well below the period for the new duty cycles to be latched on the
+ *  next update.
+ *
+ *  \param _gen  Pointer to the waveform generator.
+ */
+#define MCW_GetWorstCaseUpdateTicks( _gen )   ( (_gen)->updateTicksMax )
+
+
+/*! \brief Modulation modes of the waveform generator. */
+typedef enum MCW_Mode_enum {
+	MCW_MODE_SINE = 0,   /*!< Sinusoidal PWM. */
+	MCW_MODE_SVPWM = 1,  /*!< Space-vector PWM by min/max zero-sequence injection. */
+} MCW_Mode_t;
+
+
+/*! \brief Waveform generator instance.
+ *
+ *  The struct holds the timer used for PWM generation, the electrical angle
+ *  and the precomputed scaling used by MCW_Update(). The scaling is done once
+ *  in MCW_SetModulationIndex() so that the update itself needs just one
+ *  multiplication per phase.
+ */
+typedef struct MCW_Generator_struct {
+	/*! Timer/Counter 0 generating the PWM. */
+	TC0_t * tc;
+	/*! AWeX module belonging to the Timer/Counter. */
+	AWEX_t * awex;
+	/*! Timer period. With HiRes enabled, one tick is a quarter clkPER cycle. */
+	uint16_t period;
+	/*! Lowest compare value allowed. Keeps every pulse longer than the dead time. */
+	uint16_t minCompare;
+	/*! Highest compare value allowed. */
+	uint16_t maxCompare;
+	/*! Electrical angle. A full turn is 65536. */
+	uint16_t phase;
+	/*! Angle increment per PWM period. */
+	uint16_t phaseStep;
+	/*! Modulation index in Q15 format. */
+	uint16_t modIndex;
+	/*! Peak phase amplitude in timer ticks, derived from modIndex and period. */
+	uint16_t amplitude;
+	/*! Modulation mode. */
+	MCW_Mode_t mode;
+	/*! Worst-case update time in timer ticks, see MCW_GetWorstCaseUpdateTicks(). */
+	uint16_t updateTicksMax;
+} MCW_Generator_t;
+
+
+/* Prototyping of functions. */
+
+void MCW_Init( MCW_Generator_t * gen,
+               TC0_t * tc,
+               AWEX_t * awex,
+               HIRES_t * hires,
+               uint16_t period,
+               uint8_t deadTime );
+void MCW_SetMode( MCW_Generator_t * gen, MCW_Mode_t mode );
+void MCW_SetPhaseStep( MCW_Generator_t * gen, uint16_t phaseStep );
+void MCW_SetModulationIndex( MCW_Generator_t * gen, uint16_t modIndex );
+void MCW_Start( MCW_Generator_t * gen, TC_OVFINTLVL_t intLevel );
+void MCW_Stop( MCW_Generator_t * gen );
+void MCW_CalculateCompareValues( MCW_Generator_t * gen,
+                                 uint16_t phase,
+                                 uint16_t * compareValues );
+uint16_t MCW_BuildFrameTable( MCW_Generator_t * gen,
+                              uint16_t * frames,
+                              uint16_t maxFrames );
+void MCW_StartDMA( MCW_Generator_t * gen,
+                   volatile DMA_CH_t * channel,
+                   DMA_CH_TRIGSRC_t trigger,
+                   const uint16_t * frames,
+                   uint16_t frameCount );
+void MCW_StopDMA( MCW_Generator_t * gen, volatile DMA_CH_t * channel );
+
+
+/*! \brief Update the compare buffers for the next PWM period.
+ *
+ *  This function is meant to be called first thing in the Timer/Counter
+ *  overflow interrupt service routine. It advances the electrical angle,
+ *  calculates the three compare values and writes them to the buffered
+ *  compare registers, so they are latched on the next update condition.
+ *
+ *  The cost is three flash table reads and three 16x16-bit multiplications,
+ *  plus the min/max search in space-vector mode. The new values must be
+ *  written before the next update condition, one PWM period later. The
+ *  worst-case time, measured from the update condition, is available through
+ *  MCW_GetWorstCaseUpdateTicks(). The measurement is only valid while the
+ *  counter is still counting up, so the update should be budgeted to less
+ *  than half a PWM period, leaving the rest for the application.
+ *
+ *  \param gen  Pointer to the waveform generator.
+ */
+INLINE void MCW_Update( MCW_Generator_t * gen )
+{
+	uint16_t compareValues[3];
+	TC0_t * tc = gen->tc;
+	uint16_t ticks;
+
+	gen->phase += gen->phaseStep;
+	MCW_CalculateCompareValues( gen, gen->phase, compareValues );
+
+	tc->CCABUF = compareValues[0];
+	tc->CCBBUF = compareValues[1];
+	tc->CCCBUF = compareValues[2];
+
+	/* The counter restarted from BOTTOM on the update condition, so its
+	 * value tells how long the update took.
+	 */
+	ticks = tc->CNT;
+	if ( ticks > gen->updateTicksMax ) {
+		gen->updateTicksMax = ticks;
+	}
+}
+
+#endif
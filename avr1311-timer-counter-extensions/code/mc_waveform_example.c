@@ -0,0 +1,190 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA 3-phase motor control waveform generator example source.
+ *
+ *      This file contains an example application that demonstrates the
+ *      3-phase waveform generator, driving a BLDC/PMSM motor bridge with
+ *      space-vector PWM from Timer/Counter C0, AWeX C and HiRes C.
+ *
+ * \par Application note:
+ *      AVR1311: Using the XMEGA Timer/Counter Extensions.
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "avr_compiler.h"
+#include "mc_waveform_driver.h"
+
+/* Prototyping of functions. */
+void ConfigClockSystem( void );
+void ConfigFaultProtection( void );
+
+
+/*! PWM period in HiRes ticks. With clkPER4 at 32 MHz, the PWM frequency is
+ *  32 MHz / (2 * 800) = 20 kHz, with 800 duty cycle steps.
+ */
+#define PWM_PERIOD            800
+
+/*! PWM frequency in Hz, used for the phase step calculation. */
+#define PWM_FREQUENCY         20000
+
+/*! Dead time, given in peripheral clock cycles (1 us at 8 MHz). */
+#define DEAD_TIME_CYCLES      8
+
+/*! Electrical output frequency at full speed, in Hz. */
+#define OUTPUT_FREQUENCY_MAX  200
+
+/*! Modulation index per Hz of output frequency (constant V/f), Q15. */
+#define MODINDEX_PER_HZ       ( MCW_MODINDEX_MAX_SVPWM / OUTPUT_FREQUENCY_MAX )
+
+
+/*! The waveform generator instance. */
+MCW_Generator_t motor;
+
+
+/*! \brief Example using the 3-phase waveform generator.
+ *
+ *  Timer/Counter C0 generates three complementary PWM pairs on PC0 to PC5
+ *  through the AWeX dead-time insertion. The HiRes extension gives four
+ *  times finer duty cycle steps than the timer alone at the same PWM
+ *  frequency.
+ *
+ *  The motor is ramped from standstill to OUTPUT_FREQUENCY_MAX with a
+ *  constant voltage/frequency ratio, using space-vector modulation. The
+ *  compare values are updated in the Timer/Counter C0 overflow interrupt.
+ *  PE0 is set if the update ever takes more than half a PWM period.
+ *
+ *  A falling edge on PD0 (the fault input) clears the direction of the
+ *  AWeX-controlled pins, turning off all switches in hardware.
+ */
+int main( void )
+{
+	uint8_t frequency = 0;
+	uint16_t delay;
+
+	ConfigClockSystem();
+	ConfigFaultProtection();
+
+	/* Phase outputs on PC0 to PC5, all low until the generator runs. */
+	PORTC.OUTCLR = 0x3F;
+	PORTC.DIRSET = 0x3F;
+
+	/* Budget indicator. */
+	PORTE.DIRSET = 0x01;
+
+	MCW_Init( &motor, &TCC0, &AWEXC, &HIRESC, PWM_PERIOD, DEAD_TIME_CYCLES );
+	MCW_SetMode( &motor, MCW_MODE_SVPWM );
+	MCW_Start( &motor, TC_OVFINTLVL_HI_gc );
+
+	/* Enable high level interrupts. */
+	PMIC.CTRL = PMIC_HILVLEN_bm;
+	sei( );
+
+	do {
+		/* Ramp up the output frequency, one Hz every 20 ms. */
+		if ( frequency < OUTPUT_FREQUENCY_MAX ) {
+			frequency++;
+			MCW_SetPhaseStep( &motor, MCW_PHASE_STEP( frequency, PWM_FREQUENCY ) );
+			MCW_SetModulationIndex( &motor, frequency * MODINDEX_PER_HZ );
+		}
+
+		for ( delay = 0; delay < 20; delay++ ) {
+			delay_us( 1000 );
+		}
+
+		if ( MCW_GetWorstCaseUpdateTicks( &motor ) > ( PWM_PERIOD / 2 ) ) {
+			PORTE.OUTSET = 0x01;
+		}
+	} while (1);
+}
+
+
+/*! \brief This function enables the internal 32MHz oscillator and the
+ *         prescalers needed by the HiRes extension.
+ *
+ *  \note  The optimization of the compiler must be set above low to ensure
+ *         that the setting of the CLK register is set within 4 clock cylcles
+ *         after the CCP register is set.
+ */
+void ConfigClockSystem( void )
+{
+	/* Start internal 32MHz RC oscillator. */
+	OSC.CTRL = OSC_RC32MEN_bm;
+
+	do {
+		/* Wait while oscillator stabilizes. */
+	} while ( ( OSC.STATUS & OSC_RC32MRDY_bm ) == 0 );
+
+	/* Enable prescaler B and C, giving clkPER4 = 32 MHz and clkPER = 8 MHz. */
+	CCP = CCP_IOREG_gc;
+	CLK.PSCTRL = CLK_PSBCDIV_2_2_gc;
+
+	/* Select 32 MHz as master clock. */
+	CCP = CCP_IOREG_gc;
+	CLK.CTRL = CLK_SCLKSEL_RC32M_gc;
+}
+
+
+/*! \brief This function configures fault protection, using the falling edge of
+*          PD0 as fault input through event channel 0.
+*/
+void ConfigFaultProtection( void )
+{
+	/* Configure PD0 as input, trigger on falling edge. */
+	PORTD.DIRCLR = 0x01;
+	PORTD.PIN0CTRL = PORT_ISC_FALLING_gc;
+
+	/* Select PD0 as input for event channel 0 multiplexer. */
+	EVSYS.CH0MUX = EVSYS_CHMUX_PORTD_PIN0_gc;
+
+	/* Enable fault detection for AWEX C, using event channel 0. */
+	AWEX_ConfigureFaultDetection( &AWEXC, AWEX_FDACT_CLEARDIR_gc, EVSYS_CHMUX0_bm );
+}
+
+
+/*! \brief Timer/Counter interrupt service routine
+ *
+ *  The overflow occurs at BOTTOM, where the previous compare values have
+ *  just been latched. The values for the next PWM period are calculated
+ *  and written to the compare buffers.
+ */
+ISR(TCC0_OVF_vect)
+{
+	MCW_Update( &motor );
+}
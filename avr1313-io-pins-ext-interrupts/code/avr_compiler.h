@@ -112,6 +112,9 @@
 /*! \brief Define the watchdog reset macro. */
 #define watchdog_reset( ) (__watchdog_reset( ))
 
+/*! \brief Define the sleep macro. */
+#define cpu_sleep( ) (__sleep( ))
+
 
 #define INLINE PRAGMA( inline=forced ) static
 
@@ -139,6 +142,9 @@
 /*! \brief Define the no operation macro. */
 #define nop()   do { __asm__ __volatile__ ("nop"); } while (0)
 
+/*! \brief Define the sleep macro. */
+#define cpu_sleep()   do { __asm__ __volatile__ ("sleep"); } while (0)
+
 #define MAIN_TASK_PROLOGUE int
 
 
@@ -0,0 +1,132 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA debounced pin-change input example source file.
+ *
+ *      This file contains an example application that demonstrates the
+ *      debounced pin-change input service. Eight active-low switches are
+ *      connected to PORTD and eight LEDs to PORTE. A press toggles the LED of
+ *      the switch, and a long press turns all LEDs off. The device sleeps in
+ *      Power-down mode while all switches are stable, and in Idle mode while
+ *      the sampling timer runs.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "port_debounce.h"
+
+/*! Sampling timer clock selection. */
+#define SAMPLE_CLKSEL      TC_CLKSEL_DIV64_gc
+
+/*! Sampling period of 5 ms in timer clock cycles. */
+#define SAMPLE_PERIOD      ( (uint16_t) ( F_CPU / 64 / 200 ) - 1 )
+
+/*! Long press after 1 s, i.e. 200 samples of 5 ms. */
+#define LONG_PRESS_TICKS   200
+
+/*! Port index of the switches, returned by DEBOUNCE_AddPort(). */
+uint8_t switchPort;
+
+
+/*! \brief Debounce example.
+ *
+ *  This function sets up the debounce service and handles the events in
+ *  the main loop. Interrupts are disabled while checking for events before
+ *  going to sleep, and the SLEEP instruction is executed right after SEI,
+ *  so an event posted in between wakes the device.
+ */
+void main( void )
+{
+	uint8_t event;
+
+	PORT_SetPinsAsOutput( &PORTE, 0xFF );
+	PORT_SetOutputValue( &PORTE, 0xFF );
+
+	DEBOUNCE_Init( &TCC0, SAMPLE_CLKSEL, SAMPLE_PERIOD, LONG_PRESS_TICKS );
+	switchPort = DEBOUNCE_AddPort( &PORTD, 0xFF, true );
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	while (true) {
+		while ( DEBOUNCE_GetEvent( &event ) ) {
+			uint8_t pinMask = 1 << DEBOUNCE_EventPin( event );
+
+			switch ( DEBOUNCE_EventType( event ) ) {
+			case DEBOUNCE_EVENT_PRESS:
+				/* The LEDs are active low. */
+				PORT_TogglePins( &PORTE, pinMask );
+				break;
+			case DEBOUNCE_EVENT_LONGPRESS:
+				PORT_SetPins( &PORTE, 0xFF );
+				break;
+			default:
+				break;
+			}
+		}
+
+		cli();
+		if ( DEBOUNCE_service.queueHead == DEBOUNCE_service.queueTail ) {
+			if ( DEBOUNCE_IsIdle() ) {
+				SLEEP.CTRL = SLEEP_SMODE_PDOWN_gc | SLEEP_SEN_bm;
+			} else {
+				SLEEP.CTRL = SLEEP_SMODE_IDLE_gc | SLEEP_SEN_bm;
+			}
+			sei();
+			cpu_sleep();
+			SLEEP.CTRL = 0;
+		}
+		sei();
+	}
+}
+
+
+/*! \brief Switch port pin-change interrupt service routine. */
+ISR(PORTD_INT0_vect)
+{
+	DEBOUNCE_PinChangeHandler( switchPort );
+}
+
+
+/*! \brief Sampling timer overflow interrupt service routine. */
+ISR(TCC0_OVF_vect)
+{
+	DEBOUNCE_TimerHandler();
+}
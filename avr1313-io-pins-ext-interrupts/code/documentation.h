@@ -16,6 +16,16 @@
  * Add the .c files (and .S files where applicable) for the given example to your project.
  * Use device ATxmega128A1, optimization low for debug target and high for release. \n
  *
+ * \section hostsim Host Simulation
+ * The fast-path pin functions of port_fastpin.h and the debounce service can
+ * also be built for a Linux x86-64 host, using the register headers and the
+ * simulator in the host_sim directory of AVR1307. See host_sim/fastpin_map.c
+ * for the checks of the virtual port assignment and of the port each function
+ * accesses, with the code size and cycles listed by hand in port_fastpin.h
+ * rather than measured, host_sim/debounce_trace.c for the bounce traces replayed on the
+ * debounce service with its event latency and wakeups, and sim.h for what is
+ * modelled. \n
+ *
  * \section deviceinfo Device Info
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega128A1.
@@ -0,0 +1,138 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA fast-path pin access example source file.
+ *
+ *      This file contains an example application that demonstrates the
+ *      fast-path pin functions in port_fastpin.h. PORTD holds a software
+ *      generated clock and data line and is mapped to virtual port 0. PORTC
+ *      holds a switch and is mapped to virtual port 1. A status LED on PORTE
+ *      is not mapped and is driven through the ordinary port registers. The
+ *      mapping follows from the number of accesses given for each port.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+/* Single pin accesses per byte shifted out, for the virtual port
+ * assignment. It must be visible to every file including port_fastpin.h,
+ * so it is placed before the include. PORTD gets virtual port 0 and PORTC
+ * virtual port 1; PORTE, with no accesses given, is not mapped. */
+#define FASTPIN_ACCESS_D      26
+#define FASTPIN_ACCESS_C      1
+
+#include "port_fastpin.h"
+
+/*! Software SPI clock line. */
+#define CLOCK_PIN     FASTPIN( FASTPIN_PORT_D, 0 )
+
+/*! Software SPI data line. */
+#define DATA_PIN      FASTPIN( FASTPIN_PORT_D, 1 )
+
+/*! Strobe line latching the shifted data. */
+#define STROBE_PIN    FASTPIN( FASTPIN_PORT_D, 2 )
+
+/*! Switch input, active low. */
+#define SWITCH_PIN    FASTPIN( FASTPIN_PORT_C, 0 )
+
+/*! Status LED on a port that is not mapped to a virtual port. */
+#define LED_PIN       FASTPIN( FASTPIN_PORT_E, 0 )
+
+/*! Bar graph LEDs on the upper half of PORTD. */
+#define BARGRAPH_MASK 0xF0
+
+
+/*! \brief Shift out one byte, most significant bit first.
+ *
+ *  Every pin access below compiles to a single SBI or CBI instruction.
+ *
+ *  \param data  Byte to shift out.
+ */
+static void ShiftOut( uint8_t data )
+{
+	uint8_t bit;
+
+	for ( bit = 0; bit < 8; ++bit ) {
+		FASTPIN_Set( DATA_PIN, ( data & 0x80 ) != 0 );
+		FASTPIN_SetHigh( CLOCK_PIN );
+		data <<= 1;
+		FASTPIN_SetLow( CLOCK_PIN );
+	}
+	FASTPIN_SetHigh( STROBE_PIN );
+	FASTPIN_SetLow( STROBE_PIN );
+}
+
+
+/*! \brief Fast-path pin example.
+ *
+ *  This function shifts out a counter value while the switch is released,
+ *  shows the two lowest bits of the counter on the bar graph and toggles
+ *  the status LED every 256 counts.
+ */
+void main( void )
+{
+	uint8_t count = 0;
+
+	FASTPIN_Init();
+
+	FASTPIN_SetOutput( CLOCK_PIN );
+	FASTPIN_SetOutput( DATA_PIN );
+	FASTPIN_SetOutput( STROBE_PIN );
+	FASTPIN_SetInput( SWITCH_PIN );
+	FASTPIN_SetOutput( LED_PIN );
+	PORT_SetPinsAsOutput( &PORTD, BARGRAPH_MASK );
+
+	/* Enable the pull-up on the switch input. */
+	PORTC.PIN0CTRL = PORT_OPC_PULLUP_gc;
+
+	while (true) {
+		if ( FASTPIN_Get( SWITCH_PIN ) ) {
+			ShiftOut( count );
+
+			/* All four bar graph pins change in one write. */
+			FASTPIN_WriteGroup( FASTPIN_PORT_D,
+			                    BARGRAPH_MASK,
+			                    (uint8_t) ( ( 0x10 << ( count & 0x03 ) ) ) );
+			if ( ++count == 0 ) {
+				FASTPIN_Toggle( LED_PIN );
+			}
+		}
+	}
+}
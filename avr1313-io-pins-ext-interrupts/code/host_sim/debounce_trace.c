@@ -0,0 +1,532 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host bounce trace test of the debounced pin-change input service.
+ *
+ *      This program replays switch traces with contact bounce on PORTD of the
+ *      host simulator and runs the debounce service in port_debounce.c on
+ *      them, set up as in debounce_example.c: eight active-low switches,
+ *      5 ms sampling from TCC0 and a long press after 200 samples. The port
+ *      and timer interrupts call the service handlers, and the main loop
+ *      takes the events from the queue every POLL_US.
+ *
+ *      A bounce is a burst of pseudo-random edges, drawn from a fixed
+ *      sequence so that runs repeat, which ends on the new level at the
+ *      settle time. The cases are clean presses, bounce bursts of 1 to 10 ms,
+ *      a long press, two switches at once, short spikes that must give no
+ *      event, and a run of fast presses.
+ *
+ *      For each case the program prints the edges driven, the events, the
+ *      latency of the press and release events from the settle time, and the
+ *      pin-change and timer wakeups counted by the service, and checks that:
+ *        - the events of each pin are the expected ones, in order,
+ *        - no event comes before the first edge of its burst, or later than
+ *          four sampling periods after the settle time,
+ *        - a long press comes LONG_PRESS_TICKS - 1 samples after the press,
+ *        - there are no more pin-change interrupts than bursts, however
+ *          many edges the bursts have, as a pin change only starts the
+ *          sampling timer and masks the pin-change interrupt,
+ *        - the sampling timer is stopped after the case, and no event was
+ *          lost in the queue.
+ *
+ *      Each line holds space separated key=value pairs, and the program exits
+ *      with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding port_debounce.c. The
+ *      simulator is shared with AVR1307, and needs a program linked with
+ *      -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/debounce_trace.c \
+ *            port_debounce.c port_driver.c -o debounce_trace
+ *        ./debounce_trace
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "port_debounce.h"
+
+/*! Sampling timer clock selection, as in debounce_example.c. */
+#define SAMPLE_CLKSEL      TC_CLKSEL_DIV64_gc
+
+/*! Sampling period of 5 ms in timer clock cycles. */
+#define SAMPLE_PERIOD      ((uint16_t) (F_CPU / 64 / 200) - 1)
+
+/*! Long press after 1 s, i.e. 200 samples of 5 ms. */
+#define LONG_PRESS_TICKS   200
+
+/*! CPU cycles per microsecond. */
+#define CYCLES_PER_US      (F_CPU / 1000000UL)
+
+/*! Sampling period in microseconds. */
+#define SAMPLE_US          ((uint32_t) (SAMPLE_PERIOD + 1) * 64 / CYCLES_PER_US)
+
+/*! Interval of the main loop taking events from the queue. */
+#define POLL_US            10
+
+/*! Allowance for the interrupt handlers and the polling on top of a
+ *  number of sampling periods. */
+#define MARGIN_US          (2 * POLL_US + 200)
+
+/*! Idle line before and after the trace of each case. */
+#define IDLE_US            50000UL
+
+/*! Maximum number of edges of a trace. */
+#define TRACE_SIZE         256
+
+/*! Maximum number of events of a case. */
+#define EVENT_SIZE         32
+
+
+/*! \brief A change of one switch, see Trace_Add(). */
+typedef struct Edge {
+	/*! Time from the start of the case in microseconds. */
+	uint32_t us;
+	/*! Pin of the switch. */
+	uint8_t pin;
+	/*! true if the switch is closed after the edge. */
+	bool pressed;
+} Edge_t;
+
+
+/*! \brief An event expected or taken from the queue. */
+typedef struct Event {
+	/*! The event, as posted by the service. */
+	uint8_t event;
+	/*! Expected: time of the first edge of the burst. Taken: time seen. */
+	uint32_t firstUs;
+	/*! Expected: settle time of the burst. */
+	uint32_t settleUs;
+} Event_t;
+
+
+/*! \brief A bounce trace with its expected events. */
+typedef struct Trace {
+	/*! Edges sorted by time. */
+	Edge_t edges[TRACE_SIZE];
+	/*! Number of edges. */
+	uint16_t edgeCount;
+	/*! Expected events. */
+	Event_t expected[EVENT_SIZE];
+	/*! Number of expected events. */
+	uint8_t expectedCount;
+	/*! Number of bursts, i.e. of switch transitions or spikes. */
+	uint8_t bursts;
+	/*! End of the trace in microseconds. */
+	uint32_t endUs;
+} Trace_t;
+
+
+/*! Port index of the switches, returned by DEBOUNCE_AddPort(). */
+static uint8_t switchPort;
+
+/*! Events taken from the queue during the current case. */
+static Event_t taken[EVENT_SIZE];
+
+/*! Number of events in taken[], may exceed EVENT_SIZE. */
+static uint8_t takenCount;
+
+/*! Cycle count at the start of the current case. */
+static uint64_t caseStart;
+
+/*! State of the bounce sequence. */
+static uint32_t bounceSeed = 1;
+
+
+/*! \brief Switch port pin-change interrupt service routine. */
+ISR(PORTD_INT0_vect)
+{
+	DEBOUNCE_PinChangeHandler(switchPort);
+}
+
+
+/*! \brief Sampling timer overflow interrupt service routine. */
+ISR(TCC0_OVF_vect)
+{
+	DEBOUNCE_TimerHandler();
+}
+
+
+/*! \brief Microseconds since the start of the current case, 0 before it. */
+static uint32_t Case_Now(void)
+{
+	uint64_t now = SIM_GetCycles();
+
+	return (now > caseStart) ? (uint32_t) ((now - caseStart) / CYCLES_PER_US) : 0;
+}
+
+
+/*! \brief Let time pass, taking the events from the queue every POLL_US.
+ *
+ *  \param us  Time from the start of the case to run until.
+ */
+static void Case_RunUntil(uint32_t us)
+{
+	uint64_t end = caseStart + (uint64_t) us * CYCLES_PER_US;
+
+	while (SIM_GetCycles() < end) {
+		uint8_t event;
+
+		SIM_Run(POLL_US * CYCLES_PER_US);
+		while (DEBOUNCE_GetEvent(&event)) {
+			if (takenCount < EVENT_SIZE) {
+				taken[takenCount].event = event;
+				taken[takenCount].firstUs = Case_Now();
+			}
+			takenCount++;
+		}
+	}
+}
+
+
+/*! \brief Next value of the pseudo-random bounce sequence.
+ *
+ *  \param range  Number of values.
+ *
+ *  \return  A value from 0 to range - 1.
+ */
+static uint32_t Bounce_Next(uint32_t range)
+{
+	bounceSeed = bounceSeed * 1103515245UL + 12345;
+	return ((bounceSeed >> 8) & 0xFFFF) % range;
+}
+
+
+/*! \brief Insert an edge into a trace, keeping the edges sorted by time. */
+static void Trace_Edge(Trace_t * trace, uint32_t us, uint8_t pin, bool pressed)
+{
+	uint16_t i = trace->edgeCount;
+
+	if (trace->edgeCount >= TRACE_SIZE) {
+		return;
+	}
+	while ((i > 0) && (trace->edges[i - 1].us > us)) {
+		trace->edges[i] = trace->edges[i - 1];
+		i--;
+	}
+	trace->edges[i].us = us;
+	trace->edges[i].pin = pin;
+	trace->edges[i].pressed = pressed;
+	trace->edgeCount++;
+	if (us > trace->endUs) {
+		trace->endUs = us;
+	}
+}
+
+
+/*! \brief Add an expected event to a trace. */
+static void Trace_Expect(Trace_t * trace, uint8_t type, uint8_t pin,
+                         uint32_t firstUs, uint32_t settleUs)
+{
+	Event_t * expected = &trace->expected[trace->expectedCount++];
+
+	expected->event = type | (switchPort << 3) | pin;
+	expected->firstUs = firstUs;
+	expected->settleUs = settleUs;
+}
+
+
+/*! \brief Add a switch transition with contact bounce to a trace.
+ *
+ *  The switch goes to the new level at us, and then bounces back and forth
+ *  pairs times at pseudo-random times, the last time back to the new level
+ *  at us + bounceUs, the settle time.
+ *
+ *  \param trace     The trace.
+ *  \param us        Time of the first edge.
+ *  \param pin       Pin of the switch.
+ *  \param pressed   true for a press, false for a release.
+ *  \param bounceUs  Length of the bounce.
+ *  \param pairs     Number of bounces back to the old level.
+ */
+static void Trace_Add(Trace_t * trace, uint32_t us, uint8_t pin, bool pressed,
+                      uint32_t bounceUs, uint8_t pairs)
+{
+	uint32_t times[2 * 32];
+	uint8_t count = (bounceUs > 2) ? 2 * pairs : 0;
+	uint8_t i;
+
+	/* Sorted times inside the bounce, the last one is the settle time. */
+	for (i = 0; i < count; i++) {
+		uint32_t t = 1 + Bounce_Next(bounceUs - 1);
+		uint8_t j = i;
+
+		while ((j > 0) && (times[j - 1] > t)) {
+			times[j] = times[j - 1];
+			j--;
+		}
+		times[j] = t;
+	}
+	if (count > 0) {
+		times[count - 1] = bounceUs;
+	}
+
+	Trace_Edge(trace, us, pin, pressed);
+	for (i = 0; i < count; i++) {
+		Trace_Edge(trace, us + times[i], pin, (i & 1) ? pressed : !pressed);
+	}
+	Trace_Expect(trace, pressed ? DEBOUNCE_EVENT_PRESS : DEBOUNCE_EVENT_RELEASE,
+	             pin, us, us + ((count > 0) ? bounceUs : 0));
+	trace->bursts++;
+}
+
+
+/*! \brief Add a spike, a closed contact shorter than the debounce time. */
+static void Trace_Spike(Trace_t * trace, uint32_t us, uint8_t pin, uint32_t lengthUs)
+{
+	Trace_Edge(trace, us, pin, true);
+	Trace_Edge(trace, us + lengthUs, pin, false);
+	trace->bursts++;
+}
+
+
+/*! \brief Build the trace of a case.
+ *
+ *  \param index  Case number.
+ *  \param trace  The trace to build.
+ *
+ *  \return  Name of the case, NULL after the last case.
+ */
+static const char * Case_Build(uint8_t index, Trace_t * trace)
+{
+	uint32_t t;
+	uint8_t i;
+
+	memset(trace, 0, sizeof(*trace));
+	switch (index) {
+	case 0:
+		Trace_Add(trace, 0, 0, true, 0, 0);
+		Trace_Add(trace, 200000, 0, false, 0, 0);
+		return "clean";
+	case 1:
+		Trace_Add(trace, 0, 1, true, 1000, 5);
+		Trace_Add(trace, 200000, 1, false, 1000, 5);
+		return "bounce_1ms";
+	case 2:
+		Trace_Add(trace, 0, 2, true, 5000, 10);
+		Trace_Add(trace, 200000, 2, false, 5000, 10);
+		return "bounce_5ms";
+	case 3:
+		Trace_Add(trace, 0, 3, true, 10000, 15);
+		Trace_Add(trace, 200000, 3, false, 10000, 15);
+		return "bounce_10ms";
+	case 4:
+		Trace_Add(trace, 0, 4, true, 2000, 4);
+		Trace_Expect(trace, DEBOUNCE_EVENT_LONGPRESS, 4, 0, 2000);
+		Trace_Add(trace, 1500000, 4, false, 2000, 4);
+		return "long_press";
+	case 5:
+		Trace_Add(trace, 0, 5, true, 3000, 6);
+		Trace_Add(trace, 2000, 0, true, 3000, 6);
+		Trace_Add(trace, 300000, 5, false, 3000, 6);
+		Trace_Add(trace, 300000, 0, false, 3000, 6);
+		return "two_pins";
+	case 6:
+		/* At most three samples fall inside a spike of 12 ms. */
+		Trace_Spike(trace, 0, 6, 50);
+		Trace_Spike(trace, 100000, 6, 2000);
+		Trace_Spike(trace, 200000, 6, 12000);
+		return "spikes";
+	case 7:
+		for (i = 0, t = 0; i < 5; i++, t += 120000) {
+			Trace_Add(trace, t, 7, true, 2000, 4);
+			Trace_Add(trace, t + 60000, 7, false, 2000, 4);
+		}
+		return "fast_presses";
+	default:
+		return NULL;
+	}
+}
+
+
+/*! \brief Replay a trace and check the events.
+ *
+ *  \param name   Name of the case.
+ *  \param trace  The trace.
+ *
+ *  \return  true if all checks passed.
+ */
+static bool Case_Run(const char * name, const Trace_t * trace)
+{
+	uint16_t pinBefore, timerBefore, pinAfter, timerAfter;
+	uint8_t overflows = DEBOUNCE_service.queueOverflows;
+	uint8_t input = 0xFF;
+	uint32_t latencyMin = UINT32_MAX;
+	uint32_t latencyMax = 0;
+	uint32_t latencyTotal = 0;
+	uint8_t latencyCount = 0;
+	uint8_t wrong = 0;
+	uint8_t late = 0;
+	uint16_t pinWakeups, timerWakeups;
+	bool idle;
+	bool success;
+	uint16_t i;
+
+	DEBOUNCE_GetWakeups(&pinBefore, &timerBefore);
+	takenCount = 0;
+	caseStart = SIM_GetCycles() + (uint64_t) IDLE_US * CYCLES_PER_US;
+
+	/* Drive the edges, active low, and let the service sample them. */
+	for (i = 0; i < trace->edgeCount; i++) {
+		const Edge_t * edge = &trace->edges[i];
+
+		Case_RunUntil(edge->us);
+		if (edge->pressed) {
+			input &= ~(1 << edge->pin);
+		} else {
+			input |= 1 << edge->pin;
+		}
+		SIM_PORT_SetInput(&PORTD, input);
+	}
+	Case_RunUntil(trace->endUs + IDLE_US);
+
+	/* Match the events of each pin in order. */
+	for (i = 0; i < trace->expectedCount; i++) {
+		const Event_t * expected = &trace->expected[i];
+		uint8_t pin = DEBOUNCE_EventPin(expected->event);
+		uint8_t before = 0;
+		uint8_t seen = 0;
+		uint8_t j;
+		uint8_t k;
+
+		for (j = 0; j < i; j++) {
+			before += (DEBOUNCE_EventPin(trace->expected[j].event) == pin);
+		}
+		for (k = 0; k < takenCount && k < EVENT_SIZE; k++) {
+			if (DEBOUNCE_EventPin(taken[k].event) != pin) {
+				continue;
+			}
+			if (seen++ == before) {
+				break;
+			}
+		}
+		if ((k >= takenCount) || (k >= EVENT_SIZE) || (taken[k].event != expected->event)) {
+			wrong++;
+			continue;
+		}
+
+		if (DEBOUNCE_EventType(expected->event) == DEBOUNCE_EVENT_LONGPRESS) {
+			/* The press is the event before on the same pin. */
+			uint8_t press;
+			uint32_t hold;
+
+			for (press = k; press > 0; press--) {
+				if (DEBOUNCE_EventPin(taken[press - 1].event) == pin) {
+					break;
+				}
+			}
+			hold = (press > 0) ? taken[k].firstUs - taken[press - 1].firstUs : 0;
+			if ((hold + MARGIN_US < (LONG_PRESS_TICKS - 1) * SAMPLE_US) ||
+			    (hold > (LONG_PRESS_TICKS - 1) * SAMPLE_US + MARGIN_US)) {
+				late++;
+			}
+			continue;
+		}
+
+		if ((taken[k].firstUs < expected->firstUs) ||
+		    (taken[k].firstUs > expected->settleUs + 4 * SAMPLE_US + MARGIN_US)) {
+			late++;
+		}
+		if (taken[k].firstUs >= expected->settleUs) {
+			uint32_t latency = taken[k].firstUs - expected->settleUs;
+
+			latencyMin = (latency < latencyMin) ? latency : latencyMin;
+			latencyMax = (latency > latencyMax) ? latency : latencyMax;
+			latencyTotal += latency;
+			latencyCount++;
+		}
+	}
+	if (takenCount != trace->expectedCount) {
+		wrong++;
+	}
+
+	DEBOUNCE_GetWakeups(&pinAfter, &timerAfter);
+	pinWakeups = pinAfter - pinBefore;
+	timerWakeups = timerAfter - timerBefore;
+	idle = DEBOUNCE_IsIdle() && ((TCC0.CTRLA & TC0_CLKSEL_gm) == TC_CLKSEL_OFF_gc);
+	overflows = DEBOUNCE_service.queueOverflows - overflows;
+
+	success = (wrong == 0) && (late == 0) && idle && (overflows == 0) &&
+	          (pinWakeups >= 1) && (pinWakeups <= trace->bursts);
+	printf("case=%s edges=%u bursts=%u events=%u expected=%u wrong=%u late=%u "
+	       "latency_min_us=%lu latency_avg_us=%lu latency_max_us=%lu "
+	       "pin_wakeups=%u timer_wakeups=%u idle=%s overflows=%u result=%s\n",
+	       name, trace->edgeCount, trace->bursts, takenCount, trace->expectedCount,
+	       wrong, late,
+	       (unsigned long) (latencyCount ? latencyMin : 0),
+	       (unsigned long) (latencyCount ? latencyTotal / latencyCount : 0),
+	       (unsigned long) latencyMax,
+	       pinWakeups, timerWakeups, idle ? "yes" : "no", overflows,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+int main(void)
+{
+	static Trace_t trace;
+	bool success = true;
+	uint32_t edges = 0;
+	uint16_t pinWakeups, timerWakeups;
+	const char * name;
+	uint8_t index;
+
+	/* Open switches, then start the service as debounce_example.c does. */
+	SIM_PORT_SetInput(&PORTD, 0xFF);
+	DEBOUNCE_Init(&TCC0, SAMPLE_CLKSEL, SAMPLE_PERIOD, LONG_PRESS_TICKS);
+	switchPort = DEBOUNCE_AddPort(&PORTD, 0xFF, true);
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	for (index = 0; (name = Case_Build(index, &trace)) != NULL; index++) {
+		success &= Case_Run(name, &trace);
+		edges += trace.edgeCount;
+	}
+
+	DEBOUNCE_GetWakeups(&pinWakeups, &timerWakeups);
+	printf("summary cases=%u sample_us=%lu edges=%lu pin_wakeups=%u timer_wakeups=%u result=%s\n",
+	       index, (unsigned long) SAMPLE_US, (unsigned long) edges,
+	       pinWakeups, timerWakeups, success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
@@ -0,0 +1,505 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host test of the fast-path pin access and its virtual port mapping.
+ *
+ *      This program checks port_fastpin.h on the host simulator, which models
+ *      the virtual ports and their mapping registers.
+ *
+ *      Tests:
+ *        - map: the virtual port assignment of port_fastpin_map.h, which is
+ *          included once per case: automatic assignments with fewer and
+ *          more than four ports, ties, ports without accesses, and manual
+ *          assignments.
+ *        - pin: each pin function on pins of the four mapped ports and of
+ *          two ports that are not mapped, including PORTQ and PORTR at the
+ *          end of the port area. The function must change or read the pin
+ *          and nothing else. It is run a second time with all virtual ports
+ *          mapped to DECOY_PORT, which holds no test pins: a function using
+ *          a virtual port then acts on DECOY_PORT, so the test sees which
+ *          path each function takes.
+ *        - group: the group functions on a mapped and a port that is not
+ *          mapped, the same way.
+ *
+ *      Each pin function prints the path it took and the number of simulated
+ *      register accesses. It also prints, as listed_code, listed_words and
+ *      listed_cycles, the AVR instruction sequence of that path with its size
+ *      in words and its XMEGA cycles. These are copied by hand from the table
+ *      in port_fastpin.h: there is no AVR compiler in the host build, so they
+ *      are the expected code, not a disassembly, and are not checked. The
+ *      program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding port_fastpin.h. The simulator
+ *      is shared with AVR1307, and needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/fastpin_map.c \
+ *            port_driver.c -o fastpin_map
+ *        ./fastpin_map
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+/* Assignment of the pin tests: PORTD, PORTC, PORTR and PORTH are mapped,
+ * in that order. PORTC goes before PORTR, with as many accesses, and
+ * PORTE is left out as the fifth port. */
+#define FASTPIN_ACCESS_D  50
+#define FASTPIN_ACCESS_C  20
+#define FASTPIN_ACCESS_R  20
+#define FASTPIN_ACCESS_H  5
+#define FASTPIN_ACCESS_E  1
+
+#include "port_fastpin.h"
+
+/*! Port all virtual ports are mapped to when looking for the path taken. */
+#define DECOY_PORT   FASTPIN_PORT_B
+
+/*! Pins of the group test. */
+#define GROUP_MASK   0x3C
+
+/*! Number of entries of a table. */
+#define COUNT(_table)   (sizeof(_table) / sizeof((_table)[0]))
+
+
+/*! \brief A virtual port assignment case. */
+typedef struct MapCase {
+	/*! Name in the output. */
+	const char * name;
+	/*! Expected port of each virtual port. */
+	uint8_t expected[4];
+	/*! Port assigned by port_fastpin_map.h. */
+	uint8_t mapped[4];
+} MapCase_t;
+
+/*! \brief Case row for the current assignment. */
+#define MAP_CASE(_name, _vp0, _vp1, _vp2, _vp3) \
+	{ _name, { _vp0, _vp1, _vp2, _vp3 }, \
+	  { FASTPIN_VPORT0_MAPPED, FASTPIN_VPORT1_MAPPED, \
+	    FASTPIN_VPORT2_MAPPED, FASTPIN_VPORT3_MAPPED } },
+
+#define NONE  FASTPIN_PORT_NONE
+
+/*! Assignment cases. The first is the assignment of the pin tests. */
+static const MapCase_t mapCase[] = {
+#include "port_fastpin_map.h"
+	MAP_CASE("pin_test", FASTPIN_PORT_D, FASTPIN_PORT_C, FASTPIN_PORT_R, FASTPIN_PORT_H)
+#undef FASTPIN_ACCESS_D
+#undef FASTPIN_ACCESS_C
+#undef FASTPIN_ACCESS_R
+#undef FASTPIN_ACCESS_H
+#undef FASTPIN_ACCESS_E
+
+#include "port_fastpin_map.h"
+	MAP_CASE("none", NONE, NONE, NONE, NONE)
+
+#define FASTPIN_ACCESS_D  100
+#define FASTPIN_ACCESS_C  40
+#include "port_fastpin_map.h"
+	MAP_CASE("two", FASTPIN_PORT_D, FASTPIN_PORT_C, NONE, NONE)
+#undef FASTPIN_ACCESS_D
+#undef FASTPIN_ACCESS_C
+
+#define FASTPIN_ACCESS_A  3
+#define FASTPIN_ACCESS_B  9
+#define FASTPIN_ACCESS_C  1
+#define FASTPIN_ACCESS_E  7
+#define FASTPIN_ACCESS_F  12
+#define FASTPIN_ACCESS_K  5
+#include "port_fastpin_map.h"
+	MAP_CASE("six", FASTPIN_PORT_F, FASTPIN_PORT_B, FASTPIN_PORT_E, FASTPIN_PORT_K)
+#undef FASTPIN_ACCESS_A
+#undef FASTPIN_ACCESS_B
+#undef FASTPIN_ACCESS_C
+#undef FASTPIN_ACCESS_E
+#undef FASTPIN_ACCESS_F
+#undef FASTPIN_ACCESS_K
+
+#define FASTPIN_ACCESS_C  5
+#define FASTPIN_ACCESS_B  5
+#define FASTPIN_ACCESS_A  5
+#include "port_fastpin_map.h"
+	MAP_CASE("tie", FASTPIN_PORT_A, FASTPIN_PORT_B, FASTPIN_PORT_C, NONE)
+#undef FASTPIN_ACCESS_A
+#undef FASTPIN_ACCESS_B
+#undef FASTPIN_ACCESS_C
+
+#define FASTPIN_ACCESS_A  0
+#define FASTPIN_ACCESS_R  1
+#include "port_fastpin_map.h"
+	MAP_CASE("zero", FASTPIN_PORT_R, NONE, NONE, NONE)
+#undef FASTPIN_ACCESS_A
+#undef FASTPIN_ACCESS_R
+
+#define FASTPIN_ACCESS_Q  3
+#define FASTPIN_ACCESS_R  7
+#define FASTPIN_ACCESS_H  7
+#define FASTPIN_ACCESS_K  2
+#define FASTPIN_ACCESS_J  1
+#include "port_fastpin_map.h"
+	MAP_CASE("high", FASTPIN_PORT_H, FASTPIN_PORT_R, FASTPIN_PORT_Q, FASTPIN_PORT_K)
+#undef FASTPIN_ACCESS_Q
+#undef FASTPIN_ACCESS_R
+#undef FASTPIN_ACCESS_H
+#undef FASTPIN_ACCESS_K
+#undef FASTPIN_ACCESS_J
+
+#define FASTPIN_VPORT0_PORT  FASTPIN_PORT_D
+#define FASTPIN_VPORT2_PORT  FASTPIN_PORT_C
+#include "port_fastpin_map.h"
+	MAP_CASE("manual", FASTPIN_PORT_D, NONE, FASTPIN_PORT_C, NONE)
+#undef FASTPIN_VPORT0_PORT
+#undef FASTPIN_VPORT2_PORT
+
+#define FASTPIN_VPORT1_PORT  FASTPIN_PORT_R
+#define FASTPIN_ACCESS_A     100
+#include "port_fastpin_map.h"
+	MAP_CASE("manual_first", NONE, FASTPIN_PORT_R, NONE, NONE)
+#undef FASTPIN_VPORT1_PORT
+#undef FASTPIN_ACCESS_A
+};
+
+
+/*! \brief A pin of the pin test. */
+typedef struct TestPin {
+	/*! Name in the output. */
+	const char * name;
+	/*! Pin descriptor. */
+	uint8_t pin;
+	/*! Virtual port of the pin, or FASTPIN_NOT_MAPPED. */
+	uint8_t vport;
+} TestPin_t;
+
+static const TestPin_t testPin[] = {
+	{ "D3", FASTPIN(FASTPIN_PORT_D, 3), 0 },
+	{ "C5", FASTPIN(FASTPIN_PORT_C, 5), 1 },
+	{ "R1", FASTPIN(FASTPIN_PORT_R, 1), 2 },
+	{ "H7", FASTPIN(FASTPIN_PORT_H, 7), 3 },
+	{ "E2", FASTPIN(FASTPIN_PORT_E, 2), FASTPIN_NOT_MAPPED },
+	{ "Q0", FASTPIN(FASTPIN_PORT_Q, 0), FASTPIN_NOT_MAPPED },
+};
+
+/*! \brief Functions under test. */
+typedef enum Op {
+	OP_SET_OUTPUT,
+	OP_SET_INPUT,
+	OP_SET_HIGH,
+	OP_SET_LOW,
+	OP_TOGGLE,
+	OP_GET,
+	OP_GROUP_HIGH,
+	OP_GROUP_LOW,
+	OP_GROUP_TOGGLE,
+	OP_GROUP_WRITE,
+	OP_GROUP_READ,
+	OP_COUNT
+} Op_t;
+
+/*! \brief Description of a function under test. */
+typedef struct OpInfo {
+	/*! Name in the output. */
+	const char * name;
+	/*! true if the function uses the virtual port of a mapped port. */
+	bool usesVport;
+	/*! true for a read, false for a write. */
+	bool read;
+	/*! true for a DIR write, false for an OUT write. */
+	bool dir;
+	/*! Register value before a write. */
+	uint8_t before;
+	/*! Instruction sequence, words and cycles on a virtual port, as listed
+	 *  in port_fastpin.h. */
+	const char * vportCode;
+	uint8_t vportWords;
+	const char * vportCycles;
+	/*! Instruction sequence, words and cycles on the port registers, as
+	 *  listed in port_fastpin.h. */
+	const char * portCode;
+	uint8_t portWords;
+	const char * portCycles;
+} OpInfo_t;
+
+static const OpInfo_t opInfo[OP_COUNT] = {
+	{ "SetOutput", true, false, true, 0x00, "SBI", 1, "1", "LDI+STS_DIRSET", 3, "3" },
+	{ "SetInput", true, false, true, 0xFF, "CBI", 1, "1", "LDI+STS_DIRCLR", 3, "3" },
+	{ "SetHigh", true, false, false, 0x00, "SBI", 1, "1", "LDI+STS_OUTSET", 3, "3" },
+	{ "SetLow", true, false, false, 0xFF, "CBI", 1, "1", "LDI+STS_OUTCLR", 3, "3" },
+	{ "Toggle", false, false, false, 0x5A, "", 0, "", "LDI+STS_OUTTGL", 3, "3" },
+	{ "Get", true, true, false, 0x00, "SBIS/SBIC", 1, "2-4", "LDS+ANDI", 3, "3" },
+	{ "SetGroupHigh", false, false, false, 0x81, "", 0, "", "LDI+STS_OUTSET", 3, "3" },
+	{ "SetGroupLow", false, false, false, 0x7E, "", 0, "", "LDI+STS_OUTCLR", 3, "3" },
+	{ "ToggleGroup", false, false, false, 0x99, "", 0, "", "LDI+STS_OUTTGL", 3, "3" },
+	{ "WriteGroup", false, false, false, 0x99, "", 0, "",
+	  "LDI+STS_OUTCLR+LDI+STS_OUTSET", 6, "6" },
+	{ "ReadGroup", true, true, false, 0x00, "IN+ANDI", 2, "2", "LDS+ANDI", 3, "3" },
+};
+
+/*! Value written by OP_GROUP_WRITE. */
+#define GROUP_VALUE  0x24
+
+
+/*! \brief Port of a port number, looked up without FASTPIN_PORT_REG(). */
+static PORT_t * Test_Port(uint8_t port)
+{
+	switch (port) {
+	case FASTPIN_PORT_A: return &PORTA;
+	case FASTPIN_PORT_B: return &PORTB;
+	case FASTPIN_PORT_C: return &PORTC;
+	case FASTPIN_PORT_D: return &PORTD;
+	case FASTPIN_PORT_E: return &PORTE;
+	case FASTPIN_PORT_F: return &PORTF;
+	case FASTPIN_PORT_H: return &PORTH;
+	case FASTPIN_PORT_J: return &PORTJ;
+	case FASTPIN_PORT_K: return &PORTK;
+	case FASTPIN_PORT_Q: return &PORTQ;
+	default: return &PORTR;
+	}
+}
+
+
+/*! \brief Map all virtual ports to DECOY_PORT. */
+static void Test_MapDecoy(void)
+{
+	PORT_MapVirtualPort0( (PORTCFG_VP0MAP_t) ( DECOY_PORT << PORTCFG_VP0MAP_gp ) );
+	PORT_MapVirtualPort1( (PORTCFG_VP1MAP_t) ( DECOY_PORT << PORTCFG_VP1MAP_gp ) );
+	PORT_MapVirtualPort2( (PORTCFG_VP2MAP_t) ( DECOY_PORT << PORTCFG_VP2MAP_gp ) );
+	PORT_MapVirtualPort3( (PORTCFG_VP3MAP_t) ( DECOY_PORT << PORTCFG_VP3MAP_gp ) );
+}
+
+
+/*! \brief Set the registers of a port before a function is run. */
+static void Test_Prepare(PORT_t * port, const OpInfo_t * info, uint8_t input)
+{
+	SIM_PORT_SetInput(port, input);
+	port->DIR = info->dir ? info->before : (info->read ? 0x00 : 0xFF);
+	port->OUT = info->dir ? 0x00 : info->before;
+}
+
+
+/*! \brief Run a function under test.
+ *
+ *  \return  The value read, or 0 for a write.
+ */
+static uint8_t Test_Run(Op_t op, uint8_t pin, uint8_t mask)
+{
+	uint8_t port = FASTPIN_PORT_OF(pin);
+
+	switch (op) {
+	case OP_SET_OUTPUT: FASTPIN_SetOutput( pin ); break;
+	case OP_SET_INPUT: FASTPIN_SetInput( pin ); break;
+	case OP_SET_HIGH: FASTPIN_SetHigh( pin ); break;
+	case OP_SET_LOW: FASTPIN_SetLow( pin ); break;
+	case OP_TOGGLE: FASTPIN_Toggle( pin ); break;
+	case OP_GET: return FASTPIN_Get( pin ) ? mask : 0;
+	case OP_GROUP_HIGH: FASTPIN_SetGroupHigh( port, mask ); break;
+	case OP_GROUP_LOW: FASTPIN_SetGroupLow( port, mask ); break;
+	case OP_GROUP_TOGGLE: FASTPIN_ToggleGroup( port, mask ); break;
+	case OP_GROUP_WRITE: FASTPIN_WriteGroup( port, mask, GROUP_VALUE ); break;
+	case OP_GROUP_READ: return FASTPIN_ReadGroup( port, mask );
+	default: break;
+	}
+	return 0;
+}
+
+
+/*! \brief Expected register value after a write. */
+static uint8_t Test_Expected(Op_t op, uint8_t before, uint8_t mask)
+{
+	switch (op) {
+	case OP_SET_OUTPUT:
+	case OP_SET_HIGH:
+	case OP_GROUP_HIGH:
+		return before | mask;
+	case OP_SET_INPUT:
+	case OP_SET_LOW:
+	case OP_GROUP_LOW:
+		return before & ~mask;
+	case OP_GROUP_WRITE:
+		return (before & ~mask) | (GROUP_VALUE & mask);
+	default:
+		return before ^ mask;
+	}
+}
+
+
+/*! \brief Run a function once and check that it acted on the target port
+ *         only.
+ *
+ *  \param target  Port the function must act on.
+ *  \param other   Port the function must leave alone.
+ *  \param cycles  Where the CPU cycles of the call are stored.
+ *
+ *  \return  true if the function acted on the target only.
+ */
+static bool Test_Once(Op_t op, uint8_t pin, uint8_t mask, PORT_t * target,
+                      PORT_t * other, uint64_t * cycles)
+{
+	const OpInfo_t * info = &opInfo[op];
+	uint64_t start;
+	uint8_t value;
+
+	Test_Prepare(target, info, mask);
+	Test_Prepare(other, info, 0x00);
+	start = SIM_GetCycles();
+	value = Test_Run(op, pin, mask);
+	*cycles = SIM_GetCycles() - start;
+
+	if (info->read) {
+		return value == mask;
+	}
+	if (info->dir) {
+		return (target->DIR == Test_Expected(op, info->before, mask)) &&
+		       (other->DIR == info->before) && (target->OUT == 0x00) &&
+		       (other->OUT == 0x00);
+	}
+	return (target->OUT == Test_Expected(op, info->before, mask)) &&
+	       (other->OUT == info->before) && (target->DIR == 0xFF) &&
+	       (other->DIR == 0xFF);
+}
+
+
+/*! \brief Check a function on a pin or a group, and print its path and
+ *         code.
+ *
+ *  \param name   Name of the pin or group in the output.
+ *  \param vport  Virtual port of the pin port, or FASTPIN_NOT_MAPPED.
+ *
+ *  \return  true if the check passed.
+ */
+static bool Test_Op(Op_t op, const char * name, uint8_t pin, uint8_t mask, uint8_t vport)
+{
+	const OpInfo_t * info = &opInfo[op];
+	PORT_t * port = Test_Port(FASTPIN_PORT_OF(pin));
+	PORT_t * decoy = Test_Port(DECOY_PORT);
+	bool viaVport = info->usesVport && (vport != FASTPIN_NOT_MAPPED);
+	uint64_t cycles;
+	uint64_t decoyCycles;
+	bool mapped;
+	bool found;
+	bool success;
+
+	/* With the assigned mapping, the pin port changes. */
+	FASTPIN_Init();
+	mapped = Test_Once(op, pin, mask, port, decoy, &cycles);
+
+	/* With every virtual port on the decoy port, the virtual port path
+	 * changes the decoy port instead. */
+	Test_MapDecoy();
+	found = Test_Once(op, pin, mask, viaVport ? decoy : port, viaVport ? port : decoy,
+	                  &decoyCycles);
+	success = mapped && found && (cycles == decoyCycles);
+
+	printf("test=%s function=%s name=%s vport=%d path=%s accesses=%lu "
+	       "listed_code=%s listed_words=%u listed_cycles=%s result=%s\n",
+	       (op >= OP_GROUP_HIGH) ? "group" : "pin",
+	       info->name,
+	       name,
+	       (vport == FASTPIN_NOT_MAPPED) ? -1 : vport,
+	       viaVport ? "vport" : "port",
+	       (unsigned long) (cycles / SIM_CYCLES_PER_ACCESS),
+	       viaVport ? info->vportCode : info->portCode,
+	       viaVport ? info->vportWords : info->portWords,
+	       viaVport ? info->vportCycles : info->portCycles,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Check the assignment cases and report.
+ *
+ *  \return  true if every case passed.
+ */
+static bool Test_Map(void)
+{
+	bool success = true;
+	uint8_t i;
+
+	for (i = 0; i < COUNT(mapCase); i++) {
+		const MapCase_t * c = &mapCase[i];
+		bool ok = memcmp(c->expected, c->mapped, sizeof(c->mapped)) == 0;
+
+		printf("test=map case=%s vport0=%d vport1=%d vport2=%d vport3=%d result=%s\n",
+		       c->name,
+		       (c->mapped[0] == NONE) ? -1 : c->mapped[0],
+		       (c->mapped[1] == NONE) ? -1 : c->mapped[1],
+		       (c->mapped[2] == NONE) ? -1 : c->mapped[2],
+		       (c->mapped[3] == NONE) ? -1 : c->mapped[3],
+		       ok ? "pass" : "fail");
+		success &= ok;
+	}
+	return success;
+}
+
+
+/*! \brief Run the tests and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = Test_Map();
+	uint16_t checks = COUNT(mapCase);
+	uint8_t i;
+	uint8_t op;
+
+	/* The listed_ figures are from port_fastpin.h, not from a disassembly. */
+	printf("listed_source=port_fastpin.h disassembly=none\n");
+	for (i = 0; i < COUNT(testPin); i++) {
+		const TestPin_t * p = &testPin[i];
+
+		for (op = OP_SET_OUTPUT; op <= OP_GET; op++) {
+			success &= Test_Op(op, p->name, p->pin, FASTPIN_MASK_OF(p->pin), p->vport);
+			checks++;
+		}
+	}
+	for (op = OP_GROUP_HIGH; op < OP_COUNT; op++) {
+		success &= Test_Op(op, "D", FASTPIN(FASTPIN_PORT_D, 0), GROUP_MASK, 0);
+		success &= Test_Op(op, "E", FASTPIN(FASTPIN_PORT_E, 0), GROUP_MASK, FASTPIN_NOT_MAPPED);
+		checks += 2;
+	}
+
+	printf("summary checks=%u result=%s\n", checks, success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA debounced pin-change input service source file.
+ *
+ *      This file contains the implementation of the debounced pin-change
+ *      input service. See port_debounce.h for a description of the service.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "port_debounce.h"
+
+/*! The debounce service instance. */
+DEBOUNCE_Service_t DEBOUNCE_service;
+
+
+/*! \brief Post an event to the queue.
+ *
+ *  Only called from the interrupt handlers. The event is dropped and counted
+ *  if the queue is full.
+ *
+ *  \param event  The event to post.
+ */
+static void DEBOUNCE_PostEvent( uint8_t event )
+{
+	uint8_t head = DEBOUNCE_service.queueHead;
+	uint8_t next = ( head + 1 ) & ( DEBOUNCE_QUEUE_SIZE - 1 );
+
+	if ( next == DEBOUNCE_service.queueTail ) {
+		++DEBOUNCE_service.queueOverflows;
+		return;
+	}
+	DEBOUNCE_service.queue[head] = event;
+	DEBOUNCE_service.queueHead = next;
+}
+
+
+/*! \brief Post one event for every pin set in a mask.
+ *
+ *  \param type       Event type, one of the DEBOUNCE_EVENT_ values.
+ *  \param portIndex  Index of the port the pins belong to.
+ *  \param pins       Pins to post events for.
+ */
+static void DEBOUNCE_PostEvents( uint8_t type, uint8_t portIndex, uint8_t pins )
+{
+	uint8_t pin = 0;
+
+	while ( pins != 0 ) {
+		if ( pins & 0x01 ) {
+			DEBOUNCE_PostEvent( type | ( portIndex << 3 ) | pin );
+		}
+		pins >>= 1;
+		++pin;
+	}
+}
+
+
+/*! \brief Initialize the debounce service.
+ *
+ *  This function sets up the shared sampling timer, but does not start it.
+ *  The timer is started by the first pin change. The sampling period should
+ *  be a few milliseconds. A pin change is accepted after four equal samples,
+ *  so the period should be at least a quarter of the longest bounce time.
+ *
+ *  The overflow interrupt of the timer and the pin-change interrupts use
+ *  low level, so the handlers never preempt each other. Interrupts of that
+ *  level must be enabled in the PMIC by the application.
+ *
+ *  \param tc              Timer/Counter used as sampling timer.
+ *  \param clockSelect     Timer clock selection used while sampling.
+ *  \param period          Sampling period in timer clock cycles.
+ *  \param longPressTicks  Number of samples a pin must be held pressed to
+ *                         report a long press, 0 to disable long presses.
+ */
+void DEBOUNCE_Init( TC0_t * tc,
+                    TC_CLKSEL_t clockSelect,
+                    uint16_t period,
+                    uint8_t longPressTicks )
+{
+	DEBOUNCE_service.portCount = 0;
+	DEBOUNCE_service.activePorts = 0;
+	DEBOUNCE_service.tc = tc;
+	DEBOUNCE_service.clockSelect = clockSelect;
+	DEBOUNCE_service.longPressTicks = longPressTicks;
+	DEBOUNCE_service.queueHead = 0;
+	DEBOUNCE_service.queueTail = 0;
+	DEBOUNCE_service.queueOverflows = 0;
+	DEBOUNCE_service.pinWakeups = 0;
+	DEBOUNCE_service.timerWakeups = 0;
+
+	tc->CTRLA = TC_CLKSEL_OFF_gc;
+	tc->PER = period;
+	tc->CNT = 0;
+	tc->INTCTRLA = ( tc->INTCTRLA & ~TC0_OVFINTLVL_gm ) | TC_OVFINTLVL_LO_gc;
+}
+
+
+/*! \brief Add a port to the debounce service.
+ *
+ *  The pins in the mask are configured as inputs sensing both edges, with
+ *  pull-up and inverted input if they are active low. Port interrupt 0 is
+ *  used by the service and must not be used for other pins of the port.
+ *  The application must call DEBOUNCE_PinChangeHandler() from the port
+ *  interrupt 0 handler. The current pin levels are taken as the initial
+ *  state without posting events.
+ *
+ *  \param port       The port to add.
+ *  \param pinMask    The pins to debounce.
+ *  \param activeLow  true if the pins read low when pressed.
+ *
+ *  \return  The port index used in events, or DEBOUNCE_PORT_INVALID if
+ *           DEBOUNCE_MAX_PORTS ports have already been added.
+ */
+uint8_t DEBOUNCE_AddPort( PORT_t * port, uint8_t pinMask, bool activeLow )
+{
+	uint8_t portIndex = DEBOUNCE_service.portCount;
+	DEBOUNCE_Port_t * debouncePort;
+
+	if ( portIndex >= DEBOUNCE_MAX_PORTS ) {
+		return DEBOUNCE_PORT_INVALID;
+	}
+	debouncePort = &DEBOUNCE_service.ports[portIndex];
+
+	PORT_SetPinsAsInput( port, pinMask );
+	PORT_ConfigurePins( port,
+	                    pinMask,
+	                    false,
+	                    activeLow,
+	                    activeLow ? PORT_OPC_PULLUP_gc : PORT_OPC_TOTEM_gc,
+	                    PORT_ISC_BOTHEDGES_gc );
+
+	debouncePort->port = port;
+	debouncePort->mask = pinMask;
+	debouncePort->state = port->IN & pinMask;
+	debouncePort->count0 = 0xFF;
+	debouncePort->count1 = 0xFF;
+	debouncePort->holding = 0;
+
+	port->INTFLAGS = PORT_INT0IF_bm;
+	PORT_ConfigureInterrupt0( port, PORT_INT0LVL_LO_gc, pinMask );
+
+	DEBOUNCE_service.portCount = portIndex + 1;
+	return portIndex;
+}
+
+
+/*! \brief Get the next event from the queue.
+ *
+ *  \param event  Pointer to where the event is stored.
+ *
+ *  \retval true   An event was returned.
+ *  \retval false  The queue is empty.
+ */
+bool DEBOUNCE_GetEvent( uint8_t * event )
+{
+	uint8_t tail = DEBOUNCE_service.queueTail;
+
+	if ( tail == DEBOUNCE_service.queueHead ) {
+		return false;
+	}
+	*event = DEBOUNCE_service.queue[tail];
+	DEBOUNCE_service.queueTail = ( tail + 1 ) & ( DEBOUNCE_QUEUE_SIZE - 1 );
+	return true;
+}
+
+
+/*! \brief Get the debounced state of a port.
+ *
+ *  \param portIndex  Port index returned by DEBOUNCE_AddPort().
+ *
+ *  \return  The debounced pins, a one bit means pressed.
+ */
+uint8_t DEBOUNCE_GetState( uint8_t portIndex )
+{
+	return DEBOUNCE_service.ports[portIndex].state;
+}
+
+
+/*! \brief Get the wakeup counters.
+ *
+ *  The counters are 16 bits wide and changed by the interrupt handlers, so
+ *  they are read with interrupts disabled. Otherwise an interrupt between
+ *  the reads of the low and the high byte could give a wrong count.
+ *
+ *  \param pinWakeups    Pointer to where the number of pin-change
+ *                       interrupts is stored.
+ *  \param timerWakeups  Pointer to where the number of sampling timer
+ *                       interrupts is stored.
+ */
+void DEBOUNCE_GetWakeups( uint16_t * pinWakeups, uint16_t * timerWakeups )
+{
+	AVR_ENTER_CRITICAL_REGION( );
+	*pinWakeups = DEBOUNCE_service.pinWakeups;
+	*timerWakeups = DEBOUNCE_service.timerWakeups;
+	AVR_LEAVE_CRITICAL_REGION( );
+}
+
+
+/*! \brief Pin-change interrupt handler.
+ *
+ *  This function must be called from the port interrupt 0 handler of the
+ *  port. It masks further pin-change interrupts from the port, so bounces
+ *  do not cause an interrupt storm, and starts the sampling timer.
+ *
+ *  \param portIndex  Port index returned by DEBOUNCE_AddPort().
+ */
+void DEBOUNCE_PinChangeHandler( uint8_t portIndex )
+{
+	PORT_t * port = DEBOUNCE_service.ports[portIndex].port;
+	TC0_t * tc = DEBOUNCE_service.tc;
+
+	++DEBOUNCE_service.pinWakeups;
+	port->INTCTRL &= ~PORT_INT0LVL_gm;
+
+	if ( DEBOUNCE_service.activePorts == 0 ) {
+		tc->CNT = 0;
+		tc->CTRLA = DEBOUNCE_service.clockSelect;
+	}
+	DEBOUNCE_service.activePorts |= ( 1 << portIndex );
+}
+
+
+/*! \brief Sample and debounce one port.
+ *
+ *  The vertical counter is made of the bits count1:count0 of each pin. It
+ *  stays at 3 while the sample equals the debounced state, and counts down
+ *  on every sample that differs. A pin changes state when its counter wraps
+ *  from 0, that is on the fourth differing sample in a row. Any equal
+ *  sample in between resets the counter.
+ *
+ *  \param portIndex  Index of the port to sample.
+ *
+ *  \return  true if the port still needs to be sampled.
+ */
+static bool DEBOUNCE_SamplePort( uint8_t portIndex )
+{
+	DEBOUNCE_Port_t * debouncePort = &DEBOUNCE_service.ports[portIndex];
+	PORT_t * port = debouncePort->port;
+	uint8_t delta = ( port->IN & debouncePort->mask ) ^ debouncePort->state;
+	uint8_t changed;
+	uint8_t pressed;
+	uint8_t holding;
+	uint8_t pin;
+
+	debouncePort->count0 = ~( debouncePort->count0 & delta );
+	debouncePort->count1 = debouncePort->count0 ^ ( debouncePort->count1 & delta );
+	changed = delta & debouncePort->count0 & debouncePort->count1;
+	debouncePort->state ^= changed;
+
+	pressed = changed & debouncePort->state;
+	DEBOUNCE_PostEvents( DEBOUNCE_EVENT_PRESS, portIndex, pressed );
+	DEBOUNCE_PostEvents( DEBOUNCE_EVENT_RELEASE, portIndex, changed & ~pressed );
+
+	/* Time the pressed pins until they report a long press or are released. */
+	holding = debouncePort->holding & debouncePort->state;
+	if ( DEBOUNCE_service.longPressTicks != 0 ) {
+		holding |= pressed;
+	}
+	for ( pin = 0; pin < 8; ++pin ) {
+		uint8_t pinMask = 1 << pin;
+		if ( pressed & pinMask ) {
+			debouncePort->holdTicks[pin] = 0;
+		}
+		if ( holding & pinMask ) {
+			if ( ++debouncePort->holdTicks[pin] >= DEBOUNCE_service.longPressTicks ) {
+				DEBOUNCE_PostEvent( DEBOUNCE_EVENT_LONGPRESS | ( portIndex << 3 ) | pin );
+				holding &= ~pinMask;
+			}
+		}
+	}
+	debouncePort->holding = holding;
+
+	if ( ( delta & ~changed ) != 0 || holding != 0 ) {
+		return true;
+	}
+
+	/* All pins are stable. Arm the pin-change interrupt again, and check
+	 * for a change that happened after the sample was taken, since its
+	 * interrupt flag was just cleared.
+	 */
+	port->INTFLAGS = PORT_INT0IF_bm;
+	port->INTCTRL = ( port->INTCTRL & ~PORT_INT0LVL_gm ) | PORT_INT0LVL_LO_gc;
+	if ( ( ( port->IN & debouncePort->mask ) ^ debouncePort->state ) != 0 ) {
+		port->INTCTRL &= ~PORT_INT0LVL_gm;
+		return true;
+	}
+	return false;
+}
+
+
+/*! \brief Sampling timer interrupt handler.
+ *
+ *  This function must be called from the overflow interrupt handler of the
+ *  sampling timer. It samples all active ports, and stops the timer when
+ *  all pins are stable.
+ */
+void DEBOUNCE_TimerHandler( void )
+{
+	uint8_t activePorts = DEBOUNCE_service.activePorts;
+	uint8_t portIndex;
+
+	++DEBOUNCE_service.timerWakeups;
+
+	for ( portIndex = 0; portIndex < DEBOUNCE_service.portCount; ++portIndex ) {
+		uint8_t portBit = 1 << portIndex;
+		if ( ( activePorts & portBit ) && !DEBOUNCE_SamplePort( portIndex ) ) {
+			activePorts &= ~portBit;
+		}
+	}
+
+	DEBOUNCE_service.activePorts = activePorts;
+	if ( activePorts == 0 ) {
+		DEBOUNCE_service.tc->CTRLA = TC_CLKSEL_OFF_gc;
+	}
+}
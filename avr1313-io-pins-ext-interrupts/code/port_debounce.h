@@ -0,0 +1,173 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA debounced pin-change input service header file.
+ *
+ *      This file contains the function prototypes and definitions for a
+ *      service that debounces switches and contacts on up to four ports. The
+ *      pin-change interrupt of a port is only used to start a shared sampling
+ *      timer. The timer interrupt samples all pins of the port at once and
+ *      debounces them with a two-bit vertical counter, so a pin must read the
+ *      same level on four consecutive samples before the change is accepted.
+ *      Accepted changes are posted as press, release and long-press events to
+ *      a queue. When all pins are stable, the timer is stopped and the
+ *      pin-change interrupts are armed again, so the CPU can sleep between
+ *      transitions.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef PORT_DEBOUNCE_H
+#define PORT_DEBOUNCE_H
+
+#include "avr_compiler.h"
+#include "port_driver.h"
+
+/* Definition of macros. */
+
+/*! Maximum number of ports handled by the service. */
+#define DEBOUNCE_MAX_PORTS        4
+
+/*! Size of the event queue. Must be a power of two. */
+#define DEBOUNCE_QUEUE_SIZE       16
+
+/*! Returned by DEBOUNCE_AddPort() when no port slot is free. */
+#define DEBOUNCE_PORT_INVALID     0xFF
+
+/*! \name Event types.
+ *
+ *  An event is one byte holding the event type in bit 7:6, the port index
+ *  returned by DEBOUNCE_AddPort() in bit 4:3 and the pin number in bit 2:0.
+ */
+/*@{*/
+#define DEBOUNCE_EVENT_PRESS      0x40
+#define DEBOUNCE_EVENT_RELEASE    0x80
+#define DEBOUNCE_EVENT_LONGPRESS  0xC0
+/*@}*/
+
+/*! Event type of an event, one of the DEBOUNCE_EVENT_ values. */
+#define DEBOUNCE_EventType( _event )   ( (_event) & 0xC0 )
+
+/*! Port index of an event. */
+#define DEBOUNCE_EventPort( _event )   ( ( (_event) >> 3 ) & 0x03 )
+
+/*! Pin number of an event. */
+#define DEBOUNCE_EventPin( _event )    ( (_event) & 0x07 )
+
+/*! \brief This macro returns true while the sampling timer is stopped.
+ *
+ *  All pins are then stable and waiting for a pin-change interrupt, so the
+ *  device may enter a sleep mode where the peripheral clock is stopped.
+ *  While the timer runs, only Idle sleep mode can be used.
+ */
+#define DEBOUNCE_IsIdle()              ( DEBOUNCE_service.activePorts == 0 )
+
+
+/*! \brief Debounce state of one port. */
+typedef struct DEBOUNCE_Port_struct {
+	/*! The port being debounced. */
+	PORT_t * port;
+	/*! Pins of the port handled by the service. */
+	uint8_t mask;
+	/*! Debounced pin states, a one bit means pressed. */
+	uint8_t state;
+	/*! Low bit of the vertical counters. */
+	uint8_t count0;
+	/*! High bit of the vertical counters. */
+	uint8_t count1;
+	/*! Pressed pins that have not yet reported a long press. */
+	uint8_t holding;
+	/*! Number of samples each pin has been held pressed. */
+	uint8_t holdTicks[8];
+} DEBOUNCE_Port_t;
+
+
+/*! \brief Debounce service.
+ *
+ *  There is one instance of the service, since all ports share the same
+ *  sampling timer.
+ */
+typedef struct DEBOUNCE_Service_struct {
+	/*! Ports handled by the service. */
+	DEBOUNCE_Port_t ports[DEBOUNCE_MAX_PORTS];
+	/*! Number of ports added. */
+	uint8_t portCount;
+	/*! Bit n is set while port n is sampled by the timer. */
+	volatile uint8_t activePorts;
+	/*! Shared sampling timer. */
+	TC0_t * tc;
+	/*! Clock selection used when the sampling timer is started. */
+	TC_CLKSEL_t clockSelect;
+	/*! Samples a pin must be held to report a long press. */
+	uint8_t longPressTicks;
+	/*! Event queue, written by the interrupt handlers. */
+	volatile uint8_t queue[DEBOUNCE_QUEUE_SIZE];
+	/*! Queue write index, only changed by the interrupt handlers. */
+	volatile uint8_t queueHead;
+	/*! Queue read index, only changed by DEBOUNCE_GetEvent(). */
+	volatile uint8_t queueTail;
+	/*! Number of events lost because the queue was full. */
+	volatile uint8_t queueOverflows;
+	/*! Number of pin-change interrupts, i.e. wakeups caused by the pins.
+	 *  Read with DEBOUNCE_GetWakeups(). */
+	volatile uint16_t pinWakeups;
+	/*! Number of sampling timer interrupts. Read with DEBOUNCE_GetWakeups(). */
+	volatile uint16_t timerWakeups;
+} DEBOUNCE_Service_t;
+
+
+extern DEBOUNCE_Service_t DEBOUNCE_service;
+
+
+/* Prototyping of functions. */
+
+void DEBOUNCE_Init( TC0_t * tc,
+                    TC_CLKSEL_t clockSelect,
+                    uint16_t period,
+                    uint8_t longPressTicks );
+uint8_t DEBOUNCE_AddPort( PORT_t * port, uint8_t pinMask, bool activeLow );
+bool DEBOUNCE_GetEvent( uint8_t * event );
+uint8_t DEBOUNCE_GetState( uint8_t portIndex );
+void DEBOUNCE_GetWakeups( uint16_t * pinWakeups, uint16_t * timerWakeups );
+void DEBOUNCE_PinChangeHandler( uint8_t portIndex );
+void DEBOUNCE_TimerHandler( void );
+
+#endif
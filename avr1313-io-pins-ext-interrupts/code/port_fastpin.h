@@ -0,0 +1,357 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA fast-path pin access through virtual ports.
+ *
+ *      This file contains inline functions and macros for single-instruction
+ *      access to individual I/O pins. A pin is described by a compile-time
+ *      constant made from its port and bit number, see FASTPIN(). The
+ *      application gives the number of accesses to each port, and the four
+ *      most accessed ports are assigned to the virtual ports at compile time,
+ *      see port_fastpin_map.h. FASTPIN_Init() maps them. Accesses to pins on
+ *      a mapped port compile to
+ *      SBI, CBI, SBIS or SBIC instructions, while pins on other ports fall
+ *      back to the atomic OUTSET, OUTCLR and OUTTGL registers.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef PORT_FASTPIN_H
+#define PORT_FASTPIN_H
+
+#include "avr_compiler.h"
+#include "port_driver.h"
+
+/* Definition of macros. */
+
+/*! \name Port numbers.
+ *
+ *  The port number is the position of the port in the I/O memory map, which
+ *  is also the value written to the virtual port mapping registers.
+ */
+/*@{*/
+#define FASTPIN_PORT_A      0
+#define FASTPIN_PORT_B      1
+#define FASTPIN_PORT_C      2
+#define FASTPIN_PORT_D      3
+#define FASTPIN_PORT_E      4
+#define FASTPIN_PORT_F      5
+#define FASTPIN_PORT_H      7
+#define FASTPIN_PORT_J      8
+#define FASTPIN_PORT_K      9
+#define FASTPIN_PORT_Q      14
+#define FASTPIN_PORT_R      15
+/*! Marks an unused virtual port slot. */
+#define FASTPIN_PORT_NONE   0xFF
+/*@}*/
+
+/* Virtual port assignment. The application defines FASTPIN_ACCESS_A to
+ * FASTPIN_ACCESS_R, or FASTPIN_VPORT0_PORT to FASTPIN_VPORT3_PORT, before
+ * this file is included (or on the compiler command line). The same
+ * assignment must be seen by every source file using this header.
+ */
+#include "port_fastpin_map.h"
+
+/*! Returned by FASTPIN_VPORT_INDEX() for a port without a virtual port. */
+#define FASTPIN_NOT_MAPPED  0xFF
+
+/*! \brief Create a pin descriptor.
+ *
+ *  \param _port  Port number, e.g. FASTPIN_PORT_D.
+ *  \param _bit   Bit number in the port, 0 to 7.
+ */
+#define FASTPIN( _port, _bit )       ( (uint8_t) ( ( (_port) << 3 ) | (_bit) ) )
+
+/*! Port number of a pin descriptor. */
+#define FASTPIN_PORT_OF( _pin )      ( (uint8_t) ( (_pin) >> 3 ) )
+
+/*! Bit mask of a pin descriptor. */
+#define FASTPIN_MASK_OF( _pin )      ( (uint8_t) ( 1 << ( (_pin) & 0x07 ) ) )
+
+/*! Pointer to the PORT_t of a port number. The ports are 0x20 bytes apart,
+ *  more than the size of PORT_t. */
+#define FASTPIN_PORT_REG( _port )    ( (PORT_t *) ( (uintptr_t) &PORTA + (_port) * 0x20 ) )
+
+/*! Pointer to virtual port _index. The virtual ports are 4 bytes apart. */
+#define FASTPIN_VPORT_REG( _index )  ( (VPORT_t *) &VPORT0 + (_index) )
+
+/*! \brief Virtual port a port number is mapped to.
+ *
+ *  \param _port  Port number, e.g. FASTPIN_PORT_D.
+ *
+ *  \return  0 to 3, or FASTPIN_NOT_MAPPED.
+ */
+#define FASTPIN_VPORT_INDEX( _port )                       \
+	( ( (_port) == FASTPIN_VPORT0_MAPPED ) ? 0 :       \
+	  ( (_port) == FASTPIN_VPORT1_MAPPED ) ? 1 :       \
+	  ( (_port) == FASTPIN_VPORT2_MAPPED ) ? 2 :       \
+	  ( (_port) == FASTPIN_VPORT3_MAPPED ) ? 3 :       \
+	  FASTPIN_NOT_MAPPED )
+
+
+/*! \brief Map the assigned ports to the virtual ports.
+ *
+ *  This function must be called once, before any of the other functions in
+ *  this file are used on a pin of an assigned port.
+ */
+INLINE void FASTPIN_Init( void )
+{
+#if FASTPIN_VPORT0_MAPPED != FASTPIN_PORT_NONE
+	PORT_MapVirtualPort0( (PORTCFG_VP0MAP_t) ( FASTPIN_VPORT0_MAPPED << PORTCFG_VP0MAP_gp ) );
+#endif
+#if FASTPIN_VPORT1_MAPPED != FASTPIN_PORT_NONE
+	PORT_MapVirtualPort1( (PORTCFG_VP1MAP_t) ( FASTPIN_VPORT1_MAPPED << PORTCFG_VP1MAP_gp ) );
+#endif
+#if FASTPIN_VPORT2_MAPPED != FASTPIN_PORT_NONE
+	PORT_MapVirtualPort2( (PORTCFG_VP2MAP_t) ( FASTPIN_VPORT2_MAPPED << PORTCFG_VP2MAP_gp ) );
+#endif
+#if FASTPIN_VPORT3_MAPPED != FASTPIN_PORT_NONE
+	PORT_MapVirtualPort3( (PORTCFG_VP3MAP_t) ( FASTPIN_VPORT3_MAPPED << PORTCFG_VP3MAP_gp ) );
+#endif
+}
+
+
+/*  The functions below are meant to be called with a constant pin
+ *  descriptor, so that the compiler resolves the port lookup and keeps a
+ *  single instruction. Size in words and XMEGA cycles, worked out by hand
+ *  from the instruction set rather than taken from a disassembly:
+ *
+ *  Function             Mapped port           Other port
+ *  FASTPIN_SetHigh()    SBI          1w 1c    LDI + STS OUTSET  3w 3c
+ *  FASTPIN_SetLow()     CBI          1w 1c    LDI + STS OUTCLR  3w 3c
+ *  FASTPIN_Toggle()     LDI + STS OUTTGL 3w 3c (no toggle on a virtual port)
+ *  FASTPIN_Get()        SBIS/SBIC    1w 2-4c  LDS + ANDI        3w 3c
+ *  FASTPIN_SetOutput()  SBI          1w 1c    LDI + STS DIRSET  3w 3c
+ *  FASTPIN_SetInput()   CBI          1w 1c    LDI + STS DIRCLR  3w 3c
+ *
+ *  FASTPIN_Get() gives SBIS/SBIC when used as a condition. The host test,
+ *  host_sim/fastpin_map.c, checks which port each function accesses and
+ *  prints the listed figures of the path taken next to its results.
+ *
+ *  SBI, CBI, SBIS and SBIC are single-word instructions and are atomic, so
+ *  the pins can be shared with interrupt handlers. With a pin descriptor
+ *  that is not a compile-time constant, the mapped port case becomes a
+ *  read-modify-write of VPORTn.OUT, which is not interrupt safe.
+ */
+
+/*! \brief Drive a pin high.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ */
+INLINE void FASTPIN_SetHigh( uint8_t pin )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( FASTPIN_PORT_OF( pin ) );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		FASTPIN_VPORT_REG( vport )->OUT |= FASTPIN_MASK_OF( pin );
+	} else {
+		FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->OUTSET = FASTPIN_MASK_OF( pin );
+	}
+}
+
+
+/*! \brief Drive a pin low.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ */
+INLINE void FASTPIN_SetLow( uint8_t pin )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( FASTPIN_PORT_OF( pin ) );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		FASTPIN_VPORT_REG( vport )->OUT &= (uint8_t) ~FASTPIN_MASK_OF( pin );
+	} else {
+		FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->OUTCLR = FASTPIN_MASK_OF( pin );
+	}
+}
+
+
+/*! \brief Drive a pin to the given level.
+ *
+ *  \param pin    Pin descriptor, see FASTPIN().
+ *  \param level  true for high, false for low.
+ */
+INLINE void FASTPIN_Set( uint8_t pin, bool level )
+{
+	if ( level ) {
+		FASTPIN_SetHigh( pin );
+	} else {
+		FASTPIN_SetLow( pin );
+	}
+}
+
+
+/*! \brief Toggle the output level of a pin.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ */
+INLINE void FASTPIN_Toggle( uint8_t pin )
+{
+	FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->OUTTGL = FASTPIN_MASK_OF( pin );
+}
+
+
+/*! \brief Read the input level of a pin.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ *
+ *  \return  true if the pin is high.
+ */
+INLINE bool FASTPIN_Get( uint8_t pin )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( FASTPIN_PORT_OF( pin ) );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		return ( FASTPIN_VPORT_REG( vport )->IN & FASTPIN_MASK_OF( pin ) ) != 0;
+	} else {
+		return ( FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->IN & FASTPIN_MASK_OF( pin ) ) != 0;
+	}
+}
+
+
+/*! \brief Configure a pin as output.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ */
+INLINE void FASTPIN_SetOutput( uint8_t pin )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( FASTPIN_PORT_OF( pin ) );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		FASTPIN_VPORT_REG( vport )->DIR |= FASTPIN_MASK_OF( pin );
+	} else {
+		FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->DIRSET = FASTPIN_MASK_OF( pin );
+	}
+}
+
+
+/*! \brief Configure a pin as input.
+ *
+ *  \param pin  Pin descriptor, see FASTPIN().
+ */
+INLINE void FASTPIN_SetInput( uint8_t pin )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( FASTPIN_PORT_OF( pin ) );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		FASTPIN_VPORT_REG( vport )->DIR &= (uint8_t) ~FASTPIN_MASK_OF( pin );
+	} else {
+		FASTPIN_PORT_REG( FASTPIN_PORT_OF( pin ) )->DIRCLR = FASTPIN_MASK_OF( pin );
+	}
+}
+
+
+/*  The group functions below change several pins of one port in a single
+ *  write. They always use the OUTSET, OUTCLR and OUTTGL registers, since a
+ *  multi-bit update of VPORTn.OUT would be a read-modify-write.
+ */
+
+/*! \brief Drive a group of pins on one port high.
+ *
+ *  \param port  Port number, e.g. FASTPIN_PORT_D.
+ *  \param mask  Bit mask of the pins to set.
+ */
+INLINE void FASTPIN_SetGroupHigh( uint8_t port, uint8_t mask )
+{
+	FASTPIN_PORT_REG( port )->OUTSET = mask;
+}
+
+
+/*! \brief Drive a group of pins on one port low.
+ *
+ *  \param port  Port number, e.g. FASTPIN_PORT_D.
+ *  \param mask  Bit mask of the pins to clear.
+ */
+INLINE void FASTPIN_SetGroupLow( uint8_t port, uint8_t mask )
+{
+	FASTPIN_PORT_REG( port )->OUTCLR = mask;
+}
+
+
+/*! \brief Toggle a group of pins on one port.
+ *
+ *  \param port  Port number, e.g. FASTPIN_PORT_D.
+ *  \param mask  Bit mask of the pins to toggle.
+ */
+INLINE void FASTPIN_ToggleGroup( uint8_t port, uint8_t mask )
+{
+	FASTPIN_PORT_REG( port )->OUTTGL = mask;
+}
+
+
+/*! \brief Write a value to a group of pins on one port.
+ *
+ *  The pins outside the mask are not changed. The write is done as one
+ *  OUTCLR and one OUTSET access, so the pins in the mask that are to be
+ *  cleared change one cycle before the pins that are to be set.
+ *
+ *  \param port   Port number, e.g. FASTPIN_PORT_D.
+ *  \param mask   Bit mask of the pins to write.
+ *  \param value  New pin levels. Bits outside the mask are ignored.
+ */
+INLINE void FASTPIN_WriteGroup( uint8_t port, uint8_t mask, uint8_t value )
+{
+	PORT_t * portReg = FASTPIN_PORT_REG( port );
+
+	portReg->OUTCLR = mask & (uint8_t) ~value;
+	portReg->OUTSET = mask & value;
+}
+
+
+/*! \brief Read a group of pins on one port.
+ *
+ *  \param port  Port number, e.g. FASTPIN_PORT_D.
+ *  \param mask  Bit mask of the pins to read.
+ *
+ *  \return  The input levels of the pins in the mask.
+ */
+INLINE uint8_t FASTPIN_ReadGroup( uint8_t port, uint8_t mask )
+{
+	uint8_t vport = FASTPIN_VPORT_INDEX( port );
+
+	if ( vport != FASTPIN_NOT_MAPPED ) {
+		return FASTPIN_VPORT_REG( vport )->IN & mask;
+	} else {
+		return FASTPIN_PORT_REG( port )->IN & mask;
+	}
+}
+
+#endif
@@ -0,0 +1,269 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA fast-path pin access: virtual port assignment.
+ *
+ *      This file assigns ports to the four virtual ports at compile time, for
+ *      port_fastpin.h, which includes it. The result is FASTPIN_VPORT0_MAPPED
+ *      to FASTPIN_VPORT3_MAPPED, the port number given to each virtual port,
+ *      or FASTPIN_PORT_NONE for a virtual port that is left alone.
+ *
+ *      The assignment is automatic unless one of FASTPIN_VPORT0_PORT to
+ *      FASTPIN_VPORT3_PORT is defined. The application then defines
+ *      FASTPIN_ACCESS_A to FASTPIN_ACCESS_R to the number of single pin
+ *      accesses to each port, in any unit, for instance per millisecond in
+ *      its busiest state. The four ports with the most accesses are mapped,
+ *      most accessed first, and of ports with as many accesses the one with
+ *      the lower port number goes first. Ports with no FASTPIN_ACCESS_x, or
+ *      with zero, are never mapped.
+ *
+ *      With FASTPIN_VPORTn_PORT defined, the assignment is manual: each
+ *      virtual port gets the port given, and the others are left alone.
+ *
+ *      The file has no include guard, so that the host test can include it
+ *      once for each assignment it checks. The port numbers, FASTPIN_PORT_A
+ *      to FASTPIN_PORT_NONE, must be defined first.
+ *
+ * \par Application note:
+ *      AVR1313: Using the XMEGA I/O Pins and External Interrupts
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#undef FASTPIN_VPORT0_MAPPED
+#undef FASTPIN_VPORT1_MAPPED
+#undef FASTPIN_VPORT2_MAPPED
+#undef FASTPIN_VPORT3_MAPPED
+
+/*! \brief Non-zero if port _q goes before port _p in the automatic
+ *         assignment. Only used in preprocessor conditions.
+ */
+#define FASTPIN_AHEAD( _q, _qAccess, _p, _pAccess ) \
+	( ( (_qAccess) > (_pAccess) ) || \
+	  ( ( (_qAccess) == (_pAccess) ) && ( (_q) < (_p) ) ) )
+
+/*! \brief Number of ports going before port _p in the automatic assignment,
+ *         which is the virtual port it gets if below four.
+ */
+#define FASTPIN_RANK( _p, _pAccess ) \
+	( FASTPIN_AHEAD( FASTPIN_PORT_A, FASTPIN_ACCESS_A, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_B, FASTPIN_ACCESS_B, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_C, FASTPIN_ACCESS_C, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_D, FASTPIN_ACCESS_D, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_E, FASTPIN_ACCESS_E, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_F, FASTPIN_ACCESS_F, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_H, FASTPIN_ACCESS_H, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_J, FASTPIN_ACCESS_J, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_K, FASTPIN_ACCESS_K, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_Q, FASTPIN_ACCESS_Q, _p, _pAccess ) + \
+	  FASTPIN_AHEAD( FASTPIN_PORT_R, FASTPIN_ACCESS_R, _p, _pAccess ) )
+
+#if defined( FASTPIN_VPORT0_PORT ) || defined( FASTPIN_VPORT1_PORT ) || \
+    defined( FASTPIN_VPORT2_PORT ) || defined( FASTPIN_VPORT3_PORT )
+
+/* Manual assignment. */
+#ifdef FASTPIN_VPORT0_PORT
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_VPORT0_PORT
+#endif
+#ifdef FASTPIN_VPORT1_PORT
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_VPORT1_PORT
+#endif
+#ifdef FASTPIN_VPORT2_PORT
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_VPORT2_PORT
+#endif
+#ifdef FASTPIN_VPORT3_PORT
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_VPORT3_PORT
+#endif
+
+#else
+
+/* Automatic assignment. An undefined FASTPIN_ACCESS_x counts as zero in
+ * the conditions below.
+ */
+#if FASTPIN_ACCESS_A > 0
+#if FASTPIN_RANK( FASTPIN_PORT_A, FASTPIN_ACCESS_A ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_A
+#elif FASTPIN_RANK( FASTPIN_PORT_A, FASTPIN_ACCESS_A ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_A
+#elif FASTPIN_RANK( FASTPIN_PORT_A, FASTPIN_ACCESS_A ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_A
+#elif FASTPIN_RANK( FASTPIN_PORT_A, FASTPIN_ACCESS_A ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_A
+#endif
+#endif
+#if FASTPIN_ACCESS_B > 0
+#if FASTPIN_RANK( FASTPIN_PORT_B, FASTPIN_ACCESS_B ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_B
+#elif FASTPIN_RANK( FASTPIN_PORT_B, FASTPIN_ACCESS_B ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_B
+#elif FASTPIN_RANK( FASTPIN_PORT_B, FASTPIN_ACCESS_B ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_B
+#elif FASTPIN_RANK( FASTPIN_PORT_B, FASTPIN_ACCESS_B ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_B
+#endif
+#endif
+#if FASTPIN_ACCESS_C > 0
+#if FASTPIN_RANK( FASTPIN_PORT_C, FASTPIN_ACCESS_C ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_C
+#elif FASTPIN_RANK( FASTPIN_PORT_C, FASTPIN_ACCESS_C ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_C
+#elif FASTPIN_RANK( FASTPIN_PORT_C, FASTPIN_ACCESS_C ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_C
+#elif FASTPIN_RANK( FASTPIN_PORT_C, FASTPIN_ACCESS_C ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_C
+#endif
+#endif
+#if FASTPIN_ACCESS_D > 0
+#if FASTPIN_RANK( FASTPIN_PORT_D, FASTPIN_ACCESS_D ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_D
+#elif FASTPIN_RANK( FASTPIN_PORT_D, FASTPIN_ACCESS_D ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_D
+#elif FASTPIN_RANK( FASTPIN_PORT_D, FASTPIN_ACCESS_D ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_D
+#elif FASTPIN_RANK( FASTPIN_PORT_D, FASTPIN_ACCESS_D ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_D
+#endif
+#endif
+#if FASTPIN_ACCESS_E > 0
+#if FASTPIN_RANK( FASTPIN_PORT_E, FASTPIN_ACCESS_E ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_E
+#elif FASTPIN_RANK( FASTPIN_PORT_E, FASTPIN_ACCESS_E ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_E
+#elif FASTPIN_RANK( FASTPIN_PORT_E, FASTPIN_ACCESS_E ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_E
+#elif FASTPIN_RANK( FASTPIN_PORT_E, FASTPIN_ACCESS_E ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_E
+#endif
+#endif
+#if FASTPIN_ACCESS_F > 0
+#if FASTPIN_RANK( FASTPIN_PORT_F, FASTPIN_ACCESS_F ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_F
+#elif FASTPIN_RANK( FASTPIN_PORT_F, FASTPIN_ACCESS_F ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_F
+#elif FASTPIN_RANK( FASTPIN_PORT_F, FASTPIN_ACCESS_F ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_F
+#elif FASTPIN_RANK( FASTPIN_PORT_F, FASTPIN_ACCESS_F ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_F
+#endif
+#endif
+#if FASTPIN_ACCESS_H > 0
+#if FASTPIN_RANK( FASTPIN_PORT_H, FASTPIN_ACCESS_H ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_H
+#elif FASTPIN_RANK( FASTPIN_PORT_H, FASTPIN_ACCESS_H ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_H
+#elif FASTPIN_RANK( FASTPIN_PORT_H, FASTPIN_ACCESS_H ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_H
+#elif FASTPIN_RANK( FASTPIN_PORT_H, FASTPIN_ACCESS_H ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_H
+#endif
+#endif
+#if FASTPIN_ACCESS_J > 0
+#if FASTPIN_RANK( FASTPIN_PORT_J, FASTPIN_ACCESS_J ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_J
+#elif FASTPIN_RANK( FASTPIN_PORT_J, FASTPIN_ACCESS_J ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_J
+#elif FASTPIN_RANK( FASTPIN_PORT_J, FASTPIN_ACCESS_J ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_J
+#elif FASTPIN_RANK( FASTPIN_PORT_J, FASTPIN_ACCESS_J ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_J
+#endif
+#endif
+#if FASTPIN_ACCESS_K > 0
+#if FASTPIN_RANK( FASTPIN_PORT_K, FASTPIN_ACCESS_K ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_K
+#elif FASTPIN_RANK( FASTPIN_PORT_K, FASTPIN_ACCESS_K ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_K
+#elif FASTPIN_RANK( FASTPIN_PORT_K, FASTPIN_ACCESS_K ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_K
+#elif FASTPIN_RANK( FASTPIN_PORT_K, FASTPIN_ACCESS_K ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_K
+#endif
+#endif
+#if FASTPIN_ACCESS_Q > 0
+#if FASTPIN_RANK( FASTPIN_PORT_Q, FASTPIN_ACCESS_Q ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_Q
+#elif FASTPIN_RANK( FASTPIN_PORT_Q, FASTPIN_ACCESS_Q ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_Q
+#elif FASTPIN_RANK( FASTPIN_PORT_Q, FASTPIN_ACCESS_Q ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_Q
+#elif FASTPIN_RANK( FASTPIN_PORT_Q, FASTPIN_ACCESS_Q ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_Q
+#endif
+#endif
+#if FASTPIN_ACCESS_R > 0
+#if FASTPIN_RANK( FASTPIN_PORT_R, FASTPIN_ACCESS_R ) == 0
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_R
+#elif FASTPIN_RANK( FASTPIN_PORT_R, FASTPIN_ACCESS_R ) == 1
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_R
+#elif FASTPIN_RANK( FASTPIN_PORT_R, FASTPIN_ACCESS_R ) == 2
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_R
+#elif FASTPIN_RANK( FASTPIN_PORT_R, FASTPIN_ACCESS_R ) == 3
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_R
+#endif
+#endif
+
+#endif
+
+#ifndef FASTPIN_VPORT0_MAPPED
+#define FASTPIN_VPORT0_MAPPED  FASTPIN_PORT_NONE
+#endif
+#ifndef FASTPIN_VPORT1_MAPPED
+#define FASTPIN_VPORT1_MAPPED  FASTPIN_PORT_NONE
+#endif
+#ifndef FASTPIN_VPORT2_MAPPED
+#define FASTPIN_VPORT2_MAPPED  FASTPIN_PORT_NONE
+#endif
+#ifndef FASTPIN_VPORT3_MAPPED
+#define FASTPIN_VPORT3_MAPPED  FASTPIN_PORT_NONE
+#endif
+
+#if ( FASTPIN_VPORT0_MAPPED != FASTPIN_PORT_NONE ) && \
+    ( ( FASTPIN_VPORT0_MAPPED == FASTPIN_VPORT1_MAPPED ) || \
+      ( FASTPIN_VPORT0_MAPPED == FASTPIN_VPORT2_MAPPED ) || \
+      ( FASTPIN_VPORT0_MAPPED == FASTPIN_VPORT3_MAPPED ) )
+#error "FASTPIN_VPORT0_PORT is assigned to more than one virtual port."
+#endif
+#if ( FASTPIN_VPORT1_MAPPED != FASTPIN_PORT_NONE ) && \
+    ( ( FASTPIN_VPORT1_MAPPED == FASTPIN_VPORT2_MAPPED ) || \
+      ( FASTPIN_VPORT1_MAPPED == FASTPIN_VPORT3_MAPPED ) )
+#error "FASTPIN_VPORT1_PORT is assigned to more than one virtual port."
+#endif
+#if ( FASTPIN_VPORT2_MAPPED != FASTPIN_PORT_NONE ) && \
+    ( FASTPIN_VPORT2_MAPPED == FASTPIN_VPORT3_MAPPED )
+#error "FASTPIN_VPORT2_PORT is assigned to more than one virtual port."
+#endif
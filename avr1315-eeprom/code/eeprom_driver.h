@@ -109,8 +109,10 @@
  *  NVM.CTRLA register.
  *
  *  \note The CMDEX bit must be set within 4 clock cycles after setting the
- *        protection byte in the CCP register.
+ *        protection byte in the CCP register. Other targets, such as a host
+ *        simulation, have no timing to meet and write the registers in C.
  */
+#if defined( __ICCAVR__ ) || defined( __AVR__ )
 #define NVM_EXEC()	asm("push r30"      "\n\t"	\
 			    "push r31"      "\n\t"	\
     			    "push r16"      "\n\t"	\
@@ -126,6 +128,12 @@
 			    "pop r31"       "\n\t"	\
 			    "pop r30"       "\n\t"	\
 			    )
+#else
+#define NVM_EXEC()	do {					\
+				CCP = CCP_IOREG_gc;		\
+				NVM.CTRLA = NVM_CMDEX_bm;	\
+			} while (0)
+#endif
 
 /* Prototyping of functions. */
 void EEPROM_WriteByte( uint8_t pageAddr, uint8_t byteAddr, uint8_t value );
@@ -0,0 +1,340 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host test of the XMEGA EEPROM driver.
+ *
+ *      This program runs the EEPROM driver on the host simulator, with the
+ *      page buffer, the commands and the busy time of the NVM controller.
+ *
+ *      Scenarios:
+ *        - byte: EEPROM_WriteByte and EEPROM_ReadByte on the bytes of the
+ *          example. The atomic write must keep NVMBUSY set for the erase and
+ *          write time.
+ *        - split: EEPROM_LoadPage, EEPROM_ErasePage and EEPROM_SplitWritePage
+ *          as in the example. The erase must keep the page buffer, and each
+ *          step must keep NVMBUSY set for its own time.
+ *        - and: a split write without erase can only clear bits.
+ *        - erase_all: EEPROM_EraseAll with a full page buffer erases every
+ *          page.
+ *        - no_ccp: CMDEX written without the CCP signature is ignored.
+ *        - interrupt: the EEPROM interrupt must be taken when the write is
+ *          done.
+ *
+ *      Each scenario prints one line of space separated key=value pairs. The
+ *      program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding eeprom_driver.c. The simulator
+ *      is shared with AVR1307:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/eeprom_nvm.c \
+ *            eeprom_driver.c -o eeprom_nvm
+ *        ./eeprom_nvm
+ *
+ * \par Application note:
+ *      AVR1315: Accessing the XMEGA EEPROM
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "eeprom_driver.h"
+#include "sim.h"
+
+/*! Pages and bytes of the example. */
+#define TEST_BYTE_ADDR_1  0x00
+#define TEST_BYTE_ADDR_2  0x08
+#define TEST_PAGE_ADDR_1  0
+#define TEST_PAGE_ADDR_2  2
+#define TEST_PAGE_ADDR_3  5
+
+/*! Pages of the EEPROM. */
+#define EEPROM_PAGES      (2048 / EEPROM_PAGESIZE)
+
+/*! CPU cycles of the page erase and write times. */
+#define ERASE_CYCLES      (SIM_NVM_EE_ERASE_NS / (1000000000UL / F_CPU))
+#define WRITE_CYCLES      (SIM_NVM_EE_WRITE_NS / (1000000000UL / F_CPU))
+
+/*! Longest time the driver takes to issue a command, in CPU cycles. */
+#define ISSUE_CYCLES      200
+
+
+/*! Test buffer of the example. */
+static uint8_t testBuffer[EEPROM_PAGESIZE] = {"Accessing Atmel AVR XMEGA EEPROM"};
+
+/*! Number of EEPROM interrupts taken. */
+static volatile uint8_t interruptCount;
+
+/*! Time of the last EEPROM interrupt. */
+static volatile uint64_t interruptTime;
+
+
+/*! EEPROM ready interrupt vector. The interrupt is a level interrupt, so it
+ *  disables itself.
+ */
+ISR(NVM_EE_vect)
+{
+	NVM.INTCTRL = NVM_EELVL_OFF_gc;
+	interruptTime = SIM_GetCycles();
+	interruptCount++;
+}
+
+
+/*! \brief Time the busy period of the command just issued.
+ *
+ *  \return  CPU cycles since \a start until NVMBUSY cleared.
+ */
+static uint32_t Test_Busy(uint64_t start)
+{
+	EEPROM_WaitForNVM();
+	return (uint32_t) (SIM_GetCycles() - start);
+}
+
+
+/*! \brief Check a time from the call of the driver against the time of the
+ *         command.
+ */
+static bool Test_BusyOk(uint32_t cycles, uint32_t expected)
+{
+	return (cycles > expected) && (cycles <= expected + ISSUE_CYCLES);
+}
+
+
+/*! \brief Write and read back the bytes of the example and report. */
+static bool Test_Byte(void)
+{
+	uint64_t start;
+	uint32_t cycles;
+	bool success;
+
+	EEPROM_FlushBuffer();
+	start = SIM_GetCycles();
+	EEPROM_WriteByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_1, 0x55);
+	cycles = Test_Busy(start);
+	EEPROM_WriteByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2, 0xAA);
+
+	success = (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_1) == 0x55) &&
+	          (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2) == 0xAA) &&
+	          (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2 + 1) == 0xFF);
+
+	/* The other way round: the atomic write only changes the loaded byte. */
+	EEPROM_WriteByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_1, 0xAA);
+	EEPROM_WriteByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2, 0x55);
+	success &= (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_1) == 0xAA) &&
+	           (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2) == 0x55);
+
+	success &= Test_BusyOk(cycles, ERASE_CYCLES + WRITE_CYCLES);
+
+	printf("scenario=byte busy_cycles=%lu expected=%lu result=%s\n",
+	       (unsigned long) cycles,
+	       (unsigned long) (ERASE_CYCLES + WRITE_CYCLES),
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Write a page with split operations and report. */
+static bool Test_Split(void)
+{
+	uint32_t eraseCycles;
+	uint32_t writeCycles;
+	uint64_t start;
+	bool success = true;
+	uint8_t i;
+
+	EEPROM_LoadPage(testBuffer);
+	start = SIM_GetCycles();
+	EEPROM_ErasePage(TEST_PAGE_ADDR_2);
+	eraseCycles = Test_Busy(start);
+	success &= (NVM.STATUS & NVM_EELOAD_bm) != 0;
+	start = SIM_GetCycles();
+	EEPROM_SplitWritePage(TEST_PAGE_ADDR_2);
+	writeCycles = Test_Busy(start);
+	success &= (NVM.STATUS & NVM_EELOAD_bm) == 0;
+
+	for (i = 0; i < EEPROM_PAGESIZE; i++) {
+		success &= (EEPROM_ReadByte(TEST_PAGE_ADDR_2, i) == testBuffer[i]);
+	}
+	success &= Test_BusyOk(eraseCycles, ERASE_CYCLES) &&
+	           Test_BusyOk(writeCycles, WRITE_CYCLES);
+
+	printf("scenario=split erase_cycles=%lu write_cycles=%lu expected_erase=%lu "
+	       "expected_write=%lu result=%s\n",
+	       (unsigned long) eraseCycles,
+	       (unsigned long) writeCycles,
+	       (unsigned long) ERASE_CYCLES,
+	       (unsigned long) WRITE_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Write over a written page without erase and report. */
+static bool Test_And(void)
+{
+	uint8_t values[EEPROM_PAGESIZE];
+	uint8_t value;
+	bool success;
+
+	memset(values, 0xF0, sizeof(values));
+	EEPROM_LoadPage(values);
+	EEPROM_AtomicWritePage(TEST_PAGE_ADDR_3);
+	memset(values, 0x3C, sizeof(values));
+	EEPROM_LoadPage(values);
+	EEPROM_SplitWritePage(TEST_PAGE_ADDR_3);
+	value = EEPROM_ReadByte(TEST_PAGE_ADDR_3, EEPROM_PAGESIZE - 1);
+	success = (value == (0xF0 & 0x3C));
+
+	printf("scenario=and value=0x%02X expected=0x%02X result=%s\n",
+	       value,
+	       0xF0 & 0x3C,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Erase the whole EEPROM and report. */
+static bool Test_EraseAll(void)
+{
+	uint8_t values[EEPROM_PAGESIZE];
+	uint16_t written = 0;
+	uint8_t page;
+	uint8_t i;
+
+	/* ERASE_EEPROM erases the bytes loaded in the buffer, in every page. */
+	memset(values, 0x00, sizeof(values));
+	EEPROM_LoadPage(values);
+	EEPROM_EraseAll();
+
+	for (page = 0; page < EEPROM_PAGES; page++) {
+		for (i = 0; i < EEPROM_PAGESIZE; i++) {
+			if (EEPROM_ReadByte(page, i) != 0xFF) {
+				written++;
+			}
+		}
+	}
+
+	printf("scenario=erase_all pages=%u written_bytes=%u result=%s\n",
+	       EEPROM_PAGES,
+	       written,
+	       (written == 0) ? "pass" : "fail");
+
+	return written == 0;
+}
+
+
+/*! \brief Execute a command without the CCP signature and report. */
+static bool Test_NoCcp(void)
+{
+	bool success;
+
+	EEPROM_LoadByte(TEST_BYTE_ADDR_1, 0x12);
+	NVM.ADDR0 = 0x00;
+	NVM.ADDR1 = 0x00;
+	NVM.CMD = NVM_CMD_ERASE_WRITE_EEPROM_PAGE_gc;
+	NVM.CTRLA = NVM_CMDEX_bm;
+	success = ((NVM.STATUS & NVM_NVMBUSY_bm) == 0) &&
+	          ((NVM.STATUS & NVM_EELOAD_bm) != 0) &&
+	          (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_1) == 0xFF);
+	EEPROM_FlushBuffer();
+
+	printf("scenario=no_ccp result=%s\n", success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Take the EEPROM interrupt at the end of a write and report. */
+static bool Test_Interrupt(void)
+{
+	uint64_t start;
+	uint32_t cycles;
+	bool success;
+
+	interruptCount = 0;
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+
+	start = SIM_GetCycles();
+	EEPROM_WriteByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2, 0x5A);
+	NVM.INTCTRL = NVM_EELVL_LO_gc;
+	SIM_Run(ERASE_CYCLES + WRITE_CYCLES + 1000);
+	cycles = (uint32_t) (interruptTime - start);
+
+	success = (interruptCount == 1) &&
+	          Test_BusyOk(cycles, ERASE_CYCLES + WRITE_CYCLES) &&
+	          (EEPROM_ReadByte(TEST_PAGE_ADDR_1, TEST_BYTE_ADDR_2) == 0x5A);
+
+	printf("scenario=interrupt interrupts=%u cycles=%lu result=%s\n",
+	       interruptCount,
+	       (unsigned long) cycles,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Run the scenarios and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+
+	EEPROM_DisableMapping();
+
+	success &= Test_Byte();
+	success &= Test_Split();
+	success &= Test_And();
+	success &= Test_EraseAll();
+	success &= Test_NoCcp();
+	success &= Test_Interrupt();
+
+	printf("summary page_size=%u erase_cycles=%lu write_cycles=%lu result=%s\n",
+	       EEPROM_PAGESIZE,
+	       (unsigned long) ERASE_CYCLES,
+	       (unsigned long) WRITE_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
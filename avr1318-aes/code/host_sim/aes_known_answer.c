@@ -0,0 +1,327 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host known answer test of the XMEGA AES driver.
+ *
+ *      This program runs the AES driver on the host simulator against the
+ *      published test vectors: the AES-128 example of FIPS-197 appendix C.1
+ *      and the CBC-AES128 examples of NIST SP 800-38A F.2.1 and F.2.2.
+ *
+ *      Scenarios:
+ *        - encrypt: AES_encrypt() of the FIPS-197 block. The block must take
+ *          at least SIM_AES_CYCLES.
+ *        - lastsubkey: AES_lastsubkey_generate() must return the round 10
+ *          key of FIPS-197 C.1.
+ *        - decrypt: AES_decrypt() with the last subkey.
+ *        - backtoback: encryption and decryption taking turns on the key
+ *          memory, as in AES_example_backtoback.c.
+ *        - cbc_encrypt, cbc_decrypt: the polled CBC functions on the four
+ *          blocks of SP 800-38A, benchmarked as by asf_benchmark_example.
+ *        - int_encrypt, int_decrypt: the interrupt driver on the same blocks.
+ *        - busy_error: a STATE access while the module is busy must set
+ *          ERROR and leave the encryption intact.
+ *
+ *      Each scenario prints one line of space separated key=value pairs, with
+ *      the time in CPU cycles. The program exits with a non-zero status if a
+ *      check fails.
+ *
+ *      Build and run from the directory holding AES_driver.c. The simulator is
+ *      shared with AVR1307:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/aes_known_answer.c \
+ *            AES_driver.c -o aes_known_answer
+ *        ./aes_known_answer
+ *
+ * \par Application note:
+ *      AVR1318 Using the XMEGA built in AES accelerator
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1569 $
+ * $Date: 2008-04-22 13:03:43 +0200 (ti, 22 apr 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "avr_compiler.h"
+#include "AES_driver.h"
+#include "sim.h"
+
+/*! Number of blocks of the CBC examples. */
+#define CBC_BLOCKS        4
+
+/*! Longest time the interrupt driver may take, in CPU cycles. */
+#define TIMEOUT_CYCLES    100000UL
+
+
+/*! FIPS-197 C.1: key, plaintext, ciphertext and round 10 key. */
+static uint8_t fipsKey[AES_BLOCK_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static uint8_t fipsPlaintext[AES_BLOCK_LENGTH] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static uint8_t fipsCiphertext[AES_BLOCK_LENGTH] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+static const uint8_t fipsLastSubkey[AES_BLOCK_LENGTH] = {
+	0x13, 0x11, 0x1d, 0x7f, 0xe3, 0x94, 0x4a, 0x17,
+	0xf3, 0x07, 0xa7, 0x8b, 0x4d, 0x2b, 0x30, 0xc5
+};
+
+/*! SP 800-38A F.2.1 and F.2.2: key, initialization vector, plaintext and
+ *  ciphertext. */
+static uint8_t cbcKey[AES_BLOCK_LENGTH] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static uint8_t cbcInit[AES_BLOCK_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static uint8_t cbcPlaintext[CBC_BLOCKS * AES_BLOCK_LENGTH] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+static uint8_t cbcCiphertext[CBC_BLOCKS * AES_BLOCK_LENGTH] = {
+	0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46,
+	0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+	0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee,
+	0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+	0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b,
+	0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+	0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09,
+	0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7
+};
+
+/*! Interrupt driver of the int_ scenarios. */
+static AES_interrupt_driver_t interruptDriver;
+
+
+/*! AES interrupt vector. */
+ISR(AES_INT_vect)
+{
+	AES_interrupt_handler(&interruptDriver);
+}
+
+
+/*! \brief Report a scenario.
+ *
+ *  \param name     Name of the scenario.
+ *  \param ok       Result of the driver functions.
+ *  \param output   Output of the scenario.
+ *  \param expected Expected output.
+ *  \param length   Length of the output in bytes.
+ *  \param cycles   CPU cycles of the scenario.
+ *
+ *  \return  true if the driver functions succeeded and the output is right.
+ */
+static bool Test_Report(const char * name, bool ok, const uint8_t * output,
+                        const uint8_t * expected, uint8_t length, uint32_t cycles)
+{
+	bool match = (memcmp(output, expected, length) == 0);
+	uint8_t blocks = length / AES_BLOCK_LENGTH;
+
+	printf("scenario=%s blocks=%u driver=%s output=%s cycles=%lu cycles_per_block=%lu "
+	       "bytes_per_s=%lu result=%s\n",
+	       name,
+	       blocks,
+	       ok ? "ok" : "error",
+	       match ? "match" : "mismatch",
+	       (unsigned long) cycles,
+	       (unsigned long) (cycles / blocks),
+	       (unsigned long) ((uint64_t) length * F_CPU / cycles),
+	       (ok && match) ? "pass" : "fail");
+
+	return ok && match;
+}
+
+
+/*! \brief Run the interrupt driver on the SP 800-38A blocks and report.
+ *
+ *  \param decrypt  true to decrypt with the last subkey, false to encrypt.
+ *
+ *  \return  true if the check passed.
+ */
+static bool Test_Interrupt(bool decrypt)
+{
+	uint8_t output[CBC_BLOCKS * AES_BLOCK_LENGTH];
+	uint8_t lastSubkey[AES_BLOCK_LENGTH];
+	uint64_t start;
+	bool ok = true;
+
+	if (decrypt) {
+		ok &= AES_lastsubkey_generate(cbcKey, lastSubkey);
+	}
+	AES_software_reset();
+	AES_interrupt_driver_init(&interruptDriver,
+	                          decrypt ? cbcCiphertext : cbcPlaintext,
+	                          output,
+	                          decrypt ? lastSubkey : cbcKey,
+	                          cbcInit,
+	                          CBC_BLOCKS,
+	                          decrypt);
+	start = SIM_GetCycles();
+	ok &= AES_interrupt_driver_start(&interruptDriver, AES_INTLVL_LO_gc);
+	while (!AES_interrupt_driver_finished(&interruptDriver) &&
+	       (SIM_GetCycles() - start < TIMEOUT_CYCLES)) {
+		SIM_Run(1);
+	}
+	ok &= AES_interrupt_driver_finished(&interruptDriver) &&
+	      (SIM_GetIrqStats(AES_INT_vect_num)->count == CBC_BLOCKS);
+
+	return Test_Report(decrypt ? "int_decrypt" : "int_encrypt", ok, output,
+	                   decrypt ? cbcPlaintext : cbcCiphertext, sizeof(output),
+	                   (uint32_t) (SIM_GetCycles() - start));
+}
+
+
+/*! \brief Access STATE while the module is busy and report. */
+static bool Test_BusyError(void)
+{
+	uint8_t output[AES_BLOCK_LENGTH];
+	bool error;
+	bool ok;
+	uint8_t i;
+
+	AES_software_reset();
+	for (i = 0; i < AES_BLOCK_LENGTH; i++) {
+		AES.KEY = fipsKey[i];
+	}
+	for (i = 0; i < AES_BLOCK_LENGTH; i++) {
+		AES.STATE = fipsPlaintext[i];
+	}
+	AES_start();
+	AES.STATE = 0xFF;
+	error = AES_error_flag_check();
+	while (!AES_state_ready_flag_check()) {
+		SIM_Run(1);
+	}
+	for (i = 0; i < AES_BLOCK_LENGTH; i++) {
+		output[i] = AES.STATE;
+	}
+	ok = error && (memcmp(output, fipsCiphertext, sizeof(output)) == 0);
+
+	printf("scenario=busy_error error=%s output=%s result=%s\n",
+	       error ? "set" : "clear",
+	       (memcmp(output, fipsCiphertext, sizeof(output)) == 0) ? "match" : "mismatch",
+	       ok ? "pass" : "fail");
+
+	AES.STATUS = AES_ERROR_bm | AES_SRIF_bm;
+	return ok;
+}
+
+
+/*! \brief Run the scenarios and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	uint8_t block[AES_BLOCK_LENGTH];
+	uint8_t cbc[CBC_BLOCKS * AES_BLOCK_LENGTH];
+	uint8_t lastSubkey[AES_BLOCK_LENGTH];
+	uint8_t roundTrip[2][AES_BLOCK_LENGTH];
+	uint8_t expected[2][AES_BLOCK_LENGTH];
+	uint64_t start;
+	bool success = true;
+	bool ok;
+
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+	sei();
+	AES_software_reset();
+
+	start = SIM_GetCycles();
+	ok = AES_encrypt(fipsPlaintext, block, fipsKey);
+	success &= Test_Report("encrypt", ok, block, fipsCiphertext, sizeof(block),
+	                       (uint32_t) (SIM_GetCycles() - start)) &&
+	           (SIM_GetCycles() - start >= SIM_AES_CYCLES);
+
+	start = SIM_GetCycles();
+	ok = AES_lastsubkey_generate(fipsKey, lastSubkey);
+	success &= Test_Report("lastsubkey", ok, lastSubkey, fipsLastSubkey, sizeof(lastSubkey),
+	                       (uint32_t) (SIM_GetCycles() - start));
+
+	start = SIM_GetCycles();
+	ok = AES_decrypt(fipsCiphertext, block, lastSubkey);
+	success &= Test_Report("decrypt", ok, block, fipsPlaintext, sizeof(block),
+	                       (uint32_t) (SIM_GetCycles() - start));
+
+	/* The key memory holds the last subkey after an encryption, and the key
+	 * after a decryption. */
+	start = SIM_GetCycles();
+	ok = AES_encrypt(fipsPlaintext, roundTrip[0], fipsKey);
+	ok &= AES_decrypt_backtoback(roundTrip[0], roundTrip[0]);
+	ok &= AES_encrypt_backtoback(cbcPlaintext, roundTrip[1]);
+	ok &= AES_decrypt_backtoback(roundTrip[1], roundTrip[1]);
+	memcpy(expected[0], fipsPlaintext, AES_BLOCK_LENGTH);
+	memcpy(expected[1], cbcPlaintext, AES_BLOCK_LENGTH);
+	success &= Test_Report("backtoback", ok, roundTrip[0], expected[0], sizeof(roundTrip),
+	                       (uint32_t) (SIM_GetCycles() - start));
+
+	AES_software_reset();
+	start = SIM_GetCycles();
+	ok = AES_CBC_encrypt(cbcPlaintext, cbc, cbcKey, cbcInit, CBC_BLOCKS);
+	success &= Test_Report("cbc_encrypt", ok, cbc, cbcCiphertext, sizeof(cbc),
+	                       (uint32_t) (SIM_GetCycles() - start));
+
+	ok = AES_lastsubkey_generate(cbcKey, lastSubkey);
+	start = SIM_GetCycles();
+	ok &= AES_CBC_decrypt(cbcCiphertext, cbc, lastSubkey, cbcInit, CBC_BLOCKS);
+	success &= Test_Report("cbc_decrypt", ok, cbc, cbcPlaintext, sizeof(cbc),
+	                       (uint32_t) (SIM_GetCycles() - start));
+
+	SIM_ClearStats();
+	success &= Test_Interrupt(false);
+	SIM_ClearStats();
+	success &= Test_Interrupt(true);
+	success &= Test_BusyError();
+
+	printf("summary aes_cycles=%u result=%s\n",
+	       SIM_AES_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,428 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA 32-bit RTC calendar service source file.
+ *
+ *      This file contains the function implementations of the 32-bit RTC
+ *      calendar service. See rtc32_calendar.h for a description.
+ *
+ * \par Application note:
+ *      AVR1321: Using the XMEGA 32-bit RTC and battery backup system
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5159 $
+ * $Date: 2009-06-09 19:05:02 +0200 (ti, 09 jun 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#include "rtc32_calendar.h"
+
+/*! \brief Divide by multiplying with a reciprocal.
+ *
+ *  Computes _x / _d as ( _x * _m ) >> _s, with _m = ceil( 2^_s / _d ). Each
+ *  use below gives the exact quotient over the documented range of _x, and
+ *  keeps the product within 32 bits.
+ */
+#define RTC32CAL_DIV( _x, _m, _s )  ( (uint16_t) ( ( (uint32_t) (_x) * (_m) ) >> (_s) ) )
+
+/*! Seconds between two trim corrections, 0 if trimming is disabled. */
+static uint32_t RTC32CAL_trimInterval;
+
+/*! Trim value, positive if the crystal runs fast. */
+static int16_t RTC32CAL_trim;
+
+
+/*! \brief Read the number of the last trim interval corrected.
+ *
+ *  The number is kept in the battery backed backup registers, so corrections
+ *  due while the device was powered from VBAT only are made up for by the
+ *  first RTC32CAL_Update() after power returns.
+ */
+static uint16_t RTC32CAL_GetTrimIndex( void )
+{
+	return ( (uint16_t) VBAT.BACKUP1 << 8 ) | VBAT.BACKUP0;
+}
+
+
+/*! \brief Store the number of the last trim interval corrected.
+ *
+ *  \param index  Trim interval number.
+ */
+static void RTC32CAL_SetTrimIndex( uint16_t index )
+{
+	VBAT.BACKUP0 = (uint8_t) index;
+	VBAT.BACKUP1 = (uint8_t) ( index >> 8 );
+}
+
+
+/*! \brief This function initializes the calendar service.
+ *
+ *  The battery backup system is checked with vbat_system_check(). If the
+ *  time kept in the backup domain is valid, the RTC is left running.
+ *  Otherwise the backup system is reset, the crystal oscillator is started
+ *  with 1 Hz output and the RTC is restarted from 1970-01-01 00:00:00.
+ *
+ *  \note The RTC interrupt levels are not kept while the device is powered
+ *        from VBAT only, and must be set by the application.
+ *
+ *  \param firstStartup  true on the first start-up of the device.
+ *  \param trim          Crystal frequency error, see RTC32CAL_SetTrim().
+ *
+ *  \return  Backup system status. The time is valid if VBAT_STATUS_OK is
+ *           returned, otherwise it must be set by RTC32CAL_SetTime().
+ */
+uint8_t RTC32CAL_Init( bool firstStartup, int16_t trim )
+{
+	uint8_t status = vbat_system_check( firstStartup );
+
+	if ( status != VBAT_STATUS_OK ) {
+		vbat_reset();
+		vbat_enable_xosc( false );
+		RTC32_Initialize( RTC32CAL_TIME_MAX + 1, 0, 0 );
+		RTC32CAL_SetTrimIndex( 0 );
+	}
+	RTC32CAL_SetTrim( trim );
+
+	return status;
+}
+
+
+/*! \brief This function sets the crystal frequency trim.
+ *
+ *  The trim is the measured crystal frequency error in units of 0.1 ppm,
+ *  positive if the crystal runs fast. RTC32CAL_Update() corrects the time by
+ *  one second every 10^7 / |trim| seconds. The trim is not kept in the
+ *  backup domain, and the same value must be given again after each reset,
+ *  for instance from a calibration value stored in EEPROM.
+ *
+ *  \param trim  Crystal frequency error in 0.1 ppm units, 0 to disable.
+ */
+void RTC32CAL_SetTrim( int16_t trim )
+{
+	uint32_t interval = 0;
+
+	if ( trim != 0 ) {
+		interval = 10000000UL / (uint16_t) ( ( trim < 0 ) ? -trim : trim );
+	}
+
+	/* The stored interval number is kept from before the reset, so the
+	 * corrections due while the device was powered from VBAT only are
+	 * made. It is only restarted when the trim is changed while running.
+	 */
+	if ( RTC32CAL_trimInterval != 0 && interval != 0 &&
+	     interval != RTC32CAL_trimInterval ) {
+		RTC32CAL_SetTrimIndex( (uint16_t) ( RTC32CAL_GetTime() / interval ) );
+	}
+	RTC32CAL_trimInterval = interval;
+	RTC32CAL_trim = trim;
+}
+
+
+/*! \brief This function applies the trim correction.
+ *
+ *  This function should be called regularly, for instance on every wake-up.
+ *  It corrects the RTC by one second for every trim interval started since
+ *  the last correction, so it may be called as seldom as once per trim
+ *  interval. An alarm that falls on a second skipped by a forward correction
+ *  is moved to the next second.
+ */
+void RTC32CAL_Update( void )
+{
+	uint32_t interval = RTC32CAL_trimInterval;
+	uint32_t now;
+	uint16_t index;
+	int16_t steps;
+
+	if ( interval == 0 ) {
+		return;
+	}
+
+	/* A backward correction can move the time below the start of the
+	 * interval stored. The index then lags the stored one until the time
+	 * is past the boundary again, and the difference is negative.
+	 */
+	now = RTC32CAL_GetTime();
+	index = (uint16_t) ( now / interval );
+	steps = (int16_t) ( index - RTC32CAL_GetTrimIndex() );
+	if ( steps <= 0 ) {
+		return;
+	}
+
+	RTC32CAL_SetTrimIndex( index );
+	if ( RTC32CAL_trim > 0 ) {
+		RTC32_SetCount( now - steps );
+	} else {
+		RTC32_SetCount( now + steps );
+		if ( (uint32_t) ( RTC32_GetCompareValue() - now - 1 ) < (uint16_t) steps ) {
+			RTC32_SetCompareValue( now + steps + 1 );
+		}
+	}
+}
+
+
+/*! \brief This function sets the time.
+ *
+ *  \param time  UTC time in seconds since 1970-01-01 00:00:00.
+ */
+void RTC32CAL_SetTime( uint32_t time )
+{
+	RTC32_SetCount( time );
+	if ( RTC32CAL_trimInterval != 0 ) {
+		RTC32CAL_SetTrimIndex( (uint16_t) ( time / RTC32CAL_trimInterval ) );
+	}
+}
+
+
+/*! \brief This function reads the time as calendar fields.
+ *
+ *  \param dateTime  Pointer to where the time is stored.
+ */
+void RTC32CAL_GetDateTime( RTC32CAL_DateTime_t * dateTime )
+{
+	RTC32CAL_FromTime( RTC32CAL_GetTime(), dateTime );
+}
+
+
+/*! \brief This function converts a date to a day number.
+ *
+ *  The year is counted from March, so the leap day is the last day of the
+ *  year, and the date is located in the 400-year era starting 1600-03-01.
+ *
+ *  \param year   Year, 1970 to 2106.
+ *  \param month  Month, 1 to 12.
+ *  \param day    Day of month, 1 to 31.
+ *
+ *  \return  Number of days since 1970-01-01.
+ */
+uint16_t RTC32CAL_DaysFromCivil( uint16_t year, uint8_t month, uint8_t day )
+{
+	uint16_t yearOfEra;
+	uint16_t dayOfYear;
+	uint32_t dayOfEra;
+	uint8_t marchMonth;
+
+	if ( month > 2 ) {
+		marchMonth = month - 3;
+	} else {
+		marchMonth = month + 9;
+		--year;
+	}
+
+	yearOfEra = year - 1600;
+	dayOfEra = 0;
+	if ( yearOfEra >= 400 ) {
+		yearOfEra -= 400;
+		dayOfEra = RTC32CAL_DAYS_PER_ERA;
+	}
+
+	/* ( 153 * marchMonth + 2 ) / 5, marchMonth <= 11. */
+	dayOfYear = RTC32CAL_DIV( 153 * marchMonth + 2, 1639, 13 ) + day - 1;
+
+	/* yearOfEra / 100, yearOfEra < 400. */
+	dayOfEra += (uint32_t) yearOfEra * 365 + ( yearOfEra >> 2 ) -
+	            RTC32CAL_DIV( yearOfEra, 41, 12 ) + dayOfYear;
+
+	return (uint16_t) ( dayOfEra - RTC32CAL_ERA_OFFSET );
+}
+
+
+/*! \brief This function converts a day number to a date.
+ *
+ *  The year, month, day and weekday fields are written. The time of day
+ *  fields are not changed.
+ *
+ *  \param days      Number of days since 1970-01-01.
+ *  \param dateTime  Pointer to where the date is stored.
+ */
+void RTC32CAL_CivilFromDays( uint16_t days, RTC32CAL_DateTime_t * dateTime )
+{
+	uint32_t dayOfEra = days + RTC32CAL_ERA_OFFSET;
+	uint16_t year = 1600;
+	uint16_t dayOfCentury;
+	uint16_t dayOf4Years;
+	uint16_t dayOfYear;
+	uint8_t century;
+	uint8_t cycle;
+	uint8_t yearOfCycle;
+	uint8_t marchMonth;
+	uint16_t weekdayIndex;
+
+	if ( dayOfEra >= RTC32CAL_DAYS_PER_ERA ) {
+		dayOfEra -= RTC32CAL_DAYS_PER_ERA;
+		year += 400;
+	}
+
+	/* The last century of the era ends with a leap day and is one day
+	 * longer, so the century is found by comparison and capped at 3.
+	 */
+	century = ( dayOfEra >= RTC32CAL_DAYS_PER_CENTURY ) +
+	          ( dayOfEra >= 2UL * RTC32CAL_DAYS_PER_CENTURY ) +
+	          ( dayOfEra >= 3UL * RTC32CAL_DAYS_PER_CENTURY );
+	dayOfCentury = (uint16_t) ( dayOfEra - (uint32_t) century * RTC32CAL_DAYS_PER_CENTURY );
+
+	/* dayOfCentury / 1461, dayOfCentury < 36525. */
+	cycle = RTC32CAL_DIV( dayOfCentury, 22967, 25 );
+	dayOf4Years = dayOfCentury - cycle * RTC32CAL_DAYS_PER_4YEARS;
+
+	/* dayOf4Years / 365, dayOf4Years < 1461. The leap day at the end of
+	 * the cycle gives 4, which is capped to 3.
+	 */
+	yearOfCycle = RTC32CAL_DIV( dayOf4Years, 1437, 19 );
+	if ( yearOfCycle > 3 ) {
+		yearOfCycle = 3;
+	}
+	dayOfYear = dayOf4Years - yearOfCycle * 365;
+	year += century * 100 + cycle * 4 + yearOfCycle;
+
+	/* ( 5 * dayOfYear + 2 ) / 153, dayOfYear < 366. */
+	marchMonth = RTC32CAL_DIV( 5 * dayOfYear + 2, 857, 17 );
+
+	/* ( 153 * marchMonth + 2 ) / 5, marchMonth <= 11. */
+	dateTime->day = dayOfYear - RTC32CAL_DIV( 153 * marchMonth + 2, 1639, 13 ) + 1;
+	if ( marchMonth < 10 ) {
+		dateTime->month = marchMonth + 3;
+	} else {
+		dateTime->month = marchMonth - 9;
+		++year;
+	}
+	dateTime->year = year;
+
+	/* 1970-01-01 was a Thursday. ( days + 4 ) / 7, days + 4 < 49717. */
+	weekdayIndex = days + 4;
+	dateTime->weekday = weekdayIndex - RTC32CAL_DIV( weekdayIndex, 74899, 19 ) * 7;
+}
+
+
+/*! \brief This function converts calendar fields to seconds.
+ *
+ *  The weekday field is ignored.
+ *
+ *  \param dateTime  Pointer to the calendar time.
+ *
+ *  \return  Seconds since 1970-01-01 00:00:00.
+ */
+uint32_t RTC32CAL_ToTime( const RTC32CAL_DateTime_t * dateTime )
+{
+	uint16_t days = RTC32CAL_DaysFromCivil( dateTime->year,
+	                                        dateTime->month,
+	                                        dateTime->day );
+	uint16_t minutes = dateTime->hour * 60 + dateTime->minute;
+
+	return (uint32_t) days * 86400 + (uint32_t) minutes * 60 + dateTime->second;
+}
+
+
+/*! \brief This function converts seconds to calendar fields.
+ *
+ *  \param time      Seconds since 1970-01-01 00:00:00.
+ *  \param dateTime  Pointer to where the calendar time is stored.
+ */
+void RTC32CAL_FromTime( uint32_t time, RTC32CAL_DateTime_t * dateTime )
+{
+	/* 86400 = 128 * 675. The day number is estimated from the upper 16 bits
+	 * of time / 128 with a reciprocal slightly below 1 / 675, which gives
+	 * at most three too few days. The remainder then corrects the estimate.
+	 */
+	uint32_t time128 = time >> 7;
+	uint16_t days = (uint16_t) ( ( ( time128 >> 9 ) * 49710UL ) >> 16 );
+	uint32_t remainder = time128 - (uint32_t) days * 675;
+	uint16_t minutes;
+
+	while ( remainder >= 675 ) {
+		remainder -= 675;
+		++days;
+	}
+	remainder = ( remainder << 7 ) | ( time & 0x7F );
+
+	/* remainder / 3600, remainder < 86400. */
+	dateTime->hour = RTC32CAL_DIV( remainder, 37283, 27 );
+	minutes = (uint16_t) remainder - dateTime->hour * 3600U;
+
+	/* minutes / 60, minutes < 3600. */
+	dateTime->minute = RTC32CAL_DIV( minutes, 2185, 17 );
+	dateTime->second = minutes - dateTime->minute * 60;
+
+	RTC32CAL_CivilFromDays( days, dateTime );
+}
+
+
+/*! \brief This function sets an alarm at a calendar time.
+ *
+ *  The alarm is scheduled with RTC32_SetAlarm(), and triggers the RTC32
+ *  compare interrupt.
+ *
+ *  \param dateTime  Pointer to the alarm time.
+ *
+ *  \retval true   The alarm was set.
+ *  \retval false  The alarm time is not in the future.
+ */
+bool RTC32CAL_SetAlarm( const RTC32CAL_DateTime_t * dateTime )
+{
+	uint32_t alarm = RTC32CAL_ToTime( dateTime );
+	uint32_t now = RTC32CAL_GetTime();
+
+	if ( alarm <= now ) {
+		return false;
+	}
+	RTC32_SetAlarm( alarm - now );
+	return true;
+}
+
+
+/*! \brief This function sets an alarm at the next occurrence of a time of
+ *         day.
+ *
+ *  \param hour    Hour, 0 to 23.
+ *  \param minute  Minute, 0 to 59.
+ *  \param second  Second, 0 to 59.
+ *
+ *  \return  The alarm time in seconds since 1970-01-01 00:00:00.
+ */
+uint32_t RTC32CAL_SetDailyAlarm( uint8_t hour, uint8_t minute, uint8_t second )
+{
+	uint32_t now = RTC32CAL_GetTime();
+	uint16_t minutes = hour * 60 + minute;
+	uint32_t secondOfDay = (uint32_t) minutes * 60 + second;
+	RTC32CAL_DateTime_t today;
+	uint32_t alarm;
+
+	RTC32CAL_FromTime( now, &today );
+	alarm = now - ( (uint32_t) ( today.hour * 60 + today.minute ) * 60 + today.second ) +
+	        secondOfDay;
+	if ( alarm <= now ) {
+		alarm += 86400;
+	}
+	RTC32_SetAlarm( alarm - now );
+	return alarm;
+}
@@ -0,0 +1,127 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA 32-bit RTC calendar service header file.
+ *
+ *      This file contains the function prototypes and type definitions for a
+ *      wall-clock and calendar service on top of the 32-bit RTC. The RTC runs
+ *      from the 1 Hz output of the battery backed crystal oscillator, so the
+ *      counter itself holds UTC time as seconds since 1970-01-01 00:00:00 and
+ *      survives loss of main power.
+ *
+ *      Conversion between seconds and calendar fields is done with the
+ *      days-from-civil algorithm, using multiply-and-shift reciprocals instead
+ *      of division. A conversion costs a few 32-bit multiplications, compared
+ *      to around ten 32-bit divisions for the straightforward approach.
+ *
+ * \par Application note:
+ *      AVR1321: Using the XMEGA 32-bit RTC and battery backup system
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5159 $
+ * $Date: 2009-06-09 19:05:02 +0200 (ti, 09 jun 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef RTC32_CALENDAR_H
+#define RTC32_CALENDAR_H
+
+#include "avr_compiler.h"
+#include "rtc32_driver.h"
+#include "vbat.h"
+
+/* Definitions of macros. */
+
+/*! Last second that can be represented, 2106-02-07 06:28:14. The RTC32
+ *  period is set one below the full 32-bit range by RTC32_Initialize().
+ */
+#define RTC32CAL_TIME_MAX          0xFFFFFFFEUL
+
+/*! Number of days from 1970-01-01 to 1600-03-01, the start of the 400-year
+ *  era used by the conversion functions.
+ */
+#define RTC32CAL_ERA_OFFSET        135080UL
+
+/*! Number of days in a 400-year era. */
+#define RTC32CAL_DAYS_PER_ERA      146097UL
+
+/*! Number of days in a century that does not end with a leap day. */
+#define RTC32CAL_DAYS_PER_CENTURY  36524U
+
+/*! Number of days in a four-year cycle. */
+#define RTC32CAL_DAYS_PER_4YEARS   1461U
+
+/*! Trim value of 1 ppm, see RTC32CAL_SetTrim(). */
+#define RTC32CAL_TRIM_PPM          10
+
+/*! \brief This macro returns the current UTC time.
+ *
+ *  \return Seconds since 1970-01-01 00:00:00.
+ */
+#define RTC32CAL_GetTime()         RTC32_GetCount()
+
+
+/*! \brief Calendar time. */
+typedef struct RTC32CAL_DateTime_struct {
+	/*! Year, 1970 to 2106. */
+	uint16_t year;
+	/*! Month, 1 to 12. */
+	uint8_t month;
+	/*! Day of month, 1 to 31. */
+	uint8_t day;
+	/*! Hour, 0 to 23. */
+	uint8_t hour;
+	/*! Minute, 0 to 59. */
+	uint8_t minute;
+	/*! Second, 0 to 59. */
+	uint8_t second;
+	/*! Day of week, 0 is Sunday. Ignored when converting to seconds. */
+	uint8_t weekday;
+} RTC32CAL_DateTime_t;
+
+
+/* Prototypes of functions. Documentation is found in source file. */
+uint8_t RTC32CAL_Init( bool firstStartup, int16_t trim );
+void RTC32CAL_SetTrim( int16_t trim );
+void RTC32CAL_Update( void );
+void RTC32CAL_SetTime( uint32_t time );
+void RTC32CAL_GetDateTime( RTC32CAL_DateTime_t * dateTime );
+uint16_t RTC32CAL_DaysFromCivil( uint16_t year, uint8_t month, uint8_t day );
+void RTC32CAL_CivilFromDays( uint16_t days, RTC32CAL_DateTime_t * dateTime );
+uint32_t RTC32CAL_ToTime( const RTC32CAL_DateTime_t * dateTime );
+void RTC32CAL_FromTime( uint32_t time, RTC32CAL_DateTime_t * dateTime );
+bool RTC32CAL_SetAlarm( const RTC32CAL_DateTime_t * dateTime );
+uint32_t RTC32CAL_SetDailyAlarm( uint8_t hour, uint8_t minute, uint8_t second );
+
+#endif
@@ -0,0 +1,144 @@
+/*   This file is prepared for Doxygen automatic documentation generation   */
+/*! \file ********************************************************************
+ *
+ * \brief
+ * 		XMEGA 32-bit RTC calendar service example source code.
+ *
+ *      This file contains an example application that demonstrates the
+ *      calendar service. The UTC time is kept by the 32-bit RTC in the battery
+ *      backup domain, and a daily alarm wakes the MCU from power save mode.
+ *      A LED is lit for one minute after every alarm.
+ *
+ * \par Application note:
+ *      AVR1321: Using the XMEGA 32-bit RTC
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 112 $
+ * $Date: 2009-11-18 14:31:39 +0800 (WED, 18 Nov 2009) $  \n
+ ****************************************************************************/
+
+/*! \page License
+Copyright (c) 2009 Atmel Corporation. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+3. The name of Atmel may not be used to endorse or promote products derived
+from this software without specific prior written permission.
+
+4. This software may only be redistributed and used in connection with an Atmel
+AVR product.
+
+THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+/*============================ INCLUDES ======================================*/
+#include "avr_compiler.h"
+#include "rtc32_calendar.h"
+
+/*============================ MACROS ========================================*/
+/*! Crystal frequency error in 0.1 ppm units, positive if the crystal is fast.
+ *  Typically measured in production and stored in EEPROM.
+ */
+#define CRYSTAL_TRIM    ( -12 * RTC32CAL_TRIM_PPM )
+
+/*! Time of the daily alarm. */
+#define ALARM_HOUR      7
+#define ALARM_MINUTE    30
+
+/*============================ GLOBAL VARIABLES ==============================*/
+/*! Time the current alarm is set to. */
+uint32_t alarmTime;
+
+/*! Time the LED is turned off again, 0 when it is off. */
+uint32_t ledOffTime;
+
+/*============================ IMPLEMENTATION ================================*/
+void chip_init(void)
+{
+	PORTA.DIR = 0x02;
+	PORTA.OUTCLR = 0x02;
+
+	/* Configure the interrupt system */
+	PMIC.CTRL |= PMIC_LOLVLEN_bm;
+}
+
+int main(void)
+{
+	RTC32CAL_DateTime_t now;
+	uint8_t vbat_status;
+
+	chip_init();
+	vbat_status = RTC32CAL_Init(true, CRYSTAL_TRIM);
+
+	/*
+	 * The time in the backup domain was lost. A real application would
+	 * ask the user or a time server, this example restarts the clock
+	 * from a fixed date.
+	 */
+	if (vbat_status != VBAT_STATUS_OK) {
+		now.year = 2024;
+		now.month = 2;
+		now.day = 28;
+		now.hour = 23;
+		now.minute = 59;
+		now.second = 0;
+		RTC32CAL_SetTime(RTC32CAL_ToTime(&now));
+	}
+
+	// Interrupts must be re-enabled
+	RTC32_SetCompareIntLevel(RTC32_COMPINTLVL_LO_gc);
+	alarmTime = RTC32CAL_SetDailyAlarm(ALARM_HOUR, ALARM_MINUTE, 0);
+	ledOffTime = 0;
+
+	sei();
+
+	while (true) {
+		uint32_t time;
+
+		RTC32CAL_Update();
+		time = RTC32CAL_GetTime();
+
+		if (time >= alarmTime) {
+			/* Light the LED for a minute, then wait for tomorrow. */
+			PORTA.OUTSET = 0x02;
+			ledOffTime = time + 60;
+			RTC32_SetAlarm(60);
+			alarmTime = time + 86400;
+		} else if (ledOffTime != 0 && time >= ledOffTime) {
+			PORTA.OUTCLR = 0x02;
+			ledOffTime = 0;
+			alarmTime = RTC32CAL_SetDailyAlarm(ALARM_HOUR, ALARM_MINUTE, 0);
+		}
+
+		SLEEP.CTRL = SLEEP_SMODE_PSAVE_gc | SLEEP_SEN_bm;
+		cpu_sleep();
+	}
+}
+
+ISR(RTC32_COMP_vect)
+{
+}
@@ -16,6 +16,14 @@
  * All XMEGA devices with the targeted module can be used. The example is
  * written for ATxmega256A3B.
  *
+ * \section hostsim Host Simulation
+ * The calendar service in Drv/rtc32_calendar.c can also be built with the
+ * RTC32 and VBAT drivers for a Linux x86-64 host, using the register headers
+ * and the simulator in the host_sim directory of AVR1307. See
+ * host_sim/calendar_trim.c for the checks of the date conversions over the
+ * whole RTC32 range and of the trim correction, and sim.h for what is
+ * modelled. \n
+ *
  * \section contactinfo Contact Info
  * For more info about Atmel AVR visit http://www.atmel.com/products/AVR/ \n
  * For application notes visit
@@ -0,0 +1,432 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host test of the RTC32 calendar conversions and trim correction.
+ *
+ *      This program runs the calendar service in rtc32_calendar.c with the
+ *      RTC32 and VBAT drivers on the host simulator, which models the RTC32
+ *      counting from the 32.768 kHz crystal of the battery backup module, and
+ *      keeps the backup domain over a device reset.
+ *
+ *      Tests:
+ *        - leap: every day from 1970-01-01 to 2106-02-07 is converted both
+ *          ways and compared with a day by day reference calendar, including
+ *          the weekday. 2000 is a leap year, 2100 is not.
+ *        - time: the first, the last and a pseudo-random second of every day
+ *          are converted both ways, up to RTC32CAL_TIME_MAX.
+ *        - step: a positive and a negative trim, with RTC32CAL_Update()
+ *          called several times in every second around interval boundaries.
+ *          Each boundary must move the time by exactly one second, also when
+ *          the backward correction moves the time below the boundary, and an
+ *          alarm on a skipped second must be moved to the next one.
+ *        - catch_up: the device is reset after several trim intervals without
+ *          any update, as when powered from VBAT only. The first update after
+ *          RTC32CAL_Init() must make all corrections due, once.
+ *        - drift: the crystal runs fast or slow, and the matching trim must
+ *          keep the time within two seconds of the true time over fifty trim
+ *          intervals, with an update every UPDATE_INTERVAL seconds.
+ *
+ *      Each line holds space separated key=value pairs, and the program exits
+ *      with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding avr_compiler.h. The simulator
+ *      is shared with AVR1307, and needs a program linked with -no-pie:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. -IDrv \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/calendar_trim.c \
+ *            Drv/rtc32_calendar.c Drv/rtc32_driver.c Drv/vbat.c -o calendar_trim
+ *        ./calendar_trim
+ *
+ * \par Application note:
+ *      AVR1321: Using the XMEGA 32-bit RTC and battery backup system
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 5159 $
+ * $Date: 2009-06-09 19:05:02 +0200 (ti, 09 jun 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <setjmp.h>
+#include "sim.h"
+#include "rtc32_calendar.h"
+
+/*! CPU cycles per second. */
+#define CYCLES_PER_S       F_CPU
+
+/*! Start time of the trim tests, 2023-11-14 22:13:20, a multiple of the
+ *  trim intervals used. */
+#define TRIM_START         1700000000UL
+
+/*! Seconds between two calls to RTC32CAL_Update() in the drift test. */
+#define UPDATE_INTERVAL    10000
+
+/*! Number of trim intervals run in the drift test. */
+#define DRIFT_INTERVALS    50
+
+/*! Last day of the RTC32 range, 2106-02-07. */
+#define DAY_MAX            ((uint16_t) (RTC32CAL_TIME_MAX / 86400))
+
+/*! Number of calls to RTC32CAL_Update() in each second of the step test. */
+#define CALLS_PER_SECOND   3
+
+
+/*! Jump buffer of the reset handler. */
+static sigjmp_buf bootPoint;
+
+/*! State of the random sequence. */
+static uint32_t randomSeed = 1;
+
+
+/*! \brief Reset handler: continue after the call to SIM_Reset(). */
+static void Harness_Reset(void)
+{
+	siglongjmp(bootPoint, 1);
+}
+
+
+/*! \brief Let whole seconds pass.
+ *
+ *  \param seconds  Seconds to run.
+ */
+static void Run_Seconds(uint32_t seconds)
+{
+	while (seconds > 1000) {
+		SIM_Run(1000 * CYCLES_PER_S);
+		seconds -= 1000;
+	}
+	SIM_Run(seconds * CYCLES_PER_S);
+}
+
+
+/*! \brief Next value of the random sequence, 0 to range - 1. */
+static uint32_t Random_Next(uint32_t range)
+{
+	randomSeed = randomSeed * 1103515245UL + 12345UL;
+	return ((randomSeed >> 8) & 0xFFFFFF) % range;
+}
+
+
+/*! \brief Days of a month in the Gregorian calendar. */
+static uint8_t Month_Days(uint16_t year, uint8_t month)
+{
+	static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	bool leap = ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+
+	return days[month - 1] + ((month == 2) && leap);
+}
+
+
+/*! \brief Convert every day both ways and compare with the reference. */
+static bool Test_Leap(void)
+{
+	RTC32CAL_DateTime_t dateTime;
+	uint16_t year = 1970;
+	uint8_t month = 1;
+	uint8_t day = 1;
+	uint8_t weekday = 4;
+	uint32_t mismatches = 0;
+	uint16_t leapDays = 0;
+	bool leap2000 = false;
+	bool leap2100 = false;
+	uint32_t days;
+	bool success;
+
+	for (days = 0; days <= DAY_MAX; days++) {
+		RTC32CAL_CivilFromDays((uint16_t) days, &dateTime);
+		if ((dateTime.year != year) || (dateTime.month != month) ||
+		    (dateTime.day != day) || (dateTime.weekday != weekday) ||
+		    (RTC32CAL_DaysFromCivil(year, month, day) != days)) {
+			if (mismatches++ < 5) {
+				printf("test=leap days=%lu expected=%04u-%02u-%02u/%u got=%04u-%02u-%02u/%u\n",
+				       (unsigned long) days, year, month, day, weekday,
+				       dateTime.year, dateTime.month, dateTime.day, dateTime.weekday);
+			}
+		}
+		if ((month == 2) && (day == 29)) {
+			leapDays++;
+			leap2000 |= (year == 2000);
+			leap2100 |= (year == 2100);
+		}
+
+		weekday = (weekday + 1) % 7;
+		if (++day > Month_Days(year, month)) {
+			day = 1;
+			if (++month > 12) {
+				month = 1;
+				year++;
+			}
+		}
+	}
+
+	/* 1972 to 2104 are leap years, except 2100. */
+	success = (mismatches == 0) && (leapDays == 33) && leap2000 && !leap2100;
+	printf("test=leap days=%lu leap_days=%u leap_2000=%s leap_2100=%s mismatches=%lu result=%s\n",
+	       (unsigned long) days, leapDays, leap2000 ? "yes" : "no",
+	       leap2100 ? "yes" : "no", (unsigned long) mismatches,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Convert seconds of every day both ways. */
+static bool Test_Time(void)
+{
+	RTC32CAL_DateTime_t dateTime;
+	RTC32CAL_DateTime_t date;
+	uint32_t mismatches = 0;
+	uint32_t checks = 0;
+	uint32_t days;
+	uint8_t i;
+	bool success;
+
+	for (days = 0; days <= DAY_MAX; days++) {
+		uint32_t seconds[3] = { 0, 86399, Random_Next(86400) };
+
+		RTC32CAL_CivilFromDays((uint16_t) days, &date);
+		for (i = 0; i < 3; i++) {
+			uint32_t time;
+
+			if ((uint64_t) days * 86400 + seconds[i] > RTC32CAL_TIME_MAX) {
+				seconds[i] = RTC32CAL_TIME_MAX - days * 86400;
+			}
+			time = days * 86400 + seconds[i];
+			RTC32CAL_FromTime(time, &dateTime);
+			if ((dateTime.year != date.year) || (dateTime.month != date.month) ||
+			    (dateTime.day != date.day) || (dateTime.weekday != date.weekday) ||
+			    (dateTime.hour != seconds[i] / 3600) ||
+			    (dateTime.minute != seconds[i] / 60 % 60) ||
+			    (dateTime.second != seconds[i] % 60) ||
+			    (RTC32CAL_ToTime(&dateTime) != time)) {
+				if (mismatches++ < 5) {
+					printf("test=time time=%lu got=%04u-%02u-%02u %02u:%02u:%02u\n",
+					       (unsigned long) time, dateTime.year, dateTime.month,
+					       dateTime.day, dateTime.hour, dateTime.minute,
+					       dateTime.second);
+				}
+			}
+			checks++;
+		}
+	}
+
+	/* The last second is 2106-02-07 06:28:14. */
+	RTC32CAL_FromTime(RTC32CAL_TIME_MAX, &dateTime);
+	if ((dateTime.year != 2106) || (dateTime.month != 2) || (dateTime.day != 7) ||
+	    (dateTime.hour != 6) || (dateTime.minute != 28) || (dateTime.second != 14)) {
+		mismatches++;
+	}
+
+	success = (mismatches == 0);
+	printf("test=time checks=%lu mismatches=%lu result=%s\n",
+	       (unsigned long) checks, (unsigned long) mismatches,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Step through interval boundaries one second at a time.
+ *
+ *  \param trim  Trim value, the interval is 10^7 / |trim| seconds.
+ */
+static bool Test_Step(int16_t trim)
+{
+	uint32_t interval = 10000000UL / (uint16_t) ((trim < 0) ? -trim : trim);
+	uint8_t boundary;
+	uint8_t wrong = 0;
+	uint8_t alarmMoved = 0;
+	int32_t corrections = 0;
+	uint32_t elapsed = 0;
+	uint32_t start;
+	bool success;
+
+	RTC32CAL_SetTrim(trim);
+	start = TRIM_START - 2;
+	RTC32CAL_SetTime(start);
+
+	for (boundary = 0; boundary < 3; boundary++) {
+		uint32_t next = TRIM_START + boundary * interval;
+		uint8_t second;
+
+		/* Skip to two seconds before the boundary. */
+		if (boundary != 0) {
+			uint32_t now = RTC32CAL_GetTime();
+
+			Run_Seconds(next - 2 - now);
+			elapsed += next - 2 - now;
+		}
+
+		/* An alarm on the second a forward correction skips. */
+		if (trim < 0) {
+			RTC32_SetCompareValue(next + 1);
+		}
+
+		for (second = 0; second < 5; second++) {
+			uint8_t call;
+
+			for (call = 0; call < CALLS_PER_SECOND; call++) {
+				RTC32CAL_Update();
+			}
+
+			/* The boundary is reached in the third second. */
+			if (second == 2) {
+				corrections += (trim > 0) ? 1 : -1;
+			}
+			if (RTC32CAL_GetTime() != start + elapsed - corrections) {
+				wrong++;
+			}
+			Run_Seconds(1);
+			elapsed++;
+		}
+		if ((trim < 0) && (RTC32_GetCompareValue() == next + 2)) {
+			alarmMoved++;
+		}
+	}
+
+	success = (wrong == 0) && ((trim > 0) || (alarmMoved == 3));
+	printf("test=step trim=%d interval_s=%lu boundaries=3 corrections=%ld wrong=%u "
+	       "alarm_moved=%u result=%s\n",
+	       trim, (unsigned long) interval, (long) corrections, wrong, alarmMoved,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Make up the corrections due after a reset. */
+static bool Test_CatchUp(int16_t trim, uint8_t intervals)
+{
+	uint32_t interval = 10000000UL / (uint16_t) ((trim < 0) ? -trim : trim);
+	uint32_t idle = intervals * interval + interval / 2;
+	volatile uint8_t status = 0xFF;
+	uint32_t expected;
+	uint32_t first;
+	uint32_t second;
+	bool success;
+
+	RTC32CAL_SetTrim(trim);
+	RTC32CAL_SetTime(TRIM_START);
+	Run_Seconds(idle);
+
+	SIM_SetResetHandler(Harness_Reset);
+	if (sigsetjmp(bootPoint, 1) == 0) {
+		SIM_Reset(RST_PORF_bm);
+	}
+	SIM_SetResetHandler(NULL);
+
+	status = RTC32CAL_Init(false, trim);
+	RTC32CAL_Update();
+	first = RTC32CAL_GetTime();
+	RTC32CAL_Update();
+	second = RTC32CAL_GetTime();
+
+	expected = TRIM_START + idle + ((trim > 0) ? -intervals : intervals);
+	success = (status == VBAT_STATUS_OK) && (first == expected) && (second == expected);
+	printf("test=catch_up trim=%d intervals=%u status=%u time=%lu expected=%lu "
+	       "second_update=%lu result=%s\n",
+	       trim, intervals, status, (unsigned long) first, (unsigned long) expected,
+	       (unsigned long) second, success ? "pass" : "fail");
+	return success;
+}
+
+
+/*! \brief Correct a crystal that runs fast or slow over many intervals.
+ *
+ *  \param ppm  Frequency error of the crystal.
+ */
+static bool Test_Drift(int16_t ppm)
+{
+	int16_t trim = ppm * RTC32CAL_TRIM_PPM;
+	uint32_t interval = 10000000UL / (uint16_t) ((trim < 0) ? -trim : trim);
+	uint32_t updates = DRIFT_INTERVALS * interval / UPDATE_INTERVAL;
+	uint64_t startNs;
+	int32_t errorMin = 0;
+	int32_t errorMax = 0;
+	int32_t error = 0;
+	uint32_t i;
+	bool success;
+
+	SIM_OSC_SetDrift(OSC_XOSCEN_bm, ppm);
+	RTC32CAL_SetTrim(trim);
+	RTC32CAL_SetTime(TRIM_START);
+	startNs = SIM_GetNanoseconds();
+
+	for (i = 0; i < updates; i++) {
+		uint32_t trueTime;
+
+		Run_Seconds(UPDATE_INTERVAL);
+		RTC32CAL_Update();
+		trueTime = TRIM_START + (uint32_t) ((SIM_GetNanoseconds() - startNs) / 1000000000ULL);
+		error = (int32_t) (RTC32CAL_GetTime() - trueTime);
+		errorMin = (error < errorMin) ? error : errorMin;
+		errorMax = (error > errorMax) ? error : errorMax;
+	}
+	SIM_OSC_SetDrift(OSC_XOSCEN_bm, 0);
+
+	success = (errorMin >= -2) && (errorMax <= 2) && (error >= -1) && (error <= 1);
+	printf("test=drift ppm=%d trim=%d interval_s=%lu run_s=%lu untrimmed_error_s=%ld "
+	       "error_min_s=%ld error_max_s=%ld error_end_s=%ld result=%s\n",
+	       ppm, trim, (unsigned long) interval,
+	       (unsigned long) updates * UPDATE_INTERVAL,
+	       (long) ((int64_t) updates * UPDATE_INTERVAL * ppm / 1000000),
+	       (long) errorMin, (long) errorMax, (long) error,
+	       success ? "pass" : "fail");
+	return success;
+}
+
+
+int main(void)
+{
+	bool success = true;
+	uint8_t status;
+
+	success &= Test_Leap();
+	success &= Test_Time();
+
+	/* First start-up with a fresh battery: the RTC32 is started. */
+	status = RTC32CAL_Init(true, 0);
+	printf("test=init status=%u time=%lu result=%s\n", status,
+	       (unsigned long) RTC32CAL_GetTime(),
+	       (status == VBAT_STATUS_INIT) ? "pass" : "fail");
+	success &= (status == VBAT_STATUS_INIT);
+
+	success &= Test_Step(100);
+	success &= Test_Step(-100);
+	success &= Test_CatchUp(1000, 3);
+	success &= Test_CatchUp(-1000, 3);
+	success &= Test_Drift(25);
+	success &= Test_Drift(-25);
+
+	printf("summary result=%s\n", success ? "pass" : "fail");
+	return success ? 0 : 1;
+}
@@ -0,0 +1,344 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  Host conversion test of the XMEGA ADC driver.
+ *
+ *      This program runs the ADC driver on the host simulator, with the
+ *      set-up of task 1 on ADCB: 12-bit conversions of PB1 with VCC/1.6 as
+ *      reference and the ADC clock at an eighth of the 2 MHz CPU clock. The
+ *      calibration bytes are not loaded, as the production signature row is
+ *      not simulated. With -Wall -Wextra, gcc warns about the signature row
+ *      read of SP_ReadCalibrationByte(), which takes the row address as an
+ *      integer; the function is not called on the host.
+ *
+ *      Scenarios:
+ *        - signed, signed_clamp, gain, unsigned, bandgap, int1v, 8bit: single
+ *          conversions against the transfer functions of the data sheet,
+ *          within one LSB, and against the conversion time of the resolution
+ *          and gain.
+ *        - pipeline: the four channels started together must complete one
+ *          ADC clock cycle apart.
+ *        - below: the compare function of task 2, with the conversions
+ *          started by the program instead of free running mode. The channel
+ *          interrupt must only be taken for results below CMP.
+ *        - flush: a conversion flushed from the pipeline must not complete.
+ *
+ *      Each scenario prints one line of space separated key=value pairs. The
+ *      program exits with a non-zero status if a check fails.
+ *
+ *      Build and run from the directory holding adc_driver.c. The simulator is
+ *      shared with AVR1307:
+ *        gcc -std=gnu99 -O2 -no-pie -DF_CPU=2000000UL \
+ *            -I../../avr1307-usart/code/host_sim -I. \
+ *            ../../avr1307-usart/code/host_sim/sim.c host_sim/adc_conversion.c \
+ *            adc_driver.c -o adc_conversion
+ *        ./adc_conversion
+ *
+ * \par Application note:
+ *      AVR1517: XMEGA-A1 Xplained Training - XMEGA Analog to Digital Converter
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 2564 $
+ * $Date: 2009-07-06 17:45:56 +0200 (ma, 06 jul 2009) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "avr_compiler.h"
+#include "adc_driver.h"
+#include "sim.h"
+
+/*! CPU cycles per ADC clock cycle, ADC_PRESCALER_DIV8_gc. */
+#define ADC_CLOCK_CYCLES  8
+
+/*! Reference voltages in millivolts: VCC/1.6 and the internal 1.0 V. */
+#define VCC_REF_MV        (SIM_AC_VCC_MV / 1.6)
+#define INT1V_REF_MV      1000.0
+
+/*! Input pins of the scenarios, PB1 as in task 1 and PB4 as negative input. */
+#define INPUT_PIN         1
+#define NEGATIVE_PIN      4
+
+/*! Compare value of the below scenario, as in task 2. */
+#define COMPARE_VALUE     2048
+
+/*! Longest time a conversion may take, in CPU cycles. */
+#define TIMEOUT_CYCLES    1000UL
+
+
+/*! Number of ADCB CH0 interrupts taken. */
+static volatile uint8_t interruptCount;
+
+/*! Result read by the last ADCB CH0 interrupt. */
+static volatile uint16_t interruptResult;
+
+
+/*! ADCB channel 0 interrupt vector. */
+ISR(ADCB_CH0_vect)
+{
+	interruptResult = ADC_ResultCh_GetWord(&ADCB.CH0);
+	interruptCount++;
+}
+
+
+/*! \brief Wait for the conversion of a channel to complete.
+ *
+ *  \return  CPU cycles since \a start, or 0 on timeout.
+ */
+static uint32_t Test_Wait(ADC_CH_t * ch, uint64_t start)
+{
+	while (!ADC_Ch_Conversion_Complete(ch)) {
+		if (SIM_GetCycles() - start > TIMEOUT_CYCLES) {
+			return 0;
+		}
+	}
+	return (uint32_t) (SIM_GetCycles() - start);
+}
+
+
+/*! \brief Convert the input on CH0 once, check it and report.
+ *
+ *  \param name        Name of the scenario.
+ *  \param inputMode   Input mode and gain of the channel.
+ *  \param mux         Input multiplexer setting of the channel.
+ *  \param millivolts  Input voltage, differential for the gain input mode.
+ *  \param expected    Expected result by the transfer function.
+ *  \param clocks      ADC clock cycles of the conversion.
+ *
+ *  \return  true if the checks passed.
+ */
+static bool Test_Convert(const char * name, uint8_t inputMode, uint8_t mux,
+                         int16_t millivolts, double expected, uint8_t clocks)
+{
+	uint64_t start;
+	uint32_t cycles;
+	int16_t result;
+	bool success;
+
+	SIM_ADC_SetInput(&ADCB, INPUT_PIN, millivolts);
+	ADCB.CH0.CTRL = inputMode;
+	ADCB.CH0.MUXCTRL = mux;
+
+	start = SIM_GetCycles();
+	ADC_Ch_Conversion_Start(&ADCB.CH0);
+	cycles = Test_Wait(&ADCB.CH0, start);
+	result = (int16_t) ADC_ResultCh_GetWord(&ADCB.CH0);
+
+	/* The flag is polled with register accesses of a few cycles each. */
+	success = (cycles >= clocks * ADC_CLOCK_CYCLES) &&
+	          (cycles <= clocks * ADC_CLOCK_CYCLES + 4UL * SIM_CYCLES_PER_ACCESS) &&
+	          (abs(result - (int16_t) expected) <= 1);
+
+	printf("scenario=%s input_mv=%d value=%d expected=%.1f cycles=%lu conversion_cycles=%u "
+	       "result=%s\n",
+	       name,
+	       millivolts,
+	       result,
+	       expected,
+	       (unsigned long) cycles,
+	       clocks * ADC_CLOCK_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Start the four channels together and report their completion times. */
+static bool Test_Pipeline(void)
+{
+	ADC_CH_t * ch[4] = { &ADCB.CH0, &ADCB.CH1, &ADCB.CH2, &ADCB.CH3 };
+	uint32_t done[4] = { 0 };
+	uint64_t start;
+	bool success = true;
+	uint8_t pending = 0x0F;
+	uint8_t i;
+
+	for (i = 0; i < 4; i++) {
+		ADC_Ch_InputMode_and_Gain_Config(ch[i], ADC_CH_INPUTMODE_SINGLEENDED_gc,
+		                                 ADC_CH_GAIN_1X_gc);
+		ADC_Ch_InputMux_Config(ch[i], ADC_CH_MUXPOS_PIN1_gc, ADC_CH_MUXNEG_PIN0_gc);
+	}
+	start = SIM_GetCycles();
+	ADC_Conversions_Start(&ADCB, (ADC_CH0START_bm | ADC_CH1START_bm |
+	                              ADC_CH2START_bm | ADC_CH3START_bm));
+	while ((pending != 0) && (SIM_GetCycles() - start < TIMEOUT_CYCLES)) {
+		for (i = 0; i < 4; i++) {
+			if ((pending & (1 << i)) && ADC_Ch_Conversion_Complete(ch[i])) {
+				done[i] = (uint32_t) (SIM_GetCycles() - start);
+				ADC_ResultCh_GetWord(ch[i]);
+				pending &= ~(1 << i);
+			}
+		}
+	}
+	/* Each poll of the four flags takes a few register accesses. */
+	for (i = 1; i < 4; i++) {
+		int32_t skew = (int32_t) (done[i] - done[0]) - i * ADC_CLOCK_CYCLES;
+
+		success &= (done[i] > done[i - 1]) && (labs(skew) <= 4 * SIM_CYCLES_PER_ACCESS);
+	}
+	success &= (pending == 0);
+
+	printf("scenario=pipeline ch0_cycles=%lu ch1_cycles=%lu ch2_cycles=%lu ch3_cycles=%lu "
+	       "slot_cycles=%u result=%s\n",
+	       (unsigned long) done[0],
+	       (unsigned long) done[1],
+	       (unsigned long) done[2],
+	       (unsigned long) done[3],
+	       ADC_CLOCK_CYCLES,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Convert inputs below and above CMP in compare mode and report. */
+static bool Test_Below(void)
+{
+	static const int16_t input[4] = { 500, 1500, 900, 2000 };
+	uint8_t expectedCount = 0;
+	bool success = true;
+	uint8_t i;
+
+	ADC_Ch_InputMode_and_Gain_Config(&ADCB.CH0, ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                                 ADC_CH_GAIN_1X_gc);
+	ADC_Ch_InputMux_Config(&ADCB.CH0, ADC_CH_MUXPOS_PIN1_gc, ADC_CH_MUXNEG_PIN0_gc);
+	ADC_ConvMode_and_Resolution_Config(&ADCB, ADC_ConvMode_Unsigned, ADC_RESOLUTION_12BIT_gc);
+	ADC_CompareValue_Set(&ADCB, COMPARE_VALUE);
+	ADC_Ch_Interrupts_Config(&ADCB.CH0, ADC_CH_INTMODE_BELOW_gc, ADC_CH_INTLVL_MED_gc);
+	interruptCount = 0;
+
+	for (i = 0; i < 4; i++) {
+		double expected = (input[i] + VCC_REF_MV / 20) * 4096 / VCC_REF_MV;
+
+		SIM_ADC_SetInput(&ADCB, INPUT_PIN, input[i]);
+		ADC_Ch_Conversion_Start(&ADCB.CH0);
+		SIM_Run(TIMEOUT_CYCLES);
+		if (expected < COMPARE_VALUE) {
+			expectedCount++;
+			success &= (abs((int16_t) interruptResult - (int16_t) expected) <= 1);
+		}
+		success &= (interruptCount == expectedCount);
+	}
+	ADC_Ch_Interrupts_Config(&ADCB.CH0, ADC_CH_INTMODE_COMPLETE_gc, ADC_CH_INTLVL_OFF_gc);
+
+	/* The interrupt clears the flag, so none is left pending. */
+	success &= !ADC_Ch_Conversion_Complete(&ADCB.CH0);
+
+	printf("scenario=below compare=%u conversions=4 interrupts=%u expected=%u result=%s\n",
+	       COMPARE_VALUE,
+	       interruptCount,
+	       expectedCount,
+	       success ? "pass" : "fail");
+
+	return success;
+}
+
+
+/*! \brief Flush a conversion in progress and report. */
+static bool Test_Flush(void)
+{
+	bool complete;
+
+	ADC_Ch_Conversion_Start(&ADCB.CH0);
+	ADC_Pipeline_Flush(&ADCB);
+	SIM_Run(TIMEOUT_CYCLES);
+	complete = ADC_Ch_Conversion_Complete(&ADCB.CH0);
+
+	printf("scenario=flush complete=%s result=%s\n",
+	       complete ? "yes" : "no",
+	       complete ? "fail" : "pass");
+
+	return !complete;
+}
+
+
+/*! \brief Run the scenarios and report.
+ *
+ *  \return  0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+	bool success = true;
+
+	/* The set-up of task 1. */
+	ADC_ConvMode_and_Resolution_Config(&ADCB, ADC_ConvMode_Signed, ADC_RESOLUTION_12BIT_gc);
+	ADC_Reference_Config(&ADCB, ADC_REFSEL_VCC_gc);
+	ADC_Prescaler_Config(&ADCB, ADC_PRESCALER_DIV8_gc);
+	ADC_Enable(&ADCB);
+	ADC_Wait_8MHz(&ADCB);
+	PMIC.CTRL |= PMIC_MEDLVLEN_bm;
+	sei();
+
+	SIM_ADC_SetInput(&ADCB, NEGATIVE_PIN, 550);
+	success &= Test_Convert("signed", ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc, 1200, 1200 * 2048 / VCC_REF_MV, 7);
+	success &= Test_Convert("signed_clamp", ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc, 3000, 2047, 7);
+	/* 50 mV between PB1 and PB4, times eight. */
+	success &= Test_Convert("gain", ADC_CH_INPUTMODE_DIFFWGAIN_gc | ADC_CH_GAIN_8X_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc | ADC_CH_MUXNEG_PIN4_gc, 600,
+	                        (600 - 550) * 8 * 2048 / VCC_REF_MV, 8);
+
+	ADC_ConvMode_and_Resolution_Config(&ADCB, ADC_ConvMode_Unsigned, ADC_RESOLUTION_12BIT_gc);
+	success &= Test_Convert("unsigned", ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc, 1200,
+	                        (1200 + VCC_REF_MV / 20) * 4096 / VCC_REF_MV, 7);
+	/* The bandgap is measured against VCC/1.6, as it equals the 1.0 V reference. */
+	success &= Test_Convert("bandgap", ADC_CH_INPUTMODE_INTERNAL_gc,
+	                        ADC_CH_MUXINT_BANDGAP_gc, 0,
+	                        (SIM_AC_BANDGAP_MV + VCC_REF_MV / 20) * 4096 / VCC_REF_MV, 7);
+	ADC_Reference_Config(&ADCB, ADC_REFSEL_INT1V_gc);
+	success &= Test_Convert("int1v", ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc, 600,
+	                        (600 + INT1V_REF_MV / 20) * 4096 / INT1V_REF_MV, 7);
+	ADC_Reference_Config(&ADCB, ADC_REFSEL_VCC_gc);
+	ADC_ConvMode_and_Resolution_Config(&ADCB, ADC_ConvMode_Unsigned, ADC_RESOLUTION_8BIT_gc);
+	success &= Test_Convert("8bit", ADC_CH_INPUTMODE_SINGLEENDED_gc,
+	                        ADC_CH_MUXPOS_PIN1_gc, 1200,
+	                        (1200 + VCC_REF_MV / 20) * 256 / VCC_REF_MV, 5);
+
+	ADC_ConvMode_and_Resolution_Config(&ADCB, ADC_ConvMode_Unsigned, ADC_RESOLUTION_12BIT_gc);
+	success &= Test_Pipeline();
+	success &= Test_Below();
+	success &= Test_Flush();
+
+	printf("summary adc_clock_cycles=%u vcc_ref_mv=%.1f result=%s\n",
+	       ADC_CLOCK_CYCLES,
+	       VCC_REF_MV,
+	       success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "../Task2/Xmega_training_8bit11k.h"
+#include "../dac_driver.h"
+#include "../dma_driver.h"
+#include "../flash_table.h"
+
+// The board.h header file defines which IO ports peripherals like
+// Switches and LEDs are connected to. The header file is configured
+// for use with XMEGA-A1 Xplained.
+#include "../board.h"
+
+/*                            Task 4
+ *
+ * Plays the sound sample from Task 2 with DMA instead of an interrupt per
+ * sample. The DMA cannot read flash, so two DMA channels in double buffer
+ * mode take turns sending a RAM buffer to the DAC, and the buffer of the
+ * idle channel is refilled from flash by the flash table reader.
+ *
+ * Before playing, the cost of reading flash is measured with Timer/Counter
+ * C1, and the results are left in benchmarkCycles for the debugger.
+ */
+
+#define END_ADDRESS 11200
+
+// 2MHz/11025Hz gives the period of 181 CK
+#define TIMER_C0_PERIOD 181
+
+// Number of samples in each of the two DMA buffers.
+#define BUFFER_SIZE 128
+
+// Number of bytes read in each benchmark.
+#define BENCHMARK_SIZE 1024
+
+#define DMA_CHANNEL_0  &DMA.CH0
+#define DMA_CHANNEL_1  &DMA.CH1
+
+// Sample buffers, one for each DMA channel.
+uint8_t SampleBuffer[2][BUFFER_SIZE];
+
+// Reader streaming the sample from flash.
+FLASHTBL_Reader_t SampleReader;
+
+// 24-bit flash address of the sample.
+uint32_t SampleAddress;
+
+// Cycles used to read BENCHMARK_SIZE bytes:
+// [0] pgm_read_byte() in a loop
+// [1] FLASHTBL_ReadByte() in a loop
+// [2] FLASHTBL_Copy()
+volatile uint16_t benchmarkCycles[3];
+
+uint8_t BenchmarkBuffer[BENCHMARK_SIZE];
+
+
+// Measure the cost of the different ways of reading flash.
+void Benchmark( void )
+{
+    FLASHTBL_Reader_t reader;
+    uint16_t i;
+
+    TCC1.CTRLA = ( TCC1.CTRLA & ~TC1_CLKSEL_gm ) | TC_CLKSEL_DIV1_gc;
+
+    TCC1.CNT = 0;
+    for ( i = 0; i < BENCHMARK_SIZE; i++ )
+    {
+        BenchmarkBuffer[i] = pgm_read_byte( &(mydata[i]) );
+    }
+    benchmarkCycles[0] = TCC1.CNT;
+
+    FLASHTBL_Open( &reader, SampleAddress );
+    TCC1.CNT = 0;
+    for ( i = 0; i < BENCHMARK_SIZE; i++ )
+    {
+        BenchmarkBuffer[i] = FLASHTBL_ReadByte( &reader );
+    }
+    benchmarkCycles[1] = TCC1.CNT;
+
+    TCC1.CNT = 0;
+    FLASHTBL_Copy( BenchmarkBuffer, SampleAddress, BENCHMARK_SIZE );
+    benchmarkCycles[2] = TCC1.CNT;
+
+    TCC1.CTRLA = ( TCC1.CTRLA & ~TC1_CLKSEL_gm ) | TC_CLKSEL_OFF_gc;
+}
+
+
+// Fill a sample buffer with the next samples, restarting the sample at
+// the end.
+void FillBuffer( uint8_t * buffer )
+{
+    uint16_t left = SampleAddress + END_ADDRESS - FLASHTBL_GetAddress( &SampleReader );
+
+    if ( left > BUFFER_SIZE )
+    {
+        FLASHTBL_ReadRecord( &SampleReader, buffer, BUFFER_SIZE );
+    }
+    else
+    {
+        FLASHTBL_ReadRecord( &SampleReader, buffer, left );
+        FLASHTBL_Open( &SampleReader, SampleAddress );
+        FLASHTBL_ReadRecord( &SampleReader, buffer + left, BUFFER_SIZE - left );
+    }
+}
+
+
+void DMA_Setup( DMA_CH_t * dmaChannel, const void * src )
+{
+    DMA_SetupBlock(
+                    dmaChannel,
+                    src,
+                    DMA_CH_SRCRELOAD_BLOCK_gc,
+                    DMA_CH_SRCDIR_INC_gc,
+                    (void *) &DACB.CH0DATAH,
+                    DMA_CH_DESTRELOAD_NONE_gc,
+                    DMA_CH_DESTDIR_FIXED_gc,
+                    BUFFER_SIZE,
+                    DMA_CH_BURSTLEN_1BYTE_gc,
+                    0,
+                    false
+                   );
+
+    // Timer Overflow will trigger DMA, one sample per trigger.
+    DMA_SetTriggerSource( dmaChannel, DMA_CH_TRIGSRC_TCC0_OVF_gc );
+    DMA_EnableSingleShot( dmaChannel );
+    DMA_SetIntLevel( dmaChannel, DMA_CH_TRNINTLVL_MED_gc, DMA_CH_ERRINTLVL_OFF_gc );
+}
+
+
+int main( void )
+{
+	// First we have to enable the audio amplifier by setting PQ3 high.
+	PORTQ.PIN3CTRL = (PORTQ.PIN3CTRL & ~PORT_OPC_gm) | PORT_OPC_PULLUP_gc;
+
+	// Configure switches
+	SWITCHPORTL.DIRCLR = 0xff; // Set port as input
+    // Configure all keys to be active when pressed (inverted).
+    PORTCFG.MPCMASK = 0xFF;
+	SWITCHPORTL.PIN0CTRL = (SWITCHPORTL.PIN0CTRL & ~PORT_OPC_gm) | PORT_OPC_PULLUP_gc; //Enable pull-up to get a defined level on the switches
+    PORTCFG.MPCMASK = 0xFF;
+    SWITCHPORTL.PIN0CTRL |= PORT_INVEN_bm;
+
+    SampleAddress = FLASHTBL_FAR_ADDRESS( mydata );
+    Benchmark();
+
+    // Fill both buffers before starting.
+    FLASHTBL_Open( &SampleReader, SampleAddress );
+    FillBuffer( SampleBuffer[0] );
+    FillBuffer( SampleBuffer[1] );
+
+    // Channel 1 takes over when channel 0 is done, and the other way round.
+    DMA_Enable();
+    DMA_ConfigDoubleBuffering( DMA_DBUFMODE_CH01_gc );
+    DMA_Setup( DMA_CHANNEL_0, SampleBuffer[0] );
+    DMA_Setup( DMA_CHANNEL_1, SampleBuffer[1] );
+    DMA_EnableChannel( DMA_CHANNEL_0 );
+
+    // The DAC is left adjusted, so the DMA writes the 8-bit samples to the
+    // high byte of the data register.
+	DAC_SingleChannel_Enable(
+                                &DACB,
+	                            DAC_REFSEL_AVCC_gc,
+	                            true
+	                        );
+
+    TCC0.PER = TIMER_C0_PERIOD;
+
+	// Enable medium interrupt level in PMIC and enable global interrupts.
+	PMIC.CTRL |= PMIC_MEDLVLEN_bm;
+    sei();
+
+	while (1)
+    {
+        if(SWITCHPORTL.IN == 0x00)
+        {
+            // No Timer to trigger DMA: No sound
+            TCC0.CTRLA = ( TCC0.CTRLA & ~TC0_CLKSEL_gm ) | TC_CLKSEL_OFF_gc;
+        }
+        else
+        {
+            // Enable Timer C0, prescaler div1 means Main Clock (2MHz)
+            TCC0.CTRLA = ( TCC0.CTRLA & ~TC0_CLKSEL_gm ) | TC_CLKSEL_DIV1_gc;
+        }
+    }
+}
+
+
+// Channel 0 is done and channel 1 has taken over. Refill the buffer of
+// channel 0, which is enabled again when channel 1 is done.
+ISR(DMA_CH0_vect)
+{
+    DMA.CH0.CTRLB |= DMA_CH_TRNIF_bm;
+    FillBuffer( SampleBuffer[0] );
+}
+
+
+// Channel 1 is done and channel 0 has taken over.
+ISR(DMA_CH1_vect)
+{
+    DMA.CH1.CTRLB |= DMA_CH_TRNIF_bm;
+    FillBuffer( SampleBuffer[1] );
+}
@@ -0,0 +1,118 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA far flash table reader source file.
+ *
+ *      This file contains the function implementations of the XMEGA far flash
+ *      table reader.
+ *
+ * \par Application note:
+ *      AVR1520: XMEGA-A1 Xplained Training - XMEGA DAC
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1653 $
+ * $Date: 2008-05-21 10:26:08 +0200 (on, 21 mai 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "flash_table.h"
+
+
+/*! \brief This function copies a block from flash to RAM.
+ *
+ *  The block is read with an ELPM Z+ loop, so it may start anywhere in
+ *  flash and cross 64 KB boundaries. The loop takes eight cycles per byte.
+ *  Interrupts are not disabled. The interrupt handlers generated by the
+ *  compiler save and clear RAMPZ when they use the Z pointer, and RAMPZ is
+ *  restored when the copy is done.
+ *
+ *  \param dest     Destination in RAM.
+ *  \param address  24-bit flash address of the block.
+ *  \param count    Number of bytes to copy.
+ */
+void FLASHTBL_Copy( void * dest, uint32_t address, uint16_t count )
+{
+	if ( count == 0 ) {
+		return;
+	}
+
+#if defined( __GNUC__ )
+	{
+		uint16_t zAddress = (uint16_t) address;
+		uint8_t * destPtr = (uint8_t *) dest;
+		uint8_t savedRampz;
+
+		__asm__ __volatile__ (
+			"in %[saved], %[rampz]"        "\n\t"
+			"out %[rampz], %[page]"        "\n\t"
+			"1:"                           "\n\t"
+			"elpm __tmp_reg__, Z+"         "\n\t"
+			"st X+, __tmp_reg__"           "\n\t"
+			"sbiw %[count], 1"             "\n\t"
+			"brne 1b"                      "\n\t"
+			"out %[rampz], %[saved]"
+			: [saved] "=&r" (savedRampz),
+			  [count] "+w" (count),
+			  "+z" (zAddress),
+			  "+x" (destPtr)
+			: [rampz] "I" (_SFR_IO_ADDR( RAMPZ )),
+			  [page] "r" ( (uint8_t) ( address >> 16 ) )
+			: "memory"
+		);
+	}
+#else
+	{
+		uint8_t const __farflash * srcPtr = (uint8_t const __farflash *) address;
+		uint8_t * destPtr = (uint8_t *) dest;
+
+		do {
+			*destPtr++ = *srcPtr++;
+		} while ( --count );
+	}
+#endif
+}
+
+
+/*! \brief This function reads the next record of a table.
+ *
+ *  \param reader  Pointer to the reader.
+ *  \param dest    Destination in RAM.
+ *  \param size    Record size in bytes.
+ */
+void FLASHTBL_ReadRecord( FLASHTBL_Reader_t * reader, void * dest, uint16_t size )
+{
+	FLASHTBL_Copy( dest, reader->address, size );
+	reader->address += size;
+}
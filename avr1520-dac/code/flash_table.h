@@ -0,0 +1,218 @@
+/* This file has been prepared for Doxygen automatic documentation generation.*/
+/*! \file *********************************************************************
+ *
+ * \brief  XMEGA far flash table reader header file.
+ *
+ *      This file contains the function prototypes, inline functions and macros
+ *      for reading constant tables anywhere in flash, also above the first
+ *      64 KB. A table is addressed by its 24-bit byte address in flash, and is
+ *      read with the ELPM instruction with RAMPZ holding the upper address
+ *      byte.
+ *
+ *      A reader keeps the current address between calls, so a table can be
+ *      streamed byte by byte, word by word or record by record. Blocks are
+ *      copied to RAM with an ELPM Z+ post-increment loop of about eight cycles
+ *      per byte, which makes it possible to refill RAM buffers that are fed to
+ *      peripherals by the DMA controller, since the DMA cannot read flash.
+ *
+ * \par Application note:
+ *      AVR1520: XMEGA-A1 Xplained Training - XMEGA DAC
+ *
+ * \par Documentation
+ *      For comprehensive code documentation, supported compilers, compiler
+ *      settings and supported devices see readme.html
+ *
+ * \author
+ *      Atmel Corporation: http://www.atmel.com \n
+ *      Support email: avr@atmel.com
+ *
+ * $Revision: 1653 $
+ * $Date: 2008-05-21 10:26:08 +0200 (on, 21 mai 2008) $  \n
+ *
+ * Copyright (c) 2008, Atmel Corporation All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of ATMEL may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE EXPRESSLY AND
+ * SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+#ifndef FLASH_TABLE_H
+#define FLASH_TABLE_H
+
+#include "avr_compiler.h"
+
+/* Definition of macros. */
+
+/*! \brief This macro returns the 24-bit flash address of a table.
+ *
+ *  A pointer to data in flash is only 16 bits wide with avr-gcc, so the
+ *  address of a table placed above 64 KB must be taken with this macro.
+ *
+ *  \param _table  The table, declared with PROGMEM or __farflash.
+ */
+#if defined( __GNUC__ )
+#define FLASHTBL_FAR_ADDRESS( _table )                 \
+({                                                     \
+	uint32_t farAddress;                           \
+	__asm__ (                                      \
+		"ldi %A0, lo8(%1)"  "\n\t"             \
+		"ldi %B0, hi8(%1)"  "\n\t"             \
+		"ldi %C0, hh8(%1)"  "\n\t"             \
+		"clr %D0"                              \
+		: "=d" (farAddress)                    \
+		: "p" (&(_table))                      \
+	);                                             \
+	farAddress;                                    \
+})
+#else
+#define FLASHTBL_FAR_ADDRESS( _table )  ( (uint32_t) &(_table) )
+#endif
+
+/*! \brief This macro starts reading a table at the given address.
+ *
+ *  \param _reader   Pointer to the reader.
+ *  \param _address  24-bit flash address, see FLASHTBL_FAR_ADDRESS().
+ */
+#define FLASHTBL_Open( _reader, _address )   ( (_reader)->address = (_address) )
+
+/*! \brief This macro moves the read position of a reader.
+ *
+ *  \param _reader  Pointer to the reader.
+ *  \param _offset  Number of bytes to skip.
+ */
+#define FLASHTBL_Skip( _reader, _offset )    ( (_reader)->address += (_offset) )
+
+/*! \brief This macro returns the current address of a reader.
+ *
+ *  \param _reader  Pointer to the reader.
+ */
+#define FLASHTBL_GetAddress( _reader )       ( (_reader)->address )
+
+
+/*! \brief Flash table reader. */
+typedef struct FLASHTBL_Reader_struct {
+	/*! 24-bit flash address of the next byte to read. */
+	uint32_t address;
+} FLASHTBL_Reader_t;
+
+
+/* Prototyping of functions. Documentation is found in source file. */
+
+void FLASHTBL_Copy( void * dest, uint32_t address, uint16_t count );
+void FLASHTBL_ReadRecord( FLASHTBL_Reader_t * reader, void * dest, uint16_t size );
+
+
+/*! \brief This function reads a byte from flash.
+ *
+ *  RAMPZ is restored before returning, since it is also used to address
+ *  external data memory through the Z pointer.
+ *
+ *  \param address  24-bit flash address.
+ *
+ *  \return  The byte read.
+ */
+INLINE uint8_t FLASHTBL_GetByte( uint32_t address )
+{
+#if defined( __GNUC__ )
+	uint8_t data;
+	uint8_t savedRampz;
+
+	__asm__ __volatile__ (
+		"in %[saved], %[rampz]"     "\n\t"
+		"out %[rampz], %[page]"     "\n\t"
+		"elpm %[data], Z"           "\n\t"
+		"out %[rampz], %[saved]"
+		: [data] "=&r" (data), [saved] "=&r" (savedRampz)
+		: [rampz] "I" (_SFR_IO_ADDR( RAMPZ )),
+		  [page] "r" ( (uint8_t) ( address >> 16 ) ),
+		  "z" ( (uint16_t) address )
+	);
+	return data;
+#else
+	return *(uint8_t const __farflash *) address;
+#endif
+}
+
+
+/*! \brief This function reads a little-endian word from flash.
+ *
+ *  The word may cross a 64 KB boundary, as ELPM Z+ increments the full
+ *  RAMPZ:Z address.
+ *
+ *  \param address  24-bit flash address.
+ *
+ *  \return  The word read.
+ */
+INLINE uint16_t FLASHTBL_GetWord( uint32_t address )
+{
+#if defined( __GNUC__ )
+	uint16_t data;
+	uint16_t zAddress = (uint16_t) address;
+	uint8_t savedRampz;
+
+	__asm__ __volatile__ (
+		"in %[saved], %[rampz]"     "\n\t"
+		"out %[rampz], %[page]"     "\n\t"
+		"elpm %A[data], Z+"         "\n\t"
+		"elpm %B[data], Z+"         "\n\t"
+		"out %[rampz], %[saved]"
+		: [data] "=&r" (data), [saved] "=&r" (savedRampz), "+z" (zAddress)
+		: [rampz] "I" (_SFR_IO_ADDR( RAMPZ )),
+		  [page] "r" ( (uint8_t) ( address >> 16 ) )
+	);
+	return data;
+#else
+	return *(uint16_t const __farflash *) address;
+#endif
+}
+
+
+/*! \brief This function reads the next byte of a table.
+ *
+ *  \param reader  Pointer to the reader.
+ *
+ *  \return  The byte read.
+ */
+INLINE uint8_t FLASHTBL_ReadByte( FLASHTBL_Reader_t * reader )
+{
+	uint32_t address = reader->address;
+
+	reader->address = address + 1;
+	return FLASHTBL_GetByte( address );
+}
+
+
+/*! \brief This function reads the next little-endian word of a table.
+ *
+ *  \param reader  Pointer to the reader.
+ *
+ *  \return  The word read.
+ */
+INLINE uint16_t FLASHTBL_ReadWord( FLASHTBL_Reader_t * reader )
+{
+	uint32_t address = reader->address;
+
+	reader->address = address + 2;
+	return FLASHTBL_GetWord( address );
+}
+
+#endif